@@ -34,6 +34,8 @@ using namespace mxflib;
 #include <stdio.h>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <set>
 
 //! MXFLib debug flag
 static bool DebugMode = false;
@@ -73,6 +75,12 @@ bool LongFormConsts = false;
 //! Namespace for defining UL constants
 std::string ULNamespace = "mxflib";
 
+//! Should we write a binary dictionary snapshot rather than C++ source?
+bool BinarySnapshot = false;
+
+//! Should we also write static perfect-hash lookup tables of the dictionary?
+bool DictIndexTables = false;
+
 
 // Declare main process function
 int main_process(int argc, char *argv[]);
@@ -105,9 +113,12 @@ namespace
 		bool IsType;
 		ULPtr UL;
 		Tag LocalTag;
+		DictIndexKind Kind;						//!< The kind of item, once the type of a class is resolved
+		std::string Base;						//!< The base class, if any
+		std::string ParentName;					//!< The name of the class element holding this one, or empty if top-level
 
 	public:
-		ULData() : IsSet(false), IsPack(false), IsMulti(false), IsType(false) {};
+		ULData() : IsSet(false), IsPack(false), IsMulti(false), IsType(false), Kind(DictIndexItem) {};
 	};
 
 	typedef std::map<std::string, ULDataPtr> ULDataMap;
@@ -115,6 +126,12 @@ namespace
 
 	ULDataMap ULMap;
 	ULDataList ULFixupList;
+
+	//! Every item with a UL, in the order defined, for the static index
+	ULDataList IndexList;
+
+	//! The first set or pack defined with each name, so that extensions and derived sets can find it
+	ULDataMap IndexSets;
 };
 
 
@@ -149,6 +166,7 @@ struct ConvertState
 	std::list<std::string> EndTagText;			//!< Text to be output at the next class end tag
 	std::map<std::string, std::string> TypeMap;	//!< Map of type for each class - to allow types to be inherited
 	std::list<bool> ExtendSubsList;				//!< List of extendSubs flags (explicit and inherited) for each level
+	std::list<std::string> ClassNames;			//!< Names of the open class elements, innermost last
 	std::string ProvisionalItem;				//!< The line to send for this class if it turns out to be an item
 	std::string ProvisionalExtend;				//!< The line to send for this class if it turns out to be an extension of a set or pack
 	bool FoundType;								//!< Set true once we have determined the dictionary type (old or new)
@@ -163,6 +181,9 @@ struct ConvertState
 //! Add a ULData item for a type
 void AddType(ConvertState *State, std::string Name, std::string Detail, std::string TypeUL);
 
+//! Write static perfect-hash lookup tables of all items with ULs
+bool WriteDictIndex(FILE *OutFile);
+
 
 
 //! Do the main processing (less any pause before exit)
@@ -193,6 +214,10 @@ int main_process(int argc, char *argv[])
 				ULConsts = false;
 			else if((argv[i][1] == 'l') || (argv[i][1] == 'L'))
 				LongFormConsts = true;
+			else if((argv[i][1] == 'p') || (argv[i][1] == 'P'))
+				BinarySnapshot = true;
+			else if((argv[i][1] == 'i') || (argv[i][1] == 'I'))
+				DictIndexTables = true;
 			else if((argv[i][1] == 'n') || (argv[i][1] == 'N'))
 			{
 				if((argv[i][2] == ':') || (argv[i][2] == '=')) UseName = &argv[i][3];
@@ -229,8 +254,11 @@ int main_process(int argc, char *argv[])
 		printf("         -c         CONSTS only\n");
 		printf("         -d         DICT only\n");
 		printf("         -x         (same as -d)\n");
+		printf("         -i         Also write static perfect-hash lookup tables as \"name\"_Index\n");
 		printf("         -n=name    Use \"name\" as the name of the structure built\n");
 		printf("         -l         Always use long-form names for UL consts\n");
+		printf("         -p         Write a binary snapshot of the dictionary to <outputfile>\n");
+		printf("                    (save as <inputfile>.bin for LoadDictionary to use it)\n");
 		printf("         -s=name    Use \"name\" as the namespace for UL consts\n");
 		printf("         -v         Verbose mode - shows lots of debug info\n");
 		printf("         -z         Pause for input before final exit\n");
@@ -244,6 +272,15 @@ int main_process(int argc, char *argv[])
 	// Set up the input file
 	InputFile = argv[FileArg[0]];
 
+	// A binary snapshot is built by loading the dictionary, so none of the conversion below is required
+	if(BinarySnapshot)
+	{
+		if(WriteDictionarySnapshot(InputFile, argv[FileArg[1]]) != 0) return 1;
+
+		printf("Binary dictionary snapshot written to %s\n", argv[FileArg[1]]);
+		return 0;
+	}
+
 	// If only one output file given, duplicate it
 	if( ULConsts && FileCount==2 )
 	{
@@ -312,6 +349,12 @@ int main_process(int argc, char *argv[])
 		fprintf(outfile, "\tMXFLIB_DICTIONARY_END\n", UseName.c_str());
 	}
 
+	if(DictIndexTables && !WriteDictIndex(outfile))
+	{
+		fclose(outfile);
+		return 1;
+	}
+
 	fclose(outfile);
 	State.OutFile = NULL;
 
@@ -1363,7 +1406,7 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 			// DRAGONS: We don't add masks to the UL map
 
 			ULDataPtr ThisItem;
-			if( ULConsts && strlen(TypeUL) )
+			if( (ULConsts || DictIndexTables) && strlen(TypeUL) )
 			{
 				UInt8 KeyBuff[16];
 
@@ -1381,6 +1424,8 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 
 					ThisItem->UL = new UL(KeyBuff);
 					ThisItem->LocalTag = 0;
+					ThisItem->Kind = DictIndexLabel;
+					IndexList.push_back(ThisItem);
 
 					// Build the name to use for the const
 					std::string ItemName = ThisItem->Name;
@@ -1638,7 +1683,7 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 			if(Count == 2) Tag = GetU16(KeyBuff);
 
 			ULDataPtr ThisItem;
-			if(ULConsts && (GlobalKey.length() > 0))
+			if((ULConsts || DictIndexTables) && (GlobalKey.length() > 0))
 			{
 				UInt8 KeyBuff[16];
 
@@ -1693,6 +1738,9 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 
 					ThisItem->UL = new UL(KeyBuff);
 					ThisItem->LocalTag = (mxflib::Tag)Tag;
+					ThisItem->Base = Base;
+					if(!State->ClassNames.empty()) ThisItem->ParentName = State->ClassNames.back();
+					IndexList.push_back(ThisItem);
 
 					// Build the name to use for the const
 					std::string ItemName = ThisItem->Name;
@@ -1754,6 +1802,7 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 
 			// Store the flag for this level
 			State->ExtendSubsList.push_back(ExtendSubs);
+			State->ClassNames.push_back(name);
 
 			// TODO: We should really work out if a set or pack is a simple rename (will work as it is but will produce an empty section)
 
@@ -1761,6 +1810,21 @@ void Convert_startElement(void *user_data, const char *name, const char **attrs)
 			strncpy(TypeBuff, Type.c_str(), 32);
 			TypeBuff[31] = '\0';
 
+			// Record the kind of item for the static index, now that any inherited type is known
+			if(ThisItem)
+			{
+				if((strcasecmp(TypeBuff,"localSet") == 0) || (strcasecmp(TypeBuff,"subLocalSet") == 0)) ThisItem->Kind = DictIndexSet;
+				else if(   (strcasecmp(TypeBuff,"fixedPack") == 0) || (strcasecmp(TypeBuff,"subFixedPack") == 0)
+					    || (strcasecmp(TypeBuff,"variablePack") == 0) || (strcasecmp(TypeBuff,"subVariablePack") == 0) ) ThisItem->Kind = DictIndexPack;
+				else if(   (strcasecmp(TypeBuff,"vector") == 0) || (strcasecmp(TypeBuff,"subVector") == 0)
+					    || (strcasecmp(TypeBuff,"array") == 0) || (strcasecmp(TypeBuff,"subArray") == 0) ) ThisItem->Kind = DictIndexMultiple;
+
+				if((ThisItem->Kind == DictIndexSet) || (ThisItem->Kind == DictIndexPack))
+				{
+					if(IndexSets.find(name) == IndexSets.end()) IndexSets.insert(ULDataMap::value_type(name, ThisItem));
+				}
+			}
+
 			if(strcasecmp(TypeBuff,"universalSet") == 0)
 			{
 				if(DictStructs)
@@ -2202,6 +2266,7 @@ void Convert_endElement(void *user_data, const char *name)
 
 			// Remove the extend subs flag for this level
 			State->ExtendSubsList.pop_back();
+			State->ClassNames.pop_back();
 
 			State->Depth--;
 		
@@ -2215,7 +2280,7 @@ void Convert_endElement(void *user_data, const char *name)
 void AddType(ConvertState *State, std::string Name, std::string Detail, std::string TypeUL)
 {
 	ULDataPtr ThisItem;
-	if(ULConsts && (TypeUL.length() > 0))
+	if((ULConsts || DictIndexTables) && (TypeUL.length() > 0))
 	{
 		ULPtr ThisTypeUL = StringToUL(TypeUL);
 		if(ThisTypeUL)
@@ -2228,6 +2293,8 @@ void AddType(ConvertState *State, std::string Name, std::string Detail, std::str
 			ThisItem->IsType = true;
 			ThisItem->UL = ThisTypeUL;
 			ThisItem->LocalTag = 0;
+			ThisItem->Kind = DictIndexType;
+			IndexList.push_back(ThisItem);
 
 			// Build the name to use for the const
 			std::string ItemName = ThisItem->Name;
@@ -2259,6 +2326,266 @@ void AddType(ConvertState *State, std::string Name, std::string Detail, std::str
 }
 
 
+namespace
+{
+	//! The largest seed tried for each bucket of a perfect hash
+	const UInt32 MaxHashSeed = 1 << 20;
+
+	//! Build a minimal perfect hash of a list of distinct keys
+	/*! Each key is hashed into a bucket, then the buckets are placed largest first, each using the first seed
+	 *  that puts all of its keys into slots not yet taken.
+	 *  \param Seeds Set to the seed of each bucket
+	 *  \param Slots Set to the slot of each key
+	 *  \return false if no perfect hash could be found
+	 */
+	template<class KeyType> bool BuildPerfectHash(const std::vector<KeyType> &Keys, std::vector<UInt32> &Seeds, std::vector<UInt32> &Slots)
+	{
+		UInt32 Count = static_cast<UInt32>(Keys.size());
+
+		std::vector<UInt32> Hashes;
+		UInt32 i;
+		for(i = 0; i < Count; i++) Hashes.push_back(DictIndexHash(Keys[i]));
+
+		// DRAGONS: Start with an average of four keys per bucket, and only use more buckets if one cannot be placed
+		UInt32 Buckets;
+		for(Buckets = (Count / 4) + 1; Buckets <= (Count * 2) + 1; Buckets *= 2)
+		{
+			std::vector<std::vector<UInt32> > Members(Buckets);
+			for(i = 0; i < Count; i++) Members[DictIndexMix(Hashes[i], 0) % Buckets].push_back(i);
+
+			std::vector<std::pair<size_t, UInt32> > Order;
+			for(i = 0; i < Buckets; i++) if(!Members[i].empty()) Order.push_back(std::make_pair(Members[i].size(), i));
+			std::sort(Order.rbegin(), Order.rend());
+
+			Seeds.assign(Buckets, 0);
+			Slots.assign(Count, 0);
+			std::vector<bool> Taken(Count, false);
+
+			bool Placed = true;
+			std::vector<std::pair<size_t, UInt32> >::iterator it;
+			for(it = Order.begin(); Placed && (it != Order.end()); it++)
+			{
+				const std::vector<UInt32> &Bucket = Members[(*it).second];
+
+				Placed = false;
+				UInt32 Seed;
+				for(Seed = 1; (!Placed) && (Seed < MaxHashSeed); Seed++)
+				{
+					std::vector<UInt32> Try;
+
+					size_t j;
+					for(j = 0; j < Bucket.size(); j++)
+					{
+						UInt32 Slot = DictIndexMix(Hashes[Bucket[j]], Seed) % Count;
+						if(Taken[Slot] || (std::find(Try.begin(), Try.end(), Slot) != Try.end())) break;
+						Try.push_back(Slot);
+					}
+					if(j < Bucket.size()) continue;
+
+					for(j = 0; j < Bucket.size(); j++)
+					{
+						Taken[Try[j]] = true;
+						Slots[Bucket[j]] = Try[j];
+					}
+
+					Seeds[(*it).second] = Seed;
+					Placed = true;
+				}
+			}
+
+			if(Placed) return true;
+		}
+
+		return false;
+	}
+
+	//! Write a const array of UInt32 values
+	void WriteUInt32Array(FILE *OutFile, std::string Name, const std::vector<UInt32> &Values)
+	{
+		fprintf(OutFile, "\tconst UInt32 %s[] = {", Name.c_str());
+
+		size_t i;
+		for(i = 0; i < Values.size(); i++)
+		{
+			if(i) fprintf(OutFile, ",");
+			fprintf(OutFile, ((i % 12) == 0) ? "\n\t\t%u" : " %u", Values[i]);
+		}
+
+		fprintf(OutFile, "\n\t};\n");
+	}
+}
+
+
+//! Write static perfect-hash lookup tables of all items with ULs
+/*! The tables are written as a DictIndex called <UseName>_Index, with its entries ordered by the slot of their UL.
+ *  \return false if the tables could not be built
+ */
+bool WriteDictIndex(FILE *OutFile)
+{
+	static const char *KindNames[] = { "DictIndexType", "DictIndexLabel", "DictIndexSet", "DictIndexPack", "DictIndexMultiple", "DictIndexItem" };
+
+	// Only the first item for each UL can be found, so drop the others (keys are matched with the rules of UL::Matches())
+	std::vector<ULDataPtr> Items;
+	std::vector<const UInt8 *> Keys;
+	ULHashMap<UInt32> ItemIndex(true);
+
+	ULDataList::iterator it = IndexList.begin();
+	while(it != IndexList.end())
+	{
+		if(ItemIndex.Find(*(*it)->UL))
+		{
+			debug("Not indexing %s separately as its UL is already indexed\n", (*it)->Name.c_str());
+		}
+		else
+		{
+			ItemIndex.Add(*(*it)->UL, static_cast<UInt32>(Items.size()));
+			Items.push_back(*it);
+			Keys.push_back((*it)->UL->GetValue());
+		}
+		it++;
+	}
+
+	std::vector<UInt32> ULSeeds;
+	std::vector<UInt32> ULSlots;
+	if(!BuildPerfectHash(Keys, ULSeeds, ULSlots))
+	{
+		error("Unable to build a perfect hash of the ULs in the dictionary\n");
+		return false;
+	}
+
+	// Index the top-level names, the first item with each name being the one found
+	std::vector<const char *> NameKeys;
+	std::vector<UInt32> NameEntries;
+	std::set<std::string> Named;
+
+	size_t i;
+	for(i = 0; i < Items.size(); i++)
+	{
+		if(Items[i]->ParentName.size() || (Named.find(Items[i]->Name) != Named.end())) continue;
+
+		Named.insert(Items[i]->Name);
+		NameKeys.push_back(Items[i]->Name.c_str());
+		NameEntries.push_back(ULSlots[i]);
+	}
+
+	std::vector<UInt32> NameSeeds;
+	std::vector<UInt32> NameKeySlots;
+	if(!BuildPerfectHash(NameKeys, NameSeeds, NameKeySlots))
+	{
+		error("Unable to build a perfect hash of the names in the dictionary\n");
+		return false;
+	}
+
+	std::vector<UInt32> NameSlots(NameKeys.size());
+	for(i = 0; i < NameKeys.size(); i++) NameSlots[NameKeySlots[i]] = NameEntries[i];
+
+	// Gather the tagged items held by each class element, including those that extend an earlier definition
+	std::map<std::string, ULDataList> Members;
+	for(it = IndexList.begin(); it != IndexList.end(); it++)
+	{
+		if((*it)->ParentName.size() && ((*it)->LocalTag != 0)) Members[(*it)->ParentName].push_back(*it);
+	}
+
+	// Put the items in slot order
+	std::vector<UInt32> SlotItems(Items.size());
+	for(i = 0; i < Items.size(); i++) SlotItems[ULSlots[i]] = static_cast<UInt32>(i);
+
+	// Build the children of each set, sorted by tag, with those of a derived set replacing any of its base with the same tag
+	std::vector<std::pair<Tag, UInt32> > Children;
+	std::vector<UInt32> FirstChild(Items.size(), 0);
+	std::vector<UInt32> ChildCount(Items.size(), 0);
+	for(i = 0; i < Items.size(); i++)
+	{
+		ULDataPtr Item = Items[SlotItems[i]];
+		if(Item->Kind != DictIndexSet) continue;
+
+		std::map<Tag, UInt32> SetChildren;
+
+		std::string Name = Item->Name;
+		int Depth;
+		for(Depth = 0; Name.size() && (Depth < 32); Depth++)
+		{
+			ULDataList &List = Members[Name];
+			ULDataList::iterator Child_it = List.begin();
+			while(Child_it != List.end())
+			{
+				const UInt32 *Index = ItemIndex.Find(*(*Child_it)->UL);
+				if(Index && (SetChildren.find((*Child_it)->LocalTag) == SetChildren.end()))
+				{
+					SetChildren.insert(std::map<Tag, UInt32>::value_type((*Child_it)->LocalTag, ULSlots[*Index]));
+				}
+				Child_it++;
+			}
+
+			ULDataMap::iterator Base_it = IndexSets.find(Name);
+			Name = (Base_it == IndexSets.end()) ? "" : (*Base_it).second->Base;
+		}
+
+		FirstChild[i] = static_cast<UInt32>(Children.size());
+		ChildCount[i] = static_cast<UInt32>(SetChildren.size());
+
+		std::map<Tag, UInt32>::iterator Set_it = SetChildren.begin();
+		while(Set_it != SetChildren.end())
+		{
+			Children.push_back(*Set_it);
+			Set_it++;
+		}
+	}
+
+	fprintf(OutFile, "\n\t// Static perfect-hash index of the items in this dictionary that have ULs\n");
+
+	std::string Prefix = UseName + "_Index";
+	if(Items.size())
+	{
+		fprintf(OutFile, "\tconst DictIndexEntry %sEntries[] = {\n", Prefix.c_str());
+		for(i = 0; i < Items.size(); i++)
+		{
+			ULDataPtr Item = Items[SlotItems[i]];
+			const UInt8 *Key = Item->UL->GetValue();
+
+			fprintf(OutFile, "\t\t{ { ");
+			int j;
+			for(j = 0; j < 16; j++) fprintf(OutFile, j ? ", 0x%02x" : "0x%02x", Key[j]);
+			fprintf(OutFile, " }, \"%s\", ", CConvert(Item->Name.c_str()).c_str());
+			if(Item->ParentName.size()) fprintf(OutFile, "\"%s\", ", CConvert(Item->ParentName.c_str()).c_str());
+			else fprintf(OutFile, "NULL, ");
+			fprintf(OutFile, "0x%04x, %s, %u, %u },\n", Item->LocalTag, KindNames[Item->Kind], FirstChild[i], ChildCount[i]);
+		}
+		fprintf(OutFile, "\t};\n");
+
+		WriteUInt32Array(OutFile, Prefix + "ULSeeds", ULSeeds);
+	}
+
+	if(NameKeys.size())
+	{
+		WriteUInt32Array(OutFile, Prefix + "NameSeeds", NameSeeds);
+		WriteUInt32Array(OutFile, Prefix + "NameSlots", NameSlots);
+	}
+
+	if(Children.size())
+	{
+		fprintf(OutFile, "\tconst DictIndexChild %sChildren[] = {", Prefix.c_str());
+		for(i = 0; i < Children.size(); i++)
+		{
+			if(i) fprintf(OutFile, ",");
+			fprintf(OutFile, ((i % 6) == 0) ? "\n\t\t{ 0x%04x, %u }" : " { 0x%04x, %u }", Children[i].first, Children[i].second);
+		}
+		fprintf(OutFile, "\n\t};\n");
+	}
+
+	fprintf(OutFile, "\tconst DictIndex %s = { ", Prefix.c_str());
+	if(Items.size()) fprintf(OutFile, "%sEntries, %u, %sULSeeds, %u, ", Prefix.c_str(), (unsigned int)Items.size(), Prefix.c_str(), (unsigned int)ULSeeds.size());
+	else fprintf(OutFile, "NULL, 0, NULL, 0, ");
+	if(NameKeys.size()) fprintf(OutFile, "%sNameSeeds, %u, %sNameSlots, %u, ", Prefix.c_str(), (unsigned int)NameSeeds.size(), Prefix.c_str(), (unsigned int)NameKeys.size());
+	else fprintf(OutFile, "NULL, 0, NULL, 0, ");
+	if(Children.size()) fprintf(OutFile, "%sChildren };\n", Prefix.c_str());
+	else fprintf(OutFile, "NULL };\n");
+
+	printf("Static index of %u items written as %s\n", (unsigned int)Items.size(), Prefix.c_str());
+
+	return true;
+}
+
 //! XML callback - Handle warnings during XML parsing
 extern void Convert_warning(void *user_data, const char *msg, ...)
 {
@@ -211,6 +211,8 @@ void SetStreamIndex(BodyStreamPtr &ThisStream, bool isCBR, ProcessOptions		*pOpt
 			else 
 				ThisStream->AddIndexType(BodyStream::StreamIndexSprinkled);
 		}
+		if(pOpt->BoundedIndex)
+			ThisStream->SetBoundedIndex();
 
 	}
 }
@@ -838,6 +840,15 @@ Length ProcessEssence(int OutFileNum,
 	gettimeofday(& start, &tz);
 #endif
 
+	// Overlap the writing of each content package with the preparation of the next if requested
+	if(pOpt->AsyncWriteSize) Writer->SetAsyncWrite(pOpt->AsyncWriteSize);
+	if(pOpt->DirectWriteSize) Writer->SetDirectWrite(pOpt->DirectWriteSize);
+	if(pOpt->PrefetchDepth) Writer->SetPrefetch(pOpt->PrefetchDepth);
+
+	// Reserve disk space for the whole file if we know roughly how long it will be
+	if(pOpt->PreallocateDuration && !Writer->Preallocate(pOpt->PreallocateDuration))
+		warning("Unable to preallocate disk space for the output file\n");
+
 	// Write the body
 	if(pOpt->BodyMode == Body_None)
 	{
@@ -1097,6 +1108,7 @@ Length Process(
 		// Use padding per command line - even for block aligned files
 		if(pOpt->HeaderPadding) Writer->SetPartitionFiller(pOpt->HeaderPadding);
 		if(pOpt->HeaderSize) Writer->SetPartitionSize(pOpt->HeaderSize);
+		if(pOpt->HeaderReserve) Writer->SetHeaderReserve(pOpt->HeaderReserve, SmallestHeaderReserve);
 
 		// DRAGONS: would be nice to have an even length Header Partition
 		//if(pOpt->HeaderSize) Writer->SetPartitionSize(pOpt->HeaderSize - PartitionPackLength);
@@ -1195,3 +1207,178 @@ Length Process(
 		return Ret;
 }
 
+
+
+namespace
+{
+	//! Runs Process() for a single output file on its own thread
+	class ProcessThread : public Thread
+	{
+	public:
+		int OutFileNum;
+		MXFFilePtr Out;
+		ProcessOptions *pOpt;
+		EssenceParser::WrappingConfigList WrapCfgList;
+		EssenceSourcePair Source[ProcessOptions::MaxInFiles];
+		Rational EditRate;
+		UMIDPtr MPUMID;
+		UMIDPtr *FPUMID;
+		UMIDPtr *SPUMID;
+		Length Duration;
+
+		ProcessThread() : OutFileNum(0), pOpt(NULL), FPUMID(NULL), SPUMID(NULL), Duration(-1) {}
+
+		~ProcessThread() { Join(); }
+
+	protected:
+		virtual void Run(void)
+		{
+			Duration = Process(OutFileNum, Out, pOpt, WrapCfgList, Source, EditRate, MPUMID, FPUMID, SPUMID);
+
+			// Release our branches now, in case we stopped early and would otherwise hold back the other output files
+			int i;
+			for(i = 0; i < ProcessOptions::MaxInFiles; i++) Source[i].second = NULL;
+		}
+	};
+}
+
+
+//! Write all the output files at once, each with Process() on its own thread
+bool ProcessConcurrent(MXFFilePtr *Out, ProcessOptions *pOpt, EssenceParser::WrappingConfigList WrappingList, EssenceSourcePair *Source,
+					   Rational EditRate, UMIDPtr MPUMID, UMIDPtr *FPUMID, UMIDPtr *SPUMID, Length *Duration, int *ReadGroup /*=NULL*/)
+{
+	int OutCount = pOpt->OutFileCount;
+	int TrackCount = static_cast<int>(WrappingList.size());
+
+	// Work out which tracks each output file reads
+	/* DRAGONS: This code MUST be kept in step with the logic of the stream building loop in ProcessMetadata() */
+	std::vector<std::vector<bool> > Reads(OutCount, std::vector<bool>(TrackCount, false));
+	std::vector<int> Readers(TrackCount, 0);
+
+	int OutFileNum;
+	for(OutFileNum = 0; OutFileNum < OutCount; OutFileNum++)
+	{
+		int PreviousFP = -1;
+		int iStream = -1;
+		int iTrack = 0;
+		EssenceParser::WrappingConfigList::iterator WrapCfgList_it = WrappingList.begin();
+		while(WrapCfgList_it != WrappingList.end())
+		{
+			if(Source[iTrack].first != PreviousFP) iStream++;
+
+			if(((!pOpt->OPAtom) || (iStream == OutFileNum)) && (!(*WrapCfgList_it)->IsExternal))
+			{
+				Reads[OutFileNum][iTrack] = true;
+				Readers[iTrack]++;
+			}
+
+			PreviousFP = Source[iTrack].first;
+			WrapCfgList_it++;
+			iTrack++;
+		}
+	}
+
+	// Find the read groups whose sources are read by more than one output file
+	std::vector<int> GroupOutput(ProcessOptions::MaxInFiles, -1);
+	std::vector<bool> GroupShared(ProcessOptions::MaxInFiles, false);
+
+	int iTrack;
+	for(OutFileNum = 0; OutFileNum < OutCount; OutFileNum++)
+	{
+		for(iTrack = 0; iTrack < TrackCount; iTrack++)
+		{
+			if(!Reads[OutFileNum][iTrack]) continue;
+
+			int Group = ReadGroup ? ReadGroup[iTrack] : 0;
+			if(GroupOutput[Group] < 0) GroupOutput[Group] = OutFileNum;
+			else if(GroupOutput[Group] != OutFileNum) GroupShared[Group] = true;
+		}
+	}
+
+	// Share each source read by more than one output file, and lock the reading of any source whose group is read by more than one
+	// DRAGONS: Sources in the same group may share a parser, so all reads of them are made under a single lock, which still leaves the
+	//          writing of each output file to run in parallel. Sources in a group of their own are read directly by their output's thread
+	Mutex ReadLock[ProcessOptions::MaxInFiles];
+	std::vector<EssenceTeePtr> Tees(TrackCount);
+
+	for(iTrack = 0; iTrack < TrackCount; iTrack++)
+	{
+		int Group = ReadGroup ? ReadGroup[iTrack] : 0;
+		if((Readers[iTrack] > 1) || ((Readers[iTrack] == 1) && GroupShared[Group]))
+		{
+			Tees[iTrack] = new EssenceTee(Source[iTrack].second, pOpt->PrefetchDepth ? pOpt->PrefetchDepth : 8, &ReadLock[Group]);
+		}
+	}
+
+	// Set up each output, with its own branch of each shared source it reads and its own copy of each wrapping configuration
+	std::vector<ProcessThread*> Threads(OutCount);
+	for(OutFileNum = 0; OutFileNum < OutCount; OutFileNum++)
+	{
+		ProcessThread *ThisThread = new ProcessThread;
+		Threads[OutFileNum] = ThisThread;
+
+		ThisThread->OutFileNum = OutFileNum;
+		ThisThread->Out = Out[OutFileNum];
+		ThisThread->pOpt = pOpt;
+		ThisThread->EditRate = EditRate;
+		ThisThread->MPUMID = MPUMID;
+		ThisThread->FPUMID = FPUMID;
+		ThisThread->SPUMID = SPUMID;
+
+		iTrack = 0;
+		EssenceParser::WrappingConfigList::iterator WrapCfgList_it = WrappingList.begin();
+		while(WrapCfgList_it != WrappingList.end())
+		{
+			// Descriptors are updated as each file is written, so each file gets its own
+			// DRAGONS: Any sub-descriptors of a multiple descriptor are still shared
+			EssenceParser::WrappingConfigPtr Copy = new EssenceParser::WrappingConfig;
+			Copy->Parser = (*WrapCfgList_it)->Parser;
+			Copy->WrapOpt = (*WrapCfgList_it)->WrapOpt;
+			if((*WrapCfgList_it)->EssenceDescriptor) Copy->EssenceDescriptor = (*WrapCfgList_it)->EssenceDescriptor->MakeCopy();
+			Copy->Stream = (*WrapCfgList_it)->Stream;
+			Copy->EditRate = (*WrapCfgList_it)->EditRate;
+			Copy->SubStreams = (*WrapCfgList_it)->SubStreams;
+			Copy->StartTimecode = (*WrapCfgList_it)->StartTimecode;
+			Copy->IsExternal = (*WrapCfgList_it)->IsExternal;
+			Copy->KAGSize = (*WrapCfgList_it)->KAGSize;
+			ThisThread->WrapCfgList.push_back(Copy);
+
+			// Tracks that are not read are only used for their static properties, so can be given the original source
+			ThisThread->Source[iTrack].first = Source[iTrack].first;
+			if(Tees[iTrack] && Reads[OutFileNum][iTrack]) ThisThread->Source[iTrack].second = Tees[iTrack]->AddBranch();
+			else ThisThread->Source[iTrack].second = Source[iTrack].second;
+
+			WrapCfgList_it++;
+			iTrack++;
+		}
+	}
+
+	// The tees are now only held by their branches, so each is released once every output reading it is done
+	Tees.clear();
+
+	bool Ret = true;
+	for(OutFileNum = 0; OutFileNum < OutCount; OutFileNum++)
+	{
+		if(!Threads[OutFileNum]->Start())
+		{
+			error("Unable to start a thread to write output file %d\n", OutFileNum + 1);
+
+			// Release this output's branches so that they do not hold back the other output files
+			for(iTrack = 0; iTrack < TrackCount; iTrack++) Threads[OutFileNum]->Source[iTrack].second = NULL;
+
+			Ret = false;
+		}
+	}
+
+	for(OutFileNum = 0; OutFileNum < OutCount; OutFileNum++)
+	{
+		Threads[OutFileNum]->Join();
+		Duration[OutFileNum] = Threads[OutFileNum]->Duration;
+
+		if(Duration[OutFileNum] < 0) Ret = false;
+
+		delete Threads[OutFileNum];
+	}
+
+	return Ret;
+}
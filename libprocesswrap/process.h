@@ -40,6 +40,7 @@ using namespace mxflib;
 
 //! The empirically smallest Header
 const UInt32 EmpiricalSmallestHeader=16*1024;
+const UInt32 SmallestHeaderReserve=1024;		//!< The least expansion space to leave when it is sized from the header metadata
 
 //! DM Dictionaries
 typedef std::list<std::string> DMFileList;
@@ -130,6 +131,12 @@ public:
 	//! Debug flag for MXFLib
 	bool DebugMode;
 
+	//! Display library statistics after processing
+	bool ShowStats;
+
+	//! File to write a timeline trace of library activity to, or empty for none
+	std::string TraceFile;
+
 	/*********************************************************
 	***
 	*** Options relating to Operational Patterns
@@ -183,12 +190,21 @@ public:
 	UInt32 KAGSize;
 	UInt32 HeaderPadding ;					//!< The (minimum) number of bytes of padding to leave in the header
 	UInt32 HeaderSize ;						//!< The (minimum) size of the header
+	UInt32 HeaderReserve ;					//!< Expansion space to leave in the header as a percentage of the size of its metadata, or 0 for none
 	UInt32 BlockSize ;						//!< The BlockAlign size for this file
 	Int32 BlockOffset ;						//!< The BlockAlign essence offset for this file
 	Int32 BlockIndexOffset ;				//!< The BlockAlign index offset for this file
 
 	bool UpdateHeader;						//!< Is the header going to be updated after writing the footer
 
+	UInt32 AsyncWriteSize;					//!< Size of each output buffer for asynchronous writing, or 0 to write synchronously
+	UInt32 DirectWriteSize;					//!< Size of the staging buffer for direct (unbuffered) writing, or 0 to write through the file cache
+	Length PreallocateDuration;				//!< Estimated number of frames to reserve disk space for before writing, or 0 not to preallocate
+	unsigned int PrefetchDepth;				//!< Number of frames to read ahead per essence stream on a background thread, or 0 to read synchronously
+	unsigned int LookaheadFiles;			//!< Number of following files of a file list to open on background threads, or 0 to open each when needed
+	std::string DigestAlgorithm;			//!< Algorithm used to make a digest of each track's essence as it is written, or "" for none
+	bool ConcurrentOutputs;					//!< Write all output files at once, each on its own thread, reading each source only once
+
 	bool FrameGroup;						//!< Group all as a frame-wrapped group (in one essence container)
 	bool ZeroPad;							//!< Pad streams with zero bytes if they end earlier than others in the same frame-group
 	bool StreamMode ;						//!< Wrap in stream-mode
@@ -201,6 +217,7 @@ public:
 	bool SprinkledIndex ;					//!< Write segmented index tables (one set per partition)
 	bool IsolatedIndex ;					//!< Don't write essence and index in same partition
 	bool VeryIsolatedIndex ;				//!< Don't write metadata and index in same partition
+	bool BoundedIndex ;						//!< Free index entries once written in a sprinkled index table (implies SprinkledIndex)
 
 	bool IncludeSubstreams;					//!< Should sub-streams also be wrapped
 
@@ -213,6 +230,8 @@ public:
 	UInt32 BodyRate;						//!< The rate of body partition insertion
 	bool EditAlign ;						//!< Start new body partitions only at the start of a GOP
 
+	StorageProfile Storage;					//!< The storage the output will be read from, if set the layout is planned for it
+
 
 	Rational ForceEditRate;					//!< Edit rate to try and force
 
@@ -275,6 +294,7 @@ public:
 		OPUL(OP1a_Data)
 	{
 		DebugMode = false;
+		ShowStats = false;
 
 		SelectedWrappingOption=-1;
 
@@ -286,12 +306,21 @@ public:
 
 		HeaderPadding=0;					// The (minimum) number of bytes of padding to leave in the header
 		HeaderSize=0 ;						// The (minimum) size of the header
+		HeaderReserve=0 ;					// The expansion space to leave as a percentage of the header metadata
 		BlockSize=0 ;						// The BlockAlign size for this file
 		BlockOffset=0 ;						// The BlockAlign essence offset for this file
 		BlockIndexOffset=0 ;				// The BlockAlign index offset for this file
 
 		UpdateHeader=false;
 
+		AsyncWriteSize=0;
+		DirectWriteSize=0;
+		PreallocateDuration=0;
+		PrefetchDepth=0;
+		LookaheadFiles=0;
+		DigestAlgorithm="";
+		ConcurrentOutputs=false;
+
 		AudioLimit = 0;
 
 		OPAtom=false;		
@@ -305,6 +334,7 @@ public:
 		SprinkledIndex=false ;	
 		IsolatedIndex=false ;		
 		VeryIsolatedIndex=false ;
+		BoundedIndex=false ;
 		EditAlign=false;
 
 		IncludeSubstreams = true;
@@ -385,5 +415,29 @@ Length Process(
 			);
 
 
+/*!
+Write all the output files at once, each with Process() on its own thread. Each essence source is shared
+between the output files that use it through an EssenceTee, so the essence is read and parsed only once
+however many files it is written to. For OP-Atom, where each track has a file of its own, sources from
+different input files are read in parallel by the thread writing their file.
+\note The threads are not taken from the shared TaskExecutor, as all of them must run at once for the
+      EssenceTee branches to make progress, so one thread is started for every output file
+\return false if any output file could not be processed, in which case its duration is set to -1
+*/
+bool ProcessConcurrent(
+				MXFFilePtr			*Out,		//!< The MXF file objects for each output file, all opened for writing
+				ProcessOptions		*pOpt,		//!< A pointer to the options, shared by all output files
+				EssenceParser::WrappingConfigList WrappingList,  //!< A List of the acceptable Wrapping options for the essence being wrapped
+				EssenceSourcePair	*Source,	//!< An array of pairs ( file package index and a source to insert into that file package)
+				Rational			EditRate,	//!< The edit rate that is right for the master package.
+				UMIDPtr				MPUMID,		//!< The UMID for the master package
+				UMIDPtr				*FPUMID,	//!< An array of UMIDs for each file package
+				UMIDPtr				*SPUMID,	//!< An array of UMIDs for each source package
+				Length				*Duration,	//!< An array to receive the duration written to each output file
+				int					*ReadGroup=NULL	//!< An array giving a group number below MaxInFiles for each source, where sources
+												//!< in the same group may share a parser so must not be read at the same time,
+												//!< or NULL if all sources are to be treated as one group
+			);
+
 
 #endif //_PROCESS_H_
@@ -39,6 +39,10 @@ using namespace std;
 using namespace dot;
 
 
+// Large graphs are written as many small strings, so they are collected into large writes
+static const size_t OUTPUT_BUFFER_SIZE = 1024 * 1024;
+
+
 DotFile::DotFile(const char* filename)
 : _state(START), _nextNodeId(0), _nextClusterId(0) 
 {
@@ -48,6 +52,7 @@ DotFile::DotFile(const char* filename)
         fprintf(stderr, "Failed to open file");
         throw "Failed to open file";
     }
+    setvbuf(_dotFile, 0, _IOFBF, OUTPUT_BUFFER_SIZE);
 }
 
 DotFile::~DotFile(void)
@@ -55,14 +60,14 @@ DotFile::~DotFile(void)
     fclose(_dotFile);
 }
     
-void DotFile::startGraph(string id)
+void DotFile::startGraph(const string& id)
 {
     assert(_state == START);
     
     string str = "digraph ";
     str += id + " {\n";
         
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = ELEMENT;
 }
@@ -73,15 +78,15 @@ void DotFile::endGraph(void)
 
     string str = "}\n";
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 }
 
-void DotFile::startDefaultAttributes(string elementName)
+void DotFile::startDefaultAttributes(const string& elementName)
 {
     assert(_state == ELEMENT);
 
     string str = elementName;
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 
     _state = DEFAULT_ATTR;
 }
@@ -100,19 +105,19 @@ void DotFile::endDefaultAttributes(void)
     {
         str = ";\n";
     }
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 
     _state = ELEMENT;
 }
 
-void DotFile::startCluster(string id)
+void DotFile::startCluster(const string& id)
 {
     assert(_state == ELEMENT);
     
     string str = "subgraph ";
     str += id + " {\n";
         
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
 }
 
 void DotFile::endCluster(void)
@@ -121,16 +126,16 @@ void DotFile::endCluster(void)
 
     string str = "};\n";
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 }
  
-void DotFile::startNode(string id)
+void DotFile::startNode(const string& id)
 {
     assert(_state == ELEMENT);
 
     string str = id;
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = NODE;
 }
@@ -149,19 +154,19 @@ void DotFile::endNode(void)
         str = "];\n";
     }
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = ELEMENT;
 }
 
-void DotFile::startEdge(string fromId, string toId)
+void DotFile::startEdge(const string& fromId, const string& toId)
 {
     assert(_state == ELEMENT);
 
     string str = fromId + " -> ";
     str += toId + " ";
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = EDGE;
 }
@@ -182,7 +187,7 @@ long DotFile::allocateEdgeSpace(unsigned int size)
     return position;
 }
 
-void DotFile::startEdge(long position, string fromId, string toId)
+void DotFile::startEdge(long position, const string& fromId, const string& toId)
 {
     int result = fseek(_dotFile, position, SEEK_SET);
     assert(result == 0);
@@ -190,7 +195,7 @@ void DotFile::startEdge(long position, string fromId, string toId)
     string str = fromId + " -> ";
     str += toId;
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = EDGE;
 }
@@ -209,12 +214,12 @@ void DotFile::endEdge(void)
         str = "];\n";
     }
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = ELEMENT;
 }
 
-void DotFile::writeAttribute(string id, string value)
+void DotFile::writeAttribute(const string& id, const string& value)
 {
     assert(_state == ATTRIBUTES || _state == DEFAULT_ATTR || _state == NODE || _state == EDGE);
     
@@ -230,7 +235,7 @@ void DotFile::writeAttribute(string id, string value)
     str += id + " = ";
     str += value;
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile);
+    write(str);
     
     _state = ATTRIBUTES;
 }
@@ -251,7 +256,7 @@ void DotFile::writeAttribute(DotAttribute* attribute)
     str += attribute->getId() + " = ";
     str += attribute->getValue();
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 
     _state = ATTRIBUTES;
 }
@@ -282,11 +287,16 @@ void DotFile::writeAttributes(vector<DotAttribute*>& attributes)
         str += (*iter)->getValue();
     }
 
-    fwrite(str.c_str(), sizeof(char), str.length(), _dotFile); 
+    write(str); 
 
     _state = ATTRIBUTES;
 }
 
+void DotFile::write(const string& str)
+{
+    fwrite(str.data(), sizeof(char), str.length(), _dotFile);
+}
+
 string DotFile::getNextNodeId(void)
 {
     char buffer[13];
@@ -502,44 +512,50 @@ string DotObjectAttribute::getDisplayWidth(float fixedPitch)
     return buffer;
 }
 
-string DotObjectAttribute::escapeString(string value)
+string DotObjectAttribute::escapeString(const string& value)
 {
-    size_t index = 0;
-    while (index < value.size())
+    // built in a single pass, as inserting into the value is slow for long property values
+    string result;
+    result.reserve(value.size() + value.size() / 8);
+    
+    size_t index;
+    for (index = 0; index < value.size(); index++)
     {
-        if (value[index] == '\n')
+        char c = value[index];
+        if (c == '\n')
         {
-            value.erase(index, 1);
-            value.insert(index, "\\n");
-            index += 1;
+            result += "\\n";
         }
-        else if (value[index] == '"' ||
-            value[index] == '\\' ||
-            value[index] == '<' ||
-            value[index] == '>' ||
-            value[index] == '{' ||
-            value[index] == '}' ||
-            value[index] == '=' ||
-            value[index] == '|' )
+        else if (c == '"' ||
+            c == '\\' ||
+            c == '<' ||
+            c == '>' ||
+            c == '{' ||
+            c == '}' ||
+            c == '=' ||
+            c == '|' )
         {
-            value.insert(index, "\\");
-            index += 1;
+            result += '\\';
+            result += c;
         }
         // tab etc. become spaces
-        else if (isspace((unsigned char)value[index]))
+        else if (isspace((unsigned char)c))
         {
-            value[index] = ' ';
+            result += ' ';
         }
         // replace non-printable or control characters with "?"
-        else if (!isprint((unsigned char)value[index]) || 
-            iscntrl((unsigned char)value[index]))
+        else if (!isprint((unsigned char)c) || 
+            iscntrl((unsigned char)c))
         {
-            value[index] = '?';
+            result += '?';
+        }
+        else
+        {
+            result += c;
         }
-        index++;
     }
     
-    return value;
+    return result;
 }
 
 
@@ -42,25 +42,25 @@ public:
     DotFile(const char* filename);
     ~DotFile(void);
     
-    void startGraph(std::string id);
+    void startGraph(const std::string& id);
     void endGraph(void);
     
-    void startDefaultAttributes(std::string elementName);
+    void startDefaultAttributes(const std::string& elementName);
     void endDefaultAttributes(void);
     
-    void startCluster(std::string id);
+    void startCluster(const std::string& id);
     void endCluster(void);
  
-    void startNode(std::string id);
+    void startNode(const std::string& id);
     void endNode(void);
     
-    void startEdge(std::string fromId, std::string toId);
+    void startEdge(const std::string& fromId, const std::string& toId);
     void endEdge(void);
     // allocate space for writing an edge later using startEdge(position... 
     long allocateEdgeSpace(unsigned int size = 60);
-    void startEdge(long position, std::string fromId, std::string toId);
+    void startEdge(long position, const std::string& fromId, const std::string& toId);
 
-    void writeAttribute(std::string id, std::string value);
+    void writeAttribute(const std::string& id, const std::string& value);
     void writeAttribute(DotAttribute* attribute);
     void writeAttributes(std::vector<DotAttribute*>& attributes);
     
@@ -83,6 +83,8 @@ private:
         END
     };
     
+    void write(const std::string& str);
+
     FILE*       _dotFile;
     DotState    _state;
     long        _nextNodeId;
@@ -126,7 +128,7 @@ public:
     
 protected:
     void addPropertyValueOrDef(std::string name, std::string typeOrValue, bool isValue);
-    std::string escapeString(std::string value);
+    std::string escapeString(const std::string& value);
     
     std::string                 _name;
     std::vector<std::string>    _properties;
@@ -168,6 +168,93 @@ void mxf2dotError(const char* format, ...)
 
 
 
+// maps the InstanceUID of each metadata object to its dot node id
+// Node ids are allocated when an object is first output or referenced, so the header is only walked once,
+// and the objects that have been output are recorded so that each is output only once
+class NodeIdMap
+{
+public:
+    NodeIdMap() : _nextNodeId(0) {}
+
+    // returns the node id of an object, allocating one if needed
+    string getNodeId(MDObjectPtr obj)
+    {
+        return formatNodeId(findOrAdd(obj));
+    }
+
+    // records that the object is being output, returning false if it has been already
+    bool markOutput(MDObjectPtr obj)
+    {
+        unsigned long nodeId = findOrAdd(obj);
+        if (_output[nodeId])
+        {
+            return false;
+        }
+        _output[nodeId] = true;
+        return true;
+    }
+
+private:
+    // returns the node id number of an object, allocating one if needed
+    unsigned long findOrAdd(MDObjectPtr obj)
+    {
+        UInt8 uid[16];
+        if (!getInstanceUID(obj, uid))
+        {
+            mxf2dotError("Invalid object identification - %s object is probably missing a InstanceUID property\n", obj->Name().c_str());
+            exit(1);
+        }
+
+        UL key(uid);
+        const unsigned long* nodeId = _ids.Find(key);
+        if (nodeId != 0)
+        {
+            return *nodeId;
+        }
+
+        _ids.Add(key, _nextNodeId);
+        _output.push_back(false);
+        return _nextNodeId++;
+    }
+
+    // gets the raw InstanceUID of an object, which is hashed rather than converted to a string
+    static bool getInstanceUID(MDObjectPtr obj, UInt8* uid)
+    {
+        MDObjectPtr uidProp = obj->Child(InstanceUID_UL);
+        if (!uidProp)
+        {
+            return false;
+        }
+
+        // the value as read is used if it is still valid, otherwise it is rebuilt
+        const DataChunk& data = uidProp->GetData();
+        if (data.Size == 16)
+        {
+            memcpy(uid, data.Data, 16);
+            return true;
+        }
+        DataChunkPtr built = uidProp->PutData();
+        if (!built || built->Size != 16)
+        {
+            return false;
+        }
+        memcpy(uid, built->Data, 16);
+        return true;
+    }
+
+    static string formatNodeId(unsigned long nodeId)
+    {
+        char buffer[16];
+        sprintf(buffer, "N%lu", nodeId);
+        return buffer;
+    }
+
+    ULHashMap<unsigned long> _ids;
+    vector<bool> _output;
+    unsigned long _nextNodeId;
+};
+
+
 // context data used when traversing the metadata object tree
 class OutputContext
 {
@@ -194,19 +281,21 @@ public:
 
     string getArrayOrBatchIndexStr()
     {
-        char str[6];
+        char str[12];
         sprintf(str, "%d", arrayOrBatchIndex);
         return str;
     }
 
     
     int arrayOrBatchIndex;
-    map<string, string>* oidToNodeId;
+    NodeIdMap* nodeIds;
     MDObjectPtr obj;
     MDObjectPtr prop;
     DotObjectAttribute* oa;
+    // source references from a node id to a PackageUID/TrackId combination, resolved once all tracks are known
     vector<pair<string, string> >* sourceRefs;
-    string parentPackageUID;
+    // map from PackageUID/TrackId combination to the node id of the Track
+    map<string, string>* trackNodeIds;
 };
 
 
@@ -216,26 +305,38 @@ string getSourceRefTarget(string packageId, string trackId)
     return packageId + " " + trackId;
 }
 
-// returns true of the thing identified by the oid has a node id
-bool haveNodeId(string oid, map<string, string>* oidToNodeId)
+// returns true if the property is an array or batch of references, rather than a simple value
+// (arrays and batches of simple values are output as a single value)
+bool isReferenceArray(MDObjectPtr prop)
 {
-    assert(oid.length() > 0);
-    map<string, string>::iterator item = oidToNodeId->find(oid);
-    return item != oidToNodeId->end();
+    if (prop->empty())
+    {
+        return false;
+    }
+    MDObjectPtr first = prop->front().second;
+    return first && (first->GetLink() || first->GetRefType() == TypeRefStrong || first->GetRefType() == TypeRefWeak);
 }
 
-// returns the node id associated with the thing identified by the oid
-string getNodeId(string oid, map<string, string>* oidToNodeId)
+// record the PackageUID/TrackId combination of each Track of a Package, which is the target of source references
+void recordTracks(OutputContext* context)
 {
-    if (oid.length() == 0)
+    MDObjectPtr tracks = context->obj->Child(Tracks_UL);
+    if (!tracks)
     {
-        mxf2dotError("Invalid object identification - object is probably missing a InstanceUID property\n");
-        exit(1);
+        return;
+    }
+    
+    string packageId = context->obj->GetString(PackageUID_UL);
+    MDObjectULList::iterator trackIter;
+    for (trackIter = tracks->begin(); trackIter != tracks->end(); trackIter++)
+    {
+        MDObjectPtr track = (*trackIter).second->GetLink();
+        if (track)
+        {
+            string target = getSourceRefTarget(packageId, track->GetString(TrackID_UL));
+            context->trackNodeIds->insert(pair<string, string>(target, context->nodeIds->getNodeId(track)));
+        }
     }
-    assert(oid.length() > 0);
-    map<string, string>::iterator item = oidToNodeId->find(oid);
-    assert(item != oidToNodeId->end());
-    return (*item).second;
 }
 
 
@@ -245,12 +346,20 @@ void outputProperty(DotFile* dotFile, OutputContext* context);
 // output the object and object properties to dot
 void outputObject(DotFile* dotFile, OutputContext* context)
 {
-    if (context->obj->IsA(GenericPackage_UL))
+    // objects that are strongly referenced more than once (which is invalid) or in a loop are only output once
+    if (!context->nodeIds->markOutput(context->obj))
+    {
+        return;
+    }
+
+    bool isPackage = context->obj->IsA(GenericPackage_UL);
+    if (isPackage)
     {
         dotFile->startCluster(dotFile->getNextClusterId());
+        recordTracks(context);
     }
 
-    dotFile->startNode(getNodeId(context->obj->GetString(InstanceUID_UL), context->oidToNodeId));
+    dotFile->startNode(context->nodeIds->getNodeId(context->obj));
     DotObjectAttribute oa;
     oa.setMaxPropertyWidth(60);
     oa.setId("label");
@@ -277,7 +386,7 @@ void outputObject(DotFile* dotFile, OutputContext* context)
         outputProperty(dotFile, context);
     }
     
-    if (context->obj->IsA(GenericPackage_UL))
+    if (isPackage)
     {
         dotFile->endCluster();
     }
@@ -290,13 +399,12 @@ void outputProperty(DotFile* dotFile, OutputContext* context)
     {
         if (!context->doSimple())
         {
-            string thisInstanceUID = context->obj->GetString(InstanceUID_UL); 
-            string targetInstanceUID = context->prop->GetLink()->GetString(InstanceUID_UL);
+            MDObjectPtr target = context->prop->GetLink();
+            string sourceId = context->nodeIds->getNodeId(context->obj);
+            string targetId = context->nodeIds->getNodeId(target);
             if (context->prop->GetRefType() == DICT_REF_STRONG)
             {
                 // Strong reference value
-                string sourceId = getNodeId(thisInstanceUID, context->oidToNodeId);
-                string targetId = getNodeId(targetInstanceUID, context->oidToNodeId);
                 dotFile->startEdge(sourceId, targetId);
                 dotFile->writeAttribute("weight", "5.0");
                 if (context->inArrayOrBatch())
@@ -305,14 +413,12 @@ void outputProperty(DotFile* dotFile, OutputContext* context)
                 }
                 dotFile->endEdge();
                 OutputContext newContext = *context;
-                newContext.obj = context->prop->GetLink();
+                newContext.obj = target;
                 outputObject(dotFile, &newContext);
             }
             else
             {
                 // Weak reference value
-                string sourceId = getNodeId(thisInstanceUID, context->oidToNodeId);
-                string targetId = getNodeId(targetInstanceUID, context->oidToNodeId);
                 dotFile->startEdge(sourceId, targetId);
                 dotFile->writeAttribute("color", "blue");
                 dotFile->writeAttribute("weight", "0.5");
@@ -336,7 +442,7 @@ void outputProperty(DotFile* dotFile, OutputContext* context)
         }
         else
         {
-            if (context->prop->Value)
+            if (!isReferenceArray(context->prop))
             {
                 // Simple value or value with unknown type
                 if (context->doSimple())
@@ -350,21 +456,17 @@ void outputProperty(DotFile* dotFile, OutputContext* context)
                     if (context->prop->IsA(SourcePackageID_UL) && 
                         context->obj->Child(SourceTrackID_UL))
                     {
-                        string oid = getSourceRefTarget(context->prop->GetString(),
+                        string target = getSourceRefTarget(context->prop->GetString(),
                             context->obj->Child(SourceTrackID_UL)->GetString());
-                        if (haveNodeId(oid, context->oidToNodeId))
-                        {
-                            string sourceId = getNodeId(context->obj->GetString(InstanceUID_UL), context->oidToNodeId);
-                            string targetId = getNodeId(oid, context->oidToNodeId);
-                            // source package references will be output at the end, outside the clusters
-                            context->sourceRefs->push_back(pair<string, string>(sourceId, targetId));
-                        }
+                        string sourceId = context->nodeIds->getNodeId(context->obj);
+                        // source package references will be output at the end, outside the clusters
+                        context->sourceRefs->push_back(pair<string, string>(sourceId, target));
                     }
                 }
             }
             else
             {
-                // Array or batch value
+                // Array or batch of references
                 context->setInArrayOrBatch(true);
                 MDObjectPtr prop = context->prop;
                 MDObjectULList::iterator itemIter;
@@ -381,25 +483,21 @@ void outputProperty(DotFile* dotFile, OutputContext* context)
 
 
 
-// Record mapping from object InstanceUID and source reference target PackageUID/TrackId combination 
-// to dot node ids
+// Find the root metadata object
 // The Preface object in a Closed Complete Header or Complete Footer is our root metadata object  
-void preprocessObjects(int partitionNum, DotFile* dotFile, MXFFilePtr mxfFile, 
-    map<string, string>& oidToNodeId, MDObjectPtr& root)
+void findRoot(int partitionNum, MXFFilePtr mxfFile, PartitionPtr& partition, MDObjectPtr& root)
 {
     mxfFile->GetRIP();
 
     root = 0;
     
-    map<string, string> trackNodeIds;
-    
     bool foundPartition = false;
     int partitionCount = 0;
     RIP::iterator iter;
     for (iter = mxfFile->FileRIP.begin(); iter != mxfFile->FileRIP.end(); iter++)
     {
         mxfFile->Seek((*iter).second->ByteOffset);
-        PartitionPtr partition = mxfFile->ReadPartition();
+        partition = mxfFile->ReadPartition();
         if (partition)
         {
             if (    (partitionNum == partitionCount) 
@@ -416,76 +514,14 @@ void preprocessObjects(int partitionNum, DotFile* dotFile, MXFFilePtr mxfFile,
                 
                 if (partition->ReadMetadata())
                 {
+                    // the Preface is our root
                     MDObjectList::iterator objIter;
                     for (objIter = partition->AllMetadata.begin(); objIter != partition->AllMetadata.end(); objIter++)
                     {
-                        // the Preface is our root
                         if ((*objIter)->IsA(Preface_UL))
                         {
                             root = *objIter;
-                        }
-                        
-                        // record InstanceUID to Dot node ID mapping for every metadata object
-                        string uid = (*objIter)->GetString(InstanceUID_UL);
-                        if (uid.length() > 0)
-                        {
-                            string nodeId;
-                            if ((*objIter)->IsA(Track_UL))
-                            {
-                                map<string, string>::const_iterator trackNodeIdIter = trackNodeIds.find(uid);
-                                // use existing track node id
-                                if (trackNodeIdIter != trackNodeIds.end())
-                                {
-                                    nodeId = (*trackNodeIdIter).second;
-                                }
-                                // else create a new one
-                                else
-                                {
-                                    nodeId = dotFile->getNextNodeId();
-                                    trackNodeIds.insert(pair<string, string>(uid, nodeId));
-                                }
-                            }
-                            else
-                            {
-                                nodeId = dotFile->getNextNodeId();
-                            }
-                            oidToNodeId.insert(pair<string, string>(uid, nodeId));
-                            
-                            // record PackageUID/TrackId combination to a Track node id by traversing
-                            // from the Package (to get the PackageUID) to the child Tracks
-                            if ((*objIter)->IsA(GenericPackage_UL))
-                            {
-                                string packageId = (*objIter)->GetString(PackageUID_UL);
-                                MDObjectPtr tracks = (*objIter)->Child(Tracks_UL);
-                                if (tracks)
-                                {
-                                    MDObjectULList::iterator trackIter;
-                                    for (trackIter = tracks->begin(); trackIter != tracks->end(); trackIter++)
-                                    {
-                                        MDObjectPtr track = (*trackIter).second;
-                                        if (track->GetLink())
-                                        {
-                                            string trackUID = track->GetLink()->GetString(InstanceUID_UL);
-                                            string trackId = track->GetLink()->GetString(TrackID_UL);
-                                            string trackNodeId;
-                                            map<string, string>::const_iterator trackNodeIdIter = trackNodeIds.find(trackUID);
-                                            // use existing track node id
-                                            if (trackNodeIdIter != trackNodeIds.end())
-                                            {
-                                                trackNodeId = (*trackNodeIdIter).second;
-                                            }
-                                            // else create a new one 
-                                            else
-                                            {
-                                                trackNodeId = dotFile->getNextNodeId();
-                                                trackNodeIds.insert(pair<string, string>(trackUID, trackNodeId));
-                                            }
-                                            oidToNodeId.insert(pair<string, string>(
-                                                getSourceRefTarget(packageId, trackId), trackNodeId));
-                                        }
-                                    }
-                                }
-                            }
+                            break;
                         }
                     }
                     break;
@@ -516,11 +552,10 @@ void preprocessObjects(int partitionNum, DotFile* dotFile, MXFFilePtr mxfFile,
 
 int convert(int partitionNum, MXFFilePtr mxfFile, DotFile* dotFile)
 {
-    map<string, string> oidToNodeId;
+    // DRAGONS: The partition is kept until the output is complete as it owns the metadata
+    PartitionPtr partition;
     MDObjectPtr root;
-    // the first pass records info which is used when traversing and outputting 
-    // the object tree later
-    preprocessObjects(partitionNum, dotFile, mxfFile, oidToNodeId, root);
+    findRoot(partitionNum, mxfFile, partition, root);
     if (!root)
     {
         mxf2dotError("No valid Preface object found\n");
@@ -543,19 +578,27 @@ int convert(int partitionNum, MXFFilePtr mxfFile, DotFile* dotFile)
     dotFile->writeAttribute("weight", "1");
     dotFile->endDefaultAttributes();
     
-    // output by traversing the object tree
+    // output by traversing the object tree once, writing each package cluster as it is reached
+    NodeIdMap nodeIds;
     vector<pair<string, string> > sourceRefs;
+    map<string, string> trackNodeIds;
     OutputContext context;
     context.obj = root;
+    context.nodeIds = &nodeIds;
     context.sourceRefs = &sourceRefs;
-    context.oidToNodeId = &oidToNodeId;
+    context.trackNodeIds = &trackNodeIds;
     outputObject(dotFile, &context);
 
     // output source package references which must be output outside clusters
     vector<pair<string, string> >::const_iterator iter;
     for (iter = sourceRefs.begin(); iter != sourceRefs.end(); iter++)
     {
-        dotFile->startEdge((*iter).first, (*iter).second);
+        map<string, string>::const_iterator track = trackNodeIds.find((*iter).second);
+        if (track == trackNodeIds.end())
+        {
+            continue;
+        }
+        dotFile->startEdge((*iter).first, (*track).second);
         dotFile->writeAttribute("color", "orange");
         dotFile->writeAttribute("weight", "10.0");
         dotFile->endEdge();
@@ -40,6 +40,210 @@ bool Hashing = false;
 bool ForceKeyMode = false;
 
 
+//! The pool used for parallel encryption or decryption, or NULL to process each triplet as it is read
+CryptPoolPtr Pool;
+
+
+namespace
+{
+	//! Number of bytes encrypted or decrypted in each call to OpenSSL
+	/*! This is small enough for each slice to still be in the cache when it is hashed */
+	const size_t CryptSliceSize = 64 * 1024;
+
+	//! Largest triplet that will be passed to a CryptPool, larger ones are processed a piece at a time as they are read
+	const Length MaxPoolTripletSize = 64 * 1024 * 1024;
+
+	//! Write a complete KLV to a new memory buffer, reading (and so encrypting or decrypting) its value as GCWriter::WriteRaw() would
+	DataChunkPtr WriteToMemory(KLVObjectPtr Object)
+	{
+		DataChunkPtr Ret = new DataChunk;
+
+		MXFFilePtr Mem = new MXFFile;
+		Mem->OpenMemory(Ret);
+
+		Object->SetDestination(Mem, 0);
+		Object->WriteKL();
+
+		Position Offset = 0;
+		for(;;)
+		{
+			size_t Bytes = Object->ReadDataFrom(Offset, 2 * CryptSliceSize);
+			if(!Bytes) break;
+
+			Object->WriteDataTo(Offset);
+			Offset += Bytes;
+		}
+
+		return Ret;
+	}
+
+	//! Read a KLVObject back from a buffer filled by WriteToMemory()
+	KLVObjectPtr ReadFromMemory(DataChunkPtr &Buffer)
+	{
+		MXFFilePtr Mem = new MXFFile;
+		Mem->OpenMemory(Buffer);
+		Mem->Seek(0);
+
+		return Mem->ReadKLV();
+	}
+
+	//! A triplet to be encrypted by a CryptPool
+	class EncryptJob : public CryptJob
+	{
+	protected:
+		GCReadHandlerPtr Handler;					//!< The handler that will write the result
+		Encrypt_GCReadHandler *ThisHandler;			//!< Handler, as its real type
+		KLVEObjectPtr KLVE;							//!< The encrypted version of the source triplet, which is held in memory
+		DataChunkPtr Result;						//!< The complete encrypted triplet, once processed
+
+	public:
+		EncryptJob(Encrypt_GCReadHandler *Handler, KLVEObjectPtr &KLVE) : Handler(Handler), ThisHandler(Handler), KLVE(KLVE) {}
+
+		void Process(void)
+		{
+			Result = WriteToMemory(SmartPtr_Cast(KLVE, KLVObject));
+
+			// Free the plaintext as soon as we can
+			KLVE = NULL;
+		}
+
+		void Complete(void)
+		{
+			KLVObjectPtr Object = ReadFromMemory(Result);
+			if(Object) ThisHandler->WriteEncrypted(Object);
+		}
+	};
+
+	//! A triplet to be decrypted by a CryptPool
+	class DecryptJob : public CryptJob
+	{
+	protected:
+		GCReaderPtr Caller;							//!< The reader that will dispatch the result
+		KLVEObjectPtr KLVE;							//!< The decrypting version of the source triplet, which is held in memory
+		DataChunkPtr Result;						//!< The complete decrypted triplet, once processed
+
+	public:
+		DecryptJob(GCReaderPtr &Caller, KLVEObjectPtr &KLVE) : Caller(Caller), KLVE(KLVE) {}
+
+		void Process(void)
+		{
+			// Read the encryption header so that the plaintext key and length are known before the KL is written
+			KLVE->GetUL();
+
+			Result = WriteToMemory(SmartPtr_Cast(KLVE, KLVObject));
+
+			// Free the encrypted data as soon as we can
+			KLVE = NULL;
+		}
+
+		void Complete(void)
+		{
+			KLVObjectPtr Object = ReadFromMemory(Result);
+			if(Object) Caller->HandleData(Object);
+		}
+	};
+}
+
+
+// ============================================================================
+//! A task that processes one job for a CryptPool
+// ============================================================================
+class CryptTask : public Task
+{
+protected:
+	CryptPool *Pool;								//!< The pool we work for
+	std::list<CryptPool::QueuedJob>::iterator Item;	//!< Our job in the pool's queue
+
+public:
+	CryptTask(CryptPool *Pool, std::list<CryptPool::QueuedJob>::iterator Item) : Pool(Pool), Item(Item) {}
+
+	void Run(void)
+	{
+		TraceScope Trace("CryptJob", "crypto");
+		(*Item).Job->Process();
+		Pool->JobDone(Item);
+	}
+};
+
+
+//! Start a pool using the shared TaskExecutor
+CryptPool::CryptPool(size_t MaxQueued /*=0*/) : MaxQueued(MaxQueued)
+{
+	unsigned int Workers = GetTaskExecutor().GetWorkers();
+	if(Workers < 1) Workers = 1;
+
+	if(this->MaxQueued == 0) this->MaxQueued = 2 * Workers;
+}
+
+
+//! Wait for any jobs still being processed
+CryptPool::~CryptPool()
+{
+	Tasks.Wait();
+}
+
+
+//! Add a job to the pool, completing any others that are ready
+void CryptPool::Submit(CryptJobPtr Job)
+{
+	QueuedJob Item;
+	Item.Job = Job;
+	Item.Done = false;
+
+	// DRAGONS: Iterators to the list remain valid while other items are added and removed, and a job is only removed once done
+	std::list<QueuedJob>::iterator it;
+	{
+		MutexLock Locked(Lock);
+		Queue.push_back(Item);
+		it = Queue.end();
+		it--;
+	}
+
+	// If the executor has no workers this processes the job now
+	Tasks.Submit(new CryptTask(this, it));
+
+	// Leave room for the next job
+	CompleteReady(MaxQueued - 1);
+}
+
+
+//! Complete finished jobs, in order, until no more than a given number remain
+void CryptPool::CompleteReady(size_t MaxRemaining)
+{
+	Lock.Lock();
+	for(;;)
+	{
+		// Complete (outside the lock) any jobs that are done, in order
+		if((!Queue.empty()) && Queue.front().Done)
+		{
+			CryptJobPtr Job = Queue.front().Job;
+			Queue.pop_front();
+
+			Lock.Unlock();
+			Job->Complete();
+			Lock.Lock();
+
+			continue;
+		}
+
+		if(Queue.size() <= MaxRemaining) break;
+
+		Changed.Wait(Lock);
+	}
+	Lock.Unlock();
+}
+
+
+//! Mark a job as processed
+void CryptPool::JobDone(std::list<QueuedJob>::iterator Item)
+{
+	MutexLock Locked(Lock);
+
+	(*Item).Done = true;
+	Changed.Broadcast();
+}
+
+
 //! Build an AS-DCP hashing key from a given crypto key
 /*  The hashing key is: 
  *  - trunc( HMAC-SHA-1( CipherKey, 0x00112233445566778899aabbccddeeff ) )
@@ -64,6 +268,28 @@ DataChunkPtr BuildHashKey(size_t Size, const UInt8 *CryptoKey)
 }
 
 
+//! Initialize this object
+HashHMACSHA1::HashHMACSHA1() : KeyInited(false)
+{
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	Context = EVP_MD_CTX_create();
+#else
+	Context = EVP_MD_CTX_new();
+#endif
+}
+
+
+//! Free the SHA-1 context
+HashHMACSHA1::~HashHMACSHA1()
+{
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	EVP_MD_CTX_destroy(Context);
+#else
+	EVP_MD_CTX_free(Context);
+#endif
+}
+
+
 //! Set the key and start hashing
 /*  \return True if key is accepted
  */
@@ -92,8 +318,12 @@ bool HashHMACSHA1::SetKey(size_t Size, const UInt8 *Key)
 	}
 
 	// Initialize the SHA-1 algorythm and inject the inner key
-	SHA1_Init(&Context);
-	SHA1_Update(&Context, KeyBuffer_i, 64);
+	if((!Context) || (!EVP_DigestInit_ex(Context, EVP_sha1(), NULL)))
+	{
+		error("Unable to initialize SHA-1 in HashHMACSHA1::SetKey()\n");
+		return false;
+	}
+	EVP_DigestUpdate(Context, KeyBuffer_i, 64);
 
 	KeyInited = true;
 
@@ -123,13 +353,7 @@ void HashHMACSHA1::HashData(size_t Size, const UInt8 *Data)
 		return;
 	}
 
-	if((sizeof(size_t) > 4) &&(Size > 0xffffffff))
-	{
-		error("Maximum hashable chunk size in HashHMACSHA1::HashData() is 4GBytes\n");
-		return;
-	}
-
-	SHA1_Update(&Context, Data, static_cast<unsigned long>(Size));
+	EVP_DigestUpdate(Context, Data, Size);
 }
 
 
@@ -141,13 +365,13 @@ DataChunkPtr HashHMACSHA1::GetHash(void)
 	DataChunkPtr Ret = new DataChunk;
 	Ret->Resize(20);
 
-	SHA1_Final(Ret->Data, &Context);
+	EVP_DigestFinal_ex(Context, Ret->Data, NULL);
 
 	// Hash the inner hash with the outer key
-	SHA1_Init(&Context);
-	SHA1_Update(&Context, KeyBuffer_o, 64);
-	SHA1_Update(&Context, Ret->Data, static_cast<unsigned long>(Ret->Size));
-	SHA1_Final(Ret->Data, &Context);
+	EVP_DigestInit_ex(Context, EVP_sha1(), NULL);
+	EVP_DigestUpdate(Context, KeyBuffer_o, 64);
+	EVP_DigestUpdate(Context, Ret->Data, Ret->Size);
+	EVP_DigestFinal_ex(Context, Ret->Data, NULL);
 
 /*
 printf("Hash is:");
@@ -162,18 +386,85 @@ printf("\n");
 
 
 
+//! Initialize this object
+AESEncrypt::AESEncrypt() : NeedInit(true)
+{
+	Context = EVP_CIPHER_CTX_new();
+
+	memset(CurrentKey, 0, 16);
+	memset(CurrentIV, 0, 16);
+}
+
+
+//! Free the cipher context
+AESEncrypt::~AESEncrypt()
+{
+	if(Context) EVP_CIPHER_CTX_free(Context);
+}
+
+
 //! Encrypt data and return in a new buffer
 /*! \return NULL pointer if the encryption is unsuccessful
+ *  \note The output is chained from the output of the previous call, until the key or IV is set again
  */
 DataChunkPtr AESEncrypt::Encrypt(size_t Size, const UInt8 *Data)
 {
+	if(!Context) return NULL;
+
+	if(NeedInit)
+	{
+		if(!EVP_EncryptInit_ex(Context, EVP_aes_128_cbc(), NULL, CurrentKey, CurrentIV))
+		{
+			error("Unable to initialize AES encryption\n");
+			return NULL;
+		}
+
+		// We pad the final block ourselves
+		EVP_CIPHER_CTX_set_padding(Context, 0);
+		NeedInit = false;
+	}
+
 	// Calculate size of encrypted data (always a multiple of 16-bytes)
 	size_t RetSize = (Size + 15) / 16;
 	RetSize *= 16;
 
 	DataChunkPtr Ret = new DataChunk(RetSize);
 
-	AES_cbc_encrypt(Data, Ret->Data, static_cast<unsigned long>(Size), &CurrentKey, CurrentIV, AES_ENCRYPT);
+	// Encrypt all complete blocks a slice at a time, hashing each slice while it is still in the cache
+	size_t WholeSize = Size & ~static_cast<size_t>(15);
+	size_t Offset = 0;
+	while(Offset < RetSize)
+	{
+		size_t SliceSize = WholeSize - Offset;
+		if(SliceSize > CryptSliceSize) SliceSize = CryptSliceSize;
+
+		const UInt8 *Source = &Data[Offset];
+
+		// The final partial block is padded with zeros
+		UInt8 LastBlock[16];
+		if(SliceSize == 0)
+		{
+			memset(LastBlock, 0, 16);
+			memcpy(LastBlock, Source, Size - Offset);
+			Source = LastBlock;
+			SliceSize = 16;
+		}
+
+		int OutSize;
+		if((!EVP_EncryptUpdate(Context, &Ret->Data[Offset], &OutSize, Source, static_cast<int>(SliceSize))) || (OutSize != static_cast<int>(SliceSize)))
+		{
+			error("AES encryption failed\n");
+			NeedInit = true;
+			return NULL;
+		}
+
+		if(OutputHasher) OutputHasher->HashData(SliceSize, &Ret->Data[Offset]);
+
+		Offset += SliceSize;
+	}
+
+	// Keep the IV in step with the context so that GetIV() is valid
+	if(RetSize) memcpy(CurrentIV, &Ret->Data[RetSize - 16], 16);
 
 	return Ret;
 }
@@ -263,6 +554,41 @@ bool Encrypt_GCReadHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
 //	printf("0x%08x -> %02x:0x%08x Data for Track 0x%08x, ", (int)Object->GetLocation(), OurSID, (int)Caller->GetStreamOffset(), Object->GetGCTrackNumber());
 //	printf("Size = 0x%08x\n", (int)Object->GetLength());
 
+	// Set an encryption IV
+	// DRAGONS: The current draft AS-DCP specification requires this to be an encryption strength random number generator.
+	//          However as the IV is always sent in plaintext there is no advantage doing this.
+	//          In fact it is actually more secure to use sequential IVs starting at some moderately random value
+	// TODO: Make IVs sequential
+	// DRAGONS: The IV is chosen here, even when using a pool, so that the IVs used do not depend on the number of threads
+	UInt8 IV[16];
+	int i; for(i=0; i<16; i++) IV[i] = (UInt8) rand();
+
+	// Pass the triplet to the pool if we are using one, it must be read into memory first as the workers cannot use the source file
+	if(Pool && (Object->GetLength() <= MaxPoolTripletSize))
+	{
+		DataChunkPtr Plaintext = WriteToMemory(Object);
+		KLVObjectPtr MemObject = ReadFromMemory(Plaintext);
+		if(!MemObject) return false;
+
+		KLVEObjectPtr KLVE = MakeKLVE(MemObject, IV);
+		Pool->Submit(new EncryptJob(this, KLVE));
+
+		return true;
+	}
+
+	// Otherwise flush anything in the pool and encrypt this triplet as it is written
+	if(Pool) Pool->Flush();
+
+	KLVEObjectPtr KLVE = MakeKLVE(Object, IV);
+	WriteEncrypted(SmartPtr_Cast(KLVE, KLVObject));
+
+	return true;
+}
+
+
+//! Set up an encrypted version of a KLVObject
+KLVEObjectPtr Encrypt_GCReadHandler::MakeKLVE(KLVObjectPtr &Object, const UInt8 *IV)
+{
 	// Create an encrypted vertion of this KLVObject
 	KLVEObjectPtr KLVE = new KLVEObject(Object);
 
@@ -285,15 +611,16 @@ bool Encrypt_GCReadHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
 	}
 
 
-	// Set an encryption IV
-	// DRAGONS: The current draft AS-DCP specification requires this to be an encryption strength random number generator.
-	//          However as the IV is always sent in plaintext there is no advantage doing this.
-	//          In fact it is actually more secure to use sequential IVs starting at some moderately random value
-	// TODO: Make IVs sequential
-	UInt8 IV[16];
-	int i; for(i=0; i<16; i++) IV[i] = (UInt8) rand();
+	// Set the encryption IV
 	KLVE->SetEncryptIV(16, IV, true);
 
+	return KLVE;
+}
+
+
+//! Write an encrypted triplet, updating the index table
+void Encrypt_GCReadHandler::WriteEncrypted(KLVObjectPtr Object)
+{
 	// Update the index table to the new position
 	if(Index)
 	{
@@ -301,12 +628,10 @@ bool Encrypt_GCReadHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
 	}
 
 	// Write the encrypted data
-	Writer->WriteRaw(SmartPtr_Cast(KLVE, KLVObject));
+	Writer->WriteRaw(Object);
 
 	// Update the index position count (even if not yet indexing)
 	IndexPos++;
-
-	return true;
 }
 
 
@@ -315,17 +640,79 @@ bool Encrypt_GCReadHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
  */
 DataChunkPtr AESDecrypt::Decrypt(size_t Size, const UInt8 *Data)
 {
-	if((sizeof(size_t) > 4) &&(Size > 0xffffffff))
+	DataChunkPtr Ret = new DataChunk(Size);
+
+	if(!DecryptTo(Size, Data, Ret->Data)) return NULL;
+
+	return Ret;
+}
+
+
+//! Decrypt data into a given buffer, which may be the same as the source
+/*! \return true if the decryption <i>appears to be</i> successful
+ */
+bool AESDecrypt::DecryptTo(size_t Size, const UInt8 *Data, UInt8 *Dest)
+{
+	if(!Context) return false;
+
+	if(Size % 16)
 	{
-		error("Maximum chunk size in AESDecrypt::Decrypt() is 4GBytes\n");
-		return NULL;
+		error("AES decryption requires a multiple of 16 bytes, tried to decrypt %d bytes\n", (int)Size);
+		return false;
 	}
 
-	DataChunkPtr Ret = new DataChunk(Size);
+	if(NeedInit)
+	{
+		if(!EVP_DecryptInit_ex(Context, EVP_aes_128_cbc(), NULL, CurrentKey, CurrentIV))
+		{
+			error("Unable to initialize AES decryption\n");
+			return false;
+		}
 
-	AES_cbc_encrypt(Data, Ret->Data, static_cast<unsigned long>(Size), &CurrentKey, CurrentIV, AES_DECRYPT);
+		// The padding is removed by the caller
+		EVP_CIPHER_CTX_set_padding(Context, 0);
+		NeedInit = false;
+	}
 
-	return Ret;
+	// The last block of ciphertext is the IV for the next decryption
+	// DRAGONS: This must be copied before decrypting as the ciphertext is overwritten when decrypting in place
+	if(Size) memcpy(CurrentIV, &Data[Size - 16], 16);
+
+	size_t Offset = 0;
+	while(Offset < Size)
+	{
+		size_t SliceSize = Size - Offset;
+		if(SliceSize > CryptSliceSize) SliceSize = CryptSliceSize;
+
+		int OutSize;
+		if((!EVP_DecryptUpdate(Context, &Dest[Offset], &OutSize, &Data[Offset], static_cast<int>(SliceSize))) || (OutSize != static_cast<int>(SliceSize)))
+		{
+			error("AES decryption failed\n");
+			NeedInit = true;
+			return false;
+		}
+
+		Offset += SliceSize;
+	}
+
+	return true;
+}
+
+
+//! Initialize this object
+AESDecrypt::AESDecrypt() : NeedInit(true)
+{
+	Context = EVP_CIPHER_CTX_new();
+
+	memset(CurrentKey, 0, 16);
+	memset(CurrentIV, 0, 16);
+}
+
+
+//! Free the cipher context
+AESDecrypt::~AESDecrypt()
+{
+	if(Context) EVP_CIPHER_CTX_free(Context);
 }
 
 
@@ -410,6 +797,32 @@ bool Decrypt_GCEncryptionHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Ob
 //	printf("0x%08x -> %02x:0x%08x Encrypted data, ", (int)Object->GetLocation(), OurSID, (int)Caller->GetStreamOffset());
 //	printf("Size = 0x%08x\n", (int)Object->GetLength());
 
+	// Pass the triplet to the pool if we are using one, it must be read into memory first as the workers cannot use the source file
+	if(Pool && (Object->GetLength() <= MaxPoolTripletSize))
+	{
+		DataChunkPtr Encrypted = WriteToMemory(Object);
+		KLVObjectPtr MemObject = ReadFromMemory(Encrypted);
+		if(!MemObject) return false;
+
+		KLVEObjectPtr KLVE = MakeKLVE(MemObject);
+		Pool->Submit(new DecryptJob(Caller, KLVE));
+
+		return true;
+	}
+
+	// Otherwise flush anything in the pool and decrypt this triplet as it is written
+	if(Pool) Pool->Flush();
+
+	// Pass decryption wrapped data back for handling
+	Caller->HandleData(SmartPtr_Cast(MakeKLVE(Object), KLVObject));
+
+	return true;
+}
+
+
+//! Set up a decrypting version of a KLVObject
+KLVEObjectPtr Decrypt_GCEncryptionHandler::MakeKLVE(KLVObjectPtr &Object)
+{
 	KLVEObjectPtr KLVE = new KLVEObject(Object);
 
 	// Set a decryption wrapper
@@ -428,10 +841,7 @@ bool Decrypt_GCEncryptionHandler::HandleData(GCReaderPtr Caller, KLVObjectPtr Ob
 		Hasher->SetKey(HashKey);
 	}
 
-	// Pass decryption wrapped data back for handling
-	Caller->HandleData(SmartPtr_Cast(KLVE, KLVObject));
-
-	return true;
+	return KLVE;
 }
 
 
@@ -32,9 +32,10 @@ using namespace mxflib;
 
 #include <stdlib.h>
 
-// Include AES encryption from OpenSSL
-#include "openssl/aes.h"
-#include "openssl/sha.h"
+// Include AES encryption and SHA-1 hashing from OpenSSL
+// DRAGONS: The EVP interface is used rather than the low-level AES and SHA functions so that
+//          OpenSSL can select hardware acceleration (such as AES-NI or the ARMv8 crypto extensions)
+#include "openssl/evp.h"
 
 
 //! True if we are doing hashing calculations
@@ -44,6 +45,95 @@ extern bool Hashing;
 extern bool ForceKeyMode;
 
 
+// ============================================================================
+//! A single triplet to be encrypted or decrypted by a CryptPool
+// ============================================================================
+class CryptJob : public RefCount<CryptJob>
+{
+public:
+	virtual ~CryptJob() {}
+
+	//! Encrypt or decrypt the triplet
+	/*! \note Called on a worker thread, so must not touch the input or output files */
+	virtual void Process(void) = 0;
+
+	//! Write out the result
+	/*! \note Called on the thread that submitted the job, in the order that jobs were submitted */
+	virtual void Complete(void) = 0;
+};
+
+//! Smart pointer to a CryptJob
+typedef SmartPtr<CryptJob> CryptJobPtr;
+
+
+// Forward declare the worker task class
+class CryptTask;
+
+// ============================================================================
+//! A pool that encrypts or decrypts triplets in parallel on the workers of the shared TaskExecutor
+/*! Each triplet has its own IV and check value so any number can be processed at once. The results are
+ *  written in the order that they were submitted, and the number of jobs queued or waiting to be written
+ *  is limited so that memory use stays bounded when the workers are faster than the output.
+ */
+// ============================================================================
+class CryptPool : public RefCount<CryptPool>
+{
+protected:
+	//! A job, with its progress
+	struct QueuedJob
+	{
+		CryptJobPtr Job;							//!< The job
+		bool Done;									//!< True once Process() has returned
+	};
+
+	Mutex Lock;										//!< Lock protecting all the following
+	Condition Changed;								//!< Signalled whenever a job is finished
+	std::list<QueuedJob> Queue;						//!< Jobs not yet completed, in the order they were submitted
+	size_t MaxQueued;								//!< Maximum number of jobs in Queue
+	TaskGroup Tasks;								//!< The tasks processing our jobs
+
+	friend class CryptTask;
+
+public:
+	//! Start a pool using the shared TaskExecutor
+	/*! \param MaxQueued The maximum number of jobs that may be waiting to be processed or written, or 0 for twice the number of workers */
+	CryptPool(size_t MaxQueued = 0);
+
+	//! Wait for any jobs still being processed
+	/*! \note Any jobs not yet completed are discarded, so Flush() should be called first */
+	~CryptPool();
+
+	//! Add a job to the pool, completing any others that are ready
+	/*! Waits, completing jobs as they finish, while the pool is full */
+	void Submit(CryptJobPtr Job);
+
+	//! Wait for all jobs to finish, completing each in turn
+	/*! This must be called before writing anything else to the output file, such as a new partition */
+	void Flush(void) { CompleteReady(0); }
+
+	//! Get the number of worker threads
+	unsigned int GetThreadCount(void) const { return GetTaskExecutor().GetWorkers(); }
+
+protected:
+	//! Complete finished jobs, in order, until no more than a given number remain
+	void CompleteReady(size_t MaxRemaining);
+
+	//! Mark a job as processed
+	/*! \note Called by the task that processed the job */
+	void JobDone(std::list<QueuedJob>::iterator Item);
+
+private:
+	//! Prevent copy construction
+	CryptPool(const CryptPool &);
+};
+
+//! Smart pointer to a CryptPool
+typedef SmartPtr<CryptPool> CryptPoolPtr;
+
+//! The pool used for parallel encryption or decryption, or NULL to process each triplet as it is read
+extern CryptPoolPtr Pool;
+
+
 //! Build an AS-DCP hashing key from a given crypto key
 /*  The hashing key is: 
  *  - trunc( HMAC-SHA-1( CipherKey, 0x00112233445566778899aabbccddeeff ) )
@@ -78,7 +168,7 @@ protected:
 	UInt8 KeyBuffer_i[64];					//!< Inner key buffer, holds key xor 0x36
 	UInt8 KeyBuffer_o[64];					//!< Outer key buffer, holds key xor 0x5c
 
-	SHA_CTX Context;						//!< Our SHA-1 context
+	EVP_MD_CTX *Context;					//!< Our SHA-1 context
 
 	bool KeyInited;							//!< True once the key has been initialized
 /*
@@ -87,7 +177,10 @@ FileHandle OutFile;
 
 public:
 	//! Initialize this object
-	HashHMACSHA1() : KeyInited(false) {}
+	HashHMACSHA1();
+
+	//! Free the SHA-1 context
+	~HashHMACSHA1();
 
 	//! Set the key and start hashing
 	/*  \return True if key is accepted
@@ -109,19 +202,35 @@ public:
 class AESEncrypt : public Encrypt_Base
 {
 protected:
-	AES_KEY CurrentKey;
+	EVP_CIPHER_CTX *Context;				//!< The OpenSSL cipher context
+	UInt8 CurrentKey[16];
 	UInt8 CurrentIV[16];
+	bool NeedInit;							//!< True if the context must be initialized with the current key and IV before use
+
+	HashPtr OutputHasher;					//!< Hasher to receive all encrypted data, or NULL if none
 
 public:
+	//! Initialize this object
+	AESEncrypt();
+
+	//! Free the cipher context
+	~AESEncrypt();
+
 	//! Set an encryption key
 	/*! \return True if key is accepted
 	 */
 	bool SetKey(size_t KeySize, const UInt8 *Key) 
 	{
-		int Ret = AES_set_encrypt_key(Key, 128, &CurrentKey);
+		if(KeySize != 16)
+		{
+			error("Key for AES encryption must by 16 bytes, tried to use key of size %d\n", (int)KeySize);
+			return false;
+		}
+
+		memcpy(CurrentKey, Key, 16);
+		NeedInit = true;
 
-		// Return true only if key setting was OK
-		return Ret ? false : true; 
+		return true;
 	};
 
 	//! Set an encryption Initialization Vector
@@ -143,6 +252,7 @@ public:
 		}
 
 		memcpy(CurrentIV, IV, 16);
+		NeedInit = true;
 
 		return true; 
 	};
@@ -172,6 +282,12 @@ public:
 	/*! \return NULL pointer if the encryption is unsuccessful
 	 */
 	DataChunkPtr Encrypt(size_t Size, const UInt8 *Data);
+
+	//! Pass all encrypted data to a hasher as it is produced
+	/*! Each slice of the output is hashed as soon as it is encrypted, while it is still in the cache
+	 *  \return true
+	 */
+	bool SetOutputHasher(HashPtr &Hasher) { OutputHasher = Hasher; return true; }
 };
 
 
@@ -209,6 +325,13 @@ public:
 
 	//! Set an index table to update with new byte offsets
 	void SetIndex(IndexTablePtr Index) { this->Index = Index; }
+
+	//! Write an encrypted triplet, updating the index table
+	void WriteEncrypted(KLVObjectPtr Object);
+
+protected:
+	//! Set up an encrypted version of a KLVObject
+	KLVEObjectPtr MakeKLVE(KLVObjectPtr &Object, const UInt8 *IV);
 };
 
 
@@ -245,19 +368,33 @@ public:
 class AESDecrypt : public Decrypt_Base
 {
 protected:
-	AES_KEY CurrentKey;
+	EVP_CIPHER_CTX *Context;				//!< The OpenSSL cipher context
+	UInt8 CurrentKey[16];
 	UInt8 CurrentIV[16];
+	bool NeedInit;							//!< True if the context must be initialized with the current key and IV before use
 
 public:
+	//! Initialize this object
+	AESDecrypt();
+
+	//! Free the cipher context
+	~AESDecrypt();
+
 	//! Set an encryption key
 	/*! \return True if key is accepted
 	 */
 	virtual bool SetKey(size_t KeySize, const UInt8 *Key) 
 	{
-		int Ret = AES_set_decrypt_key(Key, 128, &CurrentKey);
+		if(KeySize != 16)
+		{
+			error("Key for AES decryption must by 16 bytes, tried to use key of size %d\n", (int)KeySize);
+			return false;
+		}
 
-		// Return true only if key setting was OK
-		return Ret ? false : true; 
+		memcpy(CurrentKey, Key, 16);
+		NeedInit = true;
+
+		return true;
 	};
 
 	//! Set a decryption Initialization Vector
@@ -279,6 +416,7 @@ public:
 		}
 
 		memcpy(CurrentIV, IV, 16);
+		NeedInit = true;
 
 		return true; 
 	};
@@ -296,18 +434,25 @@ public:
 	//! Can this decryption system safely decrypt in place?
 	/*! If BlockSize is 0 this function will return true if decryption of all block sizes can be "in place".
 	 *  Otherwise the result will indicate whether the given blocksize can be decrypted "in place".
+	 *  \note Any whole number of AES blocks can be decrypted in place, and nothing else can be decrypted at all
 	 */
-	bool CanDecryptInPlace(size_t BlockSize = 0) { return false; }
+	bool CanDecryptInPlace(size_t BlockSize = 0) { return (BlockSize % 16) == 0; }
 
 	//! Decrypt data bytes in place
 	/*! \return true if the decryption <i>appears to be</i> successful
 	 */
-	bool DecryptInPlace(size_t Size, UInt8 *Data) { return false; }
+	bool DecryptInPlace(size_t Size, UInt8 *Data) { return DecryptTo(Size, Data, Data); }
 
 	//! Decrypt data and return in a new buffer
 	/*! \return true if the decryption <i>appears to be</i> successful
 	 */
 	DataChunkPtr Decrypt(size_t Size, const UInt8 *Data);
+
+protected:
+	//! Decrypt data into a given buffer, which may be the same as the source
+	/*! \return true if the decryption <i>appears to be</i> successful
+	 */
+	bool DecryptTo(size_t Size, const UInt8 *Data, UInt8 *Dest);
 };
 
 
@@ -336,6 +481,10 @@ public:
 
 	//! Determin if a valid key has been set
 	bool KeyValid(void) { return (DecKey.Size == 16); }
+
+protected:
+	//! Set up a decrypting version of a KLVObject
+	KLVEObjectPtr MakeKLVE(KLVObjectPtr &Object);
 };
 
 
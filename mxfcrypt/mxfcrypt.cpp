@@ -54,6 +54,9 @@ string PlatformName = "MXFLib (" + OSName() + ")";
 //! Plaintext offset to use when encrypting
 int PlaintextOffset = 0;
 
+//! Number of worker threads to use for encryption or decryption, or 0 to process each triplet as it is read
+int ThreadCount = 0;
+
 //! Name of keyfile or directoy to search for keyfiles with autogenerated names
 std::string KeyFileName;
 
@@ -96,6 +99,9 @@ IndexTablePtr Index;
 //! Original index data (if preserving the index unchanged)
 DataChunkPtr OriginalIndexData;
 
+//! File to write a timeline trace of library activity to, or empty for none
+std::string TraceFile;
+
 
 #include <time.h>
 
@@ -149,6 +155,19 @@ int main(int argc, char *argv[])
 				PlaintextOffset = atoi(&argv[i][3]);
 				printf("\nPlaintext Offset = %d\n", PlaintextOffset);
 			}
+			else if(strncmp(&argv[i][1], "trace=", 6) == 0)
+			{
+				TraceFile = &argv[i][7];
+			}
+			else if((argv[i][1] == 't') || (argv[i][1] == 'T'))
+			{
+				if((argv[i][2] != '=') && (argv[i][2] != ':'))
+				{
+					error("-t option syntax = -t=<threads>\n");
+					return 1;
+				}
+				ThreadCount = atoi(&argv[i][3]);
+			}
 		}
 	}
 
@@ -164,6 +183,9 @@ int main(int argc, char *argv[])
 		printf("  -h         Perform HMAC hashing\n");
 		printf("  -k=keyfile Use the specified key file\n");
 		printf("  -p=offset  Leave plaintext bytes at the start\n");
+		printf("  -t=n       Encrypt or decrypt using n threads\n");
+		printf("  -trace=<file>\n");
+		printf("             Write a timeline of library activity to <file> in Chrome trace format\n");
 		printf("  -ip        Preserve the existing index table values\n");
 		printf("  -l-        Don't update the EssenceContainers batch\n");
 		printf("  -l+        Do update the EssenceContainer value in the descriptor\n");
@@ -172,6 +194,8 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
+	// The trace is written when we exit
+	if(TraceFile.size() && !StartTrace(TraceFile)) warning("Unable to start a trace to \"%s\"\n", TraceFile.c_str());
 
 	MXFFilePtr InFile = new MXFFile;
 	if(!InFile->Open(argv[num_options+1], true))
@@ -188,6 +212,13 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
+	// Process triplets in parallel on the shared executor if required
+	if(ThreadCount > 0)
+	{
+		GetTaskExecutor().SetWorkers(ThreadCount);
+		Pool = new CryptPool;
+	}
+
 	/* Generate a key-file if not given and we are encrypting */
 	if(!DecryptMode)
 	{
@@ -418,7 +449,12 @@ int main(int argc, char *argv[])
 		Writer->SetKAG(CurrentPartition->GetUInt(KAGSize_UL));
 
 		// Parse the file until next partition or an error
-		if (!BodyParser->ReadFromFile()) break;
+		bool ReadOK = BodyParser->ReadFromFile();
+
+		// Write anything still being processed before the next partition
+		if(Pool) Pool->Flush();
+
+		if (!ReadOK) break;
 	}
 
 	// Write the footer partition
@@ -452,6 +488,9 @@ int main(int argc, char *argv[])
 	// Add a RIP
 	OutFile->WriteRIP();
 
+	// Stop the worker threads
+	Pool = NULL;
+
 	InFile->Close();
 
 	OutFile->Close();
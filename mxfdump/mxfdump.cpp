@@ -44,7 +44,13 @@ MXFLIB_DICTIONARY_END
 
 
 #include <stdio.h>
+#include <stdarg.h>
 #include <iostream>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
 
 using namespace std;
 
@@ -78,12 +84,30 @@ static bool DumpIDs = true;
 //! Flag for basic compiled dictionary as bootstrap when loading a metadictionary
 static bool BootstrapDict = false;
 
+//! Flag for reading the file via a memory mapping
+static bool MappedRead = false;
+
+//! Size of read-ahead buffer to use when reading the file, in KB (or 0 for none)
+static size_t ReadAheadKB = 0;
+static size_t CachedBlockKB = 0;
+
+//! List of files to summarise in batch mode, a directory to scan for MXF files, "-" for stdin or empty if not in batch mode
+static std::string BatchList;
+
+//! Number of worker threads to use in batch mode
+static unsigned int BatchThreads = 4;
+
+//! Flag for running a QC scan of the file instead of dumping it
+static bool QCMode = false;
+
 #ifdef OPTION3ENABLED
 //! Flag for diplaying baseline UL of sets unsing the ObjectClass extention mechanism
 static bool ShowBaseline = false;
 #endif // OPTION3ENABLED
 
-static void DumpObject(MDObjectPtr Object, std::string Prefix);
+static void DumpObject(MDObjectPtr Object);
+static bool OpenInputFile(MXFFilePtr &File, const char *FileName);
+static int RunBatch(void);
 
 
 namespace
@@ -104,6 +128,579 @@ namespace
 }
 
 
+//! Output formats for a single file dump
+enum DumpFormatEnum
+{
+	DumpFormatText,							//!< Indented text, one item per line
+	DumpFormatJSON,							//!< A single JSON document of nested nodes
+	DumpFormatXML							//!< A single XML document of nested elements
+};
+
+//! Format of the dump output
+static DumpFormatEnum DumpFormat = DumpFormatText;
+
+
+namespace
+{
+	//! Builds the dump of a file into a large buffer that is written out a block at a time, as text, JSON or XML
+	/*! The dump is a tree of nodes, opened by Begin() and closed by End(), with attributes added by Attr() before any
+	 *  child nodes. In text mode nodes only set the indentation of lines written by Line(), and attributes are ignored,
+	 *  while in JSON and XML modes only the nodes and attributes are written.
+	 *  The nesting is held as a stack of node states, so indentation is written from a block of spaces rather than
+	 *  building a prefix string at each level.
+	 */
+	class DumpWriter
+	{
+	protected:
+		//! State of an open node
+		struct Node
+		{
+			const char *Kind;				//!< The kind of node, used as the XML element name
+			bool Indent;					//!< True if text lines within this node are indented a level
+			bool HasChildren;				//!< True once a child node has been written
+		};
+
+		FILE *Out;							//!< The file written to
+		DumpFormatEnum Format;				//!< The output format
+		char *Buffer;						//!< The output buffer
+		size_t BufferSize;					//!< The size of the output buffer
+		size_t Used;						//!< The number of bytes in the buffer waiting to be written
+		std::vector<Node> Stack;			//!< The currently open nodes, innermost last
+		size_t TextDepth;					//!< The number of indentation levels for text lines
+		Position PendingLocation;			//!< Location to add to the next node opened, or -1 if none
+		bool Started;						//!< True once the document has been started
+
+		//! Messages waiting to be written as nodes, as kind and text
+		std::list<std::pair<const char *, std::string> > Messages;
+
+	public:
+		//! Build a writer for a given file and format
+		DumpWriter(FILE *Out, DumpFormatEnum Format, size_t BufferSize = 1024 * 1024)
+			: Out(Out), Format(Format), BufferSize(BufferSize), Used(0), TextDepth(0), PendingLocation(-1), Started(false)
+		{
+			Buffer = new char[BufferSize];
+		}
+
+		//! Close any open nodes and write out the buffer
+		~DumpWriter();
+
+		//! Determine if this writer produces text, rather than structured, output
+		bool IsText(void) const { return Format == DumpFormatText; }
+
+		//! Write a line of text at the current indentation, with a newline added (text mode only)
+		void Line(const char *Fmt, ...);
+
+		//! Note the location of the next item (written at once in text mode, added to the next node otherwise)
+		void Location(Position Pos);
+
+		//! Add a message reported while dumping
+		/*! In text mode it is written at once, prefixed by Lead, otherwise it is held to be written as a node */
+		void Message(const char *Kind, const char *Lead, const char *Fmt, va_list args);
+
+		//! Open a node
+		/*! \param Kind The kind of node
+		 *  \param Indent True if text lines within this node are indented a further level
+		 */
+		void Begin(const char *Kind, bool Indent = true);
+
+		//! Add an attribute to the node most recently opened, which must not yet have any child nodes
+		void Attr(const char *Name, const std::string &Value);
+
+		//! Add an integer attribute to the node most recently opened
+		void Attr(const char *Name, Int64 Value);
+
+		//! Add an integer attribute in hex to the node most recently opened
+		void HexAttr(const char *Name, UInt64 Value, int Digits);
+
+		//! Close the node most recently opened
+		void End(void);
+
+		//! Close all open nodes, writing any messages not yet written
+		void Finish(void);
+
+		//! Write out the buffer
+		void Flush(void)
+		{
+			if(Used) fwrite(Buffer, 1, Used, Out);
+			Used = 0;
+		}
+
+	protected:
+		//! Add a single character to the buffer
+		void Put(char c)
+		{
+			if(Used == BufferSize) Flush();
+			Buffer[Used++] = c;
+		}
+
+		//! Add bytes to the buffer
+		void Write(const char *Data, size_t Size);
+
+		//! Add a null-terminated string to the buffer
+		void Write(const char *Text) { Write(Text, strlen(Text)); }
+
+		//! Add a string to the buffer, escaped for the output format
+		void WriteEscaped(const std::string &Text);
+
+		//! Add a newline and a given number of levels of indentation to the buffer
+		void NewLine(size_t Depth);
+
+		//! Format into the free space of the buffer
+		/*! \return false if the result did not fit, when nothing is added and the format should be retried with WriteFormatted() */
+		bool TryFormat(const char *Fmt, va_list args);
+
+		//! Format directly to the file, for results too big for the buffer
+		void WriteFormatted(const char *Fmt, va_list args)
+		{
+			Flush();
+			vfprintf(Out, Fmt, args);
+		}
+
+		//! Write any held messages as nodes
+		void WriteMessages(void);
+	};
+
+	//! The writer of the current single file dump, or NULL if not dumping a single file
+	DumpWriter *Output = NULL;
+
+	//! A block of spaces for indentation
+	const char IndentSpaces[] = "                                                                ";
+
+	//! The number of spaces written for each level of indentation
+	const size_t IndentSize = 2;
+
+	//! The free space that the buffer is flushed to leave before formatting into it
+	const size_t FormatSpace = 4096;
+
+
+	DumpWriter::~DumpWriter()
+	{
+		Finish();
+		Flush();
+
+		delete[] Buffer;
+
+		if(Output == this) Output = NULL;
+	}
+
+
+	void DumpWriter::Line(const char *Fmt, ...)
+	{
+		if(Format != DumpFormatText) return;
+
+		size_t Count = TextDepth * IndentSize;
+		while(Count)
+		{
+			size_t Chunk = (Count < sizeof(IndentSpaces) - 1) ? Count : sizeof(IndentSpaces) - 1;
+			Write(IndentSpaces, Chunk);
+			Count -= Chunk;
+		}
+
+		va_list args;
+		va_start(args, Fmt);
+		bool Done = TryFormat(Fmt, args);
+		va_end(args);
+
+		// DRAGONS: A va_list may only be walked once, so it is restarted for the retry
+		if(!Done)
+		{
+			va_start(args, Fmt);
+			WriteFormatted(Fmt, args);
+			va_end(args);
+		}
+
+		Put('\n');
+	}
+
+
+	void DumpWriter::Location(Position Pos)
+	{
+		if(Format == DumpFormatText)
+		{
+			Write("0x");
+			Write(Int64toHexString(Pos, 8).c_str());
+			Write(" : ");
+		}
+		else
+			PendingLocation = Pos;
+	}
+
+
+	void DumpWriter::Message(const char *Kind, const char *Lead, const char *Fmt, va_list args)
+	{
+		char Text[1024];
+		vsnprintf(Text, sizeof(Text), Fmt, args);
+		Text[sizeof(Text) - 1] = '\0';
+
+		if(Format == DumpFormatText)
+		{
+			Write(Lead);
+			Write(Text);
+			return;
+		}
+
+		std::string Message = Text;
+		while((!Message.empty()) && ((Message[Message.size() - 1] == '\n') || (Message[Message.size() - 1] == '\r')))
+			Message.erase(Message.size() - 1);
+
+		Messages.push_back(std::pair<const char *, std::string>(Kind, Message));
+	}
+
+
+	void DumpWriter::Begin(const char *Kind, bool Indent /*=true*/)
+	{
+		if(Indent) TextDepth++;
+
+		if(Format != DumpFormatText)
+		{
+			// Messages reported since the last node are written before this one, unless there is nothing yet to hold them
+			if(!Stack.empty()) WriteMessages();
+
+			if(Stack.empty())
+			{
+				if(Started) warning("Dump output has more than one top level node\n");
+				else if(Format == DumpFormatXML) Write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+				Started = true;
+			}
+			else
+			{
+				Node &Parent = Stack.back();
+				if(Format == DumpFormatJSON) Write(Parent.HasChildren ? "," : ",\"children\":[");
+				else if(!Parent.HasChildren) Put('>');
+				Parent.HasChildren = true;
+			}
+
+			NewLine(Stack.size());
+
+			if(Format == DumpFormatJSON)
+			{
+				Write("{\"kind\":\"");
+				Write(Kind);
+				Put('"');
+			}
+			else
+			{
+				Put('<');
+				Write(Kind);
+			}
+		}
+
+		Node ThisNode;
+		ThisNode.Kind = Kind;
+		ThisNode.Indent = Indent;
+		ThisNode.HasChildren = false;
+		Stack.push_back(ThisNode);
+
+		if(PendingLocation >= 0)
+		{
+			HexAttr("location", PendingLocation, 8);
+			PendingLocation = -1;
+		}
+	}
+
+
+	void DumpWriter::Attr(const char *Name, const std::string &Value)
+	{
+		if((Format == DumpFormatText) || Stack.empty()) return;
+
+		if(Format == DumpFormatJSON)
+		{
+			Write(",\"");
+			Write(Name);
+			Write("\":");
+		}
+		else
+		{
+			Put(' ');
+			Write(Name);
+			Put('=');
+		}
+
+		WriteEscaped(Value);
+	}
+
+
+	void DumpWriter::Attr(const char *Name, Int64 Value)
+	{
+		if((Format == DumpFormatText) || Stack.empty()) return;
+
+		std::string Text = Int64toString(Value);
+
+		if(Format == DumpFormatJSON)
+		{
+			Write(",\"");
+			Write(Name);
+			Write("\":");
+			Write(Text.c_str(), Text.size());
+		}
+		else
+		{
+			Put(' ');
+			Write(Name);
+			Write("=\"");
+			Write(Text.c_str(), Text.size());
+			Put('"');
+		}
+	}
+
+
+	void DumpWriter::HexAttr(const char *Name, UInt64 Value, int Digits)
+	{
+		if(Format != DumpFormatText) Attr(Name, "0x" + Int64toHexString(Value, Digits));
+	}
+
+
+	void DumpWriter::End(void)
+	{
+		if(Stack.empty()) return;
+
+		if(Format != DumpFormatText)
+		{
+			WriteMessages();
+
+			Node &ThisNode = Stack.back();
+			if(Format == DumpFormatJSON)
+			{
+				if(ThisNode.HasChildren) Put(']');
+				Put('}');
+			}
+			else if(ThisNode.HasChildren)
+			{
+				NewLine(Stack.size() - 1);
+				Write("</");
+				Write(ThisNode.Kind);
+				Put('>');
+			}
+			else
+				Write("/>");
+		}
+
+		if(Stack.back().Indent) TextDepth--;
+		Stack.pop_back();
+
+		if(Stack.empty() && (Format != DumpFormatText)) Put('\n');
+	}
+
+
+	void DumpWriter::Finish(void)
+	{
+		while(!Stack.empty()) End();
+
+		// Messages reported with no node to hold them are given one of their own
+		if((Format != DumpFormatText) && (!Messages.empty()) && !Started)
+		{
+			Begin("mxfdump");
+			End();
+		}
+	}
+
+
+	void DumpWriter::Write(const char *Data, size_t Size)
+	{
+		if(Size > (BufferSize - Used))
+		{
+			Flush();
+
+			if(Size > BufferSize)
+			{
+				fwrite(Data, 1, Size, Out);
+				return;
+			}
+		}
+
+		memcpy(&Buffer[Used], Data, Size);
+		Used += Size;
+	}
+
+
+	void DumpWriter::WriteEscaped(const std::string &Text)
+	{
+		Put('"');
+
+		const char *p = Text.c_str();
+		const char *End = p + Text.size();
+		while(p < End)
+		{
+			// Write each run of characters that need no escaping in one go
+			const char *Run = p;
+			while(p < End)
+			{
+				unsigned char c = static_cast<unsigned char>(*p);
+				if((c < 0x20) || (c == '"') || (c == '\\' && Format == DumpFormatJSON)) break;
+				if((Format == DumpFormatXML) && ((c == '&') || (c == '<') || (c == '>'))) break;
+				p++;
+			}
+			if(p > Run) Write(Run, p - Run);
+			if(p == End) break;
+
+			unsigned char c = static_cast<unsigned char>(*p++);
+			char Escape[16];
+			if(Format == DumpFormatJSON)
+			{
+				if(c == '"') Write("\\\"");
+				else if(c == '\\') Write("\\\\");
+				else if(c == '\n') Write("\\n");
+				else if(c == '\r') Write("\\r");
+				else if(c == '\t') Write("\\t");
+				else
+				{
+					sprintf(Escape, "\\u%04x", c);
+					Write(Escape);
+				}
+			}
+			else
+			{
+				if(c == '"') Write("&quot;");
+				else if(c == '&') Write("&amp;");
+				else if(c == '<') Write("&lt;");
+				else if(c == '>') Write("&gt;");
+				else if((c == '\n') || (c == '\r') || (c == '\t'))
+				{
+					sprintf(Escape, "&#%d;", c);
+					Write(Escape);
+				}
+				// DRAGONS: Other control characters are not allowed in XML 1.0, even as references
+				else Write("&#xFFFD;");
+			}
+		}
+
+		Put('"');
+	}
+
+
+	void DumpWriter::NewLine(size_t Depth)
+	{
+		Put('\n');
+
+		size_t Count = Depth * IndentSize;
+		while(Count)
+		{
+			size_t Chunk = (Count < sizeof(IndentSpaces) - 1) ? Count : sizeof(IndentSpaces) - 1;
+			Write(IndentSpaces, Chunk);
+			Count -= Chunk;
+		}
+	}
+
+
+	bool DumpWriter::TryFormat(const char *Fmt, va_list args)
+	{
+		if((BufferSize - Used) < FormatSpace) Flush();
+
+		size_t Free = BufferSize - Used;
+		int Count = vsnprintf(&Buffer[Used], Free, Fmt, args);
+
+		// DRAGONS: Some older libraries return -1 rather than the full size if the result is truncated
+		if((Count < 0) || (static_cast<size_t>(Count) >= Free)) return false;
+
+		Used += Count;
+		return true;
+	}
+
+
+	void DumpWriter::WriteMessages(void)
+	{
+		// Take the messages off the list first as Begin() and End() write any held messages
+		std::list<std::pair<const char *, std::string> > Held;
+		Held.swap(Messages);
+
+		std::list<std::pair<const char *, std::string> >::iterator it = Held.begin();
+		while(it != Held.end())
+		{
+			Begin((*it).first, false);
+			Attr("text", (*it).second);
+			End();
+			it++;
+		}
+	}
+
+
+	//! Write the summary of an index table segment and open a node for it, which the caller must close
+	void BeginIndexSegment(const IndexSegmentInfo &Info)
+	{
+		DumpWriter &Out = *Output;
+
+		if(Info.Duration == 0) Out.Line("CBR Index Table Segment (covering whole Essence Container) :");
+		else Out.Line("\nIndex Table Segment (first edit unit = %s, duration = %s) :", Int64toString(Info.StartPosition).c_str(), Int64toString(Info.Duration).c_str());
+
+		Out.Line("  Indexing BodySID 0x%04x from IndexSID 0x%04x", Info.BodySID, Info.IndexSID);
+
+		Out.Begin("indexsegment", false);
+		Out.Attr("start", Info.StartPosition);
+		Out.Attr("duration", Info.Duration);
+		Out.HexAttr("bodysid", Info.BodySID, 4);
+		Out.HexAttr("indexsid", Info.IndexSID, 4);
+	}
+
+	//! Dump the index entries for a range of edit units, in stored or presentation order
+	void DumpIndexEntries(IndexTablePtr &Table, Position Start, Length Duration, UInt32 Streams, bool Reorder)
+	{
+		DumpWriter &Out = *Output;
+
+		Position i;
+		for(i=0; i<Duration; i++)
+		{
+			UInt32 j;
+			for(j=0; j<Streams; j++)
+			{
+				IndexPosPtr Pos = Table->Lookup(Start + i, j, Reorder);
+
+				if(Out.IsText())
+				{
+					const char *Tail = "";
+					std::string Other;
+					if(Pos->Exact) Tail = "  *Exact*";
+					else if(Reorder && Pos->OtherPos)
+					{
+						Other = " (Location of un-reordered position " + Int64toString(Pos->ThisPos) + ")";
+						Tail = Other.c_str();
+					}
+
+					Out.Line("  EditUnit %3s for stream %d is at 0x%s, TempOffset=%d, Flags=%02x%s", Int64toString(Start + i).c_str(), j,
+							 Int64toHexString(Pos->Location,8).c_str(), Pos->TemporalOffset, Pos->Flags, Tail);
+				}
+				else
+				{
+					Out.Begin("entry", false);
+					Out.Attr("editunit", Start + i);
+					Out.Attr("stream", (Int64)j);
+					Out.HexAttr("location", Pos->Location, 8);
+					Out.Attr("temporaloffset", (Int64)Pos->TemporalOffset);
+					Out.HexAttr("flags", Pos->Flags, 2);
+					if(Pos->Exact) Out.Attr("exact", "true");
+					else if(Reorder && Pos->OtherPos) Out.Attr("unreorderedposition", Pos->ThisPos);
+					Out.End();
+				}
+			}
+		}
+	}
+
+	//! Dump the entries of the RIP of a file
+	void DumpRIP(MXFFilePtr &File)
+	{
+		DumpWriter &Out = *Output;
+
+		PartitionInfoMap::iterator it = File->FileRIP.begin();
+		while(it != File->FileRIP.end())
+		{
+			std::string Type = (*it).second->ThePartition ? " type " + (*it).second->ThePartition->Name() : " and is not loaded";
+
+			if(CheckDump)
+				Out.Line("  BodySID 0x%04x%s", (*it).second->BodySID, Type.c_str());
+			else
+				Out.Line("  BodySID 0x%04x is at 0x%s%s", (*it).second->BodySID, Int64toHexString((*it).second->ByteOffset,8).c_str(), Type.c_str());
+
+			Out.Begin("partition", false);
+			Out.HexAttr("bodysid", (*it).second->BodySID, 4);
+			if(!CheckDump) Out.HexAttr("offset", (*it).second->ByteOffset, 8);
+			if((*it).second->ThePartition) Out.Attr("type", (*it).second->ThePartition->Name());
+			Out.End();
+
+			it++;
+		}
+	}
+}
+
+
 //! Should we pause before exit?
 bool PauseBeforeExit = false;
 
@@ -124,8 +721,6 @@ int main(int argc, char *argv[])
 //! Do the main processing (less any pause before exit)
 int main_process(int argc, char *argv[])
 {
-	printf("Dump an MXF file using MXFLib\n");
-
 	std::string DictName = "dict.xml";
 	std::list<std::string> SuppDicts;
 	int num_options = 0;
@@ -147,12 +742,42 @@ int main_process(int argc, char *argv[])
 				else
 					CheckDump = true;
 			}
+			else if((tolower(argv[i][1]) == 'b') && (tolower(argv[i][2]) == 'l'))
+			{
+				int Start = 3;
+				if((argv[i][Start] == '=') || (argv[i][Start] == ':')) Start++;
+				if(argv[i][Start]) BatchList = &argv[i][Start];
+				else if(argc > (i+1))
+				{
+					BatchList = argv[++i];
+					num_options++;
+				}
+			}
+			else if((tolower(argv[i][1]) == 'b') && (tolower(argv[i][2]) == 't'))
+			{
+				int Start = 3;
+				if((argv[i][Start] == '=') || (argv[i][Start] == ':')) Start++;
+				BatchThreads = (unsigned int)strtoul(&argv[i][Start], NULL, 0);
+				if(BatchThreads < 1) BatchThreads = 1;
+			}
 			else if((argv[i][1] == 'b') || (argv[i][1] == 'B'))
 				FullBody = true;
 //			else if((argv[i][1] == 'g') || (argv[i][1] == 'G'))
 //				FollowGlobals = true;
+			else if((tolower(argv[i][1]) == 'l') && (tolower(argv[i][2]) == 'm') && (argv[i][3] == '\0'))
+				SetFeature(FeatureLazyMetadata);
 			else if((argv[i][1] == 'l') || (argv[i][1] == 'L'))
 				DumpLocation = true;
+			else if((tolower(argv[i][1]) == 'o') && (tolower(argv[i][2]) == 'f'))
+			{
+				int Start = 3;
+				if((argv[i][Start] == '=') || (argv[i][Start] == ':')) Start++;
+				std::string Format = &argv[i][Start];
+				std::transform(Format.begin(), Format.end(), Format.begin(), ::tolower);
+				if(Format == "json") DumpFormat = DumpFormatJSON;
+				else if(Format == "xml") DumpFormat = DumpFormatXML;
+				else DumpFormat = DumpFormatText;
+			}
 #ifdef OPTION3ENABLED
 			else if((argv[i][1] == 'o') || (argv[i][1] == 'O'))
 				ShowBaseline = true;
@@ -182,12 +807,23 @@ int main_process(int argc, char *argv[])
 			else if(tolower(argv[i][1]) == 't')
 			{
 				SetFeature(FeatureLoadMetadict);
-				printf("Loading metadictionary contents from file\n");
-				if(argv[i][2] == '1')
-				{
-					BootstrapDict = true;
-					printf("Starting with only a minimum compiled-in dictionary\n");
-				}
+				if(argv[i][2] == '1') BootstrapDict = true;
+			}
+			else if((tolower(argv[i][1]) == 'm') && (tolower(argv[i][2]) == 'm') && (argv[i][3] == '\0'))
+				MappedRead = true;
+			else if((tolower(argv[i][1]) == 'q') && (tolower(argv[i][2]) == 'c'))
+				QCMode = true;
+			else if((tolower(argv[i][1]) == 'r') && (tolower(argv[i][2]) == 'a'))
+			{
+				int Start = 3;
+				if((argv[i][Start] == '=') || (argv[i][Start] == ':')) Start++;
+				ReadAheadKB = argv[i][Start] ? (size_t)strtoul(&argv[i][Start], NULL, 0) : 8192;
+			}
+			else if((tolower(argv[i][1]) == 'f') && (tolower(argv[i][2]) == 'c'))
+			{
+				int Start = 3;
+				if((argv[i][Start] == '=') || (argv[i][Start] == ':')) Start++;
+				CachedBlockKB = argv[i][Start] ? (size_t)strtoul(&argv[i][Start], NULL, 0) : 1024;
 			}
 			else if((argv[i][1] == 'm') || (argv[i][1] == 'M'))
 			{
@@ -208,25 +844,47 @@ int main_process(int argc, char *argv[])
 		}
 	}
 
-	if (argc - num_options < 2)
+	// DRAGONS: The banner is left out of batch mode, QC reports and structured output as they must be parsable as a whole
+	if(BatchList.empty() && (!QCMode) && (DumpFormat == DumpFormatText))
 	{
-		printf("\nUsage:   %s [options] <filename>\n\n", argv[0]);
+		printf("Dump an MXF file using MXFLib\n");
+
+		if(Feature(FeatureLoadMetadict))
+		{
+			printf("Loading metadictionary contents from file\n");
+			if(BootstrapDict) printf("Starting with only a minimum compiled-in dictionary\n");
+		}
+	}
+
+	if ((argc - num_options < 2) && BatchList.empty())
+	{
+		printf("\nUsage:   %s [options] <filename>\n", argv[0]);
+		printf("         %s [options] -bl=<list>\n\n", argv[0]);
 		printf("Options: -a         Dump sub-items alpha-sorted\n");
 		printf("         -b         Dump body partitions (rather than just header and footer)\n");
+		printf("         -bl=<list> Batch mode: summarise each file named in <list> (one per line, or - for stdin),\n");
+		printf("                    or each .mxf file in directory <list>, as one line of JSON per file\n");
+		printf("         -bt=<n>    Number of files to inspect at once in batch mode (default 4)\n");
 		printf("         -c         Check dump (produce simple counts for automated testing)\n");
 		printf("         -c0        Don't dump UUID, UMID and Timestamp values (for comparing files)\n");
 		printf("         -dd <dict> Load supplementary dictionary (also -d for legacy)\n");
+		printf("         -fc[=kb]   Read the file via a block cache backend (default 1024 KB blocks)\n");
 		printf("         -g         Follow global references (if linked)\n");
 		printf("         -i         Dump full index tables (can be lengthy)\n");
 		printf("         -l         Show the location (byte offset) of metadata items dumped\n");
+		printf("         -lm        Only decode metadata sets when they are referenced\n");
 #ifdef COMPILED_DICT
 		printf("         -m <dict>  Specify main dictionary (instead of compile-time version)\n");
 #else
 		printf("         -m <dict>  Specify main dictionary (instead of dict.xml)\n");
 #endif // COMPILED_DICT
+		printf("         -mm        Read the file via a memory mapping\n");
 #ifdef OPTION3ENABLED
 		printf("         -o         Show baseline UL for sets with ObjectClass property\n");
 #endif // OPTION3ENABLED
+		printf("         -of=<fmt>  Output format: text (default), json or xml\n");
+		printf("         -qc        Check the structure and index tables of the file, reporting the findings (exits 1 if any)\n");
+		printf("         -ra[=kb]   Read the file via a read-ahead buffer (default 8192 KB)\n");
 		printf("         -t         Load metadictionary contents from file\n");
 		printf("         -t1        Load metadictionary and start from a minimal subset\n");
 		printf("         -u         Attempt to parse unknown or 'dark' sets\n");
@@ -240,19 +898,19 @@ int main_process(int argc, char *argv[])
 
 	if(BootstrapDict)
 	{
-		printf("- using a minimal compile-time dictionary and extending from metadictionary\n");
+		if(BatchList.empty() && (!QCMode) && (DumpFormat == DumpFormatText)) printf("- using a minimal compile-time dictionary and extending from metadictionary\n");
 		LoadDictionary(BootDict);
 	}
 	else
 	{
 		if( UseCompiledDict )
 		{
-			printf("- using compile-time dictionary\n");
-			LoadDictionary(DictData);
+			if(BatchList.empty() && (!QCMode) && (DumpFormat == DumpFormatText)) printf("- using compile-time dictionary\n");
+			LoadDictionaryOnDemand(DictData);
 		}
 		else
 		{
-			printf("- using dictionary %s\n", DictName.c_str());
+			if(BatchList.empty() && (!QCMode) && (DumpFormat == DumpFormatText)) printf("- using dictionary %s\n", DictName.c_str());
 			LoadDictionary(DictName);
 		}
 	}
@@ -273,13 +931,33 @@ int main_process(int argc, char *argv[])
 		UpdateTraitsMapping("Timestamp", new MessageTraits("{Timestamp}"));
 	}
 
+	if(!BatchList.empty()) return RunBatch();
+
+	DumpWriter Out(stdout, DumpFormat);
+	Output = &Out;
+
 	MXFFilePtr TestFile = new MXFFile;
-	if (! TestFile->Open(argv[num_options+1], true))
+	if(!OpenInputFile(TestFile, argv[num_options+1]))
 	{
 		perror(argv[num_options+1]);
 		return 1;
 	}
 
+	// A QC scan replaces the dump, printing a report for other tools to parse
+	if(QCMode)
+	{
+		QCScannerPtr Scanner = new QCScanner(TestFile);
+		QCReport Report;
+		bool Scanned = Scanner->Scan(Report);
+		printf("%s", Report.GetReport().c_str());
+
+		TestFile->Close();
+		return (Scanned && Report.Passed()) ? 0 : 1;
+	}
+
+	Out.Begin("mxfdump", false);
+	Out.Attr("file", argv[num_options+1]);
+
 	// Get a RIP (however possible)
 	TestFile->GetRIP();
 
@@ -289,9 +967,13 @@ int main_process(int argc, char *argv[])
 	{
 		PartitionNumber++;
 		if(CheckDump)
-			printf("\nPartition for BodySID 0x%04x\n", (*it).second->BodySID);
+			Out.Line("\nPartition for BodySID 0x%04x", (*it).second->BodySID);
 		else
-			printf("\nPartition at 0x%s is for BodySID 0x%04x\n", Int64toHexString((*it).second->ByteOffset,8).c_str(), (*it).second->BodySID);
+			Out.Line("\nPartition at 0x%s is for BodySID 0x%04x", Int64toHexString((*it).second->ByteOffset,8).c_str(), (*it).second->BodySID);
+
+		Out.Begin("partition", false);
+		if(!CheckDump) Out.HexAttr("offset", (*it).second->ByteOffset, 8);
+		Out.HexAttr("bodysid", (*it).second->BodySID, 4);
 
 		// Only dump header and footer unless asked for all partitions
 		if(FullBody || (PartitionNumber == 1) || (PartitionNumber == TestFile->FileRIP.size()))
@@ -304,12 +986,15 @@ int main_process(int argc, char *argv[])
 				{
 					if(ThisPartition->ReadMetadata() == 0)
 					{
-						printf("No header metadata in this partition\n");
+						Out.Line("No header metadata in this partition");
 					}
 					else
 					{
-						printf(" Top level count = %d\n", (int)ThisPartition->TopLevelMetadata.size());
-						printf(" Set/Pack count = %d\n", (int)ThisPartition->AllMetadata.size());
+						// Sets deferred by lazy decoding are not in the lists until decoded, so decode them all to count them
+						ThisPartition->ReadDeferredMetadata();
+
+						Out.Line(" Top level count = %d", (int)ThisPartition->TopLevelMetadata.size());
+						Out.Line(" Set/Pack count = %d", (int)ThisPartition->AllMetadata.size());
 						
 						size_t Count = 0;
 						MDObjectList::iterator it = ThisPartition->AllMetadata.begin();
@@ -319,42 +1004,30 @@ int main_process(int argc, char *argv[])
 							it++;
 						}
 
-						printf(" Sub item count = %d\n", (int)Count);
-					}
+						Out.Line(" Sub item count = %d", (int)Count);
 
-					// Read any index table segments!
-					MDObjectListPtr Segments = ThisPartition->ReadIndex();
-					if(Segments->empty())
-					{
-						printf("No index table in this partition\n");
+						Out.Attr("toplevel", (Int64)ThisPartition->TopLevelMetadata.size());
+						Out.Attr("sets", (Int64)ThisPartition->AllMetadata.size());
+						Out.Attr("items", (Int64)Count);
 					}
-					else
-					{
-						IndexTablePtr Table = new IndexTable;
-
-						MDObjectList::iterator it = Segments->begin();
-
-						while(it != Segments->end())
-						{
-							// Summarize this new segment
-							
-							UInt32 Streams = 1;
-							MDObjectPtr DeltaEntryArray = (*it)[DeltaEntryArray_UL];
-							if(DeltaEntryArray && DeltaEntryArray->GetType()->size())
-							{
-								Streams = static_cast<UInt32>(DeltaEntryArray->size() / DeltaEntryArray->GetType()->size());
-								if(Streams == 0) Streams = 1;	// Fix for bad DeltaEntryArray
-							}
 
-							Position Start = (*it)->GetInt64(IndexStartPosition_UL);
-							Length Duration = (*it)->GetInt64(IndexDuration_UL);
-							UInt32 IndexSID = (*it)->GetUInt(IndexSID_UL);
-							UInt32 BodySID = (*it)->GetUInt(BodySID_UL);
-							
-							if(Duration == 0) printf("CBR Index Table Segment (covering whole Essence Container) :\n");
-							else printf("\nIndex Table Segment (first edit unit = %s, duration = %s) :\n", Int64toString(Start).c_str(), Int64toString(Duration).c_str());
+					// Read any index table segments, parsing them directly from the raw index bytes
+					IndexTablePtr Table = new IndexTable;
+					IndexSegmentInfoList Segments;
+					ThisPartition->ReadIndex(Table, &Segments);
+					if(Segments.empty())
+					{
+						Out.Line("No index table in this partition");
+					}
+					else
+					{
+						IndexSegmentInfoList::iterator it = Segments.begin();
 
-							printf("  Indexing BodySID 0x%04x from IndexSID 0x%04x\n", BodySID, IndexSID);
+						while(it != Segments.end())
+						{
+							// Summarize this segment
+							BeginIndexSegment(*it);
+							Out.End();
 
 							it++;
 						}
@@ -367,96 +1040,69 @@ int main_process(int argc, char *argv[])
 					if(FullBody || (PartitionNumber == 1) || (PartitionNumber != TestFile->FileRIP.size()) 
 								|| (ThisPartition->IsA(CompleteFooter_UL)) || (ThisPartition->IsA(Footer_UL)) )
 					{
-						DumpObject(ThisPartition->Object,"");
+						DumpObject(ThisPartition->Object);
 
 						if(ThisPartition->ReadMetadata() == 0)
 						{
-							printf("No header metadata in this partition\n");
+							Out.Line("No header metadata in this partition");
 						}
 						else
 						{
-							printf("\nHeader Metadata:\n");
+							Out.Line("\nHeader Metadata:");
+							Out.Begin("metadata");
 							
-							MDObjectList::iterator it2 = ThisPartition->TopLevelMetadata.begin();
-							while(it2 != ThisPartition->TopLevelMetadata.end())
+							// DRAGONS: Dumping may change the list if metadata is being decoded lazily, so we dump a copy
+							MDObjectList TopLevel = ThisPartition->TopLevelMetadata;
+
+							MDObjectList::iterator it2 = TopLevel.begin();
+							while(it2 != TopLevel.end())
 							{
-								DumpObject(*it2,"  ");
+								DumpObject(*it2);
 								it2++;
 							}
-							printf("\n");
+
+							Out.End();
+							Out.Line("");
 						}
 
-						// Read any index table segments!
-						MDObjectListPtr Segments = ThisPartition->ReadIndex();
-						if(Segments->empty())
+						// Read any index table segments, parsing them directly from the raw index bytes
+						IndexTablePtr Table = new IndexTable;
+						IndexSegmentInfoList Segments;
+						ThisPartition->ReadIndex(Table, &Segments);
+						if(Segments.empty())
 						{
-							printf("No index table in this partition\n");
+							Out.Line("No index table in this partition");
 						}
 						else
 						{
-							IndexTablePtr Table = new IndexTable;
-
-							MDObjectList::iterator it = Segments->begin();
+							IndexSegmentInfoList::iterator it = Segments.begin();
 
-							while(it != Segments->end())
+							while(it != Segments.end())
 							{
-								Table->AddSegment(*it);
-							
-								// Demonstrate this new segment
-								
-								UInt32 Streams = 1;
-								MDObjectPtr DeltaEntryArray = (*it)[DeltaEntryArray_UL];
-								if(DeltaEntryArray)
-								{
-									Streams = static_cast<UInt32>(DeltaEntryArray->size());
-									if(Streams == 0) Streams = 1;	// Fix for bad DeltaEntryArray
-								}
-
-								Position Start = (*it)->GetInt64(IndexStartPosition_UL);
-								Length Duration = (*it)->GetInt64(IndexDuration_UL);
-								UInt32 IndexSID = (*it)->GetUInt(IndexSID_UL);
-								UInt32 BodySID = (*it)->GetUInt(BodySID_UL);
+								// Demonstrate this segment
 								
-								if(Duration == 0) printf("CBR Index Table Segment (covering whole Essence Container) :\n");
-								else printf("\nIndex Table Segment (first edit unit = %s, duration = %s) :\n", Int64toString(Start).c_str(), Int64toString(Duration).c_str());
+								UInt32 Streams = (*it).DeltaCount;
+								if(Streams == 0) Streams = 1;	// Fix for bad DeltaEntryArray
+
+								Position Start = (*it).StartPosition;
+								Length Duration = (*it).Duration;
 
-								printf("  Indexing BodySID 0x%04x from IndexSID 0x%04x\n", BodySID, IndexSID);
+								BeginIndexSegment(*it);
 
 								if(Duration < 1) Duration = 6;		// Could be CBR
 								if(!FullIndex && Duration > 35) Duration = 35;	// Don't go mad!
 
-								int i;
-								printf( "\n Bytestream Order:\n" );
-								for(i=0; i<Duration; i++)
-								{
-									UInt32 j;
-									for(j=0; j<Streams; j++)
-									{
-										IndexPosPtr Pos = Table->Lookup(Start + i,j,false);
-										printf("  EditUnit %3s for stream %d is at 0x%s", Int64toString(Start + i).c_str(), j, Int64toHexString(Pos->Location,8).c_str());
-										printf(", TempOffset=%d", Pos->TemporalOffset);
-										printf(", Flags=%02x", Pos->Flags);
-										if(Pos->Exact) printf("  *Exact*\n"); else printf("\n");
-									}
-								}
-
-								printf( "\n Presentation Order:\n" );
-								for(i=0; i<Duration; i++)
-								{
-									UInt32 j;
-									for(j=0; j<Streams; j++)
-									{
-										IndexPosPtr Pos = Table->Lookup(Start + i,j);
-										printf("  EditUnit %3s for stream %d is at 0x%s", Int64toString(Start + i).c_str(), j, Int64toHexString(Pos->Location,8).c_str());
-										printf(", TempOffset=%d", Pos->TemporalOffset);
-										printf(", Flags=%02x", Pos->Flags);
-	///									printf(", Keyframe is at 0x%s", Int64toHexString(Pos->KeyLocation,8).c_str() );
-
-										if(Pos->Exact) printf("  *Exact*\n");
-										else if(Pos->OtherPos) printf(" (Location of un-reordered position %s)\n", Int64toString(Pos->ThisPos).c_str());
-										else printf("\n");
-									}
-								}
+								Out.Line("\n Bytestream Order:");
+								Out.Begin("bytestream", false);
+								DumpIndexEntries(Table, Start, Duration, Streams, false);
+								Out.End();
+
+								Out.Line("\n Presentation Order:");
+								Out.Begin("presentation", false);
+								DumpIndexEntries(Table, Start, Duration, Streams, true);
+								Out.End();
+
+								Out.End();
 
 								it++;
 							}
@@ -466,47 +1112,27 @@ int main_process(int argc, char *argv[])
 			}
 		}
 
+		Out.End();
+
 		it++;
 	}
 
 	if(TestFile->ReadRIP())
 	{
-		printf("\nRead RIP\n");
-		PartitionInfoMap::iterator it = TestFile->FileRIP.begin();
-		while(it != TestFile->FileRIP.end())
-		{
-			if(CheckDump)
-				printf("  BodySID 0x%04x", (*it).second->BodySID);
-			else
-				printf("  BodySID 0x%04x is at 0x%s", (*it).second->BodySID, Int64toHexString((*it).second->ByteOffset,8).c_str());
-
-			if((*it).second->ThePartition)
-				printf(" type %s\n", (*it).second->ThePartition->Name().c_str());
-			else
-				printf(" and is not loaded\n");
-
-			it++;
-		}
+		Out.Line("\nRead RIP");
+		Out.Begin("rip", false);
+		Out.Attr("source", "read");
+		DumpRIP(TestFile);
+		Out.End();
 	}
 
 	if(TestFile->ScanRIP())
 	{
-		printf("\nScanned RIP\n");
-		PartitionInfoMap::iterator it = TestFile->FileRIP.begin();
-		while(it != TestFile->FileRIP.end())
-		{
-			if(CheckDump)
-				printf("  BodySID 0x%04x", (*it).second->BodySID);
-			else
-				printf("  BodySID 0x%04x is at 0x%s", (*it).second->BodySID, Int64toHexString((*it).second->ByteOffset,8).c_str());
-
-			if((*it).second->ThePartition)
-				printf(" type %s\n", (*it).second->ThePartition->Name().c_str());
-			else
-				printf(" and is not loaded\n");
-
-			it++;
-		}
+		Out.Line("\nScanned RIP");
+		Out.Begin("rip", false);
+		Out.Attr("source", "scanned");
+		DumpRIP(TestFile);
+		Out.End();
 	}
 
 /*	if(TestFile->BuildRIP())
@@ -551,14 +1177,413 @@ int main_process(int argc, char *argv[])
 }
 
 
+//! Open a file to be read, using the backend and buffering selected by the options
+static bool OpenInputFile(MXFFilePtr &File, const char *FileName)
+{
+	bool Opened;
+	if(CachedBlockKB)
+	{
+		FileBackendPtr Source = OpenFileBackend(FileName);
+		Opened = Source ? File->OpenBackend(new CachedFileBackend(Source, CachedBlockKB * 1024)) : false;
+	}
+	else
+		Opened = MappedRead ? File->OpenMapped(FileName) : File->Open(FileName, true);
+
+	if(!Opened) return false;
+
+	if(ReadAheadKB) File->SetReadAhead(ReadAheadKB * 1024);
+
+	return true;
+}
+
+
+namespace
+{
+	//! Messages reported while summarising a single file in batch mode
+	struct BatchMessages
+	{
+		std::list<std::string> Errors;			//!< Each error message, without the trailing newline
+		std::list<std::string> Warnings;		//!< Each warning message, without the trailing newline
+	};
+
+	//! The messages of the file being summarised on this thread, or NULL if this is not a batch worker
+	MXFLIB_THREAD_LOCAL BatchMessages *CurrentMessages = NULL;
+
+	//! Add a message to a batch message list
+	void AddBatchMessage(std::list<std::string> &List, const char *Fmt, va_list args)
+	{
+		char Buffer[1024];
+		vsnprintf(Buffer, sizeof(Buffer), Fmt, args);
+		Buffer[sizeof(Buffer) - 1] = '\0';
+
+		std::string Message = Buffer;
+		while((!Message.empty()) && ((Message[Message.size() - 1] == '\n') || (Message[Message.size() - 1] == '\r')))
+			Message.erase(Message.size() - 1);
+
+		List.push_back(Message);
+	}
+
+	//! Quote a string as a JSON string value
+	std::string JSONString(const std::string &Value)
+	{
+		std::string Ret = "\"";
+
+		std::string::const_iterator it = Value.begin();
+		while(it != Value.end())
+		{
+			unsigned char c = static_cast<unsigned char>(*it);
+			if(c == '"') Ret += "\\\"";
+			else if(c == '\\') Ret += "\\\\";
+			else if(c == '\n') Ret += "\\n";
+			else if(c == '\r') Ret += "\\r";
+			else if(c == '\t') Ret += "\\t";
+			else if(c < 0x20)
+			{
+				char Buffer[8];
+				sprintf(Buffer, "\\u%04x", c);
+				Ret += Buffer;
+			}
+			else Ret += *it;
+
+			it++;
+		}
+
+		return Ret + "\"";
+	}
+
+	//! Build a JSON array of string values
+	std::string JSONArray(const std::list<std::string> &Values)
+	{
+		std::string Ret = "[";
+
+		std::list<std::string>::const_iterator it = Values.begin();
+		while(it != Values.end())
+		{
+			if(it != Values.begin()) Ret += ",";
+			Ret += JSONString(*it);
+			it++;
+		}
+
+		return Ret + "]";
+	}
+
+	//! Find the duration and edit rate of the longest track of the Material Package
+	/*! \return false if there is no Material Package with a track of known duration */
+	bool MaterialDuration(MetadataPtr &HMeta, Length &Duration, Rational &EditRate)
+	{
+		Duration = -1;
+
+		PackageList::iterator Package_it = HMeta->Packages.begin();
+		while(Package_it != HMeta->Packages.end())
+		{
+			if((*Package_it)->IsA(MaterialPackage_UL))
+			{
+				TrackList::iterator Track_it = (*Package_it)->Tracks.begin();
+				while(Track_it != (*Package_it)->Tracks.end())
+				{
+					Length TrackDuration = 0;
+					ComponentList::iterator Comp_it = (*Track_it)->Components.begin();
+					while(Comp_it != (*Track_it)->Components.end())
+					{
+						TrackDuration += (*Comp_it)->GetInt64(ComponentLength_UL);
+						Comp_it++;
+					}
+
+					MDObjectPtr Rate = (*Track_it)->Child(EditRate_UL);
+					if(Rate && (TrackDuration > Duration))
+					{
+						Duration = TrackDuration;
+						EditRate.Numerator = Rate->GetInt("Numerator");
+						EditRate.Denominator = Rate->GetInt("Denominator");
+					}
+
+					Track_it++;
+				}
+			}
+
+			Package_it++;
+		}
+
+		return Duration >= 0;
+	}
+
+	//! Summarise a file as a single line of JSON (without the trailing newline)
+	/*! Any errors or warnings reported while reading the file are included in the summary rather than printed
+	 *  \param HadErrors Set true if any errors were reported
+	 */
+	std::string SummariseFile(const std::string &FileName, bool &HadErrors)
+	{
+		BatchMessages Messages;
+		CurrentMessages = &Messages;
+
+		std::string Ret = "{\"file\":" + JSONString(FileName);
+
+		MXFFilePtr File = new MXFFile;
+		if(!OpenInputFile(File, FileName.c_str()))
+		{
+			error("Could not open file\n");
+		}
+		else
+		{
+			Ret += ",\"size\":" + Int64toString(File->Size());
+
+			File->GetRIP();
+			Ret += ",\"partitions\":" + Int64toString(File->FileRIP.size());
+
+			PartitionPtr Master = File->ReadMasterPartition();
+			if(!Master)
+			{
+				File->Seek(0);
+				Master = File->ReadPartition();
+			}
+
+			if(!Master)
+			{
+				error("Could not read a header partition\n");
+			}
+			else
+			{
+				Ret += ",\"master_partition\":" + JSONString(Master->Name());
+
+				MDObjectPtr OP = Master->Child(OperationalPattern_UL);
+				if(OP) Ret += ",\"operational_pattern\":" + JSONString(OP->GetString());
+
+				std::list<std::string> Containers;
+				MDObjectPtr EssenceContainers = Master->Child(EssenceContainers_UL);
+				if(EssenceContainers)
+				{
+					MDObject::iterator it = EssenceContainers->begin();
+					while(it != EssenceContainers->end())
+					{
+						Containers.push_back((*it).second->GetString());
+						it++;
+					}
+				}
+				Ret += ",\"essence_containers\":" + JSONArray(Containers);
+
+				if(Master->ReadMetadata() == 0)
+				{
+					warning("No header metadata in the master partition\n");
+				}
+				else
+				{
+					Ret += ",\"metadata_sets\":" + Int64toString(Master->AllMetadata.size());
+
+					MetadataPtr HMeta = Master->ParseMetadata();
+					if(HMeta)
+					{
+						Ret += ",\"packages\":" + Int64toString(HMeta->Packages.size());
+
+						Length Duration;
+						Rational EditRate;
+						if(MaterialDuration(HMeta, Duration, EditRate))
+						{
+							Ret += ",\"duration\":" + Int64toString(Duration);
+							Ret += ",\"edit_rate\":\"" + Int64toString(EditRate.Numerator) + "/" + Int64toString(EditRate.Denominator) + "\"";
+						}
+					}
+				}
+			}
+
+			File->Close();
+		}
+
+		CurrentMessages = NULL;
+		HadErrors = !Messages.Errors.empty();
+
+		Ret += ",\"errors\":" + JSONArray(Messages.Errors);
+		Ret += ",\"warnings\":" + JSONArray(Messages.Warnings);
+		return Ret + "}";
+	}
+
+	//! The files to summarise in batch mode, shared by all the workers
+	class BatchQueue
+	{
+	protected:
+		Mutex QueueLock;						//!< Lock for taking the next file
+		Mutex OutputLock;						//!< Lock for writing a line of output
+		std::vector<std::string> Files;			//!< The files to summarise
+		size_t Next;							//!< Index in Files of the next file to summarise
+		size_t Failed;							//!< The number of files summarised with errors
+
+	public:
+		BatchQueue(const std::vector<std::string> &Files) : Files(Files), Next(0), Failed(0) {}
+
+		//! Take the next file to summarise
+		/*! \return false if there are no more files */
+		bool Take(std::string &FileName)
+		{
+			MutexLock Locked(QueueLock);
+			if(Next >= Files.size()) return false;
+			FileName = Files[Next++];
+			return true;
+		}
+
+		//! Write the summary of a file, as a complete line so that the lines of different workers are not mixed
+		void Write(const std::string &Summary, bool HadErrors)
+		{
+			MutexLock Locked(OutputLock);
+			fputs(Summary.c_str(), stdout);
+			fputc('\n', stdout);
+			if(HadErrors) Failed++;
+		}
+
+		//! Get the number of files summarised with errors
+		size_t GetFailed(void) const { return Failed; }
+	};
+
+	//! A task for batch mode, summarising files from a BatchQueue until there are none left
+	/*! Each file is read with its own MXFFile, and the dictionary is shared
+	 *  DRAGONS: The dictionary must be frozen before any task is submitted, as a compiled-in dictionary loaded on demand
+	 *           would otherwise build classes on whichever task first looks them up, changing the registry unlocked
+	 */
+	class BatchTask : public Task
+	{
+	protected:
+		BatchQueue &Queue;						//!< The queue to take files from
+
+	public:
+		BatchTask(BatchQueue &Queue) : Queue(Queue) {}
+
+		//! Summarise files until the queue is empty
+		void Run(void)
+		{
+			std::string FileName;
+			while(Queue.Take(FileName))
+			{
+				bool HadErrors;
+				std::string Summary = SummariseFile(FileName, HadErrors);
+				Queue.Write(Summary, HadErrors);
+			}
+		}
+	};
+
+	//! Determine if a file name ends in ".mxf" (in any case)
+	bool IsMXFName(const std::string &Name)
+	{
+		if(Name.size() < 4) return false;
+		std::string Ext = Name.substr(Name.size() - 4);
+		for(size_t i = 0; i < Ext.size(); i++) Ext[i] = static_cast<char>(tolower(Ext[i]));
+		return Ext == ".mxf";
+	}
+
+	//! Add the MXF files in a directory, in name order, to a list of files
+	/*! \return false if this is not a directory that can be read */
+	bool ReadBatchDirectory(const std::string &DirName, std::vector<std::string> &Files)
+	{
+		std::vector<std::string> Names;
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA FindData;
+		HANDLE Find = FindFirstFileA((DirName + "\\*").c_str(), &FindData);
+		if(Find == INVALID_HANDLE_VALUE) return false;
+		do
+		{
+			if(!(FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) Names.push_back(FindData.cFileName);
+		} while(FindNextFileA(Find, &FindData));
+		FindClose(Find);
+
+		std::string Separator = "\\";
+#else
+		DIR *Dir = opendir(DirName.c_str());
+		if(!Dir) return false;
+		struct dirent *Entry;
+		while((Entry = readdir(Dir)) != NULL) Names.push_back(Entry->d_name);
+		closedir(Dir);
+
+		std::string Separator = "/";
+#endif
+
+		std::sort(Names.begin(), Names.end());
+
+		std::vector<std::string>::iterator it = Names.begin();
+		while(it != Names.end())
+		{
+			if(IsMXFName(*it)) Files.push_back(DirName + Separator + *it);
+			it++;
+		}
+
+		return true;
+	}
+
+	//! Build the list of files to summarise from a list file, stdin (if "-") or a directory
+	/*! \return false if the list could not be read */
+	bool ReadBatchList(const std::string &List, std::vector<std::string> &Files)
+	{
+		FILE *In = stdin;
+		if(List != "-")
+		{
+			if(ReadBatchDirectory(List, Files)) return true;
+
+			In = fopen(List.c_str(), "r");
+			if(!In) return false;
+		}
+
+		char Buffer[4096];
+		while(fgets(Buffer, sizeof(Buffer), In))
+		{
+			std::string Line = Buffer;
+			while((!Line.empty()) && ((Line[Line.size() - 1] == '\n') || (Line[Line.size() - 1] == '\r')))
+				Line.erase(Line.size() - 1);
+
+			if(!Line.empty()) Files.push_back(Line);
+		}
+
+		if(In != stdin) fclose(In);
+
+		return true;
+	}
+}
+
+
+//! Summarise each file of the batch list as a line of JSON, using tasks on the shared executor
+/*! \return 0 if all files were read without error, 2 if some had errors, or 1 if the list could not be read */
+static int RunBatch(void)
+{
+	std::vector<std::string> Files;
+	if(!ReadBatchList(BatchList, Files))
+	{
+		perror(BatchList.c_str());
+		return 1;
+	}
+
+	// Make the shared dictionary complete and read-only before any tasks start, any metadictionary is then loaded into an overlay for its file
+	FreezeDictionary();
+
+	BatchQueue Queue(Files);
+
+	unsigned int ThreadCount = BatchThreads;
+	if(ThreadCount > Files.size()) ThreadCount = static_cast<unsigned int>(Files.size());
+
+	// Run one task per file inspected at once on the shared executor, which runs them on this thread if it has no workers
+	TaskExecutor &Executor = GetTaskExecutor();
+	Executor.SetWorkers(ThreadCount);
+
+	TaskGroup Tasks;
+	unsigned int i;
+	for(i = 0; i < ThreadCount; i++) Tasks.Submit(new BatchTask(Queue), &Executor);
+	Tasks.Wait();
+
+	fflush(stdout);
+
+	return Queue.GetFailed() ? 2 : 0;
+}
+
+
 //! Dump an object and any physical or logical children
-void DumpObject(MDObjectPtr Object, std::string Prefix)
+void DumpObject(MDObjectPtr Object)
 {
-	if(DumpLocation) printf("0x%s : ", Int64toHexString(Object->GetLocation(),8).c_str());
+	DumpWriter &Out = *Output;
 
-	if(Object->IsModified()) printf("%s%s is *MODIFIED*\n", Object->FullName().c_str(), Prefix.c_str() );
+	if(DumpLocation) Out.Location(Object->GetLocation());
+
+	bool Modified = Object->IsModified();
+	if(Modified) Out.Line("%s is *MODIFIED*", Object->FullName().c_str());
 
 #ifdef OPTION3ENABLED
+	// Non-baseline sets are dumped inside a node for their baseline class
+	bool InBaseline = false;
+
 	if(ShowBaseline)
 	{
 		if(!Object->IsBaseline())
@@ -566,39 +1591,49 @@ void DumpObject(MDObjectPtr Object, std::string Prefix)
 			if(Object->GetBaselineUL())
 			{
 				MDOTypePtr BaselineClass = MDOType::Find(Object->GetBaselineUL());
+				std::string BaselineName;
 				if(BaselineClass)
 				{
-					printf("%sBaseline: %s\n", Prefix.c_str(), BaselineClass->Name().c_str());
+					BaselineName = BaselineClass->Name();
 				}
 				else
 				{
-					printf("%sNote: Current dictionary does not contain a set with the baseline UL used to wrap this non-baseline class\n", Prefix.c_str());
-					printf("%sBaseline: %s\n", Prefix.c_str(), Object->GetBaselineUL()->GetString().c_str());
+					Out.Line("Note: Current dictionary does not contain a set with the baseline UL used to wrap this non-baseline class");
+					BaselineName = Object->GetBaselineUL()->GetString();
 				}
-				Prefix += "  ";
+				Out.Line("Baseline: %s", BaselineName.c_str());
+
+				Out.Begin("baseline");
+				Out.Attr("name", BaselineName);
+				InBaseline = true;
 			}
 			else
 			{
-				printf("%sNote: Current dictionary flags this class as non-baseline, but it is not wrapped in a baseline class\n", Prefix.c_str());
+				Out.Line("Note: Current dictionary flags this class as non-baseline, but it is not wrapped in a baseline class");
 			}
 		}
 		else
 		{
 			if(Object->GetBaselineUL())
 			{
-				printf("%sNote: Current dictionary flags this class as baseline, but it is wrapped as a non-baseline class\n", Prefix.c_str());
+				Out.Line("Note: Current dictionary flags this class as baseline, but it is wrapped as a non-baseline class");
 
 				MDOTypePtr BaselineClass = MDOType::Find(Object->GetBaselineUL());
+				std::string BaselineName;
 				if(BaselineClass)
 				{
-					printf("%sBaseline: %s\n", Prefix.c_str(), BaselineClass->Name().c_str());
+					BaselineName = BaselineClass->Name();
 				}
 				else
 				{
-					printf("%sNote: Current dictionary does not contain a set with the baseline UL used to wrap this non-baseline class\n", Prefix.c_str());
-					printf("%sBaseline: %s\n", Prefix.c_str(), Object->GetBaselineUL()->GetString().c_str());
+					Out.Line("Note: Current dictionary does not contain a set with the baseline UL used to wrap this non-baseline class");
+					BaselineName = Object->GetBaselineUL()->GetString();
 				}
-				Prefix += "  ";
+				Out.Line("Baseline: %s", BaselineName.c_str());
+
+				Out.Begin("baseline");
+				Out.Attr("name", BaselineName);
+				InBaseline = true;
 			}
 		}
 	}
@@ -606,68 +1641,113 @@ void DumpObject(MDObjectPtr Object, std::string Prefix)
 
 	if(Object->GetLink())
 	{
-		if(Object->GetRefType() == ClassRefStrong)
+		std::string Value = Object->GetString();
+
+		if((Object->GetRefType() == ClassRefStrong) || ((Object->GetRefType() == ClassRefGlobal) && FollowGlobals))
 		{
-			printf("%s%s = %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetString().c_str());
+			const char *RefType = (Object->GetRefType() == ClassRefStrong) ? "Strong" : "Global";
+			std::string TargetName = Object->GetLink()->Name();
+
+			Out.Line("%s = %s", Object->Name().c_str(), Value.c_str());
 
-			if(DumpLocation) printf("0x%s : ", Int64toHexString(Object->GetLocation(),8).c_str());
-			printf("%s%s -> Strong Reference to %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetLink()->Name().c_str());
+			if(DumpLocation) Out.Location(Object->GetLocation());
+			Out.Line("%s -> %s Reference to %s", Object->Name().c_str(), RefType, TargetName.c_str());
 
-			DumpObject(Object->GetLink(), Prefix + "  ");
+			Out.Begin("reference");
+			Out.Attr("name", Object->Name());
+			Out.Attr("value", Value);
+			Out.Attr("ref", (Object->GetRefType() == ClassRefStrong) ? "strong" : "global");
+			Out.Attr("target", TargetName);
+			if(Modified) Out.Attr("modified", "true");
+
+			DumpObject(Object->GetLink());
+
+			Out.End();
 		}
-		else if(Object->GetRefType() == ClassRefGlobal)
+		else
 		{
-			if(FollowGlobals)
+			std::string TargetName;
+			const char *RefType;
+			if(Object->GetRefType() == ClassRefGlobal)
 			{
-				printf("%s%s = %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetString().c_str());
-
-				if(DumpLocation) printf("0x%s : ", Int64toHexString(Object->GetLocation(),8).c_str());
-				printf("%s%s -> Global Reference to %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetLink()->Name().c_str());
-
-				DumpObject(Object->GetLink(), Prefix + "  ");
+				TargetName = Object->GetLink()->Name();
+				RefType = "global";
+				Out.Line("%s -> Global Reference to %s, %s", Object->Name().c_str(), TargetName.c_str(), Value.c_str());
+			}
+			else if(Object->GetRefType() == ClassRefMeta)
+			{
+				TargetName = Object->GetLink()->GetString(MetaDefinitionName_UL, Object->GetLink()->Name());
+				RefType = "meta";
+				Out.Line("%s -> MetaDictionary Reference to %s %s", Object->Name().c_str(), TargetName.c_str(), Value.c_str());
+			}
+			else if(Object->GetRefType() == ClassRefDict)
+			{
+				TargetName = Object->GetLink()->GetString(DefinitionObjectName_UL, Object->GetLink()->Name());
+				RefType = "dictionary";
+				Out.Line("%s -> Dictionary Reference to %s %s", Object->Name().c_str(), TargetName.c_str(), Value.c_str());
 			}
 			else
 			{
-				printf("%s%s -> Global Reference to %s, %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetLink()->Name().c_str(), Object->GetString().c_str());
+				TargetName = Object->GetLink()->Name();
+				RefType = "weak";
+				Out.Line("%s -> Weak Reference to %s %s", Object->Name().c_str(), TargetName.c_str(), Value.c_str());
 			}
-		}
-		else if(Object->GetRefType() == ClassRefMeta)
-		{
-			std::string TargetName = Object->GetLink()->GetString(MetaDefinitionName_UL, Object->GetLink()->Name());
-			printf("%s%s -> MetaDictionary Reference to %s %s\n", Prefix.c_str(), Object->Name().c_str(), TargetName.c_str(), Object->GetString().c_str());
-		}
-		else if(Object->GetRefType() == ClassRefDict)
-		{
-			std::string TargetName = Object->GetLink()->GetString(DefinitionObjectName_UL, Object->GetLink()->Name());
-			printf("%s%s -> Dictionary Reference to %s %s\n", Prefix.c_str(), Object->Name().c_str(), TargetName.c_str(), Object->GetString().c_str());
-		}
-		else
-		{
-			printf("%s%s -> Weak Reference to %s %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetLink()->Name().c_str(), Object->GetString().c_str());
+
+			Out.Begin("reference");
+			Out.Attr("name", Object->Name());
+			Out.Attr("value", Value);
+			Out.Attr("ref", RefType);
+			Out.Attr("target", TargetName);
+			if(Modified) Out.Attr("modified", "true");
+			Out.End();
 		}
 	}
 	else
 	{
 		if(Object->IsDValue())
 		{
-			printf("%s%s = <Unknown>\n", Prefix.c_str(), Object->Name().c_str());
+			Out.Line("%s = <Unknown>", Object->Name().c_str());
+
+			Out.Begin("property", false);
+			Out.Attr("name", Object->Name());
+			Out.Attr("unknown", "true");
+			if(Modified) Out.Attr("modified", "true");
+			Out.End();
 		}
 		else
 		{
 			// Check first for values that are not reference batches
 			if(Object->IsAValue())
 			{
-//if(Object->Name().find("Unknown") == std::string::npos)
-				printf("%s%s = %s\n", Prefix.c_str(), Object->Name().c_str(), Object->GetString().c_str());
-//else			printf("%s%s\n", Prefix.c_str(), Object->Name().c_str());
-if(Object->GetRefType() == ClassRefMeta)
-	printf("%s%s is an unsatisfied MetaRef\n", Prefix.c_str(), Object->Name().c_str());
-else if(Object->GetRefType() == ClassRefDict)
-	printf("%s%s is an unsatisfied DictRef\n", Prefix.c_str(), Object->Name().c_str());
+				std::string Value = Object->GetString();
+				Out.Line("%s = %s", Object->Name().c_str(), Value.c_str());
+
+				Out.Begin("property", false);
+				Out.Attr("name", Object->Name());
+				Out.Attr("value", Value);
+				if(Modified) Out.Attr("modified", "true");
+
+				if(Object->GetRefType() == ClassRefMeta)
+				{
+					Out.Line("%s is an unsatisfied MetaRef", Object->Name().c_str());
+					Out.Attr("unsatisfied", "meta");
+				}
+				else if(Object->GetRefType() == ClassRefDict)
+				{
+					Out.Line("%s is an unsatisfied DictRef", Object->Name().c_str());
+					Out.Attr("unsatisfied", "dictionary");
+				}
+
+				Out.End();
 			}
 			else
 			{
-				printf("%s%s\n", Prefix.c_str(), Object->Name().c_str());
+				Out.Line("%s", Object->Name().c_str());
+
+				Out.Begin("object");
+				Out.Attr("name", Object->Name());
+				if(Modified) Out.Attr("modified", "true");
+
 				MDObjectULList::iterator it = Object->begin();
 
 				if(!SortedDump)
@@ -675,7 +1755,7 @@ else if(Object->GetRefType() == ClassRefDict)
 					/* Dump Objects in the order stored */
 					while(it != Object->end())
 					{
-						DumpObject((*it).second, Prefix + "  ");
+						DumpObject((*it).second);
 						it++;
 					}
 				}
@@ -694,14 +1774,20 @@ else if(Object->GetRefType() == ClassRefDict)
 					CM_Iter = ChildMap.begin();
 					while(CM_Iter != ChildMap.end())
 					{
-						DumpObject((*CM_Iter).second, Prefix + "  ");
+						DumpObject((*CM_Iter).second);
 						CM_Iter++;
 					}
 				}
+
+				Out.End();
 			}
 		}
 	}
 
+#ifdef OPTION3ENABLED
+	if(InBaseline) Out.End();
+#endif // OPTION3ENABLED
+
 	return;
 }
 
@@ -716,12 +1802,14 @@ else if(Object->GetRefType() == ClassRefDict)
 //! Display a general debug message
 void mxflib::debug(const char *Fmt, ...)
 {
-	if(!DebugMode) return;
+	// DRAGONS: Debug output from batch workers would break up the lines of JSON
+	if(!DebugMode || CurrentMessages) return;
 
 	va_list args;
 
 	va_start(args, Fmt);
-	vprintf(Fmt, args);
+	if(Output) Output->Message("debug", "", Fmt, args);
+	else vprintf(Fmt, args);
 	va_end(args);
 }
 #endif // MXFLIB_DEBUG
@@ -732,6 +1820,21 @@ void mxflib::warning(const char *Fmt, ...)
 	va_list args;
 
 	va_start(args, Fmt);
+	if(CurrentMessages)
+	{
+		AddBatchMessage(CurrentMessages->Warnings, Fmt, args);
+		va_end(args);
+		return;
+	}
+
+	// DRAGONS: Messages while dumping a file go via the writer to keep them in order with the buffered dump
+	if(Output)
+	{
+		Output->Message("warning", "Warning: ", Fmt, args);
+		va_end(args);
+		return;
+	}
+
 	printf("Warning: ");
 	vprintf(Fmt, args);
 	va_end(args);
@@ -743,6 +1846,20 @@ void mxflib::error(const char *Fmt, ...)
 	va_list args;
 
 	va_start(args, Fmt);
+	if(CurrentMessages)
+	{
+		AddBatchMessage(CurrentMessages->Errors, Fmt, args);
+		va_end(args);
+		return;
+	}
+
+	if(Output)
+	{
+		Output->Message("error", "ERROR: ", Fmt, args);
+		va_end(args);
+		return;
+	}
+
 	printf("ERROR: ");
 	vprintf(Fmt, args);
 	va_end(args);
@@ -0,0 +1,194 @@
+/*! \file	asyncread.cpp
+ *	\brief	Implementation of an engine that reads the values of KLVs in the background
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace mxflib
+{
+	//! An I/O thread for an AsyncReadEngine
+	class AsyncReadWorker : public Thread
+	{
+	protected:
+		AsyncReadEngine *Owner;						//!< The engine we work for
+
+	public:
+		AsyncReadWorker(AsyncReadEngine *Owner) : Owner(Owner) {}
+
+	protected:
+		void Run(void) { Owner->WorkerLoop(); }
+	};
+}
+
+
+//! Stop the I/O threads, abandoning any queued reads
+AsyncReadEngine::~AsyncReadEngine()
+{
+	{
+		MutexLock Locked(Lock);
+		Stopping = true;
+
+		std::list<RequestPtr>::iterator it = Queue.begin();
+		while(it != Queue.end())
+		{
+			(*it)->State = Request::Cancelled;
+			it++;
+		}
+		Queue.clear();
+
+		Changed.Broadcast();
+	}
+
+	std::vector<AsyncReadWorker*>::iterator it = Workers.begin();
+	while(it != Workers.end())
+	{
+		(*it)->Join();
+		delete *it;
+		it++;
+	}
+}
+
+
+//! Submit a read of the whole value of an object
+AsyncReadEngine::RequestPtr AsyncReadEngine::Submit(KLVObjectPtr Object)
+{
+	MutexLock Locked(Lock);
+
+	// Start the I/O threads the first time we are used, no more than the shared executor has workers
+	unsigned int Limit = ThreadCount;
+	unsigned int ExecutorWorkers = GetTaskExecutor().GetWorkers();
+	if(ExecutorWorkers && (Limit > ExecutorWorkers)) Limit = ExecutorWorkers;
+
+	while(Workers.size() < Limit)
+	{
+		AsyncReadWorker *Worker = new AsyncReadWorker(this);
+		if(!Worker->Start())
+		{
+			delete Worker;
+			break;
+		}
+		Workers.push_back(Worker);
+	}
+
+	if(Workers.empty()) return NULL;
+
+	RequestPtr Ret = new Request(Object);
+	Queue.push_back(Ret);
+	Changed.Broadcast();
+
+	return Ret;
+}
+
+
+//! Wait for a request to complete
+bool AsyncReadEngine::Wait(RequestPtr &ThisRequest)
+{
+	{
+		MutexLock Locked(Lock);
+
+		if(ThisRequest->State == Request::Queued)
+		{
+			// Nobody has started this read, so take it ourselves rather than waiting for an I/O thread to reach it
+			Queue.remove(ThisRequest);
+			ThisRequest->State = Request::Reading;
+		}
+		else
+		{
+			while(ThisRequest->State == Request::Reading) Changed.Wait(Lock);
+			return ThisRequest->State == Request::Done;
+		}
+	}
+
+	bool Ret = ReadValue(ThisRequest.GetPtr());
+
+	MutexLock Locked(Lock);
+	ThisRequest->State = Ret ? Request::Done : Request::Failed;
+	Changed.Broadcast();
+
+	return Ret;
+}
+
+
+//! Cancel a request, if it has not yet been started
+void AsyncReadEngine::Cancel(RequestPtr &ThisRequest)
+{
+	MutexLock Locked(Lock);
+
+	if(ThisRequest->State == Request::Queued)
+	{
+		Queue.remove(ThisRequest);
+		ThisRequest->State = Request::Cancelled;
+	}
+}
+
+
+//! Take and service requests until stopping, called by each I/O thread
+void AsyncReadEngine::WorkerLoop(void)
+{
+	for(;;)
+	{
+		RequestPtr ThisRequest;
+		{
+			MutexLock Locked(Lock);
+
+			while(Queue.empty() && (!Stopping)) Changed.Wait(Lock);
+			if(Stopping) return;
+
+			ThisRequest = Queue.front();
+			Queue.pop_front();
+			ThisRequest->State = Request::Reading;
+		}
+
+		bool Ret = ReadValue(ThisRequest.GetPtr());
+
+		MutexLock Locked(Lock);
+		ThisRequest->State = Ret ? Request::Done : Request::Failed;
+		Changed.Broadcast();
+	}
+}
+
+
+//! Read the value of a request's object
+bool AsyncReadEngine::ReadValue(Request *ThisRequest)
+{
+	KLVObjectPtr &Object = ThisRequest->Object;
+
+	Length ValueLength = Object->GetLength();
+	if(ValueLength <= 0) return true;
+
+	if(static_cast<Length>(Object->ReadData()) < ValueLength)
+	{
+		error("Unable to read value of KLV at %s\n", Object->GetSourceLocation().c_str());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,134 @@
+/*! \file	asyncread.h
+ *	\brief	Definition of an engine that reads the values of KLVs in the background
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A GCReader normally reads each KLV with a blocking read just before it is dispatched, so only one read is ever
+ *  outstanding. Fast storage, such as NVMe or striped arrays, needs many reads in flight to reach its full throughput.
+ *  An AsyncReadEngine keeps a queue of value reads serviced by a pool of I/O threads using positional reads, so when a
+ *  GCReader is given an engine with GCReader::SetAsyncRead() it can look ahead through the keys and lengths of the
+ *  following KLVs and have their values read while earlier KLVs are being handled. The KLVs are still dispatched one at
+ *  a time, in file order, on the calling thread.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__ASYNCREAD_H
+#define MXFLIB__ASYNCREAD_H
+
+namespace mxflib
+{
+	// Forward declare the I/O thread class, which is private to the implementation
+	class AsyncReadWorker;
+
+	//! Reads the values of KLVObjects on a pool of I/O threads
+	/*! Each submitted object has its whole value read with positional reads, so the object's source file may be shared
+	 *  by any number of outstanding reads and by the submitting thread. Threads are started when the first read is
+	 *  submitted, and one engine may be shared by several readers.
+	 *  \note The objects must have positional reads selected (see KLVObject::SetPositionalRead()) and no read handler
+	 */
+	class AsyncReadEngine : public RefCount<AsyncReadEngine>
+	{
+	public:
+		//! A single submitted read
+		class Request : public RefCount<Request>
+		{
+		public:
+			//! The state of a request
+			enum RequestState { Queued, Reading, Done, Failed, Cancelled };
+
+		protected:
+			KLVObjectPtr Object;				//!< The object whose value is being read
+			RequestState State;					//!< The current state, protected by the engine's lock
+
+			friend class AsyncReadEngine;
+
+		public:
+			//! Construct a request to read the value of a given object
+			Request(KLVObjectPtr Object) : Object(Object), State(Queued) {}
+
+			//! Get the object being read
+			/*! \note The value must not be used until AsyncReadEngine::Wait() has returned true for this request */
+			KLVObjectPtr GetObject(void) { return Object; }
+		};
+
+		//! A smart pointer to a Request
+		typedef SmartPtr<Request> RequestPtr;
+
+	protected:
+		unsigned int ThreadCount;				//!< The number of I/O threads to use
+
+		Mutex Lock;								//!< Lock protecting all of the following
+		Condition Changed;						//!< Signalled when a request is queued or completed, or when stopping
+		std::list<RequestPtr> Queue;			//!< Requests not yet taken by an I/O thread, in the order submitted
+		std::vector<AsyncReadWorker*> Workers;	//!< The running I/O threads
+		bool Stopping;							//!< True once the I/O threads have been asked to stop
+
+		friend class AsyncReadWorker;
+
+	public:
+		//! Construct an engine with a given number of I/O threads
+		/*! The number of threads is the number of reads that may be in flight at once, and so the queue depth seen by the storage
+		 *  \note No more threads are started than the worker count of the shared TaskExecutor
+		 */
+		AsyncReadEngine(unsigned int Threads = 4) : ThreadCount(Threads ? Threads : 1), Stopping(false) {}
+
+		//! Stop the I/O threads, abandoning any queued reads
+		~AsyncReadEngine();
+
+		//! Get the number of I/O threads used
+		unsigned int GetThreads(void) const { return ThreadCount; }
+
+		//! Submit a read of the whole value of an object
+		/*! \return The request, or NULL if no I/O thread could be started, in which case the caller should read the value itself */
+		RequestPtr Submit(KLVObjectPtr Object);
+
+		//! Wait for a request to complete
+		/*! If the request has not yet been taken by an I/O thread it is read on the calling thread instead, so a caller that only
+		 *  waits for its reads never waits behind reads queued by others.
+		 *  \return true if the whole value was read, false if the read failed or the request was cancelled
+		 */
+		bool Wait(RequestPtr &ThisRequest);
+
+		//! Cancel a request, if it has not yet been started
+		/*! A request that is already being read completes as normal, but its result may be ignored */
+		void Cancel(RequestPtr &ThisRequest);
+
+	protected:
+		//! Take and service requests until stopping, called by each I/O thread
+		void WorkerLoop(void);
+
+		//! Read the value of a request's object
+		static bool ReadValue(Request *ThisRequest);
+
+	private:
+		//! Prevent copy construction
+		AsyncReadEngine(const AsyncReadEngine &);
+	};
+
+	//! A smart pointer to an AsyncReadEngine object
+	typedef SmartPtr<AsyncReadEngine> AsyncReadEnginePtr;
+}
+
+#endif // MXFLIB__ASYNCREAD_H
@@ -29,9 +29,162 @@
 
 #include "mxflib/mxflib.h"
 
+// Use SSE2 or NEON to speed up the commonest de-interleave cases where available at compile time
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AUDIOMUX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define AUDIOMUX_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace mxflib;
 
 
+namespace
+{
+	//! De-interleave Samples samples, each made of Units units of Bytes bytes, into one buffer per unit
+	/*! A unit is the set of channels read by one source, so a 16-channel 24-bit file split into mono sources
+	 *  has 16 units of 3 bytes and the same file split into stereo pairs has 8 units of 6 bytes.
+	 *  Fixing the unit size at compile time allows the compiler to inline each copy.
+	 */
+	template<unsigned int Bytes> void DeinterleaveUnits(const UInt8 *In, size_t Samples, unsigned int Units, UInt8 **Out)
+	{
+		// DRAGONS: Work in blocks of samples so that each block of input stays in cache while every unit is copied out of it
+		const size_t BlockSize = 64;
+		size_t Done = 0;
+		while(Done < Samples)
+		{
+			size_t Count = Samples - Done;
+			if(Count > BlockSize) Count = BlockSize;
+
+			unsigned int i;
+			for(i=0; i<Units; i++)
+			{
+				const UInt8 *Src = &In[i * Bytes];
+				UInt8 *Dest = &Out[i][Done * Bytes];
+				size_t Step = Units * Bytes;
+
+				size_t j;
+				for(j=0; j<Count; j++)
+				{
+					memcpy(Dest, Src, Bytes);
+					Dest += Bytes;
+					Src += Step;
+				}
+			}
+
+			In += Count * Units * Bytes;
+			Done += Count;
+		}
+	}
+
+	//! De-interleave a pair of 2-byte units
+	void Deinterleave2x2(const UInt8 *In, size_t Samples, UInt8 **Out)
+	{
+		UInt8 *Left = Out[0];
+		UInt8 *Right = Out[1];
+
+#if defined(AUDIOMUX_SSE2)
+		// Split 8 samples at a time: sign extend each half of every 32-bit sample pair, then pack them back to 16-bits
+		// DRAGONS: The sign extension ensures that the saturating pack never alters a value
+		while(Samples >= 8)
+		{
+			__m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i *>(In));
+			__m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&In[16]));
+
+			__m128i L = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(A, 16), 16), _mm_srai_epi32(_mm_slli_epi32(B, 16), 16));
+			__m128i R = _mm_packs_epi32(_mm_srai_epi32(A, 16), _mm_srai_epi32(B, 16));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Left), L);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Right), R);
+
+			In += 32;
+			Left += 16;
+			Right += 16;
+			Samples -= 8;
+		}
+#elif defined(AUDIOMUX_NEON)
+		while(Samples >= 8)
+		{
+			uint16x8x2_t V = vld2q_u16(reinterpret_cast<const uint16_t *>(In));
+			vst1q_u16(reinterpret_cast<uint16_t *>(Left), V.val[0]);
+			vst1q_u16(reinterpret_cast<uint16_t *>(Right), V.val[1]);
+
+			In += 32;
+			Left += 16;
+			Right += 16;
+			Samples -= 8;
+		}
+#endif
+
+		UInt8 *Rest[2] = { Left, Right };
+		DeinterleaveUnits<2>(In, Samples, 2, Rest);
+	}
+
+	//! De-interleave a pair of 4-byte units
+	void Deinterleave4x2(const UInt8 *In, size_t Samples, UInt8 **Out)
+	{
+		UInt8 *Left = Out[0];
+		UInt8 *Right = Out[1];
+
+#if defined(AUDIOMUX_SSE2)
+		// Split 4 samples at a time by gathering the even and odd 32-bit words of each pair of registers
+		while(Samples >= 4)
+		{
+			__m128i A = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(In)), _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i B = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&In[16])), _MM_SHUFFLE(3, 1, 2, 0));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Left), _mm_unpacklo_epi64(A, B));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Right), _mm_unpackhi_epi64(A, B));
+
+			In += 32;
+			Left += 16;
+			Right += 16;
+			Samples -= 4;
+		}
+#elif defined(AUDIOMUX_NEON)
+		while(Samples >= 4)
+		{
+			uint32x4x2_t V = vld2q_u32(reinterpret_cast<const uint32_t *>(In));
+			vst1q_u32(reinterpret_cast<uint32_t *>(Left), V.val[0]);
+			vst1q_u32(reinterpret_cast<uint32_t *>(Right), V.val[1]);
+
+			In += 32;
+			Left += 16;
+			Right += 16;
+			Samples -= 4;
+		}
+#endif
+
+		UInt8 *Rest[2] = { Left, Right };
+		DeinterleaveUnits<4>(In, Samples, 2, Rest);
+	}
+
+	//! De-interleave Samples samples, each made of Units equal sized units of UnitSize bytes, into one buffer per unit
+	/*! \return false if this unit size is not supported */
+	bool Deinterleave(const UInt8 *In, size_t Samples, unsigned int UnitSize, unsigned int Units, UInt8 **Out)
+	{
+		if(Units == 2)
+		{
+			if(UnitSize == 2) { Deinterleave2x2(In, Samples, Out); return true; }
+			if(UnitSize == 4) { Deinterleave4x2(In, Samples, Out); return true; }
+		}
+
+		switch(UnitSize)
+		{
+			case 1: DeinterleaveUnits<1>(In, Samples, Units, Out); return true;
+			case 2: DeinterleaveUnits<2>(In, Samples, Units, Out); return true;
+			case 3: DeinterleaveUnits<3>(In, Samples, Units, Out); return true;
+			case 4: DeinterleaveUnits<4>(In, Samples, Units, Out); return true;
+			case 6: DeinterleaveUnits<6>(In, Samples, Units, Out); return true;
+			case 8: DeinterleaveUnits<8>(In, Samples, Units, Out); return true;
+			default: return false;
+		}
+	}
+}
+
+
 //! Calculate BytesPerEditUnit for a given KAGSize
 void AudioDemuxSource::CalcBytesPerEditUnit(Uint32 KAGSize)
 {
@@ -112,13 +265,17 @@ DataChunkPtr AudioDemux::GetEssenceData(AudioDemuxSource *Caller, unsigned int C
 	// Pointer to the current position in the source buffer
 	UInt8 *BuffPtr;
 
+	// The de-interleaved version of the source buffer, if there is one
+	SplitDataList *Split;
+
 	if(InCurrentBuffer(Channel))
 	{
 		SamplesRemaining = CurrentSampleCount - (Outputs[Channel].Pos - CurrentStart);
 		Start = CurrentStart;
 
-		// Initialize the buffer pointer
+		// Initialize the buffer pointers
 		BuffPtr = CurrentData->Data;
+		Split = &CurrentSplit;
 	}
 	else if(Outputs[Channel].Eof)
 	{
@@ -150,8 +307,9 @@ DataChunkPtr AudioDemux::GetEssenceData(AudioDemuxSource *Caller, unsigned int C
 		SamplesRemaining = (*it).SampleCount - (Outputs[Channel].Pos - (*it).Start);
 		Start = (*it).Start;
 
-		// Initialize the buffer pointer
+		// Initialize the buffer pointers
 		BuffPtr = (*it).Data->Data;
+		Split = &(*it).Split;
 	}
 
 	/* Allocate the demux buffer */
@@ -182,7 +340,34 @@ DataChunkPtr AudioDemux::GetEssenceData(AudioDemuxSource *Caller, unsigned int C
 	// Ensure that the caller's end-of-item flag is set if we will demux all remaining samples for this chunk
 	Caller->SetEoi(SamplesRemaining == SampleCount);
 
-	
+	// If this buffer has already been de-interleaved for this source we simply take our part of it
+	if((Channel < Split->size()) && (*Split)[Channel] && (Outputs[Channel].GroupCount == ChannelCount))
+	{
+		DataChunkPtr &Plane = (*Split)[Channel];
+		size_t Offset = static_cast<size_t>((Outputs[Channel].Pos - Start) * BytesPerSample);
+
+		if(Offset + BufferSize <= Plane->Size)
+		{
+			// DRAGONS: If we are taking the whole buffer we hand it over rather than copying, as no-one else will need it
+			if((Offset == 0) && (BufferSize == Plane->Size))
+			{
+				Ret = Plane;
+				Plane = NULL;
+			}
+			else
+				Ret = Plane->Slice(Offset, BufferSize);
+
+			Position FinalPos = Outputs[Channel].Pos + SampleCount;
+			while(ChannelCount--)
+			{
+				Outputs[Channel].Pos = FinalPos;
+				Channel++;
+			}
+
+			return Ret;
+		}
+	}
+
 
 	// Allocate the buffer
 	Ret = new DataChunk(BufferSize);
@@ -369,7 +554,7 @@ DataChunkPtr AudioDemux::GetEssenceData(AudioDemuxSource *Caller, unsigned int C
 		if(ChannelCount == 1)
 		{
 			// The size of each sample in bytes  - less the number that we will have already incremented with post increment
-			register unsigned int StepSize = SourceSampleSize;
+			register unsigned int StepSize = SourceSampleSize - 3;
 
 			/* Single channel output */
 			while(SampleCount--)
@@ -484,6 +669,9 @@ EssenceSourcePtr AudioDemux::GetSource(unsigned int Channel, unsigned int Channe
 	// Make the new source
 	Ret = new AudioDemuxSource(this, Channel, ChannelCount);
 
+	// Record how many channels this source reads so that buffers can be de-interleaved for it
+	Outputs[Channel].GroupCount = ChannelCount;
+
 	/* Set the output data for each of our channels */
 	while(ChannelCount--)
 	{
@@ -537,6 +725,7 @@ void AudioDemux::FillBuffer(void)
 			Old.SampleCount = CurrentSampleCount;
 
 			OldData.push_back(Old);
+			OldData.back().Split.swap(CurrentSplit);
 		}
 
 		AUDIODEMUX_DEBUG("Lowest required sample = %s\n", Int64toString(LowestPosition).c_str());
@@ -589,6 +778,78 @@ void AudioDemux::FillBuffer(void)
 		// Set the sample count
 		CurrentSampleCount = CurrentData->Size / SourceSampleSize;
 	}
+
+	// De-interleave the new data for all sources at once
+	if(CurrentData) SplitBuffer(CurrentData, CurrentSampleCount, CurrentSplit);
+	else CurrentSplit.clear();
+}
+
+
+//! De-interleave a newly read buffer for all attached sources in a single pass
+/*! \param Data The interleaved data
+ *  \param SampleCount The number of whole samples in Data
+ *  \param Split List to receive the de-interleaved data for each source, indexed by the source's first channel
+ *  \note Split is left empty if the data cannot be handled this way, in which case each source demuxes its own data
+ */
+void AudioDemux::SplitBuffer(DataChunkPtr &Data, Length SampleCount, SplitDataList &Split)
+{
+	Split.clear();
+
+	// Samples that are being resized, or are not a whole number of bytes, are left to each source
+	if((OutputBitSize != 0) && (OutputBitSize != SourceChannelBitSize)) return;
+	if((SourceChannelBitSize == 0) || (SourceChannelBitSize & 7)) return;
+	if(SampleCount <= 0) return;
+
+	unsigned int ChannelSize = SourceChannelBitSize / 8;
+
+	// Locate the first channel of each source, and see if every channel is read by sources of the same size
+	std::vector<unsigned int> Firsts;
+	bool Uniform = true;
+
+	unsigned int i;
+	for(i=0; i<SourceChannelCount; i++)
+	{
+		if((!Outputs[i].Source) || (Outputs[i].GroupCount == 0)) continue;
+
+		if(i != Firsts.size() * Outputs[i].GroupCount) Uniform = false;
+		else if((!Firsts.empty()) && (Outputs[i].GroupCount != Outputs[Firsts.front()].GroupCount)) Uniform = false;
+
+		Firsts.push_back(i);
+	}
+
+	if(Firsts.empty()) return;
+
+	if(Uniform && ((Firsts.size() * Outputs[Firsts.front()].GroupCount) != SourceChannelCount)) Uniform = false;
+
+	// Allocate the output buffers
+	Split.resize(SourceChannelCount);
+	std::vector<UInt8 *> Out(Firsts.size());
+
+	size_t Count = static_cast<size_t>(SampleCount);
+	for(i=0; i<Firsts.size(); i++)
+	{
+		Split[Firsts[i]] = new DataChunk(Count * Outputs[Firsts[i]].GroupCount * ChannelSize);
+		Out[i] = Split[Firsts[i]]->Data;
+	}
+
+	// Use a specialized version when all channels are read in equal sized sets
+	if(Uniform && Deinterleave(Data->Data, Count, Outputs[Firsts.front()].GroupCount * ChannelSize, static_cast<unsigned int>(Firsts.size()), &Out[0])) return;
+
+	// Otherwise copy the channels for each source in turn
+	for(i=0; i<Firsts.size(); i++)
+	{
+		const UInt8 *Src = &Data->Data[Firsts[i] * ChannelSize];
+		UInt8 *Dest = Out[i];
+		size_t Bytes = Outputs[Firsts[i]].GroupCount * ChannelSize;
+
+		size_t j;
+		for(j=0; j<Count; j++)
+		{
+			memcpy(Dest, Src, Bytes);
+			Dest += Bytes;
+			Src += SourceSampleSize;
+		}
+	}
 }
 
 
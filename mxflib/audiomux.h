@@ -72,14 +72,19 @@ namespace mxflib
 			EssenceSourceParent Source;		//!< Parent pointers for this channel's output EssenceSource, NULL if this channel not being output
 			Position Pos;					//!< Sample position for this channel, holds the sample number for the next sample to output for this channel
 			bool Eof;						//!< True once this channel has output all that it can
+			unsigned int GroupCount;		//!< Number of channels read by the source whose first channel is this one, else zero
 		};
 
+		//! List of de-interleaved buffers, indexed by the first channel of each source
+		typedef std::vector<DataChunkPtr> SplitDataList;
+
 		//! Structure holding data relating to old, but still active, data
 		struct OldDataStruct
 		{
 			DataChunkPtr Data;				//!< The data chunk holding the data
 			Position Start;					//!< The sample number if the first sample in the data buffer
 			Length SampleCount;				//!< The number of samples in the data buffer
+			SplitDataList Split;			//!< Data de-interleaved for each source, indexed by first channel, or empty if not split
 		};
 
 		//! List of OldDataStructs
@@ -101,6 +106,7 @@ namespace mxflib
 		DataChunkPtr CurrentData;			//!< Pointer to a chunk containing the current audio data
 		Position CurrentStart;				//!< The sample number of the first sample in the CurrentData buffer
 		Length CurrentSampleCount;			//!< The number of samples in the CurrentData buffer
+		SplitDataList CurrentSplit;			//!< The CurrentData buffer de-interleaved for each source, indexed by first channel (empty if not split)
 
 		OldDataList OldData;				//!< List of data about chunks containing old, but active, data
 
@@ -140,6 +146,7 @@ namespace mxflib
 
 			// Initialize list of output sources and their positions
 			Outputs = new OutputData[SourceChannelCount];
+			for(unsigned int i=0; i<SourceChannelCount; i++) Outputs[i].GroupCount = 0;
 
 			// Clear the current start
 			CurrentStart = 0;
@@ -248,6 +255,14 @@ namespace mxflib
 		 */
 		void FillBuffer(void);
 
+		//! De-interleave a newly read buffer for all attached sources in a single pass
+		/*! \param Data The interleaved data
+		 *  \param SampleCount The number of whole samples in Data
+		 *  \param Split List to receive the de-interleaved data for each source, indexed by the source's first channel
+		 *  \note Split is left empty if the data cannot be handled this way, in which case each source demuxes its own data
+		 */
+		void SplitBuffer(DataChunkPtr &Data, Length SampleCount, SplitDataList &Split);
+
 		//! Determine which of the old buffers to use for the given channel
 		/*! \return iterator indexing the OutputData structure for the buffer, or OutData.end() if there is a problem
 		 *  \note The caller must ensure that the channel number is valid and the channel is attached to an AudioDemuxSource before calling
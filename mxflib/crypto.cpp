@@ -145,6 +145,8 @@ void KLVEObject::Init(void)
 
 	PreDecrypted = 0;
 	AwaitingEncryption = 0;
+
+	EncryptHashes = false;
 };
 
 
@@ -462,12 +464,24 @@ size_t KLVEObject::ReadDataFrom(Position Offset, size_t Size /*=-1*/)
 		// Initialize the decryption engine with the specified Initialization Vector
 		Decrypt->SetIV(16, Data.Data, true);
 
-		// Decrypt the check value...
-		DataChunkPtr PlainCheck = Decrypt->Decrypt(16, &Data.Data[16]);
+		// Decrypt the check value, in place if we can to save allocating a buffer
+		UInt8 PlainCheck[16];
+		memcpy(PlainCheck, &Data.Data[16], 16);
+		bool CheckDecrypted;
+		if(Decrypt->CanDecryptInPlace(16))
+		{
+			CheckDecrypted = Decrypt->DecryptInPlace(16, PlainCheck);
+		}
+		else
+		{
+			DataChunkPtr NewCheck = Decrypt->Decrypt(16, PlainCheck);
+			CheckDecrypted = (NewCheck && (NewCheck->Size == 16));
+			if(CheckDecrypted) memcpy(PlainCheck, NewCheck->Data, 16);
+		}
 
 		// Encrypt the check value... (Which is "CHUKCHUKCHUKCHUK" who ever said Chuck Harrison has no ego?)
 		const UInt8 DefinitivePlainCheck[16] = { 0x43, 0x48, 0x55, 0x4B, 0x43, 0x48, 0x55, 0x4B, 0x43, 0x48, 0x55, 0x4B, 0x43, 0x48, 0x55, 0x4B };
-		if((!PlainCheck) || (memcmp(PlainCheck->Data, DefinitivePlainCheck, PlainCheck->Size) != 0))
+		if((!CheckDecrypted) || (memcmp(PlainCheck, DefinitivePlainCheck, 16) != 0))
 		{
 			error("Check value did not correctly decrypt in KLVEObject::ReadDataFrom() - is the encryption key correct?\n");
 			return 0;
@@ -477,15 +491,40 @@ size_t KLVEObject::ReadDataFrom(Position Offset, size_t Size /*=-1*/)
 	// If all the requested bytes are encrypted read-and-decrypt
 	if(Offset >= PlaintextOffset) 
 	{
-		// Check if an attempt is being made to random access the encrypted data - and barf if this is so
-		if(Offset != CurrentReadOffset)
+		// Random access is only possible if we are not hashing, as the hash must see every byte in order
+		if((Offset != CurrentReadOffset) && ReadHasher)
 		{
 			error("Attempt to perform random-access reading of an encrypted KLV value field\n");
 			return 0;
 		}
 
+		// Restart decryption at the block holding the first requested byte, and read from the start of that block
+		size_t Lead = 0;
+		if(Offset != CurrentReadOffset)
+		{
+			Position BlockStart = SeekCryptoData(Offset);
+			if(BlockStart < 0) return 0;
+
+			Lead = static_cast<size_t>(Offset - BlockStart);
+			Offset = BlockStart;
+			if(Size != static_cast<size_t>(-1)) Size += Lead;
+		}
+
 		size_t Ret = ReadCryptoDataFrom(Offset, Size);
 
+		// Drop the bytes before the requested offset
+		if(Lead)
+		{
+			if(Ret <= Lead) Ret = 0;
+			else
+			{
+				Ret -= Lead;
+				memmove(Data.Data, &Data.Data[Lead], Ret);
+			}
+
+			Data.Resize(Ret);
+		}
+
 		// Read the AS-DCP footer if we have read the last of the data
 		if(CurrentReadOffset >= ValueLength) if(!ReadFooter()) { Ret = 0; Data.Resize(0); }
 
@@ -518,12 +557,17 @@ size_t KLVEObject::ReadDataFrom(Position Offset, size_t Size /*=-1*/)
 
 	/* We will be mixing plaintext and encrypted */
 
-	// Check if an attempt is being made to random access the encrypted data - and barf if this is so
-	// DRAGONS: It is possible to re-load the initial IV to allow a "rewind" but this is not implemented
+	// Check if an attempt is being made to random access the encrypted data while hashing - and barf if this is so
 	if(CurrentReadOffset > PlaintextOffset)
 	{
-		error("Attempt to perform random-access reading of an encrypted KLV value field\n");
-		return 0;
+		if(ReadHasher)
+		{
+			error("Attempt to perform random-access reading of an encrypted KLV value field\n");
+			return 0;
+		}
+
+		// Rewind the decryption to the first encrypted block
+		if(SeekCryptoData(PlaintextOffset) < 0) return 0;
 	}
 
 	// Determine how many plaintext bytes could be available (maximum)
@@ -554,9 +598,13 @@ size_t KLVEObject::ReadDataFrom(Position Offset, size_t Size /*=-1*/)
 
 	/* We have all the plaintext bytes from Offset forwards, now we read all encrypted bytes too */
 
-	// Take the buffer from the current DataChunk to preserve it
+	// Take the buffer from the current DataChunk to preserve it, or copy it if it is an external buffer that can't be taken
 	DataChunkPtr PlainData = new DataChunk;
-	PlainData->TakeBuffer(Data, true);
+	if(!PlainData->TakeBuffer(Data, true))
+	{
+		PlainData->Set(Data);
+		Data.Resize(0);
+	}
 
 	// Work out how many encrypted bytes to read
 	size_t EncSize;
@@ -569,7 +617,11 @@ size_t KLVEObject::ReadDataFrom(Position Offset, size_t Size /*=-1*/)
 	PlainData->Append(Data);
 
 	// Transfer this data to the "current" DataChunk
-	Data.TakeBuffer(PlainData);
+	if(!Data.TakeBuffer(PlainData))
+	{
+		Data.Resize(0);
+		Data.Set(PlainData);
+	}
 
 	// Set the "next" position to just after the end of what we read
 	CurrentReadOffset = Offset + Data.Size;
@@ -644,17 +696,13 @@ size_t KLVEObject::ReadCryptoDataFrom(Position Offset, size_t Size /*=-1*/)
 	// Add back in any pre-decrypted data
 	if(PreDecrypted)
 	{
-		// Steal the newly decrypted bytes
-		UInt8 *Buffer = Data.StealBuffer(true);
-
-		// Make a buffer large enough for the complete data
-		Data.ResizeBuffer(PreDecrypted + static_cast<size_t>(BytesToDecrypt));
+		// Move the newly decrypted bytes up to make room, within the existing buffer if it is big enough
+		size_t NewBytes = Data.Size;
+		Data.Resize(PreDecrypted + NewBytes);
+		memmove(&Data.Data[PreDecrypted], Data.Data, NewBytes);
 
 		// Put the pre-decrypted bytes at the start
-		Data.Set(PreDecrypted, PreDecryptBuffer);
-
-		// Follow it with the newly decrypted data
-		Data.Set(static_cast<size_t>(BytesToDecrypt), Buffer, PreDecrypted);
+		memcpy(Data.Data, PreDecryptBuffer, PreDecrypted);
 	}
 
 	// If we have decrypted more than requested store them as pre-decrypted for next time
@@ -678,6 +726,36 @@ size_t KLVEObject::ReadCryptoDataFrom(Position Offset, size_t Size /*=-1*/)
 }
 
 
+//! Set up decryption to restart at the cipher block holding a given offset in the encrypted portion of the KLV value field
+/*! The IV is set to the ciphertext of the previous block, as AES-CBC allows, so nothing before the block is decrypted
+ *  \return The offset of the start of the block, or -1 on error
+ */
+Position KLVEObject::SeekCryptoData(Position Offset)
+{
+	Position BlockStart = PlaintextOffset + ((Offset - PlaintextOffset) / EncryptionGranularity) * EncryptionGranularity;
+
+	// DRAGONS: The block before the first encrypted block is the encrypted check value, which precedes any plaintext
+	Position PrevBlock;
+	if(BlockStart == PlaintextOffset) PrevBlock = static_cast<Position>(DataOffset) - EncryptionGranularity;
+	else PrevBlock = DataOffset + BlockStart - EncryptionGranularity;
+
+	DataChunk PrevData;
+	if(Base_ReadDataFrom(PrevData, PrevBlock, EncryptionGranularity) < EncryptionGranularity)
+	{
+		error("Unable to read the previous cipher block for random-access reading in KLVEObject::ReadDataFrom()\n");
+		return -1;
+	}
+
+	Decrypt->SetIV(EncryptionGranularity, PrevData.Data, true);
+
+	// Any bytes decrypted ahead of the old position are no use now
+	PreDecrypted = 0;
+	CurrentReadOffset = BlockStart;
+
+	return BlockStart;
+}
+
+
 //! Read an integer set of chunks from a specified position in the encrypted portion of the KLV value field into the DataChunk
 /*! \param Offset Offset from the start of the KLV value from which to start reading
  *  \param Size Number of bytes to read, if = -1 all available bytes will be read (which could be billions!)
@@ -711,6 +789,8 @@ size_t KLVEObject::ReadChunkedCryptoDataFrom(Position Offset, size_t Size)
 		}
 	}
 
+	TraceScope Trace("KLVEObject::Decrypt", "crypto");
+
 	// See if we can decrypt this in place...
 	if(Decrypt->CanDecryptInPlace(Size))
 	{
@@ -735,8 +815,12 @@ size_t KLVEObject::ReadChunkedCryptoDataFrom(Position Offset, size_t Size)
 		return 0;
 	}
 
-	// Take over the buffer from the decrypted data
-	Data.TakeBuffer(NewData);
+	// Take over the buffer from the decrypted data, or copy it if it is an external buffer that can't be taken
+	if(!Data.TakeBuffer(NewData))
+	{
+		Data.Resize(0);
+		Data.Set(NewData);
+	}
 
 	return Size;
 }
@@ -815,6 +899,10 @@ size_t KLVEObject::WriteDataTo(const UInt8 *Buffer, Position Offset, size_t Size
 		// Update the current hash if we are calculating one
 		if(WriteHasher) WriteHasher->HashData(16, IV);
 
+		// Let the encryption wrapper hash all encrypted data as it produces it, if it can, starting with the check value
+		// DRAGONS: This is called even if we are not hashing, so that a wrapper re-used from an earlier KLVEObject stops hashing
+		EncryptHashes = Encrypt->SetOutputHasher(WriteHasher) && (WriteHasher ? true : false);
+
 		// ** Write the check value
 
 		// Encrypt the check value... (Which is "CHUKCHUKCHUKCHUK" who ever said Chuck Harrison has no ego?)
@@ -827,7 +915,7 @@ size_t KLVEObject::WriteDataTo(const UInt8 *Buffer, Position Offset, size_t Size
 			Base_WriteDataTo(CheckData->Data, DataOffset - EncryptionOverhead + 16, 16);
 
 			// Update the current hash if we are calculating one
-			if(WriteHasher) WriteHasher->HashData(CheckData);
+			if(WriteHasher && !EncryptHashes) WriteHasher->HashData(CheckData);
 		}
 		else
 		{
@@ -937,6 +1025,8 @@ size_t KLVEObject::WriteDataTo(const UInt8 *Buffer, Position Offset, size_t Size
  */
 size_t KLVEObject::WriteCryptoDataTo(const UInt8 *Buffer, Position Offset, size_t Size)
 {
+	TraceScope Trace("KLVEObject::WriteCryptoDataTo", "crypto");
+
 	// Self-deleting store to allow us to extend working buffer if required
 	DataChunk TempData;
 
@@ -1016,7 +1106,7 @@ size_t KLVEObject::WriteCryptoDataTo(const UInt8 *Buffer, Position Offset, size_
 
 			// Update the current hash if we are calculating one
 			// TODO: Sort the possible overflow here
-			if(WriteHasher) WriteHasher->HashData(static_cast<size_t>(StartSize), NewData->Data);
+			if(WriteHasher && !EncryptHashes) WriteHasher->HashData(static_cast<size_t>(StartSize), NewData->Data);
 		}
 
 		// Buffer for last data to be encrypted
@@ -1043,7 +1133,7 @@ size_t KLVEObject::WriteCryptoDataTo(const UInt8 *Buffer, Position Offset, size_
 		Base_WriteDataTo(NewData->Data, DataOffset + Offset + StartSize, EncryptionGranularity);
 
 		// Update the current hash if we are calculating one
-		if(WriteHasher) WriteHasher->HashData(EncryptionGranularity, NewData->Data);
+		if(WriteHasher && !EncryptHashes) WriteHasher->HashData(EncryptionGranularity, NewData->Data);
 
 		// There are no more bytes to encrypt
 		AwaitingEncryption = 0;
@@ -1082,7 +1172,7 @@ size_t KLVEObject::WriteCryptoDataTo(const UInt8 *Buffer, Position Offset, size_
 
 	// Update the current hash if we are calculating one
 	// TODO: Sort the possible overflow here
-	if(WriteHasher) WriteHasher->HashData(Size, NewData->Data);
+	if(WriteHasher && !EncryptHashes) WriteHasher->HashData(Size, NewData->Data);
 
 	// Chain the IV for next time...
 	EncryptionIV = Encrypt->GetIV();
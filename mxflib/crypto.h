@@ -37,6 +37,11 @@
 // Forward refs
 namespace mxflib
 {
+	// Forward declare Hash_Base to allow HashPtr to be used by the encryptor wrapper
+	class Hash_Base;
+
+	// Smart pointer to a hash function wrapper object
+	typedef SmartPtr<Hash_Base> HashPtr;
 }
 
 
@@ -138,6 +143,12 @@ namespace mxflib
 		/*! \return NULL pointer if the encryption is unsuccessful
 		 */
 		DataChunkPtr Encrypt(DataChunkPtr &Data) { return Encrypt(Data->Size, Data->Data); };
+
+		//! Ask this encryption system to pass all encrypted data to a hasher as it is produced
+		/*! This allows encryption and hashing to be done in a single pass over the data, while it is still in the cache.
+		 *  \return true if all data encrypted from now on will be hashed, false if the caller must hash the encrypted data itself
+		 */
+		virtual bool SetOutputHasher(HashPtr &Hasher) { UNUSED_PARAMETER(Hasher); return false; }
 	};
 
 	// Smart pointer to an encryption wrapper object
@@ -218,13 +229,18 @@ namespace mxflib
 
 		//! Decrypt data bytes in place
 		/*! \return true if the decryption <i>appears to be</i> successful
+		 *  \note If the chunk is a view of a shared buffer it is copied first, so the owner's data is not changed
 		 */
-		bool DecryptInPlace(DataChunk &Data) { return DecryptInPlace(Data.Size, Data.Data); };
+		bool DecryptInPlace(DataChunk &Data) 
+		{ 
+			if(Data.IsShared()) Data.ResizeBuffer(Data.Size);
+			return DecryptInPlace(Data.Size, Data.Data); 
+		};
 
 		//! Decrypt data bytes in place
 		/*! \return true if the decryption <i>appears to be</i> successful
 		 */
-		bool DecryptInPlace(DataChunkPtr &Data) { return DecryptInPlace(Data->Size, Data->Data); };
+		bool DecryptInPlace(DataChunkPtr &Data) { return DecryptInPlace(*Data); };
 
 		//! Decrypt data and return in a new buffer
 		/*! \return NULL pointer if the decryption is unsuccessful
@@ -292,8 +308,6 @@ namespace mxflib
 		virtual DataChunkPtr GetHash(void) = 0;
 	};
 
-	// Smart pointer to a hash function wrapper object
-	typedef SmartPtr<Hash_Base> HashPtr;
 
 
 	//! KLVEObject class
@@ -312,6 +326,7 @@ namespace mxflib
 		EncryptPtr	Encrypt;						//!< Pointer to the encryption wrapper
 		DecryptPtr	Decrypt;						//!< Pointer to the decryption wrapper
 		HashPtr WriteHasher;						//!< Pointer to a hasher being used for hashing data being written
+		bool EncryptHashes;							//!< True if the encryption wrapper is passing encrypted data to WriteHasher itself
 		HashPtr ReadHasher;							//!< Pointer to a hasher being used for hashing data being read
 
 		bool DataLoaded;							//!< True once the AS-DCP header data has been read
@@ -452,9 +467,21 @@ namespace mxflib
 		/*! \param Offset Offset from the start of the KLV value from which to start reading
 		 *  \param Size Number of bytes to read, if -1 all available bytes will be read (which could be billions!)
 		 *  \return The number of bytes read
+		 *  \note Encrypted data may be read from any offset, when not hashing, and only the cipher blocks covering the
+		 *        requested bytes are decrypted
 		 */
 		virtual size_t ReadDataFrom(Position Offset, size_t Size = static_cast<size_t>(-1));
 
+		//! Read data from the start of the KLV value into the current DataChunk
+		/*! \note Decrypted data is always held in a buffer owned by this object, so this is the same as ReadData()
+		 */
+		virtual size_t ReadDataView(size_t Size = static_cast<size_t>(-1)) { return ReadData(Size); }
+
+		//! Read data from a specified position in the KLV value field into the DataChunk
+		/*! \note Decrypted data is always held in a buffer owned by this object, so this is the same as ReadDataFrom()
+		 */
+		virtual size_t ReadDataViewFrom(Position Offset, size_t Size = static_cast<size_t>(-1)) { return ReadDataFrom(Offset, Size); }
+
 		//! Write the key and length of the current DataChunk to the destination file
 		/*! The key and length will be written to the source file as set by SetSource.
 		 *  If LenSize is zero the length will be formatted to match KLSize (if possible!)
@@ -576,6 +603,12 @@ namespace mxflib
 		 *  Only encrypted parts of the value may be read using this function (i.e. Offset >= PlaintextOffset)
 		 */
 		size_t ReadChunkedCryptoDataFrom(Position Offset, size_t Size);
+
+		//! Set up decryption to restart at the cipher block holding a given offset in the encrypted portion of the KLV value field
+		/*! The IV is set to the ciphertext of the previous block, as AES-CBC allows, so nothing before the block is decrypted
+		 *  \return The offset of the start of the block, or -1 on error
+		 */
+		Position SeekCryptoData(Position Offset);
 	
 		//! Write encrypted data from a given buffer to a given location in the destination file
 		/*! \param Buffer Pointer to data to be written
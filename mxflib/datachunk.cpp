@@ -38,7 +38,8 @@ void mxflib::DataChunk::Resize(size_t NewSize, bool PreserveContents /*=true*/)
 	if(Size == NewSize) return;
 
 	// Simple truncate or resize within the existing buffer size
-	if(DataSize >= NewSize) 
+	// DRAGONS: A buffer shared with an owner can be truncated, but not re-grown as we would be writing into the owner's buffer
+	if((DataSize >= NewSize) && ((!BufferOwner) || (NewSize <= Size)))
 	{
 		Size = NewSize;
 		return;
@@ -55,12 +56,29 @@ void mxflib::DataChunk::Resize(size_t NewSize, bool PreserveContents /*=true*/)
 //debug("AllocSize = %u\n", AllocSize);
 	}
 
-	UInt8 *NewData = new UInt8[AllocSize];
+	// Small values are held in our own inline buffer rather than allocating
+	// DRAGONS: We can't already be using the inline buffer here as it would have been big enough for the simple case above
+	if(AllocSize <= InlineSize)
+	{
+		if(PreserveContents && (Size != 0)) memcpy(InlineBuffer, Data, Size);
+
+		if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
+		ExternalBuffer = true;
+		BufferOwner = NULL;
+
+		Data = InlineBuffer;
+		DataSize = InlineSize;
+		Size = NewSize;
+		return;
+	}
+
+	UInt8 *NewData = AllocBuffer(AllocSize);
 	if(PreserveContents && (Size != 0)) memcpy(NewData, Data, Size);
 
 //debug("Changing Buffer @ 0x%08x -> 0x%08x (0x%04x)\n", (int)Data, (int)NewData, (int)AllocSize);
-	if((!ExternalBuffer) && (Data)) delete[] Data;
+	if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
 	ExternalBuffer = false;
+	BufferOwner = NULL;
 	
 	Data = NewData;
 	DataSize = AllocSize;
@@ -72,7 +90,8 @@ void mxflib::DataChunk::Resize(size_t NewSize, bool PreserveContents /*=true*/)
 /*! The buffer is resized to <b>at least</b> NewSize, but Size remains unchanged */
 void mxflib::DataChunk::ResizeBuffer(size_t NewSize, bool PreserveContents /*=true*/)
 {
-	if(DataSize >= NewSize) return;
+	// DRAGONS: A buffer shared with an owner is always replaced as the caller is about to write to it
+	if((DataSize >= NewSize) && (!BufferOwner)) return;
 
 	if(AllocationGranularity)
 	{
@@ -81,12 +100,27 @@ void mxflib::DataChunk::ResizeBuffer(size_t NewSize, bool PreserveContents /*=tr
 		NewSize = (NewSize+1) * AllocationGranularity;
 	}
 
-	UInt8 *NewData = new UInt8[NewSize];
+	// Small buffers are held inline, as in Resize()
+	if((NewSize <= InlineSize) && (Data != InlineBuffer))
+	{
+		if(PreserveContents && (Size != 0)) memcpy(InlineBuffer, Data, Size);
+
+		if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
+		ExternalBuffer = true;
+		BufferOwner = NULL;
+
+		Data = InlineBuffer;
+		DataSize = InlineSize;
+		return;
+	}
+
+	UInt8 *NewData = AllocBuffer(NewSize);
 	if(PreserveContents && (Size != 0)) memcpy(NewData, Data, Size);
 
 //debug("Changing Buffer @ 0x%08x -> 0x%08x (0x%04x)+\n", (int)Data, (int)NewData, (int)NewSize);
-	if((!ExternalBuffer) && (Data)) delete[] Data;
+	if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
 	ExternalBuffer = false;
+	BufferOwner = NULL;
 	
 	Data = NewData;
 	DataSize = NewSize;
@@ -119,7 +153,7 @@ std::string mxflib::DataChunk::GetString(void) const
 void mxflib::DataChunk::SetBuffer(UInt8 *Buffer, size_t BuffSize, size_t AllocatedSize /*=0*/)
 {
 //debug("Setting Buffer @ 0x%08x -> 0x%08x\n", (int)Data, (int)Buffer);
-	if((!ExternalBuffer) && (Data)) delete[] Data;
+	if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
 
 	Size = BuffSize;
 	Data = Buffer;
@@ -128,16 +162,47 @@ void mxflib::DataChunk::SetBuffer(UInt8 *Buffer, size_t BuffSize, size_t Allocat
 	else DataSize = AllocatedSize;
 
 	ExternalBuffer = true;
+	BufferOwner = NULL;
 }
 
 
 //! Transfer ownership of a data buffer from another DataChunk
 /*! This is a very efficient way to set one DataChunk to the value of another.
  *  However it partially destroys the source DataChunk by stealing its buffer.
+ *  If the source shares a buffer owned by another chunk, we take over its reference to the owner instead.
  *  \return true on success, false on failure
  */
 bool mxflib::DataChunk::TakeBuffer(DataChunk &OldOwner, bool MakeEmpty /*=false*/ )
 {
+	// An inline buffer can't be handed over, so copy the (small) contents instead
+	if(OldOwner.IsInline())
+	{
+		Resize(0);
+		Set(OldOwner.Size, OldOwner.Data);
+		if(MakeEmpty) OldOwner.Resize(0);
+		return true;
+	}
+
+	// A shared buffer stays with its owner, so we reference the owner just as the old chunk did
+	if(OldOwner.BufferOwner)
+	{
+		// DRAGONS: The owner is held before any old buffer of ours is released, in case we are the only other reference to it
+		DataChunkPtr Owner = OldOwner.BufferOwner;
+		SetBuffer(Owner, OldOwner.Data, OldOwner.Size);
+		DataSize = OldOwner.DataSize;
+
+		if(MakeEmpty)
+		{
+			OldOwner.BufferOwner = NULL;
+			OldOwner.Size = 0;
+			OldOwner.DataSize = 0;
+			OldOwner.Data = NULL;
+			OldOwner.ExternalBuffer = false;
+		}
+
+		return true;
+	}
+
 	size_t BuffSize = OldOwner.Size;
 	size_t AllocatedSize = OldOwner.DataSize;
 	bool ExtBuff = OldOwner.ExternalBuffer;
@@ -149,7 +214,8 @@ bool mxflib::DataChunk::TakeBuffer(DataChunk &OldOwner, bool MakeEmpty /*=false*
 	if(!Buffer) return false;
 
 	// Release any old buffer
-	if((!ExternalBuffer) && (Data)) delete[] Data;
+	if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
+	BufferOwner = NULL;
 
 	// Set the new details
 	Size = BuffSize;
@@ -168,26 +234,7 @@ bool mxflib::DataChunk::TakeBuffer(DataChunk &OldOwner, bool MakeEmpty /*=false*
  */
 bool mxflib::DataChunk::TakeBuffer(DataChunkPtr &OldOwner, bool MakeEmpty /*=false*/)
 {
-	size_t BuffSize = OldOwner->Size;
-	size_t AllocatedSize = OldOwner->DataSize;
-	bool ExtBuff = OldOwner->ExternalBuffer;
-
-	// Steal the old buffer
-	UInt8 *Buffer = OldOwner->StealBuffer(MakeEmpty);
-
-	// Fail if the old owner does not own its buffer!
-	if(!Buffer) return false;
-
-	// Release any old buffer
-	if((!ExternalBuffer) && (Data)) delete[] Data;
-
-	// Set the new details
-	Size = BuffSize;
-	DataSize = AllocatedSize;
-	Data = Buffer;
-	ExternalBuffer = ExtBuff;
-
-	return true;
+	return TakeBuffer(*OldOwner, MakeEmpty);
 }
 
 
@@ -218,3 +265,262 @@ UInt8 *DataChunk::StealBuffer(bool MakeEmpty /*=false*/)
 }
 
 
+//! Make a new chunk holding part of the data in this chunk, sharing our buffer rather than copying it where possible
+DataChunkPtr mxflib::DataChunk::Slice(size_t Start, size_t Length) const
+{
+	if(Start > Size) Start = Size;
+	if(Length > (Size - Start)) Length = Size - Start;
+
+	DataChunkPtr Ret = new DataChunk;
+	Ret->ShareFrom(*this, Start, Length);
+
+	return Ret;
+}
+
+
+//! Set this chunk to part of the data of another, sharing its buffer if possible
+void mxflib::DataChunk::ShareFrom(const DataChunk &Source, size_t Start, size_t Length)
+{
+	if(Length >= MinShareSize)
+	{
+		DataChunkPtr Owner = Source.GetSharedOwner();
+		if(Owner)
+		{
+			StatsAdd(StatsChunkSharedBytes, Length);
+
+			SetBuffer(Owner, &Source.Data[Start], Length);
+			return;
+		}
+	}
+
+	Set(Length, &Source.Data[Start]);
+}
+
+
+//! Get the chunk that owns our buffer, handing our own buffer to a new owner if required, so that it may be shared
+/*! \return NULL if the buffer can't be shared */
+DataChunkPtr mxflib::DataChunk::GetSharedOwner(void) const
+{
+	// DRAGONS: Our buffer is handed to a new owner that we then reference just like the slices, so our value is unchanged
+	//          but from now on any change we make is to a private copy. Several threads may slice the same chunk at once,
+	//          so the hand-off is made holding our reference lock, or two owners could each free the buffer.
+	DataChunk *This = const_cast<DataChunk*>(this);
+	This->__Lock();
+
+	DataChunkPtr Owner = BufferOwner;
+
+	// We don't control the lifetime of an external buffer, and an inline buffer goes when we do
+	if((!Owner) && (!ExternalBuffer) && Data)
+	{
+		Owner = new DataChunk;
+		Owner->Data = Data;
+		Owner->DataSize = DataSize;
+		Owner->Size = Size;
+		Owner->ExternalBuffer = false;
+
+		ExternalBuffer = true;
+		BufferOwner = Owner;
+	}
+
+	This->__Unlock();
+
+	return Owner;
+}
+
+
+#ifdef MXFLIB_HAS_MOVE
+//! Take over the buffer of another chunk, leaving it empty
+void mxflib::DataChunk::MoveFrom(DataChunk &Source)
+{
+	// Hold the source's owner before we release our own buffer, in case we are its only other reference
+	DataChunkPtr NewOwner = std::move(Source.BufferOwner);
+
+	if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize);
+
+	if(Source.IsInline())
+	{
+		// An inline buffer can't be handed over, but there is little to copy
+		memcpy(InlineBuffer, Source.InlineBuffer, Source.Size);
+		Data = InlineBuffer;
+		DataSize = InlineSize;
+		ExternalBuffer = true;
+	}
+	else
+	{
+		Data = Source.Data;
+		DataSize = Source.DataSize;
+		ExternalBuffer = Source.ExternalBuffer;
+	}
+
+	Size = Source.Size;
+	BufferOwner = std::move(NewOwner);
+
+	Source.Data = NULL;
+	Source.DataSize = 0;
+	Source.Size = 0;
+	Source.ExternalBuffer = false;
+}
+#endif // MXFLIB_HAS_MOVE
+
+
+namespace
+{
+	//! The allocator used for all DataChunk buffers, or NULL to use new[] and delete[] directly
+	BufferAllocator *ChunkAllocator = NULL;
+}
+
+
+//! Set the allocator to use for all DataChunk buffers, or NULL to use new[] and delete[] directly
+void mxflib::DataChunk::SetAllocator(BufferAllocator *Allocator)
+{
+	ChunkAllocator = Allocator;
+}
+
+
+//! Get the allocator in use for DataChunk buffers, or NULL if none
+BufferAllocator *mxflib::DataChunk::GetAllocator(void)
+{
+	return ChunkAllocator;
+}
+
+
+//! Allocate a new buffer of at least Size bytes, updating Size to the size allocated
+UInt8 *mxflib::DataChunk::AllocBuffer(size_t &Size)
+{
+	StatsAdd(StatsChunkAllocations);
+	StatsAdd(StatsChunkAllocatedBytes, Size);
+
+	if(ChunkAllocator) return ChunkAllocator->Allocate(Size);
+
+	return new UInt8[Size];
+}
+
+
+//! Free a buffer that we own, of the given allocated size
+void mxflib::DataChunk::FreeBuffer(UInt8 *Buffer, size_t Size)
+{
+	if(ChunkAllocator) ChunkAllocator->Free(Buffer, Size);
+	else delete[] Buffer;
+}
+
+
+//! Build a buffer pool
+mxflib::BufferPool::BufferPool(size_t MaxHeld /*=256*1024*1024*/, size_t MinSize /*=1024*/, size_t MaxSize /*=64*1024*1024*/)
+	: MinSize(MinSize), MaxSize(MaxSize), MaxHeld(MaxHeld)
+{
+	// Make sure the limits are themselves valid class sizes
+	if(this->MinSize < 4) this->MinSize = 4;
+	this->MinSize = ClassSize(SizeClass(this->MinSize));
+	this->MaxSize = ClassSize(SizeClass(this->MaxSize));
+
+	FreeLists.resize(SizeClass(this->MaxSize) + 1);
+
+	memset(&Stats, 0, sizeof(Stats));
+}
+
+
+//! Get the size class for a given size (the smallest class at least this big)
+unsigned int mxflib::BufferPool::SizeClass(size_t Size)
+{
+	// Find the power of two at or below Size
+	unsigned int Power = 0;
+	while((Size >> Power) > 1) Power++;
+
+	// Round up to the next quarter step (all sizes below 4 are their own power of two)
+	size_t Base = static_cast<size_t>(1) << Power;
+	size_t Step = Base / 4;
+	if(!Step) return Power * 4;
+
+	unsigned int Quarter = static_cast<unsigned int>((Size - Base + Step - 1) / Step);
+
+	return Power * 4 + Quarter;
+}
+
+
+//! Allocate a buffer of at least Size bytes, updating Size to the number of bytes actually allocated
+UInt8 *mxflib::BufferPool::Allocate(size_t &Size)
+{
+	if((Size < MinSize) || (Size > MaxSize))
+	{
+		MutexLock Locked(Lock);
+		Stats.Allocations++;
+		return new UInt8[Size];
+	}
+
+	unsigned int Class = SizeClass(Size);
+	Size = ClassSize(Class);
+
+	{
+		MutexLock Locked(Lock);
+		Stats.Allocations++;
+
+		std::vector<UInt8*> &List = FreeLists[Class];
+		if(!List.empty())
+		{
+			UInt8 *Ret = List.back();
+			List.pop_back();
+
+			Stats.Hits++;
+			Stats.HeldBytes -= Size;
+			return Ret;
+		}
+	}
+
+	return new UInt8[Size];
+}
+
+
+//! Free a buffer previously allocated with Size bytes
+void mxflib::BufferPool::Free(UInt8 *Buffer, size_t Size)
+{
+	{
+		MutexLock Locked(Lock);
+		Stats.Frees++;
+
+		// Only keep buffers that are exactly a pooled class size, and only while within our limit
+		if((Size >= MinSize) && (Size <= MaxSize) && ((Stats.HeldBytes + Size) <= MaxHeld))
+		{
+			unsigned int Class = SizeClass(Size);
+			if(ClassSize(Class) == Size)
+			{
+				FreeLists[Class].push_back(Buffer);
+
+				Stats.Pooled++;
+				Stats.HeldBytes += Size;
+				return;
+			}
+		}
+	}
+
+	delete[] Buffer;
+}
+
+
+//! Free all buffers currently held for re-use
+void mxflib::BufferPool::Purge(void)
+{
+	MutexLock Locked(Lock);
+
+	std::vector<std::vector<UInt8*> >::iterator it = FreeLists.begin();
+	while(it != FreeLists.end())
+	{
+		std::vector<UInt8*>::iterator Buff_it = (*it).begin();
+		while(Buff_it != (*it).end())
+		{
+			delete[] *Buff_it;
+			Buff_it++;
+		}
+		(*it).clear();
+		it++;
+	}
+
+	Stats.HeldBytes = 0;
+}
+
+
+//! Get a copy of the current counters
+BufferPoolStats mxflib::BufferPool::GetStats(void)
+{
+	MutexLock Locked(Lock);
+	return Stats;
+}
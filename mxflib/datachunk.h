@@ -45,12 +45,101 @@ namespace mxflib
 
 namespace mxflib
 {
+	//! Interface for allocating the buffers used by DataChunk objects
+	/*! DRAGONS: All buffers must be allocated with <b>new UInt8[]</b> as the caller of
+	 *           DataChunk::StealBuffer() will free them with <b>delete[]</b>
+	 */
+	class BufferAllocator
+	{
+	public:
+		virtual ~BufferAllocator() {};
+
+		//! Allocate a buffer of at least Size bytes, updating Size to the number of bytes actually allocated
+		virtual UInt8 *Allocate(size_t &Size) = 0;
+
+		//! Free a buffer previously allocated with Size bytes
+		virtual void Free(UInt8 *Buffer, size_t Size) = 0;
+	};
+
+
+	//! Counters showing how well a BufferPool is performing
+	struct BufferPoolStats
+	{
+		UInt64 Allocations;						//!< Number of buffers requested
+		UInt64 Hits;							//!< Number of requests satisfied by re-using a pooled buffer
+		UInt64 Frees;							//!< Number of buffers freed
+		UInt64 Pooled;							//!< Number of freed buffers kept for re-use
+		size_t HeldBytes;						//!< Total size of the buffers currently held for re-use
+	};
+
+
+	//! A BufferAllocator that keeps freed buffers in free lists by size for re-use
+	/*! Requests from MinSize to MaxSize bytes are rounded up to one of four size classes per power of two
+	 *  (1, 1.25, 1.5 or 1.75 times the power of two) so that buffers of nearly the same size, such as
+	 *  successive frames of essence, share a free list. Other sizes are allocated and freed directly.
+	 *  \note The pool is thread-safe
+	 */
+	class BufferPool : public BufferAllocator
+	{
+	protected:
+		size_t MinSize;							//!< Smallest buffer size that is pooled
+		size_t MaxSize;							//!< Largest buffer size that is pooled
+		size_t MaxHeld;							//!< Maximum total size of buffers held for re-use
+		std::vector<std::vector<UInt8*> > FreeLists;	//!< Free buffers, indexed by size class
+		BufferPoolStats Stats;					//!< Counters
+		Mutex Lock;								//!< Lock for all the above
+
+	public:
+		//! Build a buffer pool
+		/*! \param MaxHeld The maximum total size of all free buffers held for re-use, extra buffers are freed
+		 *  \param MinSize The smallest size to pool, smaller buffers are cheap to allocate anyway
+		 *  \param MaxSize The largest size to pool
+		 */
+		BufferPool(size_t MaxHeld = 256 * 1024 * 1024, size_t MinSize = 1024, size_t MaxSize = 64 * 1024 * 1024);
+
+		//! Free all held buffers
+		virtual ~BufferPool() { Purge(); }
+
+		//! Allocate a buffer of at least Size bytes, updating Size to the number of bytes actually allocated
+		virtual UInt8 *Allocate(size_t &Size);
+
+		//! Free a buffer previously allocated with Size bytes
+		virtual void Free(UInt8 *Buffer, size_t Size);
+
+		//! Free all buffers currently held for re-use
+		void Purge(void);
+
+		//! Get a copy of the current counters
+		BufferPoolStats GetStats(void);
+
+	protected:
+		//! Get the size class for a given size (the smallest class at least this big)
+		static unsigned int SizeClass(size_t Size);
+
+		//! Get the size of buffers in a given class
+		static size_t ClassSize(unsigned int Class) { return (static_cast<size_t>(1) << (Class / 4)) + (Class % 4) * (static_cast<size_t>(1) << (Class / 4)) / 4; }
+	};
+
+
 	class DataChunk : public RefCount<DataChunk>
 	{
 	private:
 		size_t DataSize;						//! Size of the data buffer
 		size_t AllocationGranularity;			//! Granulatiry of new memory allocations
-		bool ExternalBuffer;					//! True if the buffer is not owned by us
+		mutable bool ExternalBuffer;			//! True if the buffer is not owned by us (set when our buffer is handed to a shared owner)
+		mutable DataChunkPtr BufferOwner;		//! Optional owner of an external buffer, held to keep the buffer valid while we use it
+
+		//! Size of the buffer held within the chunk itself for small values
+		enum { InlineSize = 16 };
+
+		//! Smallest slice that shares a buffer rather than copying it, as sharing costs an extra object
+		enum { MinShareSize = 256 };
+
+		//! Buffer held within the chunk itself, used instead of allocating for data of up to InlineSize bytes
+		/*! This holds most small metadata values (integers, rationals, UUIDs and ULs) without a separate allocation.
+		 *  When in use it is flagged as an external buffer, as it must never be freed or have its ownership transferred
+		 */
+		UInt8 InlineBuffer[InlineSize];
 
 	public:
 		size_t Size;							//! Size of the active data in the buffer
@@ -70,16 +159,32 @@ namespace mxflib
 		template<int SIZE> DataChunk(const Identifier<SIZE> *ID)  : DataSize(0), AllocationGranularity(0), ExternalBuffer(false), Size(0), Data(NULL) { Set(ID->Size(), ID->GetValue() ); }
 
 		//! Data chunk copy constructor
+		/*! The data is always copied, use Slice() to share the buffer instead */
 		DataChunk(const DataChunk &Chunk) : DataSize(0), AllocationGranularity(0), ExternalBuffer(false), Size(0), Data(NULL) { Set(Chunk.Size, Chunk.Data); };
 
 		//! Data chunk construct from smart pointer
+		/*! The data is always copied, use Slice() to share the buffer instead */
 		DataChunk(const DataChunkPtr &Chunk) : DataSize(0), AllocationGranularity(0), ExternalBuffer(false), Size(0), Data(NULL) { Set(Chunk->Size, Chunk->Data); };
 
+#ifdef MXFLIB_HAS_MOVE
+		//! Data chunk move constructor, taking over the buffer of Chunk and leaving it empty
+		DataChunk(DataChunk &&Chunk) MXFLIB_NOEXCEPT : DataSize(0), AllocationGranularity(Chunk.AllocationGranularity), ExternalBuffer(false), Size(0), Data(NULL) { MoveFrom(Chunk); };
+#endif // MXFLIB_HAS_MOVE
+
 		~DataChunk() 
 		{ 
-			if((!ExternalBuffer) && (Data)) delete[] Data; 
+			if((!ExternalBuffer) && (Data)) FreeBuffer(Data, DataSize); 
 		};
 
+		//! Set the allocator to use for all DataChunk buffers, or NULL to use new[] and delete[] directly
+		/*! It is safe to change the allocator while buffers are in use as all allocators must allocate with new[].
+		 *  \note The allocator is not owned by DataChunk, and must remain valid while any DataChunk buffers exist
+		 */
+		static void SetAllocator(BufferAllocator *Allocator);
+
+		//! Get the allocator in use for DataChunk buffers, or NULL if none
+		static BufferAllocator *GetAllocator(void);
+
 		//! Resize the data chunk, preserving contents if requested
 		void Resize(size_t NewSize, bool PreserveContents = true);
 
@@ -111,6 +216,9 @@ namespace mxflib
 		//! Set some data into a data chunk (expanding it if required)
 		void Set(size_t MemSize, const UInt8 *Buffer, size_t Start = 0)
 		{
+			// Never write into a buffer shared with an owner, take our own copy first
+			if(BufferOwner) ResizeBuffer(Size > (MemSize + Start) ? Size : (MemSize + Start));
+
 			if(Size < (MemSize + Start)) Resize(MemSize + Start);
 
 			memcpy(&Data[Start], Buffer, MemSize);
@@ -119,6 +227,8 @@ namespace mxflib
 		//! Set all bytes to same value
 		void Set(Uint8 val)
 		{
+			if(BufferOwner) ResizeBuffer(Size);
+
 			memset( Data, val, Size);
 		}
 
@@ -147,6 +257,20 @@ namespace mxflib
 			return *this;
 		}
 
+#ifdef MXFLIB_HAS_MOVE
+		//! Move assignment, taking over the buffer of Right and leaving it empty
+		/*! \note If we are using an external buffer supplied by the caller the data is copied into it, as with normal assignment */
+		DataChunk& operator=(DataChunk &&Right) MXFLIB_NOEXCEPT
+		{
+			if(&Right == this) return *this;
+
+			if(ExternalBuffer && (!BufferOwner) && (!IsInline())) Set(Right.Size, Right.Data);
+			else MoveFrom(Right);
+
+			return *this;
+		}
+#endif // MXFLIB_HAS_MOVE
+
 		bool operator==(const DataChunk &Right) const
 		{
 			if(Size != Right.Size) return false;
@@ -158,6 +282,24 @@ namespace mxflib
 
 		bool operator!=(const DataChunk &Right) const { return !operator==(Right); };
 
+		//! Determine if this chunk references a buffer belonging to another DataChunk
+		bool IsShared(void) const { return BufferOwner ? true : false; }
+
+		//! Make a new chunk holding part of the data in this chunk, sharing our buffer rather than copying it where possible
+		/*! Both this chunk and the slice then treat the buffer as read-only, so Set(), Append() or growing either of them
+		 *  first takes a private copy of the data (copy-on-write) and the other is unaffected. The buffer is freed when
+		 *  the last chunk referencing it lets go. Small slices, and slices of a buffer we don't own, are simply copied.
+		 *  DRAGONS: Writing directly to <tt><b>Data</b></tt> of either chunk bypasses copy-on-write, so call MakeWritable() first
+		 *  \note Several threads may slice the same chunk at once, but not while any of them changes it
+		 */
+		DataChunkPtr Slice(size_t Start, size_t Length) const;
+
+		//! Make sure this chunk has a buffer of its own that may be written directly, copying any shared data if requested
+		void MakeWritable(bool PreserveContents = true) { if(BufferOwner) ResizeBuffer(Size, PreserveContents); }
+
+		//! Determine if this chunk is using the buffer held within itself for small values
+		bool IsInline(void) const { return Data == InlineBuffer; }
+
 		//! Get a (hex) string representation of the data in the buffer
 		std::string GetString(void) const;
 
@@ -165,6 +307,9 @@ namespace mxflib
 		void SetGranularity(size_t Gran) { AllocationGranularity = Gran; };
 		size_t GetGranularity(void) { return AllocationGranularity; };
 
+		//! Get the size of the allocated buffer, which may be more than Size
+		size_t GetBufferSize(void) const { return DataSize; };
+
 		//! Set an external buffer as the data buffer
 		/*! \note If an external buffer has been set for a DataChunk it may not
 		 *		  stay as the buffer in use. This is because there may not be
@@ -174,10 +319,24 @@ namespace mxflib
 		 */
 		void SetBuffer(UInt8 *Buffer, size_t BuffSize, size_t AllocatedSize = 0);
 
+		//! Set part of a buffer belonging to another DataChunk as the data buffer
+		/*! The owning DataChunk is referenced by this chunk until the buffer is released, so the data remains valid
+		 *  even if all other references to the owner are dropped.
+		 *  \note The shared buffer is treated as read-only: Set() or growing the chunk will first take a private copy of the data
+		 *  DRAGONS: Writing directly to <tt><b>Data</b></tt> will modify the owner's buffer
+		 */
+		void SetBuffer(DataChunkPtr Owner, UInt8 *Buffer, size_t BuffSize)
+		{
+			// DRAGONS: Owner is passed by value so that it holds a reference while SetBuffer() releases any previous owner
+			SetBuffer(Buffer, BuffSize);
+			BufferOwner = Owner;
+		}
+
 		//! Transfer ownership of a data buffer from another DataChunk
 		/*! This is a very efficient way to set one DataChunk to the value of another.
 		 *  However it partially destroys the source DataChunk by stealing its buffer.
-		 *  \return true on success, false on failure
+		 *  If the source shares a buffer owned by another chunk, we take over its reference to the owner instead.
+		 *  \return true on success, false on failure (if the source uses an external buffer that it does not own)
 		 */
 		bool TakeBuffer(DataChunk &OldOwner, bool MakeEmpty = false);
 
@@ -187,6 +346,25 @@ namespace mxflib
 		 *  \return true on success, false on failure
 		 */
 		bool TakeBuffer(DataChunkPtr &OldOwner, bool MakeEmpty = false);
+
+	protected:
+#ifdef MXFLIB_HAS_MOVE
+		//! Take over the buffer of another chunk, leaving it empty
+		void MoveFrom(DataChunk &Source);
+#endif // MXFLIB_HAS_MOVE
+
+		//! Set this chunk to part of the data of another, sharing its buffer if possible
+		void ShareFrom(const DataChunk &Source, size_t Start, size_t Length);
+
+		//! Get the chunk that owns our buffer, handing our own buffer to a new owner if required, so that it may be shared
+		/*! \return NULL if the buffer can't be shared */
+		DataChunkPtr GetSharedOwner(void) const;
+
+		//! Allocate a new buffer of at least Size bytes, updating Size to the size allocated
+		static UInt8 *AllocBuffer(size_t &Size);
+
+		//! Free a buffer that we own, of the given allocated size
+		static void FreeBuffer(UInt8 *Buffer, size_t Size);
 	};
 }
 
@@ -303,6 +303,9 @@ void MDOType::DefineInternals(void)
  */
 int mxflib::LoadTypes(TypeRecordList &TypesData, SymbolSpacePtr DefaultSymbolSpace /*=MXFLibSymbols*/)
 {
+	// If a dictionary snapshot is being made, record these definitions in it (it then loads them for us)
+	if(DictionarySnapshot::IsRecording()) return DictionarySnapshot::RecordTypes(TypesData, DefaultSymbolSpace);
+
 	//! Check if we have required internal items defined
 	if(!MDOType::GetInternalsDefined()) MDOType::DefineInternals();
 
@@ -331,6 +334,13 @@ int mxflib::LoadTypes(TypeRecordList &TypesData, SymbolSpacePtr DefaultSymbolSpa
 		MDTypePtr Ptr = MDType::Find((*it)->UL);
 		bool Extending = Ptr ? true : false;
 
+		// Once the dictionary is frozen its types are never changed, so a new definition of one leaves it as it is
+		if(Extending && MDType::IsFrozenType(Ptr))
+		{
+			it++;
+			continue;
+		}
+
 		if(Extending && (!(*it)->Type.empty()) && ((*it)->Type != Ptr->Name()))
 		{
 			warning("%s is assigned to type %s - the dictionary entry named %s has the same identifier so simply updates parts of the definition\n",
@@ -647,7 +657,12 @@ int mxflib::LoadTypes(TypeRecordList &TypesData, SymbolSpacePtr DefaultSymbolSpa
 					delete[] MaskString;
 				}
 
-				if(!Label::Insert((*it)->Type, (*it)->Detail, (*it)->UL, Mask))
+				// DRAGONS: Labels are only used to give names to values, so once frozen any new ones are simply not named
+				if(MDOType::IsFrozen())
+				{
+					debug("Label %s is not added as the dictionary is frozen\n", (*it)->Type.c_str());
+				}
+				else if(!Label::Insert((*it)->Type, (*it)->Detail, (*it)->UL, Mask))
 				{
 					warning("Failed to add label %s - this probably means that it matches an existing label definition", (*it)->Type.c_str());
 				}
@@ -724,6 +739,9 @@ namespace
  */
 int mxflib::LoadClasses(ClassRecordList &ClassesData, SymbolSpacePtr DefaultSymbolSpace /*=MXFLibSymbols*/)
 {
+	// If a dictionary snapshot is being made, record these definitions in it (it then loads them for us)
+	if(DictionarySnapshot::IsRecording()) return DictionarySnapshot::RecordClasses(ClassesData, DefaultSymbolSpace);
+
 	//! List to hold any entries that are not resolved during this pass (we will recurse to resolve them at the end of the pass)
 	ClassRecordList Unresolved;
 
@@ -979,6 +997,285 @@ int mxflib::LoadDictionary(const ConstDictionaryRecord *DictionaryData, SymbolSp
 	return Ret;
 }
 
+namespace
+{
+	//! A top-level class definition from a compiled-in dictionary that is built when first used
+	struct OnDemandClass
+	{
+		ConstClassRecordPTR Record;				//!< The first entry of the definition
+		SymbolSpacePtr SymSpace;				//!< The default symbol space in force for this definition
+		bool Loaded;							//!< True once this definition has been built
+	};
+
+	//! An index of on-demand definitions, sorted by key, holding the number of the definition containing each key
+	template<class KeyType> struct OnDemandIndex : public std::vector<std::pair<KeyType, size_t> > {};
+
+	std::vector<OnDemandClass> OnDemandClasses;	//!< All on-demand definitions, in dictionary order
+	OnDemandIndex<std::string> OnDemandULs;		//!< Index of the definitions by the version-less ULs (as 16-byte strings) of all their entries
+	OnDemandIndex<std::string> OnDemandNames;	//!< Index of the definitions by the names of all their entries
+	OnDemandIndex<Tag> OnDemandTags;			//!< Index of the definitions by the static tags of all their entries
+	size_t OnDemandRemaining = 0;				//!< The number of definitions not yet built, so lookups are free once all are built
+	int OnDemandDepth = 0;						//!< Nesting depth of definitions being built, so reference types are only located once at the end
+
+	//! Make the key used to index a UL in OnDemandULs
+	/*! The version byte of SMPTE ULs is set to 1 so that lookups match in the same way as MDOType::Find() */
+	std::string OnDemandULKey(const UInt8 *ULData)
+	{
+		std::string Ret(reinterpret_cast<const char *>(ULData), 16);
+
+		if((ULData[0] == 0x06) && (ULData[1] == 0x0e) && (ULData[2] == 0x2b) && (ULData[3] == 0x34)) Ret[7] = 1;
+
+		return Ret;
+	}
+
+	//! Add an entry, and all of its children, to the on-demand indexes
+	/*! DRAGONS: Record is changed by this function - at return it points to the next peer entry, as with LoadClassesSub()
+	 *  \param Index	If false the entries are skipped without being indexed
+	 */
+	void IndexOnDemandRecord(ConstClassRecordPTR &Record, size_t Number, bool Index = true)
+	{
+		if(Index)
+		{
+			UInt8 ULBuffer[16];
+			if(Record->UL && (ReadHexStringOrUL(Record->UL, 16, ULBuffer, " \t.") == 16))
+			{
+				OnDemandULs.push_back(std::pair<std::string, size_t>(OnDemandULKey(ULBuffer), Number));
+			}
+
+			if(Record->Name && *Record->Name) OnDemandNames.push_back(std::pair<std::string, size_t>(Record->Name, Number));
+
+			if(Record->Tag) OnDemandTags.push_back(std::pair<Tag, size_t>(Record->Tag, Number));
+		}
+
+		if((Record->Class == ClassSet) || (Record->Class == ClassPack) 
+			|| (Record->Class == ClassVector) || (Record->Class == ClassArray) 
+			|| (Record->Class == ClassExtend))
+		{
+			Record++;
+			while(Record->Class != ClassNULL) IndexOnDemandRecord(Record, Number, Index);
+		}
+
+		Record++;
+	}
+
+	//! Compare index entries by key only, so that entries with equal keys keep their dictionary order
+	template<class KeyType> bool OnDemandKeyLess(const std::pair<KeyType, size_t> &Left, const std::pair<KeyType, size_t> &Right)
+	{
+		return Left.first < Right.first;
+	}
+
+	//! Build an on-demand definition, unless it is already built
+	/*! \return true if the definition was built by this call */
+	bool LoadOnDemandEntry(size_t Number)
+	{
+		OnDemandClass &Entry = OnDemandClasses[Number];
+		if(Entry.Loaded) return false;
+
+		// Mark as built first, as building this definition may look up its own keys (or those of classes that reference it)
+		Entry.Loaded = true;
+		OnDemandRemaining--;
+
+		ConstClassRecordPTR Record = Entry.Record;
+		ClassRecordList Classes;
+		ClassRecordPtr ThisClass = LoadClassesSub(Record, Entry.SymSpace);
+		if(!ThisClass) return false;
+		Classes.push_back(ThisClass);
+
+		// DRAGONS: Any base classes or reference targets used by this definition are built by nested lookups during this call
+		OnDemandDepth++;
+		LoadClasses(Classes, Entry.SymSpace);
+		OnDemandDepth--;
+
+		// Locate the reference targets once the outermost definition is complete, with further nested builds counted as inner ones
+		if(OnDemandDepth == 0)
+		{
+			OnDemandDepth++;
+			MDOType::LocateRefTypes();
+			OnDemandDepth--;
+		}
+
+		return true;
+	}
+
+	//! Build all on-demand definitions containing a given key
+	/*! Definitions are built in dictionary order so that, if a key appears in more than one, the result matches a full load */
+	template<class KeyType> bool LoadOnDemandKey(OnDemandIndex<KeyType> &Index, const KeyType &Key)
+	{
+		std::pair<KeyType, size_t> Wanted(Key, 0);
+		typename OnDemandIndex<KeyType>::iterator First = std::lower_bound(Index.begin(), Index.end(), Wanted, OnDemandKeyLess<KeyType>);
+		typename OnDemandIndex<KeyType>::iterator Last = std::upper_bound(First, Index.end(), Wanted, OnDemandKeyLess<KeyType>);
+
+		// Copy the definition numbers first as building a definition may add others (if a snapshot of the dictionary is made)
+		std::vector<size_t> Numbers;
+		while(First != Last) Numbers.push_back((*First++).second);
+		std::sort(Numbers.begin(), Numbers.end());
+
+		bool Ret = false;
+		std::vector<size_t>::iterator it = Numbers.begin();
+		while(it != Numbers.end())
+		{
+			if(LoadOnDemandEntry(*it)) Ret = true;
+			it++;
+		}
+
+		return Ret;
+	}
+}
+
+
+//! Load dictionary from the specified in-memory definitions, building each class only when it is first used
+/*! \note There must be a terminating entry (with Type == DictionaryNULL) to end the list
+ *  \return 0 if all OK
+ *  \return -1 on error
+ */
+int mxflib::LoadDictionaryOnDemand(const ConstDictionaryRecord *DictionaryData, SymbolSpacePtr DefaultSymbolSpace /*=MXFLibSymbols*/)
+{
+	// A snapshot must hold the whole dictionary, so load it all now
+	if(DictionarySnapshot::IsRecording()) return LoadDictionary(DictionaryData, DefaultSymbolSpace);
+
+	int Ret = 0;
+
+	// Definitions that must be built now, such as extensions to existing classes
+	std::vector<size_t> Immediate;
+
+	while(DictionaryData->Type != DictionaryNULL)
+	{
+		if(DictionaryData->Type == DictionaryTypes)
+		{
+			if(LoadTypes((const ConstTypeRecord *)DictionaryData->Dict) != 0) Ret = -1;
+		}
+		else
+		{
+			SymbolSpacePtr SymSpace = DefaultSymbolSpace;
+			ConstClassRecordPTR ClassData = (const ConstClassRecord *)DictionaryData->Dict;
+
+			while(ClassData->Class != ClassNULL)
+			{
+				if(ClassData->Class == ClassSymbolSpace)
+				{
+					// A default symbol space has been specified - look it up, or create it
+					SymSpace = SymbolSpace::FindSymbolSpace(ClassData->SymSpace);
+					if(!SymSpace) SymSpace = new SymbolSpace(ClassData->SymSpace);
+
+					ClassData++;
+					continue;
+				}
+
+				OnDemandClass Entry;
+				Entry.Record = ClassData;
+				Entry.SymSpace = SymSpace;
+				Entry.Loaded = false;
+
+				size_t Number = OnDemandClasses.size();
+				bool Extend = (ClassData->Class == ClassExtend);
+				if(Extend) Immediate.push_back(Number);
+
+				OnDemandClasses.push_back(Entry);
+				OnDemandRemaining++;
+
+				// DRAGONS: Extensions are not indexed, else building a class would apply its extensions before it was itself defined
+				// DRAGONS: ClassData is changed by IndexOnDemandRecord
+				IndexOnDemandRecord(ClassData, Number, !Extend);
+			}
+		}
+
+		DictionaryData++;
+	}
+
+	// Sort the indexes, keeping the dictionary order of any duplicate keys
+	std::stable_sort(OnDemandULs.begin(), OnDemandULs.end(), OnDemandKeyLess<std::string>);
+	std::stable_sort(OnDemandNames.begin(), OnDemandNames.end(), OnDemandKeyLess<std::string>);
+	std::stable_sort(OnDemandTags.begin(), OnDemandTags.end(), OnDemandKeyLess<Tag>);
+
+	// Extensions modify classes that may already be in use, so they are applied now
+	std::vector<size_t>::iterator it = Immediate.begin();
+	while(it != Immediate.end()) LoadOnDemandEntry(*it++);
+
+	// Locate reference target types for any new types
+	MDOType::LocateRefTypes();
+
+	return Ret;
+}
+
+
+//! Build any on-demand class definitions with a given UL, or containing a child with that UL
+bool mxflib::LoadOnDemandClass(const UL &ClassUL)
+{
+	if(!OnDemandRemaining) return false;
+
+	return LoadOnDemandKey(OnDemandULs, OnDemandULKey(ClassUL.GetValue()));
+}
+
+
+//! Build any on-demand class definitions with a given name, or containing a child with that name
+bool mxflib::LoadOnDemandClass(std::string Name)
+{
+	if(!OnDemandRemaining) return false;
+
+	// Strip any symbol space and parent path from the name
+	std::string::size_type Pos = Name.rfind("::");
+	if(Pos != std::string::npos) Name = Name.substr(Pos + 2);
+	Pos = Name.rfind('/');
+	if(Pos != std::string::npos) Name = Name.substr(Pos + 1);
+
+	return LoadOnDemandKey(OnDemandNames, Name);
+}
+
+
+//! Build any on-demand class definitions containing a child with a given static tag
+bool mxflib::LoadOnDemandClass(Tag ClassTag)
+{
+	if(!OnDemandRemaining) return false;
+
+	return LoadOnDemandKey(OnDemandTags, ClassTag);
+}
+
+
+//! Build all on-demand class definitions not yet built
+void mxflib::LoadAllOnDemandClasses(void)
+{
+	if(!OnDemandRemaining) return;
+
+	OnDemandDepth++;
+	for(size_t i = 0; i < OnDemandClasses.size(); i++) LoadOnDemandEntry(i);
+	OnDemandDepth--;
+
+	MDOType::LocateRefTypes();
+}
+
+
+//! Complete the loaded dictionary and make it read-only, so that it may be used by several threads without locking
+void mxflib::FreezeDictionary(void)
+{
+	if(MDOType::IsFrozen()) return;
+
+	if(!MDOType::GetInternalsDefined()) MDOType::DefineInternals();
+
+	// Build everything that would otherwise be built on first use, changing the registry from inside a lookup
+	LoadAllOnDemandClasses();
+	MDOType::GetStaticPrimer();
+
+	MDOType::Freeze();
+}
+
+
+//! Determine if the dictionary has been frozen
+bool mxflib::IsDictionaryFrozen(void)
+{
+	return MDOType::IsFrozen();
+}
+
+
+//! Discard any on-demand class definitions not yet built, used when the dictionary is cleared
+void mxflib::ClearOnDemandClasses(void)
+{
+	OnDemandClasses.clear();
+	OnDemandULs.clear();
+	OnDemandNames.clear();
+	OnDemandTags.clear();
+	OnDemandRemaining = 0;
+}
+
 
 
 //! Load dictionary from the specified XML definitions
@@ -987,6 +1284,10 @@ int mxflib::LoadDictionary(const ConstDictionaryRecord *DictionaryData, SymbolSp
  */
 int mxflib::LoadDictionary(const char *DictFile, SymbolSpacePtr DefaultSymbolSpace, std::string Application, bool FastFail /*=false*/)
 {
+	// Use a binary snapshot of the dictionary if there is an up-to-date one
+	int Result;
+	if(LoadDictionarySnapshot(DictFile, DefaultSymbolSpace, Application, FastFail, Result)) return Result;
+
 	RXIDataPtr Dict = ParseRXIFile(DictFile, DefaultSymbolSpace, Application);
 	if(!Dict) return -1;
 
@@ -1029,6 +1029,53 @@ namespace mxflib
 		return LoadDictionary(DictionaryData, DefaultSymbolSpace, FastFail);
 	}
 
+	//! Load dictionary from the specified in-memory definitions, building each class only when it is first used
+	/*! The types are loaded as normal, as almost every class needs them. The class definitions are indexed by the ULs,
+	 *  names and tags of the classes and all of their children, and each top-level definition is built the first time
+	 *  MDOType::Find() looks up one of its keys, along with any base classes and reference targets it needs. A tool
+	 *  that only reads a few sets therefore builds only a small part of a large compiled-in dictionary.
+	 *  \note There must be a terminating entry (with Type == DictionaryNULL) to end the list
+	 *  \note Class extensions are applied immediately, which builds the classes they extend
+	 *  \note If a dictionary snapshot is being recorded everything is loaded at once, as by LoadDictionary()
+	 *  \note Building a class changes the registry without locking, so call FreezeDictionary() (or LoadAllOnDemandClasses())
+	 *        before looking up types on more than one thread
+	 *  \return 0 if all OK
+	 *  \return -1 on error
+	 */
+	int LoadDictionaryOnDemand(const ConstDictionaryRecord *DictionaryData, SymbolSpacePtr DefaultSymbolSpace = MXFLibSymbols);
+
+	//! Build any on-demand class definitions with a given UL, or containing a child with that UL
+	/*! \return true if any definitions were built, so a failed lookup is worth trying again */
+	bool LoadOnDemandClass(const UL &ClassUL);
+
+	//! Build any on-demand class definitions with a given name, or containing a child with that name
+	/*! Any symbol space or parent path in the name is ignored
+	 *  \return true if any definitions were built, so a failed lookup is worth trying again
+	 */
+	bool LoadOnDemandClass(std::string Name);
+
+	//! Build any on-demand class definitions containing a child with a given static tag
+	/*! \return true if any definitions were built, so a failed lookup is worth trying again */
+	bool LoadOnDemandClass(Tag ClassTag);
+
+	//! Build all on-demand class definitions not yet built
+	/*! This is required before anything that must see every class, such as listing the whole dictionary */
+	void LoadAllOnDemandClasses(void);
+
+	//! Discard any on-demand class definitions not yet built, used when the dictionary is cleared
+	void ClearOnDemandClasses(void);
+
+	//! Complete the loaded dictionary and make it read-only, so that it may be used by several threads without locking
+	/*! Any classes built on demand are built now, along with the internal types and the static primer. After this
+	 *  the registry of classes, types and symbol spaces is never changed, and anything defined later goes into the
+	 *  TypeOverlay active on the defining thread (such as one given to an MXFFile for its metadictionary).
+	 *  \note MDOType::ClearDict() removes the freeze along with the dictionary
+	 */
+	void FreezeDictionary(void);
+
+	//! Determine if the dictionary has been frozen
+	bool IsDictionaryFrozen(void);
+
 	//! Load dictionary from the specified XML definitions with a default symbol space
 	/*! \return 0 if all OK
 	 *  \return -1 on error
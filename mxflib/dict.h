@@ -895,3 +895,694 @@
 		MXFLIB_DICTIONARY_CLASSES(DictData_Classes_9)
 		MXFLIB_DICTIONARY_CLASSES(DictData_Classes_10)
 	MXFLIB_DICTIONARY_END
+
+	// Static perfect-hash index of the items in this dictionary that have ULs
+	const DictIndexEntry DictData_IndexEntries[] = {
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x0d, 0x00, 0x00, 0x00 }, "PeakEnvelopeTimestamp", "WaveAudioDescriptor", 0x3d30, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x08, 0x00, 0x00 }, "TypeDefinitionFixedArray", NULL, 0x0000, DictIndexSet, 0, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x14, 0x01, 0x00, 0x00 }, "MetaDefinitionDescription", "MetaDefinition", 0x0007, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x06, 0x00, 0x00, 0x00 }, "MemberNames", "TypeDefinitionRecord", 0x001d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x02, 0x01, 0x00, 0x00 }, "CompanyName", "Identification", 0x3c01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x03, 0x02, 0x01, 0x00 }, "MXFOP3b", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x01, 0x03, 0x00, 0x00, 0x00 }, "SMPTE309MTimecodeTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x03, 0x00, 0x00 }, "MXFGCD11", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x03, 0x01, 0x02, 0x01, 0x0a, 0x00, 0x00, 0x00 }, "ReversedByteOrder", "CDCIEssenceDescriptor", 0x330b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x09, 0x00, 0x00, 0x00 }, "ReferencedType", "TypeDefinitionStrongObjectReference", 0x0011, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x43, 0x00 }, "GenericDataEssenceDescriptor", NULL, 0x0000, DictIndexSet, 6, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x03, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00 }, "WeakReferenceSetParameterDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x03, 0x00, 0x00, 0x00 }, "FixedChannelStatusData", "AES3PCMDescriptor", 0x3d11, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x07, 0x0d, 0x01, 0x04, 0x01, 0x02, 0x00, 0x00, 0x00 }, "DMSCrypto", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x05, 0x01, 0x00, 0x00 }, "VersionString", "Identification", 0x3c04, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x01, 0x00, 0x00, 0x00 }, "AuxBitsMode", "AES3PCMDescriptor", 0x3d08, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "WeakReferenceArrayTypeDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x14, 0x00 }, "TimecodeComponent", NULL, 0x0000, DictIndexSet, 16, 8 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x10, 0x02, 0x04, 0x00, 0x00 }, "LastModifiedDate", "Preface", 0x3b02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetInterpolationDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceCodecDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x02, 0x01, 0x01, 0x25, 0x00, 0x00, 0x00, 0x00 }, "ChannelStatusModeType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x15, 0x10, 0x00, 0x00, 0x00, 0x00 }, "PackageUID", "GenericPackage", 0x4401, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x20, 0x02, 0x00, 0x00, 0x00, 0x00 }, "LengthType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x06, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "PartitionMetadata", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00 }, "Seconds", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceContainerDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x02, 0x01, 0x01, 0x0e, 0x00, 0x00, 0x00, 0x00 }, "RGBACode", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x04, 0x04, 0x01, 0x00, 0x00, 0x00 }, "ScanningDirection", "RGBAEssenceDescriptor", 0x3405, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x07, 0x00, 0x00, 0x00 }, "PeakEnvelopeFormat", "WaveAudioDescriptor", 0x3d2a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00 }, "Month", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x13, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferencePackage", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorTrack", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x03, 0x02 }, "DMS1SceneExtended", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceEssenceData", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x0f, 0x00, 0x00, 0x00 }, "ApplicationEnvironmentID", "ApplicationPluginObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x0b, 0x00, 0x00, 0x00 }, "DisplayHeight", "GenericPictureEssenceDescriptor", 0x3208, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x07, 0x0d, 0x01, 0x04, 0x01, 0x02, 0x01, 0x01, 0x00 }, "CryptographicFrameworkLabel", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x02, 0x09, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00 }, "CipherAlgorithm", "CryptographicContext", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x07, 0x00, 0x00, 0x00 }, "ClassDefinitions", "MetaDictionary", 0x0003, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x11, 0x01, 0x00 }, "RandomIndexMetadata", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x03, 0x01, 0x04, 0x00, 0x00, 0x00 }, "FrameLayout", "GenericPictureEssenceDescriptor", 0x320c, DictIndexItem, 0, 0 },
+		{ { 0x80, 0x62, 0xc1, 0x08, 0xa8, 0x0d, 0xeb, 0xfe, 0x3a, 0x9d, 0xc8, 0xe1, 0x7e, 0x83, 0xb6, 0x4b }, "PartitionArray", "RandomIndexMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceLocator", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x06, 0x01, 0x01, 0x03, 0x08, 0x00, 0x00, 0x00 }, "MonoSourceTrackIDs", "SourceReference", 0x1104, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x02, 0x00, 0x00 }, "PropertyDefinition", NULL, 0x0000, DictIndexSet, 24, 8 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Hours", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0b, 0x00, 0x00, 0x00 }, "ElementType", "TypeDefinitionEnumeration", 0x0014, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x05, 0x00, 0x00, 0x00 }, "HorizontalSubsampling", "CDCIEssenceDescriptor", 0x3302, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x06, 0x00, 0x00, 0x00 }, "XTsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x21, 0x00, 0x00, 0x00 }, "ElementOf", "ExtendibleEnumerationElement", 0x002a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x20, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Position", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x22, 0x00, 0x00 }, "TypeDefinitionOpaque", NULL, 0x0000, DictIndexSet, 32, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetPropertyDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x05, 0x00, 0x00, 0x00 }, "FixedUserData", "AES3PCMDescriptor", 0x3d13, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00 }, "DM_Framework", NULL, 0x0000, DictIndexSet, 36, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0c, 0x00, 0x00, 0x00 }, "FixedArrayElementType", "TypeDefinitionFixedArray", 0x0017, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x04, 0x02, 0x00 }, "Footer", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "MXFEC", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x01, 0x01, 0x01, 0x00, 0x00 }, "AudioSamplingRate", "GenericSoundEssenceDescriptor", 0x3d03, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x1c, 0x00, 0x00, 0x00 }, "SymbolSpaceURI", "ExtensionScheme", 0x0025, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1b, 0x00 }, "DataDefinition", NULL, 0x0000, DictIndexSet, 39, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x05, 0x01, 0x00, 0x00 }, "Packages", "ContentStorage", 0x1901, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x1b, 0x00, 0x00, 0x00 }, "ExtensionSchemeID", "ExtensionScheme", 0x0024, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x10, 0x00 }, "SourceReference", NULL, 0x0000, DictIndexSet, 45, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x04, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00 }, "TrackNumber", "GenericTrack", 0x4804, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x5b, 0x00 }, "VBIDataDescriptor", NULL, 0x0000, DictIndexSet, 54, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetKLVDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x01, 0x02, 0x02, 0x10, 0x02, 0x03, 0x00, 0x00 }, "ApplicationSchemesBatch", "Preface", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UTF16", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x01, 0x07, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00 }, "TrackIDs", "DMSegment", 0x6102, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x01, 0x04, 0x00, 0x00, 0x00 }, "ObjectModelVersion", "Preface", 0x3b07, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x09, 0x02, 0x01, 0x03, 0x00, 0x00, 0x00 }, "PlaintextOffset", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x07, 0x02, 0x01, 0x03, 0x01, 0x0e, 0x00, 0x00 }, "PackageMarkInPosition", "PackageMarkerObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x31, 0x00 }, "Locator", NULL, 0x0000, DictIndexSet, 64, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int8", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x02, 0x01, 0x00, 0x00, 0x00 }, "PictureEssenceTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x0b, 0x00, 0x00 }, "MXFGCEncrypted", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x05, 0x30, 0x04, 0x06, 0x00, 0x00, 0x00, 0x00 }, "IndexEditRate", "IndexTableSegment", 0x3f0b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x21, 0x00, 0x00 }, "TypeDefinitionIndirect", NULL, 0x0000, DictIndexSet, 67, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x02, 0x09, 0x03, 0x01, 0x02, 0x00, 0x00, 0x00 }, "CryptographicKeyID", "CryptographicContext", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt8", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x0c, 0x00, 0x00, 0x00 }, "PeakOfPeaksPosition", "WaveAudioDescriptor", 0x3d2f, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetTaggedValueDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceComponent", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00 }, "PictureEssenceCoding", "GenericPictureEssenceDescriptor", 0x3201, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceIdentification", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00 }, "ChannelStatusMode", "AES3PCMDescriptor", 0x3d10, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, "WeakRef", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x61, 0x00 }, "ApplicationPluginObject", NULL, 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x0a, 0x00, 0x00 }, "TypeDefinitionSet", NULL, 0x0000, DictIndexSet, 71, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x09, 0x00 }, "Filler", NULL, 0x0000, DictIndexSet, 76, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x02, 0x04, 0x00, 0x00 }, "TrackSegment", "GenericTrack", 0x4803, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x01, 0x01, 0x15, 0x11, 0x00, 0x00, 0x00, 0x00 }, "ContextID", "CryptographicContext", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x03, 0x00, 0x00 }, "TypeDefinition", NULL, 0x0000, DictIndexSet, 81, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x04, 0x00, 0x00 }, "MXFGCMPEGES", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0f, 0x00, 0x00, 0x00 }, "StringElementType", "TypeDefinitionString", 0x001b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x03, 0x05, 0x00, 0x00, 0x00 }, "AvgBps", "WaveAudioDescriptor", 0x3d09, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x06, 0x01, 0x00, 0x00, 0x00 }, "LinkedPackageUID", "EssenceContainerData", 0x2701, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x06, 0x09, 0x03, 0x00, 0x00, 0x00, 0x00 }, "ChunkLength", "UnknownChunk", 0x4f02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x25, 0x00 }, "FileDescriptor", NULL, 0x0000, DictIndexSet, 85, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x03, 0x02, 0x00 }, "ClosedBodyPartition", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x06, 0x00, 0x00, 0x00 }, "ColorSiting", "CDCIEssenceDescriptor", 0x3303, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x04, 0x00, 0x00 }, "TypeDefinitionInteger", NULL, 0x0000, DictIndexSet, 94, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x5a, 0x00 }, "JPEG2000PictureSubDescriptor", NULL, 0x0000, DictIndexSet, 100, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x1d, 0x00, 0x00, 0x00 }, "PreferredPrefix", "ExtensionScheme", 0x0026, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x07, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00 }, "TrackID", "GenericTrack", 0x4801, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongRef", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt32", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x06, 0x00, 0x00, 0x00 }, "PixelLayout", "RGBAEssenceDescriptor", 0x3401, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x08, 0x00, 0x00 }, "MaxGOP", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x0c, 0x00, 0x00 }, "MXFGCJP2K", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x01, 0x02, 0x00, 0x00, 0x00 }, "SMPTE12MTimecodeActiveUserBitsTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x09, 0x00, 0x00 }, "TypeDefinitionVariableArray", NULL, 0x0000, DictIndexSet, 103, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x0a, 0x00, 0x00 }, "MXFGCALaw", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetClassDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x03, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "AUL", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x07, 0x06, 0x01, 0x01, 0x03, 0x07, 0x00, 0x00, 0x00 }, "ChannelIDs", "SourceReference", 0x1103, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x02, 0x03, 0x01, 0x04, 0x00, 0x00, 0x00 }, "Locked", "GenericSoundEssenceDescriptor", 0x3d02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x06, 0x01, 0x01, 0x07, 0x7f, 0x01, 0x00, 0x00 }, "RootExtensions", "Root", 0x0023, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x05, 0x03, 0x0c, 0x00, 0x00, 0x00 }, "ComponentMinRef", "RGBAEssenceDescriptor", 0x3407, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x0c, 0x00, 0x00, 0x00 }, "CodingStyleDefault", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x13, 0x00, 0x00, 0x00 }, "MetaDefinitionIdentification", "MetaDefinition", 0x0005, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0a, 0x00, 0x00, 0x00 }, "WeakReferencedType", "TypeDefinitionWeakObjectReference", 0x0012, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceParameterDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x20, 0x00, 0x00, 0x00 }, "OriginalProperty", "PropertyWrapperDefinition", 0x0029, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x02, 0x01, 0x00 }, "OpenHeader", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x07, 0x00, 0x00 }, "MXFGCMPEGPES", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x02, 0x02, 0x10, 0x02, 0x02, 0x00, 0x00 }, "DMSchemes", "Preface", 0x3b0b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x02, 0x02, 0x01, 0x00 }, "MXFOP2b", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x02, 0x01, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00 }, "LayoutType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x03, 0x00, 0x00, 0x00 }, "IsConcrete", "ClassDefinition", 0x000a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x02, 0x09, 0x03, 0x02, 0x01, 0x00, 0x00, 0x00 }, "MICAlgorithm", "CryptographicContext", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x08, 0x00, 0x00, 0x00 }, "TypeDefinitions", "MetaDictionary", 0x0004, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x05, 0x03, 0x00, 0x00, 0x00, 0x00 }, "Day", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x03, 0x00, 0x00, 0x00 }, "Root", NULL, 0x0000, DictIndexSet, 108, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt64", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x06, 0x05, 0x00, 0x00 }, "Tracks", "GenericPackage", 0x4403, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt32Array", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x32, 0x00 }, "NetworkLocator", NULL, 0x0000, DictIndexSet, 112, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x4f, 0x00 }, "UnknownChunk", NULL, 0x0000, DictIndexSet, 116, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x01, 0x01, 0x04, 0x00, 0x00, 0x00 }, "ChannelCount", "GenericSoundEssenceDescriptor", 0x3d07, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x06, 0x01, 0x01, 0x04, 0x02, 0x0c, 0x00, 0x00 }, "DMFramework", "DMSegment", 0x6101, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00 }, "MetaReferenceTypeDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x01, 0x01, 0x04, 0x06, 0x0b, 0x00, 0x00 }, "FileDescriptors", "MultipleDescriptor", 0x3f01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x0b, 0x00, 0x00 }, "TypeDefinitionString", NULL, 0x0000, DictIndexSet, 122, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x47, 0x00 }, "AES3PCMDescriptor", NULL, 0x0000, DictIndexSet, 127, 37 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x60, 0x00 }, "PackageMarkerObject", NULL, 0x0000, DictIndexSet, 164, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x11, 0x00, 0x00 }, "RandomIndexMetadataV10", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetPluginDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorIdentification", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x02, 0x02, 0x00 }, "ClosedHeader", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "RGBALayout", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x01, 0x00, 0x00, 0x00 }, "ParentClass", "ClassDefinition", 0x0008, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x10, 0x01, 0x03, 0x00, 0x00 }, "PackageCreationDate", "GenericPackage", 0x4405, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "PackageID", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x0d, 0x00, 0x00, 0x00 }, "DisplayXOffset", "GenericPictureEssenceDescriptor", 0x320a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "ComponentDataDefinition", "StructuralComponent", 0x0201, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x04, 0x01, 0x01, 0x05, 0x00, 0x00, 0x00 }, "DropFrame", "TimecodeComponent", 0x1503, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x44, 0x00 }, "MultipleDescriptor", NULL, 0x0000, DictIndexSet, 167, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x03, 0x01, 0x05, 0x00, 0x00 }, "StartTimecode", "TimecodeComponent", 0x1501, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x07, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x0b, 0x01, 0x00 }, "EncryptedContainerLabel", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x10, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Opaque", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x02, 0x01, 0x00, 0x00, 0x00 }, "BlockAlign", "WaveAudioDescriptor", 0x3d0a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x04, 0x00, 0x00 }, "CodedContentType", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorSegment", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x01, 0x01 }, "DMS1Production", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x03, 0x01, 0x01, 0x00 }, "MXFOP3a", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x03, 0x02, 0x09, 0x00, 0x00, 0x00 }, "ActiveFormatDescriptor", "GenericPictureEssenceDescriptor", 0x3218, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x0a, 0x00, 0x00, 0x00 }, "PeakChannels", "WaveAudioDescriptor", 0x3d2d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x11, 0x00, 0x00, 0x00 }, "MemberTypes", "TypeDefinitionRecord", 0x001c, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x20, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UTF7String", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x03, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x7f, 0x01, 0x00 }, "GenericEssenceContainerMultipleWrappings", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DataValue", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x04, 0x00, 0x00, 0x00 }, "ProductVersion", "Identification", 0x3c03, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x06, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00 }, "ContainerDuration", "FileDescriptor", 0x3002, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Numerator", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x05, 0x03, 0x0e, 0x00, 0x00, 0x00 }, "AlphaMinRef", "RGBAEssenceDescriptor", 0x3409, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x01, 0x05, 0x00, 0x00, 0x00 }, "Version", "Preface", 0x3b05, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x01, 0x00, 0x00, 0x00 }, "Size", "TypeDefinitionInteger", 0x000f, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x06, 0x00 }, "Event", NULL, 0x0000, DictIndexSet, 177, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x10, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "ISO7String", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x02, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00 }, "SoundEssenceCompression", "GenericSoundEssenceDescriptor", 0x3d06, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x00, 0x00, 0x00 }, "DMS1", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x02, 0x00, 0x00, 0x00 }, "Xsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x06, 0x02, 0x00, 0x00, 0x00, 0x00 }, "Minutes", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x01, 0x01, 0x00, 0x00 }, "ObjectClass", "InterchangeObject", 0x0101, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x05, 0x07, 0x00, 0x00 }, "CodecDefinitions", "Dictionary", 0x2607, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x06, 0x03, 0x00, 0x00, 0x00 }, "ContextIDLink", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x0b, 0x00, 0x00, 0x00 }, "PictureComponentSizing", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x28, 0x00 }, "CDCIEssenceDescriptor", NULL, 0x0000, DictIndexSet, 184, 45 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceParameter", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorSubDescriptor", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x10, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Indirect", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSourceReference", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x11, 0x00, 0x00, 0x00 }, "LinkedDescriptiveObjectPluginID", "DM_Set", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x06, 0x00, 0x00, 0x00 }, "IsUniqueIdentifier", "PropertyDefinition", 0x000e, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x06, 0x09, 0x02, 0x00, 0x00, 0x00, 0x00 }, "IndexByteCount", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x34, 0x00 }, "GenericPackage", NULL, 0x0000, DictIndexSet, 229, 8 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceKLVDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x25, 0x00, 0x00 }, "MetaDictionary", NULL, 0x0000, DictIndexSet, 237, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x04, 0x06, 0x10, 0x02, 0x00, 0x00, 0x00, 0x00 }, "SourceLength", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x18, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00 }, "ImageStartOffset", "GenericPictureEssenceDescriptor", 0x3213, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x03, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00 }, "DataEssenceCoding", "GenericDataEssenceDescriptor", 0x3e01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetPackage", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x02, 0x03, 0x00 }, "OpenCompleteHeader", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x38, 0x00 }, "GenericTrack", NULL, 0x0000, DictIndexSet, 240, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x09, 0x00, 0x00, 0x00 }, "YTOsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x18, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00 }, "ImageEndOffset", "GenericPictureEssenceDescriptor", 0x3214, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x06, 0x02, 0x00, 0x00, 0x00 }, "TrackFileID", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00 }, "ElementNames", "TypeDefinitionEnumeration", 0x0015, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "AUID", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x05, 0x01, 0x13, 0x00, 0x00, 0x00, 0x00 }, "SignalStandard", "GenericPictureEssenceDescriptor", 0x3215, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x05, 0x00, 0x00, 0x00 }, "ColorRange", "CDCIEssenceDescriptor", 0x3306, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "TimeStruct", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x05, 0x03, 0x0d, 0x00, 0x00, 0x00 }, "AlphaMaxRef", "RGBAEssenceDescriptor", 0x3408, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x18, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00 }, "PaddingBits", "CDCIEssenceDescriptor", 0x3307, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x08, 0x00, 0x00, 0x00 }, "XTOsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x04, 0x02, 0x0d, 0x00, 0x00 }, "ContextSR", "CryptographicFramework", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1f, 0x00 }, "CodecDefinition", NULL, 0x0000, DictIndexSet, 247, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x0b, 0x00, 0x00, 0x00 }, "PeakFrames", "WaveAudioDescriptor", 0x3d2e, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x06, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00 }, "HeaderByteCount", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x30, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00 }, "EditRate", "Track", 0x4b01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x04, 0x01, 0x02, 0x02, 0x00, 0x00 }, "CryptographicContext", NULL, 0x0000, DictIndexSet, 253, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x08, 0x00, 0x00, 0x00 }, "GenerationUID", "InterchangeObject", 0x0102, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x02, 0x03, 0x01, 0x02, 0x01, 0x00, 0x00 }, "DefinitionObjectDescription", "DefinitionObject", 0x1b03, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1a, 0x00 }, "DefinitionObject", NULL, 0x0000, DictIndexSet, 256, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x05, 0x00, 0x00, 0x00 }, "ElementValues", "TypeDefinitionEnumeration", 0x0016, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceEssenceDescriptor", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x0e, 0x00, 0x00 }, "TypeDefinitionRename", NULL, 0x0000, DictIndexSet, 262, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x03, 0x02, 0x05, 0x00, 0x00, 0x00 }, "VideoLineMap", "GenericPictureEssenceDescriptor", 0x320d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x02, 0x03, 0x00, 0x00 }, "Descriptor", "SourcePackage", 0x4701, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x06, 0x01, 0x01, 0x03, 0x05, 0x00, 0x00, 0x00 }, "LinkedTrackID", "FileDescriptor", 0x3006, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorFileDescriptor", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x3a, 0x00 }, "StaticTrack", NULL, 0x0000, DictIndexSet, 267, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x0a, 0x00, 0x00 }, "ProfileAndLevel", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x08, 0x01, 0x02, 0x01, 0x03, 0x00, 0x00 }, "BodyOffset", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x30, 0x00 }, "Identification", NULL, 0x0000, DictIndexSet, 274, 12 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x15, 0x02, 0x00, 0x00, 0x00, 0x00 }, "InstanceUID", "AbstractObject", 0x3c0a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x06, 0x09, 0x00, 0x00 }, "StructuralComponents", "Sequence", 0x1001, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x03, 0x01, 0x00, 0x00 }, "ProductName", "Identification", 0x3c02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x02, 0x03, 0x03, 0x04, 0x00, 0x00, 0x00 }, "QuantizationBits", "GenericSoundEssenceDescriptor", 0x3d01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x20, 0x04, 0x00, 0x00, 0x00, 0x00 }, "LocalTagType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x02, 0x02, 0x00, 0x00, 0x00 }, "StoredWidth", "GenericPictureEssenceDescriptor", 0x3203, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x04, 0x01, 0x07, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x7e, 0x01, 0x00 }, "EncryptedTriplet", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x01, 0x03, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00 }, "IndexSID", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x02, 0x02, 0x00, 0x00, 0x00 }, "SourceEssenceContainer", "CryptographicContext", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x10, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Stream", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Boolean", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x03, 0x01, 0x03, 0x00, 0x00 }, "Origin", "Track", 0x4b02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x04, 0x00, 0x00, 0x00 }, "XOsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x04, 0x06, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00 }, "DescriptiveMetadataScheme", "DMSegment", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00 }, "Build", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceInterpolationDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceTaggedValueDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x36, 0x00 }, "MaterialPackage", NULL, 0x0000, DictIndexSet, 286, 8 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x06, 0x01, 0x01, 0x07, 0x17, 0x00, 0x00, 0x00 }, "RootPreface", "Root", 0x0002, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x01, 0x03, 0x03, 0x02, 0x01, 0x00, 0x00, 0x00 }, "PackageName", "GenericPackage", 0x4402, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x01, 0x00, 0x00 }, "ClassDefinition", NULL, 0x0000, DictIndexSet, 294, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x12, 0x00, 0x00, 0x00 }, "RenamedType", "TypeDefinitionRename", 0x001e, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x11, 0x00 }, "SourceClip", NULL, 0x0000, DictIndexSet, 301, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int64Array", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x03, 0x01, 0x00 }, "MXFOP1c", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x03, 0x06, 0x02, 0x00, 0x00, 0x00, 0x00 }, "LocalTag", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x02, 0x01, 0x01, 0x00 }, "MXFOP2a", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x04, 0x00, 0x00, 0x00 }, "UserDataMode", "AES3PCMDescriptor", 0x3d12, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x03, 0x00 }, "Segment", NULL, 0x0000, DictIndexSet, 311, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x01, 0x03, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00 }, "BodySID", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x01, 0x02 }, "DMS1ProductionExtended", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x06, 0x01, 0x01, 0x07, 0x15, 0x00, 0x00, 0x00 }, "LocalTagEntries", "Primer", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x03, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00 }, "GlobalAUID", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x18, 0x00 }, "ContentStorage", NULL, 0x0000, DictIndexSet, 316, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x04, 0x06, 0x10, 0x00, 0x00 }, "SubDescriptors", "GenericDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x10, 0x02, 0x03, 0x00, 0x00 }, "ModificationDate", "Identification", 0x3c06, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x0d, 0x00, 0x00, 0x00 }, "QuantizationDefault", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x23, 0x00, 0x00 }, "TypeDefinitionCharacter", NULL, 0x0000, DictIndexSet, 321, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x09, 0x00, 0x00, 0x00 }, "PeakEnvelopeBlockSize", "WaveAudioDescriptor", 0x3d2c, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x30, 0x04, 0x04, 0x01, 0x00, 0x00, 0x00 }, "EventComment", "Event", 0x0602, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x03, 0x02, 0x00, 0x00, 0x00 }, "SourceTrackID", "SourceReference", 0x1102, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StringArray", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x09, 0x00, 0x00 }, "BPictureCount", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00 }, "WeakReferenceParameterDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSegment", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00 }, "Denominator", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x03, 0x03, 0x00, 0x00, 0x00 }, "BlackRefLevel", "CDCIEssenceDescriptor", 0x3304, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x45, 0x00 }, "DMSourceClip", NULL, 0x0000, DictIndexSet, 325, 11 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x05, 0x05, 0x00, 0x00 }, "DataDefinitions", "Dictionary", 0x2605, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x03, 0x01, 0x06, 0x00, 0x00, 0x00 }, "FieldDominance", "GenericPictureEssenceDescriptor", 0x3212, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x02, 0x00, 0x00 }, "MXFGCDV", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x0d, 0x00, 0x00, 0x00 }, "ApplicationPluginInstanceID", "ApplicationPluginObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Major", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x01, 0x01, 0x00 }, "MXFOP1x", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x02, 0x00, 0x00, 0x00 }, "Properties", "ClassDefinition", 0x0009, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceTrack", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x41, 0x00 }, "DMSegment", NULL, 0x0000, DictIndexSet, 336, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "AUIDSet", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00 }, "DialNorm", "GenericSoundEssenceDescriptor", 0x3d0c, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x04, 0x04, 0x01, 0x06, 0x00, 0x00, 0x00 }, "DeltaEntryArray", "IndexTableSegment", 0x3f09, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DateStruct", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x06, 0x01, 0x00, 0x00 }, "Platform", "Identification", 0x3c08, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x01, 0x03, 0x00, 0x00 }, "Codec", "FileDescriptor", 0x3005, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x0a, 0x00, 0x00, 0x00 }, "SampledYOffset", "GenericPictureEssenceDescriptor", 0x3207, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int64", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x02, 0x04, 0x00 }, "ClosedCompleteHeader", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0d, 0x00, 0x00, 0x00 }, "VariableArrayElementType", "TypeDefinitionVariableArray", 0x0019, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt16", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x01, 0x01, 0x02, 0x03, 0x00, 0x00, 0x00 }, "SourceKey", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x04, 0x00, 0x00, 0x00 }, "PropertyType", "PropertyDefinition", 0x000b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x02, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00 }, "ElectroSpatialFormulation", "GenericSoundEssenceDescriptor", 0x3d05, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x01, 0x00, 0x00 }, "MXFGCD10", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x06, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Length", "RandomIndexMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "ProductVersionType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x03, 0x03, 0x03, 0x00, 0x00 }, "EventStartPosition", "Event", 0x0601, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x30, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00 }, "EventEditRate", "EventTrack", 0x4901, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x02, 0x01, 0x01, 0x03, 0x01, 0x00 }, "CodingEquations", "GenericPictureEssenceDescriptor", 0x321a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x06, 0x01, 0x01, 0x04, 0x02, 0x0e, 0x00, 0x00 }, "ApplicationPluginBatch", "InterchangeObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x08, 0x00, 0x00, 0x00 }, "Palette", "RGBAEssenceDescriptor", 0x3403, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x06, 0x01, 0x01, 0x07, 0x19, 0x00, 0x00, 0x00 }, "RootFormatVersion", "Root", 0x0022, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x0f, 0x00 }, "Sequence", NULL, 0x0000, DictIndexSet, 346, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x39, 0x00 }, "EventTrack", NULL, 0x0000, DictIndexSet, 352, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00 }, "Patch", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x51, 0x00 }, "MPEG2VideoDescriptor", NULL, 0x0000, DictIndexSet, 361, 45 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DictReferenceContainerDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00 }, "InterchangeObject", NULL, 0x0000, DictIndexSet, 406, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Timestamp", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x03, 0x01, 0x00, 0x00, 0x00 }, "SourcePackageID", "SourceReference", 0x1101, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x0c, 0x00, 0x00, 0x00 }, "LinkedDescriptiveFrameworkPluginID", "DM_Framework", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x01, 0x00, 0x00, 0x00 }, "ThisGenerationUID", "Identification", 0x3c09, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x08, 0x00, 0x00, 0x00 }, "PointsPerPeakValue", "WaveAudioDescriptor", 0x3d2b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x07, 0x02, 0x01, 0x03, 0x01, 0x0b, 0x00, 0x00 }, "EventOrigin", "EventTrack", 0x4902, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x02, 0x02, 0x10, 0x02, 0x01, 0x00, 0x00 }, "EssenceContainers", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x04, 0x01, 0x02, 0x01, 0x00, 0x00 }, "CryptographicFramework", NULL, 0x0000, DictIndexSet, 409, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x09, 0x00, 0x00, 0x00 }, "SampledXOffset", "GenericPictureEssenceDescriptor", 0x3206, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00 }, "URLString", "NetworkLocator", 0x4001, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x05, 0x01, 0x00 }, "Primer", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceKLVData", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x04, 0x01, 0x01, 0x02, 0x06, 0x00, 0x00 }, "RoundedTimecodeBase", "TimecodeComponent", 0x1502, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x10, 0x10, 0x05, 0x01, 0x00, 0x00, 0x00 }, "FooterPartition", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x0d, 0x00, 0x00 }, "TypeDefinitionRecord", NULL, 0x0000, DictIndexSet, 412, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x02, 0x01, 0x00, 0x00 }, "ContentStorageObject", "Preface", 0x3b03, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x23, 0x00 }, "EssenceContainerData", NULL, 0x0000, DictIndexSet, 418, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x06, 0x04, 0x00, 0x00 }, "Identifications", "Preface", 0x3b06, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x06, 0x01, 0x01, 0x04, 0x02, 0x0f, 0x00, 0x00 }, "PackageMarker", "MaterialPackage", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x08, 0x00, 0x00, 0x00 }, "SampledWidth", "GenericPictureEssenceDescriptor", 0x3205, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x02, 0x0d, 0x01, 0x02, 0x01, 0x10, 0x00, 0x00, 0x00 }, "MXFOPAtom", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x00, 0x00, 0x00 }, "MXFGC", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x03, 0x02, 0x08, 0x00, 0x00, 0x00 }, "StoredF2Offset", "GenericPictureEssenceDescriptor", 0x3216, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x02, 0x00, 0x00, 0x00 }, "IsSigned", "TypeDefinitionInteger", 0x0010, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x04, 0x04, 0x01, 0x07, 0x00, 0x00, 0x00 }, "PosTableCount", "IndexTableSegment", 0x3f0e, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x10, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UTF16String", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorComponent", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x02, 0x09, 0x03, 0x01, 0x03, 0x00, 0x00, 0x00 }, "EncryptedSourceValue", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x04, 0x06, 0x08, 0x03, 0x00, 0x00, 0x00, 0x00 }, "ApplicationScheme", "ApplicationPluginObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x03, 0x03, 0x00 }, "OpenCompleteBodyPartition", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x03, 0x01 }, "DMS1Scene", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x04, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00 }, "LocatorName", "TextLocator", 0x4101, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x10, 0x01, 0x00 }, "IndexTableSegment", NULL, 0x0000, DictIndexSet, 424, 11 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x03, 0x03, 0x01, 0x00 }, "MXFOP3c", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorLocator", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x08, 0x00, 0x00 }, "MXFGCMPEGPS", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x03, 0x04, 0x00 }, "ClosedCompleteBodyPartition", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x24, 0x00, 0x00 }, "MetaDefinition", NULL, 0x0000, DictIndexSet, 435, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferencePropertyDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x02, 0x02, 0x00, 0x00, 0x00 }, "SequenceOffset", "WaveAudioDescriptor", 0x3d0b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UUID", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00 }, "AspectRatio", "GenericPictureEssenceDescriptor", 0x320e, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x06, 0x01, 0x01, 0x03, 0x0e, 0x00, 0x00, 0x00 }, "TimebaseReferenceTrackID", "PackageMarkerObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x42, 0x00 }, "GenericSoundEssenceDescriptor", NULL, 0x0000, DictIndexSet, 439, 17 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x05, 0x00, 0x00, 0x00 }, "YOsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x07, 0x04, 0x02, 0x01, 0x01, 0x05, 0x00, 0x00, 0x00 }, "ChannelAssignment", "WaveAudioDescriptor", 0x3d32, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x05, 0x02, 0x00, 0x00 }, "EssenceDataObjects", "ContentStorage", 0x1902, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x07, 0x00, 0x00 }, "IdenticalGOP", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferencePluginDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int32", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x07, 0x02, 0x01, 0x03, 0x02, 0x04, 0x00, 0x00 }, "PackageMarkOutPosition", "PackageMarkerObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x06, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceVectorParameter", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x62, 0x00 }, "ApplicationReferencedObject", NULL, 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x0a, 0x00, 0x00, 0x00 }, "ComponentDepth", "CDCIEssenceDescriptor", 0x3301, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x02, 0x03, 0x00, 0x00, 0x00 }, "DataEssenceTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x02, 0x01 }, "DMS1Clip", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x02, 0x02, 0x00, 0x00 }, "Dictionaries", "Preface", 0x3b04, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x1f, 0x00, 0x00, 0x00 }, "MetaDefinitions", "ExtensionScheme", 0x0028, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x07, 0x02, 0x01, 0x03, 0x01, 0x0a, 0x00, 0x00 }, "IndexStartPosition", "IndexTableSegment", 0x3f0c, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x0e, 0x00, 0x00, 0x00 }, "SetElementType", "TypeDefinitionSet", 0x001a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x03, 0x01, 0x02, 0x01, 0x07, 0x00, 0x00, 0x00 }, "MinorVersion", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x08, 0x00 }, "CommentMarker", NULL, 0x0000, DictIndexSet, 456, 8 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x02, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00 }, "OperationalPattern", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x06, 0x00, 0x00 }, "ClosedGOP", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x20, 0x00, 0x00 }, "TypeDefinitionExtendibleEnumeration", NULL, 0x0000, DictIndexSet, 464, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x07, 0x02, 0x09, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00 }, "CipherAlgorithmAES128CBC", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Rational", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x15, 0x03, 0x00, 0x00, 0x00, 0x00 }, "DefinitionObjectIdentification", "DefinitionObject", 0x1b01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x05, 0x00, 0x00, 0x00, 0x00 }, "Release", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetParameterDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x26, 0x00, 0x00 }, "ExtensionScheme", NULL, 0x0000, DictIndexSet, 468, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00 }, "Minor", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x01, 0x01, 0x04, 0x01, 0x08, 0x00, 0x00 }, "PrimaryPackage", "Preface", 0x3b08, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x0b, 0x00, 0x00, 0x00 }, "TargetSet", "TypeDefinitionWeakObjectReference", 0x0013, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x7f, 0x00 }, "AbstractObject", NULL, 0x0000, DictIndexSet, 474, 1 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x02, 0x01, 0x01, 0x03, 0x00, 0x00, 0x00 }, "AudioRefLevel", "GenericSoundEssenceDescriptor", 0x3d04, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceContentStorage", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x02, 0x00, 0x00 }, "SingleSequence", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetContainerDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x18, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00 }, "ImageAlignmentOffset", "GenericPictureEssenceDescriptor", 0x3211, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x27, 0x00 }, "GenericPictureEssenceDescriptor", NULL, 0x0000, DictIndexSet, 475, 35 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x02, 0x03, 0x01, 0x06, 0x00, 0x00, 0x00 }, "PeakEnvelopeVersion", "WaveAudioDescriptor", 0x3d29, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x0a, 0x00, 0x00, 0x00 }, "ToolkitVersion", "Identification", 0x3c07, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceDictionary", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x07, 0x00, 0x00 }, "TypeDefinitionEnumeration", NULL, 0x0000, DictIndexSet, 510, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x05, 0x08, 0x00, 0x00 }, "ContainerDefinitions", "Dictionary", 0x2608, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt32Batch", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x05, 0x00, 0x00 }, "MXFGCUncompressed", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x03, 0x01, 0x02, 0x01, 0x09, 0x00, 0x00, 0x00 }, "KAGSize", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x03, 0x00, 0x00, 0x00 }, "ElementCount", "TypeDefinitionFixedArray", 0x0018, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x01, 0x02, 0x00, 0x00 }, "EssenceContainer", "FileDescriptor", 0x3004, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x02, 0x02, 0x00, 0x00, 0x00 }, "SoundEssenceTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x37, 0x00 }, "SourcePackage", NULL, 0x0000, DictIndexSet, 517, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int32Batch", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x7e, 0x00, 0x00, 0x00 }, "ExtendibleEnumerationElement", NULL, 0x0000, DictIndexSet, 526, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "AUIDArray", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "RGBALayoutItem", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x03, 0x01, 0x04, 0x00, 0x00 }, "StartPosition", "SourceClip", 0x1201, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00 }, "SMPTE12MTimecodeTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x06, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00 }, "EditUnitByteCount", "IndexTableSegment", 0x3f05, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x03, 0x01, 0x02, 0x01, 0x03, 0x00, 0x00, 0x00 }, "EssenceIsIdentified", "ContainerDefinition", 0x2401, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x27, 0x00, 0x00 }, "PropertyWrapperDefinition", NULL, 0x0000, DictIndexSet, 533, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x07, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00 }, "TrackName", "GenericTrack", 0x4802, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x04, 0x02, 0x02, 0x02, 0x03, 0x02, 0x01, 0x00 }, "ATSCA52", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x00 }, "StructuralComponent", NULL, 0x0000, DictIndexSet, 542, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DictReferenceDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UL", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DM_Set", NULL, 0x0000, DictIndexSet, 547, 3 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x20, 0x00 }, "ContainerDefinition", NULL, 0x0000, DictIndexSet, 550, 7 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x10, 0x10, 0x02, 0x01, 0x00, 0x00, 0x00 }, "PreviousPartition", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x24, 0x00 }, "GenericDescriptor", NULL, 0x0000, DictIndexSet, 557, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x06, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00 }, "SampleRate", "FileDescriptor", 0x3001, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x03, 0x02, 0x07, 0x00, 0x00, 0x00 }, "DisplayF2Offset", "GenericPictureEssenceDescriptor", 0x3217, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetEssenceData", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x03, 0x00, 0x00, 0x00 }, "Ysiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x30, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UMID", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x02, 0x01, 0x01, 0x06, 0x01, 0x00 }, "ColorPrimaries", "GenericPictureEssenceDescriptor", 0x3219, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x0d, 0x00, 0x00 }, "MXFGCVBI", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "VersionType", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00 }, "AlphaTransparency", "GenericPictureEssenceDescriptor", 0x320f, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x06, 0x00, 0x00 }, "TypeDefinitionWeakObjectReference", NULL, 0x0000, DictIndexSet, 561, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x0c, 0x00, 0x00 }, "TypeDefinitionStream", NULL, 0x0000, DictIndexSet, 567, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x09, 0x00, 0x00, 0x00 }, "PaletteLayout", "RGBAEssenceDescriptor", 0x3404, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x01, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 }, "Int16", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x03, 0x07, 0x00, 0x00, 0x00 }, "AlphaSampleDepth", "CDCIEssenceDescriptor", 0x3309, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "RationalArray", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00 }, "msBy4", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x0c, 0x00, 0x00, 0x00 }, "DisplayWidth", "GenericPictureEssenceDescriptor", 0x3209, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x02, 0x03, 0x01, 0x00 }, "MXFOP2c", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x3b, 0x00 }, "Track", NULL, 0x0000, DictIndexSet, 571, 9 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x01, 0x0e, 0x00, 0x00, 0x00 }, "PeakEnvelopeData", "WaveAudioDescriptor", 0x3d31, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x02, 0x01, 0x01, 0x03, 0x00, 0x00 }, "ComponentLength", "StructuralComponent", 0x0202, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x10, 0x01, 0x00, 0x00, 0x00 }, "KLVFill", NULL, 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceNetworkLocator", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x22, 0x00 }, "Dictionary", NULL, 0x0000, DictIndexSet, 580, 6 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x2f, 0x00 }, "Preface", NULL, 0x0000, DictIndexSet, 586, 13 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x03, 0x01, 0x02, 0x01, 0x06, 0x00, 0x00, 0x00 }, "MajorVersion", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x03, 0x00, 0x00 }, "ConstantBFrames", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x01, 0x07, 0x01, 0x02, 0x03, 0x01, 0x00, 0x00 }, "DefinitionObjectName", "DefinitionObject", 0x1b02, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x0a, 0x00, 0x00, 0x00 }, "Csiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x07, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, "ChunkData", "UnknownChunk", 0x4f03, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x02, 0x0a, 0x00, 0x00 }, "AnnotationSource", "CommentMarker", 0x0901, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x04, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DictReferenceVectorDataDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x33, 0x00 }, "TextLocator", NULL, 0x0000, DictIndexSet, 599, 4 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x0e, 0x00, 0x00, 0x00 }, "DisplayYOffset", "GenericPictureEssenceDescriptor", 0x320b, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x03, 0x01, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00 }, "Year", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x02, 0x02, 0x01, 0x00, 0x00, 0x00 }, "IsOptional", "PropertyDefinition", 0x000c, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x04, 0x04, 0x04, 0x01, 0x01, 0x00, 0x00, 0x00 }, "SliceCount", "IndexTableSegment", 0x3f08, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x05, 0x20, 0x07, 0x01, 0x07, 0x00, 0x00, 0x00 }, "ProductUID", "Identification", 0x3c05, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetCodecDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x05, 0x00, 0x00 }, "LowDelay", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "MetaReferenceClassDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x06, 0x02, 0x01, 0x0b, 0x00, 0x00 }, "BitRate", "MPEG2VideoDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x02, 0x01, 0x00 }, "MXFOP1b", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x0b, 0x00, 0x00, 0x00 }, "LinkedApplicationPluginInstanceID", "ApplicationReferencedObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x02, 0x05, 0x00, 0x00 }, "TypeDefinitionStrongObjectReference", NULL, 0x0000, DictIndexSet, 603, 5 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x0e, 0x00, 0x00, 0x00 }, "DescriptiveMetadataPluginID", "DMSegment", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x03, 0x01, 0x00 }, "OpenBodyPartition", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x01, 0x07, 0x00, 0x00, 0x00 }, "SampledHeight", "GenericPictureEssenceDescriptor", 0x3204, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x08, 0x04, 0x06, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00 }, "ChunkID", "UnknownChunk", 0x4f01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x05, 0x01, 0x06, 0x00, 0x00, 0x00 }, "Emphasis", "AES3PCMDescriptor", 0x3d0d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x02, 0x01, 0x00, 0x00, 0x00 }, "StoredHeight", "GenericPictureEssenceDescriptor", 0x3202, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x07, 0x02, 0x02, 0x01, 0x01, 0x02, 0x00, 0x00 }, "IndexDuration", "IndexTableSegment", 0x3f0d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01, 0x0d, 0x01, 0x02, 0x01, 0x01, 0x04, 0x04, 0x00 }, "CompleteFooter", NULL, 0x0000, DictIndexPack, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x02, 0x03, 0x02, 0x03, 0x00, 0x00, 0x00 }, "BlockStartOffset", "AES3PCMDescriptor", 0x3d0f, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x48, 0x00 }, "WaveAudioDescriptor", NULL, 0x0000, DictIndexSet, 608, 30 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x07, 0x02, 0x09, 0x02, 0x02, 0x01, 0x00, 0x00, 0x00 }, "HMACAlgorithmSHA1128", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x01, 0x01, 0x03, 0x02, 0x01, 0x10, 0x00, 0x00, 0x00 }, "DescriptiveMetadataTrack", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x06, 0x00, 0x00 }, "MXFGCAESBWF", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x01, 0x00, 0x00, 0x00 }, "Rsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x04, 0x04, 0x02, 0x05, 0x00, 0x00, 0x00 }, "IndexEntryArray", "IndexTableSegment", 0x3f0a, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x06, 0x10, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00 }, "SequenceNumber", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0d, 0x06, 0x01, 0x01, 0x07, 0x1e, 0x00, 0x00, 0x00 }, "ExtensionDescription", "ExtensionScheme", 0x0027, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x04, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, "UInt8Array", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x04, 0x01, 0x05, 0x03, 0x04, 0x00, 0x00, 0x00 }, "WhiteReflevel", "CDCIEssenceDescriptor", 0x3305, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x04, 0x06, 0x10, 0x10, 0x03, 0x01, 0x00, 0x00, 0x00 }, "ThisPartition", "PartitionMetadata", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x01, 0x10, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, "ISO7", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x05, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00 }, "StrongReferenceSetTypeDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x05, 0x01, 0x10, 0x00, 0x00, 0x00 }, "VerticalSubsampling", "CDCIEssenceDescriptor", 0x3308, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x5c, 0x00 }, "ANCDataDescriptor", NULL, 0x0000, DictIndexSet, 638, 10 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x07, 0x05, 0x00, 0x00, 0x00 }, "LocalIdentification", "PropertyDefinition", 0x000d, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x09, 0x02, 0x09, 0x03, 0x02, 0x02, 0x00, 0x00, 0x00 }, "MIC", "EncryptedTriplet", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x04, 0x01, 0x05, 0x03, 0x0b, 0x00, 0x00, 0x00 }, "ComponentMaxRef", "RGBAEssenceDescriptor", 0x3406, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x04, 0x01, 0x01, 0x05, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00 }, "DictReferenceCodecDefinition", NULL, 0x0000, DictIndexType, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x07, 0x02, 0x01, 0x10, 0x02, 0x05, 0x00, 0x00 }, "PackageModifiedDate", "GenericPackage", 0x4404, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x66, 0x00 }, "ApplicationObject", NULL, 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x09, 0x00, 0x00 }, "MXFGCMPEGTS", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x05, 0x01, 0x07, 0x01, 0x06, 0x00, 0x00, 0x00, 0x00 }, "DMSourceClipTrackIDs", "DMSourceClip", 0x6103, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01, 0x0d, 0x01, 0x01, 0x01, 0x01, 0x01, 0x29, 0x00 }, "RGBAEssenceDescriptor", NULL, 0x0000, DictIndexSet, 648, 43 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x00, 0x0d, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00 }, "MXFOPSpecialized", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x04, 0x0d, 0x01, 0x04, 0x01, 0x01, 0x02, 0x02, 0x02 }, "DMS1ClipExtended", NULL, 0x0000, DictIndexLabel, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x04, 0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x00 }, "TransferCharacteristic", "GenericPictureEssenceDescriptor", 0x3210, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x06, 0x01, 0x01, 0x04, 0x06, 0x03, 0x00, 0x00 }, "Locators", "GenericDescriptor", 0x2f01, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0a, 0x04, 0x01, 0x06, 0x03, 0x07, 0x00, 0x00, 0x00 }, "YTsiz", "JPEG2000PictureSubDescriptor", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x02, 0x03, 0x02, 0x04, 0x01, 0x02, 0x01, 0x00, 0x00 }, "MetaDefinitionName", "MetaDefinition", 0x0006, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x06, 0x01, 0x01, 0x04, 0x01, 0x0b, 0x00, 0x00 }, "BaseClass", "ApplicationObject", 0x0000, DictIndexItem, 0, 0 },
+		{ { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x0c, 0x05, 0x20, 0x07, 0x01, 0x10, 0x00, 0x00, 0x00 }, "DescriptiveMetadataApplicationEnvironmentID", "DMSegment", 0x0000, DictIndexItem, 0, 0 },
+	};
+	const UInt32 DictData_IndexULSeeds[] = {
+		63, 11, 1735, 1804, 1008, 2, 2417, 1416, 135, 9, 742, 16,
+		9, 87, 296, 2, 882, 331, 178, 508, 193, 5, 21, 1203,
+		65, 623, 71, 133, 20, 42, 1488, 20, 279, 218, 66, 267,
+		22, 9, 31, 8, 880, 1, 1064, 21, 6, 85, 1, 73,
+		140, 593, 118, 1, 220, 1, 6, 71, 28, 13, 295, 3,
+		51, 83, 397, 97, 72, 75, 1, 144, 11, 5, 3, 74,
+		206, 23, 5, 595, 29, 3, 6, 541, 104, 11, 43, 1,
+		10, 41, 1, 46, 8, 1, 305, 201, 94, 64, 46, 0,
+		0, 21, 2, 26, 7, 106, 1, 8, 6, 21, 6, 339,
+		6, 3, 1, 5, 125, 40, 248, 11, 1, 21, 4, 36,
+		34, 24, 20, 26, 36, 6, 40, 19, 3, 41, 12
+	};
+	const UInt32 DictData_IndexNameSeeds[] = {
+		1, 166, 6, 14, 129, 46, 112, 37, 440, 519, 515, 233,
+		191, 27, 813, 15, 3, 176, 30, 114, 2067, 19, 57, 117,
+		29, 22, 152, 2, 19, 1, 105, 458, 17, 1003, 1, 2,
+		151, 156, 84, 6, 14, 556, 83, 54, 5, 74, 26, 66,
+		167, 132, 4, 24, 15, 1, 26, 2, 8, 163, 2, 14,
+		160, 24, 2, 18, 1, 56
+	};
+	const UInt32 DictData_IndexNameSlots[] = {
+		53, 430, 65, 16, 33, 509, 13, 265, 387, 113, 345, 96,
+		224, 156, 282, 184, 321, 406, 431, 235, 434, 505, 172, 105,
+		375, 82, 516, 332, 229, 20, 499, 292, 455, 56, 31, 163,
+		186, 78, 150, 199, 112, 92, 325, 238, 444, 322, 394, 91,
+		167, 433, 360, 319, 245, 410, 392, 115, 397, 254, 402, 427,
+		182, 396, 135, 468, 418, 59, 215, 269, 152, 28, 341, 227,
+		296, 447, 404, 263, 289, 253, 377, 7, 469, 280, 70, 32,
+		422, 358, 441, 18, 514, 248, 511, 395, 267, 272, 205, 38,
+		89, 304, 303, 339, 439, 194, 22, 249, 412, 212, 483, 114,
+		454, 95, 306, 47, 286, 58, 137, 420, 62, 116, 11, 144,
+		192, 443, 432, 276, 160, 515, 493, 136, 380, 131, 368, 10,
+		446, 477, 117, 475, 166, 259, 128, 324, 451, 200, 77, 41,
+		44, 1, 146, 362, 481, 162, 76, 363, 84, 458, 90, 365,
+		357, 149, 310, 359, 350, 436, 256, 335, 400, 409, 80, 34,
+		17, 147, 130, 421, 291, 503, 141, 284, 181, 320, 26, 491,
+		471, 85, 390, 24, 374, 378, 5, 52, 479, 262, 492, 168,
+		87, 206, 271, 452, 21, 201, 153, 193, 512, 489, 140, 177,
+		68, 391, 104, 502, 108, 299, 261, 323, 75, 264, 312, 336,
+		67, 109, 220, 195, 355, 173, 460, 102, 54, 234, 294, 461,
+		174, 283, 207, 372, 494, 361, 429, 6, 459, 255, 243, 419,
+		354, 230, 449, 413, 346, 191, 148, 46, 25, 125, 151, 295,
+		424, 101, 351, 127, 35, 139, 381, 27, 417
+	};
+	const DictIndexChild DictData_IndexChildren[] = {
+		{ 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x0017, 57 }, { 0x0018, 415 }, { 0x3c0a, 239 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 }, { 0x3004, 416 },
+		{ 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3e01, 204 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x0201, 158 }, { 0x0202, 457 }, { 0x1501, 161 }, { 0x1502, 337 }, { 0x1503, 159 }, { 0x3c0a, 239 },
+		{ 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x000b, 308 }, { 0x000c, 472 }, { 0x000d, 506 },
+		{ 0x000e, 197 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x3c0a, 239 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x1b01, 393 },
+		{ 0x1b02, 464 }, { 0x1b03, 226 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 },
+		{ 0x0202, 457 }, { 0x1101, 326 }, { 0x1102, 279 }, { 0x1103, 118 }, { 0x1104, 45 }, { 0x3c0a, 239 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 }, { 0x3004, 416 },
+		{ 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3e01, 204 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x3c0a, 239 }, { 0x0005, 123 },
+		{ 0x0006, 520 }, { 0x0007, 2 }, { 0x001a, 385 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x0201, 158 }, { 0x0202, 457 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 },
+		{ 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 },
+		{ 0x0007, 2 }, { 0x000f, 180 }, { 0x0010, 348 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x0019, 305 }, { 0x3c0a, 239 },
+		{ 0x0002, 257 }, { 0x0022, 318 }, { 0x0023, 120 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x4001, 334 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4f01, 485 },
+		{ 0x4f02, 100 }, { 0x4f03, 466 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x001b, 97 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 },
+		{ 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3d01, 242 }, { 0x3d02, 119 },
+		{ 0x3d03, 60 }, { 0x3d04, 401 }, { 0x3d05, 309 }, { 0x3d06, 183 }, { 0x3d07, 142 }, { 0x3d08, 15 },
+		{ 0x3d09, 98 }, { 0x3d0a, 164 }, { 0x3d0b, 364 }, { 0x3d0c, 297 }, { 0x3d0d, 486 }, { 0x3d0f, 490 },
+		{ 0x3d10, 88 }, { 0x3d11, 12 }, { 0x3d12, 266 }, { 0x3d13, 55 }, { 0x3d29, 407 }, { 0x3d2a, 30 },
+		{ 0x3d2b, 329 }, { 0x3d2c, 277 }, { 0x3d2d, 170 }, { 0x3d2e, 221 }, { 0x3d2f, 83 }, { 0x3d30, 0 },
+		{ 0x3d31, 456 }, { 0x3d32, 370 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x0101, 187 },
+		{ 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 }, { 0x3004, 416 }, { 0x3005, 301 },
+		{ 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3f01, 145 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 },
+		{ 0x0202, 457 }, { 0x0601, 313 }, { 0x0602, 278 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 }, { 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 },
+		{ 0x3201, 86 }, { 0x3202, 487 }, { 0x3203, 244 }, { 0x3204, 484 }, { 0x3205, 344 }, { 0x3206, 333 },
+		{ 0x3207, 302 }, { 0x3208, 37 }, { 0x3209, 453 }, { 0x320a, 157 }, { 0x320b, 470 }, { 0x320c, 42 },
+		{ 0x320d, 231 }, { 0x320e, 366 }, { 0x320f, 445 }, { 0x3210, 517 }, { 0x3211, 405 }, { 0x3212, 288 },
+		{ 0x3213, 203 }, { 0x3214, 209 }, { 0x3215, 213 }, { 0x3216, 347 }, { 0x3217, 438 }, { 0x3218, 169 },
+		{ 0x3219, 442 }, { 0x321a, 315 }, { 0x3301, 379 }, { 0x3302, 49 }, { 0x3303, 103 }, { 0x3304, 285 },
+		{ 0x3305, 500 }, { 0x3306, 214 }, { 0x3307, 217 }, { 0x3308, 504 }, { 0x3309, 450 }, { 0x330b, 8 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4401, 23 }, { 0x4402, 258 },
+		{ 0x4403, 138 }, { 0x4404, 510 }, { 0x4405, 155 }, { 0x0003, 40 }, { 0x0004, 134 }, { 0x3c0a, 239 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4801, 107 }, { 0x4802, 428 }, { 0x4803, 93 },
+		{ 0x4804, 66 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x1b01, 393 }, { 0x1b02, 464 }, { 0x1b03, 226 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x1b01, 393 }, { 0x1b02, 464 }, { 0x1b03, 226 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 },
+		{ 0x0007, 2 }, { 0x001e, 260 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 },
+		{ 0x4801, 107 }, { 0x4802, 428 }, { 0x4803, 93 }, { 0x4804, 66 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c01, 4 }, { 0x3c02, 241 }, { 0x3c03, 175 }, { 0x3c04, 14 }, { 0x3c05, 474 }, { 0x3c06, 274 },
+		{ 0x3c07, 408 }, { 0x3c08, 300 }, { 0x3c09, 328 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x4401, 23 }, { 0x4402, 258 }, { 0x4403, 138 }, { 0x4404, 510 }, { 0x4405, 155 },
+		{ 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x0008, 154 }, { 0x0009, 293 }, { 0x000a, 132 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 }, { 0x1101, 326 },
+		{ 0x1102, 279 }, { 0x1103, 118 }, { 0x1104, 45 }, { 0x1201, 423 }, { 0x3c0a, 239 }, { 0x0101, 187 },
+		{ 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x1901, 63 }, { 0x1902, 371 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 }, { 0x1101, 326 },
+		{ 0x1102, 279 }, { 0x1103, 118 }, { 0x1104, 45 }, { 0x1201, 423 }, { 0x3c0a, 239 }, { 0x6103, 513 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 }, { 0x0601, 313 }, { 0x0602, 278 },
+		{ 0x0901, 467 }, { 0x3c0a, 239 }, { 0x6101, 143 }, { 0x6102, 71 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x0201, 158 }, { 0x0202, 457 }, { 0x1001, 240 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x4801, 107 }, { 0x4802, 428 }, { 0x4803, 93 }, { 0x4804, 66 }, { 0x4901, 314 },
+		{ 0x4902, 330 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 },
+		{ 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3201, 86 }, { 0x3202, 487 }, { 0x3203, 244 },
+		{ 0x3204, 484 }, { 0x3205, 344 }, { 0x3206, 333 }, { 0x3207, 302 }, { 0x3208, 37 }, { 0x3209, 453 },
+		{ 0x320a, 157 }, { 0x320b, 470 }, { 0x320c, 42 }, { 0x320d, 231 }, { 0x320e, 366 }, { 0x320f, 445 },
+		{ 0x3210, 517 }, { 0x3211, 405 }, { 0x3212, 288 }, { 0x3213, 203 }, { 0x3214, 209 }, { 0x3215, 213 },
+		{ 0x3216, 347 }, { 0x3217, 438 }, { 0x3218, 169 }, { 0x3219, 442 }, { 0x321a, 315 }, { 0x3301, 379 },
+		{ 0x3302, 49 }, { 0x3303, 103 }, { 0x3304, 285 }, { 0x3305, 500 }, { 0x3306, 214 }, { 0x3307, 217 },
+		{ 0x3308, 504 }, { 0x3309, 450 }, { 0x330b, 8 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 },
+		{ 0x0007, 2 }, { 0x001c, 171 }, { 0x001d, 3 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x2701, 99 }, { 0x3c0a, 239 }, { 0x3f06, 246 }, { 0x3f07, 268 }, { 0x3c0a, 239 }, { 0x3f05, 425 },
+		{ 0x3f06, 246 }, { 0x3f07, 268 }, { 0x3f08, 473 }, { 0x3f09, 298 }, { 0x3f0a, 496 }, { 0x3f0b, 79 },
+		{ 0x3f0c, 384 }, { 0x3f0d, 488 }, { 0x3f0e, 349 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 },
+		{ 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3d01, 242 }, { 0x3d02, 119 },
+		{ 0x3d03, 60 }, { 0x3d04, 401 }, { 0x3d05, 309 }, { 0x3d06, 183 }, { 0x3d07, 142 }, { 0x3d0c, 297 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 }, { 0x0601, 313 }, { 0x0602, 278 },
+		{ 0x0901, 467 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x3c0a, 239 },
+		{ 0x0024, 64 }, { 0x0025, 61 }, { 0x0026, 106 }, { 0x0027, 498 }, { 0x0028, 383 }, { 0x3c0a, 239 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 },
+		{ 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3201, 86 }, { 0x3202, 487 }, { 0x3203, 244 },
+		{ 0x3204, 484 }, { 0x3205, 344 }, { 0x3206, 333 }, { 0x3207, 302 }, { 0x3208, 37 }, { 0x3209, 453 },
+		{ 0x320a, 157 }, { 0x320b, 470 }, { 0x320c, 42 }, { 0x320d, 231 }, { 0x320e, 366 }, { 0x320f, 445 },
+		{ 0x3210, 517 }, { 0x3211, 405 }, { 0x3212, 288 }, { 0x3213, 203 }, { 0x3214, 209 }, { 0x3215, 213 },
+		{ 0x3216, 347 }, { 0x3217, 438 }, { 0x3218, 169 }, { 0x3219, 442 }, { 0x321a, 315 }, { 0x3c0a, 239 },
+		{ 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 }, { 0x0014, 48 }, { 0x0015, 211 }, { 0x0016, 228 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4401, 23 }, { 0x4402, 258 },
+		{ 0x4403, 138 }, { 0x4404, 510 }, { 0x4405, 155 }, { 0x4701, 232 }, { 0x002a, 51 }, { 0x0101, 187 },
+		{ 0x0102, 225 }, { 0x1b01, 393 }, { 0x1b02, 464 }, { 0x1b03, 226 }, { 0x3c0a, 239 }, { 0x0005, 123 },
+		{ 0x0006, 520 }, { 0x0007, 2 }, { 0x000b, 308 }, { 0x000c, 472 }, { 0x000d, 506 }, { 0x000e, 197 },
+		{ 0x0029, 126 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x0201, 158 }, { 0x0202, 457 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x1b01, 393 }, { 0x1b02, 464 }, { 0x1b03, 226 }, { 0x2401, 426 }, { 0x3c0a, 239 }, { 0x0101, 187 },
+		{ 0x0102, 225 }, { 0x2f01, 518 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x0012, 124 }, { 0x0013, 399 }, { 0x3c0a, 239 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4801, 107 }, { 0x4802, 428 },
+		{ 0x4803, 93 }, { 0x4804, 66 }, { 0x4b01, 223 }, { 0x4b02, 250 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x2605, 287 }, { 0x2607, 188 }, { 0x2608, 411 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 },
+		{ 0x3b02, 19 }, { 0x3b03, 340 }, { 0x3b04, 382 }, { 0x3b05, 179 }, { 0x3b06, 342 }, { 0x3b07, 72 },
+		{ 0x3b08, 398 }, { 0x3b09, 388 }, { 0x3b0a, 331 }, { 0x3b0b, 129 }, { 0x3c0a, 239 }, { 0x0101, 187 },
+		{ 0x0102, 225 }, { 0x3c0a, 239 }, { 0x4101, 356 }, { 0x0005, 123 }, { 0x0006, 520 }, { 0x0007, 2 },
+		{ 0x0011, 9 }, { 0x3c0a, 239 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 },
+		{ 0x3002, 176 }, { 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3d01, 242 },
+		{ 0x3d02, 119 }, { 0x3d03, 60 }, { 0x3d04, 401 }, { 0x3d05, 309 }, { 0x3d06, 183 }, { 0x3d07, 142 },
+		{ 0x3d09, 98 }, { 0x3d0a, 164 }, { 0x3d0b, 364 }, { 0x3d0c, 297 }, { 0x3d29, 407 }, { 0x3d2a, 30 },
+		{ 0x3d2b, 329 }, { 0x3d2c, 277 }, { 0x3d2d, 170 }, { 0x3d2e, 221 }, { 0x3d2f, 83 }, { 0x3d30, 0 },
+		{ 0x3d31, 456 }, { 0x3d32, 370 }, { 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 },
+		{ 0x3002, 176 }, { 0x3004, 416 }, { 0x3005, 301 }, { 0x3006, 233 }, { 0x3c0a, 239 }, { 0x3e01, 204 },
+		{ 0x0101, 187 }, { 0x0102, 225 }, { 0x2f01, 518 }, { 0x3001, 437 }, { 0x3002, 176 }, { 0x3004, 416 },
+		{ 0x3005, 301 }, { 0x3006, 233 }, { 0x3201, 86 }, { 0x3202, 487 }, { 0x3203, 244 }, { 0x3204, 484 },
+		{ 0x3205, 344 }, { 0x3206, 333 }, { 0x3207, 302 }, { 0x3208, 37 }, { 0x3209, 453 }, { 0x320a, 157 },
+		{ 0x320b, 470 }, { 0x320c, 42 }, { 0x320d, 231 }, { 0x320e, 366 }, { 0x320f, 445 }, { 0x3210, 517 },
+		{ 0x3211, 405 }, { 0x3212, 288 }, { 0x3213, 203 }, { 0x3214, 209 }, { 0x3215, 213 }, { 0x3216, 347 },
+		{ 0x3217, 438 }, { 0x3218, 169 }, { 0x3219, 442 }, { 0x321a, 315 }, { 0x3401, 110 }, { 0x3403, 317 },
+		{ 0x3404, 448 }, { 0x3405, 29 }, { 0x3406, 508 }, { 0x3407, 121 }, { 0x3408, 216 }, { 0x3409, 178 },
+		{ 0x3c0a, 239 }
+	};
+	const DictIndex DictData_Index = { DictData_IndexEntries, 523, DictData_IndexULSeeds, 131, DictData_IndexNameSeeds, 66, DictData_IndexNameSlots, 261, DictData_IndexChildren };
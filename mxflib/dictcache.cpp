@@ -0,0 +1,645 @@
+/*! \file	dictcache.cpp
+ *	\brief	Implementation of classes that store and load binary snapshots of dictionaries
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+//! The snapshot currently recording definitions, or NULL
+DictionarySnapshot *DictionarySnapshot::Recording = NULL;
+
+
+namespace
+{
+	//! Should LoadDictionary() use snapshots when it finds them?
+	bool UseSnapshots = true;
+
+	//! Identifier at the start of every snapshot file
+	const UInt8 SnapshotMagic[8] = { 'M', 'X', 'F', 'L', 'D', 'I', 'C', 'T' };
+
+	//! Size of the snapshot file header: magic, version, source hash, payload size and payload hash
+	const size_t SnapshotHeaderSize = 8 + 4 + 4 + 4 + 4;
+
+	//! Step types in the snapshot payload - one for each call to LoadTypes() or LoadClasses()
+	enum SnapshotStep
+	{
+		StepTypes = 1,						//!< A list of types
+		StepClasses = 2						//!< A list of classes
+	};
+
+	//! Limit on the nesting of child records, to prevent a corrupt snapshot sending us into deep recursion
+	const int MaxRecordDepth = 64;
+
+	//! Add data to a running 32-bit FNV-1a hash
+	UInt32 Hash32(const UInt8 *Data, size_t Size, UInt32 Hash = 0x811c9dc5)
+	{
+		while(Size--)
+		{
+			Hash ^= *(Data++);
+			Hash *= 0x01000193;
+		}
+
+		return Hash;
+	}
+
+	//! Add a string to a running 32-bit FNV-1a hash, including its terminating zero so that adjacent strings hash differently
+	UInt32 Hash32(const std::string &Text, UInt32 Hash)
+	{
+		return Hash32(reinterpret_cast<const UInt8 *>(Text.c_str()), Text.size() + 1, Hash);
+	}
+
+
+	/* Serializing functions */
+
+	void AppendU8(DataChunk &Data, UInt8 Value)
+	{
+		Data.Append(1, &Value);
+	}
+
+	void AppendU16(DataChunk &Data, UInt16 Value)
+	{
+		UInt8 Buffer[2];
+		PutU16(Value, Buffer);
+		Data.Append(2, Buffer);
+	}
+
+	void AppendU32(DataChunk &Data, UInt32 Value)
+	{
+		UInt8 Buffer[4];
+		PutU32(Value, Buffer);
+		Data.Append(4, Buffer);
+	}
+
+	void AppendString(DataChunk &Data, const std::string &Value)
+	{
+		AppendU32(Data, static_cast<UInt32>(Value.size()));
+		Data.Append(Value.size(), reinterpret_cast<const UInt8 *>(Value.data()));
+	}
+
+	void AppendUL(DataChunk &Data, const ULPtr &Value)
+	{
+		if(!Value) AppendU8(Data, 0);
+		else
+		{
+			AppendU8(Data, 1);
+			Data.Append(16, Value->GetValue());
+		}
+	}
+
+	void AppendSymbolSpace(DataChunk &Data, const SymbolSpacePtr &Value)
+	{
+		if(Value) AppendString(Data, Value->Name());
+		else AppendString(Data, "");
+	}
+
+
+	//! Bounds-checked reader for the payload of a snapshot
+	class SnapshotReader
+	{
+	protected:
+		const UInt8 *Ptr;					//!< The next byte to read
+		const UInt8 *End;					//!< The end of the data
+		bool Bad;							//!< Set if we have tried to read beyond the end of the data or found an invalid value
+
+	public:
+		SnapshotReader(const UInt8 *Data, size_t Size) : Ptr(Data), End(Data + Size), Bad(false) {}
+
+		bool IsBad(void) const { return Bad; }
+		bool AtEnd(void) const { return Bad || (Ptr >= End); }
+
+		UInt8 ReadU8(void)
+		{
+			if(End - Ptr < 1) { Bad = true; return 0; }
+			return *(Ptr++);
+		}
+
+		UInt16 ReadU16(void)
+		{
+			if(End - Ptr < 2) { Bad = true; return 0; }
+			UInt16 Ret = GetU16(Ptr);
+			Ptr += 2;
+			return Ret;
+		}
+
+		UInt32 ReadU32(void)
+		{
+			if(End - Ptr < 4) { Bad = true; return 0; }
+			UInt32 Ret = GetU32(Ptr);
+			Ptr += 4;
+			return Ret;
+		}
+
+		std::string ReadString(void)
+		{
+			UInt32 Len = ReadU32();
+			if(Bad || (static_cast<size_t>(End - Ptr) < Len)) { Bad = true; return ""; }
+
+			std::string Ret(reinterpret_cast<const char *>(Ptr), Len);
+			Ptr += Len;
+			return Ret;
+		}
+
+		ULPtr ReadUL(void)
+		{
+			if(!ReadU8()) return NULL;
+			if(End - Ptr < 16) { Bad = true; return NULL; }
+
+			ULPtr Ret = new UL(Ptr);
+			Ptr += 16;
+			return Ret;
+		}
+
+		//! Read the name of a symbol space and locate it, building it if it does not yet exist
+		SymbolSpacePtr ReadSymbolSpace(void)
+		{
+			std::string Name = ReadString();
+			if(Name.empty()) return NULL;
+
+			SymbolSpacePtr Ret = SymbolSpace::FindSymbolSpace(Name);
+			if(!Ret) Ret = new SymbolSpace(Name);
+
+			return Ret;
+		}
+
+		TypeRecordPtr ReadTypeRecord(int Depth = 0);
+		ClassRecordPtr ReadClassRecord(int Depth = 0);
+	};
+
+
+	//! Read a type record, and its children
+	TypeRecordPtr SnapshotReader::ReadTypeRecord(int Depth /*=0*/)
+	{
+		TypeRecordPtr Ret = new TypeRecord;
+
+		Ret->Class = static_cast<TypeClass>(ReadU8());
+		Ret->Type = ReadString();
+		Ret->Detail = ReadString();
+		Ret->Base = ReadString();
+		Ret->UL = ReadUL();
+		Ret->Value = ReadString();
+		Ret->Size = static_cast<int>(ReadU32());
+		Ret->Endian = ReadU8() != 0;
+		Ret->ArrayClass = static_cast<MDArrayClass>(ReadU8());
+		Ret->RefType = static_cast<TypeRef>(static_cast<Int32>(ReadU32()));
+		Ret->RefTarget = ReadString();
+		Ret->SymSpace = ReadSymbolSpace();
+		Ret->IsBaseline = ReadU8() != 0;
+
+		UInt32 Count = ReadU32();
+		if(Count && (Depth >= MaxRecordDepth)) Bad = true;
+
+		while(Count-- && !Bad) Ret->Children.push_back(ReadTypeRecord(Depth + 1));
+
+		return Ret;
+	}
+
+
+	//! Read a class record, and its children
+	ClassRecordPtr SnapshotReader::ReadClassRecord(int Depth /*=0*/)
+	{
+		ClassRecordPtr Ret = new ClassRecord;
+
+		Ret->Class = static_cast<ClassType>(ReadU8());
+		Ret->MinSize = ReadU32();
+		Ret->MaxSize = ReadU32();
+		Ret->Name = ReadString();
+		Ret->Detail = ReadString();
+		Ret->Usage = static_cast<ClassUsage>(ReadU8());
+		Ret->Base = ReadString();
+		Ret->Tag = ReadU16();
+		Ret->UL = ReadUL();
+		Ret->HasDefault = ReadU8() != 0;
+		Ret->Default = ReadString();
+		Ret->HasDValue = ReadU8() != 0;
+		Ret->DValue = ReadString();
+		Ret->RefType = static_cast<ClassRef>(static_cast<Int32>(ReadU32()));
+		Ret->RefTarget = ReadString();
+		Ret->SymSpace = ReadSymbolSpace();
+		Ret->IsBaseline = ReadU8() != 0;
+		Ret->ExtendSubs = ReadU8() != 0;
+		Ret->Parent = ReadUL();
+
+		UInt32 Count = ReadU32();
+		if(Count && (Depth >= MaxRecordDepth)) Bad = true;
+
+		while(Count-- && !Bad) Ret->Children.push_back(ReadClassRecord(Depth + 1));
+
+		return Ret;
+	}
+}
+
+
+//! Append the serialized form of a type record, and its children, to the data
+void DictionarySnapshot::AddTypeRecord(TypeRecordPtr &Record)
+{
+	AppendU8(Data, static_cast<UInt8>(Record->Class));
+	AppendString(Data, Record->Type);
+	AppendString(Data, Record->Detail);
+	AppendString(Data, Record->Base);
+	AppendUL(Data, Record->UL);
+	AppendString(Data, Record->Value);
+	AppendU32(Data, static_cast<UInt32>(Record->Size));
+	AppendU8(Data, Record->Endian ? 1 : 0);
+	AppendU8(Data, static_cast<UInt8>(Record->ArrayClass));
+	AppendU32(Data, static_cast<UInt32>(static_cast<Int32>(Record->RefType)));
+	AppendString(Data, Record->RefTarget);
+	AppendSymbolSpace(Data, Record->SymSpace);
+	AppendU8(Data, Record->IsBaseline ? 1 : 0);
+
+	AppendU32(Data, static_cast<UInt32>(Record->Children.size()));
+	TypeRecordList::iterator it = Record->Children.begin();
+	while(it != Record->Children.end())
+	{
+		AddTypeRecord(*it);
+		it++;
+	}
+}
+
+
+//! Append the serialized form of a class record, and its children, to the data
+void DictionarySnapshot::AddClassRecord(ClassRecordPtr &Record)
+{
+	AppendU8(Data, static_cast<UInt8>(Record->Class));
+	AppendU32(Data, Record->MinSize);
+	AppendU32(Data, Record->MaxSize);
+	AppendString(Data, Record->Name);
+	AppendString(Data, Record->Detail);
+	AppendU8(Data, static_cast<UInt8>(Record->Usage));
+	AppendString(Data, Record->Base);
+	AppendU16(Data, Record->Tag);
+	AppendUL(Data, Record->UL);
+	AppendU8(Data, Record->HasDefault ? 1 : 0);
+	AppendString(Data, Record->Default);
+	AppendU8(Data, Record->HasDValue ? 1 : 0);
+	AppendString(Data, Record->DValue);
+	AppendU32(Data, static_cast<UInt32>(static_cast<Int32>(Record->RefType)));
+	AppendString(Data, Record->RefTarget);
+	AppendSymbolSpace(Data, Record->SymSpace);
+	AppendU8(Data, Record->IsBaseline ? 1 : 0);
+	AppendU8(Data, Record->ExtendSubs ? 1 : 0);
+	AppendUL(Data, Record->Parent);
+
+	AppendU32(Data, static_cast<UInt32>(Record->Children.size()));
+	ClassRecordList::iterator it = Record->Children.begin();
+	while(it != Record->Children.end())
+	{
+		AddClassRecord(*it);
+		it++;
+	}
+}
+
+
+//! Record a list of types in the current snapshot, then load them
+int DictionarySnapshot::RecordTypes(TypeRecordList &TypesData, SymbolSpacePtr &DefaultSymbolSpace)
+{
+	DictionarySnapshot *This = Recording;
+
+	// DRAGONS: The records must be stored before loading them, as the loading process updates them
+	AppendU8(This->Data, StepTypes);
+	AppendSymbolSpace(This->Data, DefaultSymbolSpace);
+	AppendU32(This->Data, static_cast<UInt32>(TypesData.size()));
+
+	TypeRecordList::iterator it = TypesData.begin();
+	while(it != TypesData.end())
+	{
+		This->AddTypeRecord(*it);
+		it++;
+	}
+
+	// Load the types, without recording anything that loading them loads (such as internal types or retries of unresolved types)
+	Recording = NULL;
+	int Ret = LoadTypes(TypesData, DefaultSymbolSpace);
+	Recording = This;
+
+	return Ret;
+}
+
+
+//! Record a list of classes in the current snapshot, then load them
+int DictionarySnapshot::RecordClasses(ClassRecordList &ClassesData, SymbolSpacePtr &DefaultSymbolSpace)
+{
+	DictionarySnapshot *This = Recording;
+
+	// DRAGONS: The records must be stored before loading them, as the loading process updates them
+	AppendU8(This->Data, StepClasses);
+	AppendSymbolSpace(This->Data, DefaultSymbolSpace);
+	AppendU32(This->Data, static_cast<UInt32>(ClassesData.size()));
+
+	ClassRecordList::iterator it = ClassesData.begin();
+	while(it != ClassesData.end())
+	{
+		This->AddClassRecord(*it);
+		it++;
+	}
+
+	// Load the classes, without recording anything that loading them loads (such as retries of unresolved classes)
+	Recording = NULL;
+	int Ret = LoadClasses(ClassesData, DefaultSymbolSpace);
+	Recording = This;
+
+	return Ret;
+}
+
+
+//! Load the recorded definitions, exactly as they were loaded when recorded
+/*! \return 0 if all OK
+ *  \return -1 on error
+ */
+int DictionarySnapshot::Load(bool FastFail /*=false*/)
+{
+	int Ret = 0;
+	bool HasClasses = false;
+
+	SnapshotReader Reader(Data.Data, Data.Size);
+	while(!Reader.AtEnd())
+	{
+		UInt8 Step = Reader.ReadU8();
+		SymbolSpacePtr DefaultSymbolSpace = Reader.ReadSymbolSpace();
+		UInt32 Count = Reader.ReadU32();
+
+		if(Step == StepTypes)
+		{
+			TypeRecordList Types;
+			while(Count-- && !Reader.IsBad()) Types.push_back(Reader.ReadTypeRecord());
+			if(Reader.IsBad()) break;
+
+			if(LoadTypes(Types, DefaultSymbolSpace) != 0) Ret = -1;
+		}
+		else if(Step == StepClasses)
+		{
+			ClassRecordList Classes;
+			while(Count-- && !Reader.IsBad()) Classes.push_back(Reader.ReadClassRecord());
+			if(Reader.IsBad()) break;
+
+			if(LoadClasses(Classes, DefaultSymbolSpace) != 0) Ret = -1;
+			HasClasses = true;
+		}
+		else
+		{
+			error("Unknown entry type 0x%02x in binary dictionary snapshot\n", Step);
+			return -1;
+		}
+
+		if(FastFail && (Ret != 0)) return Ret;
+	}
+
+	if(Reader.IsBad())
+	{
+		error("Binary dictionary snapshot is truncated or corrupt\n");
+		return -1;
+	}
+
+	// If we loaded any classes, build a static primer (for use in index tables)
+	if(HasClasses) MDOType::MakePrimer(true);
+
+	// Locate reference target types for any new types
+	MDOType::LocateRefTypes();
+
+	return Ret;
+}
+
+
+//! Write this snapshot to a file
+/*! \param SourceHash The hash of the dictionary source, as returned by DictionarySourceHash()
+ *  \return true if all OK
+ */
+bool DictionarySnapshot::Write(const char *FileName, UInt32 SourceHash)
+{
+	UInt8 Header[SnapshotHeaderSize];
+	memcpy(Header, SnapshotMagic, 8);
+	PutU32(DictionarySnapshotVersion, &Header[8]);
+	PutU32(SourceHash, &Header[12]);
+	PutU32(static_cast<UInt32>(Data.Size), &Header[16]);
+	PutU32(Hash32(Data.Data, Data.Size), &Header[20]);
+
+	FileHandle File = FileOpenNew(FileName);
+	if(!FileValid(File)) return false;
+
+	bool Ret = (FileWrite(File, Header, SnapshotHeaderSize) == SnapshotHeaderSize);
+	if(Ret && Data.Size) Ret = (FileWrite(File, Data.Data, Data.Size) == Data.Size);
+
+	FileClose(File);
+
+	// Don't leave a partial snapshot lying around
+	if(!Ret) FileDelete(FileName);
+
+	return Ret;
+}
+
+
+//! Read a snapshot from a file
+/*! \param SourceHash The hash of the dictionary source that the snapshot must have been made from
+ *  \param CheckSource False if the snapshot is to be used whatever it was made from
+ *  \return NULL if the file is not a valid snapshot of the right version and source
+ */
+DictionarySnapshotPtr DictionarySnapshot::Read(const char *FileName, UInt32 SourceHash, bool CheckSource /*=true*/)
+{
+	FileHandle File = FileOpenRead(FileName);
+	if(!FileValid(File)) return NULL;
+
+	UInt8 Header[SnapshotHeaderSize];
+	if(FileRead(File, Header, SnapshotHeaderSize) != SnapshotHeaderSize)
+	{
+		FileClose(File);
+		return NULL;
+	}
+
+	// Validate the header before reading any more
+	if(    (memcmp(Header, SnapshotMagic, 8) != 0)
+		|| (GetU32(&Header[8]) != DictionarySnapshotVersion)
+		|| (CheckSource && (GetU32(&Header[12]) != SourceHash)))
+	{
+		FileClose(File);
+		return NULL;
+	}
+
+	size_t PayloadSize = static_cast<size_t>(GetU32(&Header[16]));
+
+	DictionarySnapshotPtr Ret = new DictionarySnapshot;
+	Ret->Data.Resize(PayloadSize);
+
+	bool Valid = (FileRead(File, Ret->Data.Data, PayloadSize) == PayloadSize);
+	FileClose(File);
+
+	if(Valid) Valid = (Hash32(Ret->Data.Data, PayloadSize) == GetU32(&Header[20]));
+
+	if(!Valid)
+	{
+		warning("Binary dictionary snapshot \"%s\" is corrupt and will not be used\n", FileName);
+		return NULL;
+	}
+
+	return Ret;
+}
+
+
+//! Determine if a file is a binary dictionary snapshot rather than an XML dictionary
+bool DictionarySnapshot::IsSnapshotFile(const char *FileName)
+{
+	FileHandle File = FileOpenRead(FileName);
+	if(!FileValid(File)) return false;
+
+	UInt8 Buffer[8];
+	bool Ret = (FileRead(File, Buffer, 8) == 8) && (memcmp(Buffer, SnapshotMagic, 8) == 0);
+
+	FileClose(File);
+
+	return Ret;
+}
+
+
+//! Calculate the hash used to match a snapshot to the XML dictionary it was made from
+/*! The hash covers the contents of the XML file and the loading options that affect the definitions loaded.
+ *  \param XMLFilePath The full path of the XML dictionary file
+ *  \return The hash, or 0 if the file cannot be read
+ */
+UInt32 mxflib::DictionarySourceHash(std::string XMLFilePath, SymbolSpacePtr DefaultSymbolSpace, std::string Application)
+{
+	FileHandle File = FileOpenRead(XMLFilePath.c_str());
+	if(!FileValid(File)) return 0;
+
+	UInt32 Ret = Hash32(NULL, 0);
+
+	const size_t BufferSize = 64 * 1024;
+	UInt8 *Buffer = new UInt8[BufferSize];
+	for(;;)
+	{
+		size_t Bytes = FileRead(File, Buffer, BufferSize);
+		if(Bytes == 0) break;
+
+		Ret = Hash32(Buffer, Bytes, Ret);
+	}
+	delete[] Buffer;
+
+	FileClose(File);
+
+	Ret = Hash32(DefaultSymbolSpace ? DefaultSymbolSpace->Name() : std::string(), Ret);
+	Ret = Hash32(Application, Ret);
+
+	// Zero is reserved for "unreadable"
+	return Ret ? Ret : 1;
+}
+
+
+//! Load an XML dictionary and write a binary snapshot of it
+/*! \return 0 if all OK
+ *  \return -1 on error
+ *  \note The dictionary is loaded as well as stored in the snapshot
+ */
+int mxflib::WriteDictionarySnapshot(const char *DictFile, const char *SnapshotFile, SymbolSpacePtr DefaultSymbolSpace /*=MXFLibSymbols*/, std::string Application /*=""*/)
+{
+	std::string XMLFilePath = LookupDictionaryPath(DictFile);
+	if(XMLFilePath.empty())
+	{
+		error("Failed to locate dictionary \"%s\"\n", DictFile);
+		return -1;
+	}
+
+	if(DictionarySnapshot::IsSnapshotFile(XMLFilePath.c_str()))
+	{
+		error("Dictionary \"%s\" is already a binary snapshot\n", XMLFilePath.c_str());
+		return -1;
+	}
+
+	UInt32 SourceHash = DictionarySourceHash(XMLFilePath, DefaultSymbolSpace, Application);
+
+	DictionarySnapshotPtr Snapshot = new DictionarySnapshot;
+
+	// DRAGONS: Existing snapshots are ignored while recording, or we could record the old snapshot rather than the XML
+	bool WasUsingSnapshots = UseSnapshots;
+	UseSnapshots = false;
+
+	Snapshot->StartRecording();
+	int Ret = LoadDictionary(XMLFilePath.c_str(), DefaultSymbolSpace, Application);
+	Snapshot->StopRecording();
+
+	UseSnapshots = WasUsingSnapshots;
+
+	if(Ret != 0) return Ret;
+
+	if(!Snapshot->Write(SnapshotFile, SourceHash))
+	{
+		error("Failed to write binary dictionary snapshot \"%s\"\n", SnapshotFile);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+//! Load a dictionary from a binary snapshot, if a valid one exists for the given dictionary
+/*! If DictFile is itself a snapshot it is loaded. Otherwise a snapshot with the same path as DictFile followed
+ *  by DictionarySnapshotSuffix is loaded, as long as it was made from the current version of DictFile.
+ *  \param Result Set to the result of loading the dictionary from the snapshot, if one is used
+ *  \return true if a snapshot was used, false if the XML dictionary needs to be loaded
+ */
+bool mxflib::LoadDictionarySnapshot(const char *DictFile, SymbolSpacePtr DefaultSymbolSpace, std::string Application, bool FastFail, int &Result)
+{
+	std::string FilePath = LookupDictionaryPath(DictFile);
+	if(FilePath.empty()) return false;
+
+	DictionarySnapshotPtr Snapshot;
+
+	if(DictionarySnapshot::IsSnapshotFile(FilePath.c_str()))
+	{
+		// A snapshot given in place of an XML dictionary is used as it is, as there is no XML to check it against
+		Snapshot = DictionarySnapshot::Read(FilePath.c_str(), 0, false);
+		if(!Snapshot)
+		{
+			error("Failed to load binary dictionary snapshot \"%s\"\n", FilePath.c_str());
+			Result = -1;
+			return true;
+		}
+	}
+	else
+	{
+		if(!UseSnapshots) return false;
+
+		std::string SnapshotPath = FilePath + DictionarySnapshotSuffix;
+		if(!FileExists(SnapshotPath.c_str())) return false;
+
+		Snapshot = DictionarySnapshot::Read(SnapshotPath.c_str(), DictionarySourceHash(FilePath, DefaultSymbolSpace, Application));
+		if(!Snapshot)
+		{
+			debug("Binary dictionary snapshot \"%s\" does not match \"%s\" - loading the XML dictionary instead\n", SnapshotPath.c_str(), FilePath.c_str());
+			return false;
+		}
+	}
+
+	Result = Snapshot->Load(FastFail);
+	return true;
+}
+
+
+//! Enable or disable the automatic use of snapshots in LoadDictionary() (enabled by default)
+void mxflib::SetDictionarySnapshots(bool Enable)
+{
+	UseSnapshots = Enable;
+}
@@ -0,0 +1,145 @@
+/*! \file	dictcache.h
+ *	\brief	Definition of classes that store and load binary snapshots of dictionaries
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Loading an XML dictionary means parsing the whole file and building its types and classes
+ *  from scratch. A binary snapshot records the type and class definitions passed to LoadTypes()
+ *  and LoadClasses() while an XML dictionary is loaded, so that they can be loaded again later
+ *  without any XML parsing. Each snapshot holds a hash of the XML file it was made from, so an
+ *  out-of-date snapshot is never used in place of the XML dictionary.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__DICTCACHE_H
+#define MXFLIB__DICTCACHE_H
+
+namespace mxflib
+{
+	//! Version number of the binary dictionary snapshot format, snapshots of any other version are ignored
+	const UInt32 DictionarySnapshotVersion = 1;
+
+	//! Suffix added to the path of an XML dictionary to give the path of its snapshot (e.g. dict.xml.bin)
+	const char DictionarySnapshotSuffix[] = ".bin";
+
+	// Forward declare DictionarySnapshot to allow DictionarySnapshotPtr to be defined early
+	class DictionarySnapshot;
+
+	//! A smart pointer to a DictionarySnapshot
+	typedef SmartPtr<DictionarySnapshot> DictionarySnapshotPtr;
+
+	//! A recording of the type and class definitions loaded from a dictionary, which can be saved as a binary file
+	class DictionarySnapshot : public RefCount<DictionarySnapshot>
+	{
+	protected:
+		DataChunk Data;						//!< The serialized definitions
+
+		static DictionarySnapshot *Recording;	//!< The snapshot currently recording definitions, or NULL
+
+	public:
+		//! Build an empty snapshot
+		DictionarySnapshot() { Data.SetGranularity(64 * 1024); }
+
+		//! Record all definitions loaded from now on in this snapshot, until StopRecording() is called
+		void StartRecording(void) { Recording = this; }
+
+		//! Stop recording definitions
+		void StopRecording(void) { if(Recording == this) Recording = NULL; }
+
+		//! Is a snapshot currently recording definitions?
+		static bool IsRecording(void) { return Recording != NULL; }
+
+		//! Record a list of types in the current snapshot, then load them
+		/*! \note Only used by LoadTypes(), which calls this if IsRecording() returns true
+		 */
+		static int RecordTypes(TypeRecordList &TypesData, SymbolSpacePtr &DefaultSymbolSpace);
+
+		//! Record a list of classes in the current snapshot, then load them
+		/*! \note Only used by LoadClasses(), which calls this if IsRecording() returns true
+		 */
+		static int RecordClasses(ClassRecordList &ClassesData, SymbolSpacePtr &DefaultSymbolSpace);
+
+		//! Load the recorded definitions, exactly as they were loaded when recorded
+		/*! \return 0 if all OK
+		 *  \return -1 on error
+		 */
+		int Load(bool FastFail = false);
+
+		//! Write this snapshot to a file
+		/*! \param SourceHash The hash of the dictionary source, as returned by DictionarySourceHash()
+		 *  \return true if all OK
+		 */
+		bool Write(const char *FileName, UInt32 SourceHash);
+
+		//! Read a snapshot from a file
+		/*! \param SourceHash The hash of the dictionary source that the snapshot must have been made from
+		 *  \param CheckSource False if the snapshot is to be used whatever it was made from
+		 *  \return NULL if the file is not a valid snapshot of the right version and source
+		 */
+		static DictionarySnapshotPtr Read(const char *FileName, UInt32 SourceHash, bool CheckSource = true);
+
+		//! Determine if a file is a binary dictionary snapshot rather than an XML dictionary
+		static bool IsSnapshotFile(const char *FileName);
+
+	protected:
+		//! Append the serialized form of a type record, and its children, to the data
+		void AddTypeRecord(TypeRecordPtr &Record);
+
+		//! Append the serialized form of a class record, and its children, to the data
+		void AddClassRecord(ClassRecordPtr &Record);
+
+	private:
+		//! Prevent copy construction
+		DictionarySnapshot(const DictionarySnapshot &);
+	};
+
+
+	//! Calculate the hash used to match a snapshot to the XML dictionary it was made from
+	/*! The hash covers the contents of the XML file and the loading options that affect the definitions loaded.
+	 *  \param XMLFilePath The full path of the XML dictionary file
+	 *  \return The hash, or 0 if the file cannot be read
+	 */
+	UInt32 DictionarySourceHash(std::string XMLFilePath, SymbolSpacePtr DefaultSymbolSpace, std::string Application);
+
+	//! Load an XML dictionary and write a binary snapshot of it
+	/*! \return 0 if all OK
+	 *  \return -1 on error
+	 *  \note The dictionary is loaded as well as stored in the snapshot
+	 */
+	int WriteDictionarySnapshot(const char *DictFile, const char *SnapshotFile, SymbolSpacePtr DefaultSymbolSpace = MXFLibSymbols, std::string Application = "");
+
+	//! Load a dictionary from a binary snapshot, if a valid one exists for the given dictionary
+	/*! If DictFile is itself a snapshot it is loaded. Otherwise a snapshot with the same path as DictFile followed
+	 *  by DictionarySnapshotSuffix is loaded, as long as it was made from the current version of DictFile.
+	 *  \param Result Set to the result of loading the dictionary from the snapshot, if one is used
+	 *  \return true if a snapshot was used, false if the XML dictionary needs to be loaded
+	 */
+	bool LoadDictionarySnapshot(const char *DictFile, SymbolSpacePtr DefaultSymbolSpace, std::string Application, bool FastFail, int &Result);
+
+	//! Enable or disable the automatic use of snapshots in LoadDictionary() (enabled by default)
+	void SetDictionarySnapshots(bool Enable);
+}
+
+#endif // MXFLIB__DICTCACHE_H
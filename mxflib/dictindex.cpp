@@ -0,0 +1,92 @@
+/*! \file	dictindex.cpp
+ *	\brief	Implementation of lookups in static perfect-hash indexes of a dictionary
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Determine if an indexed key matches a key being searched for, with the rules of UL::Matches()
+	bool KeyMatches(const UInt8 *Stored, const UInt8 *Key)
+	{
+		if(memcmp(&Stored[8], &Key[8], 8) != 0) return false;
+		if(Stored[6] != Key[6]) return false;
+		if((Stored[5] != Key[5]) && (Stored[4] != 0x02)) return false;
+		return memcmp(Stored, Key, 5) == 0;
+	}
+}
+
+
+//! Find the entry for a UL
+const DictIndexEntry *DictIndex::Find(const UL &Key) const
+{
+	if(!EntryCount) return NULL;
+
+	const UInt8 *KeyData = Key.GetValue();
+	UInt32 Hash = DictIndexHash(KeyData);
+	UInt32 Seed = ULSeeds[DictIndexMix(Hash, 0) % ULBuckets];
+	const DictIndexEntry *Ret = &Entries[DictIndexMix(Hash, Seed) % EntryCount];
+
+	return KeyMatches(Ret->Key, KeyData) ? Ret : NULL;
+}
+
+
+//! Find the entry for a top-level symbol name
+const DictIndexEntry *DictIndex::Find(const char *Name) const
+{
+	if(!NameCount) return NULL;
+
+	UInt32 Hash = DictIndexHash(Name);
+	UInt32 Seed = NameSeeds[DictIndexMix(Hash, 0) % NameBuckets];
+	const DictIndexEntry *Ret = &Entries[NameSlots[DictIndexMix(Hash, Seed) % NameCount]];
+
+	return (strcmp(Ret->Name, Name) == 0) ? Ret : NULL;
+}
+
+
+//! Find the child of a set with a given local tag
+const DictIndexEntry *DictIndex::FindChild(const DictIndexEntry *Set, Tag LocalTag) const
+{
+	if((!Set) || (!Set->ChildCount)) return NULL;
+
+	// Binary search the set's block of children, which are sorted by tag
+	const DictIndexChild *First = &Children[Set->FirstChild];
+	UInt32 Low = 0;
+	UInt32 High = Set->ChildCount;
+	while(Low < High)
+	{
+		UInt32 Mid = (Low + High) / 2;
+		if(First[Mid].LocalTag < LocalTag) Low = Mid + 1;
+		else High = Mid;
+	}
+
+	if((Low < Set->ChildCount) && (First[Low].LocalTag == LocalTag)) return &Entries[First[Low].Entry];
+	return NULL;
+}
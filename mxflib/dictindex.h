@@ -0,0 +1,147 @@
+/*! \file	dictindex.h
+ *	\brief	Definition of static perfect-hash indexes of a dictionary, generated by dictconvert
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  When run with -i, dictconvert writes a DictIndex alongside the compile-time dictionary. This holds
+ *  every UL-identified type, label and class of the dictionary in a table ordered by a minimal perfect
+ *  hash of its UL, with a second perfect hash giving the entry for each top-level symbol name and, for
+ *  each set, its child items (including those inherited from base sets) sorted by local tag.
+ *
+ *  All of this is constant data, so it sits in read-only memory and nothing is built at startup.
+ *  Code that only needs to recognise a key, or to find the name or local tag of a known item, can use
+ *  it with a single hashed probe and one compare, without loading the dictionary at all.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#ifndef MXFLIB__DICTINDEX_H
+#define MXFLIB__DICTINDEX_H
+
+namespace mxflib
+{
+	//! The kinds of item in a DictIndex
+	enum DictIndexKind
+	{
+		DictIndexType = 0,						//!< A type definition
+		DictIndexLabel,							//!< A label
+		DictIndexSet,							//!< A local or universal set
+		DictIndexPack,							//!< A fixed or variable pack
+		DictIndexMultiple,						//!< An array or batch class
+		DictIndexItem							//!< Any other class, including the items of sets and packs
+	};
+
+	//! One UL-identified item of a DictIndex
+	struct DictIndexEntry
+	{
+		UInt8 Key[16];							//!< The UL of the item
+		const char *Name;						//!< The symbol name of the item
+		const char *Parent;						//!< The name of the set, pack or multiple holding this item, or NULL if top-level
+		Tag LocalTag;							//!< The local tag of the item, or 0 if none
+		UInt8 Kind;								//!< The DictIndexKind of the item
+		UInt32 FirstChild;						//!< Index in the child table of the first child of a set
+		UInt32 ChildCount;						//!< The number of children of a set, including inherited ones
+	};
+
+	//! One child of a set in a DictIndex
+	struct DictIndexChild
+	{
+		Tag LocalTag;							//!< The local tag of the child
+		UInt32 Entry;							//!< The index of the child's DictIndexEntry
+	};
+
+	//! A static perfect-hash index of the items of a dictionary
+	/*! The entries are held in the order of their slots in the UL hash, so a UL is found by hashing it into
+	 *  a bucket, mixing the hash with that bucket's seed to give a slot, and comparing the one entry there.
+	 *  Names are found the same way, with a slot table giving the entry for each name slot.
+	 *  \note This is an aggregate so that an index written by dictconvert is constant-initialised
+	 */
+	struct DictIndex
+	{
+		const DictIndexEntry *Entries;			//!< The entries, in UL slot order
+		UInt32 EntryCount;						//!< The number of entries
+		const UInt32 *ULSeeds;					//!< The seed of each bucket of the UL hash
+		UInt32 ULBuckets;						//!< The number of buckets of the UL hash
+		const UInt32 *NameSeeds;				//!< The seed of each bucket of the name hash
+		UInt32 NameBuckets;						//!< The number of buckets of the name hash
+		const UInt32 *NameSlots;				//!< The entry for each slot of the name hash
+		UInt32 NameCount;						//!< The number of names indexed
+		const DictIndexChild *Children;			//!< Children of all sets, in blocks per set sorted by local tag
+
+		//! Find the entry for a UL
+		/*! Keys are matched with the rules of UL::Matches(), so the version number is ignored
+		 *  \return The entry, or NULL if the UL is not in the index
+		 */
+		const DictIndexEntry *Find(const UL &Key) const;
+
+		//! Find the entry for a top-level symbol name
+		/*! \return The entry, or NULL if no top-level item has this name */
+		const DictIndexEntry *Find(const char *Name) const;
+
+		//! Find the child of a set with a given local tag
+		/*! \return The child's entry, or NULL if the set has no child with this tag */
+		const DictIndexEntry *FindChild(const DictIndexEntry *Set, Tag LocalTag) const;
+	};
+
+
+	//! Hash a UL for a DictIndex
+	/*! The version byte is not hashed, nor is the byte that gives the coding of group keys, so that keys
+	 *  that UL::Matches() treats as the same always hash the same
+	 */
+	inline UInt32 DictIndexHash(const UInt8 *Key)
+	{
+		// 32-bit FNV-1a
+		UInt32 Ret = 0x811c9dc5;
+		for(int i=0; i<16; i++)
+		{
+			if((i == 7) || ((i == 5) && (Key[4] == 0x02))) continue;
+			Ret = (Ret ^ Key[i]) * 0x01000193;
+		}
+
+		return Ret;
+	}
+
+	//! Hash a symbol name for a DictIndex
+	inline UInt32 DictIndexHash(const char *Name)
+	{
+		UInt32 Ret = 0x811c9dc5;
+		while(*Name) Ret = (Ret ^ static_cast<UInt8>(*Name++)) * 0x01000193;
+
+		return Ret;
+	}
+
+	//! Mix the hash of a key with a seed, giving its bucket for seed 0 or its slot for the seed of that bucket
+	/*! DRAGONS: The result is used modulo sizes that are not powers of two, so all bits must be well mixed */
+	inline UInt32 DictIndexMix(UInt32 Hash, UInt32 Seed)
+	{
+		UInt32 Ret = Hash ^ (Seed * 0x9e3779b9);
+		Ret ^= Ret >> 16;
+		Ret *= 0x85ebca6b;
+		Ret ^= Ret >> 13;
+		Ret *= 0xc2b2ae35;
+		Ret ^= Ret >> 16;
+		return Ret;
+	}
+}
+
+#endif // MXFLIB__DICTINDEX_H
@@ -0,0 +1,538 @@
+/*! \file	digest.cpp
+ *	\brief	Implementation of message digest hashes and of the classes that digest essence as it is wrapped or unwrapped
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Rotate a 32-bit value left
+	inline UInt32 Rotl32(UInt32 Value, int Bits) { return (Value << Bits) | (Value >> (32 - Bits)); }
+
+	//! Rotate a 64-bit value left
+	inline UInt64 Rotl64(UInt64 Value, int Bits) { return (Value << Bits) | (Value >> (64 - Bits)); }
+
+	//! Read a little-endian 32-bit value
+	inline UInt32 ReadLE32(const UInt8 *Data)
+	{
+		return (UInt32)Data[0] | ((UInt32)Data[1] << 8) | ((UInt32)Data[2] << 16) | ((UInt32)Data[3] << 24);
+	}
+
+	//! Read a little-endian 64-bit value
+	inline UInt64 ReadLE64(const UInt8 *Data)
+	{
+		return (UInt64)ReadLE32(Data) | ((UInt64)ReadLE32(&Data[4]) << 32);
+	}
+
+	//! Read a big-endian 32-bit value
+	inline UInt32 ReadBE32(const UInt8 *Data)
+	{
+		return ((UInt32)Data[0] << 24) | ((UInt32)Data[1] << 16) | ((UInt32)Data[2] << 8) | (UInt32)Data[3];
+	}
+
+
+	//! Hash one 64-byte block into an MD5 state
+	void MD5Block(UInt32 *State, const UInt8 *Data)
+	{
+		static const UInt32 K[64] =
+		{
+			0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+			0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+			0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+			0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+			0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+			0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+			0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+			0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+		};
+
+		static const int Shift[64] =
+		{
+			7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+			5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+			4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+			6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+		};
+
+		UInt32 M[16];
+		int i;
+		for(i = 0; i < 16; i++) M[i] = ReadLE32(&Data[i * 4]);
+
+		UInt32 A = State[0];
+		UInt32 B = State[1];
+		UInt32 C = State[2];
+		UInt32 D = State[3];
+
+		for(i = 0; i < 64; i++)
+		{
+			UInt32 F;
+			int g;
+			if(i < 16)
+			{
+				F = (B & C) | (~B & D);
+				g = i;
+			}
+			else if(i < 32)
+			{
+				F = (D & B) | (~D & C);
+				g = (5 * i + 1) & 15;
+			}
+			else if(i < 48)
+			{
+				F = B ^ C ^ D;
+				g = (3 * i + 5) & 15;
+			}
+			else
+			{
+				F = C ^ (B | ~D);
+				g = (7 * i) & 15;
+			}
+
+			UInt32 Temp = D;
+			D = C;
+			C = B;
+			B = B + Rotl32(A + F + K[i] + M[g], Shift[i]);
+			A = Temp;
+		}
+
+		State[0] += A;
+		State[1] += B;
+		State[2] += C;
+		State[3] += D;
+	}
+
+
+	//! Hash one 64-byte block into an SHA-1 state
+	void SHA1Block(UInt32 *State, const UInt8 *Data)
+	{
+		UInt32 W[80];
+		int i;
+		for(i = 0; i < 16; i++) W[i] = ReadBE32(&Data[i * 4]);
+		for(i = 16; i < 80; i++) W[i] = Rotl32(W[i-3] ^ W[i-8] ^ W[i-14] ^ W[i-16], 1);
+
+		UInt32 A = State[0];
+		UInt32 B = State[1];
+		UInt32 C = State[2];
+		UInt32 D = State[3];
+		UInt32 E = State[4];
+
+		for(i = 0; i < 80; i++)
+		{
+			UInt32 F, K;
+			if(i < 20)
+			{
+				F = (B & C) | (~B & D);
+				K = 0x5a827999;
+			}
+			else if(i < 40)
+			{
+				F = B ^ C ^ D;
+				K = 0x6ed9eba1;
+			}
+			else if(i < 60)
+			{
+				F = (B & C) | (B & D) | (C & D);
+				K = 0x8f1bbcdc;
+			}
+			else
+			{
+				F = B ^ C ^ D;
+				K = 0xca62c1d6;
+			}
+
+			UInt32 Temp = Rotl32(A, 5) + F + E + K + W[i];
+			E = D;
+			D = C;
+			C = Rotl32(B, 30);
+			B = A;
+			A = Temp;
+		}
+
+		State[0] += A;
+		State[1] += B;
+		State[2] += C;
+		State[3] += D;
+		State[4] += E;
+	}
+
+
+	//! Add bytes to a 64-byte block hash, calling BlockFunc for each complete block
+	/*! This is shared by MD5 and SHA-1, which differ only in their block function and state size */
+	template<class BlockFunc> void HashBlocks(UInt32 *State, UInt64 &Count, UInt8 *Block, size_t Size, const UInt8 *Data, BlockFunc Func)
+	{
+		size_t Held = static_cast<size_t>(Count & 63);
+		Count += Size;
+
+		// Complete any partial block first
+		if(Held)
+		{
+			size_t Bytes = 64 - Held;
+			if(Bytes > Size) Bytes = Size;
+
+			memcpy(&Block[Held], Data, Bytes);
+			Data += Bytes;
+			Size -= Bytes;
+
+			if((Held + Bytes) < 64) return;
+			Func(State, Block);
+		}
+
+		// Hash whole blocks straight from the data
+		while(Size >= 64)
+		{
+			Func(State, Data);
+			Data += 64;
+			Size -= 64;
+		}
+
+		if(Size) memcpy(Block, Data, Size);
+	}
+
+
+	//! Pad the final block of an MD5 or SHA-1 hash, as a bit count in the given byte order
+	template<class BlockFunc> void FinishBlocks(UInt32 *State, UInt64 Count, const UInt8 *Block, bool BigEndian, BlockFunc Func)
+	{
+		UInt8 Final[128];
+		size_t Held = static_cast<size_t>(Count & 63);
+		memcpy(Final, Block, Held);
+
+		// Add the single '1' bit then zeros up to the length, which fills the last 8 bytes of a block
+		Final[Held] = 0x80;
+		size_t End = (Held < 56) ? 64 : 128;
+		memset(&Final[Held + 1], 0, End - Held - 1);
+
+		UInt64 Bits = Count * 8;
+		int i;
+		for(i = 0; i < 8; i++)
+		{
+			UInt8 Byte = static_cast<UInt8>(Bits >> (8 * i));
+			if(BigEndian) Final[End - 1 - i] = Byte; else Final[End - 8 + i] = Byte;
+		}
+
+		Func(State, Final);
+		if(End == 128) Func(State, &Final[64]);
+	}
+
+
+	/* xxHash64 primes */
+	const UInt64 XXH_Prime1 = UINT64_C(0x9E3779B185EBCA87);
+	const UInt64 XXH_Prime2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+	const UInt64 XXH_Prime3 = UINT64_C(0x165667B19E3779F9);
+	const UInt64 XXH_Prime4 = UINT64_C(0x85EBCA77C2B2AE63);
+	const UInt64 XXH_Prime5 = UINT64_C(0x27D4EB2F165667C5);
+
+	//! Add one 8-byte lane to an xxHash64 accumulator
+	inline UInt64 XXHRound(UInt64 Acc, UInt64 Input)
+	{
+		Acc += Input * XXH_Prime2;
+		Acc = Rotl64(Acc, 31);
+		return Acc * XXH_Prime1;
+	}
+
+	//! Merge an accumulator into the final xxHash64 value
+	inline UInt64 XXHMerge(UInt64 Acc, UInt64 Value)
+	{
+		Acc ^= XXHRound(0, Value);
+		return Acc * XXH_Prime1 + XXH_Prime4;
+	}
+}
+
+
+//! Initialize an MD5 hash
+HashMD5::HashMD5() : Count(0)
+{
+	State[0] = 0x67452301;
+	State[1] = 0xefcdab89;
+	State[2] = 0x98badcfe;
+	State[3] = 0x10325476;
+}
+
+
+//! Add the given data to the current hash being calculated
+void HashMD5::HashData(size_t Size, const UInt8 *Data)
+{
+	HashBlocks(State, Count, Block, Size, Data, MD5Block);
+}
+
+
+//! Get the hash of all data so far
+DataChunkPtr HashMD5::GetHash(void)
+{
+	UInt32 Final[4];
+	memcpy(Final, State, sizeof(Final));
+	FinishBlocks(Final, Count, Block, false, MD5Block);
+
+	DataChunkPtr Ret = new DataChunk(16);
+	int i;
+	for(i = 0; i < 16; i++) Ret->Data[i] = static_cast<UInt8>(Final[i / 4] >> (8 * (i % 4)));
+
+	return Ret;
+}
+
+
+//! Initialize an SHA-1 hash
+HashSHA1::HashSHA1() : Count(0)
+{
+	State[0] = 0x67452301;
+	State[1] = 0xefcdab89;
+	State[2] = 0x98badcfe;
+	State[3] = 0x10325476;
+	State[4] = 0xc3d2e1f0;
+}
+
+
+//! Add the given data to the current hash being calculated
+void HashSHA1::HashData(size_t Size, const UInt8 *Data)
+{
+	HashBlocks(State, Count, Block, Size, Data, SHA1Block);
+}
+
+
+//! Get the hash of all data so far
+DataChunkPtr HashSHA1::GetHash(void)
+{
+	UInt32 Final[5];
+	memcpy(Final, State, sizeof(Final));
+	FinishBlocks(Final, Count, Block, true, SHA1Block);
+
+	DataChunkPtr Ret = new DataChunk(20);
+	int i;
+	for(i = 0; i < 20; i++) Ret->Data[i] = static_cast<UInt8>(Final[i / 4] >> (8 * (3 - (i % 4))));
+
+	return Ret;
+}
+
+
+//! Initialize an xxHash64 hash
+HashXXH64::HashXXH64() : Count(0)
+{
+	State[0] = XXH_Prime1 + XXH_Prime2;
+	State[1] = XXH_Prime2;
+	State[2] = 0;
+	State[3] = static_cast<UInt64>(0) - XXH_Prime1;
+}
+
+
+//! Add the given data to the current hash being calculated
+void HashXXH64::HashData(size_t Size, const UInt8 *Data)
+{
+	size_t Held = static_cast<size_t>(Count & 31);
+	Count += Size;
+
+	// Complete any partial stripe first
+	if(Held)
+	{
+		size_t Bytes = 32 - Held;
+		if(Bytes > Size) Bytes = Size;
+
+		memcpy(&Block[Held], Data, Bytes);
+		Data += Bytes;
+		Size -= Bytes;
+
+		if((Held + Bytes) < 32) return;
+
+		State[0] = XXHRound(State[0], ReadLE64(&Block[0]));
+		State[1] = XXHRound(State[1], ReadLE64(&Block[8]));
+		State[2] = XXHRound(State[2], ReadLE64(&Block[16]));
+		State[3] = XXHRound(State[3], ReadLE64(&Block[24]));
+	}
+
+	// Hash whole stripes straight from the data, keeping the accumulators in registers
+	if(Size >= 32)
+	{
+		UInt64 V1 = State[0];
+		UInt64 V2 = State[1];
+		UInt64 V3 = State[2];
+		UInt64 V4 = State[3];
+
+		do
+		{
+			V1 = XXHRound(V1, ReadLE64(&Data[0]));
+			V2 = XXHRound(V2, ReadLE64(&Data[8]));
+			V3 = XXHRound(V3, ReadLE64(&Data[16]));
+			V4 = XXHRound(V4, ReadLE64(&Data[24]));
+			Data += 32;
+			Size -= 32;
+		} while(Size >= 32);
+
+		State[0] = V1;
+		State[1] = V2;
+		State[2] = V3;
+		State[3] = V4;
+	}
+
+	if(Size) memcpy(Block, Data, Size);
+}
+
+
+//! Get the hash of all data so far
+DataChunkPtr HashXXH64::GetHash(void)
+{
+	UInt64 Hash;
+	if(Count >= 32)
+	{
+		Hash = Rotl64(State[0], 1) + Rotl64(State[1], 7) + Rotl64(State[2], 12) + Rotl64(State[3], 18);
+		Hash = XXHMerge(Hash, State[0]);
+		Hash = XXHMerge(Hash, State[1]);
+		Hash = XXHMerge(Hash, State[2]);
+		Hash = XXHMerge(Hash, State[3]);
+	}
+	else
+	{
+		Hash = XXH_Prime5;
+	}
+
+	Hash += Count;
+
+	// Add the bytes of any partial stripe
+	size_t Held = static_cast<size_t>(Count & 31);
+	const UInt8 *p = Block;
+	while(Held >= 8)
+	{
+		Hash ^= XXHRound(0, ReadLE64(p));
+		Hash = Rotl64(Hash, 27) * XXH_Prime1 + XXH_Prime4;
+		p += 8;
+		Held -= 8;
+	}
+
+	if(Held >= 4)
+	{
+		Hash ^= static_cast<UInt64>(ReadLE32(p)) * XXH_Prime1;
+		Hash = Rotl64(Hash, 23) * XXH_Prime2 + XXH_Prime3;
+		p += 4;
+		Held -= 4;
+	}
+
+	while(Held--)
+	{
+		Hash ^= static_cast<UInt64>(*p++) * XXH_Prime5;
+		Hash = Rotl64(Hash, 11) * XXH_Prime1;
+	}
+
+	// Final avalanche
+	Hash ^= Hash >> 33;
+	Hash *= XXH_Prime2;
+	Hash ^= Hash >> 29;
+	Hash *= XXH_Prime3;
+	Hash ^= Hash >> 32;
+
+	DataChunkPtr Ret = new DataChunk(8);
+	int i;
+	for(i = 0; i < 8; i++) Ret->Data[i] = static_cast<UInt8>(Hash >> (8 * (7 - i)));
+
+	return Ret;
+}
+
+
+//! Build a hash for a named digest algorithm: "md5", "sha1" or "xxh64"
+HashPtr mxflib::MakeDigestHash(std::string Algorithm)
+{
+	std::string Name;
+	std::string::iterator it = Algorithm.begin();
+	while(it != Algorithm.end())
+	{
+		// Ignore case and any hyphen, so "SHA-1" is accepted
+		if(*it != '-') Name += static_cast<char>(tolower(*it));
+		it++;
+	}
+
+	if(Name == "md5") return new HashMD5;
+	if(Name == "sha1") return new HashSHA1;
+	if((Name == "xxh64") || (Name == "xxhash64")) return new HashXXH64;
+
+	return NULL;
+}
+
+
+//! Get a digest as a string of lower-case hex digits, as printed by tools such as md5sum
+std::string mxflib::DigestToString(DataChunkPtr Digest)
+{
+	static const char Digits[] = "0123456789abcdef";
+
+	std::string Ret;
+	if(!Digest) return Ret;
+
+	size_t i;
+	for(i = 0; i < Digest->Size; i++)
+	{
+		Ret += Digits[Digest->Data[i] >> 4];
+		Ret += Digits[Digest->Data[i] & 0x0f];
+	}
+
+	return Ret;
+}
+
+
+//! Construct a digest using a given algorithm, as accepted by MakeDigestHash()
+EssenceDigest::EssenceDigest(std::string Algorithm) : Algorithm(Algorithm), Size(0), CurrentSize(0), CurrentPartition(-1)
+{
+	Whole = MakeDigestHash(Algorithm);
+	if(!Whole) error("Unknown digest algorithm \"%s\"\n", Algorithm.c_str());
+}
+
+
+//! Add bytes of essence to the digest
+void EssenceDigest::HashData(size_t DataSize, const UInt8 *Data)
+{
+	if((!Whole) || (!DataSize)) return;
+
+	Whole->HashData(DataSize, Data);
+	Size += DataSize;
+
+	if(!Current) Current = MakeDigestHash(Algorithm);
+	Current->HashData(DataSize, Data);
+	CurrentSize += DataSize;
+}
+
+
+//! Start the digest of a new partition, at a given file position
+void EssenceDigest::StartPartition(Position Partition /*=-1*/)
+{
+	EndPartition();
+
+	CurrentPartition = Partition;
+}
+
+
+//! End the digest of the current partition, listing it if any data was hashed
+void EssenceDigest::EndPartition(void)
+{
+	if(!Current) return;
+
+	PartitionDigest Entry;
+	Entry.Partition = CurrentPartition;
+	Entry.Size = CurrentSize;
+	Entry.Digest = Current->GetHash();
+	Partitions.push_back(Entry);
+
+	Current = NULL;
+	CurrentSize = 0;
+}
@@ -0,0 +1,198 @@
+/*! \file	digest.h
+ *	\brief	Definition of message digest hashes and of the classes that digest essence as it is wrapped or unwrapped
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Quality control of MXF files often needs a digest of the essence of each track. Rather than read each file again
+ *  once it is written, an EssenceDigest may be attached to an EssenceSource (or to a GCWriter stream) so that the data
+ *  is hashed as it passes through GCWriter::Flush(), or wrapped around an EssenceSink with a DigestSink so that data
+ *  is hashed as it is unwrapped. Each EssenceDigest holds a digest of the whole stream and one for the data of each
+ *  partition.
+ *
+ *  MD5 and SHA-1 are provided for compliance with existing checksum lists, along with the much faster xxHash64.
+ *  All are built in, so no external library is required.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__DIGEST_H
+#define MXFLIB__DIGEST_H
+
+namespace mxflib
+{
+	//! MD5 message digest (RFC 1321)
+	/*! \note GetHash() may be called at any time, it does not end the hash */
+	class HashMD5 : public Hash_Base
+	{
+	protected:
+		UInt32 State[4];					//!< The current hash state
+		UInt64 Count;						//!< The number of bytes hashed so far
+		UInt8 Block[64];					//!< The bytes of an incomplete block
+
+	public:
+		HashMD5();
+
+		void HashData(size_t Size, const UInt8 *Data);
+		DataChunkPtr GetHash(void);
+	};
+
+
+	//! SHA-1 message digest (FIPS 180-4)
+	/*! \note GetHash() may be called at any time, it does not end the hash */
+	class HashSHA1 : public Hash_Base
+	{
+	protected:
+		UInt32 State[5];					//!< The current hash state
+		UInt64 Count;						//!< The number of bytes hashed so far
+		UInt8 Block[64];					//!< The bytes of an incomplete block
+
+	public:
+		HashSHA1();
+
+		void HashData(size_t Size, const UInt8 *Data);
+		DataChunkPtr GetHash(void);
+	};
+
+
+	//! xxHash64 non-cryptographic hash, with a seed of zero, giving the 8-byte hash most significant byte first
+	/*! This is many times faster than MD5 or SHA-1, so is the best choice where a cryptographic hash is not required
+	 *  \note GetHash() may be called at any time, it does not end the hash
+	 */
+	class HashXXH64 : public Hash_Base
+	{
+	protected:
+		UInt64 State[4];					//!< The four accumulators
+		UInt64 Count;						//!< The number of bytes hashed so far
+		UInt8 Block[32];					//!< The bytes of an incomplete stripe
+
+	public:
+		HashXXH64();
+
+		void HashData(size_t Size, const UInt8 *Data);
+		DataChunkPtr GetHash(void);
+	};
+
+
+	//! Build a hash for a named digest algorithm: "md5", "sha1" or "xxh64"
+	/*! \return NULL if the algorithm is not known */
+	HashPtr MakeDigestHash(std::string Algorithm);
+
+	//! Get a digest as a string of lower-case hex digits, as printed by tools such as md5sum
+	std::string DigestToString(DataChunkPtr Digest);
+
+
+	//! A digest of a stream of essence, and of the part of it in each partition
+	/*! The whole digest and the partition digests use the same algorithm. A new partition digest is started by each
+	 *  call to StartPartition(), and partitions holding no data for this stream are not listed.
+	 */
+	class EssenceDigest : public RefCount<EssenceDigest>
+	{
+	public:
+		//! The digest of the data in one partition
+		struct PartitionDigest
+		{
+			Position Partition;				//!< The file position of the partition pack, or -1 if not known
+			UInt64 Size;					//!< The number of bytes hashed in this partition
+			DataChunkPtr Digest;			//!< The digest of those bytes
+		};
+
+		//! List of partition digests, in the order written
+		typedef std::list<PartitionDigest> PartitionDigestList;
+
+	protected:
+		std::string Algorithm;				//!< The name of the digest algorithm
+		HashPtr Whole;						//!< The hash of the whole stream, or NULL if the algorithm is not known
+		HashPtr Current;					//!< The hash of the current partition, or NULL if no data yet hashed in it
+		UInt64 Size;						//!< The number of bytes hashed
+		UInt64 CurrentSize;					//!< The number of bytes hashed in the current partition
+		Position CurrentPartition;			//!< The position of the current partition, or -1 if not known
+		PartitionDigestList Partitions;		//!< The digests of completed partitions
+
+	public:
+		//! Construct a digest using a given algorithm, as accepted by MakeDigestHash()
+		EssenceDigest(std::string Algorithm);
+
+		//! Determine if the algorithm is known, else no digest is made
+		bool IsValid(void) { return Whole ? true : false; }
+
+		//! Get the name of the algorithm
+		std::string GetAlgorithm(void) { return Algorithm; }
+
+		//! Add bytes of essence to the digest
+		void HashData(size_t Size, const UInt8 *Data);
+
+		//! Add bytes of essence to the digest
+		void HashData(const DataChunk &Data) { HashData(Data.Size, Data.Data); }
+
+		//! Start the digest of a new partition, at a given file position
+		void StartPartition(Position Partition = -1);
+
+		//! End the digest of the current partition, listing it if any data was hashed
+		void EndPartition(void);
+
+		//! Get the digest of all bytes hashed so far
+		DataChunkPtr GetDigest(void) { return Whole ? Whole->GetHash() : DataChunkPtr(); }
+
+		//! Get the number of bytes hashed so far
+		UInt64 GetSize(void) { return Size; }
+
+		//! Get the digests of each partition, ending the current partition
+		PartitionDigestList &GetPartitionDigests(void) { EndPartition(); return Partitions; }
+	};
+
+	// EssenceDigestPtr is declared in essence.h, as essence sources may hold a digest
+
+
+	//! An EssenceSink that adds all data to an EssenceDigest before passing it on to another sink
+	class DigestSink : public EssenceSink
+	{
+	protected:
+		EssenceSinkPtr Sink;				//!< The sink that receives the data
+		EssenceDigestPtr Digest;			//!< The digest of the data
+
+	public:
+		//! Construct a sink passing data to a given sink (or to no sink if NULL) and hashing it in a given digest
+		DigestSink(EssenceSinkPtr Sink, EssenceDigestPtr Digest) : Sink(Sink), Digest(Digest) {}
+
+		virtual bool PutEssenceData(UInt8 const *Buffer, size_t BufferSize, bool EndOfItem = true)
+		{
+			Digest->HashData(BufferSize, Buffer);
+			return Sink ? Sink->PutEssenceData(Buffer, BufferSize, EndOfItem) : true;
+		}
+
+		virtual bool EndOfData(void) { return Sink ? Sink->EndOfData() : true; }
+
+		virtual std::string Name(void) { return Sink ? Sink->Name() : "DigestSink"; }
+
+		virtual Int32 GetInt(std::string Query) { return Sink ? Sink->GetInt(Query) : 0; }
+		virtual std::string GetString(std::string Query) { return Sink ? Sink->GetString(Query) : ""; }
+		virtual bool SetInt(std::string Text, Int32 Value) { return Sink ? Sink->SetInt(Text, Value) : false; }
+		virtual bool SetString(std::string Text, std::string Value) { return Sink ? Sink->SetString(Text, Value) : false; }
+
+		//! Get the digest
+		EssenceDigestPtr GetDigest(void) { return Digest; }
+	};
+}
+
+#endif // MXFLIB__DIGEST_H
@@ -53,6 +53,14 @@ EssenceParser::EssenceSubParserFactoryList EssenceParser::EPList;
 bool EssenceParser::Inited = false;
 
 
+//! The number of bytes read from the start of each file to identify its essence
+size_t EssenceParser::ProbeHeadSize = 64 * 1024;
+
+
+//! The number of bytes read from the end of each file to identify its essence
+size_t EssenceParser::ProbeTailSize = 4 * 1024;
+
+
 // Build an essence parser with all known sub-parsers
 void EssenceParser::Init()
 {
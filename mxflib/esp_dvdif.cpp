@@ -59,6 +59,7 @@ namespace
 	const UInt32 ID_strh = 0x73747268;		//! "strh"
 	const UInt32 ID_strf = 0x73747266;		//! "strf"
 	const UInt32 ID_indx = 0x696e6478;		//! "indx"
+	const UInt32 ID_idx1 = 0x69647831;		//! "idx1"
 
 	const UInt32 ID_dvsd = 0x64767364;		//! "dvsd"
 	const UInt32 ID_DVSD = 0x44565344;		//! "DVSD"
@@ -460,6 +461,35 @@ EssenceStreamDescriptorList DV_DIF_EssenceSubParser::IdentifyEssence(FileHandle
 }
 
 
+//! Check the probe data of a file to see if this parser may be able to identify the essence
+bool DV_DIF_EssenceSubParser::CanIdentify(const EssenceProbe &Probe)
+{
+	if(!Probe.HasHead(12)) return true;
+	if(Probe.GetHeadSize() < 12) return false;
+
+	const UInt8 *Buffer = Probe.GetHead();
+
+	// A RIFF file must be an AVI file, the rest is left to IdentifyEssence()
+	if(memcmp(Buffer, "RIFF", 4) == 0) return memcmp(&Buffer[8], "AVI ", 4) == 0;
+
+	// Otherwise this must be a raw DIF file, so we check the same section IDs as IdentifyEssence() if we have the first DIF sequence
+	if(!Probe.HasHead(80 * 150)) return true;
+	if(Probe.GetHeadSize() < (80 * 150)) return false;
+
+	if((Buffer[0] & 0xe0) != 0x00) return false;
+	if(((Buffer[80] & 0xe0) != 0x20) || ((Buffer[160] & 0xe0) != 0x20)) return false;
+	if(((Buffer[240] & 0xe0) != 0x40) || ((Buffer[320] & 0xe0) != 0x40) || ((Buffer[400] & 0xe0) != 0x40)) return false;
+
+	int i;
+	for(i=0; i<144; i++)
+	{
+		if((Buffer[i * 80 + 480] & 0xe0) != (((i & 0x0f) == 0) ? 0x60 : 0x80)) return false;
+	}
+
+	return true;
+}
+
+
 //! Examine the open file and return the wrapping options known by this parser
 /*! \param InFile The open file to examine (if the descriptor does not contain enough info)
  *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
@@ -600,6 +630,10 @@ void DV_DIF_EssenceSubParser::Use(UInt32 Stream, WrappingOptionPtr &UseWrapping)
 	EditRatio = 1;
 	PictureNumber = 0;
 	CurrentPos = 0;
+
+	// Any batched data is no longer valid
+	BatchUsed = 0;
+	BatchOffset = 0;
 }
 
 
@@ -691,6 +725,9 @@ DataChunkPtr DV_DIF_EssenceSubParser::Read(FileHandle InFile, UInt32 Stream, UIn
 	if(DIFEnd != -1)
 	{
 		// Read the data
+		if((BatchFrames > 1) && (SelectedWrapping->ThisWrapType == WrappingOption::Frame)) return BatchRead(InFile, Bytes);
+
+		DiscardBatch(InFile);
 		return FileReadChunk(InFile, Bytes);
 	}
 
@@ -699,6 +736,143 @@ DataChunkPtr DV_DIF_EssenceSubParser::Read(FileHandle InFile, UInt32 Stream, UIn
 }
 
 
+//! Read data from a raw DIF stream, reading ahead by a batch of frames at a time
+/*! DV frames are a constant size within a DIF stream, so BatchFrames reads of this size are made in one go and each read is then
+ *  taken from the batch.
+ *  DRAGONS: Each read is a copy-on-write slice of the batch, and as the caller may hold on to the data (for example in a
+ *           prefetch queue) the batch is given a buffer of its own before it is refilled
+ */
+DataChunkPtr DV_DIF_EssenceSubParser::BatchRead(FileHandle InFile, size_t Bytes)
+{
+	// Refill the batch if this read is not all within it
+	if((BatchOffset + Bytes) > BatchUsed)
+	{
+		// Move back to the first byte not yet returned from a partly used batch
+		DiscardBatch(InFile);
+
+		Position Pos = static_cast<Position>(FileTell(InFile));
+
+		size_t BatchSize = Bytes * BatchFrames;
+		if((DIFEnd - Pos) < static_cast<Position>(BatchSize)) BatchSize = static_cast<size_t>(DIFEnd - Pos);
+		if(BatchSize < Bytes) BatchSize = Bytes;
+
+		if(!Batch) Batch = new DataChunk(BatchSize);
+		else if(Batch->Size < BatchSize) Batch->Resize(BatchSize);
+
+		// The batch is read directly into its buffer, so don't overwrite the data still shared with earlier reads
+		Batch->MakeWritable(false);
+
+		BatchStart = Pos;
+		BatchUsed = static_cast<size_t>(FileRead(InFile, Batch->Data, BatchSize));
+		BatchOffset = 0;
+
+		// Return what we can at the end of the file
+		if(Bytes > BatchUsed) Bytes = BatchUsed;
+	}
+
+	DataChunkPtr Ret = Batch->Slice(BatchOffset, Bytes);
+	BatchOffset += Bytes;
+
+	return Ret;
+}
+
+
+//! Discard any batched data not yet returned, moving the file pointer back to the first byte not returned
+void DV_DIF_EssenceSubParser::DiscardBatch(FileHandle InFile)
+{
+	if(BatchOffset < BatchUsed) FileSeek(InFile, BatchStart + BatchOffset);
+
+	BatchUsed = 0;
+	BatchOffset = 0;
+}
+
+
+//! Get a run of whole edit units in one call
+/*! Batches are only read from a frame wrapped raw DIF stream, where every frame is the same size, at the native edit rate.
+ *  Any part frame at the end of the stream is left to GetEssenceData().
+ */
+EssenceBatchPtr DV_DIF_EssenceSubParser::ESP_EssenceSource::GetEssenceBatch(size_t MaxUnits, size_t MaxBytes)
+{
+	DV_DIF_EssenceSubParser *pCaller = SmartPtr_Cast(Caller, DV_DIF_EssenceSubParser);
+
+	if((pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Frame) || (pCaller->DIFEnd == -1)) return NULL;
+	if((pCaller->SelectedEditRate.Numerator != pCaller->NativeEditRate.Numerator) || (pCaller->SelectedEditRate.Denominator != pCaller->NativeEditRate.Denominator)) return NULL;
+
+	// DRAGONS: ReadInternal() counts the frames of a read when it is sized, so a size already worked out must be read by GetEssenceData()
+	if(RemainingData || AtEndOfData || (pCaller->CachedDataSize != static_cast<size_t>(-1))) return NULL;
+
+	Started = true;
+
+	// Seek to the start of the essence on the first read, otherwise continue from the last byte returned by Read()
+	if(pCaller->PictureNumber == 0)
+	{
+		pCaller->BatchUsed = 0;
+		pCaller->BatchOffset = 0;
+		FileSeek(File, pCaller->DIFStart);
+	}
+	else
+		pCaller->DiscardBatch(File);
+
+	size_t FrameSize = static_cast<size_t>(RequestedCount * 150 * 80 * pCaller->SeqCount);
+	if(!FrameSize) return NULL;
+
+	// Only whole frames are batched, the first whatever its size
+	Position Pos = static_cast<Position>(FileTell(File));
+	Position FramesLeft = (pCaller->DIFEnd - Pos) / static_cast<Position>(FrameSize);
+	if(FramesLeft <= 0) return NULL;
+
+	size_t Frames = MaxUnits;
+	if(MaxBytes && ((MaxBytes / FrameSize) < Frames)) Frames = MaxBytes / FrameSize;
+	if(FramesLeft < static_cast<Position>(Frames)) Frames = static_cast<size_t>(FramesLeft);
+	if(Frames == 0) Frames = 1;
+
+	EssenceBatchPtr Ret = new EssenceBatch;
+	Ret->FirstPosition = pCaller->PictureNumber;
+
+	// Read all the frames at once, keeping only whole frames if the file has been cut short
+	Ret->Buffer = FileReadChunk(File, Frames * FrameSize);
+	Frames = Ret->Buffer->Size / FrameSize;
+	FileSeek(File, Pos + static_cast<Position>(Frames * FrameSize));
+	if(Frames == 0) return NULL;
+
+	Ret->Sizes.resize(Frames, FrameSize);
+	Ret->EditPoints.resize(Frames, true);
+
+	pCaller->PictureNumber += static_cast<Position>(Frames * RequestedCount);
+
+	return Ret;
+}
+
+
+//! Get the location of the rest of a clip if it is held as a single range of a file
+/*! Only a raw DIF file holds the clip this way, the DV data in an AVI file is split into chunks */
+bool DV_DIF_EssenceSubParser::ESP_EssenceSource::GetEssenceFileRange(FileHandle &InFile, Position &Start, Length &Size)
+{
+	DV_DIF_EssenceSubParser *pCaller = SmartPtr_Cast(Caller, DV_DIF_EssenceSubParser);
+
+	if((pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Clip) || (pCaller->DIFEnd == -1)) return false;
+	if(RemainingData) return false;
+
+	Started = true;
+
+	// Work out how much is left from the first byte not yet returned
+	pCaller->DiscardBatch(File);
+	size_t Bytes = pCaller->ReadInternal(File, Stream, 0);
+	pCaller->CachedDataSize = static_cast<size_t>(-1);
+
+	if(!Bytes) return false;
+
+	InFile = File;
+	Start = static_cast<Position>(FileTell(File));
+	Size = static_cast<Length>(Bytes);
+
+	// Move past the data as if we had read it
+	FileSeek(File, Start + Size);
+
+	return true;
+}
+
+
 //! Read data from AVI wrapped essence
 /*! Parses the list and chunk structure - can recurse */
 DataChunkPtr DV_DIF_EssenceSubParser::AVIRead(FileHandle InFile, size_t Bytes) 
@@ -720,6 +894,23 @@ DataChunkPtr DV_DIF_EssenceSubParser::AVIRead(FileHandle InFile, size_t Bytes)
 		Decrement(AVIListRemaining, AVIChunkRemaining);
 	}
 
+	// Go straight to the next of our chunks if they are indexed
+	if(AVINextChunk < AVIIndex.size())
+	{
+		FileSeek(InFile, AVIIndex[AVINextChunk].first);
+		AVIChunkRemaining = AVIIndex[AVINextChunk].second;
+		AVINextChunk++;
+
+		// DRAGONS: We no longer know how much of the list is left, so once the index runs out (for example an idx1 index
+		//          that only covers the first RIFF) the chunks that follow are scanned as if at the top level
+		AVIListRemaining = 0;
+
+		if(!Ret) return AVIRead(InFile, Bytes);
+
+		Ret->Append(AVIRead(InFile, Bytes));
+		return Ret;
+	}
+
 	while(!FileEof(InFile))
 	{
 		// Look for another essence stream chunk in this list
@@ -787,6 +978,151 @@ DataChunkPtr DV_DIF_EssenceSubParser::AVIRead(FileHandle InFile, size_t Bytes)
 };
 
 
+//! Read the index of our chunks in an AVI file, from an OpenDML super index or else from the idx1 chunk after the movi list
+/*! \param SuperIndex The indx chunk of our stream, or NULL if none
+ *  \param MoviStart The file position of the list type of the first movi list
+ *  \param MoviSize The size of the first movi list, including its list type
+ *  \return true if an index was found that matches the first chunk of our stream
+ */
+bool DV_DIF_EssenceSubParser::ReadAVIIndex(FileHandle InFile, DataChunkPtr SuperIndex, Position MoviStart, UInt32 MoviSize)
+{
+	AVIIndex.clear();
+
+	// An OpenDML super index has four longs per entry, each entry locating a standard index chunk
+	// DRAGONS: This is used in preference to idx1 as it also covers any AVIX sections, which idx1 never does
+	if(SuperIndex && (SuperIndex->Size >= 24) && (GetU16_LE(SuperIndex->Data) == 4) && (SuperIndex->Data[3] == 0x00))
+	{
+		size_t Entries = GetU32_LE(&SuperIndex->Data[4]);
+		if(Entries > ((SuperIndex->Size - 24) / 16)) Entries = (SuperIndex->Size - 24) / 16;
+
+		size_t i;
+		for(i = 0; i < Entries; i++)
+		{
+			Position ChunkStart = static_cast<Position>(GetU64_LE(&SuperIndex->Data[24 + i * 16]));
+			if(!ReadAVIStandardIndex(InFile, ChunkStart))
+			{
+				AVIIndex.clear();
+				break;
+			}
+		}
+	}
+
+	// Otherwise use any idx1 chunk, which follows the first movi list (padded to an even size)
+	if(AVIIndex.empty())
+	{
+		Position Idx1Start = MoviStart + MoviSize;
+		if(Idx1Start & 1) Idx1Start++;
+
+		ReadAVIOldIndex(InFile, Idx1Start, MoviStart);
+	}
+
+	// Only trust an index that agrees with where we found our first chunk
+	if((!AVIIndex.empty()) && (AVIIndex.front().first != DIFStart))
+	{
+		warning("The index in this AVI file does not match the location of the first DV frame, so the index will not be used\n");
+		AVIIndex.clear();
+	}
+
+	return !AVIIndex.empty();
+}
+
+
+//! Read the entries of an OpenDML standard index chunk for our stream into AVIIndex
+bool DV_DIF_EssenceSubParser::ReadAVIStandardIndex(FileHandle InFile, Position ChunkStart)
+{
+	FileSeek(InFile, ChunkStart);
+	U32Pair Header = ReadRIFFHeader(InFile);
+	if(Header.second < 24) return false;
+
+	DataChunkPtr Chunk = FileReadChunk(InFile, Header.second);
+	if(Chunk->Size < 24) return false;
+
+	// We need an index of chunks with two longs per entry, for our stream
+	if((GetU16_LE(Chunk->Data) != 2) || (Chunk->Data[3] != 0x01) || (GetU32(&Chunk->Data[8]) != AVIStreamID)) return false;
+
+	size_t Entries = GetU32_LE(&Chunk->Data[4]);
+	if(Entries > ((Chunk->Size - 24) / 8)) Entries = (Chunk->Size - 24) / 8;
+
+	// Each entry gives the position of the chunk data relative to a base offset, and its size with the top bit set for non key-frames
+	Position BaseOffset = static_cast<Position>(GetU64_LE(&Chunk->Data[12]));
+
+	size_t i;
+	for(i = 0; i < Entries; i++)
+	{
+		const UInt8 *Entry = &Chunk->Data[24 + i * 8];
+		AVIIndex.push_back(AVIIndexList::value_type(BaseOffset + GetU32_LE(Entry), GetU32_LE(&Entry[4]) & 0x7fffffff));
+	}
+
+	return true;
+}
+
+
+//! Read the entries of an idx1 chunk for our stream into AVIIndex
+bool DV_DIF_EssenceSubParser::ReadAVIOldIndex(FileHandle InFile, Position ChunkStart, Position MoviStart)
+{
+	FileSeek(InFile, ChunkStart);
+	U32Pair Header = ReadRIFFHeader(InFile);
+	if(Header.first != ID_idx1) return false;
+
+	DataChunkPtr Chunk = FileReadChunk(InFile, Header.second);
+
+	// Offsets are normally from the list type of the movi list, but some writers use file positions instead
+	Position Base = -1;
+
+	size_t Entries = Chunk->Size / 16;
+	size_t i;
+	for(i = 0; i < Entries; i++)
+	{
+		const UInt8 *Entry = &Chunk->Data[i * 16];
+		if(GetU32(Entry) != AVIStreamID) continue;
+
+		// Each offset locates the chunk header, so skip that to find the data
+		Position Offset = static_cast<Position>(GetU32_LE(&Entry[8])) + 8;
+		if(Base < 0) Base = ((MoviStart + Offset) == DIFStart) ? MoviStart : 0;
+
+		AVIIndex.push_back(AVIIndexList::value_type(Base + Offset, GetU32_LE(&Entry[12])));
+	}
+
+	return !AVIIndex.empty();
+}
+
+
+//! Move directly to a given frame of frame wrapped essence, without reading the frames before it
+/*! This is possible for a raw DIF stream, where every frame is the same size, or an AVI file with an index */
+bool DV_DIF_EssenceSubParser::ESP_EssenceSource::SkipTo(Position EditUnit)
+{
+	DV_DIF_EssenceSubParser *pCaller = SmartPtr_Cast(Caller, DV_DIF_EssenceSubParser);
+
+	if((pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Frame) || (pCaller->EditRatio != 1)) return false;
+	if((EditUnit < 0) || RemainingData || (pCaller->CachedDataSize != static_cast<size_t>(-1))) return false;
+
+	if(pCaller->DIFEnd != -1)
+	{
+		Position Pos = pCaller->DIFStart + EditUnit * (150 * 80 * pCaller->SeqCount);
+		if(Pos >= pCaller->DIFEnd) return false;
+
+		pCaller->BatchUsed = 0;
+		pCaller->BatchOffset = 0;
+		FileSeek(File, Pos);
+	}
+	else
+	{
+		if(EditUnit >= static_cast<Position>(pCaller->AVIIndex.size())) return false;
+
+		size_t Chunk = static_cast<size_t>(EditUnit);
+		FileSeek(File, pCaller->AVIIndex[Chunk].first);
+		pCaller->AVIChunkRemaining = pCaller->AVIIndex[Chunk].second;
+		pCaller->AVINextChunk = Chunk + 1;
+		pCaller->AVIListRemaining = 0;
+	}
+
+	pCaller->PictureNumber = EditUnit;
+	Started = true;
+
+	return true;
+}
+
+
 //! Write a number of wrapping items from the specified stream to an MXF file
 /*! If frame or line mapping is used the parameter Count is used to
  *	determine how many items are read. In frame wrapping it is in
@@ -800,6 +1136,9 @@ Length DV_DIF_EssenceSubParser::Write(FileHandle InFile, UInt32 Stream, MXFFileP
 	const unsigned int BUFFERSIZE = 32768;
 	UInt8 *Buffer = new UInt8[BUFFERSIZE];
 
+	// Continue from the last byte returned by Read(), as we read directly from the file
+	DiscardBatch(InFile);
+
 	// Scan the stream and find out how many bytes to transfer
 	size_t Bytes = ReadInternal(InFile, Stream, Count);
 	Length Ret = static_cast<Length>(Bytes);
@@ -1092,6 +1431,7 @@ MDObjectPtr DV_DIF_EssenceSubParser::BuildCDCIEssenceDescriptorFromAVI(FileHandl
 	if(StreamNumber > 9) AVIStreamID += (StreamNumber / 10) << 24;
 
 	// Check if there is an index chunk - this will define the StreamID
+	DataChunkPtr IndexChunk;
 	if(ListSize > 8)
 	{
 		Header = ReadRIFFHeader(InFile);
@@ -1099,7 +1439,7 @@ MDObjectPtr DV_DIF_EssenceSubParser::BuildCDCIEssenceDescriptorFromAVI(FileHandl
 		if(Header.first == ID_indx) 
 		{
 			// Read this chunk
-			DataChunkPtr IndexChunk = FileReadChunk(InFile, Header.second);
+			IndexChunk = FileReadChunk(InFile, Header.second);
 			Decrement(ListSize, Header.second);
 
 			if(IndexChunk->Size >= 12) AVIStreamID = GetU32(&IndexChunk->Data[8]);
@@ -1127,9 +1467,11 @@ MDObjectPtr DV_DIF_EssenceSubParser::BuildCDCIEssenceDescriptorFromAVI(FileHandl
 		// Is this the movi list?
 		if(Header.first == ID_LIST)
 		{
+			Position MoviStart = FileTell(InFile);
 			UInt32 ListID = ReadU32(InFile);
 			if(ListID == ID_movi)
 			{
+				UInt32 MoviSize = Header.second;
 				ListSize = Header.second;
 
 				while(ListSize && !FileEof(InFile))
@@ -1147,6 +1489,14 @@ MDObjectPtr DV_DIF_EssenceSubParser::BuildCDCIEssenceDescriptorFromAVI(FileHandl
 
 						// Build the header from this data
 						Ret = BuildCDCIEssenceDescriptor(InFile, static_cast<UInt64>(DIFStart));
+
+						// Use the index, if there is one, to go straight to each following chunk
+						AVINextChunk = 0;
+						if(ReadAVIIndex(InFile, IndexChunk, MoviStart, MoviSize))
+						{
+							AVINextChunk = 1;
+							if(AVIIndex.size() > AVIFrameCount) AVIFrameCount = static_cast<UInt32>(AVIIndex.size());
+						}
 						
 						// Return to the start of the data
 						FileSeek(InFile, DIFStart);
@@ -1329,7 +1679,12 @@ size_t DV_DIF_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32 Stream, U
 	if((CachedDataSize != static_cast<size_t>(-1)) && CachedCount == Count) return CachedDataSize;
 
 	// Seek to the start of the essence on the first read
-	if(PictureNumber == 0) FileSeek(InFile, DIFStart);
+	if(PictureNumber == 0)
+	{
+		BatchUsed = 0;
+		BatchOffset = 0;
+		FileSeek(InFile, DIFStart);
+	}
 
 	// Return anything remaining if clip wrapping
 	if((Count == 0) && (SelectedWrapping->ThisWrapType == WrappingOption::Clip))
@@ -1354,11 +1709,11 @@ size_t DV_DIF_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32 Stream, U
 		PictureNumber += Count;
 
 		// If this would read beyond the end of the file stop at the end (don't test on AVI files)
-		if((DIFEnd != -1) && ((Ret + static_cast<Position>(FileTell(InFile))) > DIFEnd))
+		if((DIFEnd != -1) && ((Ret + GetFilePos(InFile)) > DIFEnd))
 		{
 			Position SeqSize = (150 * 80 * SeqCount);
 
-			Ret = DIFEnd - static_cast<Position>(FileTell(InFile));
+			Ret = DIFEnd - GetFilePos(InFile);
 			
 			// Fix for an incomplete frame at the end of the previous read
 			if(Ret < 0) Ret = 0;
@@ -1393,6 +1748,13 @@ size_t DV_DIF_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32 Stream, U
 /*! \return true if the option was successfully set */
 bool DV_DIF_EssenceSubParser::SetOption(std::string Option, Int64 Param /*=0*/ )
 {
+	// Number of frames to read at a time from a raw DIF stream (AVI wrapped DV is always read a chunk at a time)
+	if(Option == "BatchFrames")
+	{
+		BatchFrames = (Param > 1) ? static_cast<unsigned int>(Param) : 1;
+		return true;
+	}
+
 	warning("DV_DIF_EssenceSubParser::SetOption(\"%s\", Param) not a known option\n", Option.c_str());
 
 	return false; 
@@ -66,6 +66,12 @@ namespace mxflib
 		UInt32 AVIListRemaining;							//!< The number of bytes remaining in the current LIST while essence parsing
 		UInt32 AVIChunkRemaining;							//!< The number of bytes remaining in the current ##db chunk while essence parsing
 
+		//! The file position and size of the data of each of our chunks in an AVI file, from its index
+		typedef std::vector<std::pair<Position, UInt32> > AVIIndexList;
+
+		AVIIndexList AVIIndex;								//!< Our chunks, in order, or empty if the AVI file has no usable index
+		size_t AVINextChunk;								//!< The entry in AVIIndex of the next chunk to read
+
 		size_t CachedDataSize;								//!< The size of the next data to be read, or (size_t)-1 if not known
 		UInt64 CachedCount;									//!< The number of wrapping units that CachedDataSize relates to
 
@@ -78,8 +84,14 @@ namespace mxflib
 		MDObjectParent CurrentDescriptor;					//!< Pointer to the last essence descriptor we built
 															/*!< This is used as a quick-and-dirty check that we know how to process this source */
 
+		// Batched reading of raw DIF streams
+		DataChunkPtr Batch;									//!< Buffer holding a batch of frames read in a single read, or NULL if not yet used
+		size_t BatchUsed;									//!< Number of valid bytes in Batch
+		size_t BatchOffset;									//!< Number of bytes of Batch already returned
+		Position BatchStart;								//!< Position in the input file of the first byte of Batch
+
 		// Options
-		// None (yet)
+		unsigned int BatchFrames;							//!< Number of frames to read at a time from a raw DIF stream, set by SetOption("BatchFrames")
 
 	public:
 		//! Class for EssenceSource objects for parsing/sourcing DV-DIF essence
@@ -125,6 +137,16 @@ namespace mxflib
 				return BaseGetEssenceData(Size, MaxSize);
 			}
 
+			//! Get a run of whole edit units in one call
+			/*! Batches are only read from a frame wrapped raw DIF stream, where every frame is the same size */
+			virtual EssenceBatchPtr GetEssenceBatch(size_t MaxUnits, size_t MaxBytes);
+
+			//! Get the location of the rest of a clip if it is held as a single range of a file
+			virtual bool GetEssenceFileRange(FileHandle &InFile, Position &Start, Length &Size);
+
+			//! Move directly to a given frame of frame wrapped essence, without reading the frames before it
+			virtual bool SkipTo(Position EditUnit);
+
 			//! Get the preferred BER length size for essence KLVs written from this source, 0 for auto
 			virtual int GetBERSize(void) 
 			{ 
@@ -146,10 +168,16 @@ namespace mxflib
 			SeqCount = 10;
 			AVIFrameCount = 0;
 			StreamNumber = 0;
+			AVINextChunk = 0;
 			Buffer = NULL;
 
 			CachedDataSize = static_cast<size_t>(-1);
 			CachedCount = 0;
+
+			BatchUsed = 0;
+			BatchOffset = 0;
+			BatchStart = 0;
+			BatchFrames = 1;
 		}
 
 		~DV_DIF_EssenceSubParser()
@@ -176,6 +204,9 @@ namespace mxflib
 		//! Examine the open file and return a list of essence descriptors
 		virtual EssenceStreamDescriptorList IdentifyEssence(FileHandle InFile);
 
+		//! Check the probe data of a file to see if this parser may be able to identify the essence
+		virtual bool CanIdentify(const EssenceProbe &Probe);
+
 		//! Examine the open file and return the wrapping options known by this parser
 		virtual WrappingOptionList IdentifyWrappingOptions(FileHandle InFile, EssenceStreamDescriptor &Descriptor);
 
@@ -258,9 +289,32 @@ namespace mxflib
 		//! Scan the essence to calculate how many bytes to transfer for the given edit unit count
 		size_t ReadInternal(FileHandle InFile, UInt32 Stream, UInt64 Count/*, IndexTablePtr Index = NULL*/);
 
+		//! Read data from a raw DIF stream, reading ahead by a batch of frames at a time
+		DataChunkPtr BatchRead(FileHandle InFile, size_t Bytes);
+
+		//! Discard any batched data not yet returned, moving the file pointer back to the first byte not returned
+		void DiscardBatch(FileHandle InFile);
+
+		//! Get the position in the input file of the next byte to be returned, allowing for any batched data
+		Position GetFilePos(FileHandle InFile) { return (BatchOffset < BatchUsed) ? BatchStart + static_cast<Position>(BatchOffset) : static_cast<Position>(FileTell(InFile)); }
+
 		//! Read data from AVI wrapped essence
-		/*! Parses the list and chunk structure - can recurse */
+		/*! Parses the list and chunk structure, or follows the index if there is one - can recurse */
 		DataChunkPtr AVIRead(FileHandle InFile, size_t Bytes);
+
+		//! Read the index of our chunks in an AVI file, from an OpenDML super index or else from the idx1 chunk after the movi list
+		/*! \param SuperIndex The indx chunk of our stream, or NULL if none
+		 *  \param MoviStart The file position of the list type of the first movi list
+		 *  \param MoviSize The size of the first movi list, including its list type
+		 *  \return true if an index was found that matches the first chunk of our stream
+		 */
+		bool ReadAVIIndex(FileHandle InFile, DataChunkPtr SuperIndex, Position MoviStart, UInt32 MoviSize);
+
+		//! Read the entries of an OpenDML standard index chunk for our stream into AVIIndex
+		bool ReadAVIStandardIndex(FileHandle InFile, Position ChunkStart);
+
+		//! Read the entries of an idx1 chunk for our stream into AVIIndex
+		bool ReadAVIOldIndex(FileHandle InFile, Position ChunkStart, Position MoviStart);
 	};
 
 
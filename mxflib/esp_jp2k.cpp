@@ -178,6 +178,20 @@ EssenceStreamDescriptorList mxflib::JP2K_EssenceSubParser::IdentifyEssence(FileH
 }
 
 
+//! Check the probe data of a file to see if this parser may be able to identify the essence
+bool mxflib::JP2K_EssenceSubParser::CanIdentify(const EssenceProbe &Probe)
+{
+	// These are the same signatures as checked by IdentifyEssence()
+	const UInt8 JP2_Signature[] = { 0x00, 0x00, 0x00, 0x0c, 0x6a, 0x50, 0x20, 0x20, 0x0d, 0x0a, 0x87, 0x0a };
+	const UInt8 J2C_Signature[] = { 0xff, 0x4f, 0xff, 0x51 };
+
+	if(!Probe.HasHead(12)) return true;
+	if(Probe.GetHeadSize() < 12) return false;
+
+	return (memcmp(Probe.GetHead(), JP2_Signature, 12) == 0) || (memcmp(Probe.GetHead(), J2C_Signature, 4) == 0);
+}
+
+
 //! Examine the open file and return the wrapping options known by this parser
 /*! \param InFile The open file to examine (if the descriptor does not contain enough info)
  *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
@@ -267,14 +281,23 @@ DataChunkPtr mxflib::JP2K_EssenceSubParser::Read(FileHandle InFile, UInt32 Strea
 	// If there is no data left return a NULL pointer as a signal
 	if(!Bytes) return Ret;
 
-	// Make a datachunk with enough space
-	Ret = new DataChunk(Bytes);
+	if(MapFiles) Ret = ReadMapped(InFile, Bytes);
 
-	// Read the data
-	FileRead(InFile, Ret->Data, Bytes);
+	if(Ret)
+	{
+		CurrentPos += Bytes;
+	}
+	else
+	{
+		// Make a datachunk with enough space
+		Ret = new DataChunk(Bytes);
 
-	// Update the file pointer
-	CurrentPos = FileTell(InFile);
+		// Read the data
+		FileRead(InFile, Ret->Data, Bytes);
+
+		// Update the file pointer
+		CurrentPos = FileTell(InFile);
+	}
 
 	// Update the picture number
 	PictureNumber++;
@@ -283,6 +306,28 @@ DataChunkPtr mxflib::JP2K_EssenceSubParser::Read(FileHandle InFile, UInt32 Strea
 }
 
 
+//! Read bytes from the current position of the source file by mapping the file into memory
+/*! \return A chunk referencing the mapping, which is released when the chunk is dropped, or NULL if the file could not be mapped
+ *  DRAGONS: The whole file is mapped for each read, so this is only efficient where each file holds a single frame
+ */
+DataChunkPtr mxflib::JP2K_EssenceSubParser::ReadMapped(FileHandle InFile, size_t Bytes)
+{
+	DataChunkPtr Ret;
+
+	Int64 FileBytes = FileSize(InFile);
+	if((FileBytes <= 0) || (static_cast<UInt64>(CurrentPos + Bytes) > static_cast<UInt64>(FileBytes))) return Ret;
+
+	UInt8 *Map = FileMemoryMap(InFile, FileBytes);
+	if(!Map) return Ret;
+
+	// The returned chunk holds the only reference to the mapping, so it is released as soon as the data has been written
+	Ret = new DataChunk;
+	Ret->SetBuffer(new MappedFileChunk(Map, FileBytes), &Map[CurrentPos], Bytes);
+
+	return Ret;
+}
+
+
 //! Write a number of wrapping items from the specified stream to an MXF file
 /*! If frame or line mapping is used the parameter Count is used to
  *	determine how many items are read. In frame wrapping it is in
@@ -595,10 +640,20 @@ size_t mxflib::JP2K_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32 Str
 		return CachedDataSize;
 	}
 
+	// If frame wrapping a sequence of raw codestreams, find the end of each from the tile-part lengths
+	Ret = -1;
+	if(TilePartScan && SelectedWrapping && (SelectedWrapping->ThisWrapType == WrappingOption::Frame))
+	{
+		Ret = CodestreamSize(InFile, CurrentPos, Count);
+	}
+
 	// If the size is unknown we assume the rest of the file is data
 	// DRAGONS: Should work even for JP2 files as an "unknown" length must be the last item in a JP2 file
-	FileSeekEnd(InFile);
-	Ret = static_cast<Length>(FileTell(InFile) - CurrentPos);
+	if(Ret < 0)
+	{
+		FileSeekEnd(InFile);
+		Ret = static_cast<Length>(FileTell(InFile) - CurrentPos);
+	}
 	
 	// Move back to the current position
 	FileSeek(InFile, CurrentPos);
@@ -749,6 +804,95 @@ printf("Read Done\n");
 }
 
 
+//! Find the size of a number of consecutive codestreams from the lengths in their tile-part headers
+/*! Each codestream is walked from its SOC marker to its EOC marker, skipping over the main header marker segments by their lengths
+ *  and over each tile-part by its Psot, so the cost is one small read per marker rather than a scan of the data.
+ *  \return The total size of the codestreams, which will be less than Count codestreams if the end of the file is reached,
+ *           or -1 if a codestream could not be sized this way (for example if its last tile-part has Psot = 0)
+ */
+Length mxflib::JP2K_EssenceSubParser::CodestreamSize(FileHandle InFile, Position Start, Length Count)
+{
+	// Large enough for a marker and the start of an SOT segment (Lsot, Isot and Psot)
+	UInt8 Buffer[10];
+
+	Position Pos = Start;
+
+	while(Count--)
+	{
+		FileSeek(InFile, Pos);
+		size_t Bytes = (size_t)FileRead(InFile, Buffer, 2);
+
+		// Clean end of file
+		if(Bytes == 0) break;
+
+		// Each codestream must start with SOC
+		if((Bytes < 2) || (Buffer[0] != 0xff) || (Buffer[1] != 0x4f)) return -1;
+
+		Pos += 2;
+
+		for(;;)
+		{
+			FileSeek(InFile, Pos);
+			Bytes = (size_t)FileRead(InFile, Buffer, 10);
+
+			if((Bytes < 2) || (Buffer[0] != 0xff)) return -1;
+
+			UInt8 Marker = Buffer[1];
+
+			// EOC ends the codestream
+			if(Marker == 0xd9)
+			{
+				Pos += 2;
+				break;
+			}
+
+			// SOT - skip the whole tile-part
+			if(Marker == 0x90)
+			{
+				if(Bytes < 10) return -1;
+
+				// A Psot of zero means the tile-part runs to the EOC, which is only found by scanning
+				UInt32 Psot = GetU32(&Buffer[6]);
+				if(Psot == 0) return -1;
+
+				Pos += Psot;
+			}
+			else if(MarkerSegments[Marker])
+			{
+				if(Bytes < 4) return -1;
+
+				Pos += 2 + GetU16(&Buffer[2]);
+			}
+			else Pos += 2;
+		}
+	}
+
+	return static_cast<Length>(Pos - Start);
+}
+
+
+//! Set a parser specific option
+/*! \return true if the option was successfully set */
+bool mxflib::JP2K_EssenceSubParser::SetOption(std::string Option, Int64 Param /*=0*/ )
+{
+	if(Option == "TilePartScan")
+	{
+		TilePartScan = (Param != 0);
+		return true;
+	}
+
+	if(Option == "MapFiles")
+	{
+		MapFiles = (Param != 0);
+		return true;
+	}
+
+	debug("JP2K_EssenceSubParser::SetOption(\"%s\", Param) not a known option\n", Option.c_str());
+
+	return false; 
+}
+
+
 //! Parse a JP2 header at the start of the specified file into items in the Header multimap
 bool mxflib::JP2K_EssenceSubParser::ParseJP2Header(FileHandle InFile)
 {
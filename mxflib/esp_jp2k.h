@@ -54,6 +54,12 @@ namespace mxflib
 
 		size_t CachedDataSize;								//!< The size of the next data to be read, or (size_t)-1 if not known
 
+		bool TilePartScan;									//!< True if frame wrapped raw codestreams are sized from their tile-part lengths
+															/*!< If false, or if a codestream cannot be sized this way, the rest of the file is taken as the next frame */
+
+		bool MapFiles;										//!< True if each read maps the source file and returns the data in place rather than copying it
+															/*!< This suits image sequences with one codestream per file, set by SetOption("MapFiles") */
+
 		MDObjectParent CurrentDescriptor;					//!< Pointer to the last essence descriptor we built
 															/*!< This is used as a quick-and-dirty check that we know how to process this source */
 
@@ -117,6 +123,9 @@ namespace mxflib
 			UseEditRate.Denominator = 1;
 
 			CachedDataSize = static_cast<size_t>(-1);
+
+			TilePartScan = true;
+			MapFiles = false;
 		}
 
 		//! Build a new parser of this type and return a pointer to it
@@ -139,6 +148,9 @@ namespace mxflib
 		//! Examine the open file and return a list of essence descriptors
 		virtual EssenceStreamDescriptorList IdentifyEssence(FileHandle InFile);
 
+		//! Check the probe data of a file to see if this parser may be able to identify the essence
+		virtual bool CanIdentify(const EssenceProbe &Probe);
+
 		//! Examine the open file and return the wrapping options known by this parser
 		virtual WrappingOptionList IdentifyWrappingOptions(FileHandle InFile, EssenceStreamDescriptor &Descriptor);
 
@@ -194,6 +206,10 @@ namespace mxflib
 		//! Write a number of wrapping items from the specified stream to an MXF file
 		virtual Length Write(FileHandle InFile, UInt32 Stream, MXFFilePtr OutFile, UInt64 Count = 1);
 
+		//! Set a parser specific option
+		/*! \return true if the option was successfully set */
+		virtual bool SetOption(std::string Option, Int64 Param = 0);
+
 		//! Get a unique name for this sub-parser
 		/*! The name must be all lower case, and must be unique.
 		 *  The recommended name is the part of the filename of the parser header after "esp_" and before the ".h".
@@ -223,6 +239,16 @@ namespace mxflib
 		//! Scan the essence to calculate how many bytes to transfer for the given edit unit count
 		size_t ReadInternal(FileHandle InFile, UInt32 Stream, Length Count);
 
+		//! Read bytes from the current position of the source file by mapping the file into memory
+		/*! \return A chunk referencing the mapping, which is released when the chunk is dropped, or NULL if the file could not be mapped */
+		DataChunkPtr ReadMapped(FileHandle InFile, size_t Bytes);
+
+		//! Find the size of a number of consecutive codestreams from the lengths in their tile-part headers
+		/*! Only the marker segment headers are read, the tile data is skipped over.
+		 *  \return The total size, or -1 if any of the codestreams could not be sized this way
+		 */
+		Length CodestreamSize(FileHandle InFile, Position Start, Length Count);
+
 		//! Parse a JP2 header at the start of the specified file into items in the Header multimap
 		bool ParseJP2Header(FileHandle InFile);
 
@@ -31,6 +31,15 @@
 
 #include <math.h>	// For "floor"
 
+// Use SSE2 or NEON to speed up start code scanning where available at compile time
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MPEG2_VES_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define MPEG2_VES_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace mxflib;
 
 #include <mxflib/esp_mpeg2ves.h>
@@ -41,6 +50,61 @@ namespace
 {
 	//! Modified UUID for MPEG2-VES
 	const UInt8 MPEG2_VES_Format[] = { 0x45, 0x54, 0x57, 0x62,  0xd6, 0xb4, 0x2e, 0x4e,  0xf3, 0xd2, 'M', 'P',  'E', 'G', '2', 'V' };
+
+	//! Find the first start code prefix (00 00 01) in a buffer
+	/*! \return Pointer to the first byte of the first prefix found, or if none is found, a pointer to the first of any
+	 *          trailing bytes that could be the start of a prefix continuing beyond the buffer, otherwise End
+	 */
+	const UInt8 *FindStartCode(const UInt8 *Start, const UInt8 *End)
+	{
+		const UInt8 *p = Start;
+
+		while(p + 2 < End)
+		{
+#if defined(MPEG2_VES_SSE2)
+			// Skip blocks of 16 bytes that hold no zero bytes, or move to the first zero byte in the block
+			if(p + 16 <= End)
+			{
+				int Mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128()));
+				if(!Mask)
+				{
+					p += 16;
+					continue;
+				}
+
+				while(!(Mask & 1))
+				{
+					Mask >>= 1;
+					p++;
+				}
+
+				if(p + 2 >= End) break;
+			}
+#elif defined(MPEG2_VES_NEON)
+			// Skip blocks of 16 bytes that hold no zero bytes
+			if((p + 16 <= End) && (vmaxvq_u8(vceqq_u8(vld1q_u8(p), vdupq_n_u8(0))) == 0))
+			{
+				p += 16;
+				continue;
+			}
+#endif
+			// Step over as many bytes as can be ruled out by the third byte of the candidate
+			if(p[2] > 1) p += 3;
+			else if(p[1]) p += 2;
+			else if(p[0] || (p[2] != 1)) p++;
+			else return p;
+		}
+
+		// Allow for a prefix that starts in the last two bytes and continues beyond the buffer
+		p = (End - Start > 2) ? End - 2 : Start;
+		while(p < End)
+		{
+			if((p[0] == 0) && ((p + 1 == End) || (p[1] == 0))) return p;
+			p++;
+		}
+
+		return End;
+	}
 }
 
 
@@ -138,6 +202,32 @@ EssenceStreamDescriptorList MPEG2_VES_EssenceSubParser::IdentifyEssence(FileHand
 }
 
 
+//! Check the probe data of a file to see if this parser may be able to identify the essence
+bool MPEG2_VES_EssenceSubParser::CanIdentify(const EssenceProbe &Probe)
+{
+	// IdentifyEssence() only looks for a sequence header in the first 8k of the file
+	const size_t ScanSize = 1024*8;
+
+	if(!Probe.HasHead(ScanSize)) return true;
+
+	size_t BufferBytes = Probe.GetHeadSize();
+	if(BufferBytes > ScanSize) BufferBytes = ScanSize;
+	if(BufferBytes < 16) return false;
+
+	// The file must start with two zeros, the start of a start code
+	const UInt8 *Buffer = Probe.GetHead();
+	if((Buffer[0] != 0) || (Buffer[1] != 0)) return false;
+
+	// There must be a sequence header start code somewhere in the scanned bytes
+	for(size_t i = 2; i < (BufferBytes - 1); i++)
+	{
+		if((Buffer[i] == 0xb3) && (Buffer[i-1] == 1) && (Buffer[i-2] == 0)) return true;
+	}
+
+	return false;
+}
+
+
 //! Examine the open file and return the wrapping options known by this parser
 /*! \param InFile The open file to examine (if the descriptor does not contain enough info)
  *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
@@ -701,6 +791,22 @@ size_t MPEG2_VES_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32 Stream
 
 		for(;;)
 		{
+			// Skip over any buffered bytes that cannot be part of a start code
+			// DRAGONS: This is only valid when the last bytes scanned cannot be the start of a start code that is still to be completed
+			if(BuffCount && (Scan & 0xff) && ((Scan & 0x00ffffff) != 0x000001))
+			{
+				int Skip = static_cast<int>(FindStartCode(BuffPtr, BuffPtr + BuffCount) - BuffPtr);
+				if(Skip)
+				{
+					BuffPtr += Skip;
+					BuffCount -= Skip;
+					CurrentPos += Skip;
+
+					// None of the skipped bytes can contribute to a start code
+					Scan = 0xffffffff;
+				}
+			}
+
 			int ThisByte = BuffGetU8(InFile);
 
 			if(ThisByte == -1)
@@ -195,6 +195,9 @@ namespace mxflib
 		//! Examine the open file and return a list of essence descriptors
 		virtual EssenceStreamDescriptorList IdentifyEssence(FileHandle InFile);
 
+		//! Check the probe data of a file to see if this parser may be able to identify the essence
+		virtual bool CanIdentify(const EssenceProbe &Probe);
+
 		//! Examine the open file and return the wrapping options known by this parser
 		virtual WrappingOptionList IdentifyWrappingOptions(FileHandle InFile, EssenceStreamDescriptor &Descriptor);
 
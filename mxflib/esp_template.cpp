@@ -86,6 +86,17 @@ EssenceStreamDescriptorList mxflib::TEMPLATE_EssenceSubParser::IdentifyEssence(F
 }
 
 
+//! Check the probe data of a file to see if this parser may be able to identify the essence
+/*! This should return false if the signature of this essence type is not found in the probe data, so that files of
+ *  other types are rejected without IdentifyEssence() reading them
+ */
+bool mxflib::TEMPLATE_EssenceSubParser::CanIdentify(const EssenceProbe &Probe)
+{
+	// TODO: Check for the signature of this essence type at the start of Probe.GetHead()
+	return true;
+}
+
+
 //! Examine the open file and return the wrapping options known by this parser
 /*! \param InFile The open file to examine (if the descriptor does not contain enough info)
  *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
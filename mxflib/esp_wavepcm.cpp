@@ -89,6 +89,18 @@ EssenceStreamDescriptorList mxflib::WAVE_PCM_EssenceSubParser::IdentifyEssence(F
 }
 
 
+//! Check the probe data of a file to see if this parser may be able to identify the essence
+bool mxflib::WAVE_PCM_EssenceSubParser::CanIdentify(const EssenceProbe &Probe)
+{
+	if(!Probe.HasHead(12)) return true;
+	if(Probe.GetHeadSize() < 12) return false;
+
+	// The file must start with "RIFF" and the RIFF type must be "WAVE"
+	const UInt8 *Buffer = Probe.GetHead();
+	return (memcmp(Buffer, "RIFF", 4) == 0) && (memcmp(&Buffer[8], "WAVE", 4) == 0);
+}
+
+
 //! Examine the open file and return the wrapping options known by this parser
 /*! \param InFile The open file to examine (if the descriptor does not contain enough info)
  *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
@@ -183,7 +195,7 @@ DataChunkPtr WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceData(size_t
 		if(BytesRemaining == 0)
 		{
 			// Undo removing the size by calling SamplesThisEditUnit so that the padding sequence stays corrent
-			if(PaddingEnabled) pCaller->PushBackSize();
+			if(PaddingEnabled && (pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Clip)) pCaller->PushBackSize();
 
 			AtEndOfData = true;
 			return NULL;
@@ -193,6 +205,26 @@ DataChunkPtr WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceData(size_t
 	// Decide how many bytes to read this time - start by trying to read them all
 	size_t Bytes = BytesRemaining;
 
+	// When clip wrapping with no size requested read large blocks of whole wrapping sequences, which keeps memory use
+	// bounded and allows the edit unit position to be updated after each block without counting samples
+	bool WholeBlock = false;
+	if((pCaller->SelectedWrapping->ThisWrapType == WrappingOption::Clip) && BulkReadSize && (Size == 0))
+	{
+		size_t Block = BulkReadSize;
+		if((MaxSize != 0) && (MaxSize < Block)) Block = MaxSize;
+
+		size_t Unit = pCaller->GetBlockUnitSize();
+		if(Unit && (Block >= Unit))
+		{
+			Block -= Block % Unit;
+			if(Bytes > Block)
+			{
+				Bytes = Block;
+				WholeBlock = true;
+			}
+		}
+	}
+
 	// Hard limit to MaxSize
 	if((MaxSize != 0) && (Bytes > MaxSize))
 	{
@@ -215,10 +247,37 @@ DataChunkPtr WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceData(size_t
 	DataChunkPtr Ret = FileReadChunk(File, Bytes);
 
 	// Update the file pointer
-	pCaller->BytePosition = FileTell(File);
+	if((Ret->Size < Bytes) && PaddingEnabled)
+	{
+		// The missing bytes will be padded, so treat them as read
+		pCaller->BytePosition += Bytes;
+	}
+	else
+	{
+		pCaller->BytePosition = FileTell(File);
+
+		// Cope with an early end-of-file by ending the data where the file ends
+		if(Ret->Size < Bytes)
+		{
+			pCaller->DataSize = pCaller->BytePosition - pCaller->DataStart;
+			BytesRemaining = 0;
+
+			if(Ret->Size == 0)
+			{
+				pCaller->CurrentPosition = pCaller->CalcCurrentPosition();
 
-	// Move the edit unit pointer forward by the number of edit units read (if the last part of a read)
-	if(!BytesRemaining)	
+				AtEndOfData = true;
+				return NULL;
+			}
+		}
+	}
+
+	// Move the edit unit pointer forward by the number of edit units read (if the last part of a read, or a whole block of a clip)
+	if(WholeBlock && (Ret->Size == Bytes))
+	{
+		pCaller->CurrentPosition = pCaller->CalcCurrentPosition();
+	}
+	else if(!BytesRemaining)	
 	{
 		
 		// Only do a simple add if not reading the whole clip, and if the read succeeded
@@ -241,6 +300,73 @@ DataChunkPtr WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceData(size_t
 }
 
 
+//! Get a run of whole edit units in one call
+/*! Batches are only read when frame wrapping, as the size of each edit unit then follows from the wrapping sequence.
+ *  The end of the data, including any edit unit cut short by a truncated file, is left to GetEssenceData().
+ */
+EssenceBatchPtr WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceBatch(size_t MaxUnits, size_t MaxBytes)
+{
+	WAVE_PCM_EssenceSubParser *pCaller = SmartPtr_Cast(Caller, WAVE_PCM_EssenceSubParser);
+
+	if((pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Frame) || BytesRemaining || AtEndOfData) return NULL;
+
+	// Allow us to differentiate the first call
+	if(!Started)
+	{
+		Started = true;
+
+		// Move to the selected position
+		if(pCaller->BytePosition == 0) pCaller->BytePosition = pCaller->DataStart;
+	}
+
+	Int64 FileBytes = FileSize(File);
+	if(FileBytes < pCaller->BytePosition) return NULL;
+	UInt64 Available = static_cast<UInt64>(FileBytes - pCaller->BytePosition);
+
+	EssenceBatchPtr Ret = new EssenceBatch;
+	Ret->FirstPosition = pCaller->CurrentPosition;
+
+	size_t Total = 0;
+	while(Ret->size() < MaxUnits)
+	{
+		// Either use the cached value, or step through the wrapping sequence to find the size of the next edit unit
+		size_t Bytes = pCaller->ReadInternal(File, Stream, RequestedCount);
+
+		// The size of an edit unit not taken stays cached for the next read
+		if((Bytes == 0) || ((Total + Bytes) > Available)) break;
+		if(MaxBytes && (!Ret->Sizes.empty()) && ((Total + Bytes) > MaxBytes)) break;
+
+		pCaller->CachedDataSize = static_cast<size_t>(-1);
+
+		Ret->Sizes.push_back(Bytes);
+		Ret->EditPoints.push_back(true);
+		Total += Bytes;
+	}
+
+	if(Ret->Sizes.empty()) return NULL;
+
+	// Read all the edit units at once
+	FileSeek(File, pCaller->BytePosition);
+	Ret->Buffer = FileReadChunk(File, Total);
+
+	// DRAGONS: The file was long enough when checked, so a short read can only be from it being cut while we read,
+	//          which is treated as a read error and padded as GetEssenceData() does when padding is enabled
+	if(Ret->Buffer->Size < Total)
+	{
+		error("Only read 0x%s of 0x%s bytes of a batch of WAVE audio\n", Int64toHexString(Ret->Buffer->Size).c_str(), Int64toHexString(Total).c_str());
+
+		size_t OldSize = Ret->Buffer->Size;
+		Ret->Buffer->Resize(Total);
+		memset(&Ret->Buffer->Data[OldSize], 0, Total - OldSize);
+	}
+
+	pCaller->BytePosition += Total;
+	pCaller->CurrentPosition += static_cast<Position>(Ret->size() * RequestedCount);
+
+	return Ret;
+}
+
+
 //! Get data to write as padding after all real essence data has been processed
 /*! If more than one stream is being wrapped, they may not all end at the same wrapping-unit.
  *	When this happens each source that has ended will produce NULL is response to GetEssenceData().
@@ -290,6 +416,14 @@ bool WAVE_PCM_EssenceSubParser::ESP_EssenceSource::SetOption(std::string Option,
 		return true;
 	}
 
+	// Set the size of the blocks read when clip wrapping, 0 to read the whole clip at once
+	if(Option == "BulkReadSize")
+	{
+		BulkReadSize = static_cast<size_t>(Param);
+
+		return true;
+	}
+
 	return false;
 }
 
@@ -351,12 +485,8 @@ DataChunkPtr mxflib::WAVE_PCM_EssenceSubParser::Read(FileHandle InFile, UInt32 S
  */
 Length mxflib::WAVE_PCM_EssenceSubParser::Write(FileHandle InFile, UInt32 Stream, MXFFilePtr OutFile, UInt64 Count /*=1*/ /*, IndexTablePtr Index*/ /*=NULL*/)
 {
-	const unsigned int BUFFERSIZE = 32768;
-	UInt8 *Buffer = new UInt8[BUFFERSIZE];
-
 	// Move to the current position
 	if(BytePosition == 0) BytePosition = DataStart;
-	FileSeek(InFile, BytePosition);
 	
 	// Scan the stream and find out how many bytes to transfer
 	// Either use the cached value, or scan the stream and find out how many bytes to read
@@ -367,24 +497,11 @@ Length mxflib::WAVE_PCM_EssenceSubParser::Write(FileHandle InFile, UInt32 Stream
 	// Clear the cached size
 	CachedDataSize = static_cast<size_t>(-1);
 
-	while(Bytes)
-	{
-		size_t ChunkSize;
-		
-		// Number of bytes to transfer in this chunk
-		if(Bytes < BUFFERSIZE) ChunkSize = Bytes; else ChunkSize = BUFFERSIZE;
-
-		FileRead(InFile, Buffer, ChunkSize);
-		OutFile->Write(Buffer, ChunkSize);
-
-		Bytes -= ChunkSize;
-	}
+	// Copy the bytes as one range, which is done by the OS where possible rather than in small buffers
+	if(Bytes) OutFile->WriteFromFile(InFile, BytePosition, Bytes);
 
 	// Update the file pointer
-	BytePosition = FileTell(InFile);
-
-	// Free the buffer
-	delete[] Buffer;
+	BytePosition += Bytes;
 
 	return Ret; 
 }
@@ -439,6 +556,8 @@ bool mxflib::WAVE_PCM_EssenceSubParser::CalcWrappingSequence(Rational EditRate)
 		SampleSequence = NULL;
 	}
 
+	SequenceSamples = 0;
+
 	// Invalid edit rate!
 	if(EditRate.Numerator == 0) return false;
 
@@ -480,6 +599,8 @@ bool mxflib::WAVE_PCM_EssenceSubParser::CalcWrappingSequence(Rational EditRate)
 		UInt32 x = (UInt32)floor(f + 0.5);
 		SampleSequence[i] = x;
 		Remain = f - x;
+
+		SequenceSamples += x;
 	}
 
 	return true;
@@ -489,50 +610,49 @@ bool mxflib::WAVE_PCM_EssenceSubParser::CalcWrappingSequence(Rational EditRate)
 
 //! Calculate the current position in SetEditRate() sized edit units from "BytePosition" in bytes
 /*! \return 0 if position not known
+ *  \note The wrapping sequence is assumed to start at the start of the data, which is how it is used
  */
 Position WAVE_PCM_EssenceSubParser::CalcCurrentPosition(void)
 {
 	if(SampleSize == 0) return 0;
 
+	Position Samples = (BytePosition - DataStart) / SampleSize;
+
 	// Simple case where each edit unit has the same number of samples
-	if(ConstSamples != 0)
-	{
-		return (BytePosition-DataStart) / (SampleSize * ConstSamples);
-	}
+	if(ConstSamples != 0) return Samples / ConstSamples;
+
+	// If no edit rate has been set each sample is an edit unit
+	if((SampleSequenceSize == 0) || (SampleSequence == NULL) || (SequenceSamples == 0)) return Samples;
+
+	// Count the complete sequences from the start of the essence
+	Position Ret = (Samples / SequenceSamples) * SampleSequenceSize;
 
-	// Work out how many samples are in a complete sequence
-	UInt32 SeqSize = 0;
+	// Then the complete edit units of the fractional part
+	Position FracSamples = Samples % SequenceSamples;
 	int i;
 	for(i=0; i < SampleSequenceSize; i++)
 	{
-		SeqSize += SampleSequence[i];
-	}
+		if(FracSamples < SampleSequence[i]) break;
 
-	// Now work out how many complete sequences we are from the start of the essence
-	Position CompleteSeq = (BytePosition-DataStart) / SampleSize * SeqSize;
+		FracSamples -= SampleSequence[i];
+		Ret++;
+	}
 
-	// And The fractional part...
-	Position FracSeq = (BytePosition-DataStart) - (CompleteSeq * SeqSize);
+	return Ret;
+}
 
-	Position Ret = CompleteSeq * SeqSize;
 
-	// Count back through the sequence to see how many edit units the fractional part is
-	i = SequencePos;
-	while(FracSeq)
-	{
-		// Step back through the sequence
-		if(!i) i = SampleSequenceSize;
-		i--;
+//! Get the number of bytes in the smallest run of whole edit units that always holds the same number of samples
+/*! This is one edit unit if the number of samples per edit unit is constant, else one complete wrapping sequence */
+size_t WAVE_PCM_EssenceSubParser::GetBlockUnitSize(void)
+{
+	if(ConstSamples) return static_cast<size_t>(ConstSamples) * SampleSize;
+	if(SequenceSamples) return static_cast<size_t>(SequenceSamples) * SampleSize;
 
-		// Not a complete edit unit left
-		if(FracSeq < SampleSequence[i]) break;
+	return SampleSize;
+}
 
-		Ret += SampleSequence[i];
-		FracSeq -= SampleSequence[i];
-	}
 
-	return Ret;
-}
 
 
 
@@ -648,6 +768,41 @@ UInt32 mxflib::WAVE_PCM_EssenceSubParser::SamplesThisEditUnit(void)
 }
 
 
+//! Get the location of the rest of a clip if it is held as a single range of a file
+/*! The "data" chunk is offered when clip wrapping, unless part of a read is outstanding or padding is enabled (as a short
+ *  file must then be padded)
+ */
+bool WAVE_PCM_EssenceSubParser::ESP_EssenceSource::GetEssenceFileRange(FileHandle &InFile, Position &Start, Length &Size)
+{
+	WAVE_PCM_EssenceSubParser *pCaller = SmartPtr_Cast(Caller, WAVE_PCM_EssenceSubParser);
+
+	if(pCaller->SelectedWrapping->ThisWrapType != WrappingOption::Clip) return false;
+	if(BytesRemaining || PaddingEnabled) return false;
+
+	Started = true;
+	if(pCaller->BytePosition == 0) pCaller->BytePosition = pCaller->DataStart;
+
+	Length Done = pCaller->BytePosition - pCaller->DataStart;
+	if(Done >= pCaller->DataSize) return false;
+
+	Size = pCaller->DataSize - Done;
+
+	// A truncated file is left to GetEssenceData() to handle
+	Int64 FileBytes = FileSize(File);
+	if((FileBytes < 0) || ((pCaller->BytePosition + Size) > FileBytes)) return false;
+
+	InFile = File;
+	Start = pCaller->BytePosition;
+
+	// Move past the data as if we had read it
+	pCaller->BytePosition += Size;
+	pCaller->CachedDataSize = static_cast<size_t>(-1);
+	pCaller->CurrentPosition = pCaller->CalcCurrentPosition();
+
+	return true;
+}
+
+
 //! Scan the essence to calculate how many bytes to transfer for the given edit unit count
 /*! \note The file position pointer is left at the start of the chunk at the end of 
  *		  this function
@@ -672,13 +827,14 @@ size_t mxflib::WAVE_PCM_EssenceSubParser::ReadInternal(FileHandle InFile, UInt32
 	}
 	Max = DataSize - Max;							// How many bytes are left
 
-	// How many sample are required?
-	UInt32 SamplesPerEditUnit = SamplesThisEditUnit();
-
 	// Return anything we can find if in clip wrapping
+	// DRAGONS: The wrapping sequence is not stepped for a clip, as the clip is not read an edit unit at a time
 	if(SelectedWrapping->ThisWrapType == WrappingOption::Clip) Ret = Max;
 	else 
 	{
+		// How many sample are required?
+		UInt32 SamplesPerEditUnit = SamplesThisEditUnit();
+
 		Ret = SamplesPerEditUnit * SampleSize;
 		if(Count) Ret *= Count;
 	}
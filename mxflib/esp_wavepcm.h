@@ -59,6 +59,7 @@ namespace mxflib
 		int SampleSequenceSize;								//!< Size of SampleSequence if used
 		UInt32 *SampleSequence;								//!< Array of counts of samples per edit unit for non integer relationships between edit rate and sample rate
 		int SequencePos;									//!< Current position in the sequence (i.e. next entry to use)
+		UInt32 SequenceSamples;								//!< Total number of samples in one complete SampleSequence
 
 		MDObjectParent CurrentDescriptor;					//!< Pointer to the last essence descriptor we built
 															/*!< This is used as a quick-and-dirty check that we know how to process this source */
@@ -71,6 +72,7 @@ namespace mxflib
 			size_t BytesRemaining;							//!< The number of bytes remaining in a multi-part GetEssenceData, or zero if not part read
 
 			bool PaddingEnabled;							//!< Is padding after the end of the essence stream enabled?
+			size_t BulkReadSize;							//!< The size of each read when clip wrapping (rounded down to whole wrapping sequences), or 0 to read the whole clip at once
 			DataChunkPtr PaddingChunk;						//!< A chunk containing padding bytes (if required) for use in GetPadding()
 
 		public:
@@ -80,6 +82,7 @@ namespace mxflib
 			{
 				BytesRemaining = 0;
 				PaddingEnabled = false;
+				BulkReadSize = 4 * 1024 * 1024;
 			};
 
 			//! Get the size of the essence data in bytes
@@ -99,6 +102,13 @@ namespace mxflib
 			 */
 			virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0);
 
+			//! Get a run of whole edit units in one call
+			/*! Batches are only read when frame wrapping, as the size of each edit unit then follows from the wrapping sequence */
+			virtual EssenceBatchPtr GetEssenceBatch(size_t MaxUnits, size_t MaxBytes);
+
+			//! Get the location of the rest of a clip if it is held as a single range of a file
+			virtual bool GetEssenceFileRange(FileHandle &InFile, Position &Start, Length &Size);
+
 			//! Did the last call to GetEssenceData() return the end of a wrapping item
 			/*! \return true if the last call to GetEssenceData() returned an entire wrapping unit.
 			 *  \return true if the last call to GetEssenceData() returned the last chunk of a wrapping unit.
@@ -148,6 +158,7 @@ namespace mxflib
 			SampleSequenceSize = 0;
 			SampleSequence = NULL;
 			SequencePos = 0;
+			SequenceSamples = 0;
 			DataStart = 0;
 			DataSize = 0;
 			CurrentPosition = 0;
@@ -184,6 +195,9 @@ namespace mxflib
 		//! Examine the open file and return a list of essence descriptors
 		virtual EssenceStreamDescriptorList IdentifyEssence(FileHandle InFile);
 
+		//! Check the probe data of a file to see if this parser may be able to identify the essence
+		virtual bool CanIdentify(const EssenceProbe &Probe);
+
 		//! Examine the open file and return the wrapping options known by this parser
 		virtual WrappingOptionList IdentifyWrappingOptions(FileHandle InFile, EssenceStreamDescriptor &Descriptor);
 
@@ -277,6 +291,9 @@ namespace mxflib
 		//! Get BytesPerEditUnit for a specified number of sample bytes (take into account KAG and K + L)
 		UInt32 GetBPE_Internal(UInt32 KAGSize, UInt32 SampleSize);
 
+		//! Get the number of bytes in the smallest run of whole edit units that always holds the same number of samples
+		size_t GetBlockUnitSize(void);
+
 		//! Read the sequence header at the specified position in an MPEG2 file to build an essence descriptor
 		MDObjectPtr BuildWaveAudioDescriptor(FileHandle InFile, UInt64 Start = 0);
 
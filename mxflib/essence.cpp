@@ -75,6 +75,12 @@ namespace
 	/*! This allows private or experimental system item keys to be treated as standard GC keys when reading 
 	 */
 	DataChunkList GCSystemKeyAlternatives;
+
+	//! Mask of the bytes tested when matching a GC essence element key - all but the version number (byte 8) and the item details
+	const UInt8 GCEssenceKeyMask[16] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+	//! Mask of the bytes tested when matching a GC system item key - as for essence keys but also ignoring the set or pack structure (byte 6)
+	const UInt8 GCSystemKeyMask[16] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00 };
 }
 
 
@@ -107,6 +113,13 @@ GCWriter::GCWriter(MXFFilePtr File, UInt32 BodySID /*=0*/, int Base /*=0*/)
 	ForceFillerBER4 = false;
 
 	NextWriteOrder = 0;
+
+	QueueBudget = 0;
+	QueuedBytes = 0;
+	PartialType = 0xff;
+
+	// Each stream normally adds one item to each content package
+	WriteQueue.reserve(StreamTableSize);
 }
 
 
@@ -402,6 +415,31 @@ void GCWriter::AddStreamIndex(GCStreamID ID, IndexManagerPtr &IndexMan, int Inde
 }
 
 
+//! Set a digest to receive the value of each essence KLV written for the specified stream
+void GCWriter::SetDigest(GCStreamID ID, EssenceDigestPtr Digest)
+{
+	// Index the data block for this stream
+	if((ID < 0) || (ID >= StreamCount))
+	{
+		error("Unknown stream ID in GCWriter::SetDigest()\n");
+		return;
+	}
+
+	StreamTable[ID].Digest = Digest;
+}
+
+
+//! Start a new partition in the digest of each stream, at a given file position
+void GCWriter::StartDigestPartition(Position Partition)
+{
+	int i;
+	for(i=0; i<StreamCount; i++)
+	{
+		if(StreamTable[i].Digest) StreamTable[i].Digest->StartPartition(Partition);
+	}
+}
+
+
 //! Add system item data to the current CP
 void GCWriter::AddSystemData(GCStreamID ID, UInt64 Size, const UInt8 *Data)
 {
@@ -417,24 +455,30 @@ void GCWriter::AddSystemData(GCStreamID ID, UInt64 Size, const UInt8 *Data)
 	}
 	GCStreamData *Stream = &StreamTable[ID];
 
-	// Set up a new buffer big enough for the key, a huge BER length and the data
-	UInt8 *Buffer = new UInt8[(size_t)(16 + 9 + Size)];
+	// Build the key the first time this stream is written
+	UInt8 *Header = Stream->KLHeader;
+	if(!Stream->KeyBuilt)
+	{
+		// Copy in the key template
+		memcpy(Header, GCSystemKey, 12);
+
+		// Set up the rest of the key
+		Header[5] = Stream->RegDes;
+		Header[7] = Stream->RegVer;
+		Header[12] = Stream->Type;
+		Header[13] = Stream->SchemeOrCount;
+		Header[14] = Stream->Element;
+		Header[15] = Stream->SubOrNumber;
 
-	// Copy in the key template
-	memcpy(Buffer, GCSystemKey, 12);
+		Stream->KeyBuilt = true;
+	}
 
-	// Set up the rest of the key
-	Buffer[5] = Stream->RegDes;
-	Buffer[7] = Stream->RegVer;
-	Buffer[12] = Stream->Type;
-	Buffer[13] = Stream->SchemeOrCount;
-	Buffer[14] = Stream->Element;
-	Buffer[15] = Stream->SubOrNumber;
+	// Set the length in the preformatted header and work out the start of the data field
+	size_t ValStart = 16 + MakeBER(&Header[16], 9, Size);
 
-	// Add the length and work out the start of the data field
-	DataChunkPtr BER = MakeBER(Size);
-	memcpy(&Buffer[16], BER->Data, BER->Size);
-	size_t ValStart = 16 + BER->Size;
+	// Set up a new buffer big enough for the key, the length and the data
+	UInt8 *Buffer = new UInt8[(size_t)(ValStart + Size)];
+	memcpy(Buffer, Header, ValStart);
 
 	// Copy the value into the buffer
 	memcpy(&Buffer[ValStart], Data, (size_t)Size);
@@ -458,7 +502,7 @@ void GCWriter::AddSystemData(GCStreamID ID, UInt64 Size, const UInt8 *Data)
 	else
 		WB.IndexFiller = false;
 
-	WriteQueue.insert(WriteQueueMap::value_type(Stream->WriteOrder, WB));
+	QueueBlock(Stream->WriteOrder, WB);
 }
 
 
@@ -473,54 +517,13 @@ void GCWriter::AddEssenceData(GCStreamID ID, UInt64 Size, const UInt8 *Data, Bod
 	}
 	GCStreamData *Stream = &StreamTable[ID];
 
-	// Set up a new buffer big enough for the key, a huge BER length and the data
-	UInt8 *Buffer = new UInt8[(size_t)(16 + 9 + Size)];
-
-	if(Stream->SpecifiedKey)
-	{
-		memcpy(Buffer, Stream->SpecifiedKey->Data, 16);
-	}
-	else
-	{
-		// Copy in the key template
-		memcpy(Buffer, GetGCEssenceKey(), 12);
-	}
-
-	// Update the last three GC track number bytes unless it's not a GC KLV
-	if(!Stream->NonGC)
-	{
-		// If we have't yet fixed the count then update it and fix it
-		if(!Stream->CountFixed)
-		{
-			// Count the number of elements of this type
-			int Count = 0;		// Start at zero, we will count this stream as we pass
-			int i;
-			for(i=0; i<StreamCount; i++)
-			{
-				// DRAGONS: Should we allow duplicates for same essence types of different element types?
-				if((StreamTable[i].Type == StreamTable[ID].Type) /*&& (StreamTable[i].Element == StreamTable[ID].Element)*/)
-				{
-					Count++;
-				}
-			}
-
-			Stream->SchemeOrCount = Count+StreamBase;
-			Stream->SubOrNumber = Count+StreamBase;	// Could use Count-1, but this is clearer
-			Stream->CountFixed = true;
-		}
-
-		// Set up the rest of the key
-		Buffer[7] = Stream->RegVer;
-		Buffer[12] = Stream->Type;
-		Buffer[13] = Stream->SchemeOrCount;
-		Buffer[14] = Stream->Element;
-		Buffer[15] = Stream->SubOrNumber;
-	}
+	// Set the length in the preformatted header and work out the start of the data field
+	UInt8 *Header = GetKLHeader(ID);
+	size_t ValStart = 16 + MakeBER(&Header[16], 9, Size, Stream->LenSize);
 
-	// Add the length and work out the start of the data field
-	DataChunkPtr BER = MakeBER(Size);
-	memcpy(&Buffer[16], BER->Data, BER->Size);
-	size_t ValStart = 16 + BER->Size;
+	// Set up a new buffer big enough for the key, the length and the data
+	UInt8 *Buffer = new UInt8[(size_t)(ValStart + Size)];
+	memcpy(Buffer, Header, ValStart);
 
 	// Copy the value into the buffer
 	memcpy(&Buffer[ValStart], Data, (size_t)Size);
@@ -533,6 +536,8 @@ void GCWriter::AddEssenceData(GCStreamID ID, UInt64 Size, const UInt8 *Data, Bod
 	WB.Stream = BStream;
 	WB.FastClipWrap = false;
 	WB.LenSize = Stream->LenSize;
+	WB.Digest = Stream->Digest;
+	WB.DigestOffset = ValStart;
 
 	// Add the index data
 	WB.IndexMan = Stream->IndexMan;
@@ -545,7 +550,7 @@ void GCWriter::AddEssenceData(GCStreamID ID, UInt64 Size, const UInt8 *Data, Bod
 	else
 		WB.IndexFiller = false;
 
-	WriteQueue.insert(WriteQueueMap::value_type(Stream->WriteOrder, WB));
+	QueueBlock(Stream->WriteOrder, WB);
 }
 
 
@@ -560,49 +565,9 @@ void GCWriter::AddEssenceData(GCStreamID ID, EssenceSourcePtr Source, bool FastC
 	}
 	GCStreamData *Stream = &StreamTable[ID];
 
-	// Set up a new buffer big enough for the key alone - the BER length and data will be added later
-	UInt8 *Buffer = new UInt8[16];
-
-	if(Stream->SpecifiedKey)
-	{
-		memcpy(Buffer, Stream->SpecifiedKey->Data, 16);
-	}
-	else
-	{
-		// Copy in the key template
-		memcpy(Buffer, GetGCEssenceKey(), 12);
-	}
-
-	// Update the last three GC track number bytes unless it's not a GC KLV
-	if(!Stream->NonGC)
-	{
-		// If we have't yet fixed the count then update it and fix it
-		if(!Stream->CountFixed)
-		{
-			// Count the number of elements of this type
-			int Count = 0;		// Start at zero, we will count this stream as we pass
-			int i;
-			for(i=0; i<StreamCount; i++)
-			{
-				// DRAGONS: Should we allow duplicates for same essence types of different element types?
-				if((StreamTable[i].Type == StreamTable[ID].Type) /*&& (StreamTable[i].Element == StreamTable[ID].Element)*/)
-				{
-					Count++;
-				}
-			}
-
-			Stream->SchemeOrCount = Count+StreamBase;
-			Stream->SubOrNumber = Count+StreamBase;	// Could use Count-1, but this is clearer
-			Stream->CountFixed = true;
-		}
-
-		// Set up the rest of the key
-		Buffer[7] = Stream->RegVer;
-		Buffer[12] = Stream->Type;
-		Buffer[13] = Stream->SchemeOrCount;
-		Buffer[14] = Stream->Element;
-		Buffer[15] = Stream->SubOrNumber;
-	}
+	// Set up a new buffer big enough for the key and a huge BER length - the length will be set, and the data added, when written
+	UInt8 *Buffer = new UInt8[16 + 9];
+	memcpy(Buffer, GetKLHeader(ID), 16);
 
 	// Add this item to the write queue (the writer will free the memory and the EssenceSource)
 	WriteBlock WB;
@@ -613,6 +578,7 @@ void GCWriter::AddEssenceData(GCStreamID ID, EssenceSourcePtr Source, bool FastC
 	WB.Stream = BStream;
 	WB.FastClipWrap = FastClipWrap;
 	WB.LenSize = Stream->LenSize;
+	WB.Digest = Stream->Digest;
 
 	// Add the index data
 	WB.IndexMan = Stream->IndexMan;
@@ -625,7 +591,7 @@ void GCWriter::AddEssenceData(GCStreamID ID, EssenceSourcePtr Source, bool FastC
 	else
 		WB.IndexFiller = false;
 
-	WriteQueue.insert(WriteQueueMap::value_type(Stream->WriteOrder, WB));
+	QueueBlock(Stream->WriteOrder, WB);
 }
 
 
@@ -641,8 +607,43 @@ void GCWriter::AddEssenceData(GCStreamID ID, KLVObjectPtr Source, bool FastClipW
 	}
 	GCStreamData *Stream = &StreamTable[ID];
 
-	// Set up a new buffer big enough for the key alone - the BER length and data will be added later
-	UInt8 *Buffer = new UInt8[16];
+	// Set up a new buffer big enough for the key and a huge BER length - the length will be set, and the data added, when written
+	UInt8 *Buffer = new UInt8[16 + 9];
+	memcpy(Buffer, GetKLHeader(ID), 16);
+
+	// Add this item to the write queue (the writer will free the memory and the EssenceSource)
+	WriteBlock WB;
+	WB.Size = 16;
+	WB.Buffer = Buffer;
+	WB.KLVSource = Source;
+	WB.Stream = BStream;
+	WB.FastClipWrap = FastClipWrap;
+	WB.LenSize = Stream->LenSize;
+	WB.Digest = Stream->Digest;
+
+	// Add the index data
+	WB.IndexMan = Stream->IndexMan;
+	if(WB.IndexMan)
+	{
+		WB.IndexSubStream = Stream->IndexSubStream;
+		WB.IndexFiller = Stream->IndexFiller;
+		WB.IndexClip = Stream->IndexClip;
+	}
+	else
+		WB.IndexFiller = false;
+
+	QueueBlock(Stream->WriteOrder, WB);
+}
+
+
+
+//! Get the preformatted key of an essence stream, followed by space for a BER length, building it the first time
+UInt8 *GCWriter::GetKLHeader(GCStreamID ID)
+{
+	GCStreamData *Stream = &StreamTable[ID];
+	UInt8 *Buffer = Stream->KLHeader;
+
+	if(Stream->KeyBuilt) return Buffer;
 
 	if(Stream->SpecifiedKey)
 	{
@@ -651,7 +652,7 @@ void GCWriter::AddEssenceData(GCStreamID ID, KLVObjectPtr Source, bool FastClipW
 	else
 	{
 		// Copy in the key template
-		memcpy(Buffer, GetGCEssenceKey(), 12);
+		memcpy(Buffer, GetGCEssenceKey(), 16);
 	}
 
 	// Update the last three GC track number bytes unless it's not a GC KLV
@@ -685,31 +686,12 @@ void GCWriter::AddEssenceData(GCStreamID ID, KLVObjectPtr Source, bool FastClipW
 		Buffer[15] = Stream->SubOrNumber;
 	}
 
-	// Add this item to the write queue (the writer will free the memory and the EssenceSource)
-	WriteBlock WB;
-	WB.Size = 16;
-	WB.Buffer = Buffer;
-	WB.KLVSource = Source;
-	WB.Stream = BStream;
-	WB.FastClipWrap = FastClipWrap;
-	WB.LenSize = Stream->LenSize;
-
-	// Add the index data
-	WB.IndexMan = Stream->IndexMan;
-	if(WB.IndexMan)
-	{
-		WB.IndexSubStream = Stream->IndexSubStream;
-		WB.IndexFiller = Stream->IndexFiller;
-		WB.IndexClip = Stream->IndexClip;
-	}
-	else
-		WB.IndexFiller = false;
+	Stream->KeyBuilt = true;
 
-	WriteQueue.insert(WriteQueueMap::value_type(Stream->WriteOrder, WB));
+	return Buffer;
 }
 
 
-
 //! Get the track number associated with the specified essence stream
 /*! \note Once this function has been called for a stream, or an element
  *		  of the stream has been written, the value of "EssenceElementCount"
@@ -765,9 +747,9 @@ UInt64 GCWriter::CalcWriteSize(void)
 	UInt64 Ret = 0;
 
 	//! The last type written - KAG alignment is performed between different types
-	UInt8 LastType = 0xff;
+	UInt8 LastType = PartialType;
 
-	WriteQueueMap::iterator it = WriteQueue.begin();
+	WriteQueueList::iterator it = WriteQueue.begin();
 	while(it != WriteQueue.end())
 	{
 		// The most significant byte is basically the item type
@@ -793,9 +775,9 @@ UInt64 GCWriter::CalcWriteSize(void)
 		// Add any KLVObject-buffered essence data
 		if((*it).second.KLVSource)
 		{
+			UInt8 BER[9];
 			Length Size = (*it).second.KLVSource->GetLength();
-			DataChunkPtr BER = MakeBER(Size);
-			Ret += BER->Size + Size;
+			Ret += MakeBER(BER, 9, Size) + Size;
 		}
 		// Add any non-buffered essence data
 		else if((*it).second.Source)
@@ -804,9 +786,9 @@ UInt64 GCWriter::CalcWriteSize(void)
 			// to flag that we cannot know the size of the next write
 			if((*it).second.FastClipWrap) return (UInt64)-1;
 
+			UInt8 BER[9];
 			size_t Size = (*it).second.Source->GetEssenceDataSize();
-			DataChunkPtr BER = MakeBER(Size);
-			Ret += BER->Size + Size;
+			Ret += MakeBER(BER, 9, Size, (*it).second.LenSize) + Size;
 		}
 
 		LastType = ThisType;
@@ -839,7 +821,7 @@ UInt64 GCWriter::CalcWriteSize(void)
 GCWriter::~GCWriter()
 {
 	// Clear the write-queue buffers
-	WriteQueueMap::iterator it = WriteQueue.begin();
+	WriteQueueList::iterator it = WriteQueue.begin();
 	while(it != WriteQueue.end())
 	{
 		delete[] (*it).second.Buffer;
@@ -850,17 +832,53 @@ GCWriter::~GCWriter()
 	delete[] StreamTable;
 }
 
+//! Add an item to the write queue in write order, writing the queue early if it is over budget
+void GCWriter::QueueBlock(UInt32 WriteOrder, const WriteBlock &Block)
+{
+	// Items are nearly always added in write order, so search back from the end for the insertion point
+	WriteQueueList::iterator it = WriteQueue.end();
+	while((it != WriteQueue.begin()) && ((*(it - 1)).first > WriteOrder)) it--;
+
+	WriteQueue.insert(it, WriteQueueList::value_type(WriteOrder, Block));
+	QueuedBytes += Block.Size;
+
+	if(QueueBudget && (QueuedBytes > QueueBudget))
+	{
+		StatsAdd(StatsGCWriterEarlyWrites);
+		WriteQueued(false);
+	}
+}
+
+
 //! Flush any remaining data
-/*! \note It is important that any changes to this function are propogated to CalcWriteSize() */
 void GCWriter::Flush(void)
 {
+	WriteQueued(true);
+
+	// Increment edit unit
+	// TODO: This doesn't take account of non-frame wrapping index calculations
+	IndexEditUnit++;
+}
+
+
+//! Write the items in the write queue
+/*! \note It is important that any changes to this function are propogated to CalcWriteSize() */
+void GCWriter::WriteQueued(bool EndCP)
+{
+	TraceScope Trace(EndCP ? "GCWriter::Flush" : "GCWriter::EarlyWrite", "write");
+
 	//! Stream offset of the first byte of the key for this KLV - this will later be turned into the size of the (Key+Length) once they are written
 	Position KLSize = StreamOffset;
 
 	//! The last type written - KAG alignment is performed between different types
-	UInt8 LastType = 0xff;
+	//! DRAGONS: Continuing the type of an early write means the rest of the content package is not realigned, nor its filler indexed again
+	UInt8 LastType = PartialType;
+
+	// Gather the whole content package, including any KAG filler, so it reaches the file as a single write
+	bool Gathering = !LinkedFile->IsGathering();
+	if(Gathering) LinkedFile->StartGather();
 
-	WriteQueueMap::iterator it = WriteQueue.begin();
+	WriteQueueList::iterator it = WriteQueue.begin();
 	while(it != WriteQueue.end())
 	{
 		// The most significant byte is basically the item type
@@ -894,22 +912,48 @@ void GCWriter::Flush(void)
 			if(!(*it).second.IndexClip) (*it).second.IndexMan->OfferOffset((*it).second.IndexSubStream, IndexEditUnit, StreamOffset);
 		}
 
-		// Write the pre-formatted data and free its buffer
-		StreamOffset += LinkedFile->Write((*it).second.Buffer, (UInt32)((*it).second.Size));
+		// Set the length of any item whose value is not yet buffered in the space left after its key
+		// DRAGONS: The size of a fast clip wrapped item is not known, so it is flagged as the rest of the file and its position recorded for later correction
+		UInt64 HeaderSize = (*it).second.Size;
+		UInt64 Size = 0;
+		Position LenPosition = 0;
+		if((*it).second.KLVSource)
+		{
+			Size = (*it).second.KLVSource->GetLength();
+			HeaderSize += MakeBER(&(*it).second.Buffer[HeaderSize], 9, Size);
+		}
+		else if((*it).second.Source)
+		{
+			if((*it).second.FastClipWrap)
+			{
+				if((*it).second.LenSize == 4) Size = 0x00ffffff;
+				else Size = UINT64_C(0x00ffffffffffffff);
+
+				LenPosition = LinkedFile->Tell() + HeaderSize;
+			}
+			else Size = (*it).second.Source->GetEssenceDataSize();
+
+			HeaderSize += MakeBER(&(*it).second.Buffer[HeaderSize], 9, Size, (*it).second.LenSize);
+		}
+
+		// Write the pre-formatted data, including the key and length of any item whose value follows, and free its buffer
+		StreamOffset += LinkedFile->Write((*it).second.Buffer, (UInt32)HeaderSize);
+
+		// Digest the value if it is held in the buffer
+		EssenceDigestPtr &Digest = (*it).second.Digest;
+		if(Digest && (!(*it).second.Source) && (!(*it).second.KLVSource) && ((*it).second.Size > (*it).second.DigestOffset))
+		{
+			Digest->HashData(static_cast<size_t>((*it).second.Size - (*it).second.DigestOffset), &(*it).second.Buffer[(*it).second.DigestOffset]);
+		}
+
 		delete[] (*it).second.Buffer;
 
 		// Handle any KLVObject-buffered essence data
 		if((*it).second.KLVSource)
 		{
-			UInt64 Size = (*it).second.KLVSource->GetLength();
-
 			// Increment the EssenceData count in the source stream
 			if((*it).second.Stream) (*it).second.Stream->IncrementOverallEssenceSize(static_cast<Length>(Size));
 
-			// Write out the length
-			DataChunkPtr BER = MakeBER(Size);
-			StreamOffset += LinkedFile->Write(*BER);
-
 			// Write out all the data
 			Position Offset = 0;
 			for(;;)
@@ -922,34 +966,17 @@ void GCWriter::Flush(void)
 				if(!Bytes) break;
 
 				StreamOffset += LinkedFile->Write((*it).second.KLVSource->GetData());
+				if(Digest) Digest->HashData((*it).second.KLVSource->GetData());
 			}
 		}
 		// Handle any non-buffered essence data
 		else if((*it).second.Source)
 		{
-			Position LenPosition = 0;
-			UInt64 Size;
-
-			// If we are fast clip wrapping flag the rest of the file as the value
-			// and record the location of this length for later correction
-			if((*it).second.FastClipWrap)
-			{
-				if((*it).second.LenSize == 4) Size = 0x00ffffff;
-				else Size = UINT64_C(0x00ffffffffffffff);
-
-				LenPosition = LinkedFile->Tell();
-			}
-			else 
-			{
-				Size = (*it).second.Source->GetEssenceDataSize();
-				
-				// Increment the EssenceData count in the source stream
-				if((*it).second.Stream) (*it).second.Stream->IncrementOverallEssenceSize(static_cast<Length>(Size));
-			}
+			// Increment the EssenceData count in the source stream
+			if((!(*it).second.FastClipWrap) && (*it).second.Stream) (*it).second.Stream->IncrementOverallEssenceSize(static_cast<Length>(Size));
 
-			// Write out the length
-			int LenSize = LinkedFile->WriteBER(Size, (*it).second.LenSize);
-			StreamOffset += LenSize;
+			// The size of the BER length, used when correcting a fast clip wrapped length
+			int LenSize = static_cast<int>(HeaderSize - (*it).second.Size);
 
 			// Fast access to IndexClip flag
 			bool IndexClip = ((*it).second.IndexMan) && ((*it).second.IndexClip);
@@ -966,6 +993,20 @@ void GCWriter::Flush(void)
 				KLSize = 0;
 			}
 
+			// A clip held as a single range of a file is copied by the OS, so it need not pass through user space
+			// DRAGONS: This is not done when building a VBR index of the clip, as each edit unit must then be offered to the index manager,
+			//          or when making a digest of the essence, as the data must then pass through the digest
+			FileHandle RangeFile;
+			Position RangeStart;
+			Length RangeSize;
+			if(((!IndexClip) || (*it).second.IndexMan->IsCBR()) && (!Digest) && (*it).second.Source->GetEssenceFileRange(RangeFile, RangeStart, RangeSize))
+			{
+				UInt64 Bytes = LinkedFile->WriteFromFile(RangeFile, RangeStart, RangeSize);
+				if(Bytes != static_cast<UInt64>(RangeSize)) error("Only 0x%s of 0x%s bytes of clip copied from the essence file\n", Int64toHexString(Bytes).c_str(), Int64toHexString(RangeSize).c_str());
+
+				StreamOffset += Bytes;
+			}
+
 			// Write out all the data
 			for(;;)
 			{
@@ -984,7 +1025,12 @@ void GCWriter::Flush(void)
 					}
 				}
 
-				DataChunkPtr Data = (*it).second.Source->GetEssenceData(0, MaxWrapChunkSize);
+				DataChunkPtr Data;
+				{
+					StatsTimer Timer(StatsEssenceDataCalls);
+					TraceScope Trace("GetEssenceData", "essence");
+					Data = (*it).second.Source->GetEssenceData(0, MaxWrapChunkSize);
+				}
 				
 				// Exit when no more data left
 				if(!Data) break;
@@ -1033,6 +1079,7 @@ void GCWriter::Flush(void)
 #else
 			StreamOffset += LinkedFile->Write(*Data);
 #endif
+				if(Digest) Digest->HashData(*Data);
 
 			}
 
@@ -1061,12 +1108,28 @@ void GCWriter::Flush(void)
 			}
 		}
 
-		WriteQueue.erase(it);
-		it = WriteQueue.begin();
+		// Release the source now, rather than when the whole queue is cleared, as it may hold a lot of data
+		(*it).second.Source = NULL;
+		(*it).second.KLVSource = NULL;
+		(*it).second.Stream = NULL;
 
 		LastType = ThisType;
+		it++;
+	}
+
+	WriteQueue.clear();
+	QueuedBytes = 0;
+
+	// An early write leaves the rest of the content package to follow on directly
+	if(!EndCP)
+	{
+		PartialType = LastType;
+		if(Gathering) LinkedFile->EndGather();
+		return;
 	}
 
+	PartialType = 0xff;
+
 
 	// DRAGONS: This is a bit of a fudge to cope with new partitions 
 	//          being inserted after us and that causing a filler...
@@ -1088,9 +1151,7 @@ void GCWriter::Flush(void)
 		}
 	}
 
-	// Increment edit unit
-	// TODO: This doesn't take account of non-frame wrapping index calculations
-	IndexEditUnit++;
+	if(Gathering) LinkedFile->EndGather();
 }
 
 
@@ -1365,10 +1426,9 @@ Length GCWriter::CalcRawSize(KLVObjectPtr Object)
 }
 
 
-//! Write a raw KLVObject to the file - this is written immediately and not buffered in the WriteQueue
-void GCWriter::WriteRaw(KLVObjectPtr Object)
+//! Align the file to the KAG, counting any filler in the stream offset
+void GCWriter::AlignToKAG(void)
 {
-	// Align to the next KAG
 	if(KAGSize > 1)
 	{
 		if(!LinkedFile->IsBlockAligned())
@@ -1382,6 +1442,17 @@ void GCWriter::WriteRaw(KLVObjectPtr Object)
 			// DRAGONS: Should we do something here?
 		}
 	}
+}
+
+
+//! Write a raw KLVObject to the file - this is written immediately and not buffered in the WriteQueue
+/*! \param Align If false the KLV is written at the current position with no filler before or after it,
+ *                which allows the caller to align only chosen KLVs by calling AlignToKAG() first
+ */
+void GCWriter::WriteRaw(KLVObjectPtr Object, bool Align /*=true*/)
+{
+	// Align to the next KAG
+	if(Align) AlignToKAG();
 
 	// Set this file and position as the destination for the KLVObject
 	Object->SetDestination(LinkedFile);
@@ -1407,19 +1478,7 @@ void GCWriter::WriteRaw(KLVObjectPtr Object)
 	//          being inserted after us and that causing a filler...
 
 	// Align to the next KAG
-	if(KAGSize > 1)
-	{
-		if(!LinkedFile->IsBlockAligned())
-		{
-			UInt64 Pos = LinkedFile->Tell();
-			StreamOffset += LinkedFile->Align(ForceFillerBER4, KAGSize) - Pos;
-		}
-		else
-		{
-			// Do nothing when block aligned
-			// DRAGONS: Should we do something here?
-		}
-	}
+	if(Align) AlignToKAG();
 
 	return;
 }
@@ -1439,8 +1498,15 @@ GCReader::GCReader( MXFFilePtr File, GCReadHandlerPtr DefaultHandler /*=NULL*/,
 	StopNow = false;
 	StopCalled = false;
 	PushBackRequested = false;
+	HeaderOnly = false;
+	Positional = false;
+
+	AsyncDepth = 8;
 
 	StreamOffset = 0;
+
+	LastKeyValid = false;
+	LastHandler = NULL;
 }
 
 
@@ -1451,9 +1517,12 @@ GCReader::GCReader( MXFFilePtr File, GCReadHandlerPtr DefaultHandler /*=NULL*/,
  */
 bool GCReader::ReadFromFile(bool SingleKLV /*=false*/)
 {
+	// Values are already read by the engine if we are reading ahead
+	if(AsyncEngine && (!HeaderOnly)) return ReadFromFileAsync(SingleKLV);
+
 	// Seek to the offset of the "next" KLV
 	mxflib_assert(File);
-	File->Seek(FileOffset);
+	if(!Positional) File->Seek(FileOffset);
 
 	// Force us to stop as soon as we have read a single KLV if requested
 	StopNow = SingleKLV;
@@ -1463,7 +1532,10 @@ bool GCReader::ReadFromFile(bool SingleKLV /*=false*/)
 	do
 	{
 		// Get the next KLV
-		KLVObjectPtr Object = File->ReadKLV();
+		// DRAGONS: Positional reads only ever read the key and length, as ReadKLV() does, leaving the value until it is needed
+		KLVObjectPtr Object;
+		if(Positional) Object = File->ReadKLVHeaderAt(FileOffset);
+		else Object = HeaderOnly ? File->ReadKLVHeader() : File->ReadKLV();
 
 		// Exit if we failed
 		if(!Object)	return false;
@@ -1472,12 +1544,13 @@ bool GCReader::ReadFromFile(bool SingleKLV /*=false*/)
 		if(IsPartitionKey(Object->GetUL()->GetValue())) return true;
 
 		// Handle the data
+		StatsAdd(StatsKLVsDispatched);
 		bool Ret = HandleData(Object);
 		
 		// Perform a pushback (if requested) by seeking to the start of this KLV and not updating offsets
 		if(StopNow && PushBackRequested)
 		{
-			File->Seek(FileOffset);
+			if(!Positional) File->Seek(FileOffset);
 		}
 		else
 		{
@@ -1491,7 +1564,7 @@ bool GCReader::ReadFromFile(bool SingleKLV /*=false*/)
 		if(!Ret) return false;
 
 		// Seek to the next KLV
-		File->Seek(FileOffset);
+		if(!Positional) File->Seek(FileOffset);
 
 	} while(!StopNow);
 
@@ -1504,54 +1577,179 @@ bool GCReader::ReadFromFile(bool SingleKLV /*=false*/)
 }
 
 
-//! Force a KLVObject to be handled
-/*! \note This is not the normal way that the GCReader is used, but allows the encryption handler
- *        to push the decrypted data back to the GCReader to pass to the appropriate handler
- *  \return true if all OK, false on error
+//! Read from file using AsyncEngine to read values ahead of dispatch
+/*! All KLVs are dispatched to handlers
+ *  Stops reading at the next partition pack unless SingleKLV is true when only one KLV is dispatched
+ *  \return true if all went well, false end-of-file, an error occured or StopReading() was called
  */
-bool GCReader::HandleData(KLVObjectPtr Object)
+bool GCReader::ReadFromFileAsync(bool SingleKLV)
 {
-	// First check is this KLV is a filler
-	// We first check if byte 9 == 3 which is true for filler keys, but is
-	// false for all GC sets and packs. Once this matches we can do a full memcmp.
-	if(Object->GetUL()->GetValue()[8] == 3)
+	mxflib_assert(File);
+
+	// Force us to stop as soon as we have read a single KLV if requested
+	StopNow = SingleKLV;
+	StopCalled = false;
+
+	// Reads submitted but not yet dispatched, in file order
+	std::list<AsyncReadEngine::RequestPtr> Pending;
+
+	// The file offset of the next KLV to submit, and the result to return when there are no more to submit
+	Position ScanOffset = FileOffset;
+	bool Scanning = true;
+	bool ScanRet = false;
+
+	// Don't read ahead of a single KLV as it is unlikely to be wanted
+	size_t Depth = SingleKLV ? 1 : AsyncDepth;
+
+	bool Ret = true;
+	bool Exhausted = false;
+	do
 	{
-		const UInt8 FillerKey[16] = { 0x06, 0x0E, 0x2B, 0x34, 0x01, 0x01, 0x01, 0x01, 0x03, 0x01, 0x02, 0x10, 0x01, 0x00, 0x00, 0x00 };
-		if( memcmp(Object->GetUL()->GetValue(), FillerKey, 16) == 0 )
+		// Keep the engine busy with the following KLVs
+		while(Scanning && (Pending.size() < Depth))
+		{
+			KLVObjectPtr Object = File->ReadKLVHeaderAt(ScanOffset);
+
+			// Stop at the end of the file or at the next partition pack, which is not dispatched
+			if((!Object) || IsPartitionKey(Object->GetUL()->GetValue()))
+			{
+				Scanning = false;
+				ScanRet = Object ? true : false;
+				break;
+			}
+
+			// There is no need to read the value of a filler that nobody will see, so queue it without submitting it
+			if((!FillerHandler) && IsFiller(Object))
+			{
+				Pending.push_back(new AsyncReadEngine::Request(Object));
+				ScanOffset += Object->GetKLSize() + Object->GetLength();
+				continue;
+			}
+
+			AsyncReadEngine::RequestPtr ThisRequest = AsyncEngine->Submit(Object);
+
+			// If the engine can't start any threads, read as normal
+			if(!ThisRequest)
+			{
+				error("Unable to start asynchronous reads of %s, reading synchronously\n", File->Name.c_str());
+				AsyncEngine = NULL;
+				return ReadFromFile(SingleKLV);
+			}
+
+			Pending.push_back(ThisRequest);
+			ScanOffset += Object->GetKLSize() + Object->GetLength();
+		}
+
+		if(Pending.empty())
+		{
+			Exhausted = true;
+			Ret = ScanRet;
+			break;
+		}
+
+		AsyncReadEngine::RequestPtr ThisRequest = Pending.front();
+		Pending.pop_front();
+
+		KLVObjectPtr Object = ThisRequest->GetObject();
+		Length Size = Object->GetKLSize() + Object->GetLength();
+
+		// Skip fillers that are not dispatched
+		if((!FillerHandler) && IsFiller(Object))
+		{
+			FileOffset += Size;
+			StreamOffset += Size;
+			continue;
+		}
+
+		if(!AsyncEngine->Wait(ThisRequest))
 		{
-			if(FillerHandler) return FillerHandler->HandleData(this, Object);
-			else return true;
+			Ret = false;
+			break;
+		}
+
+		// Handle the data
+		StatsAdd(StatsKLVsDispatched);
+		Ret = HandleData(Object);
+
+		// Perform a pushback (if requested) by not updating offsets
+		if(!(StopNow && PushBackRequested))
+		{
+			// Advance to the start of the next KLV and update stream offset 
+			FileOffset += Size;
+			StreamOffset += Size;
 		}
+
+		// Abort if the handler errored
+		if(!Ret) break;
+
+	} while(!StopNow);
+
+	// Abandon any reads we no longer need
+	std::list<AsyncReadEngine::RequestPtr>::iterator it = Pending.begin();
+	while(it != Pending.end())
+	{
+		AsyncEngine->Cancel(*it);
+		it++;
+	}
+
+	// If we stopped because StopReading() was called, or after a single KLV, return its status
+	if(Ret && !Exhausted) return StopCalled;
+
+	return Ret;
+}
+
+
+//! Force a KLVObject to be handled
+/*! \note This is not the normal way that the GCReader is used, but allows the encryption handler
+ *        to push the decrypted data back to the GCReader to pass to the appropriate handler
+ *  \return true if all OK, false on error
+ */
+bool GCReader::HandleData(KLVObjectPtr Object)
+{
+	// First check is this KLV is a filler
+	if(IsFiller(Object))
+	{
+		if(FillerHandler) return FillerHandler->HandleData(this, Object);
+		else return true;
 	}
 
 	// Next check if this KLV is encrypted essence data - but only if we have an encryption handler
-	if(EncryptionHandler)
+	// DRAGONS: Decryption needs the value, so encrypted KLVs are not decrypted when reading headers only
+	if(EncryptionHandler && !HeaderOnly)
 	{
 		// We first check if byte 6 == 4 (variable pack) which is true for encrypted data keys,
 		// but is false for standard GC sets and packs. Once this matches we can do a full memcmp.
 		if(Object->GetUL()->GetValue()[5] == 4)
 		{
 			const UInt8 EncryptedKey[16] = { 0x06, 0x0E, 0x2B, 0x34, 0x02, 0x04, 0x01, 0x07, 0x0d, 0x01, 0x03, 0x01, 0x02, 0x7e, 0x01, 0x00 };
-			if( memcmp(Object->GetUL()->GetValue(), EncryptedKey, 16) == 0 )
+			if(ULEquals(Object->GetUL()->GetValue(), EncryptedKey))
 			{
 				return EncryptionHandler->HandleData(this, Object);
 			}
 		}
 	}
 
-	// Get the track-number of this GC item (or zero if not GC)
-	// Note that we don't bother if no handlers have been registered 
+	// Note that we don't bother looking for a track handler if none have been registered
 	// because we will have to use the defualt handler whatever!
-	UInt32 TrackNumber; 
-	if(!Handlers.size()) TrackNumber = 0; else TrackNumber = Object->GetGCTrackNumber();
-
-	if( TrackNumber != 0 )
+	if(!DispatchTable.empty())
 	{
-		// See if we have a handler registered for this track
-		std::map<UInt32, GCReadHandlerPtr>::iterator it = Handlers.find(TrackNumber);
+		ULPtr Key = Object->GetUL();
+
+		// Consecutive KLVs are often from the same track, so see if this is the same key as last time
+		if(!(LastKeyValid && ULEquals(Key->GetValue(), LastKey)))
+		{
+			// Get the track-number of this GC item (or zero if not GC)
+			UInt32 TrackNumber = Object->GetGCTrackNumber();
+
+			LastHandler = TrackNumber ? FindDataHandler(TrackNumber) : NULL;
 
-		// If so use that handler
-		if(it != Handlers.end()) return (*it).second->HandleData(this, Object);
+			// DRAGONS: Only remember this key if it gives the track number on its own, which is not the case
+			//          for objects such as KLVEObjects that take their track number from elsewhere
+			LastKeyValid = (GetGCTrackNumber(Key) == TrackNumber);
+			if(LastKeyValid) memcpy(LastKey, Key->GetValue(), 16);
+		}
+
+		if(LastHandler) return LastHandler->HandleData(this, Object);
 	}
 
 	// By this point we only have the default handler left
@@ -1562,6 +1760,71 @@ bool GCReader::HandleData(KLVObjectPtr Object)
 }
 
 
+//! Determine if a KLV is a filler
+bool GCReader::IsFiller(KLVObjectPtr &Object)
+{
+	// We first check if byte 9 == 3 which is true for filler keys, but is
+	// false for all GC sets and packs. Once this matches we can do a full memcmp.
+	const UInt8 *Key = Object->GetUL()->GetValue();
+	if(Key[8] != 3) return false;
+
+	const UInt8 FillerKey[16] = { 0x06, 0x0E, 0x2B, 0x34, 0x01, 0x01, 0x01, 0x01, 0x03, 0x01, 0x02, 0x10, 0x01, 0x00, 0x00, 0x00 };
+	return ULEquals(Key, FillerKey);
+}
+
+
+//! Rebuild DispatchTable from Handlers, and forget the last dispatch
+void GCReader::BuildDispatchTable(void)
+{
+	DispatchTable.clear();
+	DispatchTable.reserve(Handlers.size());
+
+	// DRAGONS: The map is already sorted by track number, so the table will be too
+	std::map<UInt32, GCReadHandlerPtr>::iterator it = Handlers.begin();
+	while(it != Handlers.end())
+	{
+		DispatchTable.push_back(std::pair<UInt32, GCReadHandler_Base*>((*it).first, (*it).second.GetPtr()));
+		it++;
+	}
+
+	LastKeyValid = false;
+	LastHandler = NULL;
+}
+
+
+//! Find the data handler for a given track number
+/*! \return NULL if there is no specific handler for this track
+ */
+GCReadHandler_Base *GCReader::FindDataHandler(UInt32 TrackNumber) const
+{
+	// A typical file has only a few tracks, so a simple scan of the table is quickest
+	if(DispatchTable.size() <= 8)
+	{
+		std::vector<std::pair<UInt32, GCReadHandler_Base*> >::const_iterator it = DispatchTable.begin();
+		while(it != DispatchTable.end())
+		{
+			if((*it).first == TrackNumber) return (*it).second;
+			it++;
+		}
+
+		return NULL;
+	}
+
+	// Otherwise binary chop the sorted table
+	size_t Low = 0;
+	size_t High = DispatchTable.size();
+	while(Low < High)
+	{
+		size_t Mid = (Low + High) / 2;
+		if(DispatchTable[Mid].first < TrackNumber) Low = Mid + 1; else High = Mid;
+	}
+
+	if((Low < DispatchTable.size()) && (DispatchTable[Low].first == TrackNumber)) return DispatchTable[Low].second;
+
+	return NULL;
+}
+
+
 //! Stop reading even though there appears to be valid data remaining
 /*! This function can be called from a handler if it detects that the current KLV is either the last
  *  KLV in partition, or does not belong in this partition at all.  If the KLV belongs to another
@@ -1587,9 +1850,141 @@ BodyReader::BodyReader(MXFFilePtr File)
 	AtEOF = false;					// We don't know if we are at the end of the file
 
 	CurrentBodySID = 0;				// We don't know what BodySID we are now in
+
+	PrefetchCount = 0;				// No prefetching unless requested
+	GCRHeaderOnly = false;			// Read complete KLVs unless requested
+	GCRAsyncDepth = 8;				// Default read-ahead if an engine is set
+
+	ParallelDispatch = false;		// Run all handlers on the reading thread unless requested
+	DispatchDepth = 64;
 };
 
 
+//! Wait for any KLVs still being dispatched in parallel
+BodyReader::~BodyReader()
+{
+	WaitDispatch();
+}
+
+
+//! Enable or disable header-only reading for all GCReaders, including those already made
+void BodyReader::SetHeaderOnly(bool Enable /*=true*/)
+{
+	GCRHeaderOnly = Enable;
+
+	std::map<UInt32, GCReaderPtr>::iterator it = Readers.begin();
+	while(it != Readers.end())
+	{
+		(*it).second->SetHeaderOnly(Enable);
+		it++;
+	}
+
+	std::map<UInt32, StreamDispatcherPtr>::iterator Dispatcher_it = Dispatchers.begin();
+	while(Dispatcher_it != Dispatchers.end())
+	{
+		(*Dispatcher_it).second->GetFramer()->SetHeaderOnly(Enable);
+		Dispatcher_it++;
+	}
+}
+
+
+//! Read the values of KLVs ahead of dispatch for all GCReaders, including those already made
+void BodyReader::SetAsyncRead(AsyncReadEnginePtr Engine, unsigned int Depth /*=8*/)
+{
+	GCRAsyncEngine = Engine;
+	GCRAsyncDepth = Depth;
+
+	std::map<UInt32, GCReaderPtr>::iterator it = Readers.begin();
+	while(it != Readers.end())
+	{
+		(*it).second->SetAsyncRead(Engine, Depth);
+		it++;
+	}
+
+	std::map<UInt32, StreamDispatcherPtr>::iterator Dispatcher_it = Dispatchers.begin();
+	while(Dispatcher_it != Dispatchers.end())
+	{
+		(*Dispatcher_it).second->GetFramer()->SetAsyncRead(Engine, Depth);
+		Dispatcher_it++;
+	}
+}
+
+
+//! Enable or disable running the handlers of each BodySID in parallel
+void BodyReader::SetParallelDispatch(bool Enable /*=true*/, unsigned int Depth /*=64*/)
+{
+	DispatchDepth = Depth;
+	if(Enable == ParallelDispatch) return;
+
+	// The framers hold the offsets of any read in progress, so give them back to the GCReaders to continue from
+	if(!Enable)
+	{
+		WaitDispatch();
+
+		std::map<UInt32, StreamDispatcherPtr>::iterator it = Dispatchers.begin();
+		while(it != Dispatchers.end())
+		{
+			GCReaderPtr Reader = GetGCReader((*it).first);
+			if(Reader && (*it).second->IsParallel())
+			{
+				GCReaderPtr Framer = (*it).second->GetFramer();
+
+				Reader->SetFileOffset(Framer->GetFileOffset());
+				Reader->SetStreamOffset(Framer->GetStreamOffset());
+			}
+			it++;
+		}
+
+		Dispatchers.clear();
+	}
+
+	ParallelDispatch = Enable;
+}
+
+
+//! Wait for all KLVs handed to the handlers in parallel to be dispatched
+bool BodyReader::WaitDispatch(void)
+{
+	bool Ret = true;
+
+	std::map<UInt32, StreamDispatcherPtr>::iterator it = Dispatchers.begin();
+	while(it != Dispatchers.end())
+	{
+		if(!(*it).second->Wait()) Ret = false;
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Get the GCReader to read the specified BodySID on this thread, which is its dispatcher's framer when dispatching in parallel
+GCReaderPtr BodyReader::GetReadingReader(UInt32 BodySID)
+{
+	GCReaderPtr Reader = GetGCReader(BodySID);
+	if((!Reader) || (!ParallelDispatch)) return Reader;
+
+	StreamDispatcherPtr &Dispatcher = Dispatchers[BodySID];
+	if(!Dispatcher)
+	{
+		Dispatcher = new StreamDispatcher(File, Reader, DispatchDepth);
+
+		// The framer continues from wherever the GCReader had got to
+		GCReaderPtr Framer = Dispatcher->GetFramer();
+		if(Dispatcher->IsParallel())
+		{
+			Framer->SetHeaderOnly(GCRHeaderOnly);
+			if(GCRAsyncEngine) Framer->SetAsyncRead(GCRAsyncEngine, GCRAsyncDepth);
+
+			Framer->SetFileOffset(Reader->GetFileOffset());
+			Framer->SetStreamOffset(Reader->GetStreamOffset());
+		}
+	}
+
+	return Dispatcher->GetFramer();
+}
+
+
 //! Seek to a specific point in the file
 /*! \return New location or -1 on seek error
  */
@@ -1615,7 +2010,9 @@ Position BodyReader::Seek(Position Pos /*=0*/)
 Position BodyReader::Seek(UInt32 BodySID, Position Pos)
 {
 	// We <b>need</b> a RIP for this to work
-	if(File->FileRIP.empty()) File->GetRIP();
+	// DRAGONS: If we are following a growing file this also picks up any partitions added since the last update
+	if(Tracker) Tracker->Update();
+	else if(File->FileRIP.empty()) File->GetRIP();
 
 	PartitionInfoPtr PartInfo = File->FileRIP.FindPartition(BodySID, Pos);
 
@@ -1727,7 +2124,7 @@ Position BodyReader::Seek(UInt32 BodySID, Position Pos)
 	CurrentBodySID = BodySID;
 
 	// If we have a reader for this BodySID we can continue reading at this point, otherwise setting NewPos will force a ReSync()
-	GCReaderPtr Reader = GetGCReader(CurrentBodySID);
+	GCReaderPtr Reader = GetReadingReader(CurrentBodySID);
 	if(Reader)
 	{
 		Reader->SetFileOffset(CurrentPos);
@@ -1741,6 +2138,58 @@ Position BodyReader::Seek(UInt32 BodySID, Position Pos)
 }
 
 
+//! Seek to the start of a given edit unit in a given stream
+/*! \return New file offset or -1 on error (such as no index table being set for this stream)
+ */
+Position BodyReader::SeekToEditUnit(UInt32 BodySID, Position EditUnit, bool ToKeyFrame /*=false*/)
+{
+	IndexTablePtr Index = GetIndex(BodySID);
+	if(!Index)
+	{
+		error("BodyReader::SeekToEditUnit(%d, %s) called with no index table set for this BodySID\n", BodySID, Int64toString(EditUnit).c_str());
+		return -1;
+	}
+
+	// Locate the edit unit, converting from display order to stored order
+	IndexPos Result;
+	Index->Lookup(EditUnit, Result);
+
+	Position StreamPos = Result.Location;
+	if(ToKeyFrame && (Result.KeyFrameOffset != 0))
+	{
+		// DRAGONS: The key frame location is not available if it is in a different index table segment, so look it up directly
+		if(Result.KeyLocation != ~0) StreamPos = Result.KeyLocation;
+		else
+		{
+			IndexPos KeyResult;
+			Index->Lookup(static_cast<Position>(Result.ThisPos) + Result.KeyFrameOffset, KeyResult, 0, false);
+			StreamPos = KeyResult.Location;
+		}
+	}
+
+	if(StreamPos < 0)
+	{
+		error("BodyReader::SeekToEditUnit(%d, %s) failed to locate the edit unit in the index table\n", BodySID, Int64toString(EditUnit).c_str());
+		return -1;
+	}
+
+	Position FilePos = Seek(BodySID, StreamPos);
+
+	if((FilePos >= 0) && (PrefetchCount > 0))
+	{
+		// Find the end of the last edit unit to be prefetched, which is the start of the one following it
+		// DRAGONS: If the index is sparse this will be a preceding edit unit, so we may prefetch less than requested
+		IndexPos EndResult;
+		Index->Lookup(static_cast<Position>(Result.ThisPos) + PrefetchCount + 1, EndResult, 0, false);
+
+		// DRAGONS: This assumes the stream is contiguous in the file from this point, which is only a hint if other streams are interleaved
+		if(EndResult.Location > StreamPos) File->Prefetch(FilePos, EndResult.Location - StreamPos);
+	}
+
+	return FilePos;
+}
+
+
 //! Are we currently at the start of a partition pack?
 bool BodyReader::IsAtPartition(void)
 {
@@ -1765,6 +2214,10 @@ bool BodyReader::Eof(void)
 	// Return true if we know we are the end of the file
 	if(AtEOF) return true;
 
+	// When following a growing file, we are at the end of the file if there are no complete KLVs beyond this point yet
+	// DRAGONS: This is not recorded in AtEOF as more data may be found at the next Poll()
+	if(Tracker) return CurrentPos >= Tracker->GetScanPos();
+
 	// Otherwise try and find out
 	File->Seek(CurrentPos);
 	
@@ -1787,6 +2240,22 @@ bool BodyReader::Eof(void)
 
 
 
+//! Check for data added to a growing file since the last check
+/*! \return The number of new partitions found, or -1 on error or if there is no tracker
+ */
+int BodyReader::Poll(void)
+{
+	if(!Tracker) return -1;
+
+	int Ret = Tracker->Update();
+
+	// Allow reading to continue if there is now more data
+	if(CurrentPos < Tracker->GetScanPos()) AtEOF = false;
+
+	return Ret;
+}
+
+
 //! Make a GCReader for the specified BodySID
 /*! \return true on success, false on error (such as there is already a GCReader for this BodySID)
  */
@@ -1801,6 +2270,9 @@ bool BodyReader::MakeGCReader(UInt32 BodySID, GCReadHandlerPtr DefaultHandler /*
 
 	// Set the encryption handler if one is configured
 	if(GCREncryptionHandler) Reader->SetEncryptionHandler(GCREncryptionHandler);
+
+	Reader->SetHeaderOnly(GCRHeaderOnly);
+	if(GCRAsyncEngine) Reader->SetAsyncRead(GCRAsyncEngine, GCRAsyncDepth);
 	
 	// Insert into the map
 	Readers[BodySID] = Reader;
@@ -1821,6 +2293,17 @@ bool BodyReader::ReadFromFile(bool SingleKLV /*=false*/)
 	bool Ret = false;
 	GCReaderPtr Reader;
 
+	// Stop if a handler running in parallel has failed
+	if(ParallelDispatch)
+	{
+		std::map<UInt32, StreamDispatcherPtr>::iterator it = Dispatchers.begin();
+		while(it != Dispatchers.end())
+		{
+			if((*it).second->HasFailed()) return false;
+			it++;
+		}
+	}
+
 	// First check if we need to re-initialise
 	if(NewPos)
 	{
@@ -1838,7 +2321,7 @@ bool BodyReader::ReadFromFile(bool SingleKLV /*=false*/)
 			if(!NewPartition) return false;
 
 			CurrentBodySID = NewPartition->GetUInt(BodySID_UL);
-			if(CurrentBodySID != 0) Reader = GetGCReader(CurrentBodySID);
+			if(CurrentBodySID != 0) Reader = GetReadingReader(CurrentBodySID);
 		
 			// All done when we have found a supported BodySID
 			if(Reader) break;
@@ -1869,7 +2352,7 @@ bool BodyReader::ReadFromFile(bool SingleKLV /*=false*/)
 	else
 	{
 		// Continue from the previous read 
-		Reader = GetGCReader(CurrentBodySID);
+		Reader = GetReadingReader(CurrentBodySID);
 		if(!Reader) return true;
 		Ret = Reader->ReadFromFile(SingleKLV);
 	}
@@ -2028,13 +2511,8 @@ GCElementKind mxflib::GetGCElementKind(const ULPtr TheUL)
 	// Assume it's not a valid key
 	ret.IsValid = false;
 
-	// Note that we first test the 11th byte as this where "Application = MXF Generic Container Keys"
-	// is set and so is the same for all GC keys and different in the majority of non-CG keys
-	// also, avoid testing the 8th byte (version number)
-	if( ( TheUL->GetValue()[10] == GetGCEssenceKey()[10] )
-	 && ( TheUL->GetValue()[9]  == GetGCEssenceKey()[9]  )
-	 && ( TheUL->GetValue()[8]  == GetGCEssenceKey()[8]  )
-	 && ( memcmp(TheUL->GetValue(), GetGCEssenceKey(), 7 ) == 0) )
+	// Test bytes 1 to 11, other than the 8th byte (version number), as a pair of masked 64-bit compares
+	if(ULMaskedEquals(TheUL->GetValue(), GetGCEssenceKey(), GCEssenceKeyMask))
 	{
 		ret.IsValid = true;
 	}
@@ -2093,14 +2571,8 @@ GCElementKind mxflib::GetGCElementKind(const ULPtr TheUL)
 //! Determine if this is a system item
 bool mxflib::IsGCSystemItem(const ULPtr TheUL)
 {
-	// Note that we first test the 11th byte as this where "Application = MXF Generic Container Keys"
-	// is set and so is the same for all GC keys and different in the majority of non-CG keys
-	// also, avoid testing the 6th byte (set or pack structure) and the 8th byte (version number)
-	if( ( TheUL->GetValue()[10] == GCSystemKey[10] )
-	 && ( TheUL->GetValue()[9]  == GCSystemKey[9]  )
-	 && ( TheUL->GetValue()[8]  == GCSystemKey[8]  )
-	 && ( TheUL->GetValue()[6]  == GCSystemKey[6]  )
-	 && ( memcmp(TheUL->GetValue(), GCSystemKey, 5 ) == 0) )
+	// Test bytes 1 to 11, other than the 6th byte (set or pack structure) and the 8th byte (version number)
+	if(ULMaskedEquals(TheUL->GetValue(), GCSystemKey, GCSystemKeyMask))
 	{
 		return true;
 	}
@@ -2158,6 +2630,33 @@ UInt32 mxflib::GetGCTrackNumber(const ULPtr TheUL)
 
 
 
+//! Read the probe data from an open file
+EssenceProbe::EssenceProbe(FileHandle InFile, size_t HeadSize /*=64*1024*/, size_t TailSize /*=4*1024*/)
+{
+	FileBytes = FileSize(InFile);
+
+	// Don't allocate more than the file holds
+	if((FileBytes >= 0) && (static_cast<Int64>(HeadSize) > FileBytes)) HeadSize = static_cast<size_t>(FileBytes);
+
+	Head = new DataChunk(HeadSize);
+	size_t Bytes = HeadSize ? FileReadAt(InFile, 0, Head->Data, HeadSize) : 0;
+	if(Bytes == static_cast<size_t>(-1)) Bytes = 0;
+	Head->Resize(Bytes);
+
+	// Only read the tail if it isn't already in the head
+	Tail = new DataChunk;
+	if(TailSize && (FileBytes > static_cast<Int64>(Head->Size)))
+	{
+		if(static_cast<Int64>(TailSize) > (FileBytes - static_cast<Int64>(Head->Size))) TailSize = static_cast<size_t>(FileBytes - Head->Size);
+
+		Tail->Resize(TailSize);
+		Bytes = FileReadAt(InFile, FileBytes - TailSize, Tail->Data, TailSize);
+		if(Bytes == static_cast<size_t>(-1)) Bytes = 0;
+		Tail->Resize(Bytes);
+	}
+}
+
+
 //! Build a list of parsers with their descriptors for a given essence file
 ParserDescriptorListPtr EssenceParser::IdentifyEssence(FileHandle InFile)
 {
@@ -2166,10 +2665,21 @@ ParserDescriptorListPtr EssenceParser::IdentifyEssence(FileHandle InFile)
 
 	ParserDescriptorListPtr Ret = new ParserDescriptorList;
 
+	// Read the probe data once for all sub-parsers
+	EssenceProbe Probe(InFile, ProbeHeadSize, ProbeTailSize);
+
 	EssenceSubParserFactoryList::iterator it = EPList.begin();
 	while(it != EPList.end())
 	{
 		EssenceSubParserPtr EP = (*it)->NewParser();
+
+		// Skip this parser if the probe data shows it can't handle the file
+		if(!EP->CanIdentify(Probe))
+		{
+			it++;
+			continue;
+		}
+
 		EssenceStreamDescriptorList DescList = EP->IdentifyEssence(InFile);
 		
 		if(!DescList.empty())
@@ -2531,6 +3041,48 @@ void EssenceParser::SelectWrappingOption(EssenceParser::WrappingConfigPtr Config
 }
 
 
+namespace
+{
+	//! The most edit units BodyWriter reads from a source in one batch when frame wrapping
+	const size_t BodyWriterBatchUnits = 16;
+
+	//! The most bytes BodyWriter reads from a source in one batch when frame wrapping
+	const size_t BodyWriterBatchBytes = 8 * 1024 * 1024;
+}
+
+
+//! Get the next edit unit, from a batch read with GetEssenceBatch() if this source supports them, else from GetEssenceData()
+/*! The edit unit returned from a batch refers to the batch buffer rather than holding a copy.
+ *  DRAGONS: Up to MaxUnits edit units are read ahead of those returned, so once this is used the source must only
+ *           be read with this method, and any edit units of a batch not returned are lost if reading stops early
+ */
+DataChunkPtr EssenceSource::GetBatchedEssenceData(size_t MaxUnits, size_t MaxBytes)
+{
+	// Read a new batch once all of the current one has been returned
+	if((!CurrentBatch) || (BatchNext >= CurrentBatch->size()))
+	{
+		CurrentBatch = GetEssenceBatch(MaxUnits, MaxBytes);
+		BatchNext = 0;
+		BatchOffset = 0;
+
+		// An empty batch is treated as no batch, leaving GetEssenceData() to report the end of the data
+		if(CurrentBatch && (CurrentBatch->size() == 0)) CurrentBatch = NULL;
+
+		if(!CurrentBatch) return GetEssenceData();
+
+		StatsAdd(StatsEssenceBatches);
+	}
+
+	size_t Size = CurrentBatch->Sizes[BatchNext++];
+
+	DataChunkPtr Ret = new DataChunk;
+	Ret->SetBuffer(CurrentBatch->Buffer, &CurrentBatch->Buffer->Data[BatchOffset], Size);
+	BatchOffset += Size;
+
+	return Ret;
+}
+
+
 //! Write a complete partition's worth of essence
 /*! Will stop if:
  *    Frame or "other" wrapping and the "StopAfter" reaches zero or "Duration" reaches zero
@@ -2571,7 +3123,9 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 	// If the previous pass for this stream left some data pending then it will already be indexed and so there
 	// is no need to index the first entry of this pass.
 	bool SparseIndex;
-	if(VBRIndex && (!Stream->HasPendingData()) && (Stream->GetIndexType() & BodyStream::StreamIndexSparseFooter))
+	// DRAGONS: A full footer index is replaced by the sparse index when using bounded index memory, so list entries for that too
+	if(VBRIndex && (!Stream->HasPendingData()) && ((Stream->GetIndexType() & BodyStream::StreamIndexSparseFooter)
+	   || (Stream->GetBoundedIndex() && (Stream->GetIndexType() & BodyStream::StreamIndexFullFooter))))
 		SparseIndex = true;
 	else
 		SparseIndex = false;
@@ -2586,8 +3140,8 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 			// Get the stream ID for this sub-stream
 			GCStreamID EssenceID = (*it)->GetStreamID();
 
-			// Add the essence to write - using FastClipWrap if available
-			Writer->AddEssenceData(EssenceID, (*it), GetFastClipWrap(), Stream);
+			// Add the essence to write - using FastClipWrap if available, which it isn't for a stream as the length is written afterwards
+			Writer->AddEssenceData(EssenceID, (*it), GetFastClipWrap() && (!File->IsStream()), Stream);
 			it++;
 		}
 
@@ -2674,7 +3228,7 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 
 							// If we are in the precharge, work out the -ve position (GetCurrentPosition may return 0 through the precharge)
 							if(PrechargeSize) EditUnit = 0 - PrechargeSize;
-							else EditUnit = (*it)->GetCurrentPosition();
+							else EditUnit = (*it)->GetBatchedPosition();
 
 							Stream->SparseList.push_back(EditUnit);
 			
@@ -2708,7 +3262,11 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 						else
 						{
 							// Read the next data for this sub-stream
-							Dat = (*it)->GetEssenceData();
+							StatsTimer Timer(StatsEssenceDataCalls);
+							TraceScope Trace("GetEssenceData", "essence");
+							// DRAGONS: A batch from a live source would wait for later wrapping units to arrive, so live mode reads one at a time
+							if(LiveMode) Dat = (*it)->GetBatchedEssenceData(1, BodyWriterBatchBytes);
+							else Dat = (*it)->GetBatchedEssenceData(BodyWriterBatchUnits, BodyWriterBatchBytes);
 						}
 
 						// Get the stream ID for this sub-stream
@@ -2766,6 +3324,9 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 				// If we have been writing precharge, reduce the count
 				if(PrechargeSize) Stream->DecrementPrecharge();
 
+				// Time this content package from now until it reaches the file
+				if(LiveMode) LivePackageStart = StatsEnabled() ? GetMicroseconds() : 0;
+
 				// Now we have written something we must record the BodySID
 				PartitionBodySID = CurrentBodySID;
 			}
@@ -2854,10 +3415,11 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 			{
 				if(!FirstIteration)
 				{
-					if((!Stream->GetEditAlign()) || Stream->GetSource()->IsEditPoint())
+					if((!Stream->GetEditAlign()) || Stream->GetSource()->IsBatchedEditPoint())
 					{
 						// If we are building a sparse index table...
-						if(VBRIndex && (Stream->GetIndexType() & BodyStream::StreamIndexSparseFooter))
+						if(VBRIndex && ((Stream->GetIndexType() & BodyStream::StreamIndexSparseFooter)
+						   || (Stream->GetBoundedIndex() && (Stream->GetIndexType() & BodyStream::StreamIndexFullFooter))))
 						{
 							// ...force the first edit unit of the new partition to be accepted, even if provisional,
 							// and add it's edit unit to the sparse list
@@ -2888,6 +3450,22 @@ Length BodyWriter::WriteEssence(StreamInfoPtr &Info, Length Duration /*=0*/, Len
 			// Write this chunk of essence
 			Writer->StartNewCP();
 
+			if(LiveMode)
+			{
+				// Push the content package through any write buffering
+				File->Flush();
+
+				if(LivePackageStart)
+				{
+					UInt64 Latency = GetMicroseconds() - LivePackageStart;
+					StatsAdd(StatsLivePackageWrites);
+					StatsAdd(StatsLivePackageWriteTime, Latency);
+					if(LiveLatencyTarget && (Latency > LiveLatencyTarget)) StatsAdd(StatsLivePackagesLate);
+
+					LivePackageStart = 0;
+				}
+			}
+
 			// Clear the pending flag
 			Stream->SetPendingData(false);
 
@@ -3229,10 +3807,43 @@ void mxflib::BodyWriter::WritePartitionPack(void)
 	{
 		// If we have a body partition handler call it and allow it to ask us to write metadata
 		if(PartitionHandler) WriteMetadata = PartitionHandler->HandlePartition(BodyWriterPtr(this), CurrentBodySID, BasePartition->GetUInt(IndexSID_UL));
+
+		// In live mode the header metadata is repeated regularly, in an open partition as it may still be updated
+		if(LiveMode && (BasePartition->GetUInt(BodySID_UL) != 0))
+		{
+			LivePartitionCount++;
+			if(LiveMetadataInterval && ((LivePartitionCount % LiveMetadataInterval) == 0))
+			{
+				WriteMetadata = true;
+				BasePartition->ChangeType(OpenBodyPartition_UL);
+			}
+		}
+	}
+
+	// Leave room for the header metadata to grow, based on its actual size
+	if(PendingHeader && WriteMetadata && HeaderReservePercent)
+	{
+		Length Reserve = (GetHeaderMetadataSize() * HeaderReservePercent) / 100;
+		if(Reserve < HeaderReserveBytes) Reserve = HeaderReserveBytes;
+
+		if(Reserve > MinPartitionFiller) MinPartitionFiller = static_cast<UInt32>(Reserve);
 	}
 
 	// FIXME: Need to force a separate partition pack if we are about to violate the metadata sharing rules
 
+	// Any essence digests start a new partition here
+	Position PartitionPos = File->Tell();
+	StreamInfoList::iterator Stream_it = StreamList.begin();
+	while(Stream_it != StreamList.end())
+	{
+		GCWriterPtr &Writer = (*Stream_it)->Stream->GetWriter();
+		if(Writer) Writer->StartDigestPartition(PartitionPos);
+		Stream_it++;
+	}
+
+	// Only partitions holding essence are checkpoints, as writing is resumed by continuing the partition
+	bool Checkpoint = (!CheckpointFile.empty()) && (!PendingHeader) && (!PendingFooter) && (BasePartition->GetUInt(BodySID_UL) != 0);
+
 	if(PendingIndexData)
 	{
 		File->WritePartitionWithIndex(BasePartition, PendingIndexData, WriteMetadata, NULL, MinPartitionFiller, MinPartitionSize);
@@ -3246,6 +3857,8 @@ void mxflib::BodyWriter::WritePartitionPack(void)
 		File->WritePartition(BasePartition, WriteMetadata, NULL, MinPartitionFiller, MinPartitionSize);
 	}
 
+	if(Checkpoint) WriteCheckpoint(PartitionPos);
+
 	// Clear the pending data
 	PartitionWritePending = false;
 	PendingHeader = false;
@@ -3260,6 +3873,63 @@ void mxflib::BodyWriter::WritePartitionPack(void)
 }
 
 
+//! Measure the size of the serialized header metadata, including its primer
+Length mxflib::BodyWriter::GetHeaderMetadataSize(void)
+{
+	// DRAGONS: This matches the way MXFFile builds the header, but a metadictionary (if written) is not counted
+	PrimerPtr ThisPrimer = MDOType::MakeBuiltInPrimer();
+	DataChunkPtr Buffer = new DataChunk;
+
+	MDObjectList::iterator it = BasePartition->TopLevelMetadata.begin();
+	while(it != BasePartition->TopLevelMetadata.end())
+	{
+		(*it)->WriteLinkedObjects(Buffer, ThisPrimer);
+		it++;
+	}
+
+	DataChunkPtr PrimerBuffer = new DataChunk;
+	ThisPrimer->WritePrimer(PrimerBuffer);
+
+	return static_cast<Length>(Buffer->Size + PrimerBuffer->Size);
+}
+
+
+//! Reserve disk space for the file, estimated from the expected duration of the essence
+bool mxflib::BodyWriter::Preallocate(Length Duration, Length BytesPerEditUnit /*=0*/)
+{
+	if(Duration <= 0) return false;
+
+	// Add up the size of an edit unit of each source if not told
+	if(!BytesPerEditUnit)
+	{
+		StreamInfoList::iterator it = StreamList.begin();
+		while(it != StreamList.end())
+		{
+			BodyStream::iterator SourceIt = (*it)->Stream->begin();
+			while(SourceIt != (*it)->Stream->end())
+			{
+				UInt32 Bytes = (*SourceIt)->GetBytesPerEditUnit(KAG ? KAG : 1);
+
+				// We can't estimate the size of VBR essence
+				if(!Bytes) return false;
+
+				BytesPerEditUnit += Bytes;
+				SourceIt++;
+			}
+			it++;
+		}
+
+		if(!BytesPerEditUnit) return false;
+	}
+
+	// Allow 1% for partition packs, index tables and the footer
+	Length Size = File->Tell() + (Duration * BytesPerEditUnit);
+	Size += Size / 100;
+
+	return File->Preallocate(Size);
+}
+
+
 //! End the current partition
 /*! Once "ended" no more essence will be added, even if otherwise valid.
  *  A new partition will be started by the next call to WritePartition()
@@ -3313,6 +3983,8 @@ void mxflib::BodyWriter::WriteBody(Length Duration /*=0*/, Length MaxPartitionSi
  */
 Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPartitionSize /*=0*/, bool ClosePartition /*=true*/)
 {
+	TraceScope Trace("BodyWriter::WritePartition", "write");
+
 	// Number of edit units processed
 	Length Ret = 0;
 
@@ -3329,6 +4001,9 @@ Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPart
 	// If there are no more streams - all done (should never happen!)
  	if(!CurrentBodySID) return Ret;
 
+	// Start reading ahead if requested, now that the index managers have been given to the sources
+	if(PrefetchDepth && !PrefetchStarted) StartPrefetch();
+
 	// Index the stream info
 	BodyStreamPtr Stream = (*CurrentStream)->Stream;
 
@@ -3369,10 +4044,11 @@ Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPart
 				Position EditUnit = IndexMan->GetLastNewEditUnit();
 				int Count = IndexMan->AddEntriesToIndex(Index, Stream->GetNextSprinkled(), EditUnit);
 
-				// TODO: Clear any used entries from the index table if not writing a full table anywhere else (or another sprinkled one?)
-
 				// We have written a sprinkled index table - next sprinkled table will start from the next edit unit in sequence
 				Stream->SetNextSprinkled(Stream->GetNextSprinkled() + Count);
+
+				// Free the written entries if the stream is using bounded index memory
+				Stream->FreeIndexEntries();
 			}
 
 			// Write the index table
@@ -3488,14 +4164,15 @@ Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPart
 						Position EditUnit = IndexMan->GetLastNewEditUnit();
 						int Count = IndexMan->AddEntriesToIndex(Index, Stream->GetNextSprinkled(), EditUnit);
 
-						// TODO: Clear any used entries from the index table if not writing a full table anywhere else (or another sprinkled one?)
-
 						// We have written a sprinkled index table - next sprinkled table will start from the next edit unit in sequence
 						// Note that we DONT do this if we are also doing sprinkled non-isolated so that we get
 						// identical copies in each place (DRAGONS: which may or may not be legal!)
 						if(Stream->GetIndexType() & BodyStream::StreamIndexSprinkled)
 						{
 							Stream->SetNextSprinkled(Stream->GetNextSprinkled() + Count);
+
+							// Free the written entries if the stream is using bounded index memory
+							Stream->FreeIndexEntries();
 						}
 					}
 
@@ -3521,8 +4198,16 @@ Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPart
 				// Note: The partition will be written by the call to WriteEssence
 			}
 
+			// When scheduling by time, keep this write within the limits of the schedule
+			if(ScheduleByTime) GetScheduledLimits(Duration, MaxPartitionSize);
+
+			// Live partitions are kept short so that their index table segments follow closely
+			if(LiveMode && LivePartitionDuration && ((Duration == 0) || (LivePartitionDuration < Duration))) Duration = LivePartitionDuration;
+
 			// Write the Essence
-			Ret += WriteEssence((*CurrentStream), Duration, MaxPartitionSize, ClosePartition);
+			Length Written = WriteEssence((*CurrentStream), Duration, MaxPartitionSize, ClosePartition);
+			(*CurrentStream)->Written += Written;
+			Ret += Written;
 
 			// Check the new state for this stream
 			StreamState = Stream->GetState();
@@ -3558,14 +4243,15 @@ Length mxflib::BodyWriter::WritePartition(Length Duration /*=0*/, Length MaxPart
 				Position EditUnit = IndexMan->GetLastNewEditUnit();
 				int Count = IndexMan->AddEntriesToIndex(Index, Stream->GetNextSprinkled(), EditUnit);
 
-				// TODO: Clear any used entries from the index table if not writing a full table anywhere else (or another sprinkled one?)
-
 				// We have written a sprinkled index table - next sprinkled table will start from the next edit unit in sequence
 				// Note that we DONT do this if we are also doing sprinkled non-isolated so that we get
 				// identical copies in each place (DRAGONS: which may or may not be legal!)
 				if(!(Stream->GetIndexType() & BodyStream::StreamIndexSprinkled))
 				{
 					Stream->SetNextSprinkled(Stream->GetNextSprinkled() + Count);
+
+					// Free the written entries if the stream is using bounded index memory
+					Stream->FreeIndexEntries();
 				}
 			}
 
@@ -3636,6 +4322,9 @@ void mxflib::BodyWriter::WriteFooter(bool WriteMetadata /*=false*/, bool IsCompl
 		return;
 	}
 
+	// All essence has been written, so no more reading ahead is required
+	StopPrefetch();
+
 	// Turn the partition into a closed complete body for any pre-footer index only partitions
 	BasePartition->ChangeType(ClosedCompleteBodyPartition_UL);
 
@@ -3746,7 +4435,7 @@ void mxflib::BodyWriter::WriteFooter(bool WriteMetadata /*=false*/, bool IsCompl
 				// We have now done the remaining sprinkles
 				IndexFlags = (BodyStream::IndexType) (IndexFlags & (BodyStream::StreamIndexSprinkled | BodyStream::StreamIndexSprinkledIsolated));
 			}
-			else if(IndexFlags & BodyStream::StreamIndexFullFooter)
+			else if((IndexFlags & BodyStream::StreamIndexFullFooter) && !Stream->GetBoundedIndex())
 			{
 				// Add all available edit units
 				IndexMan->AddEntriesToIndex(Index);
@@ -3754,13 +4443,25 @@ void mxflib::BodyWriter::WriteFooter(bool WriteMetadata /*=false*/, bool IsCompl
 				// We have now done the full index
 				IndexFlags = BodyStream::StreamIndexFullFooter;
 			}
-			else if(IndexFlags & BodyStream::StreamIndexSparseFooter)
+			else if(IndexFlags & (BodyStream::StreamIndexSparseFooter | BodyStream::StreamIndexFullFooter))
 			{
-				// Force no re-ordering in the sparse index (to prevent unsatisfied links)
-				int i;
-				for(i=0; i<Index->BaseDeltaCount; i++)
+				// DRAGONS: With bounded index memory the written entries have been freed, so a full index can't be built
+				//          and the sparse summary is written in its place
+				if(IndexFlags & BodyStream::StreamIndexFullFooter)
 				{
-					if(Index->BaseDeltaArray[i].PosTableIndex < 0) Index->BaseDeltaArray[i].PosTableIndex = 0;
+					warning("Full footer index for BodySID 0x%04x replaced by a sparse index as bounded index memory is in use\n", (int)CurrentBodySID);
+				}
+
+				// Start from any summary of entries already freed
+				if(Stream->GetSparseSummary()) Index = Stream->GetSparseSummary();
+				else
+				{
+					// Force no re-ordering in the sparse index (to prevent unsatisfied links)
+					int i;
+					for(i=0; i<Index->BaseDeltaCount; i++)
+					{
+						if(Index->BaseDeltaArray[i].PosTableIndex < 0) Index->BaseDeltaArray[i].PosTableIndex = 0;
+					}
 				}
 
 				// Add each requested entry
@@ -3772,85 +4473,498 @@ void mxflib::BodyWriter::WriteFooter(bool WriteMetadata /*=false*/, bool IsCompl
 					it++;
 				}
 
-				// We have now done the sparse index
-				IndexFlags = BodyStream::StreamIndexSparseFooter;
+				// We have now done the sparse index (and the full index if it was replaced)
+				IndexFlags = (BodyStream::IndexType) (IndexFlags & (BodyStream::StreamIndexSparseFooter | BodyStream::StreamIndexFullFooter));
+			}
+			else
+			{
+				// This shouldn't be possible!
+				mxflib_assert(0);
+			}
+		}
+
+		// If we have a pending write do it now
+		if(PartitionWritePending) EndPartition();
+
+		// Write the index table
+		DataChunkPtr IndexChunk = new DataChunk;
+		Index->WriteIndex(*IndexChunk);
+
+		// Don't write empty index partitions
+		if(IndexChunk->Size)
+		{
+			// Set the index SID
+			BasePartition->SetUInt(IndexSID_UL,  Index->IndexSID);
+
+			// Record the index data to write
+			PendingIndexData = IndexChunk;
+
+			// Queue the write
+			PartitionWritePending = true;
+		}
+
+		// Set the "done" flag for this index type
+		// DRAGONS: Is this an MSVC funny or can we really not do bitmaths with enums without them becoming integers?
+		BodyStream::IndexType Flags = Stream->GetFooterIndex();
+		Stream->SetFooterIndex((BodyStream::IndexType) (Flags | IndexFlags) );
+		if(Flags == Stream->GetFooterIndex())
+		{
+			error("Internal Error: Failed to clear footer index flag 0x%04x for BodySID 0x%04x\n", (int)IndexFlags, (int)CurrentBodySID);
+
+			// Flag all indexing done
+			Stream->SetFooterIndex(Stream->GetIndexType());
+		}
+
+		// This stream has done a cycle - move to the next stream
+		SetNextStream();
+	}
+
+	// If index data cannot share with metadata force any pending index data to be flushed before writing the actual footer
+	if((!IndexSharesWithMetadata) && WriteMetadata && PartitionWritePending && PendingIndexData)
+	{
+		EndPartition();
+	}
+
+	// Turn the partition into the correct type of footer
+	if(IsComplete)
+		BasePartition->ChangeType(CompleteFooter_UL);
+	else
+		BasePartition->ChangeType(Footer_UL);
+
+	// Flag that we have a partition to write
+	PartitionWritePending = true;
+
+	// And that it is a footer
+	PendingFooter = true;
+
+	// Set the metadata status
+	PendingMetadata = WriteMetadata;
+
+	// Write the footer now
+	EndPartition();
+
+	// Flag the writing as all done
+	State = BodyStateDone;
+
+	// Last thing we do is write the RIP
+	// TODO: At the moment there is no way to not write a RIP which is probably the best way
+	//       however if there is a good reason to allow it to be omitted...
+	// Add a RIP (note that we have to manually KAG align as a footer can end off the KAG)
+	if(KAG > 1) File->Align(KAG);
+	File->WriteRIP();
+}
+
+
+//! Save a checkpoint for the partition just written at a given position
+void mxflib::BodyWriter::WriteCheckpoint(Position PartitionPos)
+{
+	BodyWriterCheckpoint Checkpoint;
+
+	Checkpoint.PartitionPos = PartitionPos;
+	Checkpoint.PartitionBodySID = BasePartition->GetUInt(BodySID_UL);
+	Checkpoint.ResumePos = File->Tell();
+
+	RIP::iterator RIP_it = File->FileRIP.begin();
+	while(RIP_it != File->FileRIP.end())
+	{
+		Checkpoint.Partitions.push_back(BodyWriterCheckpoint::PartitionEntry((*RIP_it).first, (*RIP_it).second->BodySID));
+		RIP_it++;
+	}
+
+	// DRAGONS: Each writer holds its next content package, not yet written, so its stream offset and edit unit are those of that package
+	StreamInfoList::iterator it = StreamList.begin();
+	while(it != StreamList.end())
+	{
+		BodyStreamPtr &Stream = (*it)->Stream;
+		GCWriterPtr &Writer = Stream->GetWriter();
+
+		BodyWriterCheckpoint::StreamState State;
+		State.BodySID = Stream->GetBodySID();
+		State.IndexSID = Stream->GetIndexSID();
+		State.StreamOffset = Writer ? Writer->GetStreamOffset() : 0;
+		State.EditUnit = Writer ? Writer->GetIndexEditUnit() : 0;
+		State.NextSprinkled = Stream->GetNextSprinkled();
+		Checkpoint.Streams.push_back(State);
+
+		it++;
+	}
+
+	// Everything the checkpoint refers to must be in the file before the checkpoint is saved
+	File->Flush();
+
+	if(!Checkpoint.Write(CheckpointFile))
+	{
+		error("Unable to save checkpoint to \"%s\"\n", CheckpointFile.c_str());
+	}
+}
+
+
+//! Restore the RIP and file position of a checkpoint, reading the header partition pack as the template if none set
+bool mxflib::BodyWriter::RestoreCheckpoint(const BodyWriterCheckpoint &Checkpoint)
+{
+	if(!Checkpoint.IsValid())
+	{
+		error("Invalid checkpoint used for file \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	if(State != BodyStateStart)
+	{
+		error("A BodyWriter can only continue from a checkpoint before it has written anything\n");
+		return false;
+	}
+
+	if(!BasePartition)
+	{
+		File->Seek(0);
+		BasePartition = File->ReadPartition();
+		if(!BasePartition)
+		{
+			error("Unable to read the header partition pack of file \"%s\"\n", File->Name.c_str());
+			return false;
+		}
+	}
+
+	File->FileRIP.clear();
+
+	std::vector<BodyWriterCheckpoint::PartitionEntry>::const_iterator it = Checkpoint.Partitions.begin();
+	while(it != Checkpoint.Partitions.end())
+	{
+		File->FileRIP.AddPartition(NULL, (*it).first, (*it).second);
+		it++;
+	}
+
+	// Discard anything written after the checkpoint
+	File->Seek(Checkpoint.ResumePos);
+	if(File->Tell() != Checkpoint.ResumePos)
+	{
+		error("File \"%s\" ends before the checkpoint at 0x%s\n", File->Name.c_str(), Int64toHexString(Checkpoint.ResumePos, 8).c_str());
+		return false;
+	}
+
+	if(!File->Truncate()) warning("Unable to discard the data following the checkpoint in file \"%s\"\n", File->Name.c_str());
+
+	return true;
+}
+
+
+//! Continue writing a file from a checkpoint
+bool mxflib::BodyWriter::Resume(const BodyWriterCheckpoint &Checkpoint)
+{
+	// Check that each stream is in the checkpoint before changing anything
+	StreamInfoList::iterator it = StreamList.begin();
+	while(it != StreamList.end())
+	{
+		if(Checkpoint.GetEditUnit((*it)->Stream->GetBodySID()) == -1)
+		{
+			error("Stream with BodySID 0x%04x is not in the checkpoint for file \"%s\"\n", (*it)->Stream->GetBodySID(), File->Name.c_str());
+			return false;
+		}
+		it++;
+	}
+
+	if(!RestoreCheckpoint(Checkpoint)) return false;
+
+	InitIndexManagers();
+
+	// Restore the state of each stream, ready to write the body
+	CurrentStream = StreamList.end();
+	it = StreamList.begin();
+	while(it != StreamList.end())
+	{
+		BodyStreamPtr &Stream = (*it)->Stream;
+		GCWriterPtr &Writer = Stream->GetWriter();
+
+		std::vector<BodyWriterCheckpoint::StreamState>::const_iterator State_it = Checkpoint.Streams.begin();
+		while((*State_it).BodySID != Stream->GetBodySID()) State_it++;
+
+		Writer->SetStreamOffset((*State_it).StreamOffset);
+		Writer->SetIndexEditUnit((*State_it).EditUnit);
+		Stream->SetNextSprinkled((*State_it).NextSprinkled);
+
+		BodyStream::IndexType IndexFlags = Stream->GetIndexType();
+		if(IndexFlags & (BodyStream::StreamIndexFullFooter | BodyStream::StreamIndexSparseFooter))
+		{
+			warning("The footer index of BodySID 0x%04x will only cover the edit units written after resuming\n", Stream->GetBodySID());
+		}
+
+		// The header and any pre-body index tables have already been written
+		if(IndexFlags & (BodyStream::StreamIndexCBRBody | BodyStream::StreamIndexSprinkled)) Stream->SetState(BodyStream::BodyStreamBodyWithIndex);
+		else Stream->SetState(BodyStream::BodyStreamBodyNoIndex);
+
+		if(Stream->GetBodySID() == Checkpoint.PartitionBodySID) CurrentStream = it;
+
+		it++;
+	}
+
+	// Continue the partition of the checkpoint
+	BasePartition->ChangeType(ClosedCompleteBodyPartition_UL);
+	BasePartition->SetInt64(ThisPartition_UL, Checkpoint.PartitionPos);
+	BasePartition->SetUInt(BodySID_UL, Checkpoint.PartitionBodySID);
+	BasePartition->SetUInt(IndexSID_UL, 0);
+
+	State = BodyStateBody;
+	PartitionWritePending = false;
+	PendingHeader = false;
+	PendingFooter = false;
+	PendingMetadata = false;
+	PendingIndexData = NULL;
+	PartitionDone = false;
+	PartitionBodySID = Checkpoint.PartitionBodySID;
+	CurrentBodySID = Checkpoint.PartitionBodySID;
+
+	// If the stream of the checkpoint's partition has not been added, start a new partition with the first stream
+	if(CurrentStream == StreamList.end())
+	{
+		PartitionDone = true;
+		CurrentBodySID = 0;
+		SetNextStream();
+	}
+
+	return true;
+}
+
+
+//! Finish a file from a checkpoint by writing a footer and RIP, without scanning the body
+bool mxflib::BodyWriter::Finish(const BodyWriterCheckpoint &Checkpoint)
+{
+	if(!RestoreCheckpoint(Checkpoint)) return false;
+
+	// The footer holds no essence, index or metadata
+	BasePartition->ChangeType(Footer_UL);
+	BasePartition->SetUInt(BodySID_UL, 0);
+	BasePartition->SetUInt(BodyOffset_UL, 0);
+	BasePartition->SetUInt(IndexSID_UL, 0);
+
+	File->WritePartition(BasePartition, false);
+
+	// Add a RIP (note that we have to manually KAG align as a footer can end off the KAG)
+	if(KAG > 1) File->Align(KAG);
+	File->WriteRIP();
+
+	File->Flush();
+
+	State = BodyStateDone;
+
+	return true;
+}
+
+
+//! Get the edit unit at which the source of a given stream must restart when resuming
+Position BodyWriterCheckpoint::GetEditUnit(UInt32 BodySID) const
+{
+	std::vector<StreamState>::const_iterator it = Streams.begin();
+	while(it != Streams.end())
+	{
+		if((*it).BodySID == BodySID) return (*it).EditUnit;
+		it++;
+	}
+
+	return -1;
+}
+
+
+//! Save the checkpoint to a file, replacing any previous checkpoint so that a crash part-way through leaves one or the other
+bool BodyWriterCheckpoint::Write(const std::string &FileName) const
+{
+	std::string TempName = FileName + ".tmp";
+
+	FILE *Out = fopen(TempName.c_str(), "w");
+	if(!Out) return false;
+
+	fprintf(Out, "mxflib-checkpoint 1\n");
+	fprintf(Out, "partition %s %u %s\n", Int64toString(PartitionPos).c_str(), PartitionBodySID, Int64toString(ResumePos).c_str());
+
+	std::vector<PartitionEntry>::const_iterator Part_it = Partitions.begin();
+	while(Part_it != Partitions.end())
+	{
+		fprintf(Out, "rip %s %u\n", Int64toString((*Part_it).first).c_str(), (*Part_it).second);
+		Part_it++;
+	}
+
+	std::vector<StreamState>::const_iterator it = Streams.begin();
+	while(it != Streams.end())
+	{
+		fprintf(Out, "stream %u %u %s %s %s\n", (*it).BodySID, (*it).IndexSID, Int64toString((*it).StreamOffset).c_str(),
+				Int64toString((*it).EditUnit).c_str(), Int64toString((*it).NextSprinkled).c_str());
+		it++;
+	}
+
+	bool Ret = (fflush(Out) == 0);
+	if(fclose(Out) != 0) Ret = false;
+	if(!Ret) return false;
+
+	// DRAGONS: Windows will not rename over an existing file
+#ifdef _WIN32
+	remove(FileName.c_str());
+#endif
+
+	return rename(TempName.c_str(), FileName.c_str()) == 0;
+}
+
+
+//! Load a checkpoint from a file
+bool BodyWriterCheckpoint::Read(const std::string &FileName)
+{
+	*this = BodyWriterCheckpoint();
+
+	FILE *In = fopen(FileName.c_str(), "r");
+	if(!In) return false;
+
+	bool Ret = false;
+	char Line[256];
+	while(fgets(Line, sizeof(Line), In))
+	{
+		char Tag[32];
+		char Field[5][32];
+		int Count = sscanf(Line, "%31s %31s %31s %31s %31s %31s", Tag, Field[0], Field[1], Field[2], Field[3], Field[4]) - 1;
+		if(Count < 0) continue;
+
+		if((strcmp(Tag, "mxflib-checkpoint") == 0) && (Count == 1))
+		{
+			Ret = (ato_Int64(Field[0]) == 1);
+		}
+		else if((strcmp(Tag, "partition") == 0) && (Count == 3))
+		{
+			PartitionPos = ato_Int64(Field[0]);
+			PartitionBodySID = static_cast<UInt32>(ato_Int64(Field[1]));
+			ResumePos = ato_Int64(Field[2]);
+		}
+		else if((strcmp(Tag, "rip") == 0) && (Count == 2))
+		{
+			Partitions.push_back(PartitionEntry(ato_Int64(Field[0]), static_cast<UInt32>(ato_Int64(Field[1]))));
+		}
+		else if((strcmp(Tag, "stream") == 0) && (Count == 5))
+		{
+			StreamState State;
+			State.BodySID = static_cast<UInt32>(ato_Int64(Field[0]));
+			State.IndexSID = static_cast<UInt32>(ato_Int64(Field[1]));
+			State.StreamOffset = static_cast<UInt64>(ato_Int64(Field[2]));
+			State.EditUnit = ato_Int64(Field[3]);
+			State.NextSprinkled = ato_Int64(Field[4]);
+			Streams.push_back(State);
+		}
+	}
+
+	fclose(In);
+
+	if(!Ret || !IsValid())
+	{
+		*this = BodyWriterCheckpoint();
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Move to the active body stream furthest behind in time
+/*! \return false if there are no active body streams
+ */
+bool mxflib::BodyWriter::SetScheduledStream(void)
+{
+	StreamInfoList::iterator Best = StreamList.end();
+	double BestTime = 0.0;
+
+	// Start after the current stream so that streams level in time are written in turn
+	StreamInfoList::iterator it = StreamList.begin();
+	if(CurrentBodySID)
+	{
+		it = CurrentStream;
+		it++;
+		if(it == StreamList.end()) it = StreamList.begin();
+	}
+
+	size_t Count = StreamList.size();
+	while(Count--)
+	{
+		if((*it)->Active)
+		{
+			BodyStream::StateType StreamState = (*it)->Stream->GetState();
+
+			// If we find a "done" stream deactivate it
+			if(StreamState == BodyStream::BodyStreamDone)
+			{
+				(*it)->Active = false;
 			}
-			else
+			else if((StreamState != BodyStream::BodyStreamHeadIndex) && (StreamState != BodyStream::BodyStreamFootIndex))
 			{
-				// This shouldn't be possible!
-				mxflib_assert(0);
+				double Time = GetStreamTime(*it);
+				if((Best == StreamList.end()) || (Time < BestTime))
+				{
+					Best = it;
+					BestTime = Time;
+				}
 			}
 		}
 
-		// If we have a pending write do it now
-		if(PartitionWritePending) EndPartition();
+		it++;
+		if(it == StreamList.end()) it = StreamList.begin();
+	}
 
-		// Write the index table
-		DataChunkPtr IndexChunk = new DataChunk;
-		Index->WriteIndex(*IndexChunk);
+	if(Best == StreamList.end()) return false;
 
-		// Don't write empty index partitions
-		if(IndexChunk->Size)
-		{
-			// Set the index SID
-			BasePartition->SetUInt(IndexSID_UL,  Index->IndexSID);
+	CurrentStream = Best;
+	CurrentBodySID = (*CurrentStream)->Stream->GetBodySID();
 
-			// Record the index data to write
-			PendingIndexData = IndexChunk;
+	return true;
+}
 
-			// Queue the write
-			PartitionWritePending = true;
-		}
 
-		// Set the "done" flag for this index type
-		// DRAGONS: Is this an MSVC funny or can we really not do bitmaths with enums without them becoming integers?
-		BodyStream::IndexType Flags = Stream->GetFooterIndex();
-		Stream->SetFooterIndex((BodyStream::IndexType) (Flags | IndexFlags) );
-		if(Flags == Stream->GetFooterIndex())
-		{
-			error("Internal Error: Failed to clear footer index flag 0x%04x for BodySID 0x%04x\n", (int)IndexFlags, (int)CurrentBodySID);
+//! Get the number of seconds of essence written so far for a stream
+double mxflib::BodyWriter::GetStreamTime(StreamInfoPtr &Info)
+{
+	EssenceSourcePtr &Source = Info->Stream->GetSource();
+	if(!Source) return 0.0;
 
-			// Flag all indexing done
-			Stream->SetFooterIndex(Stream->GetIndexType());
-		}
+	Rational EditRate = Source->GetEditRate();
+	if((EditRate.Numerator <= 0) || (EditRate.Denominator <= 0)) return 0.0;
 
-		// This stream has done a cycle - move to the next stream
-		SetNextStream();
-	}
+	return (static_cast<double>(Info->Written) * EditRate.Denominator) / EditRate.Numerator;
+}
 
-	// If index data cannot share with metadata force any pending index data to be flushed before writing the actual footer
-	if((!IndexSharesWithMetadata) && WriteMetadata && PartitionWritePending && PendingIndexData)
-	{
-		EndPartition();
-	}
 
-	// Turn the partition into the correct type of footer
-	if(IsComplete)
-		BasePartition->ChangeType(CompleteFooter_UL);
-	else
-		BasePartition->ChangeType(Footer_UL);
+//! Reduce the limits for the next write of the current stream to those of the schedule
+void mxflib::BodyWriter::GetScheduledLimits(Length &Duration, Length &MaxPartitionSize)
+{
+	if(ScheduleDuration && ((Duration == 0) || (ScheduleDuration < Duration))) Duration = ScheduleDuration;
+	if(ScheduleSize && ((MaxPartitionSize == 0) || (ScheduleSize < MaxPartitionSize))) MaxPartitionSize = ScheduleSize;
 
-	// Flag that we have a partition to write
-	PartitionWritePending = true;
+	if(ScheduleSkew <= 0.0) return;
 
-	// And that it is a footer
-	PendingFooter = true;
+	// Find the time of the other active body stream furthest behind
+	bool Found = false;
+	double Behind = 0.0;
+	StreamInfoList::iterator it = StreamList.begin();
+	while(it != StreamList.end())
+	{
+		if((it != CurrentStream) && (*it)->Active)
+		{
+			BodyStream::StateType StreamState = (*it)->Stream->GetState();
+			if((StreamState != BodyStream::BodyStreamDone) && (StreamState != BodyStream::BodyStreamHeadIndex) && (StreamState != BodyStream::BodyStreamFootIndex))
+			{
+				double Time = GetStreamTime(*it);
+				if(!Found || (Time < Behind)) Behind = Time;
+				Found = true;
+			}
+		}
+		it++;
+	}
 
-	// Set the metadata status
-	PendingMetadata = WriteMetadata;
+	// With no other streams there is nothing to keep in step with
+	if(!Found) return;
 
-	// Write the footer now
-	EndPartition();
+	EssenceSourcePtr &Source = (*CurrentStream)->Stream->GetSource();
+	if(!Source) return;
 
-	// Flag the writing as all done
-	State = BodyStateDone;
+	Rational EditRate = Source->GetEditRate();
+	if((EditRate.Numerator <= 0) || (EditRate.Denominator <= 0)) return;
 
-	// Last thing we do is write the RIP
-	// TODO: At the moment there is no way to not write a RIP which is probably the best way
-	//       however if there is a good reason to allow it to be omitted...
-	// Add a RIP (note that we have to manually KAG align as a footer can end off the KAG)
-	if(KAG > 1) File->Align(KAG);
-	File->WriteRIP();
+	// DRAGONS: At least one edit unit is always allowed, otherwise a stream whose edit units are longer than the skew could never be written
+	double Allowed = (Behind + ScheduleSkew - GetStreamTime(*CurrentStream)) * EditRate.Numerator / EditRate.Denominator;
+	Length Units = (Allowed < 1.0) ? 1 : static_cast<Length>(Allowed);
+
+	if((Duration == 0) || (Units < Duration)) Duration = Units;
 }
 
 
@@ -3871,6 +4985,9 @@ void mxflib::BodyWriter::SetNextStream(void)
 	// If we haven't done anything yet we are to do the header
 	if(State == BodyStateStart) State = BodyStateHeader;
 
+	// When scheduling by time the body stream furthest behind is written next
+	if((State == BodyStateBody) && ScheduleByTime && SetScheduledStream()) return;
+
 	// See if we need to restart the list - otherwise move to the next stream
 	if(!CurrentBodySID) CurrentStream = StreamList.begin();
 	else
@@ -4030,6 +5147,9 @@ void BodyStream::AddSubStream(EssenceSourcePtr &SubSource, DataChunkPtr Key /*=N
 
 		SubSource->SetStreamID(EssenceID);
 
+		// Pass on any digest for this source
+		if(SubSource->GetDigest()) StreamWriter->SetDigest(EssenceID, SubSource->GetDigest());
+
 		// Ensure the write-order is corrected if required
 		if(SubSource->RelativeWriteOrder())
 		{
@@ -4039,6 +5159,20 @@ void BodyStream::AddSubStream(EssenceSourcePtr &SubSource, DataChunkPtr Key /*=N
 }
 
 
+//! Replace one of the sources of this stream, such as with a wrapper for it
+void BodyStream::ReplaceSource(EssenceSourcePtr &OldSource, EssenceSourcePtr &NewSource)
+{
+	BodyStream::iterator it = begin();
+	while(it != end())
+	{
+		if((*it) == OldSource) (*it) = NewSource;
+		it++;
+	}
+
+	if(Source == OldSource) Source = NewSource;
+}
+
+
 //! Set the current GCWriter
 void BodyStream::SetWriter(GCWriterPtr &Writer) 
 { 
@@ -4065,6 +5199,9 @@ void BodyStream::SetWriter(GCWriterPtr &Writer)
 
 		(*it)->SetStreamID(EssenceID);
 
+		// Pass on any digest for this source
+		if((*it)->GetDigest()) StreamWriter->SetDigest(EssenceID, (*it)->GetDigest());
+
 		// Ensure the write-order is corrected if required
 		if((*it)->RelativeWriteOrder())
 		{
@@ -4636,10 +5773,263 @@ bool ListOfFiles::GetNextFile(void)
 		return false;
 	}
 
+	// Start opening the following files
+	if(Lookahead) QueueLookahead();
+
 	return true;
 }
 
 
+namespace mxflib
+{
+	//! A thread that opens and reads files for a FileLookahead
+	class FileLookaheadWorker : public Thread
+	{
+	protected:
+		FileLookahead *Owner;						//!< The lookahead we work for
+
+	public:
+		FileLookaheadWorker(FileLookahead *Owner) : Owner(Owner) {}
+		~FileLookaheadWorker() { Join(); }
+
+	protected:
+		void Run(void) { Owner->Work(); }
+	};
+}
+
+
+//! Queue a file to be opened
+void FileLookahead::Add(std::string Name)
+{
+	MutexLock Locked(Lock);
+
+	if(Stopping) return;
+
+	Entry NewEntry;
+	NewEntry.Name = Name;
+	NewEntry.State = Queued;
+	NewEntry.Dropped = false;
+	Entries.push_back(NewEntry);
+
+	// Start the workers the first time they are needed, no more than the shared executor has workers
+	unsigned int Limit = ThreadCount;
+	unsigned int ExecutorWorkers = GetTaskExecutor().GetWorkers();
+	if(ExecutorWorkers && (Limit > ExecutorWorkers)) Limit = ExecutorWorkers;
+
+	while(Workers.size() < Limit)
+	{
+		FileLookaheadWorker *Worker = new FileLookaheadWorker(this);
+		if(!Worker->Start())
+		{
+			delete Worker;
+
+			// If we can't start any threads at all the files will simply be opened by the caller
+			if(Workers.empty()) warning("Unable to start a file lookahead thread\n");
+			break;
+		}
+		Workers.push_back(Worker);
+	}
+
+	Changed.Broadcast();
+}
+
+
+//! Get the handle of a queued file
+bool FileLookahead::Take(std::string Name, FileHandle &Handle)
+{
+	MutexLock Locked(Lock);
+
+	EntryList::iterator Found = Entries.begin();
+	while(Found != Entries.end())
+	{
+		if((!(*Found).Dropped) && ((*Found).Name == Name)) break;
+		Found++;
+	}
+
+	// Drop all files before this one, or all files if it is not queued, as they will not be used now
+	EntryList::iterator it = Entries.begin();
+	while(it != Found)
+	{
+		if((*it).State == Opening)
+		{
+			// The worker closes the file and removes the entry once it is done with it
+			(*it).Dropped = true;
+			it++;
+		}
+		else
+		{
+			if(((*it).State == Ready) && FileValid((*it).Handle)) FileClose((*it).Handle);
+			it = Entries.erase(it);
+		}
+	}
+
+	if(Found == Entries.end()) return false;
+
+	// DRAGONS: The entry is not dropped, so the worker opening it will not remove it
+	while((*Found).State == Opening) Changed.Wait(Lock);
+
+	// If no worker has started on this file yet the caller can open it as quickly as we could
+	bool Ret = false;
+	if((*Found).State == Ready)
+	{
+		Handle = (*Found).Handle;
+		Ret = FileValid(Handle);
+	}
+
+	Entries.erase(Found);
+
+	return Ret;
+}
+
+
+//! Get the number of files queued and not yet taken
+size_t FileLookahead::GetPending(void)
+{
+	MutexLock Locked(Lock);
+
+	size_t Ret = 0;
+	EntryList::iterator it = Entries.begin();
+	while(it != Entries.end())
+	{
+		if(!(*it).Dropped) Ret++;
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Stop the workers and close any files not taken
+void FileLookahead::Stop(void)
+{
+	{
+		MutexLock Locked(Lock);
+		Stopping = true;
+		Changed.Broadcast();
+	}
+
+	std::vector<FileLookaheadWorker*>::iterator WorkerIt = Workers.begin();
+	while(WorkerIt != Workers.end())
+	{
+		delete *WorkerIt;
+		WorkerIt++;
+	}
+	Workers.clear();
+
+	// The workers have removed any entries they were opening, so all that remain are Queued or Ready
+	MutexLock Locked(Lock);
+	EntryList::iterator it = Entries.begin();
+	while(it != Entries.end())
+	{
+		if(((*it).State == Ready) && FileValid((*it).Handle)) FileClose((*it).Handle);
+		it++;
+	}
+	Entries.clear();
+}
+
+
+//! Open and read queued files until stopped, called on each worker thread
+void FileLookahead::Work(void)
+{
+	UInt8 *Buffer = ReadSize ? new UInt8[ReadSize] : NULL;
+
+	Lock.Lock();
+	for(;;)
+	{
+		// Find the first file that nobody has started on
+		EntryList::iterator it = Entries.begin();
+		while((it != Entries.end()) && ((*it).State != Queued)) it++;
+
+		if(Stopping) break;
+
+		if(it == Entries.end())
+		{
+			Changed.Wait(Lock);
+			continue;
+		}
+
+		(*it).State = Opening;
+		std::string Name = (*it).Name;
+
+		Lock.Unlock();
+
+		FileHandle Handle = FileOpenRead(Name.c_str());
+		if(FileValid(Handle) && Buffer)
+		{
+			// Read the whole file so that it is in the file cache when it is parsed
+			// DRAGONS: Stopping is read without the lock, the worst case is that we read one more buffer than needed
+			Int64 Bytes = FileSize(Handle);
+			if(Bytes > 0) FilePrefetch(Handle, 0, static_cast<UInt64>(Bytes));
+
+			UInt64 Pos = 0;
+			while(!Stopping)
+			{
+				size_t Bytes = FileReadAt(Handle, Pos, Buffer, ReadSize);
+				if((Bytes == 0) || (Bytes == static_cast<size_t>(-1))) break;
+
+				Pos += Bytes;
+				if(Bytes < ReadSize) break;
+			}
+
+			// Leave the file pointer at the start for the parser
+			FileSeek(Handle, 0);
+		}
+
+		Lock.Lock();
+
+		if((*it).Dropped || Stopping)
+		{
+			if(FileValid(Handle)) FileClose(Handle);
+			Entries.erase(it);
+		}
+		else
+		{
+			(*it).Handle = Handle;
+			(*it).State = Ready;
+		}
+
+		Changed.Broadcast();
+	}
+	Lock.Unlock();
+
+	delete[] Buffer;
+}
+
+
+//! Open files of this list in advance on background threads
+void ListOfFiles::SetLookahead(int Files, unsigned int Threads /*=2*/, size_t ReadSize /*=1024*1024*/)
+{
+	LookaheadFiles = Files;
+	Lookahead = (Files > 0) ? new FileLookahead(Threads, ReadSize) : NULL;
+}
+
+
+//! Queue the files that follow the current one with the lookahead
+/*! DRAGONS: Only files from the current filename pattern are predicted, the lookahead restarts with the first file of
+ *           any following pattern as the names of those files are not known until the pattern is parsed
+ */
+void ListOfFiles::QueueLookahead(void)
+{
+	if(!Lookahead) return;
+
+	// The files already queued are those immediately following the current file
+	int Queued = static_cast<int>(Lookahead->GetPending());
+
+	char *NameBuffer = new char[1024];
+	while(Queued < LookaheadFiles)
+	{
+		// Don't queue beyond the end of the pattern
+		if((FilesRemaining >= 0) && (Queued >= FilesRemaining)) break;
+
+		sprintf(NameBuffer, BaseFileName.c_str(), FileNumber + (Queued * ListIncrement));
+		Lookahead->Add(std::string(NameBuffer));
+
+		Queued++;
+	}
+	delete[] NameBuffer;
+}
+
+
 
 //! Set the sequential source to use the EssenceSource from the currently open and identified source file
 /*! \return true if all OK, false if no EssenceSource available
@@ -5061,6 +6451,9 @@ void RangedEssenceSource::LocateStart(void)
 	// Start pre-charging from 0
 	PreChargeStart = 0;
 
+	// Go straight to the start if the source can, as it then has no pre-charge
+	if((RequestedStart > Base->GetCurrentPosition()) && Base->SkipTo(RequestedStart)) PreChargeStart = RequestedStart;
+
 	// Skip forwards until we reach the requested start
 	Position Pos;
 	while((Pos = Base->GetCurrentPosition()) <= RequestedStart)
@@ -5276,6 +6669,39 @@ void BodyStream::InitIndexManager(void)
 }
 
 
+//! Free the index entries covered by sprinkled index tables already written, if in bounded index memory mode
+void BodyStream::FreeIndexEntries(void)
+{
+	if((!BoundedIndex) || (!IndexMan) || IndexMan->IsCBR()) return;
+
+	// Entries after the last one written may still be updated with temporal offsets for earlier edit units, so
+	// when reordering the last 128 (the furthest a temporal offset can reach) are kept
+	Position Limit = NextSprinkled;
+	if(IndexMan->GetUsesReordering()) Limit -= 128;
+
+	// Move any sparse entries that are about to be freed into the summary table
+	while((!SparseList.empty()) && (SparseList.front() < Limit))
+	{
+		if(!SparseSummary)
+		{
+			SparseSummary = IndexMan->MakeIndex();
+
+			// Force no re-ordering in the sparse index (to prevent unsatisfied links)
+			int i;
+			for(i=0; i<SparseSummary->BaseDeltaCount; i++)
+			{
+				if(SparseSummary->BaseDeltaArray[i].PosTableIndex < 0) SparseSummary->BaseDeltaArray[i].PosTableIndex = 0;
+			}
+		}
+
+		IndexMan->AddEntriesToIndex(SparseSummary, SparseList.front(), SparseList.front());
+		SparseList.pop_front();
+	}
+
+	IndexMan->Flush(IndexTable::IndexLowest, Limit - 1);
+}
+
+
 //! Initialize all required index managers
 void BodyWriter::InitIndexManagers(void)
 {
@@ -5288,6 +6714,59 @@ void BodyWriter::InitIndexManagers(void)
 }
 
 
+//! Replace the sources of each suitable stream with prefetching sources
+void BodyWriter::StartPrefetch(void)
+{
+	PrefetchStarted = true;
+
+	StreamInfoList::iterator it = StreamList.begin();
+	while(it != StreamList.end())
+	{
+		BodyStreamPtr &Stream = (*it)->Stream;
+
+		// Only frame wrapped streams are read a wrapping unit at a time in a fixed order
+		bool Suitable = (Stream->GetWrapType() == BodyStream::StreamWrapFrame) && (Stream->GetPrechargeSize() == 0);
+
+		BodyStream::iterator SourceIt = Stream->begin();
+		while(Suitable && (SourceIt != Stream->end()))
+		{
+			if((*SourceIt)->IsSystemItem() || (*SourceIt)->GetPrechargeSize()) Suitable = false;
+			SourceIt++;
+		}
+
+		if(Suitable)
+		{
+			PrefetchGroupPtr Group = new PrefetchGroup(PrefetchDepth, Stream->GetIndexManager());
+			PrefetchGroups.push_back(Group);
+
+			// Take a copy of the source list as we will be modifying the stream
+			EssenceSourceList Sources = *Stream;
+			EssenceSourceList::iterator CopyIt = Sources.begin();
+			while(CopyIt != Sources.end())
+			{
+				EssenceSourcePtr NewSource = Group->AddSource(*CopyIt);
+				Stream->ReplaceSource(*CopyIt, NewSource);
+				CopyIt++;
+			}
+		}
+
+		it++;
+	}
+}
+
+
+//! Stop all prefetch threads, any remaining data will be read synchronously
+void BodyWriter::StopPrefetch(void)
+{
+	std::list<PrefetchGroupPtr>::iterator it = PrefetchGroups.begin();
+	while(it != PrefetchGroups.end())
+	{
+		(*it)->Stop();
+		it++;
+	}
+}
+
+
 //! Get the WriteOrder for the specified stream
 /*! \return -1 if not found */
 Int32 GCWriter::GetWriteOrder(GCStreamID ID)
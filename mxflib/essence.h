@@ -44,6 +44,12 @@ namespace mxflib
 	class GCReader;
 	typedef SmartPtr<GCReader> GCReaderPtr;
 
+	// Forward declare
+	class StreamDispatcher;
+
+	//! Smart pointer to a StreamDispatcher
+	typedef SmartPtr<StreamDispatcher> StreamDispatcherPtr;
+
 	// Type used to identify stream
 	typedef int GCStreamID;
 
@@ -56,6 +62,12 @@ namespace mxflib
 	//! List of smart pointers to BodyStreams
 	typedef std::list<BodyStreamPtr> BodyStreamList;
 
+	// Forward declare
+	class PrefetchGroup;
+
+	//! Smart pointer to a PrefetchGroup
+	typedef SmartPtr<PrefetchGroup> PrefetchGroupPtr;
+
 	// Forward declare
 	class EssenceSubParser;
 
@@ -64,6 +76,12 @@ namespace mxflib
 
 	//! PArent pointer to an EssenceSubParser
 	typedef ParentPtr<EssenceSubParser> EssenceSubParserParent;
+
+	// Forward declare
+	class EssenceDigest;
+
+	//! Smart pointer to an EssenceDigest
+	typedef SmartPtr<EssenceDigest> EssenceDigestPtr;
 }
 
 
@@ -126,6 +144,26 @@ namespace mxflib
 	typedef std::list<WrappingOptionPtr> WrappingOptionList;
 
 
+	//! A run of whole edit units read from an EssenceSource in one call, held back to back in a single buffer
+	class EssenceBatch : public RefCount<EssenceBatch>
+	{
+	public:
+		DataChunkPtr Buffer;					//!< The data of all the edit units, back to back
+		std::vector<size_t> Sizes;				//!< The size of each edit unit in Buffer
+		std::vector<bool> EditPoints;			//!< True for each edit unit that is an edit point
+		Position FirstPosition;					//!< The position of the first edit unit, in GetEditRate() sized edit units
+
+	public:
+		EssenceBatch() : FirstPosition(0) {}
+
+		//! Get the number of edit units in the batch
+		size_t size(void) const { return Sizes.size(); }
+	};
+
+	//! A smart pointer to an EssenceBatch
+	typedef SmartPtr<EssenceBatch> EssenceBatchPtr;
+
+
 	//! Abstract super-class for objects that supply large quantities of essence data
 	/*! This is used when clip-wrapping to prevent large quantities of data being loaded into memory 
 	 *! \note Classes derived from this class <b>must not</b> include their own RefCount<> derivation
@@ -161,9 +199,21 @@ namespace mxflib
 		 */
 		MDObjectPtr EssenceDescriptor;
 
+		//! Digest to receive all essence data written from this source, or NULL if none
+		EssenceDigestPtr Digest;
+
+		//! The batch that GetBatchedEssenceData() is returning edit units from, or NULL if none
+		EssenceBatchPtr CurrentBatch;
+
+		//! The index in CurrentBatch of the next edit unit to return
+		size_t BatchNext;
+
+		//! The offset in the buffer of CurrentBatch of the next edit unit to return
+		size_t BatchOffset;
+
 	public:
 		//! Base constructor
-		EssenceSource() : StreamID(-1), LenToSend(-1) {};
+		EssenceSource() : StreamID(-1), LenToSend(-1), BatchNext(0), BatchOffset(0) {};
 
 		//! Virtual destructor to allow polymorphism
 		virtual ~EssenceSource() { };
@@ -185,6 +235,49 @@ namespace mxflib
 		 */
 		virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0) = 0;
 
+		//! Get a run of whole edit units in one call, if this source is able to
+		/*! This is an optional alternative to a GetEssenceData() call per edit unit, with the calls to IsEditPoint() and
+		 *  GetCurrentPosition() around each, for sources that know the size of each edit unit ahead of reading it.
+		 *  The source is left as if each edit unit of the batch had been read by GetEssenceData().
+		 *  \param MaxUnits The most edit units to return
+		 *  \param MaxBytes The most bytes to return, or 0 for no limit, although the first edit unit is returned whatever its size
+		 *  \return The batch, or NULL if this source does not read batches or can't at this point, when GetEssenceData() must be used
+		 */
+		virtual EssenceBatchPtr GetEssenceBatch(size_t MaxUnits, size_t MaxBytes) { return NULL; }
+
+		//! Get the next edit unit, from a batch read with GetEssenceBatch() if this source supports them, else from GetEssenceData()
+		/*! The edit unit returned from a batch refers to the batch buffer rather than holding a copy.
+		 *  DRAGONS: Up to MaxUnits edit units are read ahead of those returned, so once this is used the source must only
+		 *           be read with this method, and any edit units of a batch not returned are lost if reading stops early
+		 */
+		DataChunkPtr GetBatchedEssenceData(size_t MaxUnits, size_t MaxBytes);
+
+		//! Is the last edit unit returned by GetBatchedEssenceData() an edit point?
+		bool IsBatchedEditPoint(void) { return (CurrentBatch && BatchNext) ? CurrentBatch->EditPoints[BatchNext - 1] : IsEditPoint(); }
+
+		//! Get the position of the next edit unit to be returned by GetBatchedEssenceData(), in GetEditRate() sized edit units
+		Position GetBatchedPosition(void) { return CurrentBatch ? (CurrentBatch->FirstPosition + BatchNext) : GetCurrentPosition(); }
+
+		//! Get the location of the rest of a clip if it is held as a single range of a file
+		/*! This allows a clip-wrapping writer to have the OS copy the clip from the file (see MXFFile::WriteFromFile()) rather
+		 *  than reading it with GetEssenceData(). If true is returned the source is left as if all of this data had been read.
+		 *  \param File	Set to the file holding the data
+		 *  \param Start	Set to the position of the first byte of data in the file
+		 *  \param Size	Set to the number of bytes of data
+		 *  \return false if the data is not available this way, in which case it must be read with GetEssenceData()
+		 *  \note The default is never to offer the data this way
+		 */
+		virtual bool GetEssenceFileRange(FileHandle &File, Position &Start, Length &Size) { return false; }
+
+		//! Move directly to a given edit unit, without reading the essence before it
+		/*! This allows a RangedEssenceSource to start part way through a long source without reading up to the start.
+		 *  As no pre-charge is read this should only be supported by sources in which every edit unit is an edit point.
+		 *  \param EditUnit The edit unit, in GetEditRate() sized edit units, to be returned by the next call to GetEssenceData()
+		 *  \return false if the source can't do this, in which case it is left unchanged
+		 *  \note The default is never to skip
+		 */
+		virtual bool SkipTo(Position EditUnit) { return false; }
+
 		//! Did the last call to GetEssenceData() return the end of a wrapping item
 		/*! \return true if the last call to GetEssenceData() returned an entire wrapping unit.
 		 *  \return true if the last call to GetEssenceData() returned the last chunk of a wrapping unit.
@@ -222,6 +315,13 @@ namespace mxflib
 		//! Get the stream ID for this stream or sub-stream
 		GCStreamID GetStreamID(void) { return StreamID; }
 
+		//! Set a digest to receive all essence data written from this source
+		/*! \note This must be set before the source is added to a BodyStream, which passes it to the GCWriter */
+		void SetDigest(EssenceDigestPtr NewDigest) { Digest = NewDigest; }
+
+		//! Get the digest receiving essence data written from this source, or NULL if none
+		EssenceDigestPtr GetDigest(void) { return Digest; }
+
 		//! Is the last data read the start of an edit point?
 		virtual bool IsEditPoint(void) { return true; }
 
@@ -556,6 +656,11 @@ namespace mxflib
 		UInt32 WriteOrder;					//!< The (default) write order for this stream
 											/*!< Elements with a lower WriteOrder are written first when the
 											 *   content package is written */
+		EssenceDigestPtr Digest;			//!< Digest to receive the value of each essence KLV written for this stream, or NULL if none
+		UInt8 KLHeader[16 + 9];				//!< The key of each KLV of this stream, followed by space for its BER length, built when first needed
+		bool KeyBuilt;						//!< True once the key in KLHeader has been built
+
+		GCStreamData() : KeyBuilt(false) {}
 	};
 
 	//! Class that manages writing of generic container essence
@@ -587,6 +692,16 @@ namespace mxflib
 		//! Map of all used write orders to stream ID - used to ensure no duplicates
 		std::map<UInt32, GCStreamID> WriteOrderMap;
 
+		size_t QueueBudget;					//!< Number of bytes that may be queued before the queue is written early, or 0 for no limit
+		UInt64 QueuedBytes;					//!< Number of bytes currently held in the write queue
+		UInt8 PartialType;					//!< Type of the last item written by an early write of the current CP, or 0xff if none
+
+		//! Get the preformatted key of an essence stream, followed by space for a BER length, building it the first time
+		/*! The header of each KLV is then built by copying the key and setting only the length bytes.
+		 *  \note Building the key fixes the essence element count of the stream (See SMPTE-379M section 7.1)
+		 */
+		UInt8 *GetKLHeader(GCStreamID ID);
+
 
 	public:
 		//! Constructor
@@ -662,6 +777,15 @@ namespace mxflib
 		//! Assign an essence container (mapping) UL to the specified stream
 		void AssignEssenceUL(GCStreamID ID, ULPtr EssenceUL);
 
+		//! Set a digest to receive the value of each essence KLV written for the specified stream
+		/*! The data is hashed as it is written by Flush(), so no extra read of the essence or of the file is needed.
+		 *  \note A clip that would otherwise be copied from its file by the OS is read and written normally instead
+		 */
+		void SetDigest(GCStreamID ID, EssenceDigestPtr Digest);
+
+		//! Start a new partition in the digest of each stream, at a given file position
+		void StartDigestPartition(Position Partition);
+
 		//! Start a new content package (and write out the prevous one if required)
 		void StartNewCP(void);
 
@@ -671,9 +795,24 @@ namespace mxflib
 		//! Flush any remaining data
 		void Flush(void);
 
+		//! Set the number of bytes that may be held in the write queue
+		/*! If adding an item takes the queue beyond this the items queued so far are written at once, rather than at the
+		 *  end of the content package, so that memory use stays bounded when one source supplies far more data than the
+		 *  others. Such an early write is counted by StatsGCWriterEarlyWrites.
+		 *  \param Bytes The number of bytes, or 0 for no limit
+		 *  \note Items added after an early write are written after those already written, whatever their write order
+		 */
+		void SetQueueBudget(size_t Bytes) { QueueBudget = Bytes; }
+
+		//! Get the number of bytes currently held in the write queue
+		UInt64 GetQueuedBytes(void) const { return QueuedBytes; }
+
 		//! Get the current stream offset
 		Int64 GetStreamOffset(void) { return StreamOffset; }
 
+		//! Set the current stream offset, such as when continuing an essence container already partly written
+		void SetStreamOffset(UInt64 Offset) { StreamOffset = Offset; }
+
 		//! Set the index position for the current CP
 		void SetIndexEditUnit(Position EditUnit) { IndexEditUnit = EditUnit; }
 
@@ -718,14 +857,18 @@ namespace mxflib
 		Length CalcRawSize(KLVObjectPtr Object);
 
 		//! Write a raw KLVObject to the file - this is written immediately and not buffered in the WriteQueue
-		void WriteRaw(KLVObjectPtr Object);
+		void WriteRaw(KLVObjectPtr Object, bool Align = true);
+
+		//! Align the file to the KAG, counting any filler in the stream offset
+		/*! This is the alignment done by WriteRaw() before and after each KLV when Align is true */
+		void AlignToKAG(void);
 
 
 		//! Structure for items to be written
 		struct WriteBlock
 		{
 			UInt64 Size;				//!< Number of bytes of data to write
-			UInt8 *Buffer;				//!< Pointer to bytes to write
+			UInt8 *Buffer;				//!< Pointer to bytes to write (for a Source or KLVSource item, the key followed by space for its BER length)
 			EssenceSourcePtr Source;	//!< Smart pointer to an EssenceSource object or NULL
 			KLVObjectPtr KLVSource;		//!< Pointer to a KLVObject as source - or NULL
 			int LenSize;				//!< The KLV length size to use for this item (0 for auto)
@@ -736,13 +879,29 @@ namespace mxflib
 			bool IndexClip;				//!< True if indexing clip-wrapped essence
 			bool WriteEncrypted;		//!< True if the data is to be written as encrypted data (via a KLVEObject)
 			bool FastClipWrap;			//!< True if this KLV is to be "FastClipWrapped"
+			EssenceDigestPtr Digest;	//!< Digest to receive the value, or NULL if none
+			size_t DigestOffset;		//!< Offset of the value in Buffer, if it holds the value and there is a digest
 		};
 
-		//! Type for holding the write queue in write order
-		typedef std::map<UInt32,WriteBlock> WriteQueueMap;
+		//! Type for holding the write queue in write order, each item with its write order
+		/*! DRAGONS: This is a sorted array rather than a map as items are nearly always added in write order, so each
+		 *           insertion is an append to storage that is reused for every content package
+		 */
+		typedef std::vector<std::pair<UInt32, WriteBlock> > WriteQueueList;
 
 		//! Queue of items for the current content package in write order
-		WriteQueueMap WriteQueue;
+		WriteQueueList WriteQueue;
+
+	protected:
+		//! Add an item to the write queue in write order, writing the queue early if it is over budget
+		/*! Items with the same write order are kept in the order they were added */
+		void QueueBlock(UInt32 WriteOrder, const WriteBlock &Block);
+
+		//! Write the items in the write queue
+		/*! \param EndCP True if this is the end of the content package, false for an early write because the queue is over budget */
+		void WriteQueued(bool EndCP);
+
+	public:
 
 
 		//! Set the WriteOrder for the specified stream
@@ -820,6 +979,54 @@ namespace mxflib
 	};
 
 
+	//! The first and last bytes of an essence file, read once so that each sub-parser can check them without file access
+	/*! EssenceParser::IdentifyEssence() builds one of these for each file and passes it to EssenceSubParser::CanIdentify()
+	 *  so that parsers that can't handle the file are rejected without each seeking and reading its own probe data.
+	 */
+	class EssenceProbe : public RefCount<EssenceProbe>
+	{
+	protected:
+		DataChunkPtr Head;						//!< The first bytes of the file
+		DataChunkPtr Tail;						//!< The last bytes of the file, empty if they are all in Head
+		Int64 FileBytes;						//!< The size of the file, or -1 if not known
+
+	public:
+		//! Read the probe data from an open file
+		/*! \param InFile	The file to probe
+		 *  \param HeadSize	The number of bytes to read from the start of the file
+		 *  \param TailSize	The number of bytes to read from the end of the file
+		 *  \note The file pointer is left at an undefined position
+		 */
+		EssenceProbe(FileHandle InFile, size_t HeadSize = 64 * 1024, size_t TailSize = 4 * 1024);
+
+		//! Get a pointer to the first bytes of the file
+		const UInt8 *GetHead(void) const { return Head->Data; }
+
+		//! Get the number of bytes available from the start of the file
+		size_t GetHeadSize(void) const { return Head->Size; }
+
+		//! Get a pointer to the last bytes of the file
+		/*! \note If the whole file fits in the head this is the end of the head data */
+		const UInt8 *GetTail(void) const { return Tail->Size ? Tail->Data : (Head->Data + Head->Size - GetTailSize()); }
+
+		//! Get the number of bytes available from the end of the file
+		size_t GetTailSize(void) const { return Tail->Size ? Tail->Size : Head->Size; }
+
+		//! Get the size of the file, or -1 if not known
+		Int64 GetFileSize(void) const { return FileBytes; }
+
+		//! Determine if the head holds the whole file
+		bool IsWhole(void) const { return (FileBytes >= 0) && (static_cast<Int64>(Head->Size) >= FileBytes); }
+
+		//! Determine if a given number of bytes from the start of the file are available, or the file is shorter than this
+		/*! If this is true a sub-parser may decide from the head alone whenever it would have read no more than Size bytes */
+		bool HasHead(size_t Size) const { return (Head->Size >= Size) || IsWhole(); }
+	};
+
+	//! Smart pointer to an EssenceProbe
+	typedef SmartPtr<EssenceProbe> EssenceProbePtr;
+
+
 	//! Base class for any EssenceSubParserFactory classes
 	class EssenceSubParserFactory : public RefCount<EssenceSubParserFactory>
 	{
@@ -916,7 +1123,7 @@ namespace mxflib
 					{
 						if((MaxSize) && (Data->Size > MaxSize))
 						{
-							RemainingData = new DataChunk(Data->Size - MaxSize, &Data->Data[MaxSize]);
+							RemainingData = Data->Slice(MaxSize, Data->Size - MaxSize);
 							Data->Resize((UInt32)MaxSize);
 						}
 					}
@@ -1054,6 +1261,13 @@ namespace mxflib
 			return Ret;
 		}
 
+		//! Check the probe data of a file to see if this parser may be able to identify the essence
+		/*! This is called by EssenceParser::IdentifyEssence() before IdentifyEssence(), which is only called if this returns true.
+		 *  \return false only if the probe data shows that this parser can't identify the essence
+		 *  \note The default is to try every file, as a parser that doesn't check the probe data must be given the chance to read the file
+		 */
+		virtual bool CanIdentify(const EssenceProbe &Probe) { return true; }
+
 		//! Examine the open file and return the wrapping options known by this parser
 		/*! \param InFile The open file to examine (if the descriptor does not contain enough info)
 		 *	\param Descriptor An essence stream descriptor (as produced by function IdentifyEssence)
@@ -1303,6 +1517,12 @@ namespace mxflib
 		//! Initialization flag for EPList
 		static bool Inited;
 
+		//! The number of bytes read from the start of each file to identify its essence
+		static size_t ProbeHeadSize;
+
+		//! The number of bytes read from the end of each file to identify its essence
+		static size_t ProbeTailSize;
+
 	private:
 		//! Prevent instantiation of essence parser - all methods are now static
 		EssenceParser();
@@ -1330,8 +1550,19 @@ namespace mxflib
 		}
 
 		//! Build a list of parsers with their descriptors for a given essence file
+		/*! The start and end of the file are read once into an EssenceProbe, and only those sub-parsers whose CanIdentify()
+		 *  accepts the probe data go on to examine the file
+		 */
 		static ParserDescriptorListPtr IdentifyEssence(FileHandle InFile);
 
+		//! Set the number of bytes read from the start and end of each file to identify its essence
+		/*! Sub-parsers that need more than this are still asked to examine the file */
+		static void SetProbeSize(size_t HeadSize, size_t TailSize)
+		{
+			ProbeHeadSize = HeadSize;
+			ProbeTailSize = TailSize;
+		}
+
 		//! Configuration data for an essence parser with a specific wrapping option
 		class WrappingConfig;
 		
@@ -1607,6 +1838,89 @@ namespace mxflib
 	typedef SmartPtr<FileParser> FileParserPtr;
 
 
+	// Forward declare the lookahead thread, which is private to the implementation
+	class FileLookaheadWorker;
+
+	//! Opens and reads files that will be needed soon on background threads
+	/*! Names are queued with Add() in the order they will be used and are opened, in order, on up to Threads threads.
+	 *  Each file is read through once so that its contents are in the operating system's file cache, and its handle
+	 *  is then held until Take() is called for it. This hides the open and first-read latency of each file of a long
+	 *  image sequence, which otherwise dominates the wrapping time on network storage.
+	 *  \note The files are only read to warm the file cache, the handles returned by Take() are positioned at the start
+	 */
+	class FileLookahead : public RefCount<FileLookahead>
+	{
+	protected:
+		//! The state of a queued file
+		enum EntryState
+		{
+			Queued,								//!< Not yet started
+			Opening,							//!< Being opened and read by a worker
+			Ready								//!< Opened (or failed to open) and waiting to be taken
+		};
+
+		//! A queued file
+		struct Entry
+		{
+			std::string Name;					//!< The name of the file
+			FileHandle Handle;					//!< The handle, once Ready, which may be invalid if the open failed
+			EntryState State;					//!< The state of this file
+			bool Dropped;						//!< Set if this file is no longer wanted while a worker is opening it
+		};
+
+		//! List of queued files, in the order they will be used
+		/*! DRAGONS: A list is used so that a worker may hold an iterator to its entry while the lock is released */
+		typedef std::list<Entry> EntryList;
+
+		size_t ReadSize;						//!< The size of each read used to warm the file cache, or 0 to only open the files
+		unsigned int ThreadCount;				//!< The number of threads to use
+
+		Mutex Lock;							//!< Lock protecting all of the following
+		Condition Changed;						//!< Signalled when an entry is added or becomes Ready, or when stopping
+		EntryList Entries;						//!< The queued files
+		bool Stopping;							//!< Set to stop the workers
+
+		std::vector<FileLookaheadWorker*> Workers;	//!< The worker threads, started by the first Add()
+
+		friend class FileLookaheadWorker;
+
+	public:
+		//! Construct a lookahead
+		/*! \param Threads	The number of files that may be opened at once
+		 *  \param ReadSize	The size of each read used to warm the file cache, or 0 to only open the files
+		 *  \note No more threads are started than the worker count of the shared TaskExecutor
+		 */
+		FileLookahead(unsigned int Threads = 2, size_t ReadSize = 1024 * 1024)
+			: ReadSize(ReadSize), ThreadCount(Threads ? Threads : 1), Stopping(false) {}
+
+		//! Stop the workers and close any files not taken
+		~FileLookahead() { Stop(); }
+
+		//! Queue a file to be opened
+		void Add(std::string Name);
+
+		//! Get the handle of a queued file
+		/*! Any files queued before this one are dropped, as the caller has moved past them.
+		 *  \return true if Handle has been set to an open handle for the file, false if the file was not queued, is
+		 *          not yet started or could not be opened, in which case the caller should open the file itself
+		 */
+		bool Take(std::string Name, FileHandle &Handle);
+
+		//! Get the number of files queued and not yet taken
+		size_t GetPending(void);
+
+		//! Stop the workers and close any files not taken
+		void Stop(void);
+
+	protected:
+		//! Open and read queued files until stopped, called on each worker thread
+		void Work(void);
+	};
+
+	//! Smart pointer to a FileLookahead
+	typedef SmartPtr<FileLookahead> FileLookaheadPtr;
+
+
 	//! List-of-files base class for handling a sequential set of files
 	class ListOfFiles
 	{
@@ -1631,9 +1945,12 @@ namespace mxflib
 		Position RangeEnd;						//!< The requested last edit unit, or -1 if using RequestedDuration
 		Length RangeDuration;					//!< The requested duration, or -1 if using RequestedEnd
 
+		FileLookaheadPtr Lookahead;				//!< Lookahead opening the following files in advance, or NULL if not used
+		int LookaheadFiles;						//!< The number of following files to keep queued with Lookahead
+
 	public:
 		//! Construct a ListOfFiles and optionally set a single source filename pattern
-		ListOfFiles(std::string FileName = "") : ExternalEssence(false), RangeStart(-1), RangeEnd(-1), RangeDuration(-1)
+		ListOfFiles(std::string FileName = "") : ExternalEssence(false), RangeStart(-1), RangeEnd(-1), RangeDuration(-1), LookaheadFiles(0)
 		{
 			AtEOF = false;
 
@@ -1728,10 +2045,33 @@ namespace mxflib
 		//! Has this essence been flagged to remain external (filename prepended with "!")
 		bool IsExternal(void) { return ExternalEssence; }
 
+		//! Open files of this list in advance on background threads
+		/*! Once each file is opened up to Files of the following files are queued to be opened and read into the file
+		 *  cache, so that a long sequence of small files, such as a JPEG 2000 image sequence, is limited by the
+		 *  throughput of the storage rather than the latency of each open.
+		 *  \param Files	The number of following files to keep open, or 0 to open each file when it is needed
+		 *  \param Threads	The number of files that may be opened at once
+		 *  \param ReadSize	The size of each read used to warm the file cache, or 0 to only open the files
+		 *  \note Only the derived class's OpenFile() knows how to use the handles, so this has no effect unless it
+		 *        calls TakeLookaheadFile()
+		 */
+		void SetLookahead(int Files, unsigned int Threads = 2, size_t ReadSize = 1024 * 1024);
+
 	protected:
 		//! Parse a given multi-file name
 		void ParseFileName(std::string FileName);
 
+		//! Queue the files that follow the current one with the lookahead
+		void QueueLookahead(void);
+
+		//! Get a handle for the current file if it has already been opened by the lookahead
+		/*! \return true if Handle has been set to an open handle for the current file, else the file must be opened by the caller */
+		bool TakeLookaheadFile(FileHandle &Handle)
+		{
+			if(!Lookahead) return false;
+			return Lookahead->Take(CurrentFileName, Handle);
+		}
+
 		//! Process an ampersand separated list of sub-file names
 		virtual void ProcessSubNames(std::string SubNames) {};
 	};
@@ -2335,7 +2675,7 @@ namespace mxflib
 		 */
 		bool OpenFile(void)
 		{
-			CurrentFile = FileOpenRead(CurrentFileName.c_str());
+			if(!TakeLookaheadFile(CurrentFile)) CurrentFile = FileOpenRead(CurrentFileName.c_str());
 			CurrentFileOpen = FileValid(CurrentFile);
 			return CurrentFileOpen;
 		}
@@ -2455,6 +2795,14 @@ namespace mxflib
 			//! Get the next "installment" of essence data
 			virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0);
 
+			//! Get the location of the rest of a clip if it is held as a single range of a file
+			/*! \note Only the data of the current source file is offered, any following files are read by GetEssenceData() */
+			virtual bool GetEssenceFileRange(FileHandle &File, Position &Start, Length &Size)
+			{
+				if((!ValidSource()) || Outer->AtEOF) return false;
+				return CurrentSource->GetEssenceFileRange(File, Start, Size);
+			}
+
 			//! Did the last call to GetEssenceData() return the end of a wrapping item
 			virtual bool EndOfItem(void) { if(ValidSource()) return CurrentSource->EndOfItem(); else return true; }
 
@@ -2631,6 +2979,11 @@ namespace mxflib
 		bool StopNow;									//!< True if no more KLVs should be read - set by StopReading() and ReadFromFile() with SingleKLV=true
 		bool StopCalled;								//!< True if StopReading() called while processing the current KLV
 		bool PushBackRequested;							//!< True if StopReading() called with PushBackKLV = true
+		bool HeaderOnly;								//!< True if only the key and length of each KLV are read before dispatch
+		bool Positional;								//!< True if KLVs are read with positional reads, leaving the file pointer alone
+
+		AsyncReadEnginePtr AsyncEngine;					//!< Engine used to read values ahead of dispatch, or NULL to read each KLV as it is dispatched
+		unsigned int AsyncDepth;						//!< The number of KLVs to read ahead of dispatch when using AsyncEngine
 
 		GCReadHandlerPtr DefaultHandler;				//!< The default handler to receive all KLVs without a specific handler
 		GCReadHandlerPtr FillerHandler;					//!< The hanlder to receive all filler KLVs
@@ -2638,6 +2991,14 @@ namespace mxflib
 
 		std::map<UInt32, GCReadHandlerPtr> Handlers;	//!< Map of read handlers indexed by track number
 
+		//! Flat copy of Handlers, sorted by track number, used for dispatch
+		/*! DRAGONS: The handlers are not owned by this table, they are kept alive by the entries in Handlers */
+		std::vector<std::pair<UInt32, GCReadHandler_Base*> > DispatchTable;
+
+		UInt8 LastKey[16];								//!< The key of the last dispatched GC KLV, valid if LastKeyValid is true
+		bool LastKeyValid;								//!< True if LastKey and LastHandler hold a valid memo of the last dispatch
+		GCReadHandler_Base *LastHandler;				//!< The handler for KLVs with key LastKey, or NULL for the default handler
+
 	public:
 		//! Create a new GCReader, optionally with a given default item handler and filler handler
 		/*! \note The default handler receives all KLVs without a specific handler (except fillers)
@@ -2665,6 +3026,9 @@ namespace mxflib
 			this->FillerHandler = FillerHandler;
 		}
 
+		//! Get the filler handler, or NULL if fillers are discarded
+		GCReadHandlerPtr GetFillerHandler(void) { return FillerHandler; }
+
 		//! Set encryption handler
 		/*! This handler will receive all encrypted KLVs and after decrypting them will
 		 *  resubmit the decrypted version for handling using function HandleData()
@@ -2674,6 +3038,48 @@ namespace mxflib
 			this->EncryptionHandler = EncryptionHandler;
 		}
 
+		//! Enable or disable header-only reading
+		/*! In header-only mode each KLV is dispatched after reading just its key and length with a single small read,
+		 *  and the reader seeks over the value rather than reading through it. Handlers that need the value can still
+		 *  read it with KLVObject::ReadData(), but handlers that only need keys, lengths and offsets (such as when
+		 *  building indexes or scanning a file's structure) never cause it to be read.
+		 *  \note Encrypted KLVs are not passed to the encryption handler in this mode as decryption requires the value,
+		 *        they are dispatched undecrypted to the default handler instead
+		 */
+		void SetHeaderOnly(bool Enable = true) { HeaderOnly = Enable; }
+
+		//! Determine if header-only reading is enabled
+		bool IsHeaderOnly(void) const { return HeaderOnly; }
+
+		//! Enable or disable positional reading
+		/*! When enabled the reader never seeks, it reads each key and length with MXFFile::ReadKLAt() and dispatches
+		 *  KLVObjects with positional reads selected, so their values are read with MXFFile::ReadAt(). Several readers,
+		 *  such as a parallel reader and a prefetcher, can then share one open MXFFile on different threads without locks.
+		 *  \note The file position is left unchanged by ReadFromFile() in this mode
+		 */
+		void SetPositionalRead(bool Enable = true) { Positional = Enable; }
+
+		//! Determine if positional reading is enabled
+		bool IsPositionalRead(void) const { return Positional; }
+
+		//! Read the values of KLVs ahead of dispatch using a given engine
+		/*! The keys and lengths of up to Depth following KLVs are read, and their values submitted to the engine, so
+		 *  that several reads are in flight while earlier KLVs are handled. KLVs are still dispatched in file order on
+		 *  the calling thread, with their values already loaded; handlers can use KLVObject::GetData() rather than
+		 *  reading the value again. Positional reads are used throughout, so the file pointer is left unchanged.
+		 *  \param Engine The engine to use, or NULL to read each KLV as it is dispatched
+		 *  \param Depth The number of KLVs to read ahead of the one being handled
+		 *  \note This has no effect in header-only mode, and no look-ahead is done when reading a single KLV
+		 */
+		void SetAsyncRead(AsyncReadEnginePtr Engine, unsigned int Depth = 8)
+		{
+			AsyncEngine = Engine;
+			AsyncDepth = Depth ? Depth : 1;
+		}
+
+		//! Get the engine used to read values ahead of dispatch, or NULL if none
+		AsyncReadEnginePtr GetAsyncRead(void) { return AsyncEngine; }
+
 		//! Set data handler for a given track number
 		void SetDataHandler(UInt32 TrackNumber, GCReadHandlerPtr DataHandler = NULL)
 		{
@@ -2685,6 +3091,8 @@ namespace mxflib
 			{
 				Handlers.erase(TrackNumber);
 			}
+
+			BuildDispatchTable();
 		}
 
 		//! Read from file - and specify a start location
@@ -2755,6 +3163,21 @@ namespace mxflib
 
 		//! Get the offset of the start of the current KLV within this GC stream
 		Position GetStreamOffset(void) { return StreamOffset; };
+
+	protected:
+		//! Read from file using AsyncEngine to read values ahead of dispatch
+		/*! \see ReadFromFile(bool) */
+		bool ReadFromFileAsync(bool SingleKLV);
+
+		//! Determine if a KLV is a filler
+		static bool IsFiller(KLVObjectPtr &Object);
+
+		//! Rebuild DispatchTable from Handlers, and forget the last dispatch
+		void BuildDispatchTable(void);
+
+		//! Find the data handler for a given track number
+		/*! \return NULL if there is no specific handler for this track */
+		GCReadHandler_Base *FindDataHandler(UInt32 TrackNumber) const;
 	};
 }
 
@@ -2779,13 +3202,44 @@ namespace mxflib
 		GCReadHandlerPtr GCRDefaultHandler;		//!< Default handler to use for new GCReaders
 		GCReadHandlerPtr GCRFillerHandler;		//!< Filler handler to use for new GCReaders
 		GCReadHandlerPtr GCREncryptionHandler;	//!< Encryption handler to use for new GCReaders
+		bool GCRHeaderOnly;						//!< True if new GCReaders should use header-only reading
+		AsyncReadEnginePtr GCRAsyncEngine;		//!< Engine new GCReaders should use to read values ahead of dispatch, or NULL for none
+		unsigned int GCRAsyncDepth;				//!< The read-ahead depth for new GCReaders using GCRAsyncEngine
 
 		std::map<UInt32, GCReaderPtr> Readers;	//!< Map of GCReaders indexed by BodySID
 
+		PartitionTrackerPtr Tracker;			//!< Tracker following the file as it grows, or NULL if the file is not growing
+
+		std::map<UInt32, IndexTablePtr> Indexes;	//!< Map of index tables used for seeking by edit unit, indexed by BodySID
+		unsigned int PrefetchCount;				//!< Number of edit units to prefetch after each SeekToEditUnit(), or zero for none
+
+		bool ParallelDispatch;					//!< True if the handlers of each BodySID are run on the shared TaskExecutor
+		unsigned int DispatchDepth;				//!< The number of KLVs that may be queued for each BodySID when dispatching in parallel
+		std::map<UInt32, StreamDispatcherPtr> Dispatchers;	//!< Map of dispatchers used for parallel dispatch, indexed by BodySID
+
 	public:
 		//! Construct a body reader and associate it with an MXF file
 		BodyReader(MXFFilePtr File);
 
+		//! Wait for any KLVs still being dispatched in parallel
+		~BodyReader();
+
+		//! Follow the file as it grows, using a given tracker
+		/*! Once a tracker is set, Eof() only reports the end of the data that the tracker has found so far and
+		 *  Seek(BodySID, Pos) updates the tracker first, so that partitions added since the last call can be found.
+		 *  \note The tracker must be for the same file as this reader
+		 */
+		void SetTracker(PartitionTrackerPtr NewTracker) { Tracker = NewTracker; }
+
+		//! Get the tracker following the file, or NULL if none
+		PartitionTrackerPtr GetTracker(void) { return Tracker; }
+
+		//! Check for data added to a growing file since the last check
+		/*! This updates the tracker, and clears any end-of-file state if more complete KLVs are now available
+		 *  \return The number of new partitions found, or -1 on error or if there is no tracker
+		 */
+		int Poll(void);
+
 		//! Seek to a specific point in the file
 		/*! \return New location or -1 on seek error
 		 */
@@ -2804,6 +3258,36 @@ namespace mxflib
 		 */
 		Position Tell(UInt32 BodySID);
 
+		//! Set the index table to use when seeking by edit unit in a given stream
+		/*! The index table should already have been loaded, such as with IndexTable::AddSegments()
+		 */
+		void SetIndex(UInt32 BodySID, IndexTablePtr Index) { Indexes[BodySID] = Index; }
+
+		//! Get the index table used when seeking by edit unit in a given stream, or NULL if none set
+		IndexTablePtr GetIndex(UInt32 BodySID)
+		{
+			std::map<UInt32, IndexTablePtr>::iterator it = Indexes.find(BodySID);
+			if(it == Indexes.end()) return NULL;
+			return (*it).second;
+		}
+
+		//! Set the number of edit units to prefetch after each SeekToEditUnit()
+		/*! After each seek the OS is asked to start reading the data for the following edit units in the background.
+		 *  This helps when stepping or scrubbing through a file on storage with a high latency.
+		 *  \param EditUnits The number of edit units to prefetch, zero to disable prefetching
+		 */
+		void SetPrefetch(unsigned int EditUnits) { PrefetchCount = EditUnits; }
+
+		//! Seek to the start of a given edit unit in a given stream
+		/*! The index table set with SetIndex() is used to locate the edit unit, including any temporal reordering.
+		 *  \param EditUnit The edit unit to locate, in display order
+		 *  \param ToKeyFrame If true the seek is to the key frame for the edit unit, so that decoding can start there
+		 *  \return New file offset or -1 on error (such as no index table being set for this stream)
+		 *  \note If the index table is sparse the seek may be to the nearest preceding indexed edit unit, from where the GCReader
+		 *        handlers will need to read forwards to find the requested edit unit
+		 */
+		Position SeekToEditUnit(UInt32 BodySID, Position EditUnit, bool ToKeyFrame = false);
+
 		//! Set the default handler for all new GCReaders
 		/*! Each time a new GCReader is created this default handler will be used if no other is specified
 		 */
@@ -2819,6 +3303,36 @@ namespace mxflib
 		 */
 		void SetEncryptionHandler(GCReadHandlerPtr EncryptionHandler = NULL) { GCREncryptionHandler = EncryptionHandler; };
 
+		//! Enable or disable header-only reading for all GCReaders, including those already made
+		/*! \see GCReader::SetHeaderOnly()
+		 */
+		void SetHeaderOnly(bool Enable = true);
+
+		//! Read the values of KLVs ahead of dispatch for all GCReaders, including those already made
+		/*! \see GCReader::SetAsyncRead()
+		 */
+		void SetAsyncRead(AsyncReadEnginePtr Engine, unsigned int Depth = 8);
+
+		//! Enable or disable running the handlers of each BodySID in parallel
+		/*! When enabled, ReadFromFile() only frames each KLV and loads its value, then hands it to a StreamDispatcher for
+		 *  its BodySID. The handlers of each BodySID are run by a task of the shared TaskExecutor, receiving the KLVs of
+		 *  their stream in file order, while the handlers of other BodySIDs run at the same time. This helps files with
+		 *  several body streams whose handlers do heavy work such as decoding or decryption.
+		 *  \param Depth The number of KLVs that may be queued for each BodySID before reading waits for its handlers
+		 *  \note Handlers may still be running when ReadFromFile() returns, so call WaitDispatch() before using their results.
+		 *        Once a handler has failed, ReadFromFile() returns false until WaitDispatch() has been called.
+		 *  \note Handlers of different BodySIDs must not share state without their own locking, GetBodySID() gives the
+		 *        BodySID being read rather than that of the KLV being handled, and StopReading() has no effect
+		 *  \note Disabling parallel dispatch waits for any KLVs still queued
+		 *  \see StreamDispatcher
+		 */
+		void SetParallelDispatch(bool Enable = true, unsigned int Depth = 64);
+
+		//! Wait for all KLVs handed to the handlers in parallel to be dispatched
+		/*! \return false if a handler has failed since the last call
+		 */
+		bool WaitDispatch(void);
+
 		//! Make a GCReader for the specified BodySID
 		/*! \return true on success, false on error (such as there is already a GCReader for this BodySID)
 		 */
@@ -2871,6 +3385,10 @@ namespace mxflib
 		 *  \return False if seeking could not be initialized (perhaps because the file is not seekable)
 		 */
 		bool InitSeek(void);
+
+		//! Get the GCReader to read the specified BodySID on this thread, which is its dispatcher's framer when dispatching in parallel
+		/*! \return NULL if there is no GCReader for this BodySID */
+		GCReaderPtr GetReadingReader(UInt32 BodySID);
 	};
 
 	//! Smart pointer to a BodyReader
@@ -3026,6 +3544,12 @@ namespace mxflib
 		/*! \note Only the master stream is (currently) edit aligned, not all sub-streams */
 		bool EditAlign;
 
+		//! Flag set if index entries are to be freed once written in a sprinkled index table
+		bool BoundedIndex;
+
+		//! Sparse index entries for the footer, moved here from SparseList as their full entries are freed
+		IndexTablePtr SparseSummary;
+
 
 		//! Prevent NULL construction
 		BodyStream();
@@ -3060,6 +3584,7 @@ namespace mxflib
 			KAG = 0;
 			ForceBER4 = false;
 			EditAlign = false;
+			BoundedIndex = false;
 
 			// Set the non-standard key if requested
 			if(Key) EssSource->SetKey(Key, NonGC);
@@ -3080,6 +3605,10 @@ namespace mxflib
 		//! Add a new sub-stream
 		void AddSubStream(EssenceSourcePtr &SubSource, DataChunkPtr Key = NULL, bool NonGC = false);
 
+		//! Replace one of the sources of this stream, such as with a wrapper for it
+		/*! \note The new source must already be set with the stream ID of the one it replaces */
+		void ReplaceSource(EssenceSourcePtr &OldSource, EssenceSourcePtr &NewSource);
+
 		//! Get this stream's BodySID
 		UInt32 GetBodySID(void) { return BodySID; }
 
@@ -3183,6 +3712,24 @@ namespace mxflib
 		//! Get the first edit unit for the next sprinkled index segment
 		Position GetNextSprinkled(void) { return NextSprinkled; }
 
+		//! Set bounded index memory mode
+		/*! When set, the index entries for each sprinkled index table are freed from the index manager once the table has
+		 *  been written, so memory use does not grow with the length of the stream. Entries required for a sparse footer
+		 *  index are first copied to a compact summary table, one per partition.
+		 *  \note This only frees memory if sprinkled index tables are being written, and a full footer index can no longer
+		 *        be built so the sparse summary is written in its place
+		 */
+		void SetBoundedIndex(bool Bounded = true) { BoundedIndex = Bounded; }
+
+		//! Determine if bounded index memory mode is in use
+		bool GetBoundedIndex(void) { return BoundedIndex; }
+
+		//! Get the sparse index summary built in bounded index memory mode (may be NULL)
+		IndexTablePtr &GetSparseSummary(void) { return SparseSummary; }
+
+		//! Free the index entries covered by sprinkled index tables already written, if in bounded index memory mode
+		void FreeIndexEntries(void);
+
 		//! Set the KLV Alignment Grid
 		// FIXME: This will break CBR indexing if changed during writing!
 		void SetKAG(UInt32 NewKAG) { KAG = NewKAG; }
@@ -3272,6 +3819,49 @@ namespace mxflib
 	typedef SmartPtr<BodyWriterHandler> BodyWriterHandlerPtr;
 
 
+	//! The state of a BodyWriter at the start of a body partition, enough to resume writing the file or to finish it
+	/*! A checkpoint is taken just after each body partition pack (and any metadata and index table segments) is written,
+	 *  at which point everything before it in the file is complete, and is saved to a small text file.
+	 */
+	struct BodyWriterCheckpoint
+	{
+		//! The state of one stream at the checkpoint
+		struct StreamState
+		{
+			UInt32 BodySID;						//!< The BodySID of the stream
+			UInt32 IndexSID;					//!< The IndexSID of the stream
+			UInt64 StreamOffset;				//!< The stream offset of the next content package
+			Position EditUnit;					//!< The edit unit of the next content package, where the stream's source must restart
+			Position NextSprinkled;				//!< The first edit unit not yet written in a sprinkled index table segment
+		};
+
+		//! The position and BodySID of a partition written before the checkpoint
+		typedef std::pair<Position, UInt32> PartitionEntry;
+
+		Position PartitionPos;					//!< The position of the partition pack written at the checkpoint
+		UInt32 PartitionBodySID;				//!< The BodySID of the essence in that partition
+		Position ResumePos;						//!< The position following the partition pack, metadata and index of that partition
+		std::vector<PartitionEntry> Partitions;	//!< Every partition written up to and including the checkpoint
+		std::vector<StreamState> Streams;		//!< The state of every stream
+
+		BodyWriterCheckpoint() : PartitionPos(-1), PartitionBodySID(0), ResumePos(-1) {}
+
+		//! Determine if this holds a checkpoint
+		bool IsValid(void) const { return ResumePos >= 0; }
+
+		//! Get the edit unit at which the source of a given stream must restart when resuming
+		/*! \return -1 if the stream is not in the checkpoint */
+		Position GetEditUnit(UInt32 BodySID) const;
+
+		//! Save the checkpoint to a file, replacing any previous checkpoint so that a crash part-way through leaves one or the other
+		bool Write(const std::string &FileName) const;
+
+		//! Load a checkpoint from a file
+		/*! \return false if the file could not be read or is not a checkpoint */
+		bool Read(const std::string &FileName);
+	};
+
+
 	//! Body writer class - manages multiplexing of essence
 	class BodyWriter : public RefCount<BodyWriter>
 	{
@@ -3302,10 +3892,11 @@ namespace mxflib
 			bool Active;											//!< True if active - set false once finished
 			BodyStreamPtr Stream;									//!< The stream in question
 			Length StopAfter;										//!< Number of edit units to output (or zero for no limit). Decremented each time data is written (unless zero).
+			Length Written;											//!< Number of edit units written so far, used when scheduling streams by time
 
 		public:
 			//! Construct an "empty" StreamInfo
-			StreamInfo() { Active = false; }
+			StreamInfo() { Active = false; Written = 0; }
 
 			//! Copy constructor
 			StreamInfo(const StreamInfo &rhs)
@@ -3313,6 +3904,7 @@ namespace mxflib
 				Active = rhs.Active;
 				Stream = rhs.Stream;
 				StopAfter = rhs.StopAfter;
+				Written = rhs.Written;
 			}
 		};
 
@@ -3344,6 +3936,9 @@ namespace mxflib
 		UInt32 MinPartitionSize;								//!< The minimum size of the non-essence part of the next partition
 		UInt32 MinPartitionFiller;								//!< The minimum size of filler before the essence part of the next partition
 
+		UInt32 HeaderReservePercent;							//!< Filler to leave after the header metadata, as a percentage of its size
+		UInt32 HeaderReserveBytes;								//!< The minimum filler to leave after the header metadata if HeaderReservePercent is set
+
 		bool IndexSharesWithMetadata;							//!< If true index tables may exist in the same partition as metadata
 		bool EssenceSharesWithMetadata;							//!< If true essence may exist in the same partition as metadata
 
@@ -3384,6 +3979,48 @@ namespace mxflib
 		 */
 		UInt32 PartitionBodySID;
 
+		//! Number of wrapping units to read ahead for each prefetched source, or 0 for no prefetch
+		unsigned int PrefetchDepth;
+
+		//! Set once StartPrefetch() has been called
+		bool PrefetchStarted;
+
+		//! True if body streams are scheduled by how far each has been written, rather than in turn
+		bool ScheduleByTime;
+
+		//! Number of edit units to write in each scheduled body partition, or 0 for no limit
+		Length ScheduleDuration;
+
+		//! Number of bytes to write in each scheduled body partition, or 0 for no limit
+		Length ScheduleSize;
+
+		//! Number of seconds that a scheduled stream may run ahead of the stream furthest behind, or 0 for no limit
+		double ScheduleSkew;
+
+		//! True if each content package is written to the file as soon as it is wrapped
+		bool LiveMode;
+
+		//! Number of edit units in each body partition in live mode, or 0 for no limit
+		Length LivePartitionDuration;
+
+		//! Number of body partitions between copies of the header metadata in live mode, or 0 for none
+		unsigned int LiveMetadataInterval;
+
+		//! Number of microseconds that each content package should take to reach the file in live mode, or 0 for no target
+		UInt64 LiveLatencyTarget;
+
+		//! Number of body partitions with essence written in live mode
+		unsigned int LivePartitionCount;
+
+		//! Time that the content package currently being wrapped was read, or 0 if not timed
+		UInt64 LivePackageStart;
+
+		//! The prefetch groups started for our streams, one per BodyStream
+		std::list<PrefetchGroupPtr> PrefetchGroups;
+
+		//! The name of the file to save a checkpoint to at the start of each body partition, or empty if not checkpointing
+		std::string CheckpointFile;
+
 		//! Prevent NULL construction
 		BodyWriter();
 
@@ -3410,13 +4047,34 @@ namespace mxflib
 			MinPartitionSize = 0;
 			MinPartitionFiller = 0;
 
+			HeaderReservePercent = 0;
+			HeaderReserveBytes = 0;
+
 			PartitionWritePending = false;
 			PendingHeader = 0;
 			PendingFooter = 0;
 			PendingMetadata = false;
 			PartitionBodySID = 0;
+
+			PrefetchDepth = 0;
+			PrefetchStarted = false;
+
+			ScheduleByTime = false;
+			ScheduleDuration = 0;
+			ScheduleSize = 0;
+			ScheduleSkew = 0.0;
+
+			LiveMode = false;
+			LivePartitionDuration = 0;
+			LiveMetadataInterval = 0;
+			LiveLatencyTarget = 0;
+			LivePartitionCount = 0;
+			LivePackageStart = 0;
 		}
 
+		//! Stop any prefetch threads
+		~BodyWriter() { StopPrefetch(); }
+
 		//! Clear any stream details ready to call AddStream()
 		/*! This allows previously used streams to be removed before a call to WriteBody() or WriteNext()
 		 */
@@ -3447,6 +4105,70 @@ namespace mxflib
 		//! Get flag stating whether BER lengths should be forced to 4-byte (where possible)
 		bool GetForceBER4(void) { return ForceBER4; }
 
+		//! Enable or disable asynchronous writing of the destination file
+		/*! When enabled, each content package is written by a background thread while the next is being prepared.
+		 *  \param BufferSize The size of each output buffer, or 0 to write synchronously
+		 *  \param BufferCount The number of output buffers to use (minimum 2)
+		 *  \return true if asynchronous writing is now enabled
+		 *  \note See MXFFile::SetAsyncWrite() for details
+		 */
+		bool SetAsyncWrite(size_t BufferSize, unsigned int BufferCount = 2) { return File->SetAsyncWrite(BufferSize, BufferCount); }
+
+		//! Enable or disable direct (unbuffered) writing of the destination file
+		/*! This stops writing a large file filling the OS cache, including when the header is rewritten by WriteFooter().
+		 *  \param BufferSize The size of the aligned staging buffer, or 0 to write normally
+		 *  \param Align The block size required by the storage for unbuffered writes
+		 *  \return true if direct writing is now enabled
+		 *  \note See MXFFile::SetDirectWrite() for details, including the use of the KAG to keep partitions aligned
+		 */
+		bool SetDirectWrite(size_t BufferSize, UInt32 Align = 4096) { return File->SetDirectWrite(BufferSize, Align); }
+
+		//! Enable or disable reading essence ahead of the writer on a background thread
+		/*! When enabled, the sources of each suitable stream are read by a worker thread (one per stream) into a queue
+		 *  holding up to Depth wrapping units per source. The data is written, and indexed, exactly as it would be without prefetch.
+		 *  \param Depth The number of wrapping units to queue for each source, or 0 to read synchronously
+		 *  \note This must be set before the first body partition is written, and only frame wrapped streams without pre-charge or system items are prefetched
+		 */
+		void SetPrefetch(unsigned int Depth) { PrefetchDepth = Depth; }
+
+		//! Enable or disable scheduling of body streams by how far each has been written, rather than in turn
+		/*! When enabled, each body partition is given to the active stream that is furthest behind in time, which then keeps
+		 *  the partition until it has written Duration edit units or Size bytes, or is MaxSkew seconds ahead of the stream
+		 *  furthest behind. With many streams this gives fewer, larger partitions than writing each stream in turn.
+		 *  \param Enable True to schedule by time, false to write each stream in turn
+		 *  \param Duration The number of edit units to write in each body partition, or 0 for no limit
+		 *  \param Size The number of bytes to write in each body partition, or 0 for no limit
+		 *  \param MaxSkew The number of seconds that a stream may run ahead of the stream furthest behind, or 0 for no limit
+		 *  \note Limits given to WritePartition() or WriteBody() still apply, the smaller of each limit being used
+		 */
+		void SetStreamScheduling(bool Enable, Length Duration = 0, Length Size = 0, double MaxSkew = 0.0)
+		{
+			ScheduleByTime = Enable;
+			ScheduleDuration = Duration;
+			ScheduleSize = Size;
+			ScheduleSkew = MaxSkew;
+		}
+
+		//! Enable or disable live wrapping, where each content package is written to the file as soon as it is wrapped
+		/*! In live mode essence is read one wrapping unit at a time and the file is flushed after each content package,
+		 *  body partitions are kept to PartitionDuration edit units so that each sprinkled index table segment is small,
+		 *  and the header metadata is repeated in an open body partition every MetadataInterval body partitions so that a
+		 *  reader of the growing file sees it as it is updated.
+		 *  The time taken by each content package, from being read to reaching the file, is gathered by the StatsLivePackageWrites
+		 *  timer, with those taking longer than LatencyTarget microseconds counted by StatsLivePackagesLate.
+		 *  \param Enable True to write live, false to buffer normally
+		 *  \param PartitionDuration The number of edit units in each body partition, or 0 for no limit
+		 *  \param MetadataInterval The number of body partitions between copies of the header metadata, or 0 for none
+		 *  \param LatencyTarget The number of microseconds that each content package should take to reach the file, or 0 for no target
+		 */
+		void SetLiveMode(bool Enable, Length PartitionDuration = 1, unsigned int MetadataInterval = 0, UInt64 LatencyTarget = 0)
+		{
+			LiveMode = Enable;
+			LivePartitionDuration = PartitionDuration;
+			LiveMetadataInterval = MetadataInterval;
+			LiveLatencyTarget = LatencyTarget;
+		}
+
 		//! Set what sort of data may share with header metadata
 		void SetMetadataSharing(bool IndexMayShare = true, bool EssenceMayShare = false)
 		{
@@ -3469,6 +4191,9 @@ namespace mxflib
 		/*! No essence will be written, but CBR index tables will be written if required.
 		 *  The partition will not be "ended" if only the header partition is written
 		 *  meaning that essence will be added by the next call to WritePartition()
+		 *  \note When writing to a stream (see MXFFile::OpenStreamFromHandle()) nothing is ever re-written, so the header
+		 *        should be open and incomplete, and index tables should be written in the body partitions (such as
+		 *        sprinkled index tables) or the footer. FastClipWrap is not used, so clip wrapped essence is held in memory
 		 */
 		void WriteHeader(bool IsClosed, bool IsComplete);
 
@@ -3530,15 +4255,87 @@ namespace mxflib
 		 */
 		void SetPartitionFiller(UInt32 PartitionFiller) { MinPartitionFiller = PartitionFiller; }
 
+		//! Reserve space in the header for its metadata to grow, sized from the metadata itself
+		/*! When the header is written its metadata is serialized to measure it, and filler of at least Percent percent of
+		 *  this size (and at least MinBytes) is left after it. This allows the header to be rewritten with updated metadata
+		 *  without relying on a fixed guess at the space required. If more filler is requested by SetPartitionFiller() for
+		 *  the header that amount is used instead.
+		 *  \param Percent Growth to allow, as a percentage of the size of the header metadata, or zero to disable
+		 *  \param MinBytes The smallest amount of filler to leave
+		 */
+		void SetHeaderReserve(UInt32 Percent, UInt32 MinBytes = 0) { HeaderReservePercent = Percent; HeaderReserveBytes = MinBytes; }
+
+		//! Reserve disk space for the file, estimated from the expected duration of the essence
+		/*! \param Duration The expected number of edit units to be written for each stream
+		 *  \param BytesPerEditUnit The expected size of one edit unit of all streams together, or zero to use the sizes given by each source
+		 *  \return true if space was reserved, false if the size could not be estimated (such as for VBR sources) or the file can't be preallocated
+		 *  \note This should be called after all streams have been added, and the estimate includes a small margin for partition packs
+		 *        and index tables. Any space not used is released when the file is closed. See MXFFile::Preallocate() for details
+		 */
+		bool Preallocate(Length Duration, Length BytesPerEditUnit = 0);
+
 		//! Initialize all required index managers
 		void InitIndexManagers(void);
 
+		//! Save a checkpoint to a file at the start of each body partition
+		/*! After a crash the file can be finished with Finish(), or writing can be continued with Resume(), without
+		 *  scanning the body. Each checkpoint is taken after the body partition pack and any index table segments are
+		 *  written, and the file is flushed before the checkpoint is saved.
+		 *  \param FileName The file to save each checkpoint to, or empty to stop checkpointing
+		 *  \note For the file to be indexed up to the last checkpoint, use sprinkled or CBR index tables rather than a footer index
+		 */
+		void SetCheckpoint(std::string FileName) { CheckpointFile = FileName; }
+
+		//! Continue writing a file from a checkpoint
+		/*! The file must be open for writing, and all streams must have been added, with their sources positioned to
+		 *  start at the edit unit given by BodyWriterCheckpoint::GetEditUnit(). Anything written after the checkpoint is
+		 *  discarded, and writing continues in the partition of the checkpoint with the next call to WriteBody() or
+		 *  WritePartition(). If no template partition has been set the header partition pack of the file is used.
+		 *  \note A full or sparse footer index only covers the edit units written after resuming
+		 *  \return false if the checkpoint does not match the streams or the file
+		 */
+		bool Resume(const BodyWriterCheckpoint &Checkpoint);
+
+		//! Finish a file from a checkpoint by writing a footer and RIP, without scanning the body
+		/*! The file must be open for writing. Anything written after the checkpoint is discarded, leaving the partition
+		 *  of the checkpoint with no essence, and an incomplete footer without metadata and a RIP are written.
+		 *  If no template partition has been set the header partition pack of the file is used.
+		 *  \return false if the footer could not be written
+		 */
+		bool Finish(const BodyWriterCheckpoint &Checkpoint);
+
 	protected:
+		//! Save a checkpoint for the partition just written at a given position
+		void WriteCheckpoint(Position PartitionPos);
+
+		//! Restore the RIP and file position of a checkpoint, reading the header partition pack as the template if none set
+		bool RestoreCheckpoint(const BodyWriterCheckpoint &Checkpoint);
+
+		//! Measure the size of the serialized header metadata, including its primer
+		Length GetHeaderMetadataSize(void);
+
+		//! Replace the sources of each suitable stream with prefetching sources
+		void StartPrefetch(void);
+
+		//! Stop all prefetch threads, any remaining data will be read synchronously
+		void StopPrefetch(void);
+
 		//! Move to the next active stream (will also advance State as required)
 		/*! \note Will set CurrentBodySID to 0 if no more active streams
 		 */
 		void SetNextStream(void);
 
+		//! Move to the active body stream furthest behind in time
+		/*! \return false if there are no active body streams
+		 */
+		bool SetScheduledStream(void);
+
+		//! Get the number of seconds of essence written so far for a stream
+		double GetStreamTime(StreamInfoPtr &Info);
+
+		//! Reduce the limits for the next write of the current stream to those of the schedule
+		void GetScheduledLimits(Length &Duration, Length &MaxPartitionSize);
+
 		//! Write a complete partition's worth of essence
 		/*! Will stop if:
 		 *    Frame or "other" wrapping and the "StopAfter" reaches zero or "Duration" reaches zero
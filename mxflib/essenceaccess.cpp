@@ -0,0 +1,469 @@
+/*! \file	essenceaccess.cpp
+ *	\brief	Implementation of a class that reads single frames of essence from an MXF file by edit unit
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Parse the key and length of a complete KLV in a buffer
+	/*! \return The size of the key and length, or 0 if the KLV is not complete within the buffer */
+	size_t ParseKL(const UInt8 *Ptr, const UInt8 *End, Length &ValueLength)
+	{
+		if((End - Ptr) < 17) return 0;
+
+		const UInt8 *LenPtr = Ptr + 16;
+		UInt64 Len = *LenPtr++;
+		if(Len >= 0x80)
+		{
+			int LenSize = static_cast<int>(Len & 0x7f);
+			if((LenSize > 8) || ((End - LenPtr) < LenSize)) return 0;
+
+			Len = 0;
+			while(LenSize--) Len = (Len << 8) + *(LenPtr++);
+		}
+
+		if(static_cast<UInt64>(End - LenPtr) < Len) return 0;
+
+		ValueLength = static_cast<Length>(Len);
+		return static_cast<size_t>(LenPtr - Ptr);
+	}
+
+	//! Determine if a key is a KLV filler key
+	bool IsFillerKey(const UInt8 *Key)
+	{
+		// DRAGONS: The version byte of the filler key varies, so is not compared
+		return (memcmp(Key, KLVFill_UL_Data, 7) == 0) && (memcmp(&Key[8], &KLVFill_UL_Data[8], 8) == 0);
+	}
+
+	//! Determine if a key is a Generic Container item key, in which case the last four bytes are the track number
+	bool IsGCKey(const UInt8 *Key)
+	{
+		static const UInt8 Prefix[4] = { 0x06, 0x0e, 0x2b, 0x34 };
+		static const UInt8 GCItem[4] = { 0x0d, 0x01, 0x03, 0x01 };
+		return (memcmp(Key, Prefix, 4) == 0) && (memcmp(&Key[8], GCItem, 4) == 0);
+	}
+}
+
+
+//! Read the header metadata, index tables and partitions of a file, ready for frames to be read
+/*! \return false if the file has no internal essence containers that could be mapped
+ *  \note The file pointer is left at an undefined position
+ */
+bool EssenceAccessor::Open(MXFFilePtr &File)
+{
+	this->File = File;
+	Tracks.clear();
+	Containers.clear();
+
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	PartitionPtr MasterPartition = File->ReadMasterPartition();
+	if(!MasterPartition)
+	{
+		File->Seek(0);
+		MasterPartition = File->ReadPartition();
+	}
+
+	if(!MasterPartition)
+	{
+		error("Could not read the header of \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	if(MasterPartition->AllMetadata.empty()) MasterPartition->ReadMetadata();
+	MetadataPtr HMeta = MasterPartition->ParseMetadata();
+	if(!HMeta)
+	{
+		error("Could not read the header metadata of \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	MDObjectPtr ContentStorage = HMeta->GetRef(ContentStorageObject_UL);
+	MDObjectPtr EssenceDataObjects = ContentStorage ? ContentStorage->Child(EssenceDataObjects_UL) : NULL;
+	if(EssenceDataObjects)
+	{
+		MDObject::iterator it = EssenceDataObjects->begin();
+		while(it != EssenceDataObjects->end())
+		{
+			MDObjectPtr ECData = (*it).second->GetRef();
+			UInt32 BodySID = ECData ? ECData->GetUInt(BodySID_UL) : 0;
+			it++;
+
+			// DRAGONS: Containers with a BodySID of zero are external essence, so have nothing to read
+			if(!BodySID) continue;
+
+			TimelineMapPtr Map = new TimelineMap;
+			if(!Map->Build(File, BodySID)) continue;
+
+			if(!Map->GetIndex())
+			{
+				warning("Essence container with BodySID 0x%04x in \"%s\" is not indexed, so its frames cannot be located\n", BodySID, File->Name.c_str());
+				continue;
+			}
+
+			ContainerInfo &Container = Containers[BodySID];
+			Container.Map = Map;
+			Container.ClipWrapped = (Map->GetStreamBase() != 0);
+			Container.ElementCount = 0;
+
+			ReadTracks(HMeta, ECData, BodySID);
+			ReadElementOrder(Container);
+		}
+	}
+
+	if(Containers.empty())
+	{
+		error("No indexed internal essence containers found in \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Read the essence tracks of the File Package linked to an essence container
+void EssenceAccessor::ReadTracks(MetadataPtr &HMeta, MDObjectPtr &ECData, UInt32 BodySID)
+{
+	MDObjectPtr LinkedUID = ECData->Child(LinkedPackageUID_UL);
+	DataChunkPtr FileUID = LinkedUID ? LinkedUID->PutData() : NULL;
+	if((!FileUID) || (FileUID->Size != 32)) return;
+
+	PackageList::iterator Package_it = HMeta->Packages.begin();
+	while(Package_it != HMeta->Packages.end())
+	{
+		MDObjectPtr PackageUID = (*Package_it)->Child(PackageUID_UL);
+		DataChunkPtr UID = PackageUID ? PackageUID->PutData() : NULL;
+		if(UID && (UID->Size == 32) && (memcmp(UID->Data, FileUID->Data, 32) == 0))
+		{
+			TrackList::iterator Track_it = (*Package_it)->Tracks.begin();
+			while(Track_it != (*Package_it)->Tracks.end())
+			{
+				if((*Track_it)->IsEssenceTrack())
+				{
+					TrackInfo &Track = Tracks[(*Track_it)->GetUInt(TrackID_UL)];
+					Track.BodySID = BodySID;
+					Track.TrackNumber = (*Track_it)->GetUInt(TrackNumber_UL);
+				}
+
+				Track_it++;
+			}
+
+			return;
+		}
+
+		Package_it++;
+	}
+}
+
+
+//! Find the order of the elements in the content packages of an essence container, from the first content package
+void EssenceAccessor::ReadElementOrder(ContainerInfo &Container)
+{
+	// A clip-wrapped container holds a single element, read as a whole
+	if(Container.ClipWrapped)
+	{
+		Container.ElementCount = 1;
+		return;
+	}
+
+	Position FileOffset;
+	Length Size;
+	if((!Container.Map->GetByteRange(0, 1, FileOffset, Size)) || (Size <= 0)) return;
+
+	DataChunkPtr Data = File->ReadAt(FileOffset, static_cast<size_t>(Size));
+	if(!Data) return;
+
+	const UInt8 *Ptr = Data->Data;
+	const UInt8 *End = Data->Data + Data->Size;
+	for(;;)
+	{
+		Length ValueLength;
+		size_t KLSize = ParseKL(Ptr, End, ValueLength);
+		if(!KLSize) break;
+
+		// DRAGONS: Filler is not counted in the delta entry array of an index table, but every other element is
+		if(!IsFillerKey(Ptr))
+		{
+			if(IsGCKey(Ptr)) Container.Elements[GetU32(&Ptr[12])] = Container.ElementCount;
+			Container.ElementCount++;
+		}
+
+		Ptr += KLSize + static_cast<size_t>(ValueLength);
+	}
+}
+
+
+//! Get the track IDs of all essence tracks that frames may be read from
+std::vector<UInt32> EssenceAccessor::GetTrackIDs(void) const
+{
+	std::vector<UInt32> Ret;
+
+	std::map<UInt32, TrackInfo>::const_iterator it = Tracks.begin();
+	while(it != Tracks.end())
+	{
+		if(Containers.find((*it).second.BodySID) != Containers.end()) Ret.push_back((*it).first);
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Get the number of edit units of the essence container holding a track, or -1 if not known
+Length EssenceAccessor::GetDuration(UInt32 TrackID) const
+{
+	std::map<UInt32, TrackInfo>::const_iterator Track_it = Tracks.find(TrackID);
+	if(Track_it == Tracks.end()) return -1;
+
+	std::map<UInt32, ContainerInfo>::const_iterator it = Containers.find((*Track_it).second.BodySID);
+	if(it == Containers.end()) return -1;
+
+	return (*it).second.Map->GetDuration();
+}
+
+
+//! Get the number of edit units of an essence container, or -1 if not known
+/*! \param BodySID The essence container, or 0 for the first */
+Length EssenceAccessor::GetContainerDuration(UInt32 BodySID) const
+{
+	std::map<UInt32, ContainerInfo>::const_iterator it = BodySID ? Containers.find(BodySID) : Containers.begin();
+	if(it == Containers.end()) return -1;
+
+	return (*it).second.Map->GetDuration();
+}
+
+
+//! Read the value of the essence element of a track for a given edit unit
+/*! \param TrackID The track ID of the essence track in its File Package
+ *  \param EditUnit The edit unit, in stored order
+ *  \param Buffer The buffer to read into, which is resized to the size of the value
+ *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+ *  \return false if the frame could not be located or read
+ *  \note For clip-wrapped essence the bytes of the edit unit within the clip are returned
+ */
+bool EssenceAccessor::ReadFrame(UInt32 TrackID, Position EditUnit, DataChunk &Buffer, FrameInfo *Info /*=NULL*/)
+{
+	std::map<UInt32, TrackInfo>::const_iterator Track_it = Tracks.find(TrackID);
+	std::map<UInt32, ContainerInfo>::const_iterator it = Containers.end();
+	if(Track_it != Tracks.end()) it = Containers.find((*Track_it).second.BodySID);
+
+	if(it == Containers.end())
+	{
+		error("No indexed essence track with TrackID %u in \"%s\"\n", TrackID, File ? File->Name.c_str() : "");
+		return false;
+	}
+
+	const ContainerInfo &Container = (*it).second;
+	UInt32 TrackNumber = (*Track_it).second.TrackNumber;
+
+	Position Start, End;
+	if(!LookupEditUnit(Container, EditUnit, Start, End, Info)) return false;
+
+	Position FileOffset;
+	if(Container.ClipWrapped)
+	{
+		if(!ReadRange(Container, Start, End, Buffer, FileOffset)) return false;
+
+		if(Info)
+		{
+			Info->FileOffset = FileOffset;
+			Info->Size = static_cast<Length>(Buffer.Size);
+		}
+		return true;
+	}
+
+	// If the index table has delta entries for the elements, read just this element rather than the whole content package
+	std::map<UInt32, int>::const_iterator Element_it = Container.Elements.find(TrackNumber);
+	if(Element_it != Container.Elements.end())
+	{
+		IndexTablePtr Index = Container.Map->GetIndex();
+		IndexPos Result;
+		int Element = (*Element_it).second;
+
+		Position ElementStart = Start;
+		if(Element > 0)
+		{
+			Index->Lookup(EditUnit, Result, Element, false);
+			if(Result.Exact && (!Result.OtherPos)) ElementStart = Result.Location;
+		}
+
+		Position ElementEnd = End;
+		if((ElementStart != Start) || (Element == 0))
+		{
+			if((Element + 1) < Container.ElementCount)
+			{
+				Index->Lookup(EditUnit, Result, Element + 1, false);
+				if(Result.Exact && (!Result.OtherPos)) ElementEnd = Result.Location;
+			}
+		}
+
+		// DRAGONS: Trust the deltas only if they give a range within the edit unit, otherwise the content packages
+		//          may not all have the same layout as the first
+		if((ElementStart >= Start) && (ElementEnd > ElementStart) && (ElementEnd <= End))
+		{
+			Start = ElementStart;
+			End = ElementEnd;
+		}
+	}
+
+	if(!ReadRange(Container, Start, End, Buffer, FileOffset)) return false;
+
+	// Find the element in the bytes read, and move its value to the start of the buffer
+	const UInt8 *Ptr = Buffer.Data;
+	const UInt8 *BufferEnd = Buffer.Data + Buffer.Size;
+	for(;;)
+	{
+		Length ValueLength;
+		size_t KLSize = ParseKL(Ptr, BufferEnd, ValueLength);
+		if(!KLSize) break;
+
+		if(IsGCKey(Ptr) && (GetU32(&Ptr[12]) == TrackNumber))
+		{
+			size_t ValueOffset = static_cast<size_t>(Ptr - Buffer.Data) + KLSize;
+			memmove(Buffer.Data, &Buffer.Data[ValueOffset], static_cast<size_t>(ValueLength));
+			Buffer.Resize(static_cast<size_t>(ValueLength));
+
+			if(Info)
+			{
+				Info->FileOffset = FileOffset + ValueOffset;
+				Info->Size = ValueLength;
+			}
+			return true;
+		}
+
+		Ptr += KLSize + static_cast<size_t>(ValueLength);
+	}
+
+	error("No essence element for TrackID %u found in edit unit %s of \"%s\"\n", TrackID, Int64toString(EditUnit).c_str(), File->Name.c_str());
+	return false;
+}
+
+
+//! Read all the KLVs of the content package of a given edit unit
+/*! \param BodySID The essence container, or 0 for the first
+ *  \param EditUnit The edit unit, in stored order
+ *  \param Buffer The buffer to read into, which is resized to the size of the content package
+ *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+ *  \return false if the content package could not be located or read
+ *  \note For clip-wrapped essence the bytes of the edit unit within the clip are returned
+ */
+bool EssenceAccessor::ReadContentPackage(UInt32 BodySID, Position EditUnit, DataChunk &Buffer, FrameInfo *Info /*=NULL*/)
+{
+	std::map<UInt32, ContainerInfo>::const_iterator it = BodySID ? Containers.find(BodySID) : Containers.begin();
+	if(it == Containers.end())
+	{
+		error("No indexed essence container with BodySID 0x%04x in \"%s\"\n", BodySID, File ? File->Name.c_str() : "");
+		return false;
+	}
+
+	Position Start, End;
+	if(!LookupEditUnit((*it).second, EditUnit, Start, End, Info)) return false;
+
+	Position FileOffset;
+	if(!ReadRange((*it).second, Start, End, Buffer, FileOffset)) return false;
+
+	if(Info)
+	{
+		Info->FileOffset = FileOffset;
+		Info->Size = static_cast<Length>(Buffer.Size);
+	}
+
+	return true;
+}
+
+
+//! Look up an edit unit in the index table of an essence container
+/*! \param Start Set to the stream offset of the start of the edit unit
+ *  \param End Set to the stream offset of the end of the edit unit
+ *  \return false if the edit unit is not indexed
+ */
+bool EssenceAccessor::LookupEditUnit(const ContainerInfo &Container, Position EditUnit, Position &Start, Position &End, FrameInfo *Info)
+{
+	Length Duration = Container.Map->GetDuration();
+	if((EditUnit < 0) || ((Duration >= 0) && (EditUnit >= Duration)))
+	{
+		error("Edit unit %s is outside the essence of \"%s\"\n", Int64toString(EditUnit).c_str(), File->Name.c_str());
+		return false;
+	}
+
+	IndexPos Result;
+	Container.Map->GetIndex()->Lookup(EditUnit, Result, 0, false);
+
+	Start = Result.Location + Container.Map->GetStreamBase();
+	End = Container.Map->EditUnitToStreamOffset(EditUnit + 1);
+
+	if((!Result.Exact) || Result.OtherPos || (End <= Start))
+	{
+		error("Edit unit %s is not indexed in \"%s\"\n", Int64toString(EditUnit).c_str(), File->Name.c_str());
+		return false;
+	}
+
+	if(Info)
+	{
+		Info->EditUnit = EditUnit;
+		Info->EditRate = Container.Map->GetEditRate();
+		Info->TemporalOffset = Result.TemporalOffset;
+		Info->KeyFrameOffset = Result.KeyFrameOffset;
+		Info->Flags = Result.Flags;
+	}
+
+	return true;
+}
+
+
+//! Read a range of stream offsets into a buffer with a single read
+/*! \return false if the range is not in one partition, or could not be read in full */
+bool EssenceAccessor::ReadRange(const ContainerInfo &Container, Position Start, Position End, DataChunk &Buffer, Position &FileOffset)
+{
+	FileOffset = Container.Map->StreamOffsetToFileOffset(Start);
+
+	// DRAGONS: The end offset is found from the last byte, as the end of a partition is also the start of the next
+	Length Size = End - Start;
+	if((FileOffset < 0) || (Container.Map->StreamOffsetToFileOffset(End - 1) != (FileOffset + Size - 1)))
+	{
+		error("Edit unit at stream offset 0x%s is not within a single partition of \"%s\"\n", Int64toHexString(Start, 8).c_str(), File->Name.c_str());
+		return false;
+	}
+
+	Buffer.Resize(static_cast<size_t>(Size), false);
+
+	size_t Bytes = File->ReadAt(FileOffset, Buffer.Data, Buffer.Size);
+	if(Bytes != Buffer.Size)
+	{
+		error("Only 0x%s of 0x%s bytes could be read at 0x%s in \"%s\"\n", Int64toHexString(Bytes, 8).c_str(), Int64toHexString(Size, 8).c_str(),
+			  Int64toHexString(FileOffset, 8).c_str(), File->Name.c_str());
+		Buffer.Resize(Bytes);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,153 @@
+/*! \file	essenceaccess.h
+ *	\brief	Definition of a class that reads single frames of essence from an MXF file by edit unit
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Serving individual frames out of an MXF file, such as for a frame server, needs each request to go straight to
+ *  the bytes of the frame. An EssenceAccessor reads the header metadata, index tables and partitions once when the
+ *  file is opened, after which each frame is located from the index table and read with a single positional read
+ *  into a buffer supplied by the caller.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__ESSENCEACCESS_H
+#define MXFLIB__ESSENCEACCESS_H
+
+namespace mxflib
+{
+	//! Reads single frames of essence, by track and edit unit, from the internal essence containers of an MXF file
+	/*! Once Open() has completed nothing is changed by reading, so ReadFrame() and ReadContentPackage() may be called
+	 *  on any number of threads at once. Each read resolves the edit unit through the index table and then makes a
+	 *  single positional read of the file, so the file pointer is not used and reads may also be mixed with other use
+	 *  of the MXFFile. No memory is allocated once the caller's buffer is big enough for the largest frame read.
+	 *  \note Edit units are counted in stored order, as that is the order of the bytes in the file
+	 */
+	class EssenceAccessor : public RefCount<EssenceAccessor>
+	{
+	public:
+		//! Details of a frame that has been read
+		struct FrameInfo
+		{
+			Position EditUnit;					//!< The edit unit read, in stored order
+			Position FileOffset;				//!< The file offset of the first byte returned
+			Length Size;						//!< The number of bytes returned
+			Rational EditRate;					//!< The edit rate of the essence container
+			Int8 TemporalOffset;				//!< The offset in edit units from stored order to display order
+			Int8 KeyFrameOffset;				//!< The offset in edit units to the previous key frame
+			UInt8 Flags;						//!< The index table flags of the edit unit
+
+			//! Determine if this edit unit is a random access point, as flagged in the index table
+			bool IsRandomAccess(void) const { return (Flags & 0x80) != 0; }
+		};
+
+	protected:
+		//! Details of an essence track
+		struct TrackInfo
+		{
+			UInt32 BodySID;						//!< The essence container holding the track
+			UInt32 TrackNumber;					//!< The track number, which matches the last four bytes of the element keys
+		};
+
+		//! Details of an essence container
+		struct ContainerInfo
+		{
+			TimelineMapPtr Map;					//!< The map of edit units to file offsets
+			bool ClipWrapped;					//!< True if the essence is clip-wrapped, so edit units are within the value of a single KLV
+			int ElementCount;					//!< The number of elements in each content package, not counting filler
+			std::map<UInt32, int> Elements;		//!< The index of each element in the content package, by track number
+		};
+
+		MXFFilePtr File;						//!< The file being read
+		std::map<UInt32, TrackInfo> Tracks;		//!< The essence tracks of the File Packages, by track ID
+		std::map<UInt32, ContainerInfo> Containers;	//!< The internal essence containers, by BodySID
+
+	public:
+		//! Build an accessor with no file open
+		EssenceAccessor() {}
+
+		//! Read the header metadata, index tables and partitions of a file, ready for frames to be read
+		/*! \return false if the file has no internal essence containers that could be mapped
+		 *  \note The file pointer is left at an undefined position
+		 */
+		bool Open(MXFFilePtr &File);
+
+		//! Get the track IDs of all essence tracks that frames may be read from
+		std::vector<UInt32> GetTrackIDs(void) const;
+
+		//! Get the number of edit units of the essence container holding a track, or -1 if not known
+		Length GetDuration(UInt32 TrackID) const;
+
+		//! Get the number of edit units of an essence container, or -1 if not known
+		/*! \param BodySID The essence container, or 0 for the first */
+		Length GetContainerDuration(UInt32 BodySID) const;
+
+		//! Read the value of the essence element of a track for a given edit unit
+		/*! \param TrackID The track ID of the essence track in its File Package
+		 *  \param EditUnit The edit unit, in stored order
+		 *  \param Buffer The buffer to read into, which is resized to the size of the value
+		 *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+		 *  \return false if the frame could not be located or read
+		 *  \note For clip-wrapped essence the bytes of the edit unit within the clip are returned
+		 */
+		bool ReadFrame(UInt32 TrackID, Position EditUnit, DataChunk &Buffer, FrameInfo *Info = NULL);
+
+		//! Read all the KLVs of the content package of a given edit unit
+		/*! \param BodySID The essence container, or 0 for the first
+		 *  \param EditUnit The edit unit, in stored order
+		 *  \param Buffer The buffer to read into, which is resized to the size of the content package
+		 *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+		 *  \return false if the content package could not be located or read
+		 *  \note For clip-wrapped essence the bytes of the edit unit within the clip are returned
+		 */
+		bool ReadContentPackage(UInt32 BodySID, Position EditUnit, DataChunk &Buffer, FrameInfo *Info = NULL);
+
+	protected:
+		//! Read the essence tracks of the File Package linked to an essence container
+		void ReadTracks(MetadataPtr &HMeta, MDObjectPtr &ECData, UInt32 BodySID);
+
+		//! Find the order of the elements in the content packages of an essence container, from the first content package
+		void ReadElementOrder(ContainerInfo &Container);
+
+		//! Look up an edit unit in the index table of an essence container
+		/*! \param Start Set to the stream offset of the start of the edit unit
+		 *  \param End Set to the stream offset of the end of the edit unit
+		 *  \return false if the edit unit is not indexed
+		 */
+		bool LookupEditUnit(const ContainerInfo &Container, Position EditUnit, Position &Start, Position &End, FrameInfo *Info);
+
+		//! Read a range of stream offsets into a buffer with a single read
+		/*! \return false if the range is not in one partition, or could not be read in full */
+		bool ReadRange(const ContainerInfo &Container, Position Start, Position End, DataChunk &Buffer, Position &FileOffset);
+
+	private:
+		//! Prevent copy construction
+		EssenceAccessor(const EssenceAccessor &);
+	};
+
+	//! A smart pointer to an EssenceAccessor object
+	typedef SmartPtr<EssenceAccessor> EssenceAccessorPtr;
+}
+
+#endif // MXFLIB__ESSENCEACCESS_H
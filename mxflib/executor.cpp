@@ -0,0 +1,453 @@
+/*! \file	executor.cpp
+ *	\brief	Implementation of a shared pool of worker threads that run tasks for the parallel features of the library
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The executor whose worker is running on this thread, or NULL if not a worker
+	MXFLIB_THREAD_LOCAL TaskExecutor *CurrentExecutor = NULL;
+
+	//! The index of the worker running on this thread
+	MXFLIB_THREAD_LOCAL int CurrentWorker = -1;
+
+	//! Pin the calling thread to a given CPU, if the platform allows
+	void PinToCPU(int CPU)
+	{
+		if(CPU < 0) return;
+
+#if defined(_WIN32)
+		if(CPU < static_cast<int>(sizeof(DWORD_PTR) * 8)) SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << CPU);
+#elif defined(__linux__)
+		cpu_set_t Set;
+		CPU_ZERO(&Set);
+		CPU_SET(CPU, &Set);
+		if(pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set) != 0) warning("Unable to pin a worker thread to CPU %d\n", CPU);
+#endif
+	}
+}
+
+
+namespace mxflib
+{
+	//! A worker thread for a TaskExecutor
+	class TaskExecutorWorker : public Thread
+	{
+	protected:
+		TaskExecutor *Owner;						//!< The executor we work for
+		int Index;									//!< Our index, which is also the index of our queue
+		int CPU;									//!< The CPU to pin ourself to, or -1 for none
+
+	public:
+		TaskExecutorWorker(TaskExecutor *Owner, int Index, int CPU) : Owner(Owner), Index(Index), CPU(CPU) {}
+
+	protected:
+		void Run(void)
+		{
+			PinToCPU(CPU);
+			Owner->WorkerLoop(Index);
+		}
+	};
+}
+
+
+//! Run a task as part of this group
+void TaskGroup::Submit(TaskPtr Item, TaskExecutor *UseExecutor /*=NULL*/)
+{
+	Executor = UseExecutor ? UseExecutor : &GetTaskExecutor();
+	Executor->Submit(Item, this);
+}
+
+
+//! Wait for all tasks of the group to finish, running queued tasks on this thread meanwhile
+void TaskGroup::Wait(void)
+{
+	for(;;)
+	{
+		{
+			MutexLock Locked(Lock);
+			if(Pending == 0) return;
+		}
+
+		// DRAGONS: Helping with any queued task, not just our own, is what stops a worker that waits for nested tasks
+		//          from deadlocking when all the other workers are busy
+		if(Executor && Executor->RunOne()) continue;
+
+		MutexLock Locked(Lock);
+		if(Pending) Changed.Wait(Lock);
+	}
+}
+
+
+//! Record that one of our tasks has finished
+void TaskGroup::TaskDone(void)
+{
+	MutexLock Locked(Lock);
+
+	Pending--;
+	Changed.Broadcast();
+}
+
+
+//! Construct an executor with a given number of workers, or one per CPU if 0
+TaskExecutor::TaskExecutor(unsigned int Workers /*=0*/) : Queued(0), NextQueue(0), Stopping(false)
+{
+	WorkerCount = Workers ? Workers : GetCPUCount();
+}
+
+
+//! Set the number of workers
+void TaskExecutor::SetWorkers(unsigned int Count)
+{
+	Stop();
+
+	MutexLock Locked(Lock);
+	WorkerCount = Count ? Count : GetCPUCount();
+}
+
+
+//! Pin the workers to a set of CPUs, one CPU per worker in turn
+void TaskExecutor::SetAffinity(const std::vector<int> &UseCPUs)
+{
+	MutexLock Locked(Lock);
+	CPUs = UseCPUs;
+}
+
+
+//! Pin the workers to the CPUs of a NUMA node
+bool TaskExecutor::SetNUMANode(int Node)
+{
+#ifdef __linux__
+	char Name[64];
+	snprintf(Name, sizeof(Name), "/sys/devices/system/node/node%d/cpulist", Node);
+
+	FILE *List = fopen(Name, "r");
+	if(!List) return false;
+
+	char Text[1024];
+	bool Ok = (fgets(Text, sizeof(Text), List) != NULL);
+	fclose(List);
+	if(!Ok) return false;
+
+	// The list is of the form "0-3,8-11"
+	std::vector<int> NodeCPUs;
+	char *p = Text;
+	while(*p >= '0' && *p <= '9')
+	{
+		int First = static_cast<int>(strtol(p, &p, 10));
+		int Last = First;
+		if(*p == '-') Last = static_cast<int>(strtol(p + 1, &p, 10));
+
+		int CPU;
+		for(CPU = First; CPU <= Last; CPU++) NodeCPUs.push_back(CPU);
+
+		if(*p == ',') p++;
+	}
+
+	if(NodeCPUs.empty()) return false;
+
+	SetAffinity(NodeCPUs);
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+//! Start the workers now, rather than when the first task is submitted
+bool TaskExecutor::Start(void)
+{
+	MutexLock Locked(Lock);
+
+	StartWorkers();
+	return !Workers.empty();
+}
+
+
+//! Queue a task to be run by a worker
+void TaskExecutor::Submit(TaskPtr Item, TaskGroup *Group /*=NULL*/)
+{
+	QueuedTask NewTask;
+	NewTask.Item = Item;
+	NewTask.Group = Group;
+
+	if(Group)
+	{
+		MutexLock Locked(Group->Lock);
+		Group->Pending++;
+	}
+
+	WorkerQueue *Target;
+	{
+		MutexLock Locked(Lock);
+
+		if(Workers.empty()) StartWorkers();
+
+		Target = NULL;
+		if(!Workers.empty())
+		{
+			// Tasks from our own workers stay on their queue, others are spread across the workers
+			if(CurrentExecutor == this) Target = Queues[CurrentWorker];
+			else Target = Queues[(NextQueue++) % Queues.size()];
+		}
+	}
+
+	// With no workers we must do the work ourself
+	if(!Target)
+	{
+		RunTask(NewTask);
+		return;
+	}
+
+	{
+		MutexLock Locked(Target->Lock);
+		Target->Tasks.push_back(NewTask);
+	}
+
+	MutexLock Locked(Lock);
+	Queued++;
+	Changed.Signal();
+}
+
+
+//! Run one queued task on the calling thread, if there are any
+bool TaskExecutor::RunOne(void)
+{
+	QueuedTask Taken;
+	if(!TakeTask((CurrentExecutor == this) ? CurrentWorker : -1, Taken)) return false;
+
+	RunTask(Taken);
+	return true;
+}
+
+
+//! Stop the workers once all queued tasks have run
+void TaskExecutor::Stop(void)
+{
+	std::vector<TaskExecutorWorker*> Stopped;
+	{
+		MutexLock Locked(Lock);
+
+		Stopping = true;
+		Changed.Broadcast();
+
+		Stopped.swap(Workers);
+	}
+
+	std::vector<TaskExecutorWorker*>::iterator it = Stopped.begin();
+	while(it != Stopped.end())
+	{
+		(*it)->Join();
+		delete *it;
+		it++;
+	}
+
+	MutexLock Locked(Lock);
+
+	std::vector<WorkerQueue*>::iterator Queue_it = Queues.begin();
+	while(Queue_it != Queues.end())
+	{
+		delete *Queue_it;
+		Queue_it++;
+	}
+
+	Queues.clear();
+	Queued = 0;
+	Stopping = false;
+}
+
+
+//! Determine if the calling thread is one of our workers
+bool TaskExecutor::IsWorkerThread(void) const
+{
+	return CurrentExecutor == this;
+}
+
+
+//! Get the number of CPUs available to this process
+unsigned int TaskExecutor::GetCPUCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO Info;
+	GetSystemInfo(&Info);
+	return Info.dwNumberOfProcessors ? static_cast<unsigned int>(Info.dwNumberOfProcessors) : 1;
+#else
+	long Count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (Count > 0) ? static_cast<unsigned int>(Count) : 1;
+#endif
+}
+
+
+//! Start the workers if they are not running
+void TaskExecutor::StartWorkers(void)
+{
+	if(Stopping || (!Workers.empty()) || (WorkerCount == 0)) return;
+
+	// DRAGONS: All the queues are made before any worker starts, as the workers read the list of queues without the lock.
+	//          If some workers fail to start the tasks given to their queues are stolen by the others.
+	unsigned int i;
+	for(i = 0; i < WorkerCount; i++) Queues.push_back(new WorkerQueue);
+
+	for(i = 0; i < WorkerCount; i++)
+	{
+		int CPU = CPUs.empty() ? -1 : CPUs[i % CPUs.size()];
+
+		TaskExecutorWorker *Worker = new TaskExecutorWorker(this, static_cast<int>(i), CPU);
+		if(!Worker->Start())
+		{
+			delete Worker;
+			break;
+		}
+
+		Workers.push_back(Worker);
+	}
+
+	if(Workers.empty())
+	{
+		warning("Unable to start any worker threads - running tasks on the calling thread instead\n");
+
+		// Don't try again until asked to by SetWorkers()
+		WorkerCount = 0;
+
+		std::vector<WorkerQueue*>::iterator it = Queues.begin();
+		while(it != Queues.end())
+		{
+			delete *it;
+			it++;
+		}
+		Queues.clear();
+	}
+}
+
+
+//! Take a task, from the back of our own queue if Own is not negative, otherwise from the front of any queue
+bool TaskExecutor::TakeTask(int Own, QueuedTask &Taken)
+{
+	size_t Count = Queues.size();
+	if(!Count) return false;
+
+	bool Found = false;
+
+	if(Own >= 0)
+	{
+		WorkerQueue *Queue = Queues[Own];
+
+		MutexLock Locked(Queue->Lock);
+		if(!Queue->Tasks.empty())
+		{
+			Taken = Queue->Tasks.back();
+			Queue->Tasks.pop_back();
+			Found = true;
+		}
+	}
+
+	// Steal the oldest task of another queue, starting with the next one along so that thieves spread out
+	size_t i;
+	for(i = 0; (!Found) && (i < Count); i++)
+	{
+		size_t Index = (static_cast<size_t>(Own + 1) + i) % Count;
+		if(static_cast<int>(Index) == Own) continue;
+
+		WorkerQueue *Queue = Queues[Index];
+
+		MutexLock Locked(Queue->Lock);
+		if(!Queue->Tasks.empty())
+		{
+			Taken = Queue->Tasks.front();
+			Queue->Tasks.pop_front();
+			Found = true;
+		}
+	}
+
+	if(Found)
+	{
+		MutexLock Locked(Lock);
+		Queued--;
+	}
+
+	return Found;
+}
+
+
+//! Run a taken task and tell its group
+void TaskExecutor::RunTask(QueuedTask &Taken)
+{
+	Taken.Item->Run();
+
+	// Drop our reference before the group is told, as the owner of the group may be waiting to clean up
+	Taken.Item = NULL;
+
+	if(Taken.Group) Taken.Group->TaskDone();
+}
+
+
+//! Run tasks until stopped, called on each worker thread
+void TaskExecutor::WorkerLoop(int Index)
+{
+	CurrentExecutor = this;
+	CurrentWorker = Index;
+
+	for(;;)
+	{
+		QueuedTask Taken;
+		if(TakeTask(Index, Taken))
+		{
+			RunTask(Taken);
+			continue;
+		}
+
+		MutexLock Locked(Lock);
+		while((Queued <= 0) && (!Stopping)) Changed.Wait(Lock);
+
+		// Queued tasks are still run when stopping, so that no group is left waiting
+		if(Stopping && (Queued <= 0)) break;
+	}
+
+	CurrentExecutor = NULL;
+	CurrentWorker = -1;
+}
+
+
+//! Get the executor shared by all the parallel features of the library
+TaskExecutor &mxflib::GetTaskExecutor(void)
+{
+	static TaskExecutor Shared;
+	return Shared;
+}
@@ -0,0 +1,225 @@
+/*! \file	executor.h
+ *	\brief	Definition of a shared pool of worker threads that run tasks for the parallel features of the library
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Parallel reading, encryption and similar features each used to start their own threads, so a process using
+ *  several of them at once, or one of them from inside another, could run many more threads than it had cores.
+ *  These features now submit short tasks to a single TaskExecutor, normally the one returned by GetTaskExecutor(),
+ *  whose worker count and CPU placement can be set once for the whole process.
+ *
+ *  Each worker has its own queue of tasks. A task submitted by a worker goes on the back of that worker's queue
+ *  and is taken from the back again, so nested work stays on the same core, while idle workers steal from the
+ *  front of other queues. A thread waiting for a TaskGroup runs queued tasks while it waits, so nested parallelism
+ *  neither deadlocks nor adds threads.
+ *
+ *  Some threads are not tasks, as they live as long as a file or a stream and spend most of their time waiting.
+ *  The I/O threads of an AsyncReadEngine and of a FileLookahead are limited to the worker count of the shared
+ *  executor. The remaining ones are one per output: the writer thread of an MXFFile with asynchronous writing,
+ *  the reader thread of each PrefetchGroup, and the thread writing each output file in ProcessConcurrent(). These
+ *  must all run at once, as they wait for each other through bounded queues, so they are not limited by the
+ *  worker count. Their number is set by the number of files and streams being written.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__EXECUTOR_H
+#define MXFLIB__EXECUTOR_H
+
+#include <deque>
+
+namespace mxflib
+{
+	// Forward declare the worker thread class, which is private to the implementation
+	class TaskExecutorWorker;
+
+	class TaskExecutor;
+	class TaskGroup;
+
+	//! A unit of work to be run by a TaskExecutor
+	class Task : public RefCount<Task>
+	{
+	public:
+		virtual ~Task() {}
+
+		//! Do the work
+		/*! \note Called on a worker thread, or on a thread waiting for a TaskGroup */
+		virtual void Run(void) = 0;
+	};
+
+	//! Smart pointer to a Task
+	typedef SmartPtr<Task> TaskPtr;
+
+
+	//! A set of tasks that can be waited for together
+	/*! DRAGONS: The group must not be destroyed until all its tasks have finished, which the destructor ensures by waiting */
+	class TaskGroup
+	{
+	protected:
+		TaskExecutor *Executor;					//!< The executor running our tasks, set by the first Submit()
+		Mutex Lock;								//!< Lock protecting Pending
+		Condition Changed;						//!< Signalled when a task of the group finishes
+		int Pending;							//!< Number of tasks submitted and not yet finished
+
+		friend class TaskExecutor;
+
+	public:
+		TaskGroup() : Executor(NULL), Pending(0) {}
+
+		//! Wait for any tasks still running
+		~TaskGroup() { Wait(); }
+
+		//! Run a task as part of this group
+		/*! \param UseExecutor The executor to run the task, or NULL for the library-wide one */
+		void Submit(TaskPtr Item, TaskExecutor *UseExecutor = NULL);
+
+		//! Wait for all tasks of the group to finish, running queued tasks on this thread meanwhile
+		void Wait(void);
+
+	protected:
+		//! Record that one of our tasks has finished
+		void TaskDone(void);
+
+	private:
+		//! Prevent copy construction
+		TaskGroup(const TaskGroup &);
+
+		//! Prevent assignment
+		TaskGroup &operator=(const TaskGroup &);
+	};
+
+
+	//! A pool of worker threads, each with its own queue of tasks, that steal work from each other when idle
+	class TaskExecutor
+	{
+	protected:
+		//! A task waiting to be run
+		struct QueuedTask
+		{
+			TaskPtr Item;						//!< The task
+			TaskGroup *Group;					//!< The group to tell when the task has finished, or NULL
+		};
+
+		//! The queue of one worker
+		struct WorkerQueue
+		{
+			Mutex Lock;							//!< Lock protecting Tasks
+			std::deque<QueuedTask> Tasks;		//!< The tasks, the owning worker works from the back and others steal from the front
+		};
+
+		unsigned int WorkerCount;				//!< The number of workers to run
+		std::vector<int> CPUs;					//!< The CPUs that workers are pinned to in turn, or empty for no pinning
+
+		Mutex Lock;								//!< Lock protecting all of the following
+		Condition Changed;						//!< Signalled when a task is queued or we are stopping
+		std::vector<TaskExecutorWorker*> Workers;	//!< The running workers, started by the first Submit()
+		std::vector<WorkerQueue*> Queues;		//!< The queue of each worker
+		int Queued;								//!< Number of tasks queued and not yet taken (may briefly be negative)
+		unsigned int NextQueue;					//!< The queue to give the next task submitted from outside the workers
+		bool Stopping;							//!< Set to stop the workers
+
+		friend class TaskExecutorWorker;
+		friend class TaskGroup;
+
+	public:
+		//! Construct an executor with a given number of workers, or one per CPU if 0
+		TaskExecutor(unsigned int Workers = 0);
+
+		//! Stop the workers once all queued tasks have run
+		~TaskExecutor() { Stop(); }
+
+		//! Set the number of workers
+		/*! \param Count The number of workers, or 0 for one per CPU
+		 *  \note Any running workers are stopped, once all queued tasks have run, and are restarted when next needed
+		 */
+		void SetWorkers(unsigned int Count);
+
+		//! Get the number of workers that will be run, or 0 if they could not be started
+		unsigned int GetWorkers(void) const { return WorkerCount; }
+
+		//! Pin the workers to a set of CPUs, one CPU per worker in turn
+		/*! \param UseCPUs The CPU numbers, or an empty list for no pinning
+		 *  \note This takes effect when the workers are next started, and is ignored on platforms without thread affinity
+		 */
+		void SetAffinity(const std::vector<int> &UseCPUs);
+
+		//! Pin the workers to the CPUs of a NUMA node
+		/*! \return false if the CPUs of the node could not be found, in which case the affinity is unchanged
+		 *  \note This is only available on Linux, where the CPUs of each node are listed by the kernel
+		 */
+		bool SetNUMANode(int Node);
+
+		//! Start the workers now, rather than when the first task is submitted
+		/*! \return false if no workers could be started, in which case tasks are run by Submit() on the calling thread */
+		bool Start(void);
+
+		//! Queue a task to be run by a worker
+		/*! If there are no workers, or they cannot be started, the task is run on the calling thread before returning
+		 *  \param Group The group to tell when the task has finished, or NULL
+		 */
+		void Submit(TaskPtr Item, TaskGroup *Group = NULL);
+
+		//! Run one queued task on the calling thread, if there are any
+		/*! \return false if no task was queued */
+		bool RunOne(void);
+
+		//! Stop the workers once all queued tasks have run
+		/*! \note This must not be called by a task, as a worker cannot wait for itself to stop */
+		void Stop(void);
+
+		//! Determine if the calling thread is one of our workers
+		bool IsWorkerThread(void) const;
+
+		//! Get the number of CPUs available to this process
+		static unsigned int GetCPUCount(void);
+
+	protected:
+		//! Start the workers if they are not running
+		/*! \note Called with the lock held */
+		void StartWorkers(void);
+
+		//! Take a task, from the back of our own queue if Own is not negative, otherwise from the front of any queue
+		bool TakeTask(int Own, QueuedTask &Taken);
+
+		//! Run a taken task and tell its group
+		static void RunTask(QueuedTask &Taken);
+
+		//! Run tasks until stopped, called on each worker thread
+		void WorkerLoop(int Index);
+
+	private:
+		//! Prevent copy construction
+		TaskExecutor(const TaskExecutor &);
+
+		//! Prevent assignment
+		TaskExecutor &operator=(const TaskExecutor &);
+	};
+
+
+	//! Get the executor shared by all the parallel features of the library
+	/*! Its worker count and affinity may be set before it is first used to control the threads used by the whole process */
+	TaskExecutor &GetTaskExecutor(void);
+}
+
+#endif // MXFLIB__EXECUTOR_H
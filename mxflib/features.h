@@ -60,6 +60,8 @@ namespace mxflib
 
 	const UInt64 FeatureVersion1KLVFill = UINT64_C(1) << 0;		//!< MXFLib feature: Write KLVFill items with the version 1 key
 	const UInt64 FeatureUnknownsByUL2Name = UINT64_C(1) << 1;	//!< MXFLib feature: If an unknown UL is converted to a name during MDObject construction, using UL2NameFunc, check if this name is a known type
+	const UInt64 FeatureLazyMetadata = UINT64_C(1) << 2;		//!< MXFLib feature: Only decode header metadata sets when first referenced (see Partition::ReadMetadata)
+	const UInt64 FeatureKeepMetadataBytes = UINT64_C(1) << 3;	//!< MXFLib feature: Keep the bytes of header metadata sets as read, for reuse when written unchanged (see MXFFile::SetMetadataCache)
 
 	/* This sub-range is currently used by temporary fixes (bits 16 to 30) */
 
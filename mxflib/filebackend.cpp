@@ -0,0 +1,398 @@
+/*! \file	filebackend.cpp
+ *	\brief	Implementation of the backends used by MXFFile to access storage other than local files
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+//! Read bytes from a given position
+size_t HandleFileBackend::ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size)
+{
+	return FileReadAt(Handle, Pos, Buffer, Size);
+}
+
+
+//! Write bytes at a given position
+size_t HandleFileBackend::WriteAt(UInt64 Pos, const UInt8 *Buffer, size_t Size)
+{
+	if(!Writable) return static_cast<size_t>(-1);
+
+	return FileWriteAt(Handle, Pos, Buffer, Size);
+}
+
+
+//! Get the number of bytes held, or -1 if not known
+Int64 HandleFileBackend::GetSize(void)
+{
+	return FileSize(Handle);
+}
+
+
+//! Read bytes from a given position
+size_t MemoryFileBackend::ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size)
+{
+	if(Pos >= Data->Size) return 0;
+
+	size_t Available = static_cast<size_t>(Data->Size - Pos);
+	if(Size > Available) Size = Available;
+
+	memcpy(Buffer, &Data->Data[Pos], Size);
+
+	return Size;
+}
+
+
+//! Read bytes from a given position
+size_t ChunkedMemoryBackend::ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size)
+{
+	if(Pos >= DataSize) return 0;
+
+	if(Size > (DataSize - Pos)) Size = static_cast<size_t>(DataSize - Pos);
+
+	size_t Done = 0;
+	while(Done < Size)
+	{
+		size_t Offset = static_cast<size_t>(Pos % SegmentSize);
+		size_t Bytes = SegmentSize - Offset;
+		if(Bytes > (Size - Done)) Bytes = Size - Done;
+
+		memcpy(&Buffer[Done], &Segments[static_cast<size_t>(Pos / SegmentSize)]->Data[Offset], Bytes);
+
+		Pos += Bytes;
+		Done += Bytes;
+	}
+
+	return Size;
+}
+
+
+//! Write bytes at a given position
+size_t ChunkedMemoryBackend::WriteAt(UInt64 Pos, const UInt8 *Buffer, size_t Size)
+{
+	UInt64 End = Pos + Size;
+
+	// Add enough segments to hold the new bytes, each cleared so that any gap left before Pos reads as zero
+	while((static_cast<UInt64>(Segments.size()) * SegmentSize) < End)
+	{
+		DataChunkPtr Segment = new DataChunk(SegmentSize);
+		memset(Segment->Data, 0, SegmentSize);
+		Segments.push_back(Segment);
+	}
+
+	size_t Done = 0;
+	while(Done < Size)
+	{
+		size_t Offset = static_cast<size_t>(Pos % SegmentSize);
+		size_t Bytes = SegmentSize - Offset;
+		if(Bytes > (Size - Done)) Bytes = Size - Done;
+
+		memcpy(&Segments[static_cast<size_t>(Pos / SegmentSize)]->Data[Offset], &Buffer[Done], Bytes);
+
+		Pos += Bytes;
+		Done += Bytes;
+	}
+
+	if(End > DataSize) DataSize = End;
+
+	return Size;
+}
+
+
+//! Get the bytes held as a scatter list of chunks, one per segment, appended to a given list
+size_t ChunkedMemoryBackend::GetChunks(DataChunkList &Chunks)
+{
+	size_t Ret = 0;
+
+	UInt64 Remaining = DataSize;
+	std::vector<DataChunkPtr>::iterator it = Segments.begin();
+	while(Remaining && (it != Segments.end()))
+	{
+		size_t Bytes = (Remaining < SegmentSize) ? static_cast<size_t>(Remaining) : SegmentSize;
+
+		DataChunkPtr View = new DataChunk;
+		View->SetBuffer(*it, (*it)->Data, Bytes);
+		Chunks.push_back(View);
+
+		Remaining -= Bytes;
+		Ret++;
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Get a copy of all the bytes held as a single chunk
+DataChunkPtr ChunkedMemoryBackend::GetData(void)
+{
+	DataChunkPtr Ret = new DataChunk(static_cast<size_t>(DataSize));
+
+	ReadAt(0, Ret->Data, Ret->Size);
+
+	return Ret;
+}
+
+
+//! Open a local file as a backend
+FileBackendPtr mxflib::OpenFileBackend(std::string FileName, bool ReadOnly /*=true*/)
+{
+	FileHandle Handle = ReadOnly ? FileOpenRead(FileName.c_str()) : FileOpen(FileName.c_str());
+	if(!FileValid(Handle)) return NULL;
+
+	return new HandleFileBackend(Handle, true, !ReadOnly, FileName);
+}
+
+
+//! Open a local file as a backend reading through a memory mapping
+FileBackendPtr mxflib::OpenMappedFileBackend(std::string FileName)
+{
+	FileHandle Handle = FileOpenRead(FileName.c_str());
+	if(!FileValid(Handle)) return NULL;
+
+	Int64 FileBytes = FileSize(Handle);
+	UInt8 *Map = (FileBytes > 0) ? FileMemoryMap(Handle, FileBytes) : NULL;
+
+	// If we can't map the file we read it through the handle instead
+	if(!Map) return new HandleFileBackend(Handle, true, false, FileName);
+
+	// DRAGONS: The mapping remains valid once the file is closed, so we don't need to hold the handle open
+	FileClose(Handle);
+
+	return new MemoryFileBackend(new MappedFileChunk(Map, FileBytes), FileName);
+}
+
+
+namespace mxflib
+{
+	//! A task that fetches blocks for a CachedFileBackend
+	/*! Each task takes the next block from a shared list until none are left */
+	class CachedFetchTask : public Task
+	{
+	protected:
+		CachedFileBackend *Owner;					//!< The cache we work for
+		std::vector<UInt64> &Wanted;				//!< The block numbers to fetch
+		std::vector<DataChunkPtr> &Results;			//!< The fetched blocks, in the same order as Wanted, NULL for a failed fetch
+		size_t &Next;								//!< The index of the next entry in Wanted to fetch
+		Mutex &NextLock;							//!< Lock protecting Next
+
+	public:
+		CachedFetchTask(CachedFileBackend *Owner, std::vector<UInt64> &Wanted, std::vector<DataChunkPtr> &Results, size_t &Next, Mutex &NextLock)
+			: Owner(Owner), Wanted(Wanted), Results(Results), Next(Next), NextLock(NextLock) {}
+
+		//! Fetch blocks until there are none left
+		/*! This is also called directly by GetBlocks(), so that the calling thread shares the work */
+		void Run(void)
+		{
+			for(;;)
+			{
+				size_t Index;
+				{
+					MutexLock Locked(NextLock);
+					if(Next >= Wanted.size()) return;
+					Index = Next++;
+				}
+
+				Results[Index] = Owner->FetchBlock(Wanted[Index]);
+			}
+		}
+	};
+}
+
+
+//! Read bytes from a given position
+size_t CachedFileBackend::ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size)
+{
+	if(!Size) return 0;
+
+	// Limit the read to the end of the data, if known
+	Int64 End = GetSize();
+	if(End >= 0)
+	{
+		if(Pos >= static_cast<UInt64>(End)) return 0;
+		if((Pos + Size) > static_cast<UInt64>(End)) Size = static_cast<size_t>(End - Pos);
+	}
+
+	std::vector<DataChunkPtr> Found;
+	if(!GetBlocks(Pos / BlockSize, (Pos + Size - 1) / BlockSize, Found)) return static_cast<size_t>(-1);
+
+	size_t Ret = 0;
+	size_t Offset = static_cast<size_t>(Pos % BlockSize);
+	std::vector<DataChunkPtr>::iterator it = Found.begin();
+	while((it != Found.end()) && Size)
+	{
+		// A short block is the end of the data
+		if(Offset >= (*it)->Size) break;
+
+		size_t Bytes = (*it)->Size - Offset;
+		if(Bytes > Size) Bytes = Size;
+
+		memcpy(Buffer, &(*it)->Data[Offset], Bytes);
+
+		Buffer += Bytes;
+		Size -= Bytes;
+		Ret += Bytes;
+
+		if((*it)->Size < BlockSize) break;
+
+		Offset = 0;
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Get the number of bytes held, or -1 if not known
+Int64 CachedFileBackend::GetSize(void)
+{
+	MutexLock Locked(Lock);
+
+	if(SourceSize == -2) SourceSize = Source->GetSize();
+	return SourceSize;
+}
+
+
+//! Hint that a region will be read soon
+/*! The blocks covering the region that are not held are fetched now, in parallel if possible
+ */
+void CachedFileBackend::Prefetch(UInt64 Pos, UInt64 Size)
+{
+	if(!Size) return;
+
+	// Don't fetch more than the cache can hold
+	UInt64 First = Pos / BlockSize;
+	UInt64 Last = (Pos + Size - 1) / BlockSize;
+	if((Last - First) >= MaxBlocks) Last = First + MaxBlocks - 1;
+
+	std::vector<DataChunkPtr> Found;
+	GetBlocks(First, Last, Found);
+}
+
+
+//! Get the blocks covering a range, fetching any that are not held
+bool CachedFileBackend::GetBlocks(UInt64 First, UInt64 Last, std::vector<DataChunkPtr> &Found)
+{
+	Found.resize(static_cast<size_t>(Last - First + 1));
+
+	// Collect the blocks we hold, and list the rest
+	std::vector<UInt64> Wanted;
+	{
+		MutexLock Locked(Lock);
+
+		for(UInt64 Number = First; Number <= Last; Number++)
+		{
+			CachedBlockMap::iterator it = Blocks.find(Number);
+			if(it == Blocks.end()) Wanted.push_back(Number);
+			else
+			{
+				(*it).second.LastUse = ++UseCount;
+				Found[static_cast<size_t>(Number - First)] = (*it).second.Data;
+			}
+		}
+	}
+
+	if(Wanted.empty()) return true;
+
+	// Fetch the missing blocks, on several threads if we can
+	std::vector<DataChunkPtr> Results(Wanted.size());
+	size_t Next = 0;
+	Mutex NextLock;
+
+	TaskExecutor &Executor = GetTaskExecutor();
+	TaskGroup Tasks;
+	if((FetchThreads > 1) && (Wanted.size() > 1) && Source->IsThreadSafe() && Executor.Start())
+	{
+		size_t Threads = FetchThreads - 1;
+		if(Threads > (Wanted.size() - 1)) Threads = Wanted.size() - 1;
+		if(Threads > Executor.GetWorkers()) Threads = Executor.GetWorkers();
+
+		while(Threads--) Tasks.Submit(new CachedFetchTask(this, Wanted, Results, Next, NextLock), &Executor);
+	}
+
+	// The calling thread fetches blocks too, which also fetches every block if no tasks were submitted
+	CachedFetchTask(this, Wanted, Results, Next, NextLock).Run();
+
+	Tasks.Wait();
+
+	// Add the fetched blocks to the cache
+	bool Ret = true;
+	MutexLock Locked(Lock);
+
+	for(size_t i = 0; i < Wanted.size(); i++)
+	{
+		if(!Results[i])
+		{
+			Ret = false;
+			continue;
+		}
+
+		CachedBlock &Entry = Blocks[Wanted[i]];
+		Entry.Data = Results[i];
+		Entry.LastUse = ++UseCount;
+		FetchedBytes += Results[i]->Size;
+
+		Found[static_cast<size_t>(Wanted[i] - First)] = Results[i];
+	}
+
+	// Drop the least recently used blocks if we hold too many
+	// DRAGONS: A linear scan is fine as the cache holds tens of blocks, and the blocks of this read are safe in Found
+	while(Blocks.size() > MaxBlocks)
+	{
+		CachedBlockMap::iterator Oldest = Blocks.begin();
+		CachedBlockMap::iterator it = Blocks.begin();
+		while(it != Blocks.end())
+		{
+			if((*it).second.LastUse < (*Oldest).second.LastUse) Oldest = it;
+			it++;
+		}
+
+		Blocks.erase(Oldest);
+	}
+
+	return Ret;
+}
+
+
+//! Fetch a single block from the source
+DataChunkPtr CachedFileBackend::FetchBlock(UInt64 Number)
+{
+	DataChunkPtr Ret = new DataChunk(BlockSize);
+
+	size_t Bytes = Source->ReadAt(Number * BlockSize, Ret->Data, BlockSize);
+	if(Bytes == static_cast<size_t>(-1))
+	{
+		error("Unable to read block at 0x%s from \"%s\"\n", Int64toHexString(Number * BlockSize, 8).c_str(), Source->GetName().c_str());
+		return NULL;
+	}
+
+	if(Bytes != BlockSize) Ret->Resize(Bytes);
+
+	return Ret;
+}
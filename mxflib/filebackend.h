@@ -0,0 +1,259 @@
+/*! \file	filebackend.h
+ *	\brief	Definition of the interface used by MXFFile to access storage other than local files
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  An MXFFile normally reads and writes a local file through the FileHandle functions in system.h, or a memory
+ *  buffer. A FileBackend allows any other storage, such as an object store or a web server accessed with range
+ *  requests, to be read (and optionally written) by providing positional reads and writes. An MXFFile opened with
+ *  OpenBackend() does all of its I/O through the backend's ReadAt() and WriteAt(), via its read-ahead window, so
+ *  the rest of the library is unchanged.
+ *
+ *  Backends for local files and memory buffers are provided, along with CachedFileBackend, which holds recently used
+ *  blocks of a slower backend and fetches the missing blocks of a large read in parallel. A backend for remote storage
+ *  only needs to implement ReadAt() and GetSize(), and when wrapped in a CachedFileBackend inspecting the header of
+ *  a large file reads little more than the partitions that are parsed.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__FILEBACKEND_H
+#define MXFLIB__FILEBACKEND_H
+
+namespace mxflib
+{
+	//! Interface to storage holding the bytes of an MXF file
+	/*! All access is positional, so a backend holds no file pointer and one backend may be shared by several MXFFiles.
+	 *  \note Positions are physical positions, including any run-in
+	 */
+	class FileBackend : public RefCount<FileBackend>
+	{
+	public:
+		virtual ~FileBackend() {}
+
+		//! Read bytes from a given position
+		/*! \return The number of bytes read, which is only less than Size at the end of the data, or -1 on error */
+		virtual size_t ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size) = 0;
+
+		//! Write bytes at a given position
+		/*! \return The number of bytes written, or -1 on error
+		 *  \note The default is a read-only backend
+		 */
+		virtual size_t WriteAt(UInt64 Pos, const UInt8 *Buffer, size_t Size) { return static_cast<size_t>(-1); }
+
+		//! Get the number of bytes held, or -1 if not known
+		virtual Int64 GetSize(void) = 0;
+
+		//! Determine if this backend can be written
+		virtual bool IsWritable(void) { return false; }
+
+		//! Determine if ReadAt() and WriteAt() may be called on several threads at once
+		virtual bool IsThreadSafe(void) { return false; }
+
+		//! Get the preferred size of reads, used as the read-ahead window size of an MXFFile using this backend
+		virtual size_t GetBlockSize(void) { return 64 * 1024; }
+
+		//! Hint that a region will be read soon
+		/*! \note The default does nothing */
+		virtual void Prefetch(UInt64 Pos, UInt64 Size) {}
+
+		//! Get a name for the storage, used as the name of an MXFFile using this backend
+		virtual std::string GetName(void) { return "File Backend"; }
+	};
+
+	//! A smart pointer to a FileBackend
+	typedef SmartPtr<FileBackend> FileBackendPtr;
+
+
+	//! A backend reading and writing a local file through the FileHandle functions
+	/*! All access uses FileReadAt() and FileWriteAt(), so the handle's file pointer is never used and no lock is needed */
+	class HandleFileBackend : public FileBackend
+	{
+	protected:
+		FileHandle Handle;					//!< The file handle
+		bool Owned;							//!< True if we close the handle when destroyed
+		bool Writable;						//!< True if the handle was opened for writing
+		std::string Name;					//!< The name of the file
+
+	public:
+		//! Construct a backend for an open file handle
+		/*! \param Handle	The handle to use
+		 *  \param Owned	True if the handle is to be closed when this backend is destroyed
+		 *  \param Writable	True if the handle was opened for writing
+		 *  \param Name		The name of the file
+		 */
+		HandleFileBackend(FileHandle Handle, bool Owned = false, bool Writable = false, std::string Name = "Existing Open File")
+			: Handle(Handle), Owned(Owned), Writable(Writable), Name(Name) {}
+
+		~HandleFileBackend() { if(Owned) FileClose(Handle); }
+
+		size_t ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size);
+		size_t WriteAt(UInt64 Pos, const UInt8 *Buffer, size_t Size);
+		Int64 GetSize(void);
+		bool IsWritable(void) { return Writable; }
+		bool IsThreadSafe(void) { return true; }
+		void Prefetch(UInt64 Pos, UInt64 Size) { FilePrefetch(Handle, Pos, Size); }
+		std::string GetName(void) { return Name; }
+	};
+
+
+	//! A read-only backend holding the whole file in memory, such as a DataChunk referencing a memory mapping
+	class MemoryFileBackend : public FileBackend
+	{
+	protected:
+		DataChunkPtr Data;					//!< The bytes of the file
+		std::string Name;					//!< The name of the file
+
+	public:
+		//! Construct a backend reading from a buffer
+		MemoryFileBackend(DataChunkPtr Data, std::string Name = "Memory File") : Data(Data), Name(Name) {}
+
+		size_t ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size);
+		Int64 GetSize(void) { return static_cast<Int64>(Data->Size); }
+		bool IsThreadSafe(void) { return true; }
+		std::string GetName(void) { return Name; }
+	};
+
+
+	//! A writable backend holding the file in memory as a list of fixed size segments
+	/*! Growing the file only ever adds segments, so bytes already written are never moved or copied and building a
+	 *  large file in memory takes time in proportion to its size. This makes it a better choice than
+	 *  MXFFile::OpenMemory() for building files, such as fragments for HTTP delivery, with OpenBackend().
+	 *  \note This backend is not thread-safe, as writing may add segments
+	 */
+	class ChunkedMemoryBackend : public FileBackend
+	{
+	protected:
+		size_t SegmentSize;					//!< The size of each segment
+		std::vector<DataChunkPtr> Segments;	//!< The segments, each allocated to SegmentSize bytes
+		UInt64 DataSize;					//!< The number of bytes held, which is the end of the last byte written
+		std::string Name;					//!< The name of the file
+
+	public:
+		//! Construct an empty backend
+		/*! \param SegmentSize The size of each segment added as the file grows */
+		ChunkedMemoryBackend(size_t SegmentSize = 1024 * 1024, std::string Name = "Memory File")
+			: SegmentSize(SegmentSize ? SegmentSize : 1024 * 1024), DataSize(0), Name(Name) {}
+
+		size_t ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size);
+		size_t WriteAt(UInt64 Pos, const UInt8 *Buffer, size_t Size);
+		Int64 GetSize(void) { return static_cast<Int64>(DataSize); }
+		bool IsWritable(void) { return true; }
+		std::string GetName(void) { return Name; }
+
+		//! Get the size of each segment
+		size_t GetSegmentSize(void) const { return SegmentSize; }
+
+		//! Get the bytes held as a scatter list of chunks, one per segment, appended to a given list
+		/*! The chunks reference the segments rather than holding a copy, and keep them valid if this backend is destroyed.
+		 *  \return The number of chunks added
+		 *  DRAGONS: Later writes to bytes already held are seen through the chunks, as they share the segments
+		 */
+		size_t GetChunks(DataChunkList &Chunks);
+
+		//! Get a copy of all the bytes held as a single chunk
+		DataChunkPtr GetData(void);
+	};
+
+
+	//! Open a local file as a backend
+	/*! \return NULL if the file could not be opened */
+	FileBackendPtr OpenFileBackend(std::string FileName, bool ReadOnly = true);
+
+	//! Open a local file as a backend reading through a memory mapping
+	/*! \return NULL if the file could not be opened
+	 *  \note If the file can't be mapped it is read through its file handle instead
+	 */
+	FileBackendPtr OpenMappedFileBackend(std::string FileName);
+
+
+	// Forward declare the fetch task, which is private to the implementation
+	class CachedFetchTask;
+
+	//! A read-only backend holding recently used blocks of another, slower, backend
+	/*! Reads are broken into fixed size blocks, each fetched from the source once and kept until it is the least
+	 *  recently used of more than MaxBlocks. When a read or a Prefetch() needs several blocks that are not held, and
+	 *  the source is thread-safe, they are fetched on up to FetchThreads threads at once, which hides much of the
+	 *  latency of remote storage. The calling thread fetches blocks itself, the others are workers of the shared
+	 *  TaskExecutor, so the number of threads is also limited by its worker count.
+	 */
+	class CachedFileBackend : public FileBackend
+	{
+	protected:
+		//! A block held in the cache
+		struct CachedBlock
+		{
+			DataChunkPtr Data;				//!< The bytes of the block, which may be short at the end of the data
+			UInt64 LastUse;					//!< The value of UseCount when this block was last used
+		};
+
+		//! Map of held blocks, indexed by block number
+		typedef std::map<UInt64, CachedBlock> CachedBlockMap;
+
+		FileBackendPtr Source;				//!< The backend holding the data
+		size_t BlockSize;					//!< The size of each block
+		size_t MaxBlocks;					//!< The number of blocks that may be held
+		unsigned int FetchThreads;			//!< The number of threads used to fetch blocks
+
+		Mutex Lock;							//!< Lock protecting all of the following
+		CachedBlockMap Blocks;				//!< The blocks held
+		UInt64 UseCount;					//!< Incremented for each block used, to find the least recently used
+		UInt64 FetchedBytes;				//!< The number of bytes fetched from the source
+		Int64 SourceSize;					//!< The size of the source, or -2 if not yet asked
+
+		friend class CachedFetchTask;
+
+	public:
+		//! Construct a cache for a given backend
+		/*! \param Source		The backend to read
+		 *  \param BlockSize	The size of each block fetched from the source
+		 *  \param MaxBlocks	The number of blocks to hold
+		 *  \param FetchThreads	The number of threads used to fetch blocks, including the calling thread, or 0 or 1 to fetch them on the calling thread
+		 */
+		CachedFileBackend(FileBackendPtr Source, size_t BlockSize = 1024 * 1024, size_t MaxBlocks = 64, unsigned int FetchThreads = 4)
+			: Source(Source), BlockSize(BlockSize ? BlockSize : 1024 * 1024), MaxBlocks(MaxBlocks ? MaxBlocks : 1), FetchThreads(FetchThreads),
+			  UseCount(0), FetchedBytes(0), SourceSize(-2) {}
+
+		size_t ReadAt(UInt64 Pos, UInt8 *Buffer, size_t Size);
+		Int64 GetSize(void);
+		bool IsThreadSafe(void) { return true; }
+		size_t GetBlockSize(void) { return BlockSize; }
+		void Prefetch(UInt64 Pos, UInt64 Size);
+		std::string GetName(void) { return Source->GetName(); }
+
+		//! Get the number of bytes fetched from the source so far
+		UInt64 GetFetchedBytes(void) { MutexLock Locked(Lock); return FetchedBytes; }
+
+	protected:
+		//! Get the blocks covering a range, fetching any that are not held
+		/*! \return false if a block could not be fetched */
+		bool GetBlocks(UInt64 First, UInt64 Last, std::vector<DataChunkPtr> &Found);
+
+		//! Fetch a single block from the source
+		/*! \return NULL on error */
+		DataChunkPtr FetchBlock(UInt64 Number);
+	};
+}
+
+#endif // MXFLIB__FILEBACKEND_H
@@ -68,6 +68,11 @@ namespace mxflib
 	//! List of smart pointers to index table segments
 	typedef std::list<IndexSegmentPtr> IndexSegmentList;
 
+	struct IndexSegmentInfo;
+
+	//! List of index table segment summaries, in the order read
+	typedef std::list<IndexSegmentInfo> IndexSegmentInfoList;
+
 
 	/* SymbolSpace pointer types */
 
@@ -0,0 +1,219 @@
+/*! \file	growing.cpp
+ *	\brief	Implementation of classes that follow the partitions of an MXF file as it grows
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Read the key and length of a KLV, as long as the whole KLV is before a given end of the file
+	/*! \return false if the KLV is not yet complete
+	 *  \note Length is set to -1 if the KLV is complete but does not have a valid length
+	 */
+	bool ReadCompleteKL(MXFFilePtr &File, Position Location, Position End, UInt8 *Key, Length &Len, Position &ValueStart)
+	{
+		// Read the key and the longest possible BER length, or as much as there is
+		UInt8 Buffer[16 + 9];
+		Length Available = End - Location;
+		if(Available < 17) return false;
+		if(Available > static_cast<Length>(sizeof(Buffer))) Available = sizeof(Buffer);
+
+		File->Seek(Location);
+		size_t Bytes = File->Read(Buffer, static_cast<size_t>(Available));
+		if(Bytes < 17) return false;
+
+		// The length could be long-form with not all of its bytes written yet
+		if((Buffer[16] > 0x80) && (Bytes < static_cast<size_t>(Buffer[16] - 0x80 + 17))) return false;
+
+		memcpy(Key, Buffer, 16);
+
+		const UInt8 *BERPtr = &Buffer[16];
+		Len = ReadBER(&BERPtr, static_cast<int>(Bytes - 16));
+		if(Len < 0) return true;
+
+		ValueStart = Location + static_cast<Position>(BERPtr - Buffer);
+		return (ValueStart + Len) <= End;
+	}
+}
+
+
+//! Construct a tracker for a given file
+PartitionTracker::PartitionTracker(MXFFilePtr &File) : File(File), ScanPos(0), LastPartition(-1)
+{
+	// Start from the last partition already known, if there is one
+	if(!File->FileRIP.empty())
+	{
+		RIP::reverse_iterator it = File->FileRIP.rbegin();
+		if((*it).second->GetByteOffset() >= 0)
+		{
+			ScanPos = (*it).second->GetByteOffset();
+			LastPartition = ScanPos;
+		}
+	}
+}
+
+
+//! Scan any data added to the file since the last update
+/*! \return The number of new partitions found, or -1 on error (such as the file containing invalid data)
+ */
+int PartitionTracker::Update(void)
+{
+	Length FileSize = File->Size();
+	if(FileSize < 0)
+	{
+		error("Unable to determine the size of file \"%s\" in PartitionTracker::Update()\n", File->Name.c_str());
+		return -1;
+	}
+
+	// The end of the MXF data, relative to the start of the first partition pack
+	Position End = static_cast<Position>(FileSize - File->RunIn.Size);
+	if(End <= ScanPos) return 0;
+
+	Position StartPos = ScanPos;
+	std::list<PartitionInfoPtr> NewParts;
+
+	UInt8 Key[16];
+	Length Len;
+	Position ValueStart;
+	while(ReadCompleteKL(File, ScanPos, End, Key, Len, ValueStart))
+	{
+		if(Len < 0)
+		{
+			error("Invalid KLV length at 0x%s in file \"%s\"\n", Int64toHexString(ScanPos, 8).c_str(), File->Name.c_str());
+			return -1;
+		}
+
+		if(IsPartitionKey(Key))
+		{
+			// The partition we started from is already known, so only read it to find the end of its metadata
+			bool Known = (ScanPos == LastPartition);
+
+			File->Seek(ScanPos);
+			PartitionPtr ThisPartition = File->ReadPartition();
+			if(!ThisPartition)
+			{
+				error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(ScanPos, 8).c_str(), File->Name.c_str());
+				return -1;
+			}
+
+			if(!Known)
+			{
+				UInt32 BodySID = ThisPartition->GetUInt(BodySID_UL);
+				UInt32 IndexSID = ThisPartition->GetUInt(IndexSID_UL);
+				PartitionInfoPtr Info = File->FileRIP.AddPartition(ThisPartition, ScanPos, BodySID);
+				Info->SetSIDs(BodySID, IndexSID);
+				Info->SetStreamOffset(ThisPartition->GetInt64(BodyOffset_UL));
+
+				NewParts.push_back(Info);
+				LastPartition = ScanPos;
+			}
+
+			// Skip the header metadata and index table segments if they are all present
+			Position NextPos = SkipPartitionData(ThisPartition, End);
+			ScanPos = (NextPos >= 0) ? NextPos : (ValueStart + Len);
+		}
+		else
+		{
+			ScanPos = ValueStart + Len;
+		}
+	}
+
+	// Tell the handlers what we found
+	PartitionTrackHandlerList::iterator it = Handlers.begin();
+	while(it != Handlers.end())
+	{
+		std::list<PartitionInfoPtr>::iterator Part_it = NewParts.begin();
+		while(Part_it != NewParts.end())
+		{
+			(*it)->NewPartition(this, *Part_it);
+			Part_it++;
+		}
+
+		if(ScanPos != StartPos) (*it)->Grown(this, ScanPos);
+
+		it++;
+	}
+
+	return static_cast<int>(NewParts.size());
+}
+
+
+//! Get the info for the last partition found in the file, or NULL if none have been found
+PartitionInfoPtr PartitionTracker::GetLastPartition(void)
+{
+	if(LastPartition < 0) return NULL;
+
+	RIP::iterator it = File->FileRIP.find(LastPartition);
+	if(it == File->FileRIP.end()) return NULL;
+
+	return (*it).second;
+}
+
+
+//! Work out where the header metadata and index table segments of a partition end, if they are all in the file
+/*! \param Part The partition pack, which has just been read
+ *  \param End The current end of the file
+ *  \return The location of the first KLV after the metadata and index, or -1 if this is not yet known
+ */
+Position PartitionTracker::SkipPartitionData(PartitionPtr &Part, Position End)
+{
+	Length Skip = Part->GetInt64(HeaderByteCount_UL) + Part->GetInt64(IndexByteCount_UL);
+	if(Skip <= 0) return -1;
+
+	// The byte counts start after any filler following the partition pack
+	Position Start = File->Tell();
+
+	UInt8 Key[16];
+	Length Len;
+	Position ValueStart;
+	if(!ReadCompleteKL(File, Start, End, Key, Len, ValueStart)) return -1;
+	if(Len < 0) return -1;
+
+	UL FirstKey(Key);
+	if(FirstKey.Matches(KLVFill_UL)) Start = ValueStart + Len;
+
+	Position NextPos = Start + Skip;
+	if(NextPos > End) return -1;
+
+	// Check that we have ended up at the start of a KLV, otherwise the byte counts are not valid and we will need to scan
+	if(NextPos < End)
+	{
+		UInt8 Test[2];
+		File->Seek(NextPos);
+		if((File->Read(Test, 2) == 2) && ((Test[0] != 0x06) || (Test[1] != 0x0e)))
+		{
+			warning("Byte counts in partition pack at 0x%s in file \"%s\" are not valid\n", Int64toHexString(Part->GetLocation(), 8).c_str(), File->Name.c_str());
+			return -1;
+		}
+	}
+
+	return NextPos;
+}
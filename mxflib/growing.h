@@ -0,0 +1,129 @@
+/*! \file	growing.h
+ *	\brief	Definition of classes that follow the partitions of an MXF file as it grows
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A file that is still being written, such as during live ingest, can be polled to find the
+ *  partitions added since the last poll. MXFFile::BuildRIP() needs to scan the whole file each
+ *  time, whereas a PartitionTracker remembers how far it has scanned and only reads the keys and
+ *  lengths of the KLVs that have been added since.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__GROWING_H
+#define MXFLIB__GROWING_H
+
+namespace mxflib
+{
+	// Forward declare PartitionTracker to allow the handler to be defined first
+	class PartitionTracker;
+
+	//! Base class for handlers that are told when a PartitionTracker finds new partitions
+	class PartitionTrackHandler_Base : public RefCount<PartitionTrackHandler_Base>
+	{
+	public:
+		//! Base destructor
+		virtual ~PartitionTrackHandler_Base() {};
+
+		//! Handle a newly found partition
+		/*! \note This is called once for each new partition, in file order, after the partition has been added to the file's RIP
+		 */
+		virtual void NewPartition(PartitionTracker *Caller, PartitionInfoPtr &Info) = 0;
+
+		//! Handle the file growing
+		/*! Called once for each call to PartitionTracker::Update() that finds more complete KLVs, after any calls to NewPartition()
+		 *  \param End The location of the end of the last complete KLV now found
+		 */
+		virtual void Grown(PartitionTracker *Caller, Position End) {};
+	};
+
+	//! A smart pointer to a PartitionTrackHandler_Base object
+	typedef SmartPtr<PartitionTrackHandler_Base> PartitionTrackHandlerPtr;
+
+	//! A list of smart pointers to PartitionTrackHandler_Base objects
+	typedef std::list<PartitionTrackHandlerPtr> PartitionTrackHandlerList;
+
+
+	//! Follows the partitions of an MXF file as it grows
+	/*! Each call to Update() reads the keys and lengths of any KLVs added since the previous call, adding any
+	 *  partitions found to the file's RIP. The value of each KLV is skipped unless it is a partition pack, and
+	 *  the header metadata and index table segments in a partition are skipped in one go where the byte counts
+	 *  in the partition pack allow.
+	 *  \note Scanning stops at the first KLV that is not yet complete, which is read again by the next Update()
+	 */
+	class PartitionTracker : public RefCount<PartitionTracker>
+	{
+	protected:
+		MXFFilePtr File;						//!< The file being tracked
+		Position ScanPos;						//!< The location of the next KLV to be scanned
+		Position LastPartition;					//!< The location of the last partition pack found, or -1 if none found yet
+		PartitionTrackHandlerList Handlers;		//!< Handlers to tell about changes
+
+	public:
+		//! Construct a tracker for a given file
+		/*! If the file already has a RIP, scanning starts from the last partition in it, which is not reported as new
+		 */
+		PartitionTracker(MXFFilePtr &File);
+
+		//! Scan any data added to the file since the last update
+		/*! \return The number of new partitions found, or -1 on error (such as the file containing invalid data)
+		 */
+		int Update(void);
+
+		//! Add a handler to be told about new partitions and growth of the file
+		void AddHandler(PartitionTrackHandlerPtr Handler) { Handlers.push_back(Handler); }
+
+		//! Get the location of the end of the data scanned so far
+		Position GetScanPos(void) const { return ScanPos; }
+
+		//! Get the info for the last partition found in the file, or NULL if none have been found
+		PartitionInfoPtr GetLastPartition(void);
+
+		//! Get the file being tracked
+		MXFFilePtr &GetFile(void) { return File; }
+
+	protected:
+		//! Add a new partition, read from the current file position, to the RIP
+		/*! \return The info for the partition, or NULL if it could not be read
+		 */
+		PartitionInfoPtr AddPartition(Position Location);
+
+		//! Work out where the header metadata and index table segments of a partition end, if they are all in the file
+		/*! \param Part The partition pack, which has just been read
+		 *  \param End The current end of the file
+		 *  \return The location of the first KLV after the metadata and index, or -1 if this is not yet known
+		 */
+		Position SkipPartitionData(PartitionPtr &Part, Position End);
+
+	private:
+		//! Prevent copy construction
+		PartitionTracker(const PartitionTracker &);
+	};
+
+	//! A smart pointer to a PartitionTracker object
+	typedef SmartPtr<PartitionTracker> PartitionTrackerPtr;
+}
+
+#endif // MXFLIB__GROWING_H
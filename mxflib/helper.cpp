@@ -29,6 +29,15 @@
 
 #include "mxflib/mxflib.h"
 
+// Use SSE2 or NEON for the ASCII runs of string conversions where available at compile time
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define HELPER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define HELPER_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace mxflib;
 
 // Define the features bitmap - turn on those features set by compile time switch
@@ -122,13 +131,13 @@ UInt32 mxflib::MakeBER(UInt8 *Data, int MaxSize, UInt64 Length, UInt32 Size /*=0
 }
 
 
-//! Read a BER length
+//! Read a BER length of any form
 /*! \param Data is a pointer to a pointer to the data so that the pointer will be updated to point to the first byte <b>after</b> the length.
  *  \param MaxSize is the maximum number of bytes available to read the BER length. This function never reads from more than 9 bytes as SMPTE 377M forbids vast BER lengths.
  *  \return The length, or -1 if the data was not a valid BER length
  *  \note MaxSize is signed to allow calling code to end up with -ve available bytes!
  */
-Length mxflib::ReadBER(UInt8 const **Data, int MaxSize)
+Length mxflib::ReadBERGeneral(UInt8 const **Data, int MaxSize)
 {
 	if(MaxSize <= 0) return -1;
 
@@ -514,6 +523,171 @@ bool mxflib::IsWideString(std::string &String)
 }
 
 
+//! Convert a UTF-16 string to UTF-8, stopping at the first null
+/*! Surrogate pairs are converted to single 4-byte codes, and a lead surrogate without a trail surrogate becomes U+FFFD
+ *  \param Source The UTF-16 code units, in native byte order
+ *  \param Count The number of code units in Source
+ *  \param Dest Buffer to receive the UTF-8, which must have room for 3 bytes per code unit
+ *  \return The number of bytes written to Dest
+ */
+size_t mxflib::UTF16ToUTF8(const UInt16 *Source, size_t Count, char *Dest)
+{
+	const UInt16 *End = &Source[Count];
+	char *Out = Dest;
+
+	while(Source < End)
+	{
+#if defined(HELPER_SSE2)
+		// Narrow runs of 8 ASCII code units at once, checking first that none is zero or above 0x7f
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i High = _mm_set1_epi16(static_cast<short>(0xff80));
+		while((End - Source) >= 8)
+		{
+			__m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Source));
+			__m128i Bad = _mm_or_si128(_mm_cmpeq_epi16(V, Zero), _mm_xor_si128(_mm_cmpeq_epi16(_mm_and_si128(V, High), Zero), _mm_set1_epi16(-1)));
+			if(_mm_movemask_epi8(Bad)) break;
+
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(Out), _mm_packus_epi16(V, V));
+			Source += 8;
+			Out += 8;
+		}
+#elif defined(HELPER_NEON)
+		while((End - Source) >= 8)
+		{
+			uint16x8_t V = vld1q_u16(Source);
+			if((vmaxvq_u16(V) > 0x7f) || (vminvq_u16(V) == 0)) break;
+
+			vst1_u8(reinterpret_cast<uint8_t *>(Out), vmovn_u16(V));
+			Source += 8;
+			Out += 8;
+		}
+#endif
+		if(Source == End) break;
+
+		UInt16 Value = *Source++;
+
+		// Exit when a null is found
+		if(!Value) break;
+
+		// Is this a simple 7-bit character?
+		if(Value < 0x80)
+		{
+			*Out++ = static_cast<char>(Value);
+		}
+		// How about a value that can be represented in 2 UTF8 bytes?
+		else if(Value < 0x800)
+		{
+			*Out++ = static_cast<char>(0xc0 | (Value >> 6));
+			*Out++ = static_cast<char>(0x80 | (Value & 0x3f));
+		}
+		// Is this a surrogate pair?
+		else if(((Value & 0xfc00) == 0xd800) && (Source < End) && ((*Source & 0xfc00) == 0xdc00))
+		{
+			UInt16 Trail = *Source++;
+			UInt16 UValue = ((Value >> 6) & 0x000f) + 1;
+			*Out++ = static_cast<char>(0xf0 | (UValue >> 2));
+			*Out++ = static_cast<char>(0x80 | ((UValue & 0x03) << 4) | ((Value & 0x003c) >> 2));
+			*Out++ = static_cast<char>(0x80 | ((Value & 0x03) << 4) | ((Trail & 0x03c0) >> 6));
+			*Out++ = static_cast<char>(0x80 | (Trail & 0x3f));
+		}
+		// Otherwise it will take 3 bytes
+		else
+		{
+			// A lead surrogate without its trail surrogate is replaced
+			if((Value & 0xfc00) == 0xd800) Value = 0xfffd;
+
+			*Out++ = static_cast<char>(0xe0 | (Value >> 12));
+			*Out++ = static_cast<char>(0x80 | ((Value >> 6) & 0x3f));
+			*Out++ = static_cast<char>(0x80 | (Value & 0x3f));
+		}
+	}
+
+	return static_cast<size_t>(Out - Dest);
+}
+
+
+//! Convert a UTF-8 string to UTF-16
+/*! Codes of 4 bytes are converted to surrogate pairs, and invalid bytes become U+FFFD
+ *  \param Source The UTF-8 bytes
+ *  \param Size The number of bytes in Source
+ *  \param Dest Buffer to receive the UTF-16 code units in native byte order, which must have room for one per byte of Source
+ *  \return The number of code units written to Dest
+ */
+size_t mxflib::UTF8ToUTF16(const char *Source, size_t Size, UInt16 *Dest)
+{
+	const UInt8 *p = reinterpret_cast<const UInt8 *>(Source);
+	const UInt8 *End = &p[Size];
+	UInt16 *Out = Dest;
+
+	while(p < End)
+	{
+#if defined(HELPER_SSE2)
+		// Widen runs of 16 ASCII bytes at once, checking first that no byte has its top bit set
+		const __m128i Zero = _mm_setzero_si128();
+		while((End - p) >= 16)
+		{
+			__m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+			if(_mm_movemask_epi8(V)) break;
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Out), _mm_unpacklo_epi8(V, Zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&Out[8]), _mm_unpackhi_epi8(V, Zero));
+			p += 16;
+			Out += 16;
+		}
+#elif defined(HELPER_NEON)
+		while((End - p) >= 16)
+		{
+			uint8x16_t V = vld1q_u8(p);
+			if(vmaxvq_u8(V) > 0x7f) break;
+
+			vst1q_u16(Out, vmovl_u8(vget_low_u8(V)));
+			vst1q_u16(&Out[8], vmovl_u8(vget_high_u8(V)));
+			p += 16;
+			Out += 16;
+		}
+#endif
+		if(p == End) break;
+
+		size_t Left = static_cast<size_t>(End - p);
+
+		// Is is a simple 7-bit character?
+		if((p[0] & 0x80) == 0)
+		{
+			*Out++ = p[0];
+			p++;
+		}
+		// Or a 2-byte code?
+		else if((Left >= 2) && ((p[0] & 0xe0) == 0xc0) && ((p[1] & 0xc0) == 0x80))
+		{
+			*Out++ = (static_cast<UInt16>(p[0] & 0x1f) << 6) | static_cast<UInt16>(p[1] & 0x3f);
+			p += 2;
+		}
+		// Or a 3-byte code?
+		else if((Left >= 3) && ((p[0] & 0xf0) == 0xe0) && ((p[1] & 0xc0) == 0x80) && ((p[2] & 0xc0) == 0x80))
+		{
+			*Out++ = (static_cast<UInt16>(p[0] & 0x0f) << 12) | (static_cast<UInt16>(p[1] & 0x3f) << 6) | static_cast<UInt16>(p[2] & 0x3f);
+			p += 3;
+		}
+		// Or a 4-byte code, which becomes a surrogate pair?
+		else if((Left >= 4) && ((p[0] & 0xf8) == 0xf0) && ((p[1] & 0xc0) == 0x80) && ((p[2] & 0xc0) == 0x80) && ((p[3] & 0xc0) == 0x80))
+		{
+			UInt16 UValue = (static_cast<UInt16>(p[0] & 0x07) << 2) | (static_cast<UInt16>(p[1] & 0x30) >> 4);
+			*Out++ = 0xd800 | ((UValue - 1) << 6) | ((p[1] & 0x0f) << 2) | ((p[2] & 0x30) >> 4);
+			*Out++ = 0xdc00 | ((p[2] & 0x0f) << 6) | (p[3] & 0x3f);
+			p += 4;
+		}
+		// Errors get replaced with "replacement character"
+		else
+		{
+			*Out++ = 0xfffd;
+			p++;
+		}
+	}
+
+	return static_cast<size_t>(Out - Dest);
+}
+
+
 //! Read an IFF chunk header (from an open file)
 /*! The Chunk ID is read as a big-endian UInt32 and returned as the first
  *	part of the returned pair. The chunk size is read as a specified-endian
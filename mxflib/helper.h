@@ -139,8 +139,51 @@ namespace mxflib
 		return new DataChunk(Bytes, Buff);
 	}
 
+	//! Read a BER length of any form
+	/*! This is the general version of ReadBER(), which is used for the less common forms of length */
+	Length ReadBERGeneral(UInt8 const **Data, int MaxSize);
+
 	//! Read a BER length
-	Length ReadBER(UInt8 const **Data, int MaxSize);
+	/*! \param Data is a pointer to a pointer to the data so that the pointer will be updated to point to the first byte <b>after</b> the length.
+	 *  \param MaxSize is the maximum number of bytes available to read the BER length.
+	 *  \return The length, or -1 if the data was not a valid BER length
+	 *  The short form and the 4, 5 and 9 byte long forms, which cover almost all lengths found in MXF files, are decoded
+	 *  here with a single bounds test and no loop, other forms are passed to ReadBERGeneral()
+	 */
+	inline Length ReadBER(UInt8 const **Data, int MaxSize)
+	{
+		if(MaxSize > 0)
+		{
+			const UInt8 *p = *Data;
+			UInt8 First = *p;
+
+			if(First < 0x80)
+			{
+				*Data = p + 1;
+				return static_cast<Length>(First);
+			}
+
+			if((First == 0x83) && (MaxSize >= 4))
+			{
+				*Data = p + 4;
+				return static_cast<Length>((static_cast<UInt32>(p[1]) << 16) | (static_cast<UInt32>(p[2]) << 8) | p[3]);
+			}
+
+			if((First == 0x84) && (MaxSize >= 5))
+			{
+				*Data = p + 5;
+				return static_cast<Length>(GetU32(&p[1]));
+			}
+
+			if((First == 0x88) && (MaxSize >= 9))
+			{
+				*Data = p + 9;
+				return static_cast<Length>(GetU64(&p[1]));
+			}
+		}
+
+		return ReadBERGeneral(Data, MaxSize);
+	}
 
 	//! Read a BER length
 	inline Length ReadBER(UInt8 **Data, int MaxSize)
@@ -300,6 +343,24 @@ namespace mxflib
 	/*! \note This currently only checks if any bytes contain >127 so it is only safe to test strings that are either 7-bit ASCII or UTF-8 */
 	bool IsWideString(std::string &String);
 
+	//! Convert a UTF-16 string to UTF-8, stopping at the first null
+	/*! Surrogate pairs are converted to single 4-byte codes, and a lead surrogate without a trail surrogate becomes U+FFFD
+	 *  \param Source The UTF-16 code units, in native byte order
+	 *  \param Count The number of code units in Source
+	 *  \param Dest Buffer to receive the UTF-8, which must have room for 3 bytes per code unit
+	 *  \return The number of bytes written to Dest
+	 */
+	size_t UTF16ToUTF8(const UInt16 *Source, size_t Count, char *Dest);
+
+	//! Convert a UTF-8 string to UTF-16
+	/*! Codes of 4 bytes are converted to surrogate pairs, and invalid bytes become U+FFFD
+	 *  \param Source The UTF-8 bytes
+	 *  \param Size The number of bytes in Source
+	 *  \param Dest Buffer to receive the UTF-16 code units in native byte order, which must have room for one per byte of Source
+	 *  \return The number of code units written to Dest
+	 */
+	size_t UTF8ToUTF16(const char *Source, size_t Size, UInt16 *Dest);
+
 	//! Read hex values separated by any of 'Sep'
 	/*! \note Modifies the value of Source to point to the following byte
 	 *  \return number of values read */
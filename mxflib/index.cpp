@@ -29,6 +29,8 @@
 
 #include "mxflib/mxflib.h"
 
+#include <algorithm>
+
 using namespace mxflib;
 
 
@@ -38,10 +40,60 @@ using namespace mxflib;
 const Position IndexTable::IndexLowest = (0 - UINT64_C(0x7fffffffffffffff));
 
 
+namespace
+{
+	//! The largest IndexEntryArray that fits in a segment, allowing for the 2-byte local set length and the 8-byte array header
+	const int MaxIndexEntryArraySize = 0xffff - 8;
+
+	//! The number of entries to allow for when a segment first grows without a reserved capacity
+	const int InitialSegmentEntries = 64;
+
+	//! Read the entries of a DeltaEntryArray property, whether held as child objects or as packed bytes
+	/*! \return The number of entries, with a new array of them in Array, or -1 if the property is malformed */
+	int ReadDeltaEntries(MDObjectPtr &Ptr, DeltaEntry *&Array)
+	{
+		MDPackedArray Packed = Ptr->GetPackedArray();
+		if(!Packed.empty())
+		{
+			if(Packed.GetItemSize() != sizeof(DeltaEntry))
+			{
+				Array = NULL;
+				return -1;
+			}
+
+			int Count = static_cast<int>(Packed.size());
+			Array = new DeltaEntry[Count];
+			memcpy(Array, Packed.GetItem(0), Count * sizeof(DeltaEntry));
+
+			return Count;
+		}
+
+		int Count = static_cast<int>(Ptr->size());
+		Array = new DeltaEntry[Count];
+
+		int Delta = 0;
+		MDObjectULList::iterator it = Ptr->begin();
+		while(it != Ptr->end())
+		{
+			Array[Delta].PosTableIndex = (*it).second[0]->GetInt();
+			Array[Delta].Slice = (*it).second[1]->GetUInt();
+			PutU32((*it).second[2]->GetUInt(), Array[Delta].ElementDelta);
+
+			it++;
+			Delta++;
+		}
+
+		return (Delta == Count) ? Count : -1;
+	}
+}
+
+
 //! Free memory by purging the specified range from the index
 /*! DRAGONS: This function needs testing, also it could be improved to purge partial segments as well */
 void IndexTable::Purge(UInt64 FirstPosition, UInt64 LastPosition)
 {
+	ClearFlat();
+
 	// Find the correct entry, or the nearest after it
 	// DRAGONS: Is this inefficient?
 	IndexSegmentMap::iterator it = SegmentMap.find(FirstPosition);
@@ -128,14 +180,56 @@ bool IndexTable::AddIndexEntry(Position EditUnit, Int8 TemporalOffset, Int8 KeyF
 }
 
 
+//! Add pre-formed index entries for a run of consecutive edit units, creating segments as required
+bool IndexTable::AddIndexEntries(Position FirstEditUnit, int Count, int Size, UInt8 const *Entries)
+{
+	if(Size != static_cast<int>(IndexEntrySize))
+	{
+		error("Current index table has entries of size %d, tried to add entries of size %d\n", IndexEntrySize, Size);
+		return false;
+	}
+
+	while(Count > 0)
+	{
+		// Get the correct segment to use
+		IndexSegmentPtr Segment = GetSegment(FirstEditUnit);
+
+		// If this position already exists in the segment we must replace it
+		if(FirstEditUnit < (Segment->StartPosition + Segment->EntryCount))
+		{
+			// DRAGONS: Need to add replace!
+			error("Replacing index entries is not yet implemented\n");
+		}
+
+		// Start a new segment if this one is full
+		int Free = Segment->GetFreeEntries();
+		if(Free <= 0)
+		{
+			Segment = AddSegment(FirstEditUnit);
+			Free = Segment->GetFreeEntries();
+			if(Free <= 0) return false;
+		}
+
+		int ThisCount = (Count < Free) ? Count : Free;
+		if(!Segment->AddIndexEntries(ThisCount, Size, Entries)) return false;
+
+		FirstEditUnit += ThisCount;
+		Entries += ThisCount * Size;
+		Count -= ThisCount;
+	}
+
+	return true;
+}
+
+
 //! Perform an index table look-up
 /*! Note that the return value is relative to the start of the EC in frame-wrapping,
  *  but relative to the start of the value of the first KLV in the first edit unit
  *  in the essence container in clip-wrapping
  */
-IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reorder /* =true */)
+void IndexTable::Lookup(Position EditUnit, IndexPos &Result, int SubItem /* =0 */, bool Reorder /* =true */) const
 {
-	IndexPosPtr Ret = new IndexPos;
+	StatsAdd(StatsIndexLookups);
 
 	// Deal with CBR first
 	if(EditUnitByteCount)
@@ -146,39 +240,45 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 		if(SubItem == 0)
 		{
 			// If we are looking for the first sub-stream then all is fine
-			Ret->Exact = true;
-			Ret->OtherPos = false;
+			Result.Exact = true;
+			Result.OtherPos = false;
 		}
 		else
 		{
 			// Can't index a stream if we don't have a delta to it
 			if(SubItem >= BaseDeltaCount)
 			{
-				Ret->Exact = false;
-				Ret->OtherPos = false;
+				Result.Exact = false;
+				Result.OtherPos = false;
 			}
 			else
 			{
 				// Otherwise add the delta
-				Ret->Exact = true;
-				Ret->OtherPos = false;
+				Result.Exact = true;
+				Result.OtherPos = false;
 				Loc += GetU32(BaseDeltaArray[SubItem].ElementDelta);
 			}
 		}
 
-		Ret->ThisPos = EditUnit;
-		Ret->Location = Loc;
-		Ret->Offset = false;
-		Ret->KeyFrameOffset = 0;
-		Ret->TemporalOffset = 0;
-		Ret->KeyLocation = Ret->Location;
-		Ret->Flags = 0;
+		Result.ThisPos = EditUnit;
+		Result.Location = Loc;
+		Result.Offset = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = Result.Location;
+		Result.Flags = 0;
+
+		return;
+	}
 
-		return Ret;
+	// Use the flat index for main stream look-ups if we have one
+	if(FlatValid && (SubItem == 0))
+	{
+		if(FlatLookup(EditUnit, Result, Reorder)) return;
 	}
 
 	// Find the correct segment  - one starting with this edit unit, or the nearest before it
-	IndexSegmentMap::iterator it = SegmentMap.find(EditUnit);
+	IndexSegmentMap::const_iterator it = SegmentMap.find(EditUnit);
 	if(it == SegmentMap.end()) 
 	{ 
 		if(!SegmentMap.empty()) 
@@ -199,17 +299,17 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 	// If this position is before the start of the index table, return the start of the essence
 	if((it == SegmentMap.end()) || ((*it).first > EditUnit))
 	{
-		Ret->ThisPos = 0;
-		Ret->Location = 0;
-		Ret->Exact = false;
-		Ret->Offset = false;
-		Ret->OtherPos = false;
-		Ret->KeyFrameOffset = 0;
-		Ret->TemporalOffset = 0;
-		Ret->KeyLocation = 0;
-		Ret->Flags = 0;
+		Result.ThisPos = 0;
+		Result.Location = 0;
+		Result.Exact = false;
+		Result.Offset = false;
+		Result.OtherPos = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = 0;
+		Result.Flags = 0;
 
-		return Ret;
+		return;
 	}
 
 	// Build a segment pointer for ease of reading (very slight inefficiency)
@@ -220,23 +320,23 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 	{
 		error("IndexTableSegment contains no index entries!\n");
 
-		Ret->ThisPos = 0;
-		Ret->Location = 0;
-		Ret->Exact = false;
-		Ret->Offset = false;
-		Ret->OtherPos = false;
-		Ret->KeyFrameOffset = 0;
-		Ret->TemporalOffset = 0;
-		Ret->KeyLocation = 0;
-		Ret->Flags = 0;
+		Result.ThisPos = 0;
+		Result.Location = 0;
+		Result.Exact = false;
+		Result.Offset = false;
+		Result.OtherPos = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = 0;
+		Result.Flags = 0;
 
-		return Ret;
+		return;
 	}
 
 	// If the nearest (or lower) index point is before this edit unit, set the result accordingly
 	if((Segment->StartPosition + Segment->EntryCount - 1) < EditUnit)
 	{
-		Ret->ThisPos = Segment->StartPosition + Segment->EntryCount - 1;
+		Result.ThisPos = Segment->StartPosition + Segment->EntryCount - 1;
 		
 		// Index the start of the index entry
 		UInt8 *Ptr = &Segment->IndexEntryArray.Data[(Segment->EntryCount-1) * IndexEntrySize];
@@ -245,18 +345,18 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 		Ptr += 3;
 
 		// Read the location of the start of the edit unit
-		Ret->Location = GetU64(Ptr);
+		Result.Location = GetU64(Ptr);
 
 		// Set non-exact values
-		Ret->Exact = false;
-		Ret->OtherPos = true;
-		Ret->Offset = false;
-		Ret->KeyFrameOffset = 0;
-		Ret->TemporalOffset = 0;
-		Ret->KeyLocation = Ret->Location;
-		Ret->Flags = 0;
+		Result.Exact = false;
+		Result.OtherPos = true;
+		Result.Offset = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = Result.Location;
+		Result.Flags = 0;
 
-		return Ret;
+		return;
 	}
 
 	// Index the start of the correct index entry
@@ -269,44 +369,44 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 	// Apply temporal re-ordering if we should, but only if we have details of the exact sub-item
 	if(Reorder && (TemporalOffset != 0) && (Segment->DeltaCount == 0 || (SubItem < Segment->DeltaCount) && (Segment->DeltaArray[SubItem].PosTableIndex < 0)))
 	{
-		Ret = Lookup(EditUnit + TemporalOffset, SubItem, false);
-		Ret->TemporalOffset = TemporalOffset;
-		return Ret;
+		Lookup(EditUnit + TemporalOffset, Result, SubItem, false);
+		Result.TemporalOffset = TemporalOffset;
+		return;
 	}
 
 	// We are in the correct edit unit, so record the fact
-	Ret->ThisPos = EditUnit;
+	Result.ThisPos = EditUnit;
 
 	// Recorde the temporal offset
 	if (Segment->DeltaCount == 0 || (SubItem < Segment->DeltaCount) && (Segment->DeltaArray[SubItem].PosTableIndex < 0)) 
-		Ret->TemporalOffset = TemporalOffset;
+		Result.TemporalOffset = TemporalOffset;
 	else
-		Ret->TemporalOffset = 0;
+		Result.TemporalOffset = 0;
 
 	// Read the offset to the previous key-frame
-	Ret->KeyFrameOffset = GetI8(Ptr);
+	Result.KeyFrameOffset = GetI8(Ptr);
 	Ptr++;
 
 	// Read the flags for this frame
-	Ret->Flags = GetU8(Ptr);
+	Result.Flags = GetU8(Ptr);
 	Ptr++;
 
 	// Index the start of the keyframe index entry
 	// DRAGONS: Bit 3 int the flags means key-frame out of range
-	if( (Ret->Flags & 4) || ((-Ret->KeyFrameOffset) > (EditUnit - Segment->StartPosition) ))
+	if( (Result.Flags & 4) || ((-Result.KeyFrameOffset) > (EditUnit - Segment->StartPosition) ))
 	{
 		// Key Frame is in a different Index Table Segment (or is out of range)
-		Ret->KeyLocation = ~0;
+		Result.KeyLocation = ~0;
 	}
 	else
 	{
-		UInt8 *PKF = &Segment->IndexEntryArray.Data[(EditUnit - Segment->StartPosition - (-Ret->KeyFrameOffset)) * IndexEntrySize];
+		UInt8 *PKF = &Segment->IndexEntryArray.Data[(EditUnit - Segment->StartPosition - (-Result.KeyFrameOffset)) * IndexEntrySize];
 		PKF += 3;
-		Ret->KeyLocation = GetI64(PKF);
+		Result.KeyLocation = GetI64(PKF);
 	}
 
 	// Read the location of the start of the edit unit
-	Ret->Location = GetU64(Ptr);
+	Result.Location = GetU64(Ptr);
 	Ptr += 8;
 
 	// Note: At this point Ptr indexes the start of the SliceOffset array
@@ -314,16 +414,16 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 	// If we don't have details of the exact sub-item return the start of the edit unit
 	if( SubItem >= Segment->DeltaCount)
 	{
-		Ret->Exact = false;
-		Ret->OtherPos = false;
-		Ret->Offset = false;
+		Result.Exact = false;
+		Result.OtherPos = false;
+		Result.Offset = false;
 
-		return Ret;
+		return;
 	}
 
 	// We now have an exact match
-	Ret->Exact = true;
-	Ret->OtherPos = false;
+	Result.Exact = true;
+	Result.OtherPos = false;
 
 	// Locate this sub-item in the edit unit
 	if(SubItem > 0) 
@@ -333,11 +433,11 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 		if(Slice)
 		{
 			UInt8 *SlicePtr = Ptr + ((Slice - 1) * sizeof(UInt32));
-			Ret->Location += GetU32(SlicePtr);
+			Result.Location += GetU32(SlicePtr);
 		}
 
 		// Add the element delta
-		Ret->Location += GetU32(Segment->DeltaArray[SubItem].ElementDelta);
+		Result.Location += GetU32(Segment->DeltaArray[SubItem].ElementDelta);
 	}
 
 	// Sort the PosOffset if one is required
@@ -347,19 +447,179 @@ IndexPosPtr IndexTable::Lookup(Position EditUnit, int SubItem /* =0 */, bool Reo
 		// Index the correct PosTable entry for this sub-item
 		UInt8 *PosPtr = Ptr + (NSL * sizeof(UInt32)) + ((PosTableIndex - 1) * (sizeof(UInt32)*2) );
 
-		Ret->PosOffset.Numerator = GetI32(PosPtr);
+		Result.PosOffset.Numerator = GetI32(PosPtr);
 		PosPtr += 4;
-		Ret->PosOffset.Denominator = GetI32(PosPtr);
-		Ret->Offset = true;
+		Result.PosOffset.Denominator = GetI32(PosPtr);
+		Result.Offset = true;
 	}
 	else
-		Ret->Offset = false;
+		Result.Offset = false;
 
-	return Ret;
+	return;
 }
 
 
 
+//! Perform a main stream look-up using the flat index
+/*! This gives the same results as the segment based look-up in IndexTable::Lookup() for SubItem 0
+ *  \return false if the flat index cannot satisfy this look-up
+ */
+bool IndexTable::FlatLookup(Position EditUnit, IndexPos &Result, bool Reorder) const
+{
+	// Find the run starting with this edit unit, or the nearest before it
+	FlatIndexRun Key;
+	Key.Start = EditUnit;
+	std::vector<FlatIndexRun>::const_iterator it = std::upper_bound(FlatRuns.begin(), FlatRuns.end(), Key);
+
+	// If this position is before the start of the index table, return the start of the essence
+	if(it == FlatRuns.begin())
+	{
+		Result.ThisPos = 0;
+		Result.Location = 0;
+		Result.Exact = false;
+		Result.Offset = false;
+		Result.OtherPos = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = 0;
+		Result.Flags = 0;
+
+		return true;
+	}
+
+	const FlatIndexRun &Run = *(--it);
+
+	// If the nearest (or lower) index point is before this edit unit, set the result accordingly
+	if((Run.Start + Run.Count - 1) < EditUnit)
+	{
+		Result.ThisPos = Run.Start + Run.Count - 1;
+		Result.Location = FlatStreamOffset[Run.First + static_cast<size_t>(Run.Count - 1)];
+		Result.Exact = false;
+		Result.OtherPos = true;
+		Result.Offset = false;
+		Result.KeyFrameOffset = 0;
+		Result.TemporalOffset = 0;
+		Result.KeyLocation = Result.Location;
+		Result.Flags = 0;
+
+		return true;
+	}
+
+	size_t Entry = Run.First + static_cast<size_t>(EditUnit - Run.Start);
+
+	// Apply temporal re-ordering if we should
+	Int8 TemporalOffset = FlatTemporalOffset[Entry];
+	if(Reorder && (TemporalOffset != 0) && Run.Reorder)
+	{
+		Lookup(EditUnit + TemporalOffset, Result, 0, false);
+		Result.TemporalOffset = TemporalOffset;
+		return true;
+	}
+
+	Result.ThisPos = EditUnit;
+	Result.TemporalOffset = Run.Reorder ? TemporalOffset : 0;
+	Result.KeyFrameOffset = FlatKeyOffset[Entry];
+	Result.Flags = FlatFlags[Entry];
+	Result.Location = FlatStreamOffset[Entry];
+
+	// Locate the keyframe, unless it is in a different segment (or is out of range)
+	if( (Result.Flags & 4) || ((-Result.KeyFrameOffset) > (EditUnit - Run.Start) ))
+		Result.KeyLocation = ~0;
+	else
+		Result.KeyLocation = FlatStreamOffset[Entry + Result.KeyFrameOffset];
+
+	Result.Exact = Run.Exact;
+	Result.OtherPos = false;
+	Result.Offset = false;
+
+	return true;
+}
+
+
+//! Build a compact contiguous copy of the main stream index entries to speed up look-ups
+bool IndexTable::Flatten(void)
+{
+	ClearFlat();
+
+	// CBR tables are looked-up arithmetically anyway
+	if(EditUnitByteCount)
+	{
+		FlatValid = true;
+		return true;
+	}
+
+	// Count the entries so that we can size the arrays in one go
+	size_t Total = 0;
+	IndexSegmentMap::iterator it = SegmentMap.begin();
+	while(it != SegmentMap.end())
+	{
+		IndexSegmentPtr &Segment = (*it).second;
+
+		// We can't flatten empty segments (which shouldn't exist) or those with a PosTable entry for the main stream
+		if(Segment->EntryCount == 0) return false;
+		if((Segment->DeltaCount > 0) && (Segment->DeltaArray[0].PosTableIndex > 0)) return false;
+
+		Total += Segment->EntryCount;
+		it++;
+	}
+
+	FlatRuns.reserve(SegmentMap.size());
+	FlatStreamOffset.resize(Total);
+	FlatFlags.resize(Total);
+	FlatTemporalOffset.resize(Total);
+	FlatKeyOffset.resize(Total);
+
+	size_t Entry = 0;
+	it = SegmentMap.begin();
+	while(it != SegmentMap.end())
+	{
+		IndexSegmentPtr &Segment = (*it).second;
+
+		FlatIndexRun Run;
+		Run.Start = (*it).first;
+		Run.Count = Segment->EntryCount;
+		Run.First = Entry;
+		Run.Exact = (Segment->DeltaCount > 0);
+		Run.Reorder = (Segment->DeltaCount == 0) || (Segment->DeltaArray[0].PosTableIndex < 0);
+		FlatRuns.push_back(Run);
+
+		UInt8 *Ptr = Segment->IndexEntryArray.Data;
+		int i;
+		for(i=0; i<Segment->EntryCount; i++)
+		{
+			FlatTemporalOffset[Entry] = GetI8(Ptr);
+			FlatKeyOffset[Entry] = GetI8(&Ptr[1]);
+			FlatFlags[Entry] = GetU8(&Ptr[2]);
+			FlatStreamOffset[Entry] = GetU64(&Ptr[3]);
+
+			Ptr += IndexEntrySize;
+			Entry++;
+		}
+
+		it++;
+	}
+
+	FlatValid = true;
+	return true;
+}
+
+
+//! Discard any flat index, freeing its memory
+void IndexTable::ClearFlat(void)
+{
+	if(!FlatValid) return;
+
+	FlatValid = false;
+
+	// DRAGONS: Swap with empty vectors as clear() need not free the memory
+	std::vector<FlatIndexRun>().swap(FlatRuns);
+	std::vector<UInt64>().swap(FlatStreamOffset);
+	std::vector<UInt8>().swap(FlatFlags);
+	std::vector<Int8>().swap(FlatTemporalOffset);
+	std::vector<Int8>().swap(FlatKeyOffset);
+}
+
+
 //! Add an index table segment from an "IndexSegment" MDObject
 /*! DRAGONS: Not the most efficient way to do this */
 IndexSegmentPtr IndexTable::AddSegment(MDObjectPtr Segment)
@@ -397,23 +657,13 @@ IndexSegmentPtr IndexTable::AddSegment(MDObjectPtr Segment)
 			// Free any old delta array
 			if(BaseDeltaCount) delete[] BaseDeltaArray; 
 
-			BaseDeltaCount = static_cast<int>(Ptr->size());
-			BaseDeltaArray = new DeltaEntry[BaseDeltaCount];
-
-			int Delta = 0;
-			MDObjectULList::iterator it = Ptr->begin();
-			while(it != Ptr->end())
-			{
-				BaseDeltaArray[Delta].PosTableIndex = (*it).second[0]->GetInt();
-				BaseDeltaArray[Delta].Slice = (*it).second[1]->GetUInt();
-				PutU32((*it).second[2]->GetUInt(), BaseDeltaArray[Delta].ElementDelta);
-
-				it++;
-				Delta++;
-			}
-			if(Delta != BaseDeltaCount)
+			BaseDeltaCount = ReadDeltaEntries(Ptr, BaseDeltaArray);
+			if(BaseDeltaCount < 0)
 			{
 				error("Malformed DeltaEntryArray in %s at %s\n", Segment->FullName().c_str(), Segment->GetSourceLocation().c_str());
+				delete[] BaseDeltaArray;
+				BaseDeltaArray = NULL;
+				BaseDeltaCount = 0;
 			}
 		}
 	}
@@ -429,24 +679,13 @@ IndexSegmentPtr IndexTable::AddSegment(MDObjectPtr Segment)
 		}
 		else
 		{
-			Ret->DeltaCount = static_cast<int>(Ptr->Value->size());
-
-			Ret->DeltaArray = new DeltaEntry[Ret->DeltaCount];
-			
-			int Delta = 0;
-			MDObjectULList::iterator it = Ptr->begin();
-			while(it != Ptr->end())
-			{
-				Ret->DeltaArray[Delta].PosTableIndex = (*it).second[0]->GetInt();
-				Ret->DeltaArray[Delta].Slice = (*it).second[1]->GetUInt();
-				PutU32((*it).second[2]->GetUInt(), Ret->DeltaArray[Delta].ElementDelta);
-
-				it++;
-				Delta++;
-			}
-			if(Delta != Ret->DeltaCount)
+			Ret->DeltaCount = ReadDeltaEntries(Ptr, Ret->DeltaArray);
+			if(Ret->DeltaCount < 0)
 			{
 				error("Malformed DeltaEntryArray in %s at %s\n", Segment->FullName().c_str(), Segment->GetSourceLocation().c_str());
+				delete[] Ret->DeltaArray;
+				Ret->DeltaArray = NULL;
+				Ret->DeltaCount = 0;
 			}
 		}
 
@@ -501,9 +740,15 @@ IndexSegmentPtr IndexTable::AddSegment(MDObjectPtr Segment)
 
 
 //! Add an index table segment from a raw DataChunk containing a section of un-parsed index table data
-/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions */
-void IndexTable::AddSegments(DataChunkPtr &IndexChunk)
+/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions
+ *  \param IndexChunk The index table segments, and any filler between them
+ *  \param Info If not NULL, a summary of each segment is appended to this list
+ *  \return false if the data was not entirely valid index table segments and filler
+ */
+bool IndexTable::AddSegments(DataChunkPtr &IndexChunk, IndexSegmentInfoList *Info /*=NULL*/)
 {
+	bool Ret = true;
+
 	UInt8 const *pData = IndexChunk->Data;
 	Length Size = IndexChunk->Size;
 
@@ -523,16 +768,25 @@ void IndexTable::AddSegments(DataChunkPtr &IndexChunk)
 			error("KLV group with key %s claims to have a value with size %s, but remaining bytes = %s, in IndexTable::AddSegments()\n", 
 				  SetKey.GetString().c_str(), Int64toString((Int64)SetLength).c_str(), Int64toString((Int64)Size).c_str());
 			SetLength = Size;
+			Ret = false;
 		}
 
 		if(SetKey.Matches(IndexTableSegment_UL))
 		{
 //printf("%s is 0x%04x bytes at %p\n", SetKey.GetString().c_str(), (int)SetLength, pData);
-			AddSegment(pData, SetLength, 2);
+			if(Info)
+			{
+				IndexSegmentInfo ThisInfo;
+				AddSegment(pData, SetLength, 2, &ThisInfo);
+				Info->push_back(ThisInfo);
+			}
+			else
+				AddSegment(pData, SetLength, 2);
 		}
 		else if(!SetKey.Matches(KLVFill_UL))
 		{
 			warning("Unexpected data with key %s found in bytes passed to IndexTable::AddSegments()\n", SetKey.GetString().c_str());
+			Ret = false;
 		}
 
 		pData += SetLength;
@@ -542,12 +796,18 @@ void IndexTable::AddSegments(DataChunkPtr &IndexChunk)
 	if(Size != 0)
 	{
 		warning("%d extra byte%s found after parsing all index table data in IndexTable::AddSegments()\n", (int)Size, Size == 1 ? "" : "s" );
+		Ret = false;
 	}
+
+	return Ret;
 }
 
 //! Add an index table segment from a raw DataChunk containing an un-parsed "IndexSegment"
-/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions */
-IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int LenSize /*=2*/)
+/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions
+ *  \param Info If not NULL, this is filled with a summary of the segment
+ *  \return The segment added, or NULL if this was a CBR index segment
+ */
+IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int LenSize /*=2*/, IndexSegmentInfo *Info /*=NULL*/)
 {
 	IndexSegmentPtr Ret;
 
@@ -695,6 +955,9 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 		Size -= ItemSize;
 	}
 
+	// DRAGONS: The size is used up as the delta entries are read, so note if there are any now
+	bool HaveDeltas = (DeltaEntryArraySize >= 8);
+
 	if( EditUnitByteCount ) // CBR
 	{
 		this->EditUnitByteCount = EditUnitByteCount;
@@ -707,7 +970,11 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 			DeltaEntryArraySize -= 8;
 			pDeltaEntryArray += 8;
 
-			if(ItemSize < 6)
+			if(ItemCount == 0)
+			{
+				// An empty array, so the entry size does not matter (some writers give 0)
+			}
+			else if(ItemSize < 6)
 			{
 				error("Malformed DeltaEntryArray, minimum size of each entry is 6 bytes, but this instance claims Length = %u\n", ItemSize);
 			}
@@ -748,7 +1015,7 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 	{
 		Ret = AddSegment(StartPosition);
 
-		if(DeltaEntryArraySize == 0)
+		if(DeltaEntryArraySize < 8)
 		{
 			Ret->DeltaCount = 0;
 		}
@@ -759,7 +1026,12 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 			DeltaEntryArraySize -= 8;
 			pDeltaEntryArray += 8;
 
-			if(ItemSize < 6)
+			if(ItemCount == 0)
+			{
+				// An empty array, so the entry size does not matter (some writers give 0)
+				Ret->DeltaCount = 0;
+			}
+			else if(ItemSize < 6)
 			{
 				error("Malformed DeltaEntryArray, minimum size of each entry is 6 bytes, but this instance claims Length = %u\n", ItemSize);
 				Ret->DeltaCount = 0;
@@ -839,7 +1111,7 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 		}
 		else
 		{
-			if(IndexEntryArraySize >= 28)
+			if(IndexEntryArraySize >= 8)
 			{
 				UInt32 EntryCount = GetU32(pIndexEntryArray);
 				UInt32 EntrySize = GetU32(&pIndexEntryArray[4]);
@@ -848,11 +1120,29 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 				{
 					error("IndexEntryArray items should be %d bytes, but are %d\n", IndexEntrySize, EntrySize);
 				}
-				else Ret->AddIndexEntries(EntryCount, IndexEntrySize, &pIndexEntryArray[8]);
+				else
+				{
+					if((static_cast<Length>(EntryCount) * EntrySize) > (IndexEntryArraySize - 8))
+					{
+						error("Malformed IndexEntryArray, claims %u entries but only has room for %u\n", EntryCount, static_cast<UInt32>((IndexEntryArraySize - 8) / EntrySize));
+						EntryCount = static_cast<UInt32>((IndexEntryArraySize - 8) / EntrySize);
+					}
+
+					Ret->AddIndexEntries(EntryCount, IndexEntrySize, &pIndexEntryArray[8]);
+				}
 			}
 		}
 	} // CBR,VBR
 
+	if(Info)
+	{
+		Info->StartPosition = (StartPosition < 0) ? 0 : StartPosition;
+		Info->Duration = (Duration < 0) ? 0 : Duration;
+		Info->IndexSID = IndexSID;
+		Info->BodySID = BodySID;
+		Info->DeltaCount = Ret ? Ret->DeltaCount : (HaveDeltas ? BaseDeltaCount : 0);
+	}
+
 	return Ret;
 }
 
@@ -860,7 +1150,10 @@ IndexSegmentPtr IndexTable::AddSegment(UInt8 const *pSegment, Length Size, int L
 //! Create a new empty index table segment
 IndexSegmentPtr IndexTable::AddSegment(Int64 StartPosition)
 {
+	ClearFlat();
+
 	IndexSegmentPtr Segment = IndexSegment::AddIndexSegmentToIndexTable(this, StartPosition);
+	if(SegmentCapacity) Segment->ReserveEntries(SegmentCapacity);
 
 	SegmentMap.insert(IndexSegmentMap::value_type(StartPosition, Segment));
 
@@ -889,13 +1182,14 @@ bool IndexSegment::AddIndexEntry(Int8 TemporalOffset, Int8 KeyFrameOffset, UInt8
 		return false;
 	}
 
-	// Calculate the new size to see if it is too big for a 2-byte local local set length
-	int NewSize = ((EntryCount+1) * Parent->IndexEntrySize + 8);
-
-		if(NewSize > 0xffff) 
-			return false;
+	// Check that there is room for another entry within a 2-byte local set length
+	if(GetFreeEntries() < 1) return false;
 
-	UInt8 *Buffer = new UInt8[Parent->IndexEntrySize];
+	// Extend the Index Entry Array and build the new entry at its end
+	GrowEntryArray(1);
+	size_t Offset = IndexEntryArray.Size;
+	IndexEntryArray.Resize(Offset + Parent->IndexEntrySize);
+	UInt8 *Buffer = &IndexEntryArray.Data[Offset];
 
 	// Write the new entry
 	Buffer[0] = (UInt8) TemporalOffset;
@@ -917,20 +1211,16 @@ bool IndexSegment::AddIndexEntry(Int8 TemporalOffset, Int8 KeyFrameOffset, UInt8
 	for(i=0; i<PosCount; i++)
 	{
 		PutI32(PosPtr->Numerator, Ptr);
-		PutI32(PosPtr->Denominator, Ptr);
+		PutI32(PosPtr->Denominator, &Ptr[4]);
 		PosPtr++;
 		Ptr += 8;
 	}
 
-	// Add this entry to the end of the Index Entry Array
-	IndexEntryArray.Set(Parent->IndexEntrySize, Buffer, IndexEntryArray.Size);
+	Parent->ClearFlat();
 
 	// Increment the count
 	EntryCount++;
 
-	// Free the buffer
-	delete[] Buffer;
-
 	return true;
 }
 
@@ -946,9 +1236,8 @@ bool IndexSegment::AddIndexEntries(int Count, int Size, UInt8 const *Entries)
 		return false;
 	}
 
-	// Calculate the new size to see if it is too big for a 2-byte local local set length
-	int NewSize = (EntryCount * Parent->IndexEntrySize) + (Count * Size);
-	if(NewSize > 0xffff) return false;
+	// Check that the entries will fit within a 2-byte local set length
+	if(Count > GetFreeEntries()) return false;
 
 // diagnostics
 #ifdef MXFLIB_DEBUG
@@ -972,7 +1261,9 @@ bool IndexSegment::AddIndexEntries(int Count, int Size, UInt8 const *Entries)
 	}
 #endif // MXFLIB_DEBUG
 
+	GrowEntryArray(Count);
 	IndexEntryArray.Set(Size * Count, Entries, IndexEntryArray.Size);
+	Parent->ClearFlat();
 
 	// Increment the count
 	EntryCount += Count;
@@ -981,6 +1272,46 @@ bool IndexSegment::AddIndexEntries(int Count, int Size, UInt8 const *Entries)
 }
 
 
+//! Get the number of entries that may be added before this segment reaches its maximum size
+int IndexSegment::GetFreeEntries(void)
+{
+	mxflib_assert(Parent);
+
+	return (MaxIndexEntryArraySize / static_cast<int>(Parent->IndexEntrySize)) - EntryCount;
+}
+
+
+//! Reserve buffer space for a number of entries in total, limited to the maximum size of a segment
+void IndexSegment::ReserveEntries(int Count)
+{
+	mxflib_assert(Parent);
+
+	int MaxEntries = MaxIndexEntryArraySize / static_cast<int>(Parent->IndexEntrySize);
+	if(Count > MaxEntries) Count = MaxEntries;
+
+	size_t Bytes = static_cast<size_t>(Count) * Parent->IndexEntrySize;
+	if(Bytes > IndexEntryArray.GetBufferSize()) IndexEntryArray.ResizeBuffer(Bytes);
+}
+
+
+//! Make room in the buffer for Count more entries, growing it geometrically to limit re-allocation
+void IndexSegment::GrowEntryArray(int Count)
+{
+	size_t Needed = IndexEntryArray.Size + static_cast<size_t>(Count) * Parent->IndexEntrySize;
+	if(Needed <= IndexEntryArray.GetBufferSize()) return;
+
+	// Double the number of entries each time, but never past the most that will fit in the segment
+	int Entries = 2 * EntryCount;
+	if(Entries < InitialSegmentEntries) Entries = InitialSegmentEntries;
+	if(Entries < (EntryCount + Count)) Entries = EntryCount + Count;
+
+	ReserveEntries(Entries);
+
+	// DRAGONS: ReserveEntries() limits the size to a full segment, which callers should already have checked, but we must not overflow
+	if(Needed > IndexEntryArray.GetBufferSize()) IndexEntryArray.ResizeBuffer(Needed);
+}
+
+
 //! Index segment pseudo-constructor
 /*! \note <b>Only</b> call this from IndexTable::AddSegment() because it adds the segment to its SegmentMap */
 IndexSegmentPtr IndexSegment::AddIndexSegmentToIndexTable(IndexTablePtr ParentTable, Int64 IndexStartPosition)
@@ -1179,6 +1510,8 @@ size_t IndexTable::WriteIndex(DataChunk &Buffer)
 //! Fudge to correct index entry
 void IndexTable::Correct(Position EditUnit, Int8 TemporalOffset, Int8 KeyFrameOffset, UInt8 Flags)
 {
+	ClearFlat();
+
 	// Find the correct segment  - one starting with this edit unit, or the nearest before it
 	IndexSegmentMap::iterator it = SegmentMap.find(EditUnit);
 	if(it == SegmentMap.end()) 
@@ -1273,58 +1606,84 @@ void IndexSegment::Update(Position EditUnit, UInt64 StreamOffset)
 	// Write the stream offset for this frame
 	PutU64(StreamOffset,Ptr);
 
+	Parent->ClearFlat();
+
 	return;
 }
 
 
 
 
+//! Make room for entries from FirstPosition - Before to FirstPosition + Count - 1, clearing any new entries
+/*! The ring is grown if required, which only happens if entries are not committed often enough
+ */
+void ReorderIndex::MakeRoom(int Before, int Count)
+{
+	int Needed = Before + ((Count > EntryCount) ? Count : EntryCount);
+
+	if(Needed > Capacity)
+	{
+		int NewCapacity = Capacity * 2;
+		while(NewCapacity < Needed) NewCapacity *= 2;
+
+		// Unwrap the existing entries to the start of the new ring
+		DataChunk NewEntries;
+		NewEntries.Resize(NewCapacity * IndexEntrySize);
+
+		int i;
+		for(i = 0; i < EntryCount; i++) memcpy(&NewEntries.Data[i * IndexEntrySize], GetEntry(i), IndexEntrySize);
+
+		IndexEntries.TakeBuffer(NewEntries);
+		Capacity = NewCapacity;
+		Head = 0;
+	}
+
+	if(Before)
+	{
+		Head = (Head + Capacity - Before) % Capacity;
+
+		int i;
+		for(i = 0; i < Before; i++) memset(GetEntry(i), 0, IndexEntrySize);
+
+		if(CompleteEntryCount) CompleteEntryCount += Before;
+		EntryCount += Before;
+		FirstPosition -= Before;
+	}
+
+	// Clear any new entries so that their temporal offsets are zero until set
+	while(EntryCount < Count)
+	{
+		memset(GetEntry(EntryCount), 0, IndexEntrySize);
+		EntryCount++;
+	}
+}
+
+
 //! Add a new entry to the table (setting flags and anchor offset)
 bool ReorderIndex::SetEntry(Position Pos, UInt8 Flags, Int8 AnchorOffset, UInt8 *Tables /*=NULL*/ )
 {
 	// If this is the first entry we have added to the table set FirstPosition
-	if(IndexEntries.Size == 0)
+	if(EntryCount == 0)
 	{
 		FirstPosition = Pos;
 	}
 	// Otherwise see if we are trying to add an entry before the start
 	else if(Pos < FirstPosition)
 	{
-		// How far do we need to shift the data
-		Int64 Shift = (FirstPosition - Pos) * IndexEntrySize;
-
-		// Make enought room
-		IndexEntries.Resize((UInt32)(IndexEntries.Size + Shift));
-
-		// Shift the entries forwards
-		memmove(&IndexEntries.Data[Shift], IndexEntries.Data, EntryCount * IndexEntrySize);
-
-		// Adjust the counts
-		if(CompleteEntryCount) CompleteEntryCount += (int)(FirstPosition - Pos);
-		EntryCount += (int)(FirstPosition - Pos);
-		
-		// And the start position
-		FirstPosition = Pos;
+		MakeRoom(int(FirstPosition - Pos), 0);
 	}
 
 	// Index this entry
 	int Entry = int(Pos - FirstPosition);
 	
 	// Update the count
-	if(Entry >= EntryCount)
-	{
-		IndexEntries.Resize((Entry+1) * IndexEntrySize);
-		EntryCount = Entry + 1;
-	}
+	if(Entry >= EntryCount) MakeRoom(0, Entry + 1);
 
 	// And the complete count
 	if(Entry >= CompleteEntryCount) CompleteEntryCount = Entry + 1;
 
 	// Index the start of the entry
-	UInt8 *EntryPtr = &IndexEntries.Data[Entry * IndexEntrySize];
-
-	// Clear the temporal offset if it hasn't yet been set
-	if(Entry >= EntryCount) *EntryPtr = 0;
+	UInt8 *EntryPtr = GetEntry(Entry);
 
 	// Updata the data
 	EntryPtr[1] = AnchorOffset;
@@ -1365,11 +1724,8 @@ bool ReorderIndex::SetStreamOffset(Position Pos, Position StreamOffset)
 		return false;
 	}
 
-	// Index the start of the entry
-	UInt8 *EntryPtr = &IndexEntries.Data[Entry * IndexEntrySize];
-
 	// Updata the data
-	PutI64(StreamOffset, &EntryPtr[3]);
+	PutI64(StreamOffset, &GetEntry(Entry)[3]);
 
 	return true;
 }
@@ -1379,45 +1735,24 @@ bool ReorderIndex::SetStreamOffset(Position Pos, Position StreamOffset)
 bool ReorderIndex::SetTemporalOffset(Position Pos, Int8 TemporalOffset)
 {
 	// If this is the first entry we have added to the table set FirstPosition
-	if(IndexEntries.Size == 0)
+	if(EntryCount == 0)
 	{
 		FirstPosition = Pos;
 	}
 	// Otherwise see if we are trying to add an entry before the start
 	else if(Pos < FirstPosition)
 	{
-		// How far do we need to shift the data
-		Int64 Shift = (FirstPosition - Pos) * IndexEntrySize;
-
-		// Make enought room
-		IndexEntries.Resize((UInt32)(IndexEntries.Size + Shift));
-
-		// Shift the entries forwards
-		memmove(&IndexEntries.Data[Shift], IndexEntries.Data, EntryCount * IndexEntrySize);
-
-		// Adjust the counts
-		if(CompleteEntryCount) CompleteEntryCount += (int)(FirstPosition - Pos);
-		EntryCount +=(int) (FirstPosition - Pos);
-		
-		// And the start position
-		FirstPosition = Pos;
+		MakeRoom(int(FirstPosition - Pos), 0);
 	}
 
 	// Index this entry
 	int Entry = int(Pos - FirstPosition);
 	
 	// Update the count
-	if(Entry >= EntryCount)
-	{
-		IndexEntries.Resize((Entry+1) * IndexEntrySize);
-		EntryCount = Entry + 1;
-	}
+	if(Entry >= EntryCount) MakeRoom(0, Entry + 1);
 	
-	// Index the start of the entry
-	UInt8 *EntryPtr = &IndexEntries.Data[Entry * IndexEntrySize];
-
 	// Set the temporal offset
-	*EntryPtr = TemporalOffset;
+	*GetEntry(Entry) = TemporalOffset;
 
 	return true;
 }
@@ -1429,52 +1764,68 @@ bool ReorderIndex::SetTemporalOffset(Position Pos, Int8 TemporalOffset)
  *        TemporalOffsets set so the caller must ensure it only asks us to commit those
  *		  entries that are certain to be totally complete. One possible strategy is to
  *		  always leave at least 128 entries in the table until the end of processing as
- *		  the temporal offsets cannot reach further than 128 backwards.
+ *		  the temporal offsets cannot reach further than 128 backwards, or to use CommitGOPs().
  */
 Int32 ReorderIndex::CommitEntries(IndexTablePtr Index, Int32 Count /*=-1*/)
 {
-	IndexSegmentPtr Segment = Index->GetSegment(FirstPosition);
+	TraceScope Trace("ReorderIndex::CommitEntries", "index");
 
 	// Note that we only commit complete entries
 	if((Count < 0) || (Count > CompleteEntryCount)) Count = CompleteEntryCount;
-	
-	if(!Segment->AddIndexEntries(Count, IndexEntrySize, IndexEntries.Data))
+	if(Count == 0) return 0;
+
+	// The entries are added in at most two runs, as the range may wrap around the end of the ring
+	// DRAGONS: The index table starts new segments as required so we can't burst the 64k limit
+	int FirstRun = Capacity - Head;
+	if(FirstRun > Count) FirstRun = Count;
+
+	bool Ok = Index->AddIndexEntries(FirstPosition, FirstRun, IndexEntrySize, GetEntry(0));
+	if(Ok && (FirstRun < Count)) Ok = Index->AddIndexEntries(FirstPosition + FirstRun, Count - FirstRun, IndexEntrySize, GetEntry(FirstRun));
+
+	if(!Ok)
 	{
-		// DRAGONS: This will happen when we burst the 64k limit!
-		error("Problem in call to IndexSegment::AddIndexEntries from ReorderIndex::CommitEntries\n");
+		error("Problem in call to IndexTable::AddIndexEntries from ReorderIndex::CommitEntries\n");
 
 		return 0;
 	}
 
-	// Shuffle data back in data chunk (or clear it)
+	// Drop the committed entries from the ring
 	if(EntryCount <= Count) 
 	{
 		EntryCount = 0;
 		CompleteEntryCount = 0;
 		FirstPosition = 0;
-		IndexEntries.Resize(0);
+		Head = 0;
 	}
 	else
 	{
-		// How far do we need to shift the data
-		Int64 Shift = Count * IndexEntrySize;
+		Head = (Head + Count) % Capacity;
+		EntryCount -= Count;
+		CompleteEntryCount -= Count;
+		FirstPosition += Count;
+	}
 
-		Int32 NewCount = EntryCount - Count;
+	return Count;
+}
 
-		// Shift the entries backwards
-		memmove(IndexEntries.Data, &IndexEntries.Data[Shift], NewCount * IndexEntrySize);
 
-		// Adjust the counts
-		if(CompleteEntryCount > NewCount) CompleteEntryCount -= NewCount; else CompleteEntryCount = 0;
-		if(EntryCount > NewCount) EntryCount -= NewCount; else EntryCount = 0;
-		
-		// And the start position
-		if(FirstPosition > NewCount) FirstPosition -= NewCount; else FirstPosition = 0;
+//! Commit all whole GOPs whose temporal offsets can no longer change to the specified index table
+/*! Entries are committed up to, but not including, the latest random access entry that is at least MaxReorder entries
+ *  before the end of the complete entries, so each call adds one run of whole GOPs to the index table.
+ *  \return The number of entries committed
+ */
+Int32 ReorderIndex::CommitGOPs(IndexTablePtr Index)
+{
+	int Limit = CompleteEntryCount - MaxReorder;
 
-		IndexEntries.Resize((EntryCount+1) * IndexEntrySize);
+	int Entry;
+	for(Entry = Limit; Entry > 0; Entry--)
+	{
+		// Bit 7 of the flags marks a random access entry
+		if(GetEntry(Entry)[2] & 0x80) return CommitEntries(Index, Entry);
 	}
 
-	return Count;
+	return 0;
 }
 
 
@@ -1921,15 +2272,22 @@ bool IndexManager::OfferKeyOffset(Position EditUnit, int Offset)
 #define ManagedDataArrayGranularity 1024		// Number of extra entries to add when creating or extending-up the array
 
 //! Flush index data to free memory
-/*! \note The array is not resized (unless it is totally cleared) so this will not gain much when flushing the end of the array. 
- *        If the beginning of the array is flushed the data is shuffled down allowing more new entries to be added to the end before resizing.
+/*! All managed entries from FirstEditUnit to LastEditUnit inclusive are discarded, and can no longer be added to an index table.
+ *  This allows a long stream to be indexed in a fixed amount of memory by flushing each range once it has been written.
+ *  \note If reordering is used the entries for up to 128 edit units after the last one written may still receive temporal offsets
+ *        for edit units before it, so the caller should keep that margin unflushed
  */
 void IndexManager::Flush(Position FirstEditUnit, Position LastEditUnit)
 {
 	// No need for a CBR index table
 	if(DataIsCBR) return;
 
-	error("IndexManager::Flush() not yet implemented\n");
+	std::map<Position, IndexData*>::iterator it = ManagedData.lower_bound(FirstEditUnit);
+	while((it != ManagedData.end()) && ((*it).first <= LastEditUnit))
+	{
+		delete[] (UInt8*)(*it).second;
+		ManagedData.erase(it++);
+	}
 }
 
 
@@ -1980,6 +2338,8 @@ IndexTablePtr IndexManager::MakeIndex(void)
 /*! \return Number of index entries added */
 int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Position FirstEditUnit /*=IndexLowest*/, Position LastEditUnit /*=UINT64_C(0x7fffffffffffffff)*/)
 {
+	TraceScope Trace("IndexManager::AddEntriesToIndex", "index");
+
 	// Count of number of index table entries added
 	int Ret = 0;
 
@@ -1994,13 +2354,8 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 	// No data to add
 	if((it == ManagedData.end()) || ((*it).first > LastEditUnit)) return Ret;
 
-	// Set up SliceOffsets and PosTable arrays
 	int NSL = Index->NSL;
-	UInt32 *SliceOffsets = NULL;
-	if(NSL) SliceOffsets = new UInt32[NSL];
 	int NPE = Index->NPE;
-	Rational *PosTable = NULL;
-	if(NPE) PosTable = new Rational[NPE];
 
 	// Undo any reordering set in the index table if requested to undo reordering
 	if(UsesReordering && UndoReorder)
@@ -2017,8 +2372,6 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 	{
 		error("PosTable not currently supported by IndexManager\n");
 		NPE = 0;
-		delete[] PosTable;
-		PosTable = NULL;
 	}
 
 	// Which bits in the status word show we can use the entry?
@@ -2026,11 +2379,19 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 	if(UsesReordering) StatusTest = 0x03; else StatusTest = 0x01;
 	if(UndoReorder) StatusTest |= 0x04;
 
+	// Entries for runs of consecutive edit units are built in a batch and added to the index together
+	const int EntrySize = 11 + 4*NSL;
+	const int MaxBatch = 8192;
+
+	DataChunk Batch;
+	Batch.ResizeBuffer(EntrySize * ((ManagedData.size() < static_cast<size_t>(MaxBatch)) ? ManagedData.size() : MaxBatch));
+	Position BatchStart = 0;
+	int BatchCount = 0;
+
 	// Loop until out of entries
 	while((*it).first <= LastEditUnit)
 	{
 		IndexData *ThisEntry = (*it).second;
-		int Slice = 0;
 
 		Position StreamPos = ThisEntry->StreamOffset[0];
 
@@ -2041,23 +2402,43 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 			continue;
 		}
 
+		// Determine the edit unit to add
+		Position ThisEditUnit = (*it).first;
+		if(UndoReorder) ThisEditUnit += ThisEntry->TemporalDiff;
+
+		// Add the current batch if this entry does not follow on from it, or it is full
+		if(BatchCount && ((ThisEditUnit != (BatchStart + BatchCount)) || (BatchCount == MaxBatch)))
+		{
+			Index->AddIndexEntries(BatchStart, BatchCount, EntrySize, Batch.Data);
+			BatchCount = 0;
+		}
+
+		if(!BatchCount) BatchStart = ThisEditUnit;
+
+		// Build this entry at the end of the batch
+		Batch.Resize((BatchCount + 1) * EntrySize);
+		UInt8 *Ptr = &Batch.Data[BatchCount * EntrySize];
+
+		Ptr[0] = static_cast<UInt8>(ThisEntry->TemporalOffset);
+		Ptr[1] = static_cast<UInt8>(ThisEntry->KeyOffset);
+		Ptr[2] = static_cast<UInt8>(ThisEntry->Flags);
+		PutU64(ThisEntry->StreamOffset[0], &Ptr[3]);
+		Ptr += 11;
+
 		// Build the slice table
+		// DRAGONS: Slice offsets of any missing entries are left as zero, which is not very good, but what else do we do
+		// FIXME: Scan forwards to find the next indexed item to calculate the correct slice offset for a zero size object
+		if(NSL) memset(Ptr, 0, 4*NSL);
+
+		int Slice = 0;
 		int i;
 		for(i=0; i<(StreamCount-1); i++)
 		{
 			if( ElementSizeList[i] == 0) // VBR - next Stream will be start of next Slice
 			{
 				Position NextPos = ThisEntry->StreamOffset[i+1];
-				
-				if(NextPos >= StreamPos) 
-					SliceOffsets[Slice]=(UInt32)(NextPos - StreamPos);
-				else
-				{
-					// Write zero in the slice offset of any missing entry
-					// DRAGONS: this is not very good, but what else do we do
-					// FIXME: Scan forwards to find the next indexed item to calculate the correct slice offset for a zero size object
-					SliceOffsets[Slice]=0;
-				}
+
+				if((NextPos >= StreamPos) && (Slice < NSL)) PutU32(static_cast<UInt32>(NextPos - StreamPos), &Ptr[4*Slice]);
 
 				Slice++;
 			}
@@ -2065,14 +2446,7 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 			// DRAGONS: Not supporting PosTable yet!
 		}
 
-		// Determine the edit unit to add
-		Position ThisEditUnit = (*it).first;
-		if(UndoReorder) ThisEditUnit += ThisEntry->TemporalDiff;
-
-		{
-			// Add this new entry (carry FirstEditUnit up with us as we go)
-			Index->AddIndexEntry(ThisEditUnit, ThisEntry->TemporalOffset, ThisEntry->KeyOffset, ThisEntry->Flags, ThisEntry->StreamOffset[0], NSL, SliceOffsets, NPE, PosTable);
-		}
+		BatchCount++;
 
 		// Maintain count of entries
 		Ret++;
@@ -2081,8 +2455,8 @@ int IndexManager::AddEntriesToIndex(bool UndoReorder, IndexTablePtr Index, Posit
 		if(++it == ManagedData.end()) break;
 	}
 
-	if(NSL) delete[] SliceOffsets;
-	if(NPE) delete[] PosTable;
+	// Add the last batch
+	if(BatchCount) Index->AddIndexEntries(BatchStart, BatchCount, EntrySize, Batch.Data);
 
 	return Ret;
 }
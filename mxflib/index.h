@@ -74,6 +74,16 @@ namespace mxflib
 	//! Map of edit unit positions to index table segemnts
 	typedef std::map<Position, IndexSegmentPtr> IndexSegmentMap;
 
+	//! Summary of an index table segment as read from raw index table data
+	struct IndexSegmentInfo
+	{
+		Position StartPosition;			//!< The first edit unit indexed by the segment
+		Length Duration;				//!< The number of edit units indexed, or zero for a CBR index of the whole essence container
+		UInt32 IndexSID;				//!< The IndexSID of the segment
+		UInt32 BodySID;					//!< The BodySID of the essence indexed
+		int DeltaCount;					//!< The number of entries in the segment's DeltaEntryArray, one per element of each edit unit
+	};
+
 	//! Class for holding index entries that may be out of order
 	class IndexEntry : public RefCount<IndexEntry>
 	{
@@ -100,7 +110,10 @@ namespace mxflib
 	class ReorderIndex : public RefCount<ReorderIndex>
 	{
 	protected:
-		DataChunk IndexEntries;				//!< Data chunk holding the actual entries
+		DataChunk IndexEntries;				//!< Data chunk holding the actual entries, as a ring of Capacity entries
+		int Capacity;						//!< Number of entries that fit in the ring before it must grow
+		int Head;							//!< Ring slot of the entry for FirstPosition
+		int MaxReorder;						//!< Furthest that a temporal offset may be set before the latest entry
 		int CompleteEntryCount;				//!< Number of entries including all details (but not necessarily a temporal offset)
 		int EntryCount;						//!< Number of entries containing a either full details or a temporal offset
 											/*!< This is actually the index of the highest used entry plus one, so there may
@@ -113,16 +126,25 @@ namespace mxflib
 
 	public:
 		//! Initialise the ReorderIndex
-		ReorderIndex(int UseIndexEntrySize)
+		/*! \param UseIndexEntrySize The size of each index entry
+		 *  \param UseMaxReorder The furthest that a temporal offset may be set before the latest entry, which sizes the ring
+		 */
+		ReorderIndex(int UseIndexEntrySize, int UseMaxReorder = 128)
 		{
-			// Set a high granularity to reduce overhead of frequent reallocation
-			IndexEntries.SetGranularity(1024 * 16);
-
 			CompleteEntryCount = 0;
 			EntryCount = 0;
+			FirstPosition = 0;
+			Head = 0;
 
 			mxflib_assert(UseIndexEntrySize);
 			IndexEntrySize = UseIndexEntrySize;
+
+			// DRAGONS: The ring holds the reorder reach plus a long GOP, so it only grows if entries are not committed
+			MaxReorder = UseMaxReorder;
+			Capacity = 64;
+			while(Capacity < (MaxReorder * 2)) Capacity *= 2;
+
+			IndexEntries.Resize(Capacity * IndexEntrySize);
 		}
 
 		//! Add a new entry to the table (setting flags and anchor offset)
@@ -139,6 +161,16 @@ namespace mxflib
 
 		//! Commit entries to the specified index table
 		Int32 CommitEntries(IndexTablePtr Index, Int32 Count = -1);
+
+		//! Commit all whole GOPs whose temporal offsets can no longer change to the specified index table
+		Int32 CommitGOPs(IndexTablePtr Index);
+
+	protected:
+		//! Get a pointer to the entry for a given offset from FirstPosition
+		UInt8 *GetEntry(int Entry) { return &IndexEntries.Data[((Head + Entry) % Capacity) * IndexEntrySize]; }
+
+		//! Make room for entries from FirstPosition - Before to FirstPosition + Count - 1, clearing any new entries
+		void MakeRoom(int Before, int Count);
 	};
 
 	typedef SmartPtr<ReorderIndex> ReorderIndexPtr;
@@ -177,6 +209,28 @@ namespace mxflib
 
 		ReorderIndexPtr		Reorder;			//!< Pointer to our reorder index if we are using one (used for building reordered indexes)
 
+	protected:
+		//! A run of contiguous entries in the flat index, built from a single IndexSegment
+		struct FlatIndexRun
+		{
+			Position Start;						//!< Edit unit of the first entry in this run
+			Length Count;						//!< Number of entries in this run
+			size_t First;						//!< Index of the first entry of this run in the flat arrays
+			bool Exact;							//!< True if the segment had a delta entry for the main stream (so main stream look-ups are exact)
+			bool Reorder;						//!< True if main stream look-ups in this segment may be temporally reordered
+
+			//! Sort runs by start position
+			bool operator<(const FlatIndexRun &Other) const { return Start < Other.Start; }
+		};
+
+		bool FlatValid;							//!< True if the flat index below matches the segment map
+		std::vector<FlatIndexRun> FlatRuns;	//!< Runs of entries in the flat index, sorted by start position
+		std::vector<UInt64> FlatStreamOffset;	//!< Stream offset of each entry in the flat index
+		std::vector<UInt8> FlatFlags;			//!< Flags of each entry in the flat index
+		std::vector<Int8> FlatTemporalOffset;	//!< Temporal offset of each entry in the flat index
+		std::vector<Int8> FlatKeyOffset;		//!< Key frame offset of each entry in the flat index
+
+		int SegmentCapacity;					//!< Number of entries to reserve space for in each new segment, or 0 to grow as entries are added
 
 	public:
 		//! The lowest valid index position, used to flag omitted "start" parameters
@@ -186,7 +240,7 @@ namespace mxflib
 
 	public:
 		//! Construct an IndexTable with no CBRDeltaArray
-		IndexTable() : IndexSID(0), BodySID(0), EditUnitByteCount(0) , BaseDeltaCount(0)
+		IndexTable() : IndexSID(0), BodySID(0), EditUnitByteCount(0) , BaseDeltaCount(0), FlatValid(false)
 		{ 
 			IndexDuration=0;
 			EditRate.Numerator=0; 
@@ -194,6 +248,7 @@ namespace mxflib
 			NSL=0; 
 			NPE=0; 
 			IndexEntrySize=11; 
+			SegmentCapacity=0;
 		};
 
 		//! Free any memory used by BaseDeltaArray when this IndexTable is destroyed
@@ -272,12 +327,19 @@ namespace mxflib
 		IndexSegmentPtr AddSegment(MDObjectPtr Segment);
 
 		//! Add an index table segment from a raw DataChunk containing a section of un-parsed index table data
-		/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions */
-		void AddSegments(DataChunkPtr &IndexChunk);
+		/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions
+		 *  \param IndexChunk The index table segments, and any filler between them
+		 *  \param Info If not NULL, a summary of each segment is appended to this list
+		 *  \return false if the data was not entirely valid index table segments and filler
+		 */
+		bool AddSegments(DataChunkPtr &IndexChunk, IndexSegmentInfoList *Info = NULL);
 
 		//! Add an index table segment from a raw DataChunk containing an un-parsed "IndexSegment"
-		/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions */
-		IndexSegmentPtr AddSegment(UInt8 const *pSegment, Length Size, int LenSize = 2);
+		/*! DRAGONS: This is far more efficient for loading the index table than using the general metadata functions
+		 *  \param Info If not NULL, this is filled with a summary of the segment
+		 *  \return The segment added, or NULL if this was a CBR index segment
+		 */
+		IndexSegmentPtr AddSegment(UInt8 const *pSegment, Length Size, int LenSize = 2, IndexSegmentInfo *Info = NULL);
 
 		//! Create a new empty index table segment
 		IndexSegmentPtr AddSegment(Int64 StartPosition);
@@ -290,11 +352,50 @@ namespace mxflib
 						   int SliceCount = 0, UInt32 *SliceOffsets = NULL, 
 						   int PosCount = 0, Rational *PosTable = NULL);
 
+		//! Add pre-formed index entries for a run of consecutive edit units, creating segments as required
+		/*! This is much faster than adding the entries one at a time with AddIndexEntry() as each segment is
+		 *  extended once per run, rather than once per entry. Runs too big for one segment continue in a new one.
+		 *  \param FirstEditUnit The edit unit of the first entry
+		 *  \param Count The number of entries
+		 *  \param Size The size of each entry, which must match IndexEntrySize
+		 *  \param Entries The entries, formatted as in an IndexEntryArray
+		 */
+		bool AddIndexEntries(Position FirstEditUnit, int Count, int Size, UInt8 const *Entries);
+
+		//! Set the number of entries to reserve space for in each new segment
+		/*! Setting this to the expected number of entries avoids any re-allocation as segments grow. The space is
+		 *  limited to what will fit in one segment.
+		 */
+		void SetSegmentCapacity(int Entries) { SegmentCapacity = Entries; }
+
 //#####
 //##### DRAGONS: Should Lookup also check the pending items?
 //#####
 		//! Perform an index table look-up
-		IndexPosPtr Lookup(Position EditUnit, int SubItem = 0, bool Reorder = true);
+		IndexPosPtr Lookup(Position EditUnit, int SubItem = 0, bool Reorder = true) const
+		{
+			IndexPosPtr Ret = new IndexPos;
+			Lookup(EditUnit, *Ret, SubItem, Reorder);
+			return Ret;
+		}
+
+		//! Perform an index table look-up, filling in a caller-supplied result rather than allocating a new one
+		void Lookup(Position EditUnit, IndexPos &Result, int SubItem = 0, bool Reorder = true) const;
+
+		//! Build a compact contiguous copy of the main stream index entries to speed up look-ups
+		/*! Once built, main stream look-ups in VBR tables do a binary search of the segments followed by a direct
+		 *  array access rather than a map search and entry decode. CBR tables are always looked-up arithmetically.
+		 *  \note The flat index is discarded by any change made to the table through IndexTable or IndexSegment
+		 *         methods, so this should be called once the table is complete
+		 *  \return false if the table cannot be flattened, in which case look-ups continue to use the segments
+		 */
+		bool Flatten(void);
+
+		//! Discard any flat index, freeing its memory
+		void ClearFlat(void);
+
+		//! Determine if a valid flat index is in use
+		bool IsFlat(void) const { return FlatValid; }
 
 		//! Calculate the duration of this index table (the highest indexed position + 1)
 		/*! DRAGONS: Also updates public member IndexDuration */
@@ -319,13 +420,18 @@ namespace mxflib
 		}
 
 		//! Enable reordering and get a pointer to the reorder index object
-		ReorderIndexPtr EnableReorder(void)
+		/*! \param MaxReorder The furthest that a temporal offset may be set before the latest entry */
+		ReorderIndexPtr EnableReorder(int MaxReorder = 128)
 		{
-			if(!Reorder) Reorder = new ReorderIndex(IndexEntrySize);
+			if(!Reorder) Reorder = new ReorderIndex(IndexEntrySize, MaxReorder);
 
 			return Reorder;
 		}
 
+	protected:
+		//! Perform a main stream look-up using the flat index
+		/*! \return false if the flat index cannot satisfy this look-up */
+		bool FlatLookup(Position EditUnit, IndexPos &Result, bool Reorder) const;
 	};
 }
 
@@ -377,6 +483,18 @@ namespace mxflib
 		//! Add multiple - pre-formed index entries
 		bool AddIndexEntries(int Count, int Size, UInt8 const *Entries);
 
+		//! Get the number of entries that may be added before this segment reaches its maximum size
+		int GetFreeEntries(void);
+
+		//! Reserve buffer space for a number of entries in total, limited to the maximum size of a segment
+		void ReserveEntries(int Count);
+
+	protected:
+		//! Make room in the buffer for Count more entries, growing it geometrically to limit re-allocation
+		void GrowEntryArray(int Count);
+
+	public:
+
 		//! Update the Stream Offset of an index entry
 		void Update(Position EditUnit, UInt64 StreamOffset);
 	};
@@ -457,7 +575,7 @@ namespace mxflib
 		IndexManager(int PosTableIndex, UInt32 ElementSize);
 
 		//! Free any memory used
-		~IndexManager()
+		virtual ~IndexManager()
 		{
 			delete[] PosTableList;
 			delete[] ElementSizeList;
@@ -499,7 +617,7 @@ namespace mxflib
 		int AddSubStream(int PosTableIndex, UInt32 ElementSize);
 
 		//! Update the PosTableIndex for a given stream
-		void SetPosTableIndex(int StreamID, int PosTableIndex)
+		virtual void SetPosTableIndex(int StreamID, int PosTableIndex)
 		{
 			if(StreamID < StreamCount) PosTableList[StreamID] = PosTableIndex;
 		}
@@ -514,7 +632,7 @@ namespace mxflib
 		void SetOffset(int SubStream, Position EditUnit, UInt64 Offset, int KeyOffset = 0, int Flags = -1);
 
 		//! Accept or decline an offered edit unit (of a stream) without a known offset
-		bool OfferEditUnit(int SubStream, Position EditUnit, int KeyOffset = 0, int Flags = -1);
+		virtual bool OfferEditUnit(int SubStream, Position EditUnit, int KeyOffset = 0, int Flags = -1);
 
 		//! Accept or decline an offered offset for a particular edit unit of a stream
 		bool OfferOffset(int SubStream, Position EditUnit, UInt64 Offset, int KeyOffset = 0, int Flags = -1);
@@ -523,13 +641,13 @@ namespace mxflib
 		void SetTemporalOffset(Position EditUnit, int Offset);
 
 		//! Accept or decline an offered temporal offset for a particular edit unit
-		bool OfferTemporalOffset(Position EditUnit, int Offset);
+		virtual bool OfferTemporalOffset(Position EditUnit, int Offset);
 
 		//! Set the key-frame offset for a particular edit unit
 		void SetKeyOffset(Position EditUnit, int Offset);
 
 		//! Accept or decline an offered key-frame offset for a particular edit unit
-		bool OfferKeyOffset(Position EditUnit, int Offset);
+		virtual bool OfferKeyOffset(Position EditUnit, int Offset);
 
 		//! Accept provisional entry
 		/*! \return The edit unit of the entry accepted - or IndexLowest if none available */
@@ -550,6 +668,9 @@ namespace mxflib
 		//! Read the edit unit of the last entry added (or IndexLowest if none added)
 		Position GetLastNewEditUnit(void) { return LastNewEditUnit; }
 
+		//! Determine if the index table uses reordering
+		bool GetUsesReordering(void) { return UsesReordering; }
+
 		//! Accept next edit unit offered
 		void AcceptNext(void)
 		{
@@ -575,6 +696,7 @@ namespace mxflib
 		}
 
 		//! Flush index data to free memory
+		/*! Discards all entries from FirstEditUnit to LastEditUnit inclusive */
 		void Flush(Position FirstEditUnit, Position LastEditUnit);
 
 		//! Get the edit unit of the first available entry
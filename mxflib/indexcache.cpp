@@ -0,0 +1,359 @@
+/*! \file	indexcache.cpp
+ *	\brief	Implementation of a sidecar file that caches the partition map and index tables of an MXF file
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Identifier at the start of every index cache file
+	const UInt8 CacheMagic[8] = { 'M', 'X', 'F', 'L', 'I', 'D', 'X', 'C' };
+
+	//! Size of the cache file header: magic, version, file key, payload size and payload hash
+	const size_t CacheHeaderSize = 8 + 4 + 20 + 4 + 4;
+
+	//! Size of each partition entry in the payload
+	const size_t PartitionEntrySize = 8 + 4 + 4 + 1 + 8 + 8;
+
+	//! Largest partition pack that will be read to build the file key
+	const Length MaxPackSize = 64 * 1024;
+
+	//! Add data to a running 32-bit FNV-1a hash
+	UInt32 Hash32(const UInt8 *Data, size_t Size, UInt32 Hash = 0x811c9dc5)
+	{
+		while(Size--)
+		{
+			Hash ^= *(Data++);
+			Hash *= 0x01000193;
+		}
+
+		return Hash;
+	}
+
+	void AppendU32(DataChunk &Data, UInt32 Value)
+	{
+		UInt8 Buffer[4];
+		PutU32(Value, Buffer);
+		Data.Append(4, Buffer);
+	}
+
+	void AppendI64(DataChunk &Data, Int64 Value)
+	{
+		UInt8 Buffer[8];
+		PutI64(Value, Buffer);
+		Data.Append(8, Buffer);
+	}
+
+	//! Get the default cache file name for an MXF file
+	std::string CacheFileName(MXFFilePtr &File, std::string CacheFile)
+	{
+		if(CacheFile.length()) return CacheFile;
+		return File->Name + IndexCacheSuffix;
+	}
+}
+
+
+//! Record the partition map held in a RIP
+void IndexCache::SetPartitions(RIP &FileRIP)
+{
+	Partitions.clear();
+	Partitions.reserve(FileRIP.size());
+
+	RIP::iterator it = FileRIP.begin();
+	while(it != FileRIP.end())
+	{
+		PartitionInfoPtr &Info = (*it).second;
+
+		PartitionEntry Entry;
+		Entry.ByteOffset = Info->GetByteOffset();
+		Entry.BodySID = Info->GetBodySID();
+		Entry.IndexSID = Info->GetIndexSID();
+		Entry.KnownSIDs = Info->SIDsKnown();
+		Entry.StreamOffset = Info->GetStreamOffset();
+		Entry.EssenceStart = Info->GetEssenceStart();
+
+		// If the partition pack has been read we can fill in anything not otherwise known
+		if(Info->ThePartition)
+		{
+			if(!Entry.KnownSIDs)
+			{
+				Entry.BodySID = Info->ThePartition->GetUInt(BodySID_UL);
+				Entry.IndexSID = Info->ThePartition->GetUInt(IndexSID_UL);
+				Entry.KnownSIDs = true;
+			}
+
+			if(Entry.StreamOffset == -1) Entry.StreamOffset = Info->ThePartition->GetInt64(BodyOffset_UL);
+		}
+
+		Partitions.push_back(Entry);
+		it++;
+	}
+}
+
+
+//! Add the recorded partition map to a RIP
+void IndexCache::ApplyPartitions(RIP &FileRIP)
+{
+	std::vector<PartitionEntry>::iterator it = Partitions.begin();
+	while(it != Partitions.end())
+	{
+		PartitionInfoPtr Info;
+
+		RIP::iterator RIP_it = FileRIP.find((*it).ByteOffset);
+		if(RIP_it == FileRIP.end()) Info = FileRIP.AddPartition(NULL, (*it).ByteOffset, (*it).BodySID);
+		else Info = (*RIP_it).second;
+
+		if((*it).KnownSIDs && !Info->SIDsKnown()) Info->SetSIDs((*it).BodySID, (*it).IndexSID);
+		if(Info->GetStreamOffset() == -1) Info->SetStreamOffset((*it).StreamOffset);
+		if(Info->GetEssenceStart() == -1) Info->SetEssenceStart((*it).EssenceStart);
+
+		it++;
+	}
+}
+
+
+//! Get an index table by IndexSID, or NULL if not in the cache
+IndexTablePtr IndexCache::GetIndexTable(UInt32 IndexSID)
+{
+	IndexTableList::iterator it = Tables.begin();
+	while(it != Tables.end())
+	{
+		if((*it)->IndexSID == IndexSID) return *it;
+		it++;
+	}
+
+	return NULL;
+}
+
+
+//! Write this cache to a sidecar file for a given MXF file
+bool IndexCache::Write(MXFFilePtr &File, std::string CacheFile /*=""*/)
+{
+	UInt8 Header[CacheHeaderSize];
+	memcpy(Header, CacheMagic, 8);
+	PutU32(IndexCacheVersion, &Header[8]);
+	if(!MakeFileKey(File, &Header[12])) return false;
+
+	DataChunk Data;
+	Data.SetGranularity(64 * 1024);
+
+	AppendU32(Data, static_cast<UInt32>(Partitions.size()));
+	std::vector<PartitionEntry>::iterator it = Partitions.begin();
+	while(it != Partitions.end())
+	{
+		UInt8 Known = (*it).KnownSIDs ? 1 : 0;
+
+		AppendI64(Data, (*it).ByteOffset);
+		AppendU32(Data, (*it).BodySID);
+		AppendU32(Data, (*it).IndexSID);
+		Data.Append(1, &Known);
+		AppendI64(Data, (*it).StreamOffset);
+		AppendI64(Data, (*it).EssenceStart);
+		it++;
+	}
+
+	// Each table is stored as its serialized index table segments
+	AppendU32(Data, static_cast<UInt32>(Tables.size()));
+	IndexTableList::iterator Table_it = Tables.begin();
+	while(Table_it != Tables.end())
+	{
+		DataChunk Segments;
+		(*Table_it)->WriteIndex(Segments);
+
+		AppendU32(Data, static_cast<UInt32>(Segments.Size));
+		Data.Append(Segments);
+		Table_it++;
+	}
+
+	PutU32(static_cast<UInt32>(Data.Size), &Header[32]);
+	PutU32(Hash32(Data.Data, Data.Size), &Header[36]);
+
+	std::string FileName = CacheFileName(File, CacheFile);
+	FileHandle Out = FileOpenNew(FileName.c_str());
+	if(!FileValid(Out)) return false;
+
+	bool Ret = (FileWrite(Out, Header, CacheHeaderSize) == CacheHeaderSize);
+	if(Ret && Data.Size) Ret = (FileWrite(Out, Data.Data, Data.Size) == Data.Size);
+
+	FileClose(Out);
+
+	// Don't leave a partial cache lying around
+	if(!Ret) FileDelete(FileName.c_str());
+
+	return Ret;
+}
+
+
+//! Read the cache for a given MXF file from a sidecar file
+IndexCachePtr IndexCache::Read(MXFFilePtr &File, std::string CacheFile /*=""*/)
+{
+	UInt8 Key[FileKeySize];
+	if(!MakeFileKey(File, Key)) return NULL;
+
+	std::string FileName = CacheFileName(File, CacheFile);
+	FileHandle In = FileOpenRead(FileName.c_str());
+	if(!FileValid(In)) return NULL;
+
+	UInt8 Header[CacheHeaderSize];
+	if(FileRead(In, Header, CacheHeaderSize) != CacheHeaderSize)
+	{
+		FileClose(In);
+		return NULL;
+	}
+
+	// Validate the header, including that the MXF file has not changed since the cache was written
+	if(    (memcmp(Header, CacheMagic, 8) != 0)
+		|| (GetU32(&Header[8]) != IndexCacheVersion)
+		|| (memcmp(&Header[12], Key, FileKeySize) != 0))
+	{
+		FileClose(In);
+		return NULL;
+	}
+
+	size_t PayloadSize = static_cast<size_t>(GetU32(&Header[32]));
+
+	DataChunk Data(PayloadSize);
+	bool Valid = (FileRead(In, Data.Data, PayloadSize) == PayloadSize);
+	FileClose(In);
+
+	if(Valid) Valid = (Hash32(Data.Data, PayloadSize) == GetU32(&Header[36]));
+
+	IndexCachePtr Ret = new IndexCache;
+
+	const UInt8 *Ptr = Data.Data;
+	size_t Remaining = PayloadSize;
+
+	// Read the partition map
+	if(Valid)
+	{
+		Valid = (Remaining >= 4);
+		UInt32 Count = Valid ? GetU32(Ptr) : 0;
+		Ptr += 4;
+		Remaining -= 4;
+
+		if(Valid) Valid = ((Remaining / PartitionEntrySize) >= Count);
+		if(Valid)
+		{
+			Ret->Partitions.resize(Count);
+			std::vector<PartitionEntry>::iterator it = Ret->Partitions.begin();
+			while(it != Ret->Partitions.end())
+			{
+				(*it).ByteOffset = GetI64(Ptr);
+				(*it).BodySID = GetU32(&Ptr[8]);
+				(*it).IndexSID = GetU32(&Ptr[12]);
+				(*it).KnownSIDs = (Ptr[16] != 0);
+				(*it).StreamOffset = GetI64(&Ptr[17]);
+				(*it).EssenceStart = GetI64(&Ptr[25]);
+
+				Ptr += PartitionEntrySize;
+				Remaining -= PartitionEntrySize;
+				it++;
+			}
+		}
+	}
+
+	// Read the index tables
+	if(Valid)
+	{
+		Valid = (Remaining >= 4);
+		UInt32 Count = Valid ? GetU32(Ptr) : 0;
+		Ptr += 4;
+		Remaining -= 4;
+
+		while(Valid && Count--)
+		{
+			Valid = (Remaining >= 4);
+			if(!Valid) break;
+
+			size_t Size = static_cast<size_t>(GetU32(Ptr));
+			Ptr += 4;
+			Remaining -= 4;
+
+			Valid = (Remaining >= Size);
+			if(!Valid) break;
+
+			IndexTablePtr Table = new IndexTable;
+			DataChunkPtr Segments = new DataChunk(Size, Ptr);
+			Table->AddSegments(Segments);
+			Ret->Tables.push_back(Table);
+
+			Ptr += Size;
+			Remaining -= Size;
+		}
+	}
+
+	if(!Valid)
+	{
+		warning("Index cache \"%s\" is corrupt and will not be used\n", FileName.c_str());
+		return NULL;
+	}
+
+	return Ret;
+}
+
+
+//! Build the key that ties a cache to the current state of an MXF file
+/*! The key holds the size and modification time of the file, and a hash of its first partition pack
+ *  \return false if the key cannot be built, such as for a memory file or one opened from a handle
+ */
+bool IndexCache::MakeFileKey(MXFFilePtr &File, UInt8 *Key)
+{
+	if(File->Name.empty()) return false;
+
+	Length Size = File->Size();
+	Int64 ModTime = FileModTime(File->Name.c_str());
+	if((Size < 0) || (ModTime < 0)) return false;
+
+	PutI64(Size, Key);
+	PutI64(ModTime, &Key[8]);
+
+	// Hash the header partition pack, which also covers the run-in (if any) as this moves the partition pack
+	Position Pos = File->Tell();
+	File->Seek(0);
+
+	UInt32 Hash = Hash32(File->RunIn.Data, File->RunIn.Size);
+	ULPtr PackKey = File->ReadKey();
+	Length PackSize = PackKey ? File->ReadBER() : -1;
+	if((PackSize < 0) || (PackSize > MaxPackSize))
+	{
+		File->Seek(Pos);
+		return false;
+	}
+
+	DataChunkPtr Pack = File->Read(static_cast<size_t>(PackSize));
+	Hash = Hash32(PackKey->GetValue(), 16, Hash);
+	Hash = Hash32(Pack->Data, Pack->Size, Hash);
+	PutU32(Hash, &Key[16]);
+
+	File->Seek(Pos);
+
+	return true;
+}
@@ -0,0 +1,126 @@
+/*! \file	indexcache.h
+ *	\brief	Definition of a sidecar file that caches the partition map and index tables of an MXF file
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Random access to a file with no footer index, or with only sparse index tables, requires the
+ *  partitions to be located and the index tables rebuilt by scanning the body. An IndexCache holds
+ *  the results of that work so that they can be written to a small sidecar file and read back the
+ *  next time the same file is opened. The cache records the size and modification time of the MXF
+ *  file and a hash of its header partition pack, and is ignored if any of these has changed.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__INDEXCACHE_H
+#define MXFLIB__INDEXCACHE_H
+
+namespace mxflib
+{
+	//! Version number of the index cache file format, caches of any other version are ignored
+	const UInt32 IndexCacheVersion = 1;
+
+	//! Suffix added to the path of an MXF file to give the default path of its index cache (e.g. file.mxf.idx)
+	const char IndexCacheSuffix[] = ".idx";
+
+	// Forward declare IndexCache to allow IndexCachePtr to be defined early
+	class IndexCache;
+
+	//! A smart pointer to an IndexCache
+	typedef SmartPtr<IndexCache> IndexCachePtr;
+
+	//! A list of smart pointers to index tables
+	typedef std::list<IndexTablePtr> IndexTableList;
+
+	//! The partition map and index tables of an MXF file, which can be stored in a sidecar file
+	class IndexCache : public RefCount<IndexCache>
+	{
+	protected:
+		//! The details of a single partition
+		struct PartitionEntry
+		{
+			Position ByteOffset;			//!< Byte offset of the partition pack in the file
+			UInt32 BodySID;					//!< BodySID of the partition
+			UInt32 IndexSID;				//!< IndexSID of the partition
+			bool KnownSIDs;					//!< True if the SIDs are known for sure
+			Position StreamOffset;			//!< Stream offset of the first essence byte in the partition, or -1 if not known
+			Position EssenceStart;			//!< Byte offset of the first essence byte in the partition, or -1 if not known
+		};
+
+		std::vector<PartitionEntry> Partitions;	//!< The partition map, in file order
+		IndexTableList Tables;					//!< The index tables
+
+	public:
+		//! Build an empty cache
+		IndexCache() {};
+
+		//! Record the partition map held in a RIP
+		/*! Any previously recorded partitions are replaced */
+		void SetPartitions(RIP &FileRIP);
+
+		//! Add the recorded partition map to a RIP
+		/*! Partitions already in the RIP are left as they are, but any missing details are filled in from the cache
+		 *  \note The partition packs themselves are not read, so ThePartition will be NULL for each partition added
+		 */
+		void ApplyPartitions(RIP &FileRIP);
+
+		//! Get the number of partitions recorded
+		size_t GetPartitionCount(void) const { return Partitions.size(); }
+
+		//! Add an index table to the cache
+		void AddIndexTable(IndexTablePtr Table) { Tables.push_back(Table); }
+
+		//! Get the index tables in the cache
+		IndexTableList &GetIndexTables(void) { return Tables; }
+
+		//! Get an index table by IndexSID, or NULL if not in the cache
+		IndexTablePtr GetIndexTable(UInt32 IndexSID);
+
+		//! Write this cache to a sidecar file for a given MXF file
+		/*! \param CacheFile The sidecar file to write, or empty to use the name of the MXF file followed by IndexCacheSuffix
+		 *  \return true if all OK
+		 */
+		bool Write(MXFFilePtr &File, std::string CacheFile = "");
+
+		//! Read the cache for a given MXF file from a sidecar file
+		/*! \param CacheFile The sidecar file to read, or empty to use the name of the MXF file followed by IndexCacheSuffix
+		 *  \return NULL if there is no valid cache for the current state of the MXF file
+		 */
+		static IndexCachePtr Read(MXFFilePtr &File, std::string CacheFile = "");
+
+	protected:
+		//! Build the key that ties a cache to the current state of an MXF file
+		/*! \return false if the key cannot be built, such as for a memory file or one opened from a handle */
+		static bool MakeFileKey(MXFFilePtr &File, UInt8 *Key);
+
+		//! Size of the key built by MakeFileKey()
+		enum { FileKeySize = 20 };
+
+	private:
+		//! Prevent copy construction
+		IndexCache(const IndexCache &);
+	};
+}
+
+#endif // MXFLIB__INDEXCACHE_H
@@ -0,0 +1,184 @@
+/*! \file	indexscan.cpp
+ *	\brief	Implementation of a class that builds index tables for essence written without them
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+//! Scan the body of the file to build an index table for a given stream
+/*! \return The new index table, or NULL if no edit units were found or an error occurred
+ */
+IndexTablePtr IndexScanner::Scan(UInt32 BodySID, UInt32 IndexSID, Rational EditRate)
+{
+	EditUnitCount = 0;
+
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	IndexTablePtr Ret = new IndexTable;
+	Ret->IndexSID = IndexSID;
+	Ret->BodySID = BodySID;
+	Ret->EditRate = EditRate;
+
+	// A single delta entry for the whole edit unit
+	UInt32 ElementSize = 0;
+	Ret->DefineDeltaArray(1, &ElementSize);
+
+	UInt8 FirstKey[16];
+	bool FirstKeyKnown = false;
+
+	RIP::iterator it = File->FileRIP.begin();
+	while(it != File->FileRIP.end())
+	{
+		PartitionInfoPtr Info = (*it).second;
+		it++;
+
+		// Don't read partition packs that we already know are for other streams
+		if(Info->SIDsKnown() && (Info->GetBodySID() != BodySID)) continue;
+
+		File->Seek(Info->GetByteOffset());
+		PartitionPtr ThisPartition = File->ReadPartition();
+		if(!ThisPartition)
+		{
+			error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(Info->GetByteOffset(), 8).c_str(), File->Name.c_str());
+			return NULL;
+		}
+
+		if(ThisPartition->GetUInt(BodySID_UL) != BodySID) continue;
+
+		if(!ThisPartition->SeekEssence()) continue;
+
+		Position EssenceStart = File->Tell();
+		Position StreamOffset = ThisPartition->GetInt64(BodyOffset_UL);
+
+		// Only the first edit unit in each partition is indexed for a sparse index
+		bool PartitionStart = true;
+
+		for(;;)
+		{
+			Position KLVStart = File->Tell();
+
+			// Read each key and length in one go, without filling the read-ahead window with the value
+			UInt8 KeyBuffer[16];
+			Length Len;
+			Int32 KLSize = File->ReadKL(KeyBuffer, Len);
+			if(!KLSize) break;
+
+			// Stop at the next partition pack or the RIP
+			ULPtr Key = new UL(KeyBuffer);
+			if(IsPartitionKey(KeyBuffer) || Key->Matches(RandomIndexMetadata_UL)) break;
+
+			Position ValueStart = KLVStart + KLSize;
+
+			UInt8 ElementKey[16];
+			if(GetElementKey(Key, ValueStart, Len, ElementKey))
+			{
+				if(!FirstKeyKnown)
+				{
+					memcpy(FirstKey, ElementKey, 16);
+					FirstKeyKnown = true;
+				}
+
+				// DRAGONS: Byte 8 is the version number, which may differ between otherwise identical keys
+				if((memcmp(ElementKey, FirstKey, 7) == 0) && (memcmp(&ElementKey[8], &FirstKey[8], 8) == 0))
+				{
+					bool Indexed = (Interval == 0) ? PartitionStart : ((EditUnitCount % Interval) == 0);
+					if(Indexed)
+					{
+						Position Location = StreamOffset + (KLVStart - EssenceStart);
+						Ret->AddIndexEntry(EditUnitCount, 0, 0, EntryFlags, static_cast<UInt64>(Location));
+					}
+
+					PartitionStart = false;
+					EditUnitCount++;
+				}
+			}
+
+			File->Seek(ValueStart + Len);
+		}
+	}
+
+	if(EditUnitCount == 0)
+	{
+		error("No edit units found for BodySID 0x%04x in file \"%s\"\n", BodySID, File->Name.c_str());
+		return NULL;
+	}
+
+	Ret->IndexDuration = EditUnitCount;
+
+	return Ret;
+}
+
+
+//! Get the key that identifies the element held in a KLV
+/*! For encrypted triplets this is the key of the plaintext element, otherwise it is the KLV key itself
+ *  \return false if the KLV does not hold an essence element
+ */
+bool IndexScanner::GetElementKey(ULPtr &Key, Position ValueStart, Length ValueLength, UInt8 *ElementKey)
+{
+	if(Key->Matches(EncryptedTriplet_UL))
+	{
+		// The source key follows the context ID and the plaintext offset, each of which has a BER length
+		UInt8 Buffer[9 + 16 + 9 + 8 + 9 + 16];
+		Length Available = ValueLength;
+		if(Available > static_cast<Length>(sizeof(Buffer))) Available = sizeof(Buffer);
+
+		File->Seek(ValueStart);
+		size_t Bytes = File->ReadSmall(Buffer, static_cast<size_t>(Available));
+
+		const UInt8 *Ptr = Buffer;
+		const UInt8 *End = &Buffer[Bytes];
+
+		int Item;
+		for(Item = 0; Item < 3; Item++)
+		{
+			if(Ptr >= End) return false;
+
+			Length ItemLength = ReadBER(&Ptr, static_cast<int>(End - Ptr));
+			if((ItemLength < 0) || (ItemLength > (End - Ptr))) return false;
+
+			// The third item is the source key
+			if(Item == 2)
+			{
+				if(ItemLength != 16) return false;
+				memcpy(ElementKey, Ptr, 16);
+				return true;
+			}
+
+			Ptr += ItemLength;
+		}
+
+		return false;
+	}
+
+	if(!GetGCElementKind(Key).IsValid) return false;
+
+	memcpy(ElementKey, Key->GetValue(), 16);
+	return true;
+}
@@ -0,0 +1,94 @@
+/*! \file	indexscan.h
+ *	\brief	Definition of a class that builds index tables for essence written without them
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Files written without index tables can only be accessed randomly by reading through the body.
+ *  An IndexScanner builds a VBR index table for such a file by reading only the partition packs
+ *  and the keys and lengths of the KLVs in the body, seeking over each value, so that the table
+ *  can be written into a new footer partition and the scan need never be repeated.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__INDEXSCAN_H
+#define MXFLIB__INDEXSCAN_H
+
+namespace mxflib
+{
+	//! Builds a VBR index table for a frame-wrapped essence stream from the keys and lengths of its KLVs
+	/*! The start of each edit unit is found as the start of each KLV with the same key as the first essence
+	 *  element in the stream. Filler and other non-essence KLVs are skipped, but are counted in the stream
+	 *  offsets in the same way as BodyReader::Seek(). Encrypted triplets are matched by the key of the
+	 *  plaintext element that they hold, which is read from the start of each triplet.
+	 *  \note The essence itself is not parsed, so each entry has no temporal or key frame offset and the same
+	 *        flags, making the index unsuitable for long-GOP essence unless every entry indexed is a key frame
+	 *  \note Clip-wrapped essence cannot be indexed in this way as a single KLV holds every edit unit
+	 */
+	class IndexScanner : public RefCount<IndexScanner>
+	{
+	protected:
+		MXFFilePtr File;						//!< The file being scanned
+		Length Interval;						//!< Index every Interval edit units, or only the first in each partition if zero
+		UInt8 EntryFlags;						//!< Flags to set in each index entry
+		Length EditUnitCount;					//!< Number of edit units found by the last scan
+
+	public:
+		//! Construct a scanner for a given file
+		IndexScanner(MXFFilePtr &File) : File(File), Interval(1), EntryFlags(0x80), EditUnitCount(0) {};
+
+		//! Set how sparse the index table should be
+		/*! \param EditUnits 1 to index every edit unit, n to index every nth edit unit, or zero to index only
+		 *         the first edit unit in each partition (as sparse footer indexes written by BodyWriter do)
+		 */
+		void SetInterval(Length EditUnits) { Interval = EditUnits; }
+
+		//! Set the flags to use for every index entry, the default is 0x80 (random access point)
+		void SetEntryFlags(UInt8 Flags) { EntryFlags = Flags; }
+
+		//! Scan the body of the file to build an index table for a given stream
+		/*! \return The new index table, or NULL if no edit units were found or an error occurred
+		 */
+		IndexTablePtr Scan(UInt32 BodySID, UInt32 IndexSID, Rational EditRate);
+
+		//! Get the number of edit units found by the last scan, whether or not each was indexed
+		Length GetEditUnitCount(void) const { return EditUnitCount; }
+
+	protected:
+		//! Get the key that identifies the element held in a KLV
+		/*! For encrypted triplets this is the key of the plaintext element, otherwise it is the KLV key itself
+		 *  \return false if the KLV does not hold an essence element
+		 */
+		bool GetElementKey(ULPtr &Key, Position ValueStart, Length ValueLength, UInt8 *ElementKey);
+
+	private:
+		//! Prevent copy construction
+		IndexScanner(const IndexScanner &);
+	};
+
+	//! A smart pointer to an IndexScanner object
+	typedef SmartPtr<IndexScanner> IndexScannerPtr;
+}
+
+#endif // MXFLIB__INDEXSCAN_H
@@ -0,0 +1,104 @@
+/*! \file	internedname.cpp
+ *	\brief	Implementation of the table of interned names
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The table of interned names, each with its hash
+	/*! DRAGONS: The keys of a map never move, so pointers to them are held by InternedName objects.
+	 *           This is built on first use as names may be interned during static initialisation
+	 */
+	std::map<std::string, size_t> &NameTable(void)
+	{
+		static std::map<std::string, size_t> Table;
+		return Table;
+	}
+
+	//! Lock for the table of interned names
+	Mutex &NameTableLock(void)
+	{
+		static Mutex Lock;
+		return Lock;
+	}
+
+	//! Locate, or add, a name in the table
+	const std::string *Intern(const std::string &Name, size_t &Hash)
+	{
+		MutexLock Locked(NameTableLock());
+
+		std::map<std::string, size_t> &Table = NameTable();
+		std::map<std::string, size_t>::iterator it = Table.find(Name);
+		if(it == Table.end()) it = Table.insert(std::map<std::string, size_t>::value_type(Name, InternedName::HashOf(Name))).first;
+
+		Hash = (*it).second;
+		return &(*it).first;
+	}
+}
+
+
+//! Construct an empty name
+InternedName::InternedName()
+{
+	Str = Intern(std::string(), Hash);
+}
+
+
+//! Construct an interned copy of a name
+InternedName::InternedName(const std::string &Name)
+{
+	Str = Intern(Name, Hash);
+}
+
+
+//! Construct an interned copy of a name
+InternedName::InternedName(const char *Name)
+{
+	Str = Intern(std::string(Name), Hash);
+}
+
+
+//! Calculate the hash used for interned names
+/*! This is the 32-bit FNV-1a hash */
+size_t InternedName::HashOf(const std::string &Name)
+{
+	UInt32 Ret = 2166136261u;
+
+	std::string::const_iterator it = Name.begin();
+	while(it != Name.end())
+	{
+		Ret = (Ret ^ static_cast<UInt8>(*it)) * 16777619u;
+		it++;
+	}
+
+	return static_cast<size_t>(Ret);
+}
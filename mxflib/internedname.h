@@ -0,0 +1,92 @@
+/*! \file	internedname.h
+ *	\brief	Interned names for fast comparison of type and property names
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Each distinct name is held once in a library-wide table, so two InternedName objects are equal exactly when they
+ *  refer to the same entry, which is a single pointer compare. The names of all dictionary types are interned, so code
+ *  that repeatedly locates properties by name can build an InternedName once and avoid string compares on every access.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__INTERNEDNAME_H
+#define MXFLIB__INTERNEDNAME_H
+
+#include <string>
+
+namespace mxflib
+{
+	//! A name held in the library-wide table of interned names
+	/*! Construction looks up (or adds) the name in the table, so this is best done once and the result kept,
+	 *  for example as a static. Copying, comparing and hashing an InternedName are then all trivial.
+	 *  \note The constructors are explicit to avoid ambiguity with overloads taking std::string
+	 */
+	class InternedName
+	{
+	protected:
+		const std::string *Str;					//!< The single copy of this name in the table
+		size_t Hash;							//!< Hash of the name, calculated when first interned
+
+	public:
+		//! Construct an empty name
+		InternedName();
+
+		//! Construct an interned copy of a name
+		explicit InternedName(const std::string &Name);
+
+		//! Construct an interned copy of a name
+		explicit InternedName(const char *Name);
+
+		//! Get the name as a string
+		/*! DRAGONS: The string returned is the table's copy, so stays valid for the life of the program */
+		const std::string &Name(void) const { return *Str; }
+
+		//! Get the name as a C string
+		const char *c_str(void) const { return Str->c_str(); }
+
+		//! Get the precomputed hash of this name
+		size_t GetHash(void) const { return Hash; }
+
+		//! Determine if this is the empty name
+		bool empty(void) const { return Str->empty(); }
+
+		//! Determine if two names are the same
+		bool operator==(const InternedName &Other) const { return Str == Other.Str; }
+
+		//! Determine if two names differ
+		bool operator!=(const InternedName &Other) const { return Str != Other.Str; }
+
+		//! Determine if this name matches a string, which need not be interned
+		bool operator==(const std::string &Other) const { return (&Other == Str) || (Other == *Str); }
+
+		//! Determine if a string is the table's copy of this name, which is a pointer compare
+		bool Is(const std::string *Other) const { return Other == Str; }
+
+		//! Calculate the hash used for interned names
+		static size_t HashOf(const std::string &Name);
+	};
+}
+
+#endif // MXFLIB__INTERNEDNAME_H
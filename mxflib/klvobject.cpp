@@ -75,6 +75,21 @@ Int32 KLVObject::Base_ReadKL(void)
 		return 0;
 	}
 
+	// Positional reads leave the file pointer alone, so the file may be shared with other threads
+	if(Source.Positional)
+	{
+		UInt8 Key[16];
+		Length Len;
+		Int32 KLSize = Source.File->ReadKLAt(Source.Offset, Key, Len);
+		if(!KLSize) return 0;
+
+		TheUL = new UL(Key);
+		ValueLength = Dest.OuterLength = Source.OuterLength = Len;
+		Dest.KLSize = Source.KLSize = KLSize;
+
+		return KLSize;
+	}
+
 	// Read the key
 	Source.File->Seek(Source.Offset);
 	TheUL = Source.File->ReadKey();
@@ -142,9 +157,6 @@ size_t KLVObject::Base_ReadDataFrom(DataChunk &Buffer, Position Offset, size_t S
 		return 0;
 	}
 
-	// Seek to the start of the requested data
-	Source.File->Seek(Source.Offset + Source.KLSize + Offset);
-
 	// Resize the chunk
 	// Discarding old data first (by setting Size to 0) prevents old data being 
 	// copied needlessly if the buffer is reallocated to increase its size
@@ -152,7 +164,18 @@ size_t KLVObject::Base_ReadDataFrom(DataChunk &Buffer, Position Offset, size_t S
 	Buffer.Resize(static_cast<size_t>(BytesToRead));
 
 	// Read into the buffer (only as big as the buffer is!)
-	size_t Bytes = Source.File->Read(Buffer.Data, Buffer.Size);
+	size_t Bytes;
+	if(Source.Positional)
+	{
+		Bytes = Source.File->ReadAt(Source.Offset + Source.KLSize + Offset, Buffer.Data, Buffer.Size);
+	}
+	else
+	{
+		// Seek to the start of the requested data
+		Source.File->Seek(Source.Offset + Source.KLSize + Offset);
+
+		Bytes = Source.File->Read(Buffer.Data, Buffer.Size);
+	}
 
 	// Resize the buffer if something odd happened (such as an early end-of-file)
 	if(Bytes != static_cast<size_t>(BytesToRead)) Buffer.Resize(Bytes);
@@ -161,6 +184,61 @@ size_t KLVObject::Base_ReadDataFrom(DataChunk &Buffer, Position Offset, size_t S
 }
 
 
+//! Base verion: Read data from a specified position in the KLV value field into a DataChunk as a read-only view of the source
+/*! \param Offset Offset from the start of the KLV value from which to start reading
+ *  \param Size Number of bytes to read, if -1 all available bytes will be read (which could be billions!)
+ *  \return The number of bytes read
+ *
+ *  DRAGONS: This base function may be called from derived class objects to get base behaviour.
+ *           It is therefore vital that the function does not call any "virtual" KLVObject
+ *           functions, directly or indirectly.
+ */
+size_t KLVObject::Base_ReadDataViewFrom(DataChunk &Buffer, Position Offset, size_t Size /*=-1*/)
+{
+	// Views are only available when reading directly from the source file, otherwise read as normal
+	if(ReadHandler || (Source.Offset < 0) || (!Source.File)) return Base_ReadDataFrom(Buffer, Offset, Size);
+
+	// Initially plan to read all the bytes available
+	Length BytesToRead = Source.OuterLength - Offset;
+
+	// Limit to specified size if > 0 and if < available
+	if( (Size > 0) && (Size < static_cast<size_t>(BytesToRead))) BytesToRead = static_cast<Length>(Size);
+
+	// Don't do anything if nothing to read
+	if(BytesToRead <= 0) 
+	{
+		Buffer.Resize(0);
+		return 0;
+	}
+
+	// Sanity check the size of this read
+	if((sizeof(size_t) < 8) && (BytesToRead > 0xffffffff))
+	{
+		error("Tried to read > 4GBytes, but this platform can only handle <= 4GByte chunks\n");
+		return 0;
+	}
+
+	// Read a view of the data, this will be a copy if the file can't supply views
+	DataChunkPtr View;
+	if(Source.Positional)
+	{
+		View = Source.File->ReadAt(Source.Offset + Source.KLSize + Offset, static_cast<size_t>(BytesToRead));
+	}
+	else
+	{
+		// Seek to the start of the requested data
+		Source.File->Seek(Source.Offset + Source.KLSize + Offset);
+
+		View = Source.File->ReadView(static_cast<size_t>(BytesToRead));
+	}
+
+	// Reference the data held by the view rather than copying it
+	Buffer.SetBuffer(View, View->Data, View->Size);
+
+	return View->Size;
+}
+
+
 //! Base verion: Write the key and length of the current DataChunk to the destination file
 /*! The key and length will be written to the source file as set by SetSource.
  *  If LenSize is zero the length will be formatted to match KLSize (if possible!)
@@ -250,3 +328,116 @@ size_t KLVObject::Base_WriteDataTo(const UInt8 *Buffer, Position Offset, size_t
 	return Dest.File->Write(Buffer, Size);
 }
 
+
+
+//! Build a cursor at the start of the value of a given object
+/*! \param Object The object to read, which must not be read in any other way while the cursor is in use
+ *  \param WindowSize The maximum number of bytes in each window
+ *  \param ReadAhead True to read the next window on a worker thread, if the object uses positional reads
+ */
+KLVCursor::KLVCursor(KLVObjectPtr Object, size_t WindowSize, bool ReadAhead /*=false*/)
+	: Object(Object), WindowSize(WindowSize), CurrentOffset(0), NextOffset(0), Current(0), State(AheadIdle), AheadOffset(0), AheadBytes(0), Stopping(false)
+{
+	bool Direct = (!Object->ReadHandler) && Object->Source.File && (Object->Source.Offset >= 0);
+
+	UseViews = Direct && Object->Source.File->IsMemoryFile();
+
+	// DRAGONS: Reading ahead is only safe with positional reads, as the file pointer would otherwise be moved under the caller,
+	//          and there is nothing to gain for views as no bytes are copied
+	Ahead = ReadAhead && Direct && (!UseViews) && Object->Source.Positional;
+	if(Ahead) Ahead = Start();
+}
+
+
+//! Move to the next window of the value
+/*! \return false once the end of the value has been reached, or if no data could be read */
+bool KLVCursor::Next(void)
+{
+	if(!Ahead)
+	{
+		size_t Bytes = ReadWindow(Buffers[Current], NextOffset);
+		if(!Bytes) return false;
+
+		CurrentOffset = NextOffset;
+		NextOffset += Bytes;
+		return true;
+	}
+
+	MutexLock Locked(Lock);
+
+	// Nothing has been read ahead on the first call
+	if(State == AheadIdle)
+	{
+		AheadOffset = NextOffset;
+		State = AheadPending;
+		Changed.Broadcast();
+	}
+
+	while(State == AheadPending) Changed.Wait(Lock);
+
+	State = AheadIdle;
+	if(!AheadBytes) return false;
+
+	// The window read ahead becomes the current window, and the old current buffer is free for the next read-ahead
+	Current = 1 - Current;
+	CurrentOffset = AheadOffset;
+	NextOffset = AheadOffset + AheadBytes;
+
+	if(NextOffset < Object->GetLength())
+	{
+		AheadOffset = NextOffset;
+		State = AheadPending;
+		Changed.Broadcast();
+	}
+
+	return true;
+}
+
+
+//! Read a single window into a given buffer
+size_t KLVCursor::ReadWindow(DataChunk &Buffer, Position Offset)
+{
+	if(Offset >= Object->GetLength()) return 0;
+
+	if(UseViews) return Object->Base_ReadDataViewFrom(Buffer, Offset, WindowSize);
+
+	return Object->Base_ReadDataFrom(Buffer, Offset, WindowSize);
+}
+
+
+//! Stop the worker thread, if running
+void KLVCursor::Stop(void)
+{
+	Lock.Lock();
+	Stopping = true;
+	Changed.Broadcast();
+	Lock.Unlock();
+
+	Join();
+}
+
+
+//! Read each requested window until we are stopped
+void KLVCursor::Run(void)
+{
+	MutexLock Locked(Lock);
+
+	for(;;)
+	{
+		while(!Stopping && (State != AheadPending)) Changed.Wait(Lock);
+
+		if(Stopping) return;
+
+		// DRAGONS: The caller only changes Current once the read is done, so the other buffer is ours until then
+		DataChunk &Buffer = Buffers[1 - Current];
+		Position Offset = AheadOffset;
+
+		Lock.Unlock();
+		size_t Bytes = ReadWindow(Buffer, Offset);
+		Lock.Lock();
+
+		AheadBytes = Bytes;
+		State = AheadDone;
+		Changed.Broadcast();
+	}
+}
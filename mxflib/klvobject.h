@@ -154,10 +154,12 @@ namespace mxflib
 			Length OuterLength;				//!< The length of the entire readable value space - in basic KLV types this is always ValueLength, derived types may add some hidden overhead
 			Int32 KLSize;					//!< Size of this object's KL in the source or destination file (-1 if not known)
 			bool Valid;						//!< Set to true once the data is "set"
+			bool Positional;				//!< True if reads from File use positional reads, leaving the file pointer alone
 
 			KLVInfo()
 			{
 				Valid = false;
+				Positional = false;
 				Offset = -1;
 				OuterLength = 0;
 				KLSize = -1;
@@ -170,6 +172,7 @@ namespace mxflib
 				Offset = RHS.Offset;
 				OuterLength = RHS.OuterLength;
 				KLSize = RHS.KLSize;
+				Positional = RHS.Positional;
 
 				return *this;
 			}
@@ -192,6 +195,8 @@ namespace mxflib
 		//@@@ Is this another MSVC bug?  KLVEObject can't access protected KLVObject properties from KLVEObject constructor!!
 		friend class KLVEObject;
 
+		friend class KLVCursor;
+
 	public:
 		KLVObject(ULPtr ObjectUL = NULL);
 		virtual void Init(void);
@@ -215,6 +220,27 @@ namespace mxflib
 			}
 		}
 
+		//! Set the key and length of an object when they have already been read from the source file
+		/*! This allows the value to be read from the source file later, without reading the key and length again
+		 *  \note SetSource() must be called first
+		 */
+		void SetSourceKL(ULPtr Key, Length Len, Int32 KLSize)
+		{
+			TheUL = Key;
+			ValueLength = Dest.OuterLength = Source.OuterLength = Len;
+			Source.KLSize = Dest.KLSize = KLSize;
+		}
+
+		//! Select positional reads from the source file
+		/*! When enabled the key, length and value are read with MXFFile::ReadAt() rather than a Seek() and Read(),
+		 *  so the file pointer is neither used nor moved and the source file may be read by other threads at the same time
+		 *  \note This only affects reads made directly from the source file, not those made by a read handler
+		 */
+		void SetPositionalRead(bool Enable = true) { Source.Positional = Enable; }
+
+		//! Determine if positional reads from the source file are selected
+		bool IsPositionalRead(void) const { return Source.Positional; }
+
 		//! Set the destination details for the object to be written to a file
 		/*! \param File The destination file of this KLVObject
 		 *  \param Location The byte offset of the start of the <b>key</b> of the KLV from the start of the file, if omitted (or -1) the current position in that file will be used
@@ -326,6 +352,34 @@ namespace mxflib
 		 */
 		size_t Base_ReadDataFrom(DataChunk &Buffer, Position Offset, size_t Size = static_cast<size_t>(-1));
 
+		//! Read data from the start of the KLV value into the DataChunk as a read-only view of the source
+		/*! If the source file can supply views (such as memory and mapped files) the DataChunk will reference the
+		 *  source buffer rather than holding a copy of the data, otherwise the data is read as for ReadData()
+		 *  \param Size Number of bytes to read, if -1 all available bytes will be read (which could be billions!)
+		 *  \return The number of bytes read
+		 *  \note The data in the DataChunk must be treated as read-only until it is next read or resized
+		 */
+		virtual size_t ReadDataView(size_t Size = static_cast<size_t>(-1)) { return Base_ReadDataViewFrom(Data, 0, Size); }
+
+		//! Read data from a specified position in the KLV value field into the DataChunk as a read-only view of the source
+		/*! \param Offset Offset from the start of the KLV value from which to start reading
+		 *  \param Size Number of bytes to read, if -1 all available bytes will be read (which could be billions!)
+		 *  \return The number of bytes read
+		 *  \note The data in the DataChunk must be treated as read-only until it is next read or resized
+		 */
+		virtual size_t ReadDataViewFrom(Position Offset, size_t Size = static_cast<size_t>(-1)) { return Base_ReadDataViewFrom(Data, Offset, Size); }
+
+		//! Base verion: Read data from a specified position in the KLV value field into a DataChunk as a read-only view of the source
+		/*! \param Offset Offset from the start of the KLV value from which to start reading
+		 *  \param Size Number of bytes to read, if -1 all available bytes will be read (which could be billions!)
+		 *  \return The number of bytes read
+		 *
+		 *  DRAGONS: This base function may be called from derived class objects to get base behaviour.
+		 *           It is therefore vital that the function does not call any "virtual" KLVObject
+		 *           functions, directly or indirectly.
+		 */
+		size_t Base_ReadDataViewFrom(DataChunk &Buffer, Position Offset, size_t Size = static_cast<size_t>(-1));
+
 		//! Write the key and length of the current DataChunk to the destination file
 		/*! The key and length will be written to the source file as set by SetSource.
 		 *  If LenSize is zero the length will be formatted to match KLSize (if possible!)
@@ -376,7 +430,8 @@ namespace mxflib
 			Length BytesToWrite = Data.Size - Start;
 
 			// Write the requested size (if valid)
-			if((Size > 0) && ((Length)Size < BytesToWrite)) BytesToWrite = Size;
+			// DRAGONS: The default of -1 must be checked for explicitly as it becomes negative when cast to a 64-bit Length
+			if((Size > 0) && (Size != static_cast<size_t>(-1)) && ((Length)Size < BytesToWrite)) BytesToWrite = Size;
 
 			// Sanity check the size of this chunk
 			if((sizeof(size_t) < 8) && (BytesToWrite > 0xffffffff))
@@ -430,6 +485,74 @@ namespace mxflib
 		//! Get a reference to the data chunk
 		virtual DataChunk& GetData(void) { return Data; }
 	};
+
+
+	//! Streams the value of a KLVObject as a series of fixed-size windows
+	/*! Each window is read into one of two buffers that are kept for the life of the cursor, so a value of any size
+	 *  is read with constant memory and no allocations once the buffers have grown to the window size. For memory
+	 *  and mapped files each window is instead a view of the file, so nothing is copied.
+	 *  If read-ahead is requested, and the object uses positional reads, the next window is read on a worker
+	 *  thread while the caller is handling the current one.
+	 *  \note The raw bytes of the value are returned, as read by Base_ReadDataFrom(), so the value of a KLVEObject
+	 *        is not decrypted
+	 */
+	class KLVCursor : protected Thread
+	{
+	protected:
+		//! The state of a read-ahead request
+		enum AheadState { AheadIdle, AheadPending, AheadDone };
+
+		KLVObjectPtr Object;				//!< The object whose value is read
+		size_t WindowSize;					//!< The maximum number of bytes in each window
+		Position CurrentOffset;				//!< The offset in the value of the current window
+		Position NextOffset;				//!< The offset in the value of the next window
+		DataChunk Buffers[2];				//!< The buffers that windows are read into
+		int Current;						//!< The index of the buffer holding the current window
+		bool UseViews;						//!< True if windows are views of a memory or mapped file
+		bool Ahead;							//!< True if the next window is read ahead on the worker thread
+
+		Mutex Lock;							//!< Lock protecting the read-ahead state below
+		Condition Changed;					//!< Signalled when a read-ahead is requested or completed, or when stopping
+		AheadState State;					//!< The state of the read-ahead
+		Position AheadOffset;				//!< The offset in the value of the window being read ahead
+		size_t AheadBytes;					//!< The number of bytes read ahead, once done
+		bool Stopping;						//!< Set to request the worker thread to stop
+
+	public:
+		//! Build a cursor at the start of the value of a given object
+		/*! \param Object The object to read, which must not be read in any other way while the cursor is in use
+		 *  \param WindowSize The maximum number of bytes in each window
+		 *  \param ReadAhead True to read the next window on a worker thread, if the object uses positional reads
+		 */
+		KLVCursor(KLVObjectPtr Object, size_t WindowSize, bool ReadAhead = false);
+
+		//! Stop the worker thread before destruction
+		~KLVCursor() { Stop(); }
+
+		//! Move to the next window of the value
+		/*! \return false once the end of the value has been reached, or if no data could be read */
+		bool Next(void);
+
+		//! Get the data of the current window
+		/*! \note The data is only valid until the next call to Next(), and must be treated as read-only */
+		DataChunk &GetData(void) { return Buffers[Current]; }
+
+		//! Get the offset in the value of the current window
+		Position GetOffset(void) const { return CurrentOffset; }
+
+		//! Get the number of bytes of the value after the current window
+		Length GetRemaining(void) { return Object->GetLength() - NextOffset; }
+
+	protected:
+		//! Read a single window into a given buffer
+		size_t ReadWindow(DataChunk &Buffer, Position Offset);
+
+		//! Stop the worker thread, if running
+		void Stop(void);
+
+		//! Read each requested window until we are stopped
+		virtual void Run(void);
+	};
 }
 
 #endif // MXFLIB__KLVOBJECT_H
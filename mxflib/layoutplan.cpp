@@ -0,0 +1,239 @@
+/*! \file	layoutplan.cpp
+ *	\brief	Implementation of a planner that chooses the KAG and partition layout of a file for the storage it will be read from
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The largest granularity that the essence of each partition is block aligned to, as up to this much filler may be added per partition
+	const UInt32 MaxBlockAlign = 1024 * 1024;
+
+	//! The approximate number of seconds of essence in each body partition when not partitioning by size
+	const Int32 PartitionSeconds = 10;
+
+	//! Determine if a key is a KLV filler key
+	bool IsFillerKey(const UInt8 *Key)
+	{
+		// DRAGONS: The version byte of the filler key varies, so is not compared
+		return (memcmp(Key, KLVFill_UL_Data, 7) == 0) && (memcmp(&Key[8], &KLVFill_UL_Data[8], 8) == 0);
+	}
+
+	//! Determine if a key is a Generic Container essence element key
+	bool IsGCEssenceKey(const UInt8 *Key)
+	{
+		static const UInt8 Prefix[4] = { 0x06, 0x0e, 0x2b, 0x34 };
+		static const UInt8 GCItem[4] = { 0x0d, 0x01, 0x03, 0x01 };
+		return (memcmp(Key, Prefix, 4) == 0) && (memcmp(&Key[8], GCItem, 4) == 0);
+	}
+}
+
+
+//! Parse a profile from a string of the form "<stripe>[:<part>[:<read>]]"
+/*! \return false if the string is not a valid profile */
+bool StorageProfile::Parse(const char *Text)
+{
+	UInt32 *Fields[3] = { &StripeSize, &PartSize, &ReadSize };
+
+	int i;
+	for(i = 0; i < 3; i++)
+	{
+		char *End;
+		unsigned long Value = strtoul(Text, &End, 0);
+
+		// An empty field leaves that part of the profile unset
+		*Fields[i] = (End == Text) ? 0 : static_cast<UInt32>(Value);
+
+		if(*End == '\0') return IsSet();
+		if((*End != ':') || (i == 2)) return false;
+
+		Text = End + 1;
+	}
+
+	return false;
+}
+
+
+//! Build a description of the plan, one setting per line
+std::string LayoutPlan::GetDescription(void) const
+{
+	std::string Ret = "KAG size " + UInt64toString(KAGSize) + "\n";
+
+	if(BlockAlign) Ret += "Partition essence aligned to " + UInt64toString(BlockAlign) + " byte blocks\n";
+
+	if(PartitionSize) Ret += "Body partition roughly every " + UInt64toString(PartitionSize) + " bytes\n";
+	else if(PartitionDuration) Ret += "Body partition every " + UInt64toString(PartitionDuration) + " edit units\n";
+
+	if(!SprinkledIndex) Ret += "Complete index table in the footer\n";
+	else if(IsolatedIndex) Ret += "Index table segments in their own partitions\n";
+	else Ret += "Index table segment in each partition\n";
+
+	return Ret;
+}
+
+
+//! Choose the layout of a file for a given storage profile
+/*! \param Profile The storage the file will be read from
+ *  \param EditUnitSize The typical number of bytes in each edit unit, or zero if not known
+ *  \param EditRate The edit rate of the essence, used to space body partitions when not partitioning by size
+ */
+LayoutPlan mxflib::PlanLayout(const StorageProfile &Profile, UInt32 EditUnitSize, Rational EditRate)
+{
+	LayoutPlan Ret;
+
+	UInt32 Granularity = Profile.GetGranularity();
+	if(!Granularity) return Ret;
+
+	// The KAG must divide the granularity so that KAG boundaries fall on granularity boundaries, so use its largest power-of-two factor
+	UInt32 KAG = Granularity & (~Granularity + 1);
+
+	// DRAGONS: Each KLV is padded by half a KAG on average, so large KAGs are only used when edit units are big enough to
+	//          keep the padding to a few percent
+	UInt32 MaxKAG = EditUnitSize ? (EditUnitSize / 16) : LayoutDefaultMaxKAG;
+	if(MaxKAG < LayoutMinKAG) MaxKAG = LayoutMinKAG;
+	while(KAG > MaxKAG) KAG /= 2;
+
+	Ret.KAGSize = KAG;
+
+	// The KAG is relative to the start of each partition, so align the essence in each partition to the granularity to make
+	// the KAG boundaries fall on granularity boundaries in the file
+	if((KAG < Granularity) && (Granularity <= MaxBlockAlign)) Ret.BlockAlign = Granularity;
+
+	if(Profile.PartSize)
+	{
+		// Keep each partition within a part, with its index table segment in a partition of its own, so that the index
+		// for any frame can be fetched with a single small ranged request
+		Ret.PartitionSize = Profile.PartSize;
+		Ret.SprinkledIndex = true;
+		Ret.IsolatedIndex = true;
+	}
+	else
+	{
+		// For striped storage a complete index in the footer is read once, and partitions only need to be frequent
+		// enough for a reader of a growing file to find recent essence
+		if(EditRate.Denominator > 0)
+		{
+			Ret.PartitionDuration = (static_cast<Length>(EditRate.Numerator) * PartitionSeconds) / EditRate.Denominator;
+			if(Ret.PartitionDuration < 1) Ret.PartitionDuration = 1;
+		}
+	}
+
+	return Ret;
+}
+
+
+//! Build a report of the statistics, one per line, as "<name> <value>"
+std::string LayoutStats::GetReport(void) const
+{
+	std::string Ret;
+
+	Ret += "layout.granularity " + UInt64toString(Granularity) + "\n";
+	Ret += "layout.partitions " + UInt64toString(Partitions) + "\n";
+	Ret += "layout.partitions.aligned " + UInt64toString(AlignedPartitions) + "\n";
+	if(PartSize) Ret += "layout.partitions.oversize " + UInt64toString(OversizePartitions) + "\n";
+	Ret += "layout.essence.klvs " + UInt64toString(EssenceKLVs) + "\n";
+	Ret += "layout.essence.aligned " + UInt64toString(AlignedValues) + "\n";
+	Ret += "layout.essence.split " + UInt64toString(SplitValues) + "\n";
+	Ret += "layout.essence.bytes " + UInt64toString(EssenceBytes) + "\n";
+	Ret += "layout.fill.bytes " + UInt64toString(FillBytes) + "\n";
+	Ret += "layout.file.bytes " + UInt64toString(FileBytes) + "\n";
+
+	return Ret;
+}
+
+
+//! Measure how well the KLVs and partitions of a file line up with a storage profile
+/*! Every KLV of the file is visited, reading only its key and length
+ *  \return false if the file could not be walked to the end
+ */
+bool mxflib::MeasureLayout(MXFFilePtr &File, const StorageProfile &Profile, LayoutStats &Stats)
+{
+	Stats = LayoutStats();
+	Stats.Granularity = Profile.GetGranularity();
+	Stats.PartSize = Profile.PartSize;
+
+	UInt64 Granularity = Stats.Granularity ? Stats.Granularity : 1;
+	Length FileSize = File->Size();
+
+	Position Pos = 0;
+	Position PartitionStart = -1;
+	while(Pos < FileSize)
+	{
+		UInt8 Key[16];
+		Length ValueLength;
+		Int32 KLSize = File->ReadKLAt(Pos, Key, ValueLength);
+		if(!KLSize)
+		{
+			error("Unable to read a KLV at 0x%s in \"%s\"\n", Int64toHexString(Pos, 8).c_str(), File->Name.c_str());
+			return false;
+		}
+
+		Length KLVSize = KLSize + ValueLength;
+
+		if(IsPartitionKey(Key))
+		{
+			if((PartitionStart >= 0) && Stats.PartSize && ((Pos - PartitionStart) > static_cast<Length>(Stats.PartSize))) Stats.OversizePartitions++;
+			PartitionStart = Pos;
+
+			Stats.Partitions++;
+			if((Pos % Granularity) == 0) Stats.AlignedPartitions++;
+		}
+		else if(IsFillerKey(Key))
+		{
+			Stats.FillBytes += KLVSize;
+		}
+		else if(IsGCEssenceKey(Key))
+		{
+			Position ValueStart = Pos + KLSize;
+
+			Stats.EssenceKLVs++;
+			Stats.EssenceBytes += ValueLength;
+			if((ValueStart % Granularity) == 0) Stats.AlignedValues++;
+
+			// A value is split if reading it touches more units of the granularity than the fewest that could hold it
+			if(ValueLength > 0)
+			{
+				UInt64 Needed = (ValueLength + Granularity - 1) / Granularity;
+				UInt64 Touched = ((ValueStart + ValueLength - 1) / Granularity) - (ValueStart / Granularity) + 1;
+				if(Touched > Needed) Stats.SplitValues++;
+			}
+		}
+
+		Pos += KLVSize;
+	}
+
+	// The last partition runs to the end of the file
+	if((PartitionStart >= 0) && Stats.PartSize && ((Pos - PartitionStart) > static_cast<Length>(Stats.PartSize))) Stats.OversizePartitions++;
+
+	Stats.FileBytes = Pos;
+
+	return true;
+}
@@ -0,0 +1,125 @@
+/*! \file	layoutplan.h
+ *	\brief	Definition of a planner that chooses the KAG and partition layout of a file for the storage it will be read from
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  The KAG, body partition spacing and index placement of a file decide how its bytes line up with the stripes of a
+ *  RAID or the parts of an object store, and so how many device reads or ranged requests it takes to read a frame.
+ *  PlanLayout() chooses these settings for a StorageProfile, and MeasureLayout() reports how well the KLVs and
+ *  partitions of a finished file line up with that profile.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__LAYOUTPLAN_H
+#define MXFLIB__LAYOUTPLAN_H
+
+namespace mxflib
+{
+	//! The largest KAG chosen when the size of each edit unit is not known
+	/*! This matches the sector and page size of most storage, so keeps direct I/O aligned without much padding */
+	const UInt32 LayoutDefaultMaxKAG = 4096;
+
+	//! The smallest KAG chosen for a storage profile
+	const UInt32 LayoutMinKAG = 512;
+
+	//! The storage that a file is to be read from, all sizes in bytes with zero meaning not applicable
+	struct StorageProfile
+	{
+		UInt32 StripeSize;						//!< The stripe size of a RAID or striped filesystem
+		UInt32 PartSize;						//!< The part size of an object store, the unit of each ranged request
+		UInt32 ReadSize;						//!< The size of reads that the player or server prefers to make
+
+		StorageProfile() : StripeSize(0), PartSize(0), ReadSize(0) {}
+
+		//! Determine if any part of the profile is set
+		bool IsSet(void) const { return (StripeSize != 0) || (PartSize != 0) || (ReadSize != 0); }
+
+		//! Get the granularity that reads should be aligned to
+		/*! This is the preferred read size if given, otherwise the stripe size, otherwise the part size */
+		UInt32 GetGranularity(void) const
+		{
+			if(ReadSize) return ReadSize;
+			if(StripeSize) return StripeSize;
+			return PartSize;
+		}
+
+		//! Parse a profile from a string of the form "<stripe>[:<part>[:<read>]]"
+		/*! \return false if the string is not a valid profile */
+		bool Parse(const char *Text);
+	};
+
+	//! The layout chosen for a storage profile
+	struct LayoutPlan
+	{
+		UInt32 KAGSize;							//!< The KAG to use
+		UInt32 BlockAlign;						//!< The block size to align the essence of each partition to, or zero for none
+		Length PartitionDuration;				//!< The number of edit units in each body partition, or zero if partitioned by size
+		Length PartitionSize;					//!< The largest size of each body partition, or zero if partitioned by duration
+		bool SprinkledIndex;					//!< True to write an index table segment in each partition, otherwise a complete index in the footer
+		bool IsolatedIndex;						//!< True to keep index table segments in partitions of their own
+
+		LayoutPlan() : KAGSize(1), BlockAlign(0), PartitionDuration(0), PartitionSize(0), SprinkledIndex(false), IsolatedIndex(false) {}
+
+		//! Build a description of the plan, one setting per line
+		std::string GetDescription(void) const;
+	};
+
+	//! Choose the layout of a file for a given storage profile
+	/*! \param Profile The storage the file will be read from
+	 *  \param EditUnitSize The typical number of bytes in each edit unit, or zero if not known
+	 *  \param EditRate The edit rate of the essence, used to space body partitions when not partitioning by size
+	 */
+	LayoutPlan PlanLayout(const StorageProfile &Profile, UInt32 EditUnitSize, Rational EditRate);
+
+	//! How well the KLVs and partitions of a file line up with a storage profile
+	struct LayoutStats
+	{
+		UInt32 Granularity;						//!< The granularity that alignment was measured against
+		UInt32 PartSize;						//!< The part size that partition sizes were measured against, or zero
+		UInt64 Partitions;						//!< The number of partition packs
+		UInt64 AlignedPartitions;				//!< The number of partition packs starting on a granularity boundary
+		UInt64 OversizePartitions;				//!< The number of partitions larger than one part
+		UInt64 EssenceKLVs;						//!< The number of Generic Container essence KLVs
+		UInt64 AlignedValues;					//!< The number of essence values starting on a granularity boundary
+		UInt64 SplitValues;						//!< The number of essence values touching more granularity units than their size needs
+		UInt64 EssenceBytes;					//!< The total size of the essence values
+		UInt64 FillBytes;						//!< The total size of all filler KLVs, including their keys and lengths
+		UInt64 FileBytes;						//!< The total size of all the KLVs walked
+
+		LayoutStats() : Granularity(0), PartSize(0), Partitions(0), AlignedPartitions(0), OversizePartitions(0), EssenceKLVs(0),
+						AlignedValues(0), SplitValues(0), EssenceBytes(0), FillBytes(0), FileBytes(0) {}
+
+		//! Build a report of the statistics, one per line, as "<name> <value>"
+		std::string GetReport(void) const;
+	};
+
+	//! Measure how well the KLVs and partitions of a file line up with a storage profile
+	/*! Every KLV of the file is visited, reading only its key and length
+	 *  \return false if the file could not be walked to the end
+	 */
+	bool MeasureLayout(MXFFilePtr &File, const StorageProfile &Profile, LayoutStats &Stats);
+}
+
+#endif // MXFLIB__LAYOUTPLAN_H
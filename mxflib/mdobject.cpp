@@ -42,6 +42,9 @@ using namespace mxflib;
 //! Static flag to say if dark metadata sets that appear to be valid KLV 2x2 sets should be parsed
 bool MDObject::ParseDark = false;
 
+//! Static count of items at which arrays of fixed-size items are read as packed bytes, or zero to never pack
+UInt32 MDObject::PackThreshold = 0;
+
 //! Static primer to use for index tables
 PrimerPtr MDOType::StaticPrimer;
 
@@ -51,6 +54,125 @@ SymbolSpaceMap SymbolSpace::AllSymbolSpaces;
 //! Global SymbolSpace for all MXFLib's normal symbols
 SymbolSpacePtr mxflib::MXFLibSymbols = new SymbolSpace("http://www.freemxf.org/MXFLibSymbols");
 
+//! Set true once the dictionary is frozen
+bool MDOType::Frozen = false;
+
+
+//! Construct a new symbol space
+/*! Once the dictionary is frozen the new symbol space is added to the active overlay rather than the list of all symbol spaces */
+SymbolSpace::SymbolSpace(std::string Name) : SymName(Name), Frozen(false)
+{
+	if(MDOType::IsFrozen())
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) Overlay->AddSymbolSpace(this);
+		else error("Symbol space \"%s\" cannot be added as the dictionary is frozen and no overlay is active\n", Name.c_str());
+
+		return;
+	}
+
+	SymbolSpaceMap::iterator it = AllSymbolSpaces.find(Name);
+
+	if(it != AllSymbolSpaces.end())
+	{
+		error("Duplicate symbol space name \"%s\"\n", Name.c_str());
+	}
+
+	AllSymbolSpaces.insert(SymbolSpaceMap::value_type(Name, this));
+}
+
+
+//! Add a new symbol to this symbol space
+/*! \return true if added OK, else false (most likely a duplicate symbol name)
+ */
+bool SymbolSpace::AddSymbol(std::string Symbol, ULPtr &UL)
+{
+	iterator it = find(Symbol);
+	if(it != end()) return false;
+
+	if(Frozen)
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(!Overlay)
+		{
+			error("Symbol %s cannot be added to symbol space \"%s\" as the dictionary is frozen and no overlay is active\n", Symbol.c_str(), SymName.c_str());
+			return false;
+		}
+
+		return Overlay->AddSymbol(SymName, Symbol, UL);
+	}
+
+	insert(value_type(Symbol, UL));
+
+	return true;
+}
+
+
+//! Locate the given symbol in this symbol space, optionally check all other spaces too
+ULPtr SymbolSpace::Find(std::string Symbol, bool SearchAll /*=false*/) const
+{
+	const_iterator it = find(Symbol);
+
+	if(it != end()) return (*it).second;
+
+	// Symbols added since the dictionary was frozen are in the overlay
+	TypeOverlay *Overlay = Frozen ? TypeOverlay::Current() : NULL;
+	if(Overlay)
+	{
+		ULPtr Ret = Overlay->FindSymbol(SymName, Symbol);
+		if(Ret) return Ret;
+	}
+
+	if(SearchAll)
+	{
+		SymbolSpaceMap::iterator map_it = AllSymbolSpaces.begin();
+		while(map_it != AllSymbolSpaces.end())
+		{
+			it = (*map_it).second->find(Symbol);
+			if(it != (*map_it).second->end()) return (*it).second;
+
+			map_it++;
+		}
+
+		if(MDOType::IsFrozen())
+		{
+			Overlay = TypeOverlay::Current();
+			if(Overlay) return Overlay->FindSymbol(Symbol);
+		}
+	}
+
+	return NULL;
+}
+
+
+//! Find the symbol space with a given name
+SymbolSpacePtr SymbolSpace::FindSymbolSpace(std::string Name)
+{
+	SymbolSpaceMap::iterator it = AllSymbolSpaces.find(Name);
+
+	if(it != AllSymbolSpaces.end()) return (*it).second;
+
+	if(MDOType::IsFrozen())
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) return Overlay->FindSymbolSpace(Name);
+	}
+
+	return NULL;
+}
+
+
+//! Set whether the existing symbol spaces may be changed, used when the dictionary is frozen or cleared
+void SymbolSpace::SetAllFrozen(bool Value)
+{
+	SymbolSpaceMap::iterator it = AllSymbolSpaces.begin();
+	while(it != AllSymbolSpaces.end())
+	{
+		(*it).second->Frozen = Value;
+		it++;
+	}
+}
+
 //! Translator function to translate unknown ULs to object names
 MDObject::ULTranslator MDObject::UL2NameFunc = NULL;
 
@@ -115,7 +237,7 @@ PrimerPtr MDOType::MakePrimer(bool SetStatic /*=false*/)
 /*! This constructor is private so the ONLY way to create
  *	new MDOTypes from outside this class is via member methods
 */
-MDOType::MDOType(void)
+MDOType::MDOType(void) : ChildIndex(true), ChildIndexValid(false)
 {
 	// Initialise dictionary data
 	KeyFormat = DICT_KEY_NONE;
@@ -161,6 +283,9 @@ MDOTypePtr MDOType::Find(std::string BaseType, SymbolSpacePtr &SymSpace, bool Se
 		if(ThisUL) return MDOType::Find(ThisUL);
 	}
 
+	// The type may be in a compiled-in dictionary that is built on demand
+	if(LoadOnDemandClass(BaseType)) return Find(BaseType, SymSpace, SearchAll);
+
 	return NULL;
 }
 
@@ -173,11 +298,11 @@ MDOTypePtr MDOType::Find(const UL& BaseUL)
 {
 	MDOTypePtr theType;
 
-	std::map<UL, MDOTypePtr>::iterator it = ULLookup.find(BaseUL);
+	const MDOTypePtr *Found = ULLookup.Find(BaseUL);
 
-	if(it != ULLookup.end())
+	if(Found)
 	{
-		theType = (*it).second;
+		theType = *Found;
 	}
 	else
 	{
@@ -187,18 +312,81 @@ MDOTypePtr MDOType::Find(const UL& BaseUL)
 			UL Ver1UL = BaseUL;
 			Ver1UL.Set(7, 1);
 
-			std::map<UL, MDOTypePtr>::iterator it2 = ULLookupVer1.find(Ver1UL);
-			if(it2 != ULLookupVer1.end())
+			Found = ULLookupVer1.Find(Ver1UL);
+			if(Found)
 			{
-				theType = (*it2).second;
+				theType = *Found;
 			}
 		}
 	}
 
+	// The type may be in a compiled-in dictionary that is built on demand
+	if(!theType && LoadOnDemandClass(BaseUL)) return Find(BaseUL);
+
+	// Once the dictionary is frozen, any later classes are in the active overlay
+	if(!theType && Frozen)
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) theType = Overlay->FindClass(BaseUL);
+	}
+
 	return theType;
 }
 
 
+//! Get a value that changes whenever types are added or removed, so that cached type lookups can be discarded
+/*! Once the dictionary is frozen this also changes when classes are added to the overlay active on this thread */
+UInt32 MDOType::GetLookupGeneration(void)
+{
+	if(Frozen)
+	{
+		// DRAGONS: The global generation no longer changes, so adding the overlay count gives a new value for each class added to it
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) return LookupGeneration + Overlay->GetGeneration();
+	}
+
+	return LookupGeneration;
+}
+
+
+//! Freeze the dictionary, so that the lookups and existing types are only read from now on
+void MDOType::Freeze(void)
+{
+	Frozen = true;
+	SymbolSpace::SetAllFrozen(true);
+}
+
+
+//! Clear any loaded dictionary data
+/*! This can be used before loading a different dictionary, or to free allocated memory for debugging (such as memory leak detection) */
+void MDOType::ClearDict(void)
+{
+	AllTypes.clear();
+	TopTypes.clear();
+	ULLookup.clear();
+	ULLookupVer1.clear();
+	LookupGeneration++;
+	NameLookup.clear();
+	InternalsDefined = false;
+	ClearOnDemandClasses();
+	Frozen = false;
+	SymbolSpace::SetAllFrozen(false);
+
+	// Any cached overlays were built on top of the old dictionary
+	TypeOverlay::ClearCache();
+}
+
+
+//! Determine if a class is part of the frozen dictionary, rather than defined later in an overlay
+bool MDOType::IsFrozenClass(const MDOTypePtr &Class)
+{
+	if(!Frozen || !Class->TypeUL) return false;
+
+	const MDOTypePtr *Registered = ULLookup.Find(*Class->TypeUL);
+	return Registered && (*Registered == Class);
+}
+
+
 //! Find the MDOType object that defines a type with a specified Tag
 /*! The tag is looked up in the supplied primer
  *	\note if BasePrimer is NULL then the static primer is searched
@@ -210,13 +398,18 @@ MDOTypePtr MDOType::Find(Tag BaseTag, PrimerPtr BasePrimer)
 	MDOTypePtr theType;
 
 	// Search the static primer by default
-	if(!BasePrimer) BasePrimer = GetStaticPrimer();
+	bool StaticPrimer = !BasePrimer;
+	if(StaticPrimer) BasePrimer = GetStaticPrimer();
 
 	// Search the primer
 	Primer::iterator it = BasePrimer->find(BaseTag);
 
-	// Return NULL if not in the primer
-	if(it == BasePrimer->end()) return NULL;
+	// Return NULL if not in the primer, unless it is a static tag of a class that is built on demand
+	if(it == BasePrimer->end())
+	{
+		if(StaticPrimer && LoadOnDemandClass(BaseTag)) return Find(BaseTag, NULL);
+		return NULL;
+	}
 
 	// Now search on the located UL
 	return MDOType::Find((*it).second);
@@ -241,7 +434,7 @@ MDObject::MDObject(std::string BaseType, SymbolSpacePtr &SymSpace /*=MXFLibSymbo
 	if(ThisUL) Type = MDOType::Find(ThisUL);
 	if(Type)
 	{
-		ObjectName = Type->Name();
+		ShareName(Type->GetInternedName());
 	}
 	else
 	{
@@ -251,7 +444,7 @@ MDObject::MDObject(std::string BaseType, SymbolSpacePtr &SymSpace /*=MXFLibSymbo
 
 		mxflib_assert(Type);
 
-		ObjectName = "Unknown " + BaseType;
+		SetName("Unknown " + BaseType);
 	}
 
 	// Set up the value type
@@ -277,6 +470,7 @@ MDObject::MDObject(std::string BaseType, SymbolSpacePtr &SymSpace /*=MXFLibSymbo
 	TheTag = 0;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -305,7 +499,7 @@ MDObject::MDObject(MDOTypePtr BaseType) : Type(BaseType)
 	else
 		IsValue = false;
 
-	ObjectName = BaseType->Name();
+	ShareName(BaseType->GetInternedName());
 	
 	IsConstructed = true;
 	IsSubItem = false;
@@ -317,6 +511,7 @@ MDObject::MDObject(MDOTypePtr BaseType) : Type(BaseType)
 	TheTag = 0;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -339,7 +534,7 @@ MDObject::MDObject(const MDType *ValType)
 	mxflib_assert(ValueType);
 	if(!ValueType) ValueType = MDType::Find("UnknownType");
 
-	ObjectName = ValueType->Name();
+	ShareName(ValueType->GetInternedName());
 
 	// Set the legacy value link to us as we are a value
 	Value = this;
@@ -354,6 +549,7 @@ MDObject::MDObject(const MDType *ValType)
 	TheTag = 0;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -372,7 +568,7 @@ MDObject::MDObject(MDTraitsPtr &Tr)
 	ValueType = MDType::Find("UnknownType");
 	mxflib_assert(ValueType);
 
-	ObjectName = Tr->Name();
+	SetName(Tr->Name());
 
 	// Set the legacy value link to us as we are a value
 	Value = this;
@@ -387,6 +583,7 @@ MDObject::MDObject(MDTraitsPtr &Tr)
 	TheTag = 0;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -410,7 +607,7 @@ void MDObject::ULCtor(void)
 	Type = MDOType::Find(TheUL);
 	if(Type)
 	{
-		ObjectName = Type->Name();
+		ShareName(Type->GetInternedName());
 		if(Type->GetContainerType() == NONE)
 		{
 			ValueType = Type->GetValueType();
@@ -429,7 +626,7 @@ void MDObject::ULCtor(void)
 		if(ValueType)
 		{
 			Type = MDOType::Find("Unknown");
-			ObjectName = ValueType->Name();
+			ShareName(ValueType->GetInternedName());
 			
 			// Set the legacy value link to us as we are a value
 			Value = this;
@@ -453,6 +650,7 @@ void MDObject::ULCtor(void)
 	TheTag = 0;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -469,12 +667,12 @@ void MDObject::UnknownCtor(void)
 {
 	if(UL2NameFunc)
 	{
-		ObjectName = UL2NameFunc(TheUL,NULL);
+		SetName(UL2NameFunc(TheUL,NULL));
 
 		if(ObjectName.empty())
 		{
 			// If we were unable to translate at all, use the normal pattern
-			ObjectName = "Unknown";
+			SetName("Unknown");
 			if(TheTag) ObjectName += " " + Tag2String(TheTag);
 			if(!(TheUL->Matches(AbstractObject_UL))) ObjectName += " " + TheUL->GetString();
 		}
@@ -490,7 +688,7 @@ void MDObject::UnknownCtor(void)
 	}
 	else
 	{
-		ObjectName = "Unknown";
+		SetName("Unknown");
 		if(TheTag) ObjectName += " " + Tag2String(TheTag);
 		if(!(TheUL->Matches(AbstractObject_UL))) ObjectName += " " + TheUL->GetString();
 	}
@@ -534,6 +732,7 @@ void MDObject::UnknownCtor(void)
 	ParentFile = NULL;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -549,10 +748,10 @@ MDObject::MDObject(Tag BaseTag, PrimerPtr BasePrimer)
 	// Try and find the tag in the primer
 	if(BasePrimer) 
 	{
-		Primer::iterator it = BasePrimer->find(BaseTag);
+		const Primer::TagType *Found = BasePrimer->LookupType(BaseTag);
 
 		// Didn't find it!!
-		if(it == BasePrimer->end())
+		if(!Found)
 		{
 			/* MJB 8-June-2007: DRAGONS: Don't complain about AAF built-in tags */
 			if(BaseTag >= 0x0100)
@@ -570,9 +769,10 @@ MDObject::MDObject(Tag BaseTag, PrimerPtr BasePrimer)
 		}
 		else
 		{
-			// It was found in the primer, so lookup the type from the UL
-			TheUL = new UL((*it).second);
-			Type = MDOType::Find(TheUL);
+			// It was found in the primer, so use the type with that UL
+			// DRAGONS: The UL is shared with the primer's cache, which is safe as a ULPtr is never used to modify a UL in place
+			TheUL = Found->TypeUL;
+			Type = Found->Type;
 		}
 	}
 	else
@@ -591,7 +791,7 @@ MDObject::MDObject(Tag BaseTag, PrimerPtr BasePrimer)
 		return;
 	}
 
-	ObjectName = Type->Name();
+	ShareName(Type->GetInternedName());
 
 	// Set up the value type
 	if(Type->GetContainerType() == NONE)
@@ -615,6 +815,7 @@ MDObject::MDObject(Tag BaseTag, PrimerPtr BasePrimer)
 	TheTag = BaseTag;
 
 	Outer = NULL;
+	PackedCount = 0;
 
 	// Initialise the new object
 	Init();
@@ -997,6 +1198,9 @@ bool remove_this_stub;
  */
 MDObjectPtr MDObject::AddChildInternal(MDObjectPtr ChildObject, bool Replace /* = false */)
 {
+	// Packed items must become children before any more are added
+	if(PackedCount) Unpack();
+
 	// If replacing, remove any existing children of this type
 	if (Replace) RemoveChild(ChildObject->Type);
 
@@ -1108,6 +1312,34 @@ MDObjectPtr MDObject::operator[](const std::string ChildName) const
 }
 
 
+//! Access sub-item by interned name within a compound MDObject
+/*! If the child does not exist in this item then NULL is returned
+ *  even if it is a valid child to have in this type of container
+ *
+ *  DRAGONS: This doesn't work well with SmartPtrs
+ *           so member function Child() is also available
+*/
+MDObjectPtr MDObject::operator[](const InternedName &ChildName) const
+{
+	MDObjectULList::const_iterator it = begin();
+	while(it != end())
+	{
+		const MDObject *Item = (*it).second;
+
+		// Names shared with the type are interned, so can be matched by pointer - other names need a full compare
+		if(Item->TypeName)
+		{
+			if(ChildName.Is(Item->TypeName)) return (*it).second;
+		}
+		else if(Item->ObjectName == ChildName.Name()) return (*it).second;
+
+		it++;
+	}
+
+	return NULL;
+}
+
+
 //! Access sub-item of the specified type within a compound MDObject
 /*! If the child does not exist in this item then NULL is returned
  *  even if it is a valid child to have in this type of container
@@ -1294,6 +1526,16 @@ size_t MDObject::ReadValue(const UInt8 *Buffer, size_t Size, PrimerPtr UsePrimer
 	size_t Count = 0;
 	UInt32 ItemSize = 0;
 
+	// Any bytes cached for the containing set no longer match
+	ClearWriteCache();
+
+	// Any packed items are replaced by the new value
+	if(PackedCount)
+	{
+		PackedCount = 0;
+		Data.Resize(0);
+	}
+
 	// Allow arrays and batches to be handled by thier traits if known
 	MDContainerType CType = GetContainerType();
 	if(((CType == ARRAY) || (CType == BATCH)) && Traits) CType = NONE;
@@ -1789,6 +2031,9 @@ void MDObject::Resize(UInt32 Count)
 	// simply validate the size
 	if(ValueType->GetSize()) Count = ValueType->GetSize();
 
+	// Packed items must become children before resizing
+	if(PackedCount) Unpack();
+
 	if(Count == 0)
 	{
 		clear();
@@ -1816,6 +2061,92 @@ void MDObject::Resize(UInt32 Count)
 }
 
 
+//! Get a view of the items of this array value, if held as packed bytes
+/*! \return An empty view if the items are held as child objects */
+MDPackedArray MDObject::GetPackedArray(void) const
+{
+	if(!PackedCount) return MDPackedArray();
+
+	return MDPackedArray(Data.Data, PackedCount, Data.Size / PackedCount, ValueType->EffectiveBase());
+}
+
+
+//! Hold the items of this array value as packed bytes, replacing any child objects
+/*! \param Buffer The bytes of the items, without any batch header
+ *  \param Count The number of items
+ *  \param ItemSize The size of each item, in bytes
+ */
+void MDObject::SetPacked(const UInt8 *Buffer, UInt32 Count, size_t ItemSize)
+{
+	clear();
+
+	Data.Set(Count * ItemSize, Buffer);
+	PackedCount = Count;
+}
+
+
+//! Build child objects for the items of this array value if they are held as packed bytes
+void MDObject::Unpack(void)
+{
+	if(!PackedCount) return;
+
+	// Take a copy of the packed bytes as our data is cleared as we unpack
+	DataChunk Items(Data.Size, Data.Data);
+	size_t ItemSize = Items.Size / PackedCount;
+	UInt32 Count = PackedCount;
+
+	PackedCount = 0;
+	Data.Resize(0);
+
+	MDTypePtr Base = ValueType->EffectiveBase();
+
+	UInt32 i;
+	for(i = 0; i < Count; i++)
+	{
+		// DRAGONS: The item is added before reading its value because some complex traits need to know the parent details
+		MDObjectPtr NewItem = new MDObject(Base);
+		insert(NewItem);
+
+		NewItem->ReadValue(&Items.Data[i * ItemSize], ItemSize);
+	}
+}
+
+
+//! Get the offset of a named member within each item of a compound type
+/*! \return The offset, or -1 if there is no such member or it follows a variable size member */
+int MDPackedArray::GetMemberOffset(const std::string &Member) const
+{
+	if(!ItemType) return -1;
+
+	int Offset = 0;
+	MDTypeList::const_iterator it = ItemType->GetChildList().begin();
+	while(it != ItemType->GetChildList().end())
+	{
+		if((*it)->Name() == Member) return Offset;
+
+		UInt32 Size = (*it)->EffectiveSize();
+		if(!Size) return -1;
+
+		Offset += static_cast<int>(Size);
+		it++;
+	}
+
+	return -1;
+}
+
+
+//! Build an MDObject holding a copy of a given item, or NULL if out of range
+MDObjectPtr MDPackedArray::MakeItem(size_t Index) const
+{
+	if((Index >= Count) || !ItemType) return NULL;
+
+	MDObjectPtr Ret = new MDObject(ItemType);
+	Ret->ReadValue(&Items[Index * ItemSize], ItemSize);
+
+	return Ret;
+}
+
+
 //! Has this object (including any child objects) been modified?
 bool MDObject::IsModified(void) const
 {
@@ -1869,7 +2200,7 @@ bool MDObject::SetGenerationUID(UUIDPtr NewGen)
 	if((CType != SET) && (CType != PACK)) return false;
 
 	// Find (or add) the GenerationUID property
-	MDObjectPtr GenUID = Child("GenerationUID");
+	MDObjectPtr GenUID = Child(GenerationUID_UL);
 	if(!GenUID)
 	{
 		// If we don't currently have a GenerationUID, first check if this is because we shouldn't have one
@@ -2121,12 +2452,13 @@ DataChunkPtr MDObject::PutData(PrimerPtr UsePrimer /* =NULL */) const
 	if(EffClass == ARRAYEXPLICIT)
 	{
 		UInt8 Buffer[8];
-		PutU32(static_cast<UInt32>(size()), Buffer);
+		UInt32 Count = PackedCount ? PackedCount : static_cast<UInt32>(size());
+		PutU32(Count, Buffer);
 
 		UInt32 ItemSize = ValueType->EffectiveBase()->EffectiveSize();
 		
 		// Calculate item size if variable (and not empty)
-		if((ItemSize == 0) && (size() > 0)) ItemSize = static_cast<UInt32>((Ret->Size - 8) / size());
+		if((ItemSize == 0) && (Count > 0)) ItemSize = static_cast<UInt32>((Ret->Size - 8) / Count);
 
 		PutU32(ItemSize, &Buffer[4]);
 
@@ -2194,6 +2526,221 @@ size_t MDObject::WriteLinkedSubObjects(DataChunkPtr &Buffer, PrimerPtr UsePrimer
 }
 
 
+//! Add this top level object, and any strongly linked sub-objects, to a list in the order WriteLinkedObjects() writes them
+void MDObject::GetLinkedObjects(MDObjectList &List)
+{
+	List.push_back(this);
+
+	MDObjectULList::iterator it = begin();
+	while(it != end())
+	{
+		if((*it).second->Link)
+		{
+			if((*it).second->GetRefType() == DICT_REF_STRONG) (*it).second->Link->GetLinkedObjects(List);
+		}
+		else if(!((*it).second->empty()))
+		{
+			// Strong references may be held within sub-items, such as batches of references
+			(*it).second->GetLinkedSubObjects(List);
+		}
+		it++;
+	}
+}
+
+
+//! Add any items strongly linked from sub-items to a list in the order WriteLinkedSubObjects() writes them
+void MDObject::GetLinkedSubObjects(MDObjectList &List)
+{
+	MDObjectULList::iterator it = begin();
+	while(it != end())
+	{
+		if((*it).second->Link)
+		{
+			if((*it).second->GetRefType() == DICT_REF_STRONG) (*it).second->Link->GetLinkedObjects(List);
+		}
+		else if(!((*it).second->empty()))
+		{
+			(*it).second->GetLinkedSubObjects(List);
+		}
+		it++;
+	}
+}
+
+
+//! Add the local tags that writing this object will use to a primer, in the order that writing it would add them
+/*! DRAGONS: This follows the order that WriteObject() visits properties, other than within packs (which are written in
+ *           the order of their definition) as packs do not normally contain local sets. Any tag missed here is still added
+ *           when the object is written, but may then be given a different dynamic tag.
+ */
+void MDObject::AddTagsToPrimer(PrimerPtr &UsePrimer) const
+{
+	// Only properties of local sets are written with local tags
+	bool LocalTags = (Type->GetContainerType() == SET) && (Type->GetKeyFormat() == DICT_KEY_2_BYTE);
+
+	MDObjectULList::const_iterator it = begin();
+	while(it != end())
+	{
+		if(LocalTags && (*it).second->TheUL) UsePrimer->Lookup((*it).second->TheUL, (*it).second->TheTag);
+
+		if(!((*it).second->empty())) (*it).second->AddTagsToPrimer(UsePrimer);
+
+		it++;
+	}
+}
+
+
+//! Get the bytes of this top level set as last written by a cached write, if still valid for a given primer
+/*! The local tags used in the cached bytes are added to the primer if not already there.
+ *  \return NULL if this set has not been cached, has changed since, or its tags conflict with the primer
+ */
+DataChunkPtr MDObject::GetWriteCache(PrimerPtr &UsePrimer)
+{
+	if(!WriteCache) return NULL;
+
+	// Check that every tag used means the same in this primer, or is not yet used by it
+	std::vector<std::pair<Tag, UL> >::iterator it = WriteCache->Tags.begin();
+	while(it != WriteCache->Tags.end())
+	{
+		if(!UsePrimer->CanUse((*it).second, (*it).first)) return NULL;
+		it++;
+	}
+
+	// Add any tags not yet in the primer
+	it = WriteCache->Tags.begin();
+	while(it != WriteCache->Tags.end())
+	{
+		UsePrimer->insert(Primer::value_type((*it).first, (*it).second));
+		it++;
+	}
+
+	return WriteCache->Data;
+}
+
+
+namespace
+{
+	//! Determine if any of the properties of an object, or their sub-items, are sets
+	bool ContainsSet(const MDObject *Object)
+	{
+		MDObjectULList::const_iterator it = Object->begin();
+		while(it != Object->end())
+		{
+			if((*it).second->GetContainerType() == SET) return true;
+			if((!(*it).second->empty()) && ContainsSet((*it).second)) return true;
+			it++;
+		}
+
+		return false;
+	}
+}
+
+
+//! Keep the bytes of this top level set, as written with a given primer, for reuse by later writes
+/*! Only local sets, with no sets nested within their properties, are cached */
+void MDObject::SetWriteCache(DataChunkPtr &Data, PrimerPtr &UsePrimer)
+{
+	if((Type->GetContainerType() != SET) || (Type->GetKeyFormat() != DICT_KEY_2_BYTE)) return;
+
+	// Nested sets would also need their tags recording, so these are simply not cached
+	if(ContainsSet(this)) return;
+
+	std::vector<std::pair<Tag, UL> > Tags;
+	Tags.reserve(size());
+
+	MDObjectULList::iterator it = begin();
+	while(it != end())
+	{
+		if(!(*it).second->TheUL) return;
+
+		Tags.push_back(std::pair<Tag, UL>(UsePrimer->Lookup((*it).second->TheUL, (*it).second->TheTag), *((*it).second->TheUL)));
+		it++;
+	}
+
+	WriteCache = new MDObjectWriteCache;
+	WriteCache->Data = Data;
+	WriteCache->Tags.swap(Tags);
+}
+
+
+//! Keep the bytes of this top level set as read, for reuse if it is written unchanged
+/*! \param Buffer The buffer holding the set, which is referenced rather than copied
+ *  \param Offset The offset of the key of the set in Buffer
+ *  \param Size The size of the whole KLV of the set
+ *  \param ReadPrimer The primer used to read the set
+ *  \note This must be called after the value has been read, as ReadValue() discards any cached bytes.
+ *        Only local sets with 2-byte lengths, no sets nested within their properties and all tags known
+ *        to ReadPrimer are kept
+ */
+void MDObject::KeepReadBytes(DataChunkPtr &Buffer, size_t Offset, size_t Size, PrimerPtr &ReadPrimer)
+{
+	if((!ReadPrimer) || (Type->GetContainerType() != SET) || (Type->GetKeyFormat() != DICT_KEY_2_BYTE) || (Type->GetLenFormat() != DICT_LEN_2_BYTE)) return;
+
+	if((Size < 17) || ((Offset + Size) > Buffer->Size)) return;
+
+	// Nested sets would also need their tags recording, so these are simply not kept
+	if(ContainsSet(this)) return;
+
+	// Skip the key and BER length to find the value
+	const UInt8 *Ptr = &Buffer->Data[Offset + 16];
+	size_t Remaining = Size - 16;
+
+	size_t LenSize = 1;
+	UInt64 ValueLen = *Ptr;
+	if(ValueLen >= 0x80)
+	{
+		LenSize += (*Ptr & 0x7f);
+		if((LenSize > 9) || (LenSize > Remaining)) return;
+
+		ValueLen = 0;
+		size_t i;
+		for(i=1; i<LenSize; i++) ValueLen = (ValueLen << 8) + Ptr[i];
+	}
+
+	// Only keep complete sets
+	if((LenSize > Remaining) || (ValueLen != (Remaining - LenSize))) return;
+
+	Ptr += LenSize;
+	Remaining -= LenSize;
+
+	// Record the UL of every tag used, as the primer used when writing may differ from the one read
+	std::vector<std::pair<Tag, UL> > Tags;
+	while(Remaining)
+	{
+		if(Remaining < 4) return;
+
+		Tag ThisTag = GetU16(Ptr);
+		size_t ThisLen = GetU16(&Ptr[2]);
+		if((ThisLen + 4) > Remaining) return;
+
+		Primer::iterator it = ReadPrimer->find(ThisTag);
+		if(it == ReadPrimer->end()) return;
+
+		Tags.push_back(std::pair<Tag, UL>(ThisTag, (*it).second));
+
+		Ptr += ThisLen + 4;
+		Remaining -= ThisLen + 4;
+	}
+
+	WriteCache = new MDObjectWriteCache;
+	WriteCache->Data = new DataChunk;
+	WriteCache->Data->SetBuffer(Buffer, &Buffer->Data[Offset], Size);
+	WriteCache->Tags.swap(Tags);
+}
+
+
+//! Discard any cached bytes for this object and the objects containing it
+void MDObject::ClearWriteCache(void)
+{
+	MDObject *Ptr = this;
+	while(Ptr)
+	{
+		if(Ptr->WriteCache) Ptr->WriteCache = NULL;
+
+		Ptr = Ptr->Parent.GetPtr();
+	}
+}
+
+
 #ifdef OPTION3ENABLED
 //! Determine the nearest baseline UL for this type
 /*! The nearest baseline UL is the key of the closest type in the derevation chain to be a baseline class
@@ -2267,7 +2814,8 @@ size_t MDObject::WriteObject(DataChunkPtr &Buffer, const MDObject *ParentObject,
 	MDContainerType CType = Type->GetContainerType();
 	
 	// Treat value containers the same way as type containers
-	if((CType == NONE) && (ValueType && (ValueType->EffectiveClass() == TYPEARRAY)))
+	// DRAGONS: Packed arrays have no children, so are written from their value bytes
+	if((CType == NONE) && (ValueType && (ValueType->EffectiveClass() == TYPEARRAY)) && !PackedCount)
 	{
 		if(ValueType->EffectiveType()->GetArrayClass() == ARRAYEXPLICIT) CType = BATCH; else CType = ARRAY;
 	}
@@ -2707,6 +3255,7 @@ MDObjectPtr MDObject::MakeCopy(void) const
 	Ret->TheTag = TheTag;
 	Ret->Traits = Traits;
 	Ret->ObjectName = ObjectName;
+	Ret->TypeName = TypeName;
 
 	Ret->SetModified(true);
 
@@ -2768,6 +3317,7 @@ void MDOType::Derive(MDOTypePtr &BaseEntry)
 	
 	// Remove any of our existing children
 	clear();
+	ChildIndexValid = false;
 
 	// Add children from base class
 	MDOTypeList::iterator it = BaseEntry->ChildList.begin();
@@ -2775,7 +3325,7 @@ void MDOType::Derive(MDOTypePtr &BaseEntry)
 	{
 		// Add the base types children
 		insert(*it);
-		NameLookup[RootName + DictName + "/" + (*it)->Name()] = *it;
+		if(!Frozen) NameLookup[RootName + DictName.Name() + "/" + (*it)->Name()] = *it;
 		it++;
 	}
 
@@ -2817,6 +3367,7 @@ void MDOType::ReDerive(MDOTypePtr &BaseEntry)
 			
 			ChildList.insert(ChildListIt, *it);
 			ChildOrder.insert(ChildOrderIt, NewName);
+			ChildIndexValid = false;
 		}
 
 		// Increment the insertion points (unless already at the end of the lists)
@@ -2951,8 +3502,17 @@ bool MDOType::HasA(const ULPtr &ChildType) const
 //! Locate reference target types for any types not yet located
 void mxflib::MDOType::LocateRefTypes(void)
 {
-	MDOTypeList::iterator it = MDOType::AllTypes.begin();
-	while(it != MDOType::AllTypes.end())
+	// Once the dictionary is frozen its types are all located, so only those in the overlay need to be
+	MDOTypeList *Types = &AllTypes;
+	if(Frozen)
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(!Overlay) return;
+		Types = &Overlay->GetClasses();
+	}
+
+	MDOTypeList::iterator it = Types->begin();
+	while(it != Types->end())
 	{
 		// Locate the reference target if the name exists, but not the type
 		if((*it)->RefTargetName.size() && !(*it)->RefTarget)
@@ -3020,7 +3580,7 @@ bool MDObject::ChangeType(const UL &NewType)
 		}
 	}
 
-	ObjectName = Type->Name();
+	ShareName(Type->GetInternedName());
 	TheTag = MDOType::GetStaticPrimer()->Lookup(TheUL);
 
 	return true;
@@ -3050,10 +3610,68 @@ std::pair<MDOType::iterator, bool> MDOType::insert(MDOTypePtr NewType)
 	std::pair<iterator, bool> Ret = MDOTypeMap::insert(MDOTypeMap::value_type(NewName, NewType));
 	ChildList.push_back(NewType);
 	ChildOrder.push_back(NewName);
+	ChildIndexValid = false;
 	return Ret;
 }
 
 
+namespace
+{
+	//! Lock used to prevent two threads building the same child index at once
+	Mutex ChildIndexLock;
+}
+
+
+//! Locate a child by UL
+/*! The UL is compared with UL::Matches(), so the version number is ignored.
+ *  \note If more than one child matches, the first in name order is returned
+ */
+MDOTypePtr MDOType::Child(const UL &ChildType) const
+{
+	// (Re)build the index if our children have changed since it was built
+	if(!ChildIndexValid)
+	{
+		MutexLock Locked(ChildIndexLock);
+
+		if(!ChildIndexValid)
+		{
+			ChildIndex.clear();
+			ChildIndex.reserve(size());
+
+			// DRAGONS: Add the children in name order, to match the order this was previously searched
+			MDOTypeMap::const_iterator it = begin();
+			while(it != end())
+			{
+				if((*it).second->TypeUL) ChildIndex.Add(*((*it).second->TypeUL), (*it).second);
+				it++;
+			}
+
+			ChildIndexValid = true;
+		}
+	}
+
+	const MDOTypePtr *Found = ChildIndex.Find(ChildType);
+	if(Found) return *Found;
+
+	return NULL;
+}
+
+
+//! Locate a named child, by interned name
+/*! As the names of all types are interned this compares pointers rather than strings */
+MDOTypePtr MDOType::Child(const InternedName &Name) const
+{
+	MDOTypeMap::const_iterator it = begin();
+	while(it != end())
+	{
+		if((*it).second->DictName == Name) return (*it).second;
+		it++;
+	}
+
+	return NULL;
+}
+
+
 //! Locate a numerically indexed child
 /*! DRAGONS: If the type is not numerically indexed then the index will be treated as a 0-based ChildList index */
 MDOTypePtr MDOType::Child(int Index) const
@@ -3140,6 +3758,22 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 		Ret = MDOType::Find(RootName + ThisClass->Name, ThisSymbolSpace);
 	}
 
+	if(Frozen)
+	{
+		// Once the dictionary is frozen its classes are never changed, so a new definition of one leaves it as it is
+		// DRAGONS: Any new children in that definition are not added either, so are read as unknown items
+		if(Ret && IsFrozenClass(Ret)) return Ret;
+
+		if(!TypeOverlay::Current())
+		{
+			error("Class %s cannot be defined as the dictionary is frozen and no overlay is active\n", ThisClass->Name.c_str());
+			return NULL;
+		}
+	}
+
+	// A frozen parent cannot have children added, but the new class can still be found in the overlay
+	bool FrozenParent = Frozen && Parent && IsFrozenClass(Parent);
+
 	// Initially assume that we aren't extending
 	bool Extending = false;
 
@@ -3221,7 +3855,7 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 			if(Ret)
 			{
 				Ret->RootName = RootName;
-				Ret->DictName = ThisClass->Name;
+				Ret->DictName = InternedName(ThisClass->Name);
 				
 				Ret->KeyFormat = DICT_KEY_UNDEFINED;
 				Ret->LenFormat = DICT_LEN_UNDEFINED;
@@ -3236,7 +3870,7 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 				Ret->Use = ThisClass->Usage;
 
 				// Set the name lookup - UL lookup set when key set
-				NameLookup[RootName + ThisClass->Name] = Ret;
+				if(!Frozen) NameLookup[RootName + ThisClass->Name] = Ret;
 			}
 		}
 		else if(ThisClass->Class == ClassArray)
@@ -3365,10 +3999,10 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 			Ret->Parent = Parent;
 
 			// Add us as a child of our parent
-			Parent->insert(Ret);
+			if(!FrozenParent) Parent->insert(Ret);
 
 			// Move reference details from parent (used for vectors)
-			if(Parent->RefType != ClassRefNone)
+			if((!FrozenParent) && (Parent->RefType != ClassRefNone))
 			{
 				RefType = Parent->RefType;
 				RefTarget = Parent->RefTargetName;
@@ -3384,7 +4018,7 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 	else
 	{
 		// If the parent does not match, it is possible that this is the same property being added to a different set - breaks single inheritance, but can be used with care!
-		if(Parent && (Parent != Ret->Parent))
+		if(Parent && (Parent != Ret->Parent) && (!FrozenParent))
 		{
 			if(Ret->TypeUL)
 			{
@@ -3474,7 +4108,7 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 		// If we don't have a tag set this global key as the key
 		if(ThisClass->Tag == 0) Ret->Key.Set(16, TypeUL->GetValue());
 
-		Ret->TypeUL = TypeUL;
+		Ret->SetUL(TypeUL);
 
 		// When the class is first defined we set whether it is baseline or not
 		Ret->BaselineClass = ThisClass->IsBaseline;
@@ -3539,9 +4173,17 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 	}
 
 	/* Add this new class to the lookups - this is done after building children so we can fail safely if children not built */
-	if(!Extending)
+	if((!Extending) && Frozen)
+	{
+		TypeOverlay::Current()->AddClass(Ret, *TypeUL);
+
+		// Add the name and UL to the symbol space (which adds to the overlay if the symbol space is frozen)
+		ThisSymbolSpace->AddSymbol(Ret->FullName(), TypeUL);
+	}
+	else if(!Extending)
 	{
-		ULLookup[*TypeUL] = Ret;
+		ULLookup.Set(*TypeUL, Ret);
+		LookupGeneration++;
 
 		// Add the name and UL to the symbol space
 		ThisSymbolSpace->AddSymbol(Ret->FullName(), TypeUL);
@@ -3556,7 +4198,7 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 			Ver1->Set(7,1);
 
 			// Insert it into the version 1 lookup
-			ULLookupVer1[*Ver1] = Ret;
+			ULLookupVer1.Set(*Ver1, Ret);
 		}
 
 		if(!Parent)
@@ -3574,8 +4216,11 @@ MDOTypePtr MDOType::DefineClass(ClassRecordPtr &ThisClass, SymbolSpacePtr Defaul
 	 */
 	if(Extending && ThisClass->ExtendSubs && (Ret->size() != 0))
 	{
-		MDOTypeList::iterator it = AllTypes.begin();
-		while(it != AllTypes.end())
+		// DRAGONS: Once frozen, the class being extended is in the overlay, so only overlay classes can be derived from it
+		MDOTypeList &Derived = Frozen ? TypeOverlay::Current()->GetClasses() : AllTypes;
+
+		MDOTypeList::iterator it = Derived.begin();
+		while(it != Derived.end())
 		{
 			// Extend any types that are derived from our use (carefully not adding again to our use)
 			if(((*it) != Ret) && ((*it)->IsA(Ret))) (*it)->ReDerive(Ret);
@@ -3596,14 +4241,16 @@ MDOTypeList MDOType::AllTypes;	//!< All types managed by the MDOType class
 MDOTypeList MDOType::TopTypes;	//!< The top-level types managed by the MDOType class
 
 //! Map for UL lookups
-std::map<UL, MDOTypePtr> MDOType::ULLookup;
+ULHashMap<MDOTypePtr> MDOType::ULLookup;
 		
 //! Map for UL version-less lookups
-std::map<UL, MDOTypePtr> MDOType::ULLookupVer1;
-		
+ULHashMap<MDOTypePtr> MDOType::ULLookupVer1;		
 //! Map for reverse lookups based on type name
 std::map<std::string, MDOTypePtr> MDOType::NameLookup;
 
+//! Count of changes to ULLookup
+UInt32 MDOType::LookupGeneration = 1;
+
 
 //! Redefine a sub-item in a container
 void MDOType::ReDefine(std::string NewDetail, std::string NewBase, unsigned int NewMinSize, unsigned int NewMaxSize)
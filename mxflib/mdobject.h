@@ -47,6 +47,9 @@
 namespace mxflib
 {
 	//! SymbolSpace used to translate a symbolic name to a UL
+	/*! Once the dictionary is frozen new symbol spaces, and new symbols for existing ones, are held in the
+	 *  TypeOverlay active on the current thread so that the existing symbol spaces are only read.
+	 */
 	class SymbolSpace : public std::map<std::string, ULPtr>, public RefCount<SymbolSpace>
 	{
 	protected:
@@ -54,70 +57,29 @@ namespace mxflib
 
 		std::string SymName;									//!< The name of this symbol space
 
+		bool Frozen;											//!< True once the dictionary is frozen, so this symbol space is not changed
+
 	private:
  		//! Prevent copy construction by NOT having an implementation to this copy constructor
 		SymbolSpace(const SymbolSpace &rhs);
 
 	public:
 		//! Construct a new symbol space
-		SymbolSpace(std::string Name) : SymName(Name)
-		{
-			SymbolSpaceMap::iterator it = AllSymbolSpaces.find(Name);
-
-			if(it != AllSymbolSpaces.end())
-			{
-				error("Duplicate symbol space name \"%s\"\n");
-			}
-
-			AllSymbolSpaces.insert(SymbolSpaceMap::value_type(Name, this));
-		};
-
+		SymbolSpace(std::string Name);
 
 		//! Add a new symbol to this symbol space
 		/*! \return true if added OK, else false (most likely a duplicate symbol name)
 		 */
-		bool AddSymbol(std::string Symbol, ULPtr &UL)
-		{
-			iterator it = find(Symbol);
-			if(it != end()) return false;
-
-			insert(value_type(Symbol, UL));
-
-			return true;
-		}
-
+		bool AddSymbol(std::string Symbol, ULPtr &UL);
 
 		//! Locate the given symbol in this symbol space, optionally check all other spaces too
-		ULPtr Find(std::string Symbol, bool SearchAll = false)
-		{
-			iterator it = find(Symbol);
-
-			if(it != end()) return (*it).second;
-
-			if(SearchAll)
-			{
-				SymbolSpaceMap::iterator map_it = AllSymbolSpaces.begin();
-				while(map_it != AllSymbolSpaces.end())
-				{
-					it = (*map_it).second->find(Symbol);
-					if(it != (*map_it).second->end()) return (*it).second;
-
-					map_it++;
-				}
-			}
-
-			return NULL;
-		}
+		ULPtr Find(std::string Symbol, bool SearchAll = false) const;
 
 		//! Find the symbol space with a given name
-		static SymbolSpacePtr FindSymbolSpace(std::string Name)
-		{
-			SymbolSpaceMap::iterator it = AllSymbolSpaces.find(Name);
-
-			if(it != AllSymbolSpaces.end()) return (*it).second;
+		static SymbolSpacePtr FindSymbolSpace(std::string Name);
 
-			return NULL;
-		}
+		//! Set whether the existing symbol spaces may be changed, used when the dictionary is frozen or cleared
+		static void SetAllFrozen(bool Value);
 
 		//! Get the name of this symbol space
 		const std::string &Name(void) const { return SymName; }
@@ -192,7 +154,7 @@ namespace mxflib
 		/* Dictionary data */
 		DataChunk		Key;			//!< Main key field
 		DataChunk		GlobalKey;		//!< Global key field (may be a copy of Key)
-		std::string		DictName;		//!< Short (XML tag) name
+		InternedName	DictName;		//!< Short (XML tag) name
 		std::string		Detail;			//!< Full descriptive name
 		std::string		TypeName;		//!< Data type name from dictionary (or built from UL found in file?)
 		DictKeyFormat	KeyFormat;		//!< Format of key of sub-items
@@ -211,6 +173,9 @@ namespace mxflib
 
 		bool			BaselineClass;	//!< True if this is a baseline class as defined in 377M or certain other specific standards (and so will not be added to the KXS metadictionary)
 
+		mutable ULHashMap<MDOTypePtr> ChildIndex;	//!< Index of child types by UL, built when first required
+		mutable bool	ChildIndexValid;			//!< True if ChildIndex is up to date with the current children
+
 		//! Protected constructor so we can control creation of types
 		MDOType();
 
@@ -219,7 +184,8 @@ namespace mxflib
 		MDOType(MDContainerType ContainerType, std::string RootName, std::string Name, std::string Detail, MDTypePtr Type, 
 				DictKeyFormat KeyFormat, DictLenFormat LenFormat, unsigned int minLen, unsigned int maxLen, DictUse Use)
 			: ContainerType(ContainerType), RootName(RootName), ValueType(Type), TypeTag(0), DictName(Name), Detail(Detail),
-			  KeyFormat(KeyFormat), LenFormat(LenFormat), minLength(minLen), maxLength(maxLen), Use(Use), BaselineClass(false)
+			  KeyFormat(KeyFormat), LenFormat(LenFormat), minLength(minLen), maxLength(maxLen), Use(Use), BaselineClass(false),
+			  ChildIndex(true), ChildIndexValid(false)
 		{
 			// MaxLength = 0 is used for maxlength = unbounded
 			if(maxLength == 0) maxLength = (unsigned int)-1;
@@ -228,7 +194,7 @@ namespace mxflib
 			else TypeName = Name;
 
 			// Set the name lookup - UL lookup set when key set
-			NameLookup[RootName + Name] = this;
+			if(!Frozen) NameLookup[RootName + Name] = this;
 
 			// Start of with no referencing details
 			RefType = ClassRefNone;
@@ -239,10 +205,13 @@ namespace mxflib
 		/******************************/
 
 		//! Get the name of this type
-		const std::string &Name(void) const { return DictName; }
+		const std::string &Name(void) const { return DictName.Name(); }
+
+		//! Get the interned name of this type
+		const InternedName &GetInternedName(void) const { return DictName; }
 
 		//! Get the full name of this type, including all parents
-		std::string FullName(void) const { return RootName + DictName; }
+		std::string FullName(void) const { return RootName + DictName.Name(); }
 
 		//! Report the detailed description for this type
 		const std::string &GetDetail(void) const { return Detail; };
@@ -328,7 +297,13 @@ namespace mxflib
 		/**************************/
 
 		//! Set the UL for this type or this specific object
-		void SetUL(ULPtr &Val) { TypeUL = Val; }
+		void SetUL(ULPtr &Val)
+		{
+			TypeUL = Val;
+
+			// Our parent will need to re-index its children
+			if(Parent) Parent->ChildIndexValid = false;
+		}
 
 		//! Read-only access to the current UL (same as GetTypeUL for types, but may differ for actual objects)
 		const ULPtr &GetUL(void) const { return TypeUL; }
@@ -369,6 +344,12 @@ namespace mxflib
 		//! Locate a named child
 		MDOTypePtr operator[](const std::string Name) const { return Child(Name); }
 
+		//! Locate a named child, by interned name
+		MDOTypePtr Child(const InternedName &Name) const;
+
+		//! Locate a named child, by interned name
+		MDOTypePtr operator[](const InternedName &Name) const { return Child(Name); }
+
 		//! Locate a numerically indexed child
 		/*! DRAGONS: If the type is not numerically indexed then the index will be treated as a 0-based ChildList index */
 		/* FIXME: Add this method */
@@ -379,31 +360,14 @@ namespace mxflib
 		MDOTypePtr operator[](int Index) const { return Child(Index); }
 
 		//! Locate a child by UL
-		MDOTypePtr Child(ULPtr &ChildType) const
-		{
-			MDOTypeMap::const_iterator it = begin();
-			while(it != end()) 
-			{ 
-				if(((*it).second->TypeUL) && (((*it).second->TypeUL)->Matches(*ChildType))) return (*it).second; 
-				it++;
-			}
-			return NULL;
-		}
+		MDOTypePtr Child(ULPtr &ChildType) const { return Child(*ChildType); }
 
 		//! Locate a child by UL
 		MDOTypePtr operator[](ULPtr &ChildType) const { return Child(ChildType); }
 
 		//! Locate a child by UL
-		MDOTypePtr Child(const UL &ChildType) const
-		{
-			MDOTypeMap::const_iterator it = begin();
-			while(it != end()) 
-			{ 
-				if(((*it).second->TypeUL) && (((*it).second->TypeUL)->Matches(ChildType))) return (*it).second; 
-				it++;
-			}
-			return NULL;
-		}
+		/*! The UL is compared with UL::Matches(), so the version number is ignored */
+		MDOTypePtr Child(const UL &ChildType) const;
 
 		//! Locate a child by UL
 		MDOTypePtr operator[](const UL &ChildType) const { return Child(ChildType); }
@@ -548,17 +512,22 @@ namespace mxflib
 		static MDOTypeList	TopTypes;	//!< The top-level types managed by this object
 
 		//! Map for UL lookups
-		static std::map<UL, MDOTypePtr> ULLookup;
+		static ULHashMap<MDOTypePtr> ULLookup;
 		
 		//! Map for UL lookups - ignoring the version number (all entries use version = 1)
-		static std::map<UL, MDOTypePtr> ULLookupVer1;
-
+		static ULHashMap<MDOTypePtr> ULLookupVer1;
 		//! Map for reverse lookups based on type name
 		static MDOTypeMap NameLookup;
 
 		//! Flag to show when we have loaded types and classes required for internal use
 		static bool InternalsDefined;
 
+		//! Count of changes to ULLookup, allowing lookup results to be cached (see Primer::LookupType)
+		static UInt32 LookupGeneration;
+
+		//! Set true once the dictionary is frozen, after which the lookups and existing types are never changed
+		static bool Frozen;
+
 	public:
 		//! Bit masks for items that are to be set for this definition in BuildTypeFromDict
 		/*! This allows some values to be inherited from the base class,
@@ -589,17 +558,29 @@ namespace mxflib
 		//! Accessor for InternalsDefined
 		static bool GetInternalsDefined(void) { return InternalsDefined; }
 
+		//! Get a value that changes whenever types are added or removed, so that cached type lookups can be discarded
+		/*! Once the dictionary is frozen this also changes when classes are added to the overlay active on this thread */
+		static UInt32 GetLookupGeneration(void);
+
+		//! Determine if the dictionary has been frozen
+		static bool IsFrozen(void) { return Frozen; }
+
+		//! Freeze the dictionary, so that the lookups and existing types are only read from now on
+		/*! Any classes, types or symbol spaces defined after this are added to the TypeOverlay active on the
+		 *  defining thread, and are an error if there is none. Use FreezeDictionary() rather than calling this
+		 *  directly as that also completes any parts of the dictionary that would otherwise be built on first use.
+		 */
+		static void Freeze(void);
+
+	protected:
+		//! Determine if a class is part of the frozen dictionary, rather than defined later in an overlay
+		static bool IsFrozenClass(const MDOTypePtr &Class);
+
+	public:
+
 		//! Clear any loaded dictionary data
 		/*! This can be used before loading a different dictionary, or to free allocated memory for debugging (such as memory leak detection) */
-		static void ClearDict(void)
-		{
-			AllTypes.clear();
-			TopTypes.clear();
-			ULLookup.clear();
-			ULLookupVer1.clear();
-			NameLookup.clear();
-			InternalsDefined = false;
-		}
+		static void ClearDict(void);
 
 		//! Load types and classes required for internal use 
 		static void DefineInternals(void);
@@ -670,6 +651,102 @@ namespace mxflib
 }
 
 
+namespace mxflib
+{
+	//! Interface for a source of reference targets that have not yet been read
+	/*! This allows header metadata sets to be decoded only when a reference to them is first followed
+	 */
+	class RefResolver : public RefCount<RefResolver>
+	{
+	public:
+		virtual ~RefResolver() {};
+
+		//! Locate, and link, the target of a given reference source
+		/*! \note If the target cannot be found the source is left un-linked */
+		virtual void Resolve(MDObject *Source) = 0;
+	};
+
+	//! A smart pointer to a RefResolver
+	typedef SmartPtr<RefResolver> RefResolverPtr;
+}
+
+
+namespace mxflib
+{
+	//! The bytes of a top level set kept for reuse when writing, with the local tags they use
+	/*! This is held apart from MDObject as only top level sets ever have one */
+	class MDObjectWriteCache : public RefCount<MDObjectWriteCache>
+	{
+	public:
+		DataChunkPtr Data;							//!< The bytes of the set
+		std::vector<std::pair<Tag, UL> > Tags;		//!< The local tags used in Data, and the UL of each
+	};
+
+	//! A smart pointer to an MDObjectWriteCache
+	typedef SmartPtr<MDObjectWriteCache> MDObjectWriteCachePtr;
+}
+
+
+namespace mxflib
+{
+	//! A read-only view of the items of an array or batch value that is held as packed bytes rather than as child objects
+	/*! Items are read directly from the bytes, and an MDObject is only built for an item when asked for with MakeItem().
+	 *  \note The view points into the data of the object it came from, so is only valid until that object is changed or destroyed
+	 */
+	class MDPackedArray
+	{
+	protected:
+		const UInt8 *Items;					//!< The bytes of the first item
+		size_t Count;						//!< The number of items
+		size_t ItemSize;					//!< The size of each item, in bytes
+		MDTypePtr ItemType;					//!< The type of each item
+
+	public:
+		//! Build an empty view
+		MDPackedArray() : Items(NULL), Count(0), ItemSize(0) {}
+
+		//! Build a view of a given number of packed items
+		MDPackedArray(const UInt8 *Items, size_t Count, size_t ItemSize, const MDTypePtr &ItemType)
+			: Items(Items), Count(Count), ItemSize(ItemSize), ItemType(ItemType) {}
+
+		//! Get the number of items
+		size_t size(void) const { return Count; }
+
+		//! Determine if there are no items
+		bool empty(void) const { return Count == 0; }
+
+		//! Get the size of each item, in bytes
+		size_t GetItemSize(void) const { return ItemSize; }
+
+		//! Get the type of each item
+		const MDTypePtr &GetItemType(void) const { return ItemType; }
+
+		//! Get the bytes of a given item, or NULL if out of range
+		const UInt8 *GetItem(size_t Index) const { return (Index < Count) ? &Items[Index * ItemSize] : NULL; }
+
+		//! Read a big-endian integer at a given offset within a given item
+		/*! \note There is no range checking, so the caller must ensure that Index and Offset are valid for the item size */
+		template<typename T> T Get(size_t Index, size_t Offset = 0) const
+		{
+			const UInt8 *p = &Items[Index * ItemSize + Offset];
+
+			UInt64 Raw = 0;
+			size_t i;
+			for(i = 0; i < sizeof(T); i++) Raw = (Raw << 8) | p[i];
+
+			return static_cast<T>(Raw);
+		}
+
+		//! Get the offset of a named member within each item of a compound type
+		/*! \return The offset, or -1 if there is no such member or it follows a variable size member */
+		int GetMemberOffset(const std::string &Member) const;
+
+		//! Build an MDObject holding a copy of a given item, or NULL if out of range
+		MDObjectPtr MakeItem(size_t Index) const;
+	};
+}
+
+
 namespace mxflib
 {
 	//! Metadata Object class
@@ -694,6 +771,7 @@ namespace mxflib
 
 		MDObjectParent Link;			//!< The target of this reference if we are a weak or strong reference
 		MDObjectPtr OwningLink;			//!< The target of this reference if we are a strong reference - will own the target and keep it from being deleted whicle we exist
+		mutable RefResolverPtr Resolver;	//!< Source of the target of this reference if it has not been linked because the target is yet to be read
 
 		bool IsConstructed;				//!< True if this object is constructed, false if read from a file or a parent object
 		Position ParentOffset;			//!< Offset from start of parent object if read from file or object
@@ -703,7 +781,10 @@ namespace mxflib
 		ULPtr TheUL;					//!< The UL for this object (if known)
 		Tag TheTag;						//!< The local tag used for this object (if known)
 
-		std::string ObjectName;			//!< The name of this object (normally the name of the type)
+		std::string ObjectName;			//!< The name of this object, if it is not simply the name of its type (see TypeName)
+		const std::string *TypeName;	//!< The name of this object when it is the name of its type, or NULL to use ObjectName
+										/*!< DRAGONS: This points at the interned copy of the type's name, saving a copy of the name in
+										 *            every object and allowing names to be compared by pointer */
 
 
 		MDTraitsPtr Traits;				//! The current traits for reading and modifying this value (if IsValue is true)
@@ -711,6 +792,10 @@ namespace mxflib
 		bool Modified;					//!< True if this object has been modified since being "read"
 										/*!< This is used to automatically update the GenerationUID when writing the object */
 
+		MDObjectWriteCachePtr WriteCache;	//!< The bytes of this set as last written by a cached write (or as read), or NULL if none or changed since
+
+		UInt32 PackedCount;				//!< The number of array items held as packed bytes in Data rather than as children, or zero if not packed
+
 		ObjectInterface *Outer;			//!< Pointer to outer object if this is a sub-object of an ObjectInterface derived object
 
 	public:
@@ -730,6 +815,9 @@ namespace mxflib
 		//! Static flag to say if dark metadata sets that appear to be valid KLV 2x2 sets should be parsed
 		static bool ParseDark;
 
+		//! Static count of items at which arrays of fixed-size items are read as packed bytes, or zero to never pack
+		static UInt32 PackThreshold;
+
 	public:
 		//! Our value - this will either by ourself (if we represent a value) or NULL
 		/*! DRAGONS: This is for legacy support as Value used to point to an MDValue object
@@ -753,6 +841,12 @@ namespace mxflib
 		*/
 		void UnknownCtor(void);
 
+		//! Set the name of this object to the name of its type, sharing the type's copy of the name
+		void ShareName(const InternedName &Name) { TypeName = &Name.Name(); ObjectName.clear(); }
+
+		//! Set the name of this object to a name of its own
+		void SetName(const std::string &Name) { TypeName = NULL; ObjectName = Name; }
+
 	public:
 		//! Construct a new MDObject of the specified type
 		/*! BaseType is a symbol to be located in the given SymbolSpace - if no SymbolSpace is specifed the default MXFLib space is used 
@@ -788,13 +882,13 @@ namespace mxflib
 		/******************************/
 
 		//! Get the name of this type
-		const std::string &Name(void) const { return ObjectName; }
+		const std::string &Name(void) const { return TypeName ? *TypeName : ObjectName; }
 
 		//! Get the full name of this type, including all parents
 		std::string FullName(void) const
 		{
-			if(Parent) return Parent->FullName() + "/" + ObjectName;
-			else return ObjectName; 
+			if(Parent) return Parent->FullName() + "/" + Name();
+			else return Name(); 
 		};
 
 		//! Report the detailed description for this type
@@ -988,6 +1082,68 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		/*! Normally any contained sub-types (such as array items or compound members) hold their own data */
 		bool HandlesSubdata(void) const { return Traits ? Traits->HandlesSubdata() : false; }
 
+	protected:
+		//! Read a fixed-size integer value directly from our data, bypassing the virtual traits call
+		/*! \return false if the traits are not plain fixed-size integer traits, or the data is not that size
+		 *  \note Sizes of up to 4 bytes are sign-extended for signed types, to match the traits
+		 */
+		template<typename T> bool GetFixedInt(T &Ret) const
+		{
+			const MDTraitsPtr &Tr = GetTraits();
+			if((!Tr) || (Tr->GetFixedKind() != MDTraits::FixedInt) || (Data.Size != Tr->GetFixedSize())) return false;
+
+			UInt64 Raw = 0;
+			size_t i;
+			for(i = 0; i < Data.Size; i++) Raw = (Raw << 8) | Data.Data[i];
+
+			// DRAGONS: static_cast<T>(-1) < 0 is only true for signed T
+			if((static_cast<T>(-1) < 0) && (Data.Size < 8) && (Data.Data[0] & 0x80)) Raw |= ~UInt64(0) << (Data.Size * 8);
+
+			Ret = static_cast<T>(Raw);
+			return true;
+		}
+
+		//! Write a fixed-size integer value directly to our data, bypassing the virtual traits call
+		/*! \return false if the traits are not plain fixed-size integer traits, or the data is not already that size
+		 */
+		template<typename T> bool SetFixedInt(T Val)
+		{
+			if((!Traits) || (Traits->GetFixedKind() != MDTraits::FixedInt) || (Data.Size != Traits->GetFixedSize())) return false;
+
+			UInt8 Buffer[8];
+			UInt64 Raw = static_cast<UInt64>(Val);
+			size_t i = Data.Size;
+			while(i--)
+			{
+				Buffer[i] = static_cast<UInt8>(Raw);
+				Raw >>= 8;
+			}
+
+			Data.Set(Data.Size, Buffer);
+			return true;
+		}
+
+	public:
+		//! Read an identifier value, such as a UUID, Label or UMID, directly from our data
+		/*! \return false if this is not an identifier value of the same size as Ret, in which case Ret is unchanged
+		 */
+		template<class ID> bool GetIdentifier(ID &Ret) const
+		{
+			const MDTraitsPtr &Tr = GetTraits();
+			if((!Tr) || (Tr->GetFixedKind() != MDTraits::FixedIdentifier) || (Data.Size != Ret.Size())) return false;
+
+			Ret.Set(Data.Data);
+			return true;
+		}
+
+		//! Read an identifier value of a given child directly from its data
+		/*! \return false if the child does not exist or is not an identifier value of the same size as Ret */
+		template<class ID> bool GetIdentifier(const UL &ChildType, ID &Ret) const
+		{
+			MDObjectPtr Ptr = Child(ChildType);
+			return Ptr ? Ptr->GetIdentifier(Ret) : false;
+		}
+
 	public:
 		/* Static traits methods */
 
@@ -1040,6 +1196,13 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Locate a named child
 		MDObjectPtr operator[](const std::string Name) const;
 
+		//! Locate a named child, by interned name
+		MDObjectPtr Child(const InternedName &Name) const { return operator[](Name); }
+
+		//! Locate a named child, by interned name
+		/*! This compares pointers rather than strings for children named after their types, which is almost all of them */
+		MDObjectPtr operator[](const InternedName &Name) const;
+
 		//! Locate a numerically indexed child
 		/*! DRAGONS: If the type is not numerically indexed then the index will be treated as a 0-based ChildList index */
 		MDObjectPtr Child(int Index) const { return operator[](Index); }
@@ -1152,16 +1315,16 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		/* Get the value of this object */
 
 		//! Get the 32-bit signed integer version of value
-		Int32 GetInt(Int32 Default = 0) const { if( Value && GetTraits() ) return GetTraits()->GetInt(Value); else return Default; }
+		Int32 GetInt(Int32 Default = 0) const { Int32 Ret; if( GetFixedInt(Ret) ) return Ret; if( Value && GetTraits() ) return GetTraits()->GetInt(Value); else return Default; }
 
 		//! Get the 64-bit signed integer version of value
-		Int64 GetInt64(Int64 Default = 0) const { if( Value && GetTraits() ) return GetTraits()->GetInt64(Value); else return Default; }
+		Int64 GetInt64(Int64 Default = 0) const { Int64 Ret; if( GetFixedInt(Ret) ) return Ret; if( Value && GetTraits() ) return GetTraits()->GetInt64(Value); else return Default; }
 
 		//! Get the 32-bit unsigned integer version of value
-		UInt32 GetUInt(UInt32 Default = 0) const { if( Value && GetTraits() ) return GetTraits()->GetUInt(Value); else return Default; }
+		UInt32 GetUInt(UInt32 Default = 0) const { UInt32 Ret; if( GetFixedInt(Ret) ) return Ret; if( Value && GetTraits() ) return GetTraits()->GetUInt(Value); else return Default; }
 
 		//! Get the 64-bit unsigned integer version of value
-		UInt64 GetUInt64(UInt64 Default = 0) const { if( Value && GetTraits() ) return GetTraits()->GetUInt64(Value); else return Default; }
+		UInt64 GetUInt64(UInt64 Default = 0) const { UInt64 Ret; if( GetFixedInt(Ret) ) return Ret; if( Value && GetTraits() ) return GetTraits()->GetUInt64(Value); else return Default; }
 
 		//! Get the UTF-8 string version of value
 		std::string GetString(std::string Default = "", OutputFormatEnum Format = -1) const { if( Value && GetTraits() ) return GetTraits()->GetString(Value, Format); else return Default; }
@@ -1301,6 +1464,9 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Has this object (including any child objects) been modified?
 		bool IsModified(void) const;
 
+		//! Has this object itself been modified, such as by adding or removing children, ignoring changes within the children?
+		bool IsModifiedItself(void) const { return Modified; }
+
 		//! Get the location within the ultimate parent
 		Position GetLocation(void) const;
 
@@ -1323,16 +1489,16 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		/* Set the value of this object */
 
 		//! Set the value from a 32-bit signed integer
-		void SetInt(Int32 Val) { SetModified(true); if (Value && Traits) Traits->SetInt(Value, Val); }
+		void SetInt(Int32 Val) { SetModified(true); if (SetFixedInt(Val)) return; if (Value && Traits) Traits->SetInt(Value, Val); }
 
 		//! Set the value from a 64-bit signed integer
-		void SetInt64(Int64 Val) { SetModified(true); if (Value && Traits) Traits->SetInt64(Value, Val); }
+		void SetInt64(Int64 Val) { SetModified(true); if (SetFixedInt(Val)) return; if (Value && Traits) Traits->SetInt64(Value, Val); }
 
 		//! Set the value from a 32-bit unsigned integer
-		void SetUInt(UInt32 Val) { SetModified(true); if (Value && Traits) Traits->SetUInt(Value, Val); }
+		void SetUInt(UInt32 Val) { SetModified(true); if (SetFixedInt(Val)) return; if (Value && Traits) Traits->SetUInt(Value, Val); }
 
 		//! Set the value from a 64-bit unsigned integer
-		void SetUInt64(UInt64 Val) { SetModified(true); if (Value && Traits) Traits->SetUInt64(Value, Val); }
+		void SetUInt64(UInt64 Val) { SetModified(true); if (SetFixedInt(Val)) return; if (Value && Traits) Traits->SetUInt64(Value, Val); }
 
 		//! Set the value from a UTF-8 string
 		void SetString(std::string Val)	{ SetModified(true); if (Value && Traits) Traits->SetString(Value, Val); }
@@ -1560,7 +1726,7 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 			if(!Ptr) return false;
 
 			Type = Ptr;
-			ObjectName = Type->Name();
+			ShareName(Type->GetInternedName());
 			TheUL = Type->GetUL();
 			if(TheUL) TheTag = MDOType::GetStaticPrimer()->Lookup(TheUL);
 			else TheTag = 0;
@@ -1590,6 +1756,14 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Set the "attempt to parse dark metadata" flag
 		static void SetParseDark(bool Value) { ParseDark = Value; }
 
+		//! Set the number of items at which arrays of fixed-size items are read as packed bytes, or zero to never pack
+		/*! Packed arrays have no child objects until Unpack() is called, so code reading them must use GetPackedArray()
+		 */
+		static void SetPackThreshold(UInt32 Items) { PackThreshold = Items; }
+
+		//! Get the number of items at which arrays of fixed-size items are read as packed bytes, or zero if never packed
+		static UInt32 GetPackThreshold(void) { return PackThreshold; }
+
 
 		/* Interface IMDValueIO */
 		/************************/
@@ -1665,12 +1839,47 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Append this top level object, and any strongly linked sub-objects, to a memory buffer
 		size_t WriteLinkedObjects(DataChunkPtr &Buffer, PrimerPtr UsePrimer = NULL);
 
+		//! Add this top level object, and any strongly linked sub-objects, to a list in the order WriteLinkedObjects() writes them
+		void GetLinkedObjects(MDObjectList &List);
+
+		//! Add the local tags that writing this object will use to a primer, in the order that writing it would add them
+		void AddTagsToPrimer(PrimerPtr &UsePrimer) const;
+
+		//! Get the bytes of this top level set as last written by a cached write, if still valid for a given primer
+		/*! The local tags used in the cached bytes are added to the primer if not already there.
+		 *  \return NULL if this set has not been cached, has changed since, or its tags conflict with the primer
+		 */
+		DataChunkPtr GetWriteCache(PrimerPtr &UsePrimer);
+
+		//! Keep the bytes of this top level set, as written with a given primer, for reuse by later writes
+		/*! Only local sets, with no sets nested within their properties, are cached */
+		void SetWriteCache(DataChunkPtr &Data, PrimerPtr &UsePrimer);
+
+		//! Keep the bytes of this top level set as read, for reuse if it is written unchanged
+		/*! \param Buffer The buffer holding the set, which is referenced rather than copied
+		 *  \param Offset The offset of the key of the set in Buffer
+		 *  \param Size The size of the whole KLV of the set
+		 *  \param ReadPrimer The primer used to read the set
+		 *  \note This must be called after the value has been read, as ReadValue() discards any cached bytes.
+		 *        Only local sets with 2-byte lengths, no sets nested within their properties and all tags known
+		 *        to ReadPrimer are kept
+		 */
+		void KeepReadBytes(DataChunkPtr &Buffer, size_t Offset, size_t Size, PrimerPtr &ReadPrimer);
+
+		//! Discard any cached bytes for this object and the objects containing it
+		void ClearWriteCache(void);
+
 
 		/* Interface IMDValueRef */
 		/************************/
 
 		//! Access the target of a reference link
-		MDObjectParent GetRef(void) const { return Link; };
+		/*! If the target is yet to be read it is read now, if possible */
+		MDObjectParent GetRef(void) const
+		{
+			if((!Link) && Resolver) ResolveRef();
+			return Link;
+		};
 
 		//! Access the target of a reference link child property
 		MDObjectParent GetRef(std::string ChildType) const
@@ -1728,6 +1937,9 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Write any items strongly linked from sub-items
 		size_t WriteLinkedSubObjects(DataChunkPtr &Buffer, PrimerPtr UsePrimer);
 
+		//! Add any items strongly linked from sub-items to a list in the order WriteLinkedSubObjects() writes them
+		void GetLinkedSubObjects(MDObjectList &List);
+
 	public:
 
 		void SetUint(UInt32 Val) { SetUInt(Val); }
@@ -1746,6 +1958,23 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 		//! Is this a value rather than a container?
 		bool IsAValue(void) const { return IsValue; }
 
+		//! Are the items of this array value held as packed bytes rather than as child objects?
+		bool IsPacked(void) const { return PackedCount != 0; }
+
+		//! Get a view of the items of this array value, if held as packed bytes
+		/*! \return An empty view if the items are held as child objects */
+		MDPackedArray GetPackedArray(void) const;
+
+		//! Hold the items of this array value as packed bytes, replacing any child objects
+		/*! \param Buffer The bytes of the items, without any batch header
+		 *  \param Count The number of items
+		 *  \param ItemSize The size of each item, in bytes
+		 */
+		void SetPacked(const UInt8 *Buffer, UInt32 Count, size_t ItemSize);
+
+		//! Build child objects for the items of this array value if they are held as packed bytes
+		void Unpack(void);
+
 		//! Value copy
 		MDObject &operator=(const MDObject &RHS)
 		{
@@ -1753,6 +1982,7 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 			if(ValueType && RHS.ValueType && (ValueType->EffectiveType() == RHS.ValueType->EffectiveType()))
 			{
 				Data.Set(RHS.Data);
+				PackedCount = RHS.PackedCount;
 			}
 			// ... otherwise copy by string value!
 			else
@@ -1901,13 +2131,30 @@ error("UNSUPPORTED: Trying to determine ref target of %s\n", FullName().c_str())
 			if(GetRefType() == ClassRefStrong) OwningLink = NewLink;
 		}
 
+		//! Set the source of the target of this reference, if it is yet to be read
+		/*! The target will be requested from the resolver when this reference is first followed */
+		void SetResolver(RefResolverPtr &NewResolver) { Resolver = NewResolver; }
+
+	protected:
+		//! Ask our resolver to locate and link our target
+		void ResolveRef(void) const
+		{
+			// DRAGONS: The resolver is only given one chance, and this also prevents any chance of recursion
+			RefResolverPtr ThisResolver = Resolver;
+			Resolver = NULL;
+			ThisResolver->Resolve(const_cast<MDObject*>(this));
+		}
+
+	public:
+
 
 	protected:
 		//! Sets the modification state of this object
 		/*! \note This function should be used rather than setting "Modified" as a 
 		 *        future revision may "bubble" this up from sub-items to sets and packs
+		 *  \note Setting the modified flag discards any cached bytes of the containing set
 		 */
-		void SetModified(bool State) { Modified = State; }
+		void SetModified(bool State) { Modified = State; if(State) ClearWriteCache(); }
 //		void SetModified(bool State) { printf("%s Modified set to %s\n", FullName().c_str(), State ? "true" : "false"); Modified = State; }
 
 	public:
@@ -787,9 +787,9 @@ So UTF16 (surrogate-pair) -> UTF8:
 */
 std::string MDTraits_UTF16String::GetString(const MDObject *Object) const
 { 
-	std::string Ret;				//!< Return value being built
-	char Buffer[5];					//!< Buffer for building each Unicode symbol
-	UInt16 Surrogate = 0;			//!< First surrogate if processing a pair
+	// Gather the code units, up to the first null, and convert them in one go
+	std::vector<UInt16> Units;
+	Units.reserve(Object->size());
 
 	MDObject::const_iterator it = Object->begin();
 	while(it != Object->end())
@@ -799,52 +799,16 @@ std::string MDTraits_UTF16String::GetString(const MDObject *Object) const
 		// Exit when a null is found
 		if(!Value) break;
 
-		if(Surrogate)
-		{
-			UInt16 UValue = ((Surrogate >> 6) & 0x000f) + 1;
-			Buffer[0] = (char)(0xf0 | (UValue >> 2));
-			Buffer[1] = (char)(0x80 | ((UValue & 0x03) << 4) | ((Surrogate & 0x003c) >> 2));
-			Buffer[2] = (char)(0x80 | ((Surrogate & 0x03) << 4) | ((Value & 0x03c0) >> 6));
-			Buffer[3] = (char)(0x80 | (Value & 0x3f));
-			Buffer[4] = 0;
-
-			// End surrogate-pair processing
-			Surrogate = 0;
-		}
-		else
-		{
-			// Is this a simple 7-bit character?
-			if((Value & (UInt16)(~0x7f)) == 0)
-			{
-				Buffer[0] = (char)Value;
-				Buffer[1] = 0;
-			}
-			// How about a value that can be represented in 2 UTF8 bytes?
-			else if((Value & (UInt16)(~0x7ff)) == 0)
-			{
-				Buffer[0] = (char)(0xc0 | (Value >> 6));
-				Buffer[1] = (char)(0x80 | (Value & 0x3f));
-				Buffer[2] = 0;
-			}
-			// Is this a surrogate start ?
-			else if((Value & 0xfc00) == 0xd800)
-			{
-				Surrogate = Value;
-			}
-			// Otherwise it will take 3 bytes
-			else
-			{
-				Buffer[0] = (char)(0xe0 | (Value >> 12));
-				Buffer[1] = (char)(0x80 | ((Value >> 6) & 0x3f));
-				Buffer[2] = (char)(0x80 | (Value & 0x3f));
-				Buffer[3] = 0;
-			}
-		}
-
-		if(!Surrogate) Ret += std::string(Buffer);
+		Units.push_back(Value);
 		it++;
 	}
 
+	std::string Ret;
+	if(Units.empty()) return Ret;
+
+	Ret.resize(Units.size() * 3);
+	Ret.resize(UTF16ToUTF8(&Units[0], Units.size(), &Ret[0]));
+
 	return Ret;
 }
 
@@ -867,101 +831,28 @@ So UTF8 -> UTF16 (surrogate-pair):
 */
 void MDTraits_UTF16String::SetString(MDObject *Object, std::string Val)
 {
-	UInt32 Len;							//!< Length of the UTF-8 version
-	char *Buffer;						//!< Buffer to hold the UTF-8 version
-	UInt32 RetLen;						//!< Length of returned UTF-16 string (in 16-bit words)
-	int Value;							//!< Built UTF-16 version of the current character
-
-	// Read the UTF-8 value
-	Len = static_cast<UInt32>(Val.size());
-	Buffer = new char[Len + 1];
-	strcpy(Buffer, Val.c_str());
-
-	// Initially assume that the return string will be the same size (times two) as the input string.
-	// It will be no longer as four-byte UTF-16 codes start as four UTF-8 bytes
-	if(GetStringTermination())
-		Object->Resize(Len + 1);
-	else
-		Object->Resize(Len);
+	// Convert the whole string first, leaving room for a terminating null
+	// DRAGONS: The UTF-16 version is no longer than the UTF-8 version as four-byte UTF-16 codes start as four UTF-8 bytes
+	std::vector<UInt16> Units(Val.size() + 1);
+	size_t Count = UTF8ToUTF16(Val.data(), Val.size(), &Units[0]);
 
+	// Terminate the string if requested
+	if(GetStringTermination()) Units[Count++] = 0;
 
-	// Count the actual length
-	RetLen = 0;
+	Object->Resize(static_cast<UInt32>(Count));
 
-	char *p = Buffer;
+	// Set the values - quit if no more entries available (could be fixed size array)
+	UInt32 RetLen = 0;
 	MDObject::iterator it = Object->begin();
-	while((Len) && (it != Object->end()))
+	while((RetLen < Count) && (it != Object->end()))
 	{
-		// Is is a simple 7-bit character?
-		if((p[0] & 0x80) == 0)
-		{
-			Value = (UInt16)*p;
-			p++;
-			Len--;
-		}
-		// Or a 2-byte code?
-		else if((Len >= 2) && ((p[0] & 0xe0) == 0xc0))
-		{
-			Value = (((UInt16)(p[0] & 0x1f)) << 6) | ((UInt16)(p[1] & 0x3f));
-			p += 2;
-			Len -= 2;
-		}
-		// Or a 3-byte code?
-		else if((Len >= 3) && ((p[0] & 0xf0) == 0xe0))
-		{
-			Value = (((UInt16)(p[0] & 0x0f)) << 12) | (((UInt16)(p[1] & 0x3f)) << 6) | ((UInt16)(p[2] & 0x3f));
-			p += 3;
-			Len -= 3;
-		}
-		// Handle surrogate
-		else if((Len >= 4) && ((p[0] & 0xf0) == 0xf0))
-		{
-			// Build leading surrogate
-			UInt16 UValue = (((UInt16)(p[0] & 0x07)) << 2) | (((UInt16)(p[1] & 0x30)) >> 4);
-			Value = 0xd800 | ((UValue - 1) << 6) | ((p[1] & 0x0f) << 2) | ((p[2] & 0x30) >> 4);
-
-			(*it).second->SetUInt(Value);
-			RetLen++;
-
-			// Move forward - quit if no more entries available (could be fixed size array)
-			it++;
-			if(it == Object->end()) break;
-
-			// Build trailing surrogate (will be added at end of loop below)
-			Value = 0xdc00 | ((p[2] & 0x0f) << 6) | (p[3] & 0x3f);
-
-			p += 4;
-			Len -= 4;
-		}
-		// Errors get replaced with "replacement character"
-		else
-		{
-			Value = 0xfffd;
-		}
-
-		// Set this value;
-		(*it).second->SetUInt(Value);
+		(*it).second->SetUInt(Units[RetLen]);
 		RetLen++;
 		it++;
 	}
 
-	// Terminate the string if requested
-	if(GetStringTermination())
-
-	{
-		if(it != Object->end())
-		{
-			(*it).second->SetUInt(0);
-			RetLen++;
-		}
-	}
-
-
 	// Shrink output array to the actual size required
 	Object->Resize(RetLen);
-
-	// Free our temporary buffer
-	delete[] Buffer;
 }
 
 
@@ -986,67 +877,39 @@ So UTF8 -> UTF16 (surrogate-pair):
 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx  110110ww wwzzzzyy 110111yy yyxxxxxx
 */std::string MDTraits_StringArray::GetString(const MDObject *Object) const
 {
-	std::string Ret;				//!< Return value being built
-	char Buffer[5];					//!< Buffer for building each Unicode symbol
-	UInt16 Surrogate = 0;			//!< First surrogate if processing a pair
+	// Gather all the code units, including the nulls between strings
+	std::vector<UInt16> Units;
+	Units.reserve(Object->size());
 
-	Ret = "\"";
 	MDObject::const_iterator it = Object->begin();
 	while(it != Object->end())
 	{
-		UInt16 Value = (*it).second->GetInt();
+		Units.push_back((*it).second->GetInt());
+		it++;
+	}
 
-		// Split strings when a null is found
-		if(!Value)
-		{
-			if(++it == Object->end()) Ret += "\""; else Ret += "\", \"";
-			continue;
-		}
+	std::string Ret = "\"";
 
-		if(Surrogate)
-		{
-			UInt16 UValue = ((Surrogate >> 6) & 0x000f) + 1;
-			Buffer[0] = (char)(0xf0 | (UValue >> 2));
-			Buffer[1] = (char)(0x80 | ((UValue & 0x03) << 4) | ((Surrogate & 0x003c) >> 2));
-			Buffer[2] = (char)(0x80 | ((Surrogate & 0x03) << 4) | ((Value & 0x03c0) >> 6));
-			Buffer[3] = (char)(0x80 | (Value & 0x3f));
-			Buffer[4] = 0;
-
-			// End surrogate-pair processing
-			Surrogate = 0;
-		}
-		else
+	// Buffer for the UTF-8 version of each string
+	std::vector<char> Buffer(Units.size() * 3 + 1);
+
+	size_t Start = 0;
+	size_t i;
+	for(i = 0; i <= Units.size(); i++)
+	{
+		// Convert each string when its null, or the end of the array, is found
+		if((i == Units.size()) || (Units[i] == 0))
 		{
-			// Is this a simple 7-bit character?
-			if((Value & (UInt16)(~0x7f)) == 0)
-			{
-				Buffer[0] = (char)Value;
-				Buffer[1] = 0;
-			}
-			// How about a value that can be represented in 2 UTF8 bytes?
-			else if((Value & (UInt16)(~0x7ff)) == 0)
-			{
-				Buffer[0] = (char)(0xc0 | (Value >> 6));
-				Buffer[1] = (char)(0x80 | (Value & 0x3f));
-				Buffer[2] = 0;
-			}
-			// Is this a surrogate start ?
-			else if((Value & 0xfc00) == 0xd800)
-			{
-				Surrogate = Value;
-			}
-			// Otherwise it will take 3 bytes
-			else
+			if(i > Start) Ret.append(&Buffer[0], UTF16ToUTF8(&Units[Start], i - Start, &Buffer[0]));
+
+			// Split strings when a null is found
+			if(i < Units.size())
 			{
-				Buffer[0] = (char)(0xe0 | (Value >> 12));
-				Buffer[1] = (char)(0x80 | ((Value >> 6) & 0x3f));
-				Buffer[2] = (char)(0x80 | (Value & 0x3f));
-				Buffer[3] = 0;
+				if((i + 1) == Units.size()) Ret += "\""; else Ret += "\", \"";
 			}
-		}
 
-		if(!Surrogate) Ret += std::string(Buffer);
-		it++;
+			Start = i + 1;
+		}
 	}
 
 	return Ret;
@@ -1204,6 +1067,14 @@ UInt64 MDTraits_BasicArray::GetUInt64(const MDObject *Object) const
 
 std::string MDTraits_BasicArray::GetString(const MDObject *Object) const
 {
+	// Packed items are formatted from an unpacked copy
+	if(Object->IsPacked())
+	{
+		MDObjectPtr Copy = Object->MakeCopy();
+		Copy->Unpack();
+		return GetString(Copy);
+	}
+
 	std::string Ret;
 
 	MDObject::const_iterator it;
@@ -1319,6 +1190,22 @@ size_t MDTraits_BasicArray::ReadValue(MDObject *Object, const UInt8 *Buffer, siz
 	// Figure out the maximum number of items to read, or zero if open-ended
 	UInt32 MaxItems = ValueType->Size;
 
+	// Large open-ended arrays of fixed-size items may be held as packed bytes rather than building an object per item
+	UInt32 Threshold = MDObject::GetPackThreshold();
+	if(Threshold && (!MaxItems) && AllowPacking())
+	{
+		size_t ItemSize = ValueType->EffectiveBase()->EffectiveSize();
+		if(ItemSize && (ItemSize == ThisSize || UnknownCount))
+		{
+			size_t Items = UnknownCount ? (Size / ItemSize) : static_cast<size_t>(Count);
+			if((Items >= Threshold) && ((Items * ItemSize) <= Size) && (!UnknownCount || ((Items * ItemSize) == Size)))
+			{
+				Object->SetPacked(Buffer, static_cast<UInt32>(Items), ItemSize);
+				return Bytes + (Items * ItemSize);
+			}
+		}
+	}
+
 	// Count of actual items read, and bytes read in doing so
 	UInt32 ActualCount = 0;
 
@@ -2445,14 +2332,31 @@ size_t MDTraits_BasicCompound::ReadValue(MDObject *Object, const UInt8 *Buffer,
 }
 
 
+namespace
+{
+	//! Interned names of the sub-items of compound types, so that sub-items are located without string compares
+	const InternedName NumeratorName("Numerator");
+	const InternedName DenominatorName("Denominator");
+	const InternedName DateName("Date");
+	const InternedName TimeName("Time");
+	const InternedName YearName("Year");
+	const InternedName MonthName("Month");
+	const InternedName DayName("Day");
+	const InternedName HoursName("Hours");
+	const InternedName MinutesName("Minutes");
+	const InternedName SecondsName("Seconds");
+	const InternedName msBy4Name("msBy4");
+}
+
+
 /*********************************
 **   Rational Implementations   **
 *********************************/
 
 std::string MDTraits_Rational::GetString(const MDObject *Object) const
 {
-	MDObjectPtr Numerator = Object->Child("Numerator");
-	MDObjectPtr Denominator = Object->Child("Denominator");
+	MDObjectPtr Numerator = Object->Child(NumeratorName);
+	MDObjectPtr Denominator = Object->Child(DenominatorName);
 
 	UInt32 Num = 0;
 	UInt32 Den = 1;
@@ -2478,8 +2382,8 @@ std::string MDTraits_Rational::GetString(const MDObject *Object) const
 
 void MDTraits_Rational::SetString(MDObject *Object, std::string Val)
 {
-	MDObjectPtr Numerator = Object->Child("Numerator");
-	MDObjectPtr Denominator = Object->Child("Denominator");
+	MDObjectPtr Numerator = Object->Child(NumeratorName);
+	MDObjectPtr Denominator = Object->Child(DenominatorName);
 
 	UInt32 Num = atoi(Val.c_str());
 
@@ -2531,30 +2435,30 @@ std::string MDTraits_TimeStamp::GetString(const MDObject *Object) const
 	MDObject *Seconds;
 	MDObject *msBy4;
 
-	MDObject *Date = Object->Child("Date");
-	MDObject *Time = Object->Child("Time");
+	MDObject *Date = Object->Child(DateName);
+	MDObject *Time = Object->Child(TimeName);
 
 	// AVMETA: Use Avid style nested structure if applicable
 	if(Date && Time)
 	{
-		Year = Date->Child("Year");
-		Month = Date->Child("Month");
-		Day = Date->Child("Day");
+		Year = Date->Child(YearName);
+		Month = Date->Child(MonthName);
+		Day = Date->Child(DayName);
 
-		Hours = Time->Child("Hours");
-		Minutes = Time->Child("Minutes");
-		Seconds = Time->Child("Seconds");
-		msBy4 = Time->Child("msBy4");
+		Hours = Time->Child(HoursName);
+		Minutes = Time->Child(MinutesName);
+		Seconds = Time->Child(SecondsName);
+		msBy4 = Time->Child(msBy4Name);
 	}
 	else
 	{
-		Year = Object->Child("Year");
-		Month = Object->Child("Month");
-		Day = Object->Child("Day");
-		Hours = Object->Child("Hours");
-		Minutes = Object->Child("Minutes");
-		Seconds = Object->Child("Seconds");
-		msBy4 = Object->Child("msBy4");
+		Year = Object->Child(YearName);
+		Month = Object->Child(MonthName);
+		Day = Object->Child(DayName);
+		Hours = Object->Child(HoursName);
+		Minutes = Object->Child(MinutesName);
+		Seconds = Object->Child(SecondsName);
+		msBy4 = Object->Child(msBy4Name);
 	}
 
 	UInt32 Y;
@@ -2615,30 +2519,30 @@ void MDTraits_TimeStamp::SetString(MDObject *Object, std::string Val)
 	MDObject *Seconds;
 	MDObject *msBy4;
 
-	MDObject *Date = Object->Child("Date");
-	MDObject *Time = Object->Child("Time");
+	MDObject *Date = Object->Child(DateName);
+	MDObject *Time = Object->Child(TimeName);
 
 	// AVMETA: Use Avid style nested structure if applicable
 	if(Date && Time)
 	{
-		Year = Date->Child("Year");
-		Month = Date->Child("Month");
-		Day = Date->Child("Day");
+		Year = Date->Child(YearName);
+		Month = Date->Child(MonthName);
+		Day = Date->Child(DayName);
 
-		Hours = Time->Child("Hours");
-		Minutes = Time->Child("Minutes");
-		Seconds = Time->Child("Seconds");
-		msBy4 = Time->Child("msBy4");
+		Hours = Time->Child(HoursName);
+		Minutes = Time->Child(MinutesName);
+		Seconds = Time->Child(SecondsName);
+		msBy4 = Time->Child(msBy4Name);
 	}
 	else
 	{
-		Year = Object->Child("Year");
-		Month = Object->Child("Month");
-		Day = Object->Child("Day");
-		Hours = Object->Child("Hours");
-		Minutes = Object->Child("Minutes");
-		Seconds = Object->Child("Seconds");
-		msBy4 = Object->Child("msBy4");
+		Year = Object->Child(YearName);
+		Month = Object->Child(MonthName);
+		Day = Object->Child(DayName);
+		Hours = Object->Child(HoursName);
+		Minutes = Object->Child(MinutesName);
+		Seconds = Object->Child(SecondsName);
+		msBy4 = Object->Child(msBy4Name);
 	}
 
 	UInt32 Y = 0;
@@ -127,13 +127,36 @@ namespace mxflib
 		//! List of all traits that exist
 		static MDTraitsMap AllTraits;
 
+	public:
+		//! The kinds of fixed-size value that MDObject reads and writes directly from the bytes, rather than through the traits
+		enum FixedKind
+		{
+			FixedNone = 0,						//!< Values are only accessed through the traits
+			FixedInt,							//!< A big-endian integer of FixedSize bytes
+			FixedIdentifier						//!< An identifier (such as a UL or UUID) of FixedSize bytes
+		};
+
+	protected:
+		FixedKind Fixed;						//!< The kind of fixed-size value these traits handle
+		size_t FixedSize;						//!< The number of bytes in a fixed-size value
+
 		//! Protected constructor so all traits need to be created via Create()
-		MDTraits() {};
+		MDTraits() : Fixed(FixedNone), FixedSize(0) {};
+
+		//! Flag that values with these traits are fixed-size and may be accessed directly by MDObject
+		/*! DRAGONS: Derived traits that change how integer or identifier values are read or written must reset this to FixedNone */
+		void SetFixed(FixedKind Kind, size_t Size) { Fixed = Kind; FixedSize = Size; }
 
 	public:
 		//! Allow virtual destruction
 		virtual ~MDTraits() {}
 
+		//! Get the kind of fixed-size value these traits handle, if any
+		FixedKind GetFixedKind(void) const { return Fixed; }
+
+		//! Get the number of bytes in a fixed-size value, or zero if not fixed-size
+		size_t GetFixedSize(void) const { return FixedSize; }
+
 		//! Does this trait take control of all sub-data and build values in the values own DataChunk?
 		/*! Normally any contained sub-types (such as array items or compound members) hold their own data */
 		virtual bool HandlesSubdata(void) const { return false; };
@@ -270,6 +293,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_Int8"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_Int8() { SetFixed(FixedInt, 1); }
+
 	protected:
 		virtual void SetInt(MDObject *Object, Int32 Val);
 		virtual Int32 GetInt(const MDObject *Object) const;
@@ -296,6 +322,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_Int16"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_Int16() { SetFixed(FixedInt, 2); }
+
 	protected:
 		virtual void SetInt(MDObject *Object, Int32 Val);
 		virtual Int32 GetInt(const MDObject *Object) const;
@@ -322,6 +351,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_Int32"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_Int32() { SetFixed(FixedInt, 4); }
+
 	protected:
 		virtual void SetInt(MDObject *Object, Int32 Val);
 		virtual Int32 GetInt(const MDObject *Object) const;
@@ -348,6 +380,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_Int64"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_Int64() { SetFixed(FixedInt, 8); }
+
 	protected:
 		virtual void SetInt(MDObject *Object, Int32 Val);
 		virtual void SetInt64(MDObject *Object, Int64 Val);
@@ -434,6 +469,10 @@ friend class MDTraits_BasicEnum;
 		virtual std::string Name() const { return "mxflib::MDTraits_BasicArray"; };
 
 	protected:
+		//! May large arrays of fixed-size items read with these traits be held as packed bytes?
+		/*! Traits that build their value from the child objects, such as strings, must not allow packing */
+		virtual bool AllowPacking(void) const { return true; }
+
 		virtual void SetInt(MDObject *Object, Int32 Val);
 		virtual void SetInt64(MDObject *Object, Int64 Val);
 		virtual void SetUInt(MDObject *Object, UInt32 Val);
@@ -457,6 +496,7 @@ friend class MDTraits_BasicEnum;
 		virtual std::string Name() const { return "mxflib::MDTraits_BasicStringArray"; };
 
 	protected:
+		virtual bool AllowPacking(void) const { return false; }
 		virtual void SetString(MDObject *Object, std::string Val);
 		virtual std::string GetString(const MDObject *Object) const;
                 //Overridden to avoid partial overriden virtual function issues with ICC
@@ -496,6 +536,7 @@ friend class MDTraits_BasicEnum;
 		virtual std::string Name() const { return "mxflib::MDTraits_RawArray"; };
 
 	protected:
+		virtual bool AllowPacking(void) const { return false; }
 		virtual void SetString(MDObject *Object, std::string Val);
 		virtual std::string GetString(const MDObject *Object) const;
                 //Overridden to avoid partial overriden virtual function issues with ICC
@@ -515,6 +556,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_UUID"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_UUID() { SetFixed(FixedIdentifier, 16); }
+
 		//! Set the default output format from a string and return an OutputFormatEnum value to use in future
 		static OutputFormatEnum SetOutputFormat(std::string Format)
 		{
@@ -548,6 +592,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_Label"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_Label() { SetFixed(FixedIdentifier, 16); }
+
 		//! Set the default output format from a string and return an OutputFormatEnum value to use in future
 		static OutputFormatEnum SetOutputFormat(std::string Format)
 		{
@@ -578,6 +625,9 @@ friend class MDTraits_BasicEnum;
 		//! A unique name for this trait
 		virtual std::string Name() const { return "mxflib::MDTraits_UMID"; };
 
+		//! Flag that values are read and written directly by MDObject
+		MDTraits_UMID() { SetFixed(FixedIdentifier, 32); }
+
 	protected:
 		virtual void SetString(MDObject *Object, std::string Val);
 		virtual std::string GetString(const MDObject *Object) const;
@@ -592,6 +642,7 @@ friend class MDTraits_BasicEnum;
 		virtual std::string Name() const { return "mxflib::MDTraits_RawArrayArray"; };
 
 	protected:
+		virtual bool AllowPacking(void) const { return false; }
 		virtual void SetString(MDObject *Object, std::string Val);
 		virtual std::string GetString(const MDObject *Object) const;
                 //Overridden to avoid partial overriden virtual function issues with ICC
@@ -55,11 +55,24 @@ MDType::TraitsMapType MDType::TraitsMap;
 MDType::TraitsULMapType MDType::TraitsULMap;
 
 
-//! Add a given type to the lookups
+//! Add a given type to the list of types and the lookups
+/*! Once the dictionary is frozen the type is added to the active overlay instead */
 void MDType::AddType(MDTypePtr &Type, ULPtr &TypeUL)
 {
+	if(MDOType::IsFrozen())
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) Overlay->AddType(Type, *TypeUL);
+		else error("Type %s cannot be added as the dictionary is frozen and no overlay is active\n", Type->Name().c_str());
+
+		return;
+	}
+
+	// Add to the list of types
+	Types.push_back(Type);
+
 	// Add the name to the name lookup
-	NameLookup[Type->TypeName] = Type;
+	NameLookup[Type->TypeName.Name()] = Type;
 
 	// Add the UL to the UL lookup
 	ULLookup[*TypeUL] = Type;
@@ -97,9 +110,6 @@ MDTypePtr MDType::AddBasic(std::string TypeName, std::string Detail, ULPtr &UL,
 	// Set the type size
 	NewType->Size = TypeSize;
 
-	// Add to the list of types
-	Types.push_back(NewType);
-
 	// Set the lookup
 	AddType(NewType, UL);
 
@@ -142,9 +152,6 @@ MDTypePtr MDType::AddInterpretation(std::string TypeName, std::string Detail, MD
 	NewType->RefTarget = BaseType->RefTarget;
 	NewType->RefTargetType = BaseType->RefTargetType;
 
-	// Add to the list of types
-	Types.push_back(NewType);
-
 	// Set the lookup
 	AddType(NewType, UL);
 
@@ -170,9 +177,6 @@ MDTypePtr MDType::AddArray(std::string TypeName, std::string Detail, MDTypePtr B
 	// Set the array size
 	NewType->Size = Size;
 
-	// Add to the list of types
-	Types.push_back(NewType);
-
 	// Set the lookup
 	AddType(NewType, UL);
 
@@ -195,9 +199,6 @@ MDTypePtr MDType::AddCompound(std::string TypeName, std::string Detail, ULPtr &U
 	// Compounds have no size of thier own
 	NewType->Size = 0;
 
-	// Add to the list of types
-	Types.push_back(NewType);
-
 	// Set the lookup
 	AddType(NewType, UL);
 
@@ -220,9 +221,6 @@ MDTypePtr MDType::AddEnum(std::string TypeName, std::string Detail, MDTypePtr Ba
 	// Inherit size
 	NewType->Size = BaseType->Size;
 
-	// Add to the list of types
-	Types.push_back(NewType);
-
 	// Set the lookup
 	AddType(NewType, UL);
 
@@ -401,10 +399,27 @@ MDTypePtr MDType::Find(const UL& BaseUL)
 		}
 	}
 
+	// Once the dictionary is frozen, any later types are in the active overlay
+	if(!theType && MDOType::IsFrozen())
+	{
+		TypeOverlay *Overlay = TypeOverlay::Current();
+		if(Overlay) theType = Overlay->FindType(BaseUL);
+	}
+
 	return theType;
 }
 
 
+//! Determine if a type is part of the frozen dictionary, rather than defined later in an overlay
+bool MDType::IsFrozenType(const MDTypePtr &Type)
+{
+	if(!MDOType::IsFrozen() || !Type->TypeUL) return false;
+
+	std::map<UL, MDTypePtr>::iterator it = ULLookup.find(*Type->TypeUL);
+	return (it != ULLookup.end()) && ((*it).second == Type);
+}
+
+
 //! Locate a named child
 MDTypePtr MDType::Child(std::string Name) const
 {
@@ -170,7 +170,7 @@ namespace mxflib
 				   public IMDTraitsAccess
 	{
 	protected:
-		std::string TypeName;			//!< Name of this MDType
+		InternedName TypeName;			//!< Name of this MDType
 		std::string	Detail;				//!< Meaningful description
 		MDTypeClass Class;				//!< Class of this MDType
 		MDArrayClass ArrayClass;		//!< Sub-class of array
@@ -218,13 +218,16 @@ namespace mxflib
 		/******************************/
 
 		//! Get the name of this type
-		const std::string &Name(void) const { return TypeName; }
+		const std::string &Name(void) const { return TypeName.Name(); }
+
+		//! Get the interned name of this type
+		const InternedName &GetInternedName(void) const { return TypeName; }
 
 		//! Get the full name of this type, including all parents
 		std::string FullName(void) const
 		{
-			if((Class == COMPOUND) && Base) return Base->TypeName + "/" + TypeName;
-			return TypeName;
+			if((Class == COMPOUND) && Base) return Base->TypeName.Name() + "/" + TypeName.Name();
+			return TypeName.Name();
 		}
 
 		//! Report the detailed description for this type
@@ -547,10 +550,12 @@ namespace mxflib
 		static TraitsULMapType TraitsULMap;
 
 	protected:
-		//! Add a given type to the lookups
+		//! Add a given type to the list of types and the lookups
 		static void AddType(MDTypePtr &Type, ULPtr &TypeUL);
 
 	public:
+		//! Determine if a type is part of the frozen dictionary, rather than defined later in an overlay
+		static bool IsFrozenType(const MDTypePtr &Type);
 
 
 		/* Allow MDObject class to view internals of this class */
@@ -381,6 +381,7 @@ namespace
 //! Load classes and types from a Metadictionary object
 /*! At the point where this function is called, you need to have all the component parts loaded and
  *  all the strong references within the metadictionary need to be satisfied
+ *  \return false if any part of the metadictionary could not be loaded
  */
 bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 {
@@ -412,6 +413,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 			if(!TypeDef)
 			{
 				error("Missing target for type definition strong reference at 0x%s\n", Int64toHexString((*it).second->GetLocation(),8).c_str());
+				Ret = false;
 			}
 			else
 			{
@@ -457,6 +459,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 			if(!ClassDef)
 			{
 				error("Missing target for class definition strong reference at 0x%s\n", Int64toHexString((*it).second->GetLocation(),8).c_str());
+				Ret = false;
 			}
 			else
 			{
@@ -472,6 +475,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 					if((!ClassIDObject) || (IDData->Size < 16))
 					{
 						error("No valid Class ID for %s at %s\n", ClassDef->FullName().c_str(), ClassDef->GetSourceLocation().c_str());
+						Ret = false;
 						
 						// Make a random UUID to use instead
 						ClassID = new mxflib::UUID;
@@ -491,6 +495,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 					if(!ParentClass)
 					{
 						error("No parent class specified for %s of %s at %s\n", ClassDef->FullName().c_str(), ClassDef->GetString(MetaDefinitionName_UL, "unnamed class").c_str(), ClassDef->GetSourceLocation().c_str());
+						Ret = false;
 					}
 					else
 					{
@@ -536,6 +541,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 							if(!PropertyDef)
 							{
 								error("Missing target for class definition strong reference at 0x%s\n", Int64toHexString((*Prop_it).second->GetLocation(),8).c_str());
+								Ret = false;
 							}
 							else
 							{
@@ -549,6 +555,7 @@ bool mxflib::LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace)
 								if((!PropertyIDObject) || (IDData->Size < 16))
 								{
 									error("No valid Property ID for %s at %s\n", PropertyDef->FullName().c_str(), PropertyDef->GetSourceLocation().c_str());
+									Ret = false;
 									
 									// Make a random UUID to use instead
 									PropertyID = new mxflib::UUID;
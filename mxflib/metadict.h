@@ -40,6 +40,7 @@ namespace mxflib
 	//! Load classes and types from a Metadictionary object
 	/*! At the point where this function is called, you need to have all the component parts loaded and
 	 *  all the strong references within the metadictionary need to be satisfied
+	 *  \return false if any part of the metadictionary could not be loaded
 	 */
 	bool LoadMetadictionary(MDObjectPtr &Meta, SymbolSpacePtr &SymSpace);
 
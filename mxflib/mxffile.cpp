@@ -40,6 +40,247 @@
 
 using namespace mxflib;
 
+
+namespace mxflib
+{
+	//! Background writer used by MXFFile when asynchronous writing is enabled
+	/*! Buffers are filled by the thread calling MXFFile::Write() and written, in order, by our own thread */
+	class AsyncFileWriter : public Thread
+	{
+	protected:
+		FileHandle Handle;						//!< The file being written
+		size_t BufferSize;						//!< The size of each buffer
+		DataChunkPtr Current;					//!< The buffer currently being filled
+		DataChunkList Queue;					//!< Full buffers waiting to be written, in order - the head is removed once written
+		DataChunkList Free;						//!< Empty buffers ready for use
+		bool Stopping;							//!< Set to tell the thread to end once the queue is empty
+		bool Failed;							//!< Set if a write has failed since the last Sync()
+
+		Mutex Lock;								//!< Lock for all the above except Current
+		Condition Changed;						//!< Signalled when a buffer is queued or written, or when stopping
+
+	public:
+		AsyncFileWriter(FileHandle Handle, size_t BufferSize, unsigned int BufferCount)
+			: Handle(Handle), BufferSize(BufferSize), Stopping(false), Failed(false)
+		{
+			Current = NewBuffer();
+			while(--BufferCount) Free.push_back(NewBuffer());
+		}
+
+		//! Add data to the output, waiting for a free buffer if required
+		void Write(UInt8 const *Data, size_t Size)
+		{
+			while(Size)
+			{
+				size_t Bytes = BufferSize - Current->Size;
+				if(Bytes > Size) Bytes = Size;
+
+				Current->Append(Bytes, Data);
+				Data += Bytes;
+				Size -= Bytes;
+
+				if(Current->Size == BufferSize) Submit();
+			}
+		}
+
+		//! Wait until all data passed to Write() has been written
+		/*! \return false if any write has failed since the last call */
+		bool Sync(void)
+		{
+			if(Current->Size) Submit();
+
+			MutexLock Locked(Lock);
+			while(!Queue.empty()) Changed.Wait(Lock);
+
+			bool Ret = !Failed;
+			Failed = false;
+			return Ret;
+		}
+
+		//! Write any remaining data and end the thread
+		/*! \return false if any write has failed since the last call to Sync() */
+		bool Stop(void)
+		{
+			bool Ret = Sync();
+
+			Lock.Lock();
+			Stopping = true;
+			Changed.Broadcast();
+			Lock.Unlock();
+
+			Join();
+			return Ret;
+		}
+
+	protected:
+		//! Build a new, empty, buffer
+		DataChunkPtr NewBuffer(void)
+		{
+			DataChunkPtr Ret = new DataChunk;
+			Ret->ResizeBuffer(BufferSize);
+			return Ret;
+		}
+
+		//! Queue the current buffer for writing, and wait for a free buffer to replace it
+		void Submit(void)
+		{
+			MutexLock Locked(Lock);
+
+			Queue.push_back(Current);
+			Changed.Broadcast();
+
+			while(Free.empty()) Changed.Wait(Lock);
+			Current = Free.front();
+			Free.pop_front();
+		}
+
+		//! Write each queued buffer in turn until told to stop
+		void Run(void)
+		{
+			Lock.Lock();
+			for(;;)
+			{
+				while(Queue.empty() && (!Stopping)) Changed.Wait(Lock);
+				if(Queue.empty()) break;
+
+				// DRAGONS: We leave the buffer at the head of the queue while writing so that Sync() waits for it
+				DataChunkPtr Buffer = Queue.front();
+				Lock.Unlock();
+
+				size_t Bytes = FileWrite(Handle, Buffer->Data, Buffer->Size);
+
+				Lock.Lock();
+				if(Bytes != Buffer->Size) Failed = true;
+
+				Buffer->Resize(0);
+				Queue.pop_front();
+				Free.push_back(Buffer);
+				Changed.Broadcast();
+			}
+			Lock.Unlock();
+		}
+	};
+
+
+	//! Task used by MXFFile::WriteMetadataSets() to serialize header metadata sets on the shared TaskExecutor
+	/*! Each task serializes with its own copy of the primer, so any set that would add a tag to the primer
+	 *  is left for the calling thread to serialize in order with the real primer
+	 */
+	class MetadataWriteTask : public Task
+	{
+	protected:
+		std::vector<MDObject*> &Sets;			//!< The sets to write
+		std::vector<DataChunkPtr> &Results;		//!< The serialized bytes of each set, already set for cached sets
+		PrimerPtr Template;						//!< The primer to copy, holding all tags expected to be used
+		size_t &Next;							//!< The index of the next set to be taken by a task
+		Mutex &Lock;							//!< Lock for Next
+
+	public:
+		MetadataWriteTask(std::vector<MDObject*> &Sets, std::vector<DataChunkPtr> &Results, PrimerPtr Template, size_t &Next, Mutex &Lock)
+			: Sets(Sets), Results(Results), Template(Template), Next(Next), Lock(Lock) {}
+
+		void Run(void)
+		{
+			PrimerPtr LocalPrimer = Template->MakeCopy();
+
+			for(;;)
+			{
+				size_t Index;
+				{
+					MutexLock Locked(Lock);
+					Index = Next++;
+				}
+				if(Index >= Sets.size()) break;
+
+				if(Results[Index]) continue;
+
+				size_t PrimerSize = LocalPrimer->size();
+
+				DataChunkPtr Data = new DataChunk;
+				Sets[Index]->WriteObject(Data, NULL, LocalPrimer);
+
+				// If a tag was added, the set must be written with the real primer, and our copy is no longer a true copy
+				if(LocalPrimer->size() != PrimerSize) LocalPrimer = Template->MakeCopy();
+				else Results[Index] = Data;
+			}
+		}
+	};
+}
+
+
+namespace
+{
+	//! The smallest number of header metadata sets that will be serialized using worker threads
+	const size_t MinParallelMetadataSets = 64;
+
+	//! The smallest write that is passed straight to the file while gathering, rather than being copied into the gather buffer
+	const size_t GatherBypassSize = 256 * 1024;
+
+	//! A read or parse to be run by RunFileJobs(), possibly on a task of the shared TaskExecutor
+	class FileJob
+	{
+	public:
+		virtual ~FileJob() {}
+
+		//! Run the job
+		virtual void Execute(void) = 0;
+	};
+
+	//! Task used by RunFileJobs() to run jobs until none are left
+	class FileJobTask : public Task
+	{
+	protected:
+		std::vector<FileJob*> &Jobs;			//!< The jobs to run
+		size_t &Next;							//!< The index of the next job to be taken
+		Mutex &Lock;							//!< Lock for Next
+
+	public:
+		FileJobTask(std::vector<FileJob*> &Jobs, size_t &Next, Mutex &Lock) : Jobs(Jobs), Next(Next), Lock(Lock) {}
+
+		//! Run jobs until none are left
+		/*! This is also called directly by RunFileJobs(), so that the calling thread shares the work */
+		void Run(void)
+		{
+			for(;;)
+			{
+				size_t Index;
+				{
+					MutexLock Locked(Lock);
+					Index = Next++;
+				}
+				if(Index >= Jobs.size()) break;
+
+				Jobs[Index]->Execute();
+			}
+		}
+	};
+
+	//! Run a list of jobs using up to a given number of threads, including the calling thread
+	/*! The other threads are workers of the shared TaskExecutor, so the number is also limited by its worker count */
+	void RunFileJobs(std::vector<FileJob*> &Jobs, unsigned int Threads)
+	{
+		size_t Next = 0;
+		Mutex Lock;
+
+		if(Threads > Jobs.size()) Threads = static_cast<unsigned int>(Jobs.size());
+
+		TaskExecutor &Executor = GetTaskExecutor();
+		TaskGroup Tasks;
+		if((Threads > 1) && Executor.Start())
+		{
+			if(Threads > Executor.GetWorkers() + 1) Threads = Executor.GetWorkers() + 1;
+
+			while(Threads-- > 1) Tasks.Submit(new FileJobTask(Jobs, Next, Lock), &Executor);
+		}
+
+		// Share the work, which also runs every job if no tasks were submitted
+		FileJobTask(Jobs, Next, Lock).Run();
+
+		Tasks.Wait();
+	}
+}
+
+
 //! Open the named MXF file
 bool mxflib::MXFFile::Open(std::string FileName, bool ReadOnly /* = false */ )
 {
@@ -47,7 +288,9 @@ bool mxflib::MXFFile::Open(std::string FileName, bool ReadOnly /* = false */ )
 
 	// Set to be a normal file
 	isMemoryFile = false;
+	isMappedFile = false;
 	isHandleFile = false;
+	isStream = false;
 
 	// Record the name
 	Name = FileName;
@@ -65,6 +308,11 @@ bool mxflib::MXFFile::Open(std::string FileName, bool ReadOnly /* = false */ )
 
 	isOpen = true;
 
+	// Start with an empty read-ahead window at the start of the file
+	ReadAheadBuffer = NULL;
+	ReadAheadPos = 0;
+	ReadAheadHandlePos = 0;
+
 	return ReadRunIn();
 }
 
@@ -76,7 +324,9 @@ bool mxflib::MXFFile::OpenNew(std::string FileName)
 
 	// Set to be a normal file
 	isMemoryFile = false;
+	isMappedFile = false;
 	isHandleFile = false;
+	isStream = false;
 
 	// Record the name
 	Name = FileName;
@@ -87,6 +337,11 @@ bool mxflib::MXFFile::OpenNew(std::string FileName)
 
 	isOpen = true;
 
+	// Start with an empty read-ahead window at the start of the file
+	ReadAheadBuffer = NULL;
+	ReadAheadPos = 0;
+	ReadAheadHandlePos = 0;
+
 	// No run-in yet
 	RunInSize = 0;
 
@@ -100,7 +355,9 @@ bool mxflib::MXFFile::OpenMemory(DataChunkPtr Buff /*=NULL*/, Position Offset /*
 
 	// Set to be a memory file
 	isMemoryFile = true;
+	isMappedFile = false;
 	isHandleFile = false;
+	isStream = false;
 	Name = "Memory File";
 
 	// No run-in currently allowed on memory files
@@ -123,6 +380,56 @@ bool mxflib::MXFFile::OpenMemory(DataChunkPtr Buff /*=NULL*/, Position Offset /*
 }
 
 
+//! Open the named MXF file for reading via a memory mapping
+/*! Reads from the file return DataChunks that reference the mapping rather than holding a copy of the data,
+ *  and these will keep the mapping valid even after the file is closed.
+ *  \note If the file cannot be mapped (for example if it is too big for the address space) it is opened as a normal read-only file
+ *  DRAGONS: The mapping is private to this process, but chunks returned by Read() share it - so they should be treated as read-only
+ */
+bool mxflib::MXFFile::OpenMapped(std::string FileName)
+{
+	if(isOpen) Close();
+
+	// Start as a normal file
+	isMemoryFile = false;
+	isMappedFile = false;
+	isHandleFile = false;
+	isStream = false;
+
+	// Record the name
+	Name = FileName;
+
+	Handle = FileOpenRead(FileName.c_str());
+
+	if(!FileValid(Handle)) return false;
+
+	isOpen = true;
+
+	// Start with an empty read-ahead window at the start of the file (in case we can't map it)
+	ReadAheadBuffer = NULL;
+	ReadAheadPos = 0;
+	ReadAheadHandlePos = 0;
+
+	Int64 FileBytes = FileSize(Handle);
+	UInt8 *Map = (FileBytes > 0) ? FileMemoryMap(Handle, FileBytes) : NULL;
+
+	// If we can't map the file we continue reading it the normal way
+	if(!Map) return ReadRunIn();
+
+	// DRAGONS: The mapping remains valid once the file is closed, so we don't need to hold the handle open
+	FileClose(Handle);
+
+	// Use the memory file mechanism with the mapping as the buffer
+	isMemoryFile = true;
+	isMappedFile = true;
+	Buffer = new MappedFileChunk(Map, FileBytes);
+	BufferOffset = 0;
+	BufferCurrentPos = 0;
+
+	return ReadRunIn();
+}
+
+
 //! Open an MXFFile for an existing, open, file handle
 /*! DRAGONS: Once the file handle given here is closed by the caller, all further I/O will fail! */
 bool mxflib::MXFFile::OpenFromHandle(FileHandle Handle)
@@ -131,7 +438,9 @@ bool mxflib::MXFFile::OpenFromHandle(FileHandle Handle)
 
 	// Set to be a normal file, but with external handle management
 	isMemoryFile = false;
+	isMappedFile = false;
 	isHandleFile = true;
+	isStream = false;
 
 	// Record the name
 	Name = "Existing Open File";
@@ -143,6 +452,78 @@ bool mxflib::MXFFile::OpenFromHandle(FileHandle Handle)
 
 	isOpen = true;
 
+	// Start with an empty read-ahead window at the current position of the handle
+	ReadAheadBuffer = NULL;
+	ReadAheadPos = ReadAheadHandlePos = FileTell(Handle);
+
+	return ReadRunIn();
+}
+
+
+//! Open an MXFFile for writing to an existing, open, non-seekable file handle such as a pipe or socket
+/*! The file pointer starts at zero and is advanced by each write. Seek() only succeeds if it would not move the file pointer,
+ *  so nothing written can be updated later, and reading is not supported.
+ *  DRAGONS: Once the file handle given here is closed by the caller, all further I/O will fail!
+ */
+bool mxflib::MXFFile::OpenStreamFromHandle(FileHandle Handle)
+{
+	if(isOpen) Close();
+
+	// Set to be a stream, with external handle management
+	isMemoryFile = false;
+	isMappedFile = false;
+	isHandleFile = true;
+	isStream = true;
+
+	// Record the name
+	Name = "Output Stream";
+
+	// Set up our file handle
+	this->Handle = Handle;
+
+	if(!FileValid(Handle)) return false;
+
+	isOpen = true;
+
+	// DRAGONS: Read-ahead is not used for a stream, but it must not hold data from an earlier file
+	ReadAheadBuffer = NULL;
+
+	// Nothing has been written yet, and we are not going to write a run-in
+	StreamPos = 0;
+	RunInSize = 0;
+
+	return true;
+}
+
+
+//! Open an MXFFile that does all of its I/O through a given backend
+/*! The file is read via the read-ahead window, which is set to the backend's block size if not already enabled,
+ *  and can be written if the backend is writable (but not with asynchronous or direct writing).
+ *  \note A thread-safe backend may be shared by several MXFFiles, each with its own file pointer
+ */
+bool mxflib::MXFFile::OpenBackend(FileBackendPtr Backend)
+{
+	if(isOpen) Close();
+
+	if(!Backend) return false;
+
+	// Set to be a normal file, but with all I/O through the backend
+	isMemoryFile = false;
+	isMappedFile = false;
+	isHandleFile = true;
+	isStream = false;
+
+	Name = Backend->GetName();
+	this->Backend = Backend;
+
+	isOpen = true;
+
+	// DRAGONS: The file pointer is held as the read-ahead position, so read-ahead must be enabled
+	if(!ReadAheadSize) ReadAheadSize = Backend->GetBlockSize();
+	ReadAheadBuffer = NULL;
+	ReadAheadPos = 0;
+	ReadAheadHandlePos = static_cast<UInt64>(-1);
+
 	return ReadRunIn();
 }
 
@@ -204,19 +585,33 @@ bool mxflib::MXFFile::ReadRunIn()
 //! Close the file
 bool mxflib::MXFFile::Close(void)
 {
+	// Complete any gathered, asynchronous or direct writes and stop the writer
+	if(GatherBuffer) EndGather();
+	if(AsyncWriter) SetAsyncWrite(0);
+	if(DirectBuffer) SetDirectWrite(0);
+
 	if(isOpen) 
 	{
 		if(isMemoryFile)
 		{
 			Buffer = NULL;
 		}
+		else if(Backend)
+		{
+			Backend = NULL;
+		}
 		else
 		{
+			if(Preallocated) FileTrimAllocation(Handle);
 			if(!isHandleFile) FileClose(Handle);
 		}
 	}
 
 	isOpen = false;
+	Preallocated = false;
+	isMappedFile = false;
+	ReadAheadBuffer = NULL;
+	PreloadedIndex.clear();
 
 	return true;
 }
@@ -225,16 +620,33 @@ bool mxflib::MXFFile::Close(void)
 //! Read data from the file into a DataChunk
 DataChunkPtr mxflib::MXFFile::Read(size_t Size)
 {
+	StatsAdd(StatsFileReadCalls);
+	TraceScope Trace("MXFFile::Read", "io");
+
+	// Mapped files return a reference to the data rather than a copy
+	if(isMappedFile)
+	{
+		DataChunkPtr Ret = MemoryReadView(Size);
+		StatsAdd(StatsFileReadBytes, Ret->Size);
+		return Ret;
+	}
+
 	DataChunkPtr Ret = new DataChunk(Size);
 
 	if(Size)
 	{
 		size_t Bytes;
 
+		if(WritesPending()) SyncWrites();
+
 		if(isMemoryFile)
 		{
 			Bytes = MemoryRead(Ret->Data, Size);
 		}
+		else if(ReadAheadSize)
+		{
+			Bytes = ReadAheadRead(Ret->Data, Size);
+		}
 		else
 		{
 			Bytes = FileRead(Handle, Ret->Data, Size);
@@ -248,6 +660,8 @@ DataChunkPtr mxflib::MXFFile::Read(size_t Size)
 		}
 
 		if(Bytes != Size) Ret->Resize(Bytes);
+
+		StatsAdd(StatsFileReadBytes, Bytes);
 	}
 
 	return Ret;
@@ -257,14 +671,23 @@ DataChunkPtr mxflib::MXFFile::Read(size_t Size)
 //! Read data from the file into a supplied buffer
 size_t mxflib::MXFFile::Read(UInt8 *Buffer, size_t Size)
 {
+	StatsAdd(StatsFileReadCalls);
+	TraceScope Trace("MXFFile::Read", "io");
+
 	size_t Ret = 0;
 
 	if(Size)
 	{
+		if(WritesPending()) SyncWrites();
+
 		if(isMemoryFile)
 		{
 			Ret = MemoryRead(Buffer, Size);
 		}
+		else if(ReadAheadSize)
+		{
+			Ret = ReadAheadRead(Buffer, Size);
+		}
 		else
 		{
 			Ret = FileRead(Handle, Buffer, Size);
@@ -276,9 +699,580 @@ size_t mxflib::MXFFile::Read(UInt8 *Buffer, size_t Size)
 			error("Error reading file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(Tell(), 8).c_str(), strerror(errno));
 			Ret = 0;
 		}
+
+		StatsAdd(StatsFileReadBytes, Ret);
+	}
+
+	return Ret;
+}
+
+
+//! Set the size of the read-ahead window used when reading physical files
+void mxflib::MXFFile::SetReadAhead(size_t Size, UInt32 Align /*=0*/)
+{
+	if(WritesPending()) SyncWrites();
+
+	// Backend files always read via the window
+	if(Backend && (!Size)) Size = Backend->GetBlockSize();
+
+	// Keep the handle in step with the file pointer when switching modes
+	if(isOpen && (!isMemoryFile) && (!Backend))
+	{
+		if(ReadAheadSize && (!Size)) FileSeek(Handle, ReadAheadPos);
+		else if((!ReadAheadSize) && Size) ReadAheadPos = ReadAheadHandlePos = FileTell(Handle);
+	}
+
+	ReadAheadSize = Size;
+	ReadAheadAlign = Align;
+
+	// Any existing window may be the wrong size (and views may still reference it)
+	ReadAheadBuffer = NULL;
+}
+
+
+//! Load a new read-ahead window covering the current file pointer
+size_t mxflib::MXFFile::ReadAheadFill(void)
+{
+	// Work out where the window should start, aligned relative to the end of the run-in
+	UInt64 Start = ReadAheadPos;
+	if((ReadAheadAlign > 1) && (ReadAheadPos > RunInSize))
+	{
+		Start -= (ReadAheadPos - RunInSize) % ReadAheadAlign;
+
+		// Don't waste most of the window on data behind the file pointer
+		if((ReadAheadPos - Start) > (ReadAheadSize / 2)) Start = ReadAheadPos;
+	}
+
+	// DRAGONS: If a view references the current window we must leave it intact and use a new one
+	if((!ReadAheadBuffer) || ReadAheadShared)
+	{
+		ReadAheadBuffer = new DataChunk(ReadAheadSize);
+		ReadAheadShared = false;
+	}
+	else
+		ReadAheadBuffer->Resize(ReadAheadSize);
+
+	// DRAGONS: We always seek before reading as the previous operation on the handle may have been a write
+	ReadAheadStart = Start;
+	size_t Bytes = PhysicalRead(Start, ReadAheadBuffer->Data, ReadAheadSize);
+	ReadAheadHandlePos = static_cast<UInt64>(-1);
+
+	if(Bytes == static_cast<size_t>(-1))
+	{
+		ReadAheadBuffer->Resize(0);
+		return Bytes;
+	}
+
+	ReadAheadBuffer->Resize(Bytes);
+
+	if(!InReadAhead()) return 0;
+	return static_cast<size_t>(ReadAheadStart + Bytes - ReadAheadPos);
+}
+
+
+//! Read from a physical file via the read-ahead window
+size_t mxflib::MXFFile::ReadAheadRead(UInt8 *Data, size_t Size)
+{
+	size_t Ret = 0;
+
+	while(Size)
+	{
+		// Copy as much as we can from the current window
+		if(InReadAhead())
+		{
+			size_t Offset = static_cast<size_t>(ReadAheadPos - ReadAheadStart);
+			size_t Bytes = ReadAheadBuffer->Size - Offset;
+			if(Bytes > Size) Bytes = Size;
+
+			memcpy(Data, &ReadAheadBuffer->Data[Offset], Bytes);
+
+			Data += Bytes;
+			Size -= Bytes;
+			Ret += Bytes;
+			ReadAheadPos += Bytes;
+			continue;
+		}
+
+		// Reads at least as big as the window go straight to the file, saving a copy
+		if(Size >= ReadAheadSize)
+		{
+			size_t Bytes = PhysicalRead(ReadAheadPos, Data, Size);
+			ReadAheadHandlePos = static_cast<UInt64>(-1);
+
+			if(Bytes == static_cast<size_t>(-1)) return Ret ? Ret : Bytes;
+
+			ReadAheadPos += Bytes;
+			return Ret + Bytes;
+		}
+
+		size_t Available = ReadAheadFill();
+		if(Available == static_cast<size_t>(-1)) return Ret ? Ret : Available;
+
+		// End of file
+		if(Available == 0) break;
+	}
+
+	return Ret;
+}
+
+
+//! Read from a physical file via the read-ahead window, returning a DataChunk that references the window rather than a copy if possible
+DataChunkPtr mxflib::MXFFile::ReadAheadView(size_t Size)
+{
+	// Large reads are not buffered, so can't be returned as a view
+	if(Size >= ReadAheadSize) return Read(Size);
+
+	size_t Available = 0;
+	if(InReadAhead()) Available = static_cast<size_t>(ReadAheadStart + ReadAheadBuffer->Size - ReadAheadPos);
+
+	if(Available < Size)
+	{
+		// If this window holds part of the data, but the file continues, fall back to a copy
+		if(Available && (ReadAheadBuffer->Size == ReadAheadSize)) return Read(Size);
+
+		Available = ReadAheadFill();
+
+		// Errors, or a window starting too far back to hold all the data, are handled by a normal read
+		if((Available == static_cast<size_t>(-1)) || ((Available < Size) && (ReadAheadBuffer->Size == ReadAheadSize))) return Read(Size);
+
+		// Otherwise we are limited by the end of the file
+		if(Available < Size) Size = Available;
+	}
+
+	DataChunkPtr Ret = new DataChunk();
+	Ret->SetBuffer(ReadAheadBuffer, &ReadAheadBuffer->Data[ReadAheadPos - ReadAheadStart], Size);
+	ReadAheadShared = true;
+
+	ReadAheadPos += Size;
+
+	StatsAdd(StatsFileReadCalls);
+	StatsAdd(StatsFileReadBytes, Size);
+
+	return Ret;
+}
+
+
+//! Write to a physical file when read-ahead is enabled
+size_t mxflib::MXFFile::ReadAheadWrite(UInt8 const *Data, size_t Size)
+{
+	// Discard the read-ahead window if we are about to overwrite part of it
+	if(ReadAheadBuffer && (ReadAheadPos < (ReadAheadStart + ReadAheadBuffer->Size)) && ((ReadAheadPos + Size) > ReadAheadStart))
+	{
+		ReadAheadBuffer = NULL;
+	}
+
+	size_t Ret;
+	if(Backend)
+	{
+		Ret = Backend->WriteAt(ReadAheadPos, Data, Size);
+	}
+	else
+	{
+		// Only seek if we need to, as this may flush any buffered writes
+		if(ReadAheadHandlePos != ReadAheadPos) FileSeek(Handle, ReadAheadPos);
+
+		Ret = FileWrite(Handle, Data, Size);
+	}
+
+	if(Ret == static_cast<size_t>(-1)) ReadAheadHandlePos = static_cast<UInt64>(-1);
+	else
+	{
+		ReadAheadPos += Ret;
+		ReadAheadHandlePos = ReadAheadPos;
+	}
+
+	return Ret;
+}
+
+
+//! Write a range of another open file
+UInt64 mxflib::MXFFile::WriteFromFile(FileHandle Source, UInt64 Start, UInt64 Size)
+{
+	StatsAdd(StatsFileWriteCalls);
+	StatsAdd(StatsFileWriteBytes, Size);
+	TraceScope Trace("MXFFile::Write", "io");
+
+	UInt64 Ret = 0;
+
+	// The OS can only copy to a local file, and not via the direct write staging buffer as that must stay aligned
+	if(!(isMemoryFile || isStream || Backend || DirectBuffer))
+	{
+		if(WritesPending()) SyncWrites();
+
+		if(ReadAheadSize)
+		{
+			// Discard the read-ahead window if we are about to overwrite part of it
+			if(ReadAheadBuffer && (ReadAheadPos < (ReadAheadStart + ReadAheadBuffer->Size)) && ((ReadAheadPos + Size) > ReadAheadStart))
+			{
+				ReadAheadBuffer = NULL;
+			}
+
+			if(ReadAheadHandlePos != ReadAheadPos) FileSeek(Handle, ReadAheadPos);
+		}
+
+		Ret = FileCopyRange(Handle, Source, Start, Size);
+
+		if(ReadAheadSize)
+		{
+			ReadAheadPos += Ret;
+			ReadAheadHandlePos = ReadAheadPos;
+		}
+
+		// DRAGONS: With client supplied file-I/O no copy is made, so we fall through to the buffered copy
+		if(Ret) return Ret;
+	}
+
+	// Copy through a buffer, using positional reads where possible so that the source file pointer is left alone
+	const size_t BufferSize = 1024 * 1024;
+	DataChunk Buffer(static_cast<size_t>(Size < BufferSize ? Size : BufferSize));
+	while(Ret < Size)
+	{
+		size_t Chunk = (Size - Ret) > BufferSize ? BufferSize : static_cast<size_t>(Size - Ret);
+		size_t Bytes = FileReadAt(Source, Start + Ret, Buffer.Data, Chunk);
+		if(Bytes == static_cast<size_t>(-1))
+		{
+			FileSeek(Source, Start + Ret);
+			Bytes = static_cast<size_t>(FileRead(Source, Buffer.Data, Chunk));
+		}
+		if(Bytes == 0) break;
+
+		size_t Written = WriteInternal(Buffer.Data, Bytes);
+		if(Written == static_cast<size_t>(-1)) break;
+
+		Ret += Written;
+		if(Written != Bytes) break;
+	}
+
+	return Ret;
+}
+
+
+//! Enable or disable asynchronous writing of a physical file
+bool mxflib::MXFFile::SetAsyncWrite(size_t BufferSize, unsigned int BufferCount /*=2*/)
+{
+	// Stop any existing writer, completing its writes
+	if(AsyncWriter)
+	{
+		if(WritesPending()) SyncWrites();
+
+		AsyncWriter->Stop();
+		delete AsyncWriter;
+		AsyncWriter = NULL;
+	}
+
+	if((!BufferSize) || (!isOpen) || isMemoryFile || Backend) return false;
+
+	if(DirectBuffer)
+	{
+		error("Asynchronous writing can't be used with direct writing for file \"%s\"\n", Name.c_str());
+		return false;
+	}
+
+	if(BufferCount < 2) BufferCount = 2;
+
+	AsyncWriter = new AsyncFileWriter(Handle, BufferSize, BufferCount);
+	if(!AsyncWriter->Start())
+	{
+		warning("Unable to start asynchronous writer for file \"%s\" - writing synchronously\n", Name.c_str());
+		delete AsyncWriter;
+		AsyncWriter = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Write to a non-seekable output stream
+size_t mxflib::MXFFile::StreamWrite(UInt8 const *Data, size_t Size)
+{
+	size_t Ret = FileWrite(Handle, Data, Size);
+	if(Ret != static_cast<size_t>(-1)) StreamPos += Ret;
+
+	return Ret;
+}
+
+
+//! Pass data to the background writer when asynchronous writing is enabled
+size_t mxflib::MXFFile::AsyncWrite(UInt8 const *Data, size_t Size)
+{
+	// Start a new run of writes at the current file position
+	if(!AsyncPending)
+	{
+		AsyncPos = static_cast<UInt64>(Tell()) + RunInSize;
+
+		// DRAGONS: We always seek as the handle may not be at the file pointer (read-ahead), or the last operation may have been a read
+		if(!isStream) FileSeek(Handle, AsyncPos);
+
+		// The written data may overlap the read-ahead window, so we discard it
+		ReadAheadBuffer = NULL;
+
+		AsyncPending = true;
+	}
+
+	AsyncWriter->Write(Data, Size);
+	AsyncPos += Size;
+
+	return Size;
+}
+
+
+//! Wait for all asynchronous writes to complete, leaving the file handle at the end of the written data
+void mxflib::MXFFile::AsyncSync(void)
+{
+	AsyncPending = false;
+
+	// DRAGONS: We can't report the reason as errno was set on the writer's thread
+	if(!AsyncWriter->Sync()) error("Error writing file \"%s\" before 0x%s\n", Name.c_str(), Int64toHexString(AsyncPos - RunInSize, 8).c_str());
+
+	if(ReadAheadSize) ReadAheadPos = ReadAheadHandlePos = AsyncPos;
+	if(isStream) StreamPos = AsyncPos;
+}
+
+
+//! Start collecting written data in memory so that it can be written to the file in one go
+void mxflib::MXFFile::StartGather(size_t Limit /*=4*1024*1024*/)
+{
+	if((!isOpen) || isMemoryFile) return;
+
+	GatherLimit = Limit;
+	if(!GatherBuffer)
+	{
+		GatherBuffer = new DataChunk;
+		GatherBuffer->SetGranularity(64 * 1024);
+	}
+}
+
+
+//! Write any gathered data and return to writing directly
+void mxflib::MXFFile::EndGather(void)
+{
+	if(!GatherBuffer) return;
+
+	if(GatherBuffer->Size) GatherFlush();
+	GatherBuffer = NULL;
+}
+
+
+//! Add data to the gather buffer, writing the buffer if it reaches the limit
+size_t mxflib::MXFFile::GatherWrite(UInt8 const *Data, size_t Size)
+{
+	// A large value, such as a frame of essence, costs more to copy than to write on its own, so it follows the gathered data directly
+	// DRAGONS: This keeps frames that are read into a memory mapping out of user-space copies altogether
+	if(Size >= GatherBypassSize)
+	{
+		if(GatherBuffer->Size) GatherFlush();
+
+		// DRAGONS: We detach the buffer while writing so that Write() acts on the file itself
+		DataChunkPtr Gather = GatherBuffer;
+		GatherBuffer = NULL;
+
+		size_t Bytes = WriteInternal(Data, Size);
+		if(Bytes != Size) error("Error writing file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(Tell(), 8).c_str(), strerror(errno));
+
+		GatherBuffer = Gather;
+		return Bytes;
+	}
+
+	// The gathered data will be written at the current position
+	if(!GatherBuffer->Size) GatherPos = static_cast<UInt64>(Tell()) + RunInSize;
+
+	GatherBuffer->Append(Size, Data);
+
+	if(GatherBuffer->Size >= GatherLimit) GatherFlush();
+
+	return Size;
+}
+
+
+//! Write the contents of the gather buffer to the file
+void mxflib::MXFFile::GatherFlush(void)
+{
+	// DRAGONS: We detach the buffer while writing so that Tell() and Write() act on the file itself
+	DataChunkPtr Data = GatherBuffer;
+	GatherBuffer = NULL;
+
+	size_t Bytes = WriteInternal(Data->Data, Data->Size);
+	if(Bytes != Data->Size) error("Error writing file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(GatherPos - RunInSize, 8).c_str(), strerror(errno));
+
+	Data->Resize(0);
+	GatherBuffer = Data;
+}
+
+
+//! Reserve disk space for the file to grow to a given size
+bool mxflib::MXFFile::Preallocate(Length Size)
+{
+	if((!isOpen) || isMemoryFile || Backend || (Size <= 0)) return false;
+
+	if(!FilePreallocate(Handle, static_cast<UInt64>(Size + RunInSize))) return false;
+
+	Preallocated = true;
+	return true;
+}
+
+
+//! Discard everything in the file after the current position
+bool mxflib::MXFFile::Truncate(void)
+{
+	if((!isOpen) || isMemoryFile || isStream || Backend) return false;
+
+	if(GatherBuffer) EndGather();
+	Flush();
+
+	return FileTruncate(Handle, static_cast<UInt64>(Tell() + RunInSize));
+}
+
+
+//! Enable or disable direct (unbuffered) writing of a physical file
+bool mxflib::MXFFile::SetDirectWrite(size_t BufferSize, UInt32 Align /*=4096*/)
+{
+	// Write any staged data and return to normal writing
+	if(DirectBuffer)
+	{
+		if(WritesPending()) SyncWrites();
+
+		FileCloseDirect(DirectHandle);
+		AlignedFree(DirectBuffer);
+		DirectBuffer = NULL;
+	}
+
+	if((!BufferSize) || (!isOpen) || isMemoryFile || isStream || Backend) return false;
+
+	if(AsyncWriter)
+	{
+		error("Direct writing can't be used with asynchronous writing for file \"%s\"\n", Name.c_str());
+		return false;
+	}
+
+	// The file must be re-opened to get an unbuffered handle
+	if(Name.empty()) return false;
+
+	if((Align < 512) || (Align & (Align - 1)))
+	{
+		error("Direct write alignment of %u bytes is not valid, it must be a power of 2 of at least 512\n", Align);
+		return false;
+	}
+
+	if(WritesPending()) SyncWrites();
+
+	DirectHandle = FileOpenDirect(Name.c_str());
+	if(!DirectFileValid(DirectHandle))
+	{
+		warning("Unable to open file \"%s\" for direct writing - writing through the file cache\n", Name.c_str());
+		return false;
+	}
+
+	DirectAlign = Align;
+	DirectBufferSize = ((BufferSize + Align - 1) / Align) * Align;
+	DirectBuffer = AlignedAlloc(DirectBufferSize, Align);
+	if(!DirectBuffer)
+	{
+		error("Unable to allocate a %s byte buffer for direct writing\n", UInt64toString(DirectBufferSize).c_str());
+		FileCloseDirect(DirectHandle);
+		return false;
+	}
+
+	DirectPending = false;
+
+	return true;
+}
+
+
+//! Add data to the direct write staging buffer, writing the buffer each time it is full
+size_t mxflib::MXFFile::DirectWrite(UInt8 const *Data, size_t Size)
+{
+	// Start a new run of writes at the current file position
+	if(!DirectPending)
+	{
+		UInt64 Pos = static_cast<UInt64>(Tell()) + RunInSize;
+
+		DirectStart = Pos - (Pos % DirectAlign);
+		DirectFill = static_cast<size_t>(Pos - DirectStart);
+
+		// Ensure nothing written through the normal handle can reach the file after our direct writes
+		FileFlush(Handle);
+
+		// DRAGONS: Only whole blocks can be written, so we need the existing data before the file pointer in this block
+		if(DirectFill)
+		{
+			FileSeek(Handle, DirectStart);
+			size_t Bytes = FileRead(Handle, DirectBuffer, DirectFill);
+			if(Bytes == static_cast<size_t>(-1)) Bytes = 0;
+			if(Bytes < DirectFill) memset(&DirectBuffer[Bytes], 0, DirectFill - Bytes);
+		}
+
+		// The written data may overlap the read-ahead window, so we discard it
+		ReadAheadBuffer = NULL;
+
+		DirectPending = true;
+	}
+
+	size_t Ret = Size;
+	while(Size)
+	{
+		size_t Bytes = DirectBufferSize - DirectFill;
+		if(Bytes > Size) Bytes = Size;
+
+		memcpy(&DirectBuffer[DirectFill], Data, Bytes);
+		DirectFill += Bytes;
+		Data += Bytes;
+		Size -= Bytes;
+
+		if(DirectFill == DirectBufferSize)
+		{
+			if(FileWriteDirect(DirectHandle, DirectBuffer, DirectBufferSize, DirectStart) != DirectBufferSize)
+			{
+				error("Error writing file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(DirectStart - RunInSize, 8).c_str(), strerror(errno));
+				Ret -= Size;
+			}
+
+			DirectStart += DirectBufferSize;
+			DirectFill = 0;
+		}
+	}
+
+	return Ret;
+}
+
+
+//! Write all data in the direct write staging buffer, leaving the file handle at the end of the written data
+void mxflib::MXFFile::DirectSync(void)
+{
+	DirectPending = false;
+
+	// Whole blocks are written directly
+	size_t Whole = DirectFill - (DirectFill % DirectAlign);
+	if(Whole && (FileWriteDirect(DirectHandle, DirectBuffer, Whole, DirectStart) != Whole))
+	{
+		error("Error writing file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(DirectStart - RunInSize, 8).c_str(), strerror(errno));
+	}
+
+	// Any part block is written normally, and flushed so that it can't later overwrite a direct write to the same block
+	UInt64 End = DirectStart + DirectFill;
+	if(Whole < DirectFill)
+	{
+		FileSeek(Handle, DirectStart + Whole);
+		if(FileWrite(Handle, &DirectBuffer[Whole], DirectFill - Whole) != (DirectFill - Whole))
+		{
+			error("Error writing file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(DirectStart + Whole - RunInSize, 8).c_str(), strerror(errno));
+		}
+		FileFlush(Handle);
 	}
 
-	return Ret;
+	// DRAGONS: We always seek, as this also discards any data buffered by the handle that has since been written directly
+	FileSeek(Handle, End);
+
+	if(ReadAheadSize) ReadAheadPos = ReadAheadHandlePos = End;
+}
+
+
+//! Complete all gathered, asynchronous and direct writes
+void mxflib::MXFFile::SyncWrites(void)
+{
+	if(GatherBuffer && GatherBuffer->Size) GatherFlush();
+	if(AsyncPending) AsyncSync();
+	if(DirectPending) DirectSync();
 }
 
 
@@ -582,248 +1576,311 @@ Position MXFFile::ScanRIP_FindFooter(Length MaxScan)
 }
 
 
-//! Build a RIP for the open MXF file by scanning the entire file for partitions
-/*! The new RIP is placed in property FileRIP
- *  \note Each partition pack will be loaded and referenced from the new RIP
- *  \note This new RIP will represent what is in the physical
- *        file so any data in memory will not be considered
- *  \note The current contents of FileRIP will be destroyed
- */
-bool mxflib::MXFFile::BuildRIP(void)
+namespace
 {
-	// Remove any old data
-	FileRIP.clear();
+	//! The size of each read made when scanning the bytes of a file for a key
+	const size_t RIPScanReadSize = 1024 * 1024;
 
-	FileRIP.isGenerated = true;
-
-	Seek(0);
+	//! The number of bytes needed after the start of a partition pack to check that it is valid
+	/*! This covers the key, the longest BER length and the first two properties */
+	const size_t RIPPackCheckSize = 16 + 9 + 16;
 
-	UInt64 Location = 0;
+	//! The smallest region of a file walked by each thread of MXFFile::BuildRIP()
+	const Length RIPMinRegionSize = 64 * 1024 * 1024;
 
-	// Read the first partition pack in the file
-	PartitionPtr ThisPartition = ReadPartition();
+	//! The number of KLVs that must follow each other from a possible key before it is taken as a KLV boundary
+	const int RIPSyncKLVs = 4;
 
-	// If we couldn't read the first object then there are no partitions
-	// Note that this is not stricty an error - the file could be empty!
-	if(!ThisPartition) return true;
+	//! Determine if a key starts with the SMPTE UL prefix
+	bool IsSMPTEKey(const UInt8 *Key)
+	{
+		return (Key[0] == 0x06) && (Key[1] == 0x0e) && (Key[2] == 0x2b) && (Key[3] == 0x34);
+	}
 
-	// Check that the first KLV is a partition pack
-	// DRAGONS: What if the first KLV is a filler? - This shouldn't be valid as it would look like a run-in!
-	if(!(ThisPartition->IsA(PartitionMetadata_UL)) )
+	//! Determine if a key is that of a header, body or footer partition pack
+	/*! IsPartitionKey() also matches the other packs of the same family, such as the primer, which must not be taken as partitions */
+	bool IsPartitionPackKey(const UInt8 *Key)
 	{
-		error("First KLV in file \"%s\" is not a known partition type\n", Name.c_str());
-		return false;
+		return IsPartitionKey(Key) && (Key[13] >= 0x02) && (Key[13] <= 0x04);
 	}
 
-	for(;;)
+	//! Determine if the bytes at a given position hold a valid partition pack
+	/*! As well as the key, the length must be valid for a partition pack and its ThisPartition property must hold its own position,
+	 *  which makes it very unlikely that bytes within an essence value are mistaken for a partition pack
+	 */
+	bool IsPartitionPackAt(const UInt8 *Data, size_t Size, Position Pos)
 	{
-		UInt32 BodySID = 0;
-		MDObjectPtr Ptr = ThisPartition[BodySID_UL];
-		if(Ptr) BodySID = Ptr->Value->GetInt();
+		if((Size < RIPPackCheckSize) || !IsPartitionKey(Data)) return false;
 
-		FileRIP.AddPartition(ThisPartition, Location, BodySID);
+		const UInt8 *p = &Data[16];
+		Length PackLength = mxflib::ReadBER(&p, static_cast<int>(Size - 16));
+		if((PackLength < 88) || (((PackLength - 88) % 16) != 0)) return false;
 
-		Length Skip;
+		return GetI64(&p[8]) == Pos;
+	}
 
-		// Work out how far to skip ahead
-		Length HeaderByteCount = ThisPartition->GetInt64(HeaderByteCount_UL);
-		Skip = HeaderByteCount + ThisPartition->GetInt64(IndexByteCount_UL);
+	//! Scan the bytes of a file forwards from a given position for the next valid partition pack
+	/*! \return The position of the partition pack, or -1 if none starts before End */
+	Position ScanForPartition(MXFFile *File, Position Pos, Position End)
+	{
+		DataChunk Buffer(RIPScanReadSize);
 
-		if(Skip)
+		while(Pos < End)
 		{
-			// Location before we skip
-			Position PreSkip = Tell();
+			size_t Bytes = File->ReadAt(Pos, Buffer.Data, RIPScanReadSize);
+			if(Bytes < RIPPackCheckSize) return -1;
+
+			// Only keys with enough bytes after them to be checked are tested, the rest are tested in the next window
+			size_t Limit = (Bytes < RIPScanReadSize) ? Bytes : (Bytes - RIPPackCheckSize);
+			if(static_cast<Length>(Limit) > (End - Pos)) Limit = static_cast<size_t>(End - Pos);
+
+			// DRAGONS: memchr() is vectorized by most C libraries, so is the fastest way to find the first byte of each key
+			const UInt8 *p = Buffer.Data;
+			const UInt8 *pEnd = &Buffer.Data[Limit];
+			while((p = static_cast<const UInt8*>(memchr(p, 0x06, pEnd - p))) != NULL)
+			{
+				size_t Offset = p - Buffer.Data;
+				if(IsPartitionPackAt(p, Bytes - Offset, Pos + Offset)) return Pos + Offset;
+				p++;
+			}
 
-#if MXF_VERSION_10_CHECK
-			/* Check for version 10 HeaderByteCount and possible bug version */
-			// Version 10 of MXF counts from the end of the partition pack, however
-			// some version 10 code uses the version 11 counting so we check to 
-			// see if the header is claimed to be an integer number of KAGs and
-			// that there is a leading filler to take us to the start of the next KAG
-			// In this case we are probably in a Version 10 HeaderByteCount bug situation...
+			if(Bytes < RIPScanReadSize) return -1;
+			Pos += Limit;
+		}
 
-			UInt16 Ver = 0;
-			Ptr = ThisPartition[MinorVersion_UL];
-			Ver = Ptr->Value->GetUInt();
+		return -1;
+	}
 
-			bool SkipFiller = true;		// Version 11 behaviour
+	//! Read the key and length of a KLV, checking that they look valid
+	/*! Unlike MXFFile::ReadKLAt() no error is reported, as this is used to test bytes that may not be a KLV
+	 *  \return The size of the whole KLV, or 0 if the key or length are not valid or the KLV runs past the end of the file
+	 */
+	Length ReadPlausibleKL(MXFFile *File, Position Pos, Length FileSize, UInt8 *Key)
+	{
+		UInt8 Buffer[16 + 9];
+		size_t Bytes = File->ReadAt(Pos, Buffer, sizeof(Buffer));
+		if((Bytes < 17) || !IsSMPTEKey(Buffer)) return 0;
 
-			if(Ver == 1)				// Ver = 1 for version 10 files
-			{
-				UInt32 KAGSize = 0;
-				Ptr = ThisPartition[KAGSize_UL];
-				if(Ptr) KAGSize = Ptr->GetInt();
+		const UInt8 *p = &Buffer[16];
+		Length ValueLength = mxflib::ReadBER(&p, static_cast<int>(Bytes - 16));
+		if(ValueLength < 0) return 0;
 
-				UInt64 HeaderByteCount = 0;
-				Ptr = ThisPartition[HeaderByteCount_UL];
-				if(Ptr) HeaderByteCount = Ptr->GetInt();
+		Length KLVSize = (p - Buffer) + ValueLength;
+		if((KLVSize <= 0) || (KLVSize > (FileSize - Pos))) return 0;
 
-				if((KAGSize > 16) && (HeaderByteCount > 0))
-				{
-					UInt64 Pos = Tell();
-					UInt64 U = HeaderByteCount / KAGSize;
-					if((U * KAGSize) == HeaderByteCount)
-					{
-						MDObjectPtr First = ReadObject();
-						if(!First)
-						{
-							// Can't tell what is next! This will probably cause an error later!
-							SkipFiller = true;
-							Seek(Pos);
-						}
-						else if(First->IsA(KLVFill_UL))
-						{
-							U = Tell() / KAGSize;
-							if( (U * KAGSize) == (UInt64)Tell() )
-							{
-								warning("(Version 10 file) HeaderByteCount in %s at 0x%s in %s does not include the leading filler\n",
-										ThisPartition->FullName().c_str(), Int64toHexString(ThisPartition->GetLocation(),8).c_str(), 
-										ThisPartition->GetSource().c_str());
+		memcpy(Key, Buffer, 16);
+		return KLVSize;
+	}
 
-								// We are skipping filler - even though we have already done it!
-								SkipFiller = true;
-								PreSkip = Tell();
-							}
-							else
-							{
-								SkipFiller = false;
-								Seek(Pos);
-							}
-						}
-					}
-				}
-			}
+	//! Scan the bytes of a file forwards from a given position for the first point that looks like the start of a KLV
+	/*! A possible key is only accepted if it is followed by a chain of further valid KLVs, or the end of the file
+	 *  \return The position of the KLV, or -1 if none starts before End
+	 */
+	Position ScanForKLV(MXFFile *File, Position Pos, Position End, Length FileSize)
+	{
+		DataChunk Buffer(RIPScanReadSize);
 
-			if(SkipFiller)
-#endif // MXF_VERSION_10_CHECK
+		while(Pos < End)
+		{
+			size_t Bytes = File->ReadAt(Pos, Buffer.Data, RIPScanReadSize);
+			if(Bytes < 4) return -1;
+
+			// The chain of KLVs following each possible key is read separately, so only the first four bytes are needed here
+			size_t Limit = Bytes - 3;
+			if(static_cast<Length>(Limit) > (End - Pos)) Limit = static_cast<size_t>(End - Pos);
+
+			const UInt8 *p = Buffer.Data;
+			const UInt8 *pEnd = &Buffer.Data[Limit];
+			while((p = static_cast<const UInt8*>(memchr(p, 0x06, pEnd - p))) != NULL)
 			{
-				MDObjectPtr First = ReadObject();
-				if(!First)
+				if(IsSMPTEKey(p))
 				{
-					error("Error reading first KLV after %s at 0x%s in %s\n", ThisPartition->FullName().c_str(), 
-						  Int64toHexString(ThisPartition->GetLocation(),8).c_str(), ThisPartition->GetSource().c_str());
-					return false;
-				}
+					Position Start = Pos + (p - Buffer.Data);
+					Position Next = Start;
 
-				if(First->IsA(KLVFill_UL))
-					PreSkip = Tell();
-				else if(HeaderByteCount)
-				{
-					if(!First->IsA(Primer_UL))
+					int Count = 0;
+					UInt8 Key[16];
+					while((Count < RIPSyncKLVs) && (Next < FileSize))
 					{
-						error("When HeaderByteCount is not zero, the first KLV following a partition pack (and any trailing filler) must be a Primer, however %s found at 0x%s in %s\n", 
-							First->FullName().c_str(), Int64toHexString(First->GetLocation(),8).c_str(), 
-							First->GetSource().c_str());
+						Length KLVSize = ReadPlausibleKL(File, Next, FileSize, Key);
+						if(!KLVSize) break;
+
+						Next += KLVSize;
+						Count++;
 					}
+
+					if((Count == RIPSyncKLVs) || (Next == FileSize)) return Start;
 				}
-				else if(!First->IsA(IndexTableSegment_UL))
-				{
-					error("When HeaderByteCount is zero, but IndexByteCount is not zero, the first KLV following a partition pack (and any trailing filler) must be an IndexTableSegment, however %s found at 0x%s in %s\n", 
-						  First->FullName().c_str(), Int64toHexString(First->GetLocation(),8).c_str(), 
-						  First->GetSource().c_str());
-				}
-			}
 
-			// Skip over header
-			Position NextPos = PreSkip + Skip;
-			Seek(NextPos);
-			if( Tell() != NextPos)
-			{
-				error("Unexpected end of file in partition starting at 0x%s in file \"%s\" (Trying to skip from 0x%s to 0x%s)\n",
-					  Int64toHexString(Location,8).c_str(), Name.c_str(), Int64toHexString(PreSkip,8).c_str(), Int64toHexString(NextPos,8).c_str());
-				return false;
+				p++;
 			}
 
-			// Check that we ended up in a sane place after the skip
-			DataChunkPtr Test = Read(2);
-			if( Test->Size != 2)
-			{
-				// Less than 2 bytes after the declared end of this metadata
-				// Could be that the count is valid and points us to the end of the file
-				// but to be safe check through the header to see if there is anything else
-				Seek(PreSkip);
-			} 
-			else if((Test->Data[0] != 6) || (Test->Data[1] != 0x0e))
-			{
-				error("Byte counts in partition pack at 0x%s in file \"%s\" are not valid\n", Int64toHexString(Location,8).c_str(), Name.c_str());
-				
-				// Move back to end of partition pack and scan through the header
-				Seek(PreSkip);
-			}
-			else
+			if(Bytes < RIPScanReadSize) return -1;
+			Pos += Limit;
+		}
+
+		return -1;
+	}
+
+	//! Walk the KLVs of a file from a given KLV boundary, recording the position of each partition pack
+	/*! Only the key and length of each KLV are read. If a key or length is not valid the bytes of the file are scanned
+	 *  for the next partition pack, and walking continues from there.
+	 *  \return The position of the first KLV at or after End, or the end of the file
+	 */
+	Position WalkKLVs(MXFFile *File, Position Pos, Position End, Length FileSize, std::vector<Position> &Partitions)
+	{
+		while((Pos < End) && (Pos < FileSize))
+		{
+			UInt8 Key[16];
+			Length KLVSize = ReadPlausibleKL(File, Pos, FileSize, Key);
+			if(!KLVSize)
 			{
-				// Move back (the test moved the pointer 2 bytes forwards)
-				Seek(NextPos);
+				// There is not enough of the file left for a partition pack
+				if((Pos + 17) > FileSize) return FileSize;
+
+				warning("Invalid KLV found at 0x%s in file \"%s\", scanning for the next partition pack\n", Int64toHexString(Pos, 8).c_str(), File->Name.c_str());
+
+				Pos = ScanForPartition(File, Pos + 1, FileSize);
+				if(Pos < 0) return FileSize;
+
+				continue;
 			}
+
+			if(IsPartitionPackKey(Key)) Partitions.push_back(Pos);
+
+			Pos += KLVSize;
 		}
 
-		// Now scan until the next partition
-		ULPtr Key;
-		for(;;)
+		return Pos;
+	}
+
+	//! A walk of the KLVs in one region of a file by MXFFile::BuildRIP()
+	class RIPRegionJob : public FileJob
+	{
+	public:
+		MXFFile *File;							//!< The file to walk
+		Position Start;							//!< The start of the region
+		Position End;							//!< The end of the region
+		Length FileSize;						//!< The size of the file
+		Position Sync;							//!< The first KLV boundary found in the region, or -1 if none found
+		Position Stop;							//!< The position the walk stopped at, at or after End
+		std::vector<Position> Partitions;		//!< The position of each partition pack found
+
+		RIPRegionJob(MXFFile *File, Position Start, Position End, Length FileSize)
+			: File(File), Start(Start), End(End), FileSize(FileSize), Sync(-1), Stop(-1) {}
+
+		void Execute(void)
 		{
-			Location = Tell();
-			Key = ReadKey();
-			if(!Key) break;
+			// The first region starts with the header partition, but others must first find a KLV boundary
+			Sync = Start ? ScanForKLV(File, Start, End, FileSize) : 0;
+			if(Sync >= 0) Stop = WalkKLVs(File, Sync, End, FileSize, Partitions);
+		}
+	};
+}
 
-			// Identify what we have found
-			MDOTypePtr ThisType = MDOType::Find(Key);
 
-			// Only check for this being a partition pack if we know the type
-			if(ThisType)
-			{
-				if(ThisType->Base)
-				{
-					if(ThisType->IsA(PartitionMetadata_UL))
-					{
-						break;
-					}
-				}
-			}
+//! Build a RIP for the open MXF file by scanning the entire file for partitions
+/*! The new RIP is placed in property FileRIP
+ *  The file is walked from KLV to KLV reading only keys and lengths, and where a length is not valid the bytes are scanned for
+ *  the next partition pack. Large files are split into regions that are walked in parallel, each starting from the first point
+ *  in the region that looks like a KLV boundary, and the walks are joined up on the calling thread.
+ *  \param Threads The number of regions to walk at once, forced to 1 for a backend that is not thread-safe
+ *  \note Each partition pack will be loaded and referenced from the new RIP
+ *  \note This new RIP will represent what is in the physical
+ *        file so any data in memory will not be considered
+ *  \note The current contents of FileRIP will be destroyed
+ */
+bool mxflib::MXFFile::BuildRIP(unsigned int Threads /*=4*/)
+{
+	// Remove any old data
+	FileRIP.clear();
 
-			Skip = ReadBER();
-			Position NextPos = Tell() + Skip;
+	FileRIP.isGenerated = true;
 
-			// Test for badly damaged file - have we ended up in a sequence of zeros?
-			if(Skip == 0)
-			{
-				// If a zero length is followed by 16 zero bytes - abandon all hope!
-				UInt8 Buff[16];
-				if(Read(Buff, 16) == 16)
-				{
-					UInt8 *p = Buff;
-					int Count = 16;
-					while(Count && (*(p++) == 0)) Count--;
-					if(!Count)
-					{
-						error("Unexpected sequence of zero bytes where a KLV stream was expected starting at 0x%s in file \"%s\"\n",
-							  Int64toHexString(NextPos,8).c_str(), Name.c_str() );
-						return false;
-					}
-				}
-			}
+	Length FileSize = isMemoryFile ? static_cast<Length>(BufferOffset + Buffer->Size) : (Size() - RunInSize);
+
+	// Check that the first KLV is a partition pack
+	// DRAGONS: What if the first KLV is a filler? - This shouldn't be valid as it would look like a run-in!
+	UInt8 Key[16];
+	Length ValueLength;
+	if(!ReadKLAt(0, Key, ValueLength))
+	{
+		// If we couldn't read the first KLV then there are no partitions
+		// Note that this is not stricty an error - the file could be empty!
+		return true;
+	}
+
+	if(!IsPartitionKey(Key))
+	{
+		error("First KLV in file \"%s\" is not a known partition type\n", Name.c_str());
+		return false;
+	}
+
+	// Split the file into regions, none smaller than the minimum
+	if(Threads < 1) Threads = 1;
+	if(Backend && !Backend->IsThreadSafe()) Threads = 1;
 
-			Seek(NextPos);
-			if( (Skip < 0) || (Tell() != NextPos))
+	Length Regions = FileSize / RIPMinRegionSize;
+	if(Regions > static_cast<Length>(Threads)) Regions = Threads;
+	if(Regions < 1) Regions = 1;
+
+	std::vector<RIPRegionJob> Walks;
+	Walks.reserve(static_cast<size_t>(Regions));
+
+	Length RegionSize = FileSize / Regions;
+	Position Start = 0;
+	while(Walks.size() < static_cast<size_t>(Regions))
+	{
+		Position End = (Walks.size() == static_cast<size_t>(Regions - 1)) ? FileSize : (Start + RegionSize);
+		Walks.push_back(RIPRegionJob(this, Start, End, FileSize));
+		Start = End;
+	}
+
+	std::vector<FileJob*> Jobs;
+	size_t i;
+	for(i = 0; i < Walks.size(); i++) Jobs.push_back(&Walks[i]);
+	RunFileJobs(Jobs, Threads);
+
+	// Join up the walks - each is only used if walking on from the end of the previous one arrives at its start
+	std::vector<Position> Partitions = Walks[0].Partitions;
+	Position Pos = Walks[0].Stop;
+	for(i = 1; i < Walks.size(); i++)
+	{
+		RIPRegionJob &Walk = Walks[i];
+
+		// An earlier walk may have skipped over this region with a long KLV, or a scan for a partition pack
+		if(Pos >= Walk.End) continue;
+
+		if(Walk.Sync >= 0)
+		{
+			Pos = WalkKLVs(this, Pos, Walk.Sync, FileSize, Partitions);
+			if(Pos == Walk.Sync)
 			{
-				error("Unexpected end of file in KLV starting at 0x%s in file \"%s\" (Trying to skip from 0x%s to 0x%s)\n",
-					  Int64toHexString(Location,8).c_str(), Name.c_str(), Int64toHexString(NextPos - Skip,8).c_str(), Int64toHexString(NextPos,8).c_str());
-				return false;
+				Partitions.insert(Partitions.end(), Walk.Partitions.begin(), Walk.Partitions.end());
+				Pos = Walk.Stop;
+				continue;
 			}
-
-			if(Eof()) break;
 		}
 
-		// Check if we found anything
-		if(!Key) break;
-		if(Eof()) break;
+		// The region's own walk started part-way through a KLV, so walk it again from where we are
+		Pos = WalkKLVs(this, Pos, Walk.End, FileSize, Partitions);
+	}
 
-		// By this point we have found a partition pack
-		// Read it ...
-		Seek(Location);
-		ThisPartition = ReadPartition();
+	// Read each partition pack found and add it to the RIP
+	std::vector<Position>::iterator it = Partitions.begin();
+	while(it != Partitions.end())
+	{
+		Seek(*it);
+		PartitionPtr ThisPartition = ReadPartition();
+		if(!ThisPartition)
+		{
+			error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(*it, 8).c_str(), Name.c_str());
+			return false;
+		}
 
-		// ... then loop back to add it
-		continue;
+		FileRIP.AddPartition(ThisPartition, *it, ThisPartition->GetUInt(BodySID_UL));
+
+		it++;
 	}
 
 	return true;
@@ -831,29 +1888,29 @@ bool mxflib::MXFFile::BuildRIP(void)
 
 //! Read a BER length from the open file
 /*! \return -1 on error
+ *  DRAGONS: The bytes are read into a local buffer to avoid allocating a DataChunk for every length read
  */
 Length mxflib::MXFFile::ReadBER(void)
 {
-	DataChunkPtr Len = Read(1);
-	if(Len->Size < 1)
+	UInt8 Buffer[128];
+	if(ReadSmall(Buffer, 1) < 1)
 	{
 		error("Incomplete BER length in file \"%s\" at 0x%s\n", Name.c_str(), Int64toHexString(Tell(),8).c_str());
 		return -1;
 	}
 
-	Length Ret = Len->Data[0];
+	Length Ret = Buffer[0];
 	if(Ret >= 0x80)
 	{
-		UInt32 i = (UInt32)Ret & 0x7f;
-		Len = Read(i);
-		if(Len->Size != i)
+		size_t i = static_cast<size_t>(Ret & 0x7f);
+		if(ReadSmall(Buffer, i) != i)
 		{
 			error("Incomplete BER length in file \"%s\" at 0x%s\n", Name.c_str(), Int64toHexString(Tell(),8).c_str());
 			return -1;
 		}
 
 		Ret = 0;
-		UInt8 *p = Len->Data;
+		UInt8 *p = Buffer;
 		while(i--) Ret = ((Ret<<8) + *(p++));
 	}
 
@@ -867,21 +1924,21 @@ ULPtr mxflib::MXFFile::ReadKey(void)
 	ULPtr Ret;
 
 //	UInt64 Location = Tell();
-	DataChunkPtr Key = Read(16);
+	UInt8 Key[16];
 
 	// If we couldn't read 16-bytes then bug out (this may be valid)
-	if(Key->Size != 16) return Ret;
+	if(ReadSmall(Key, 16) != 16) return Ret;
 
 /*
 	// Sanity check the keys
-	if((Key->Data[0] != 6) || (Key->Data[1] != 0x0e))
+	if((Key[0] != 6) || (Key[1] != 0x0e))
 	{
 		error("Invalid KLV key found at 0x%s in file \"%s\"\n", Int64toHexString(Location, 8).c_str(), Name.c_str());
 		return Ret;
 	}
 */
 	// Build the UL
-	Ret = new UL(Key->Data);
+	Ret = new UL(Key);
 
 	return Ret;
 }
@@ -1114,6 +2171,89 @@ namespace
 }
 
 
+//! Append a list of header metadata sets to a buffer, using worker threads and cached bytes if enabled
+/*! The bytes appended, and the tags added to the primer, are the same as for calling WriteObject() for each set in turn
+ *  (other than for the dynamic tags of any properties missed by MDObject::AddTagsToPrimer(), which are still valid)
+ */
+void MXFFile::WriteMetadataSets(DataChunkPtr &Buffer, MDObjectList &Sets, PrimerPtr &UsePrimer)
+{
+	std::vector<MDObject*> SetArray;
+	SetArray.reserve(Sets.size());
+
+	MDObjectList::iterator it = Sets.begin();
+	while(it != Sets.end())
+	{
+		SetArray.push_back(*it);
+		it++;
+	}
+
+	size_t Count = SetArray.size();
+	std::vector<DataChunkPtr> Results(Count);
+	std::vector<UInt8> Cached(Count, 0);
+
+	// With no workers the sets are simply written in order
+	if((MetadataThreads <= 1) || (Count < MinParallelMetadataSets))
+	{
+		size_t i;
+		for(i=0; i<Count; i++)
+		{
+			DataChunkPtr Data;
+			if(MetadataCache) Data = SetArray[i]->GetWriteCache(UsePrimer);
+
+			if(Data) Buffer->Append(Data);
+			else
+			{
+				Data = new DataChunk;
+				SetArray[i]->WriteObject(Data, NULL, UsePrimer);
+				Buffer->Append(Data);
+
+				if(MetadataCache) SetArray[i]->SetWriteCache(Data, UsePrimer);
+			}
+		}
+
+		return;
+	}
+
+	// Take any cached sets, and add the tags for all others to the primer, in the order they would be added when writing
+	size_t i;
+	for(i=0; i<Count; i++)
+	{
+		if(MetadataCache) Results[i] = SetArray[i]->GetWriteCache(UsePrimer);
+
+		if(Results[i]) Cached[i] = 1;
+		else SetArray[i]->AddTagsToPrimer(UsePrimer);
+	}
+
+	// Serialize the remaining sets on tasks of the shared executor
+	size_t Next = 0;
+	Mutex Lock;
+	PrimerPtr Template = UsePrimer->MakeCopy();
+
+	TaskGroup Tasks;
+	unsigned int Threads = MetadataThreads;
+	while(Threads--) Tasks.Submit(new MetadataWriteTask(SetArray, Results, Template, Next, Lock));
+	Tasks.Wait();
+
+	// Append the results in order, writing any sets the tasks could not
+	size_t TotalSize = Buffer->Size;
+	for(i=0; i<Count; i++) if(Results[i]) TotalSize += Results[i]->Size;
+	Buffer->ResizeBuffer(TotalSize);
+
+	for(i=0; i<Count; i++)
+	{
+		if(!Results[i])
+		{
+			Results[i] = new DataChunk;
+			SetArray[i]->WriteObject(Results[i], NULL, UsePrimer);
+		}
+
+		Buffer->Append(Results[i]);
+
+		if(MetadataCache && !Cached[i]) SetArray[i]->SetWriteCache(Results[i], UsePrimer);
+	}
+}
+
+
 //! Write or re-write a partition pack and associated metadata (and index table segments?)
 /*! \note Partition properties are updated from the linked metadata
  *	\return true if (re-)write was successful, else false
@@ -1162,6 +2302,10 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 		if(MetadataBuffer->Size != 0) WritePreface = false;
 	}
 
+	// Sets to be written by WriteMetadataSets(), if it is required
+	MDObjectList MetadataSets;
+	bool ListSets = (MetadataThreads > 1) || MetadataCache;
+
 	// Write all objects
 	MDObjectList::iterator it = ThisPartition->TopLevelMetadata.begin();
 	while(it != ThisPartition->TopLevelMetadata.end())
@@ -1171,7 +2315,10 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 			// FIXME: This is a fudge to prevent the preface being written twice with KXS
 			//        We still need to write any other "top level" items
 			if(WritePreface || (!(*it)->IsA(Preface_UL)))
-				(*it)->WriteLinkedObjects(MetadataBuffer, ThisPrimer);
+			{
+				if(ListSets) (*it)->GetLinkedObjects(MetadataSets);
+				else (*it)->WriteLinkedObjects(MetadataBuffer, ThisPrimer);
+			}
 		}
 
 		// See if we are dealing with the preface - if so, we need to extract some data
@@ -1182,6 +2329,8 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 		it++;
 	}
 
+	if(!MetadataSets.empty()) WriteMetadataSets(MetadataBuffer, MetadataSets, ThisPrimer);
+
 	if(Preface)
 	{
 		// Update OP label
@@ -1239,13 +2388,21 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 	// If we are going to be doing block alignment we will need to know the size of the partition pack
 	else if(BlockAlign)
 	{
-		// Write the (currently incomplete) partition pack to determine its size
-		Position CurrentPos = Tell();
-		WritePartitionPack(ThisPartition);
-		PartitionPackSize = (Length)(Tell() - CurrentPos);
-		
-		// Then move back so that we re-write it later
-		Seek(CurrentPos);
+		// DRAGONS: We can't move back in a stream, so we serialize the partition pack to measure it instead
+		if(isStream)
+		{
+			PartitionPackSize = static_cast<Length>(ThisPartition->WriteObject()->Size);
+		}
+		else
+		{
+			// Write the (currently incomplete) partition pack to determine its size
+			Position CurrentPos = Tell();
+			WritePartitionPack(ThisPartition);
+			PartitionPackSize = (Length)(Tell() - CurrentPos);
+			
+			// Then move back so that we re-write it later
+			Seek(CurrentPos);
+		}
 
 		// Read the partition's body SID so we know if there is essence in this partition
 		BodySID = ThisPartition->GetUInt(BodySID_UL);
@@ -1538,41 +2695,148 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 		Write(PrimerBuffer);
 
 		{
-			// Write the Root if writing an Avid compatible metadictionary
-			if(RootBuffer->Size)
-			{
-				// Write the Root Object
-				Write(RootBuffer);
-				HeaderPadding -= static_cast<UInt32>(RootBuffer->Size);
-			}
+			// Write the Root if writing an Avid compatible metadictionary
+			if(RootBuffer->Size)
+			{
+				// Write the Root Object
+				Write(RootBuffer);
+				HeaderPadding -= static_cast<UInt32>(RootBuffer->Size);
+			}
+
+			// Write the other header metadata
+			Write(MetadataBuffer);
+		}
+	}
+
+
+
+	// Write a filler of the required size
+	if(HeaderPadding) Align((UInt32)1, HeaderPadding);
+
+	if(IndexData)
+	{
+		// Write the index data
+		Write(IndexData);
+
+		// Ensure the correct size of filler for the already written index byte count
+
+		UInt32 IndexPadding = static_cast<UInt32>(IndexByteCount - IndexData->Size);
+
+
+
+		// Write a filler of the required size
+
+		if(IndexPadding) Align((UInt32)1, IndexPadding);
+
+	}
+
+
+	return true;
+}
+
+
+//! Overwrite just the changed bytes of a partition pack and its header metadata, as read from this file
+bool MXFFile::PatchPartition(PartitionPtr ThisPartition)
+{
+	if((!isOpen) || isStream || isMappedFile) return false;
+
+	MXFFilePtr PackFile = ThisPartition->GetParentFile();
+	if((!PackFile) || (PackFile.GetPtr() != this)) return false;
+
+	// The bytes to write, and where to write them, which are only written once we know that all the changes can be patched
+	typedef std::list<std::pair<Position, DataChunkPtr> > PatchList;
+	PatchList Patches;
+
+	// The pack is compared with the bytes in the file, as changing the type of a partition does not mark it as modified
+	Position PackLocation = ThisPartition->GetLocation();
+	UInt8 PackKey[16];
+	Length PackLength;
+	Int32 PackKLSize = ReadKLAt(PackLocation, PackKey, PackLength);
+	if(!PackKLSize) return false;
+
+	DataChunkPtr NewPack = ThisPartition->WriteObject();
+	if(NewPack->Size != static_cast<size_t>(PackKLSize + PackLength)) return false;
+
+	DataChunkPtr OldPack = ReadAt(PackLocation, NewPack->Size);
+	if((!OldPack) || (OldPack->Size != NewPack->Size)) return false;
+
+	bool PackChanged = (memcmp(OldPack->Data, NewPack->Data, NewPack->Size) != 0);
+
+	// The sets patched, to be marked as unmodified once their changes are in the file
+	MDObjectList PatchedSets;
+
+	MDObjectList::iterator it = ThisPartition->AllMetadata.begin();
+	while(it != ThisPartition->AllMetadata.end())
+	{
+		MDObjectPtr &Set = *it;
+		it++;
+
+		if(!Set->IsModified()) continue;
+
+		// DRAGONS: Sets read from a preloaded partition were parsed from a memory copy of this file, holding the same bytes
+		//          at the same locations, so are accepted if that copy has our name
+		MXFFilePtr SetFile = Set->GetParentFile();
+		if((!SetFile) || ((SetFile.GetPtr() != this) && (SetFile->Name != Name))) return false;
+
+		// A set that is itself modified has had properties added or removed
+		if(Set->IsModifiedItself()) return false;
+
+		// Only local sets with 2-byte tags and lengths are patched
+		if((Set->GetType()->GetKeyFormat() != DICT_KEY_2_BYTE) || (Set->GetType()->GetLenFormat() != DICT_LEN_2_BYTE)) return false;
+
+		MDObject::iterator Prop_it = Set->begin();
+		while(Prop_it != Set->end())
+		{
+			MDObjectPtr &Property = (*Prop_it).second;
+			Prop_it++;
 
-			// Write the other header metadata
-			Write(MetadataBuffer);
-		}
-	}
+			if(!Property->IsModified()) continue;
+			if(Property->GetParent().GetPtr() != Set.GetPtr()) return false;
 
+			DataChunkPtr NewValue = Property->PutData();
 
+			// Check that the file still holds this property, with a value of the same size, at the location it was read from
+			Position Location = Property->GetLocation();
+			UInt8 OldTL[4];
+			if(ReadAt(Location, OldTL, 4) != 4) return false;
+			if((GetU16(OldTL) != Property->GetTag()) || (GetU16(&OldTL[2]) != NewValue->Size)) return false;
 
-	// Write a filler of the required size
-	if(HeaderPadding) Align((UInt32)1, HeaderPadding);
+			Patches.push_back(PatchList::value_type(Location + 4, NewValue));
+		}
 
-	if(IndexData)
-	{
-		// Write the index data
-		Write(IndexData);
+		PatchedSets.push_back(Set);
+	}
 
-		// Ensure the correct size of filler for the already written index byte count
+	// The pack is written last, so that if a write fails the old pack still describes the partition
+	if(PackChanged) Patches.push_back(PatchList::value_type(PackLocation, NewPack));
 
-		UInt32 IndexPadding = static_cast<UInt32>(IndexByteCount - IndexData->Size);
+	Position CurrentPos = Tell();
 
+	PatchList::iterator Patch_it = Patches.begin();
+	while(Patch_it != Patches.end())
+	{
+		if((Seek((*Patch_it).first) != 0) || (Write(*(*Patch_it).second) != (*Patch_it).second->Size))
+		{
+			error("Failed to write 0x%s bytes at 0x%s while patching the partition at 0x%s in file \"%s\"\n", Int64toHexString((*Patch_it).second->Size).c_str(),
+				  Int64toHexString((*Patch_it).first, 8).c_str(), Int64toHexString(PackLocation, 8).c_str(), Name.c_str());
 
+			Seek(CurrentPos);
+			return false;
+		}
 
-		// Write a filler of the required size
+		Patch_it++;
+	}
 
-		if(IndexPadding) Align((UInt32)1, IndexPadding);
+	Seek(CurrentPos);
 
+	// The file now matches the metadata, so nothing is left to be written
+	MDObjectList::iterator Set_it = PatchedSets.begin();
+	while(Set_it != PatchedSets.end())
+	{
+		(*Set_it)->ClearModified();
+		Set_it++;
 	}
-
+	ThisPartition->ClearModified();
 
 	return true;
 }
@@ -1580,6 +2844,12 @@ bool MXFFile::WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, b
 
 size_t MXFFile::MemoryWrite(UInt8 const *Data, size_t Size)
 {
+	if(isMappedFile)
+	{
+		error("Cannot write to memory mapped file \"%s\"\n", Name.c_str());
+		return 0;
+	}
+
 	if(BufferCurrentPos < BufferOffset)
 	{
 		error("Cannot currently write to a memory file before the buffer start\n");
@@ -1607,7 +2877,8 @@ size_t MXFFile::MemoryRead(UInt8 *Data, size_t Size)
 
 	if((BufferCurrentPos - BufferOffset) >= Buffer->Size)
 	{
-		error("Cannot currently read beyond the end of a memory file buffer\n");
+		// The end of a mapped file is a genuine end-of-file, not an error
+		if(!isMappedFile) error("Cannot currently read beyond the end of a memory file buffer\n");
 		return 0;
 	}
 
@@ -1632,6 +2903,34 @@ size_t MXFFile::MemoryRead(UInt8 *Data, size_t Size)
 
 
 
+//! Read from a memory file buffer, returning a DataChunk that references the buffer rather than a copy
+DataChunkPtr MXFFile::MemoryReadView(size_t Size)
+{
+	DataChunkPtr Ret = new DataChunk();
+
+	if(BufferCurrentPos < BufferOffset)
+	{
+		error("Cannot currently read from a memory file before the buffer start\n");
+		return Ret;
+	}
+
+	// If we are at, or beyond, the end of the file return an empty chunk
+	if((BufferCurrentPos - BufferOffset) >= Buffer->Size) return Ret;
+
+	// Limit our read to the bytes available
+	size_t Start = static_cast<size_t>(BufferCurrentPos - BufferOffset);
+	if(Size > (Buffer->Size - Start)) Size = Buffer->Size - Start;
+
+	// Point the new chunk at the data in the buffer
+	Ret->SetBuffer(Buffer, &Buffer->Data[Start], Size);
+
+	// Update the pointer
+	BufferCurrentPos += Size;
+
+	return Ret;
+}
+
+
 //! Read a KLVObject from the file
 KLVObjectPtr MXFFile::ReadKLV(void)
 {
@@ -1647,6 +2946,208 @@ KLVObjectPtr MXFFile::ReadKLV(void)
 }
 
 
+//! Read a KLVObject from the file, reading no more than its key and length
+/*! \return NULL if no more valid KLVs
+ */
+KLVObjectPtr MXFFile::ReadKLVHeader(void)
+{
+	Position Location = Tell();
+
+	UInt8 Key[16];
+	Length ValueLength;
+	Int32 KLSize = ReadKL(Key, ValueLength);
+	if(KLSize < 17) return NULL;
+
+	KLVObjectPtr Ret = new KLVObject();
+	Ret->SetSource(this, Location);
+	Ret->SetSourceKL(new UL(Key), ValueLength, KLSize);
+
+	return Ret;
+}
+
+
+//! Read the key and length of the KLV at the current position with a single small read
+/*! \return The size of the key and length, or 0 if no complete and valid KL could be read
+ */
+Int32 MXFFile::ReadKL(UInt8 *Key, Length &ValueLength)
+{
+	Position Location = Tell();
+
+	// Read the key and the longest valid BER length, which may run into the value (or the next KLV) if the length is shorter
+	UInt8 Buffer[16 + 9];
+	size_t Bytes = ReadSmall(Buffer, sizeof(Buffer));
+	if(Bytes < 17)
+	{
+		Seek(Location);
+		return 0;
+	}
+
+	const UInt8 *BERPtr = &Buffer[16];
+	ValueLength = mxflib::ReadBER(&BERPtr, static_cast<int>(Bytes - 16));
+	if(ValueLength < 0)
+	{
+		error("Invalid or incomplete BER length in file \"%s\" at 0x%s\n", Name.c_str(), Int64toHexString(Location + 16, 8).c_str());
+		Seek(Location);
+		return 0;
+	}
+
+	memcpy(Key, Buffer, 16);
+
+	Int32 KLSize = static_cast<Int32>(BERPtr - Buffer);
+	Seek(Location + KLSize);
+
+	return KLSize;
+}
+
+
+//! Read a few bytes from the file without loading a new read-ahead window
+size_t MXFFile::ReadSmall(UInt8 *Buffer, size_t Size)
+{
+	if(isMemoryFile || (!ReadAheadSize)) return Read(Buffer, Size);
+
+	if(WritesPending()) SyncWrites();
+
+	// Use the current window if it holds everything
+	if(InReadAhead() && ((ReadAheadPos + Size) <= (ReadAheadStart + ReadAheadBuffer->Size))) return ReadAheadRead(Buffer, Size);
+
+	StatsAdd(StatsFileReadCalls);
+	TraceScope Trace("MXFFile::Read", "io");
+
+	size_t Ret = PhysicalRead(ReadAheadPos, Buffer, Size);
+	ReadAheadHandlePos = static_cast<UInt64>(-1);
+
+	if(Ret == static_cast<size_t>(-1))
+	{
+		error("Error reading file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(Tell(), 8).c_str(), strerror(errno));
+		return 0;
+	}
+
+	StatsAdd(StatsFileReadBytes, Ret);
+
+	ReadAheadPos += Ret;
+	return Ret;
+}
+
+
+
+//! Read data from a given position in the file, without using or moving the file pointer
+DataChunkPtr MXFFile::ReadAt(Position Pos, size_t Size)
+{
+	// Mapped files return a reference to the data rather than a copy
+	if(isMappedFile && isOpen && (Pos >= 0))
+	{
+		StatsAdd(StatsFileReadCalls);
+		TraceScope Trace("MXFFile::Read", "io");
+
+		DataChunkPtr Ret = new DataChunk();
+
+		UInt64 Start = static_cast<UInt64>(Pos) + RunInSize;
+		if((Start < BufferOffset) || ((Start - BufferOffset) >= Buffer->Size)) return Ret;
+
+		size_t Offset = static_cast<size_t>(Start - BufferOffset);
+		if(Size > (Buffer->Size - Offset)) Size = Buffer->Size - Offset;
+
+		Ret->SetBuffer(Buffer, &Buffer->Data[Offset], Size);
+
+		StatsAdd(StatsFileReadBytes, Size);
+		return Ret;
+	}
+
+	DataChunkPtr Ret = new DataChunk(Size);
+
+	size_t Bytes = ReadAt(Pos, Ret->Data, Size);
+	if(Bytes != Size) Ret->Resize(Bytes);
+
+	return Ret;
+}
+
+
+//! Read data from a given position in the file into a supplied buffer, without using or moving the file pointer
+size_t MXFFile::ReadAt(Position Pos, UInt8 *Data, size_t Size)
+{
+	if((!isOpen) || (Pos < 0) || (!Size)) return 0;
+
+	StatsAdd(StatsFileReadCalls);
+	TraceScope Trace("MXFFile::Read", "io");
+
+	UInt64 Start = static_cast<UInt64>(Pos) + RunInSize;
+	size_t Ret;
+
+	if(isMemoryFile)
+	{
+		// DRAGONS: Memory files hold the data as a buffer starting at BufferOffset
+		if((Start < BufferOffset) || ((Start - BufferOffset) >= Buffer->Size) || (!Buffer->Data)) return 0;
+
+		size_t Offset = static_cast<size_t>(Start - BufferOffset);
+		Ret = Buffer->Size - Offset;
+		if(Ret > Size) Ret = Size;
+
+		memcpy(Data, &Buffer->Data[Offset], Ret);
+	}
+	else if(isStream)
+	{
+		error("Unable to read from output stream \"%s\"\n", Name.c_str());
+		return 0;
+	}
+	else if(Backend)
+	{
+		Ret = Backend->ReadAt(Start, Data, Size);
+	}
+	else
+	{
+		Ret = FileReadAt(Handle, Start, Data, Size);
+	}
+
+	if(Ret == static_cast<size_t>(-1))
+	{
+		error("Error reading file \"%s\" at 0x%s - %s\n", Name.c_str(), Int64toHexString(Pos, 8).c_str(), strerror(errno));
+		return 0;
+	}
+
+	StatsAdd(StatsFileReadBytes, Ret);
+
+	return Ret;
+}
+
+
+//! Read the key and length of the KLV at a given position, without using or moving the file pointer
+Int32 MXFFile::ReadKLAt(Position Pos, UInt8 *Key, Length &ValueLength)
+{
+	// Read the key and the longest valid BER length, which may run into the value (or the next KLV) if the length is shorter
+	UInt8 Buffer[16 + 9];
+	size_t Bytes = ReadAt(Pos, Buffer, sizeof(Buffer));
+	if(Bytes < 17) return 0;
+
+	const UInt8 *BERPtr = &Buffer[16];
+	ValueLength = mxflib::ReadBER(&BERPtr, static_cast<int>(Bytes - 16));
+	if(ValueLength < 0)
+	{
+		error("Invalid or incomplete BER length in file \"%s\" at 0x%s\n", Name.c_str(), Int64toHexString(Pos + 16, 8).c_str());
+		return 0;
+	}
+
+	memcpy(Key, Buffer, 16);
+
+	return static_cast<Int32>(BERPtr - Buffer);
+}
+
+
+//! Read a KLVObject from a given position in the file, reading no more than its key and length, without using or moving the file pointer
+KLVObjectPtr MXFFile::ReadKLVHeaderAt(Position Pos)
+{
+	UInt8 Key[16];
+	Length ValueLength;
+	Int32 KLSize = ReadKLAt(Pos, Key, ValueLength);
+	if(KLSize < 17) return NULL;
+
+	KLVObjectPtr Ret = new KLVObject();
+	Ret->SetSource(this, Pos);
+	Ret->SetSourceKL(new UL(Key), ValueLength, KLSize);
+	Ret->SetPositionalRead();
+
+	return Ret;
+}
+
 
 //! Locate and read a partition containing closed header metadata
 /*! \ret NULL if none found
@@ -1910,10 +3411,10 @@ bool MXFFile::IsTruncated(std::string *Details /*=NULL*/)
 		if(ChunkPos < ChunkSize) ChunkSize = static_cast<size_t>(ChunkPos);
 		
 		// Read the small first chunk
+		// DRAGONS: Positional reads are used so that scanning backwards does not fill the read-ahead window with data that will not be used
 		Buffer->Resize(ChunkSize);
 		ChunkPos -= ChunkSize;
-		Seek(ChunkPos);
-		Read(Buffer->Data, ChunkSize);
+		ReadAt(ChunkPos, Buffer->Data, ChunkSize);
 
 		// Do a simple check to see if the file seems to end in padding bytes
 		if(Buffer->Data[ChunkSize - 1] == Buffer->Data[ChunkSize - 2])
@@ -2040,8 +3541,7 @@ bool MXFFile::IsTruncated(std::string *Details /*=NULL*/)
 				memmove(&Buffer->Data[ChunkSize], Buffer->Data, 15);
 
 				// Read this chunk
-				Seek(ChunkPos);
-				Read(Buffer->Data, ChunkSize);
+				ReadAt(ChunkPos, Buffer->Data, ChunkSize);
 				pScan = &Buffer->Data[ChunkSize - 1];
 
 				// Scan from here
@@ -2070,7 +3570,7 @@ bool MXFFile::IsTruncated(std::string *Details /*=NULL*/)
 
 			// Check if the file ends during the L of this KLV, if not, read the length
 			Seek(LastKLV + 16);
-			int LenLen = FileGetc(Handle);
+			int LenLen = ReadU8();
 			if(LenLen <= 0x80) LastKLVLength = LenLen;
 			else
 			{
@@ -2158,7 +3658,7 @@ bool MXFFile::IsTruncated(std::string *Details /*=NULL*/)
 
 	// Manually read the footer KLV length, validating as we go
 	Seek(FooterPos + 16);
-	Length Len = FileGetc(Handle);
+	Length Len = ReadU8();
 	if(Len == 0x80)
 	{
 		// Treat invalid BER as truncated
@@ -2222,7 +3722,7 @@ bool MXFFile::IsTruncated(std::string *Details /*=NULL*/)
 		if(TestKey->Matches(KLVFill_UL))
 		{
 			// Manually read the filler length, validating as we go
-			Length Len = FileGetc(Handle);
+			Length Len = ReadU8();
 			if(Len == 0x80)
 			{
 				// Treat invalid BER as truncated
@@ -2459,3 +3959,254 @@ WrapType MXFFile::GetWrapType(UInt32 BodySID, PartitionPtr ThisPartition)
 	return Ret;
 }
 
+
+
+namespace
+{
+	//! The number of bytes read from the start of each partition by MXFFile::Preload() before its size is known
+	const size_t PreloadFirstRead = 64 * 1024;
+
+	//! A positional read of part of a file
+	class PreloadReadJob : public FileJob
+	{
+	public:
+		MXFFile *File;							//!< The file to read
+		Position Start;							//!< The position of the first byte to read
+		size_t Size;							//!< The number of bytes to read
+		DataChunkPtr Data;						//!< The bytes read
+
+		PreloadReadJob(MXFFile *File, Position Start, size_t Size) : File(File), Start(Start), Size(Size) {}
+
+		void Execute(void) { Data = File->ReadAt(Start, Size); }
+	};
+
+	//! The parsing of all the index table segments of one IndexSID into an index table
+	class PreloadIndexJob : public FileJob
+	{
+	public:
+		IndexTablePtr Table;					//!< The table to build
+		std::vector<DataChunkPtr> Chunks;		//!< The index table segments of each partition, in file order
+
+		PreloadIndexJob() : Table(new IndexTable) {}
+
+		void Execute(void)
+		{
+			std::vector<DataChunkPtr>::iterator it = Chunks.begin();
+			while(it != Chunks.end())
+			{
+				Table->AddSegments(*it);
+				it++;
+			}
+		}
+	};
+
+	//! Determine if a key is a KLV filler key
+	bool IsPreloadFillerKey(const UInt8 *Key)
+	{
+		// DRAGONS: The version byte of the filler key varies, so is not compared
+		return (memcmp(Key, KLVFill_UL_Data, 7) == 0) && (memcmp(&Key[8], &KLVFill_UL_Data[8], 8) == 0);
+	}
+
+	//! The layout of one partition, found from the first bytes read by MXFFile::Preload()
+	struct PreloadPartition
+	{
+		PartitionInfoPtr Info;					//!< The RIP entry of the partition
+		DataChunkPtr Data;						//!< The bytes of the partition, from the partition pack to the end of its index table segments
+		UInt32 KLSize;							//!< The size of the key and length of the partition pack
+		size_t MetadataStart;					//!< The offset in Data of the header metadata, after the pack and any filler
+		UInt64 HeaderByteCount;					//!< The size of the header metadata, including any trailing filler
+		UInt64 IndexByteCount;					//!< The size of the index table segments, including any trailing filler
+		UInt32 IndexSID;						//!< The IndexSID of the partition
+		UInt32 BodySID;							//!< The BodySID of the partition
+	};
+
+	//! Find the layout of a partition from its first bytes
+	/*! \return The number of bytes from the start of the partition pack to the end of its index table segments, or 0 if not a valid partition pack */
+	UInt64 ParsePreloadPartition(PreloadPartition &Part)
+	{
+		const UInt8 *Start = Part.Data->Data;
+		size_t Size = Part.Data->Size;
+
+		if((Size < 17) || !IsPartitionPackKey(Start)) return 0;
+
+		const UInt8 *p = &Start[16];
+		Length PackLength = mxflib::ReadBER(&p, static_cast<int>(Size - 16));
+
+		// DRAGONS: The fixed part of a partition pack is 88 bytes, holding the fields we need at fixed offsets
+		if((PackLength < 88) || ((p - Start) + PackLength > static_cast<Length>(Size))) return 0;
+
+		Part.KLSize = static_cast<UInt32>(p - Start);
+		Part.HeaderByteCount = GetU64(&p[32]);
+		Part.IndexByteCount = GetU64(&p[40]);
+		Part.IndexSID = GetU32(&p[48]);
+		Part.BodySID = GetU32(&p[60]);
+
+		size_t PackEnd = static_cast<size_t>((p - Start) + PackLength);
+		Part.MetadataStart = PackEnd;
+
+		// Skip any filler following the partition pack
+		if((Size >= PackEnd + 17) && IsPreloadFillerKey(&Start[PackEnd]))
+		{
+			p = &Start[PackEnd + 16];
+			Length FillLength = mxflib::ReadBER(&p, static_cast<int>(Size - PackEnd - 16));
+			if(FillLength < 0) return 0;
+
+			Part.MetadataStart = static_cast<size_t>((p - Start) + FillLength);
+		}
+
+		return Part.MetadataStart + Part.HeaderByteCount + Part.IndexByteCount;
+	}
+}
+
+
+//! Read every partition pack, with its header metadata and index table segments, using concurrent reads
+bool MXFFile::Preload(unsigned int Threads /*=8*/)
+{
+	if((!isOpen) || isStream) return false;
+
+	PreloadedIndex.clear();
+
+	if(FileRIP.empty() && !GetRIP()) return false;
+
+	if(Threads < 1) Threads = 1;
+	if(Backend && !Backend->IsThreadSafe()) Threads = 1;
+
+	std::vector<PreloadPartition> Parts(FileRIP.size());
+	std::vector<PreloadReadJob> Reads;
+	Reads.reserve(FileRIP.size());
+
+	// First read the start of every partition, which will hold all of most small partitions
+	size_t i = 0;
+	RIP::iterator it = FileRIP.begin();
+	while(it != FileRIP.end())
+	{
+		Parts[i].Info = (*it).second;
+		Reads.push_back(PreloadReadJob(this, (*it).second->GetByteOffset(), PreloadFirstRead));
+
+		i++;
+		it++;
+	}
+
+	std::vector<FileJob*> Jobs;
+	for(i = 0; i < Reads.size(); i++) Jobs.push_back(&Reads[i]);
+	RunFileJobs(Jobs, Threads);
+
+	// Now read the whole of any partition that did not fit in the first read
+	Length FileSize = Size();
+	std::vector<PreloadReadJob> MoreReads;
+	std::vector<size_t> MoreParts;
+	for(i = 0; i < Parts.size(); i++)
+	{
+		Parts[i].Data = Reads[i].Data;
+
+		UInt64 End = ParsePreloadPartition(Parts[i]);
+		if(End == 0)
+		{
+			error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(Parts[i].Info->GetByteOffset(), 8).c_str(), Name.c_str());
+			Parts[i].Data = NULL;
+			continue;
+		}
+
+		// DRAGONS: Byte counts are not trusted until checked against the file, as a damaged pack could otherwise ask for a huge read
+		if((FileSize >= 0) && (static_cast<Position>(End) > (FileSize - Parts[i].Info->GetByteOffset())))
+		{
+			error("Partition at 0x%s in file \"%s\" has byte counts running past the end of the file\n", Int64toHexString(Parts[i].Info->GetByteOffset(), 8).c_str(), Name.c_str());
+			Parts[i].Data = NULL;
+			continue;
+		}
+
+		if((sizeof(size_t) < 8) && (End > 0xffffffff))
+		{
+			error("Maximum read size on this platform is 4Gbytes - However, requested to read partition at 0x%s which has size of 0x%s\n",
+				  Int64toHexString(Parts[i].Info->GetByteOffset(), 8).c_str(), Int64toHexString(End, 8).c_str());
+			Parts[i].Data = NULL;
+			continue;
+		}
+
+		if(End > Parts[i].Data->Size)
+		{
+			MoreReads.push_back(PreloadReadJob(this, Parts[i].Info->GetByteOffset(), static_cast<size_t>(End)));
+			MoreParts.push_back(i);
+		}
+	}
+
+	if(!MoreReads.empty())
+	{
+		Jobs.clear();
+		for(i = 0; i < MoreReads.size(); i++) Jobs.push_back(&MoreReads[i]);
+		RunFileJobs(Jobs, Threads);
+
+		for(i = 0; i < MoreReads.size(); i++) Parts[MoreParts[i]].Data = MoreReads[i].Data;
+	}
+
+	// Parse the partition packs and header metadata, and gather the index table segments of each IndexSID
+	MXFFilePtr Self = this;
+	std::map<UInt32, PreloadIndexJob*> IndexJobs;
+	for(i = 0; i < Parts.size(); i++)
+	{
+		PreloadPartition &Part = Parts[i];
+		if(!Part.Data) continue;
+
+		Position Location = Part.Info->GetByteOffset();
+		UInt64 End = Part.MetadataStart + Part.HeaderByteCount + Part.IndexByteCount;
+		if(Part.Data->Size < End)
+		{
+			error("Unable to read all of the partition at 0x%s in file \"%s\"\n", Int64toHexString(Location, 8).c_str(), Name.c_str());
+			continue;
+		}
+
+		// Parse from a memory file holding the bytes read, at the same positions as in this file
+		MXFFilePtr Memory = new MXFFile;
+		Memory->OpenMemory(Part.Data, Location);
+		Memory->Name = Name;
+		Memory->SetTypeOverlay(Overlay);
+
+		Memory->Seek(Location);
+		PartitionPtr ThisPartition = Memory->ReadPartition();
+		if(!ThisPartition)
+		{
+			error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(Location, 8).c_str(), Name.c_str());
+			continue;
+		}
+
+		if(Part.HeaderByteCount) ThisPartition->ReadMetadata();
+		if(Memory->GetTypeOverlay()) Overlay = Memory->GetTypeOverlay();
+
+		// Re-parent the pack so that later use, such as SeekEssence(), reads this file
+		ThisPartition->Object->SetParent(Self, Location, Part.KLSize);
+
+		Part.Info->SetSIDs(Part.BodySID, Part.IndexSID);
+		Part.Info->SetPartition(ThisPartition);
+		Part.Info->SetEssenceStart(Location + static_cast<Position>(End));
+
+		if(Part.IndexByteCount && Part.IndexSID)
+		{
+			PreloadIndexJob *&Job = IndexJobs[Part.IndexSID];
+			if(!Job) Job = new PreloadIndexJob;
+
+			DataChunkPtr IndexData = new DataChunk;
+			IndexData->SetBuffer(Part.Data, &Part.Data->Data[Part.MetadataStart + Part.HeaderByteCount], static_cast<size_t>(Part.IndexByteCount));
+			Job->Chunks.push_back(IndexData);
+		}
+	}
+
+	// Finally parse the index table segments, one IndexSID per job
+	Jobs.clear();
+	std::map<UInt32, PreloadIndexJob*>::iterator JobIt = IndexJobs.begin();
+	while(JobIt != IndexJobs.end())
+	{
+		Jobs.push_back((*JobIt).second);
+		JobIt++;
+	}
+	RunFileJobs(Jobs, Threads);
+
+	JobIt = IndexJobs.begin();
+	while(JobIt != IndexJobs.end())
+	{
+		PreloadedIndex[(*JobIt).first] = (*JobIt).second->Table;
+		delete (*JobIt).second;
+		JobIt++;
+	}
+
+	return true;
+}
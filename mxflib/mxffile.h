@@ -46,26 +46,81 @@ namespace mxflib
 
 namespace mxflib
 {
+	// Forward declare the background writer used for asynchronous writes
+	class AsyncFileWriter;
+
+	//! A DataChunk holding a read-only memory mapping of a file
+	/*! The mapping is released when the last reference to this chunk is dropped, so any
+	 *  DataChunk set to reference it with SetBuffer(Owner, ...) will keep the mapping valid
+	 */
+	class MappedFileChunk : public DataChunk
+	{
+	protected:
+		UInt8 *MapBase;					//!< The base address of the mapping
+		UInt64 MapSize;					//!< The size of the mapping
+
+	public:
+		MappedFileChunk(UInt8 *Map, UInt64 Size) : MapBase(Map), MapSize(Size) { SetBuffer(Map, static_cast<size_t>(Size)); };
+		~MappedFileChunk() { FileMemoryUnmap(MapBase, MapSize); };
+	};
+
 	//! Holds data relating to an MXF file
 	class MXFFile : public RefCount<MXFFile>
 	{
 	protected:
 		bool isOpen;					//!< True when the file is open
 		bool isMemoryFile;				//!< True is the file is a "memory file"
+		bool isMappedFile;				//!< True if the file is a memory mapped physical file (this is also flagged as a memory file)
 		bool isHandleFile;				//!< True if the file handle is managed externally (we don't open or close it ourselves)
+		bool isStream;					//!< True if the file is a non-seekable output stream, such as a pipe or socket
+		UInt64 StreamPos;				//!< Number of bytes written to a stream, used as the file pointer as the handle can't report it
 		bool TruncatedKnown;			//!< True if the state of "Truncated" has been determined
 		bool Truncated;					//!< True if we have determined that this file has been truncated
 		FileHandle Handle;				//!< File handle
+		FileBackendPtr Backend;			//!< The backend used for all I/O, or NULL if this file uses Handle or is a memory file
 		UInt32 RunInSize;				//!< Size of run-in in physical file
 
 		DataChunkPtr Buffer;			//!< Memory file buffer pointer
 		UInt64 BufferOffset;			//!< Offset of the start of the buffer from the start of the memory file
 		UInt64 BufferCurrentPos;		//!< Offset of the current position from the start of the memory file
 
+		size_t ReadAheadSize;			//!< Size of the read-ahead window for physical files, or 0 if read-ahead is disabled
+		UInt32 ReadAheadAlign;			//!< Alignment of the start of each read-ahead window (such as the KAG), or 0 for none
+		DataChunkPtr ReadAheadBuffer;	//!< The current read-ahead window, or NULL if none loaded
+		UInt64 ReadAheadStart;			//!< Physical file position of the start of ReadAheadBuffer
+		UInt64 ReadAheadPos;			//!< Physical file position of the file pointer when read-ahead is enabled
+		UInt64 ReadAheadHandlePos;		//!< Physical file position of the file handle when read-ahead is enabled, or -1 if not known
+		bool ReadAheadShared;			//!< True if views of ReadAheadBuffer have been returned, so it must not be overwritten
+
+		AsyncFileWriter *AsyncWriter;	//!< Background writer for asynchronous writes, or NULL if writes are synchronous
+		bool AsyncPending;				//!< True if data has been passed to AsyncWriter since the file position was last synchronized
+		UInt64 AsyncPos;				//!< Physical file position of the file pointer while AsyncPending is set
+
+		DataChunkPtr GatherBuffer;		//!< Buffer collecting writes between StartGather() and EndGather(), or NULL if not gathering
+		size_t GatherLimit;				//!< The gathered data is written once it reaches this size
+		UInt64 GatherPos;				//!< Physical file position of the start of the data in GatherBuffer
+
+		UInt8 *DirectBuffer;			//!< Aligned staging buffer for direct (unbuffered) writing, or NULL if not enabled
+		size_t DirectBufferSize;		//!< Size of DirectBuffer, a multiple of DirectAlign
+		UInt32 DirectAlign;				//!< Block size to which all direct writes are aligned
+		DirectFileHandle DirectHandle;	//!< Unbuffered handle, used for all whole blocks written while direct writing is enabled
+		bool DirectPending;				//!< True if DirectBuffer holds data not yet written to the file
+		UInt64 DirectStart;				//!< Physical file position of the start of DirectBuffer, always a multiple of DirectAlign
+		size_t DirectFill;				//!< Number of bytes in DirectBuffer
+
+		bool Preallocated;				//!< True if disk space has been reserved by Preallocate(), and any left over must be released on closing
+
+		unsigned int MetadataThreads;	//!< Number of threads used to serialize header metadata sets, or 0 or 1 for the calling thread only
+		bool MetadataCache;				//!< True if the serialized bytes of each header metadata set are kept for reuse when unchanged
+
 		UInt32 BlockAlign;				//!< Some systems can run more efficiently if the essence and index data start on a block boundary - if used this is the block size
 		Int32 BlockAlignEssenceOffset;	//!< Fixed distance from the block grid at which to align essence (+ve is after the grid, -ve before)
 		Int32 BlockAlignIndexOffset;	//!< Fixed distance from the block grid at which to align index (+ve is after the grid, -ve before)
 
+		TypeOverlayPtr Overlay;			//!< Overlay holding the classes and types of the file's metadictionary once the dictionary is frozen, or NULL if none
+
+		std::map<UInt32, IndexTablePtr> PreloadedIndex;	//!< Index tables built by Preload(), indexed by IndexSID
+
 		//DRAGONS: There should probably be a property to say that in-memory values have changed?
 		//DRAGONS: Should we have a flush() function
 	public:
@@ -74,21 +129,146 @@ namespace mxflib
 		std::string Name;
 
 	public:
-		MXFFile() : isOpen(false), isMemoryFile(false), TruncatedKnown(false), Truncated(false), BlockAlign(0) {};
+		MXFFile() : isOpen(false), isMemoryFile(false), isMappedFile(false), isStream(false), TruncatedKnown(false), Truncated(false), ReadAheadSize(0), ReadAheadAlign(0), AsyncWriter(NULL), AsyncPending(false), DirectBuffer(NULL), DirectPending(false), Preallocated(false), MetadataThreads(0), MetadataCache(false), BlockAlign(0) {};
 		~MXFFile() { if(isOpen) Close(); };
 
 		virtual bool Open(std::string FileName, bool ReadOnly = false );
 		virtual bool OpenNew(std::string FileName);
 		virtual bool OpenMemory(DataChunkPtr Buff = NULL, Position Offset = 0);
+		virtual bool OpenMapped(std::string FileName);
 		virtual bool OpenFromHandle(FileHandle Handle);
+		virtual bool OpenStreamFromHandle(FileHandle Handle);
+		virtual bool OpenBackend(FileBackendPtr Backend);
 		virtual bool Close(void);
 
+		//! Determine if this is a memory file (including a memory mapped physical file)
+		bool IsMemoryFile(void) const { return isMemoryFile; }
+
+		//! Determine if this is a non-seekable output stream
+		bool IsStream(void) const { return isStream; }
+
+		//! Determine if this is a memory mapped physical file
+		bool IsMappedFile(void) const { return isMappedFile; }
+
+		//! Determine if this file is accessed through a FileBackend
+		bool IsBackendFile(void) const { return Backend ? true : false; }
+
+		//! Get the backend used by this file, or NULL if it does not use one
+		FileBackendPtr GetBackend(void) { return Backend; }
+
+		//! Set the size of the read-ahead window used when reading physical files
+		/*! \param Size	The number of bytes to read from the file in one go, or 0 to disable read-ahead
+		 *  \param Align	If non-zero, each window starts on a multiple of this many bytes from the start of the MXF data (such as the KAG)
+		 *  Small reads, such as keys and lengths, and seeks within the current window are then satisfied from
+		 *  memory rather than each requiring a call to the operating system.
+		 *  \note This has no effect on memory files. Backend files always read via the window, so setting 0 selects the backend's block size
+		 */
+		void SetReadAhead(size_t Size, UInt32 Align = 0);
+
+		//! Get the size of the read-ahead window, or 0 if read-ahead is disabled
+		size_t GetReadAhead(void) const { return ReadAheadSize; }
+
+		//! Enable or disable asynchronous writing of a physical file
+		/*! \param BufferSize	The size of each output buffer, or 0 to return to synchronous writing
+		 *  \param BufferCount	The number of output buffers, including the one being filled (minimum 2)
+		 *  When enabled, data passed to Write() is copied to an output buffer and each full buffer is written
+		 *  by a background thread, so the caller can carry on preparing the next data while the last is written.
+		 *  The caller only waits if all buffers are full. Any other access to the file (such as a Seek() to a
+		 *  different position, a Read() or a Flush()) first waits for all pending writes to complete.
+		 *  \note This must be called after the file is opened, and is disabled when the file is closed. It has no effect on memory files
+		 *  DRAGONS: Write errors are reported when the pending writes are completed rather than by Write() itself
+		 *  \return true if asynchronous writing is now enabled
+		 */
+		bool SetAsyncWrite(size_t BufferSize, unsigned int BufferCount = 2);
+
+		//! Determine if asynchronous writing is enabled
+		bool IsAsyncWrite(void) const { return AsyncWriter != NULL; }
+
+		//! Enable or disable direct (unbuffered) writing of a physical file
+		/*! \param BufferSize	The size of the staging buffer (rounded up to a multiple of Align), or 0 to return to normal writing
+		 *  \param Align		The block size required by the storage for unbuffered writes
+		 *  When enabled, data passed to Write() is collected in an aligned staging buffer and each full buffer is written
+		 *  with O_DIRECT (or FILE_FLAG_NO_BUFFERING on Windows), so writing a very large file does not fill the OS cache.
+		 *  Any other access to the file (such as a Seek() to a different position, a Read() or a Flush()) first writes the
+		 *  whole blocks in the buffer in the same way, and any final part block through the normal file handle. A run of
+		 *  writes that starts part way through a block, such as rewriting a header, reads the start of that block first.
+		 *  Partitions, and the essence within them, are only written on block boundaries if the KAG is a multiple of the
+		 *  block size (or SetBlockAlign() is used) but this affects the speed of writing rather than the data written.
+		 *  \note This must be called after the file is opened, and is disabled when the file is closed. It has no effect on
+		 *        memory files and can't be used at the same time as asynchronous writing
+		 *  \return true if direct writing is now enabled, false if it is not available for this file
+		 */
+		bool SetDirectWrite(size_t BufferSize, UInt32 Align = 4096);
+
+		//! Determine if direct writing is enabled
+		bool IsDirectWrite(void) const { return DirectBuffer != NULL; }
+
+		//! Reserve disk space for the file to grow to a given size, so that it can be written without fragmenting
+		/*! \param Size	The expected final size of the file in bytes
+		 *  The length of the file is not changed, so readers of a growing file only see what has been written.
+		 *  Any space still unused when the file is closed is released.
+		 *  \return true if the space was reserved, false if this is not supported for this file or filesystem
+		 */
+		bool Preallocate(Length Size);
+
+		//! Discard everything in the file after the current position
+		/*! This is used when re-writing the end of a file, such as when resuming from a checkpoint, so that nothing of the
+		 *  old contents is left after the new end of the file.
+		 *  \return false if the file could not be truncated, which is always the case for memory files, streams and backends
+		 */
+		bool Truncate(void);
+
+		//! Set the number of threads used to serialize header metadata
+		/*! When more than one, the sets of the header metadata in each partition written are serialized into separate
+		 *  buffers by this many tasks on the shared TaskExecutor, and the buffers then appended in order. The local tags are added to the
+		 *  primer in the same order as when serializing on one thread, so the bytes written are the same.
+		 *  \note Only worthwhile for large header metadata, such as with many descriptive metadata or timed text sets,
+		 *        as small headers are always serialized on the calling thread
+		 */
+		void SetMetadataThreads(unsigned int Threads) { MetadataThreads = Threads; }
+
+		//! Get the number of threads used to serialize header metadata
+		unsigned int GetMetadataThreads(void) const { return MetadataThreads; }
+
+		//! Set the overlay that the classes and types of the file's metadictionary are added to once the dictionary is frozen
+		/*! If none is set, one is made for the file when its metadictionary is first loaded. The overlay is active
+		 *  while header metadata is read from this file.
+		 */
+		void SetTypeOverlay(TypeOverlayPtr Value) { Overlay = Value; }
+
+		//! Get the overlay used while reading header metadata from this file, or NULL if none
+		TypeOverlayPtr GetTypeOverlay(void) const { return Overlay; }
+
+		//! Enable or disable reuse of the serialized bytes of unchanged header metadata sets
+		/*! When enabled, the bytes of each local set in the header metadata are kept with the set when it is written,
+		 *  and later partitions (such as repeated headers in body partitions, or the footer) reuse them for any set that
+		 *  has not since been changed. Changing a property of a set discards its bytes.
+		 *  DRAGONS: A cached set is only re-encoded if it, or one of its properties, is changed through the MDObject
+		 *           interface (such as SetValue(), ReadValue() or AddChild()), so values must not be altered directly
+		 */
+		void SetMetadataCache(bool Enable = true) { MetadataCache = Enable; }
+
+		//! Start collecting written data in memory so that it can be written to the file in one go
+		/*! This allows a sequence of small writes, such as the keys, lengths, values and filler of a content package,
+		 *  to be issued as a single write. The gathered data is written by EndGather(), if it reaches Limit bytes,
+		 *  or before any other access to the file (such as a Seek() to a different position or a Read()).
+		 *  Writes of 256KiB or more are not gathered, but follow the gathered data directly so that large values are not copied.
+		 *  \note This has no effect on memory files
+		 */
+		void StartGather(size_t Limit = 4 * 1024 * 1024);
+
+		//! Write any gathered data and return to writing directly
+		void EndGather(void);
+
+		//! Determine if written data is currently being gathered
+		bool IsGathering(void) const { return GatherBuffer ? true : false; }
+
 		bool ReadRunIn(void);
 
 		// RIP Readers
 		bool ReadRIP(void);
 		bool ScanRIP(Length MaxScan = 1024*1024);
-		bool BuildRIP(void);
+		bool BuildRIP(unsigned int Threads = 4);
 		bool GetRIP(Length MaxScan = 1024*1024);
 
 		
@@ -117,6 +297,11 @@ namespace mxflib
 		{ 
 			if(!isOpen) return 0;
 			if(isMemoryFile) return BufferCurrentPos-RunInSize;
+			if(GatherBuffer && GatherBuffer->Size) return GatherPos+GatherBuffer->Size-RunInSize;
+			if(AsyncPending) return AsyncPos-RunInSize;
+			if(DirectPending) return DirectStart+DirectFill-RunInSize;
+			if(isStream) return StreamPos;
+			if(ReadAheadSize) return ReadAheadPos-RunInSize;
 			return UInt64(mxflib::FileTell(Handle))-RunInSize;
 		}
 
@@ -132,12 +317,38 @@ namespace mxflib
 		int Seek(Position Pos)
 		{ 
 			if(!isOpen) return 0;
+
+			StatsAdd(StatsFileSeekCalls);
+
 			if(isMemoryFile)
 			{
 				BufferCurrentPos = Pos+RunInSize;
 				return 0;
 			}
 
+			// A stream can only "seek" to where it already is
+			if(isStream)
+			{
+				if(Pos == Tell()) return 0;
+
+				error("Unable to seek to 0x%s in output stream \"%s\"\n", Int64toHexString(Pos, 8).c_str(), Name.c_str());
+				return -1;
+			}
+
+			// Seeking to where we already are leaves any gathered or asynchronous writes pending
+			if(WritesPending())
+			{
+				if(Pos == Tell()) return 0;
+				SyncWrites();
+			}
+
+			// With read-ahead the handle is only moved when we next need to access the file
+			if(ReadAheadSize)
+			{
+				ReadAheadPos = Pos+RunInSize;
+				return 0;
+			}
+
 			return mxflib::FileSeek(Handle, Pos+RunInSize);
 		}
 
@@ -146,6 +357,13 @@ namespace mxflib
 			if(!isOpen) return 0;
 			if(isMemoryFile)
 			{
+				// Mapped files hold the whole file, so the end of the buffer is the end of the file
+				if(isMappedFile)
+				{
+					BufferCurrentPos = BufferOffset + Buffer->Size;
+					return 0;
+				}
+
 				error("MXFFile::SeekEnd() not supported on memory files\n");
 
 				// Seek to the end of the current buffer
@@ -153,6 +371,27 @@ namespace mxflib
 				return (int)Tell();
 			}
 
+			// We are always at the end of a stream
+			if(isStream) return 0;
+
+			if(WritesPending()) SyncWrites();
+
+			if(Backend)
+			{
+				Int64 End = Backend->GetSize();
+				if(End < 0) return -1;
+
+				ReadAheadPos = static_cast<UInt64>(End);
+				return 0;
+			}
+
+			if(ReadAheadSize)
+			{
+				int Ret = mxflib::FileSeekEnd(Handle);
+				ReadAheadPos = ReadAheadHandlePos = mxflib::FileTell(Handle);
+				return Ret;
+			}
+
 			return mxflib::FileSeekEnd(Handle);
 		}
 
@@ -163,11 +402,23 @@ namespace mxflib
 			if(!isOpen) return true;
 			if(isMemoryFile)
 			{
+				if(isMappedFile) return (BufferCurrentPos - BufferOffset) >= Buffer->Size;
+
 				error("MXFFile::Eof() not supported on memory files\n");
 
 				// Return true if at the end of the current buffer
 				if((BufferCurrentPos - BufferOffset) <= Buffer->Size) return true; else return false;
 			}
+
+			if(isStream) return true;
+
+			if(WritesPending()) SyncWrites();
+
+			if(ReadAheadSize)
+			{
+				if(InReadAhead()) return false;
+				return ReadAheadPos >= static_cast<UInt64>(Backend ? Backend->GetSize() : FileSize(Handle));
+			}
 		
 			return mxflib::FileEof(Handle) ? true : false; 
 		};
@@ -177,13 +428,47 @@ namespace mxflib
 		Length Size(void)
 		{
 			if(!isOpen) return -1;
+			if(isMappedFile) return static_cast<Length>(Buffer->Size);
 			if(isMemoryFile) return -1;
+			if(isStream) return Tell();
+			if(WritesPending()) SyncWrites();
+			if(Backend) return Backend->GetSize();
 			return FileSize(Handle);
 		}
 
+		//! Hint that a region of the file will be read soon
+		/*! The OS is asked to start reading the region in the background, this call does not wait for the data.
+		 *  \note This does nothing for memory files and mapped files, or on platforms without support for read hints
+		 */
+		void Prefetch(Position Start, Length Size)
+		{
+			if(!isOpen || isMemoryFile || (Start < 0) || (Size <= 0)) return;
+			if(Backend) Backend->Prefetch(static_cast<UInt64>(Start + RunInSize), static_cast<UInt64>(Size));
+			else mxflib::FilePrefetch(Handle, static_cast<UInt64>(Start + RunInSize), static_cast<UInt64>(Size));
+		}
+
 		DataChunkPtr Read(size_t Size);
 		size_t Read(UInt8 *Buffer, size_t Size);
 
+		//! Read data from the file into a DataChunk that references the file's own buffer if possible, rather than a copy
+		/*! For memory files and mapped files the returned chunk references the file buffer, for other files this is the same as Read(Size)
+		 *  \note The returned data must be treated as read-only
+		 *  DRAGONS: A view of a (non-mapped) memory file is only valid until that file is next written
+		 */
+		DataChunkPtr ReadView(size_t Size) 
+		{ 
+			if(isMemoryFile)
+			{
+				DataChunkPtr Ret = MemoryReadView(Size);
+				StatsAdd(StatsFileReadCalls);
+				StatsAdd(StatsFileReadBytes, Ret->Size);
+				return Ret;
+			}
+			if(WritesPending()) SyncWrites();
+			if(ReadAheadSize) return ReadAheadView(Size);
+			return Read(Size);
+		}
+
 //		MDObjectPtr ReadObject(void);
 //		template<class TP, class T> TP ReadObjectBase(void) { TP x; return x; };
 //		template<> MDObjectPtr ReadObjectBase<MDObjectPtr, MDObject>(void) { MDObjectPtr x; return x; };
@@ -193,6 +478,76 @@ namespace mxflib
 		//! Read a KLVObject from the file
 		KLVObjectPtr ReadKLV(void);
 
+		//! Read a KLVObject from the file, reading no more than its key and length
+		/*! The key and length are read with ReadKL(), and the value is left to be read from the file if required.
+		 *  \return NULL if no more valid KLVs
+		 */
+		KLVObjectPtr ReadKLVHeader(void);
+
+		//! Read the key and length of the KLV at the current position with a single small read
+		/*! \param Key Buffer to receive the 16-byte key
+		 *  \param ValueLength Set to the length of the value
+		 *  \return The size of the key and length, or 0 if no complete and valid KL could be read
+		 *  \note The file pointer is left at the start of the value
+		 */
+		Int32 ReadKL(UInt8 *Key, Length &ValueLength);
+
+		//! Read a few bytes from the file without loading a new read-ahead window
+		/*! The current read-ahead window is used if it holds all the bytes requested, otherwise they are read directly from
+		 *  the file. This prevents the values of large KLVs being read when only their keys and lengths are required.
+		 */
+		size_t ReadSmall(UInt8 *Buffer, size_t Size);
+
+		//! Read data from a given position in the file, without using or moving the file pointer
+		/*! Unlike a Seek() followed by a Read(), this may be called on several threads at once for the same MXFFile, and
+		 *  while another thread uses the file pointer, so long as nothing is written. The read-ahead window is not used.
+		 *  For mapped files the returned chunk references the mapping rather than holding a copy.
+		 *  \note Data written through this MXFFile is only seen once it has reached the file, such as after Flush()
+		 *  DRAGONS: Concurrent reads of a backend file are only safe if the backend is thread-safe, and on Windows
+		 *           positional reads of a normal file still move the handle's file pointer, so should not be mixed
+		 *           with reads using the file pointer on another thread
+		 */
+		DataChunkPtr ReadAt(Position Pos, size_t Size);
+
+		//! Read data from a given position in the file into a supplied buffer, without using or moving the file pointer
+		/*! \see ReadAt(Position, size_t) */
+		size_t ReadAt(Position Pos, UInt8 *Buffer, size_t Size);
+
+		//! Read the key and length of the KLV at a given position, without using or moving the file pointer
+		/*! \return The size of the key and length, or 0 if no complete and valid KL could be read
+		 *  \see ReadAt(Position, size_t)
+		 */
+		Int32 ReadKLAt(Position Pos, UInt8 *Key, Length &ValueLength);
+
+		//! Read a KLVObject from a given position in the file, reading no more than its key and length, without using or moving the file pointer
+		/*! The returned object has positional reads enabled, so its value is also read without using the file pointer.
+		 *  \return NULL if no valid KLV could be read
+		 */
+		KLVObjectPtr ReadKLVHeaderAt(Position Pos);
+
+		//! Read every partition pack, with its header metadata and index table segments, using concurrent reads
+		/*! The RIP is read (or built) if not already known, then the start of each partition is read with a positional
+		 *  read, several at once, followed by the rest of any partition whose metadata and index did not fit in the first
+		 *  read. Each PartitionInfo in the RIP is given its partition, with any header metadata already parsed, and its essence start, and the
+		 *  index table segments are parsed in parallel into one IndexTable per IndexSID, available from GetPreloadedIndex().
+		 *  This turns the many small dependent reads of opening a file into a couple of rounds of parallel reads, which
+		 *  matters most for network and object storage where each read has a high latency.
+		 *  \param Threads The number of reads or index parses to run at once, limited by the workers of the shared TaskExecutor and forced to 1 for a backend that is not thread-safe
+		 *  \return false if the file is not open for reading, or the RIP could not be found or built
+		 *  \note Header metadata is parsed on the calling thread, as the dictionary and primer are not thread-safe
+		 *  DRAGONS: The sets of the header metadata are parented to an in-memory copy of the partition rather than this file
+		 */
+		bool Preload(unsigned int Threads = 8);
+
+		//! Get the index table built by Preload() for a given IndexSID
+		/*! \return NULL if Preload() has not been called, or found no index table segments for this IndexSID */
+		IndexTablePtr GetPreloadedIndex(UInt32 IndexSID)
+		{
+			std::map<UInt32, IndexTablePtr>::iterator it = PreloadedIndex.find(IndexSID);
+			if(it == PreloadedIndex.end()) return NULL;
+			return (*it).second;
+		}
+
 		//! Write a partition pack to the file
 		void WritePartitionPack(PartitionPtr ThisPartition, PrimerPtr UsePrimer = NULL);
 
@@ -241,6 +596,19 @@ namespace mxflib
 			return WritePartitionInternal(true, ThisPartition, true, IndexData, UsePrimer, 0, 0);
 		}
 
+		//! Overwrite just the changed bytes of a partition pack and its header metadata, as read from this file
+		/*! This is much cheaper than ReWritePartition() when only fixed-size values, such as durations, have been changed.
+		 *  Each modified property is written over its old value, and the partition pack is written over the old pack if
+		 *  it differs, without serializing or writing anything else. This is only possible if no set or property has been
+		 *  added or removed, and every changed value is the same size as the value in the file.
+		 *  \return true if the changes were patched, false if they could not be, in which case nothing has been written
+		 *          and ReWritePartition() should be used instead, or if a write failed (with an error message), in which case
+		 *          some of the changed values may have been written, but not the partition pack
+		 *  \note Unlike ReWritePartition(), the partition pack is not updated from the metadata. The file position is unchanged
+		 *  \note Once patched, the partition pack and the patched sets are no longer flagged as modified
+		 */
+		bool PatchPartition(PartitionPtr ThisPartition);
+
 		//! Is this file truncated?
 		/*! If Details != NULL, the file will be re-tested and a details written into the string for truncated files
 		 */
@@ -250,6 +618,9 @@ namespace mxflib
 		//! Write or re-write a partition pack and associated metadata (and index table segments?)
 		bool WritePartitionInternal(bool ReWrite, PartitionPtr ThisPartition, bool IncludeMetadata, DataChunkPtr IndexData, PrimerPtr UsePrimer, UInt32 Padding, UInt32 MinPartitionSize);
 
+		//! Append a list of header metadata sets to a buffer, using worker threads and cached bytes if enabled
+		void WriteMetadataSets(DataChunkPtr &Buffer, MDObjectList &Sets, PrimerPtr &UsePrimer);
+
 	public:
 		//! Write the RIP
 		void WriteRIP(void);
@@ -276,32 +647,49 @@ namespace mxflib
 		//! Write raw data
 		size_t Write(const UInt8 *Buffer, size_t Size) 
 		{ 
-			if(isMemoryFile) return MemoryWrite(Buffer, Size);
+			StatsAdd(StatsFileWriteCalls);
+			StatsAdd(StatsFileWriteBytes, Size);
+			TraceScope Trace("MXFFile::Write", "io");
 
-			return FileWrite(Handle, Buffer, Size); 
+			return WriteInternal(Buffer, Size);
 		};
 
 		//! Write the contents of a DataChunk by reference
 		size_t Write(const DataChunk &Data) 
 		{ 
-			if(isMemoryFile) return MemoryWrite(Data.Data, Data.Size);
+			StatsAdd(StatsFileWriteCalls);
+			StatsAdd(StatsFileWriteBytes, Data.Size);
+			TraceScope Trace("MXFFile::Write", "io");
 
-			return FileWrite(Handle, Data.Data, Data.Size); 
+			return WriteInternal(Data.Data, Data.Size);
 		};
 
 		void Flush()
 		{
-			FileFlush(Handle);
+			if(WritesPending()) SyncWrites();
+			if(!Backend) FileFlush(Handle);
 		}
 
 		//! Write the contents of a DataChunk by SmartPtr
 		size_t Write(DataChunkPtr Data)
 		{ 
-			if(isMemoryFile) return MemoryWrite(Data->Data, Data->Size);
+			StatsAdd(StatsFileWriteCalls);
+			StatsAdd(StatsFileWriteBytes, Data->Size);
+			TraceScope Trace("MXFFile::Write", "io");
 
-			return static_cast<size_t>(FileWrite(Handle, Data->Data, Data->Size)); 
+			return WriteInternal(Data->Data, Data->Size);
 		};
 
+		//! Write a range of another open file
+		/*! When writing a local file without direct writes the OS is asked to copy the data, so it need not pass through
+		 *  user space, otherwise it is read into a buffer and written as normal
+		 *  \param Source	The file to copy from, whose file pointer may be moved
+		 *  \param Start	The position of the first byte to copy
+		 *  \param Size		The number of bytes to copy
+		 *  \return The number of bytes written, which is only less than Size at the end of the source or on error
+		 */
+		UInt64 WriteFromFile(FileHandle Source, UInt64 Start, UInt64 Size);
+
 		//! Write 8-bit unsigned integer
 		void WriteU8(UInt8 Val) { unsigned char Buffer[1]; PutU8(Val, Buffer); Write(Buffer, 1); }
 
@@ -417,6 +805,81 @@ namespace mxflib
 		//! Read from a memory file buffer
 		/*! \note This can be overridden in classes derived from MXFFile to give different memory read behaviour */
 		virtual size_t MemoryRead(UInt8 *Data, size_t Size);
+
+		//! Read from a memory file buffer, returning a DataChunk that references the buffer rather than a copy
+		DataChunkPtr MemoryReadView(size_t Size);
+
+		//! Is the file pointer within the current read-ahead window?
+		bool InReadAhead(void) const
+		{
+			return ReadAheadBuffer && (ReadAheadPos >= ReadAheadStart) && (ReadAheadPos < (ReadAheadStart + ReadAheadBuffer->Size));
+		}
+
+		//! Load a new read-ahead window covering the current file pointer
+		/*! \return The number of bytes available from the current position, or -1 on error */
+		size_t ReadAheadFill(void);
+
+		//! Read from a physical file via the read-ahead window
+		/*! \return The number of bytes read, or -1 on error */
+		size_t ReadAheadRead(UInt8 *Data, size_t Size);
+
+		//! Read from a physical file via the read-ahead window, returning a DataChunk that references the window rather than a copy if possible
+		DataChunkPtr ReadAheadView(size_t Size);
+
+		//! Write to a physical file when read-ahead is enabled
+		size_t ReadAheadWrite(UInt8 const *Data, size_t Size);
+
+		//! Read from a given position of a physical file, through the backend if there is one
+		/*! \return The number of bytes read, or -1 on error
+		 *  \note This moves the file handle, so ReadAheadHandlePos must be updated by the caller
+		 */
+		size_t PhysicalRead(UInt64 Pos, UInt8 *Data, size_t Size)
+		{
+			if(Backend) return Backend->ReadAt(Pos, Data, Size);
+
+			mxflib::FileSeek(Handle, Pos);
+			return mxflib::FileRead(Handle, Data, Size);
+		}
+
+		//! Write raw data via whichever write mode is active, without counting the call in the library statistics
+		size_t WriteInternal(const UInt8 *Buffer, size_t Size)
+		{
+			if(isMemoryFile) return MemoryWrite(Buffer, Size);
+			if(GatherBuffer) return GatherWrite(Buffer, Size);
+			if(DirectBuffer) return DirectWrite(Buffer, Size);
+			if(AsyncWriter) return AsyncWrite(Buffer, Size);
+			if(isStream) return StreamWrite(Buffer, Size);
+			if(ReadAheadSize) return ReadAheadWrite(Buffer, Size);
+
+			return FileWrite(Handle, Buffer, Size);
+		}
+
+		//! Write to a non-seekable output stream
+		size_t StreamWrite(UInt8 const *Data, size_t Size);
+
+		//! Pass data to the background writer when asynchronous writing is enabled
+		size_t AsyncWrite(UInt8 const *Data, size_t Size);
+
+		//! Wait for all asynchronous writes to complete, leaving the file handle at the end of the written data
+		void AsyncSync(void);
+
+		//! Add data to the direct write staging buffer, writing the buffer each time it is full
+		size_t DirectWrite(UInt8 const *Data, size_t Size);
+
+		//! Write all data in the direct write staging buffer, leaving the file handle at the end of the written data
+		void DirectSync(void);
+
+		//! Add data to the gather buffer, writing the buffer if it reaches the limit
+		size_t GatherWrite(UInt8 const *Data, size_t Size);
+
+		//! Write the contents of the gather buffer to the file
+		void GatherFlush(void);
+
+		//! Are there gathered or asynchronous writes that have not yet reached the file?
+		bool WritesPending(void) const { return AsyncPending || DirectPending || (GatherBuffer && GatherBuffer->Size); }
+
+		//! Complete all gathered, asynchronous and direct writes
+		void SyncWrites(void);
 	};
 }
 
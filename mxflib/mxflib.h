@@ -44,6 +44,7 @@ namespace mxflib {}
 // Required std::headers
 
 #include <list>
+#include <vector>
 #include <map>
 #include <cstring>
 
@@ -87,9 +88,18 @@ namespace mxflib
 
 #include "mxflib/smartptr.h"
 
+#include "mxflib/thread.h"
+
+#include "mxflib/executor.h"
+
+#include "mxflib/stats.h"
+
+#include "mxflib/trace.h"
+
 #include "mxflib/endian.h"
 
 #include "mxflib/types.h"
+#include "mxflib/ulhash.h"
 
 #include "mxflib/datachunk.h"
 
@@ -97,12 +107,16 @@ namespace mxflib
 
 #include "mxflib/helper.h"
 
+#include "mxflib/internedname.h"
+
 #include "mxflib/ulmap.h"
 
 #include "mxflib/mdtraits.h"
 #include "mxflib/deftypes.h"
 #include "mxflib/rxiparser.h"
 #include "mxflib/legacytypes.h"
+#include "mxflib/dictcache.h"
+#include "mxflib/dictindex.h"
 
 #include "mxflib/primer.h"
 
@@ -110,20 +124,53 @@ namespace mxflib
 #include "mxflib/mdtype.h"
 #include "mxflib/mdobject.h"
 
+#include "mxflib/typeoverlay.h"
+
 #include "mxflib/metadata.h"
 
 #include "mxflib/rip.h"
 
+#include "mxflib/filebackend.h"
 #include "mxflib/mxffile.h"
 
+#include "mxflib/growing.h"
+
 #include "mxflib/index.h"
 
+#include "mxflib/indexcache.h"
+
+#include "mxflib/indexscan.h"
+
+#include "mxflib/timeline.h"
+
+#include "mxflib/essenceaccess.h"
+
+#include "mxflib/packagecache.h"
+
+#include "mxflib/asyncread.h"
+
 #include "mxflib/essence.h"
 
+#include "mxflib/synthetic.h"
+
+#include "mxflib/parallelread.h"
+
+#include "mxflib/streamdispatch.h"
+
+#include "mxflib/prefetch.h"
+
+#include "mxflib/layoutplan.h"
+
+#include "mxflib/qcscan.h"
+
+#include "mxflib/rewrap.h"
+
 #include "mxflib/klvobject.h"
 
 #include "mxflib/crypto.h"
 
+#include "mxflib/digest.h"
+
 #include "mxflib/vbi.h"
 
 #include "mxflib/audiomux.h"
@@ -0,0 +1,237 @@
+/*! \file	packagecache.cpp
+ *	\brief	Implementation of a byte-limited cache of content packages read by an EssenceAccessor
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+//! Build a cache in front of a given accessor
+ContentPackageCache::ContentPackageCache(EssenceAccessorPtr &Accessor, size_t Budget, unsigned int Depth /*=8*/)
+	: Accessor(Accessor), Budget(Budget), CachedBytes(0), Hits(0), Misses(0), ReadAhead(0),
+	  Depth(Depth), HaveLast(false), Direction(1), Remaining(0), Started(false), Stopping(false)
+{
+}
+
+
+//! Get the content package of a given edit unit, from the cache if held or else from the file
+/*! \param BodySID The essence container, or 0 for the first
+ *  \param EditUnit The edit unit, in stored order
+ *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+ *  \return The bytes of all the KLVs of the content package, or NULL if it could not be read
+ */
+DataChunkPtr ContentPackageCache::Read(UInt32 BodySID, Position EditUnit, EssenceAccessor::FrameInfo *Info /*=NULL*/)
+{
+	CacheKey Key;
+	Key.BodySID = BodySID;
+	Key.EditUnit = EditUnit;
+
+	{
+		MutexLock Locked(Lock);
+
+		NoteRequest(Key);
+
+		EntryMap::iterator it = Entries.find(Key);
+		if(it != Entries.end())
+		{
+			Hits++;
+			StatsAdd(StatsPackageCacheHits);
+
+			// Move to the front of the use order
+			UseOrder.splice(UseOrder.begin(), UseOrder, (*it).second.Use);
+
+			if(Info) *Info = (*it).second.Info;
+			return (*it).second.Data;
+		}
+
+		Misses++;
+		StatsAdd(StatsPackageCacheMisses);
+	}
+
+	// DRAGONS: The read is made without the lock so that other callers, and the worker, are not held up by it
+	DataChunkPtr Data = new DataChunk;
+	EssenceAccessor::FrameInfo ThisInfo;
+	if(!Accessor->ReadContentPackage(BodySID, EditUnit, *Data, &ThisInfo)) return NULL;
+
+	MutexLock Locked(Lock);
+	Insert(Key, Data, ThisInfo);
+
+	if(Info) *Info = ThisInfo;
+	return Data;
+}
+
+
+//! Change the maximum number of bytes to hold, dropping the least recently used content packages as required
+void ContentPackageCache::SetBudget(size_t NewBudget)
+{
+	MutexLock Locked(Lock);
+
+	Budget = NewBudget;
+	Trim();
+}
+
+
+//! Drop all cached content packages
+void ContentPackageCache::Clear(void)
+{
+	MutexLock Locked(Lock);
+
+	Entries.clear();
+	UseOrder.clear();
+	CachedBytes = 0;
+}
+
+
+//! Stop the worker thread, after which no more reading ahead is done
+void ContentPackageCache::Stop(void)
+{
+	Lock.Lock();
+	Stopping = true;
+	Started = true;
+	Changed.Broadcast();
+	Lock.Unlock();
+
+	Join();
+}
+
+
+//! Add a content package to the cache as the most recently used, dropping others to stay within the budget
+/*! \note Called with the lock held */
+void ContentPackageCache::Insert(const CacheKey &Key, DataChunkPtr &Data, const EssenceAccessor::FrameInfo &Info)
+{
+	// A content package bigger than the whole budget is never held
+	if(Data->Size > Budget) return;
+
+	// Another thread may have read the same content package while we were reading it
+	EntryMap::iterator it = Entries.find(Key);
+	if(it != Entries.end())
+	{
+		UseOrder.splice(UseOrder.begin(), UseOrder, (*it).second.Use);
+		return;
+	}
+
+	UseOrder.push_front(Key);
+
+	CacheEntry &Entry = Entries[Key];
+	Entry.Data = Data;
+	Entry.Info = Info;
+	Entry.Use = UseOrder.begin();
+
+	CachedBytes += Data->Size;
+	Trim();
+}
+
+
+//! Drop least recently used content packages until no more than the budget is held
+/*! \note Called with the lock held */
+void ContentPackageCache::Trim(void)
+{
+	while((CachedBytes > Budget) && !UseOrder.empty())
+	{
+		EntryMap::iterator it = Entries.find(UseOrder.back());
+		CachedBytes -= (*it).second.Data->Size;
+
+		Entries.erase(it);
+		UseOrder.pop_back();
+	}
+}
+
+
+//! Record a request, and start reading ahead if it continues in the direction of the previous one
+/*! \note Called with the lock held */
+void ContentPackageCache::NoteRequest(const CacheKey &Key)
+{
+	Position Step = Key.EditUnit - LastKey.EditUnit;
+	bool Scrubbing = HaveLast && (Key.BodySID == LastKey.BodySID) && (Step != 0) && (Step <= Depth) && (Step >= -static_cast<Position>(Depth));
+
+	HaveLast = true;
+	LastKey = Key;
+
+	if(!Scrubbing)
+	{
+		Remaining = 0;
+		return;
+	}
+
+	Direction = (Step > 0) ? 1 : -1;
+	NextKey.BodySID = Key.BodySID;
+	NextKey.EditUnit = Key.EditUnit + Direction;
+	Remaining = Depth;
+
+	if(!Started)
+	{
+		Started = true;
+
+		// If the worker can't be started there is simply no reading ahead
+		if(!Start()) Depth = 0;
+	}
+
+	Changed.Broadcast();
+}
+
+
+//! Read ahead in the direction of the most recent requests until we are stopped
+void ContentPackageCache::Run(void)
+{
+	MutexLock Locked(Lock);
+
+	for(;;)
+	{
+		while(!Stopping && !Remaining) Changed.Wait(Lock);
+
+		if(Stopping) return;
+
+		CacheKey Key = NextKey;
+		NextKey.EditUnit += Direction;
+		Remaining--;
+
+		Length Duration = Accessor->GetContainerDuration(Key.BodySID);
+		if((Key.EditUnit < 0) || ((Duration >= 0) && (Key.EditUnit >= Duration)))
+		{
+			Remaining = 0;
+			continue;
+		}
+
+		if(Entries.find(Key) != Entries.end()) continue;
+
+		Lock.Unlock();
+
+		DataChunkPtr Data = new DataChunk;
+		EssenceAccessor::FrameInfo Info;
+		bool Ok = Accessor->ReadContentPackage(Key.BodySID, Key.EditUnit, *Data, &Info);
+
+		Lock.Lock();
+
+		if(Ok)
+		{
+			ReadAhead++;
+			Insert(Key, Data, Info);
+		}
+	}
+}
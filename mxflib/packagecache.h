@@ -0,0 +1,166 @@
+/*! \file	packagecache.h
+ *	\brief	Definition of a byte-limited cache of content packages read by an EssenceAccessor
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Editors scrubbing through a file ask for the same few content packages again and again. A ContentPackageCache
+ *  keeps the most recently used content packages, up to a given number of bytes, and reads ahead in the direction
+ *  that the caller is moving so that the next request is usually already held.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__PACKAGECACHE_H
+#define MXFLIB__PACKAGECACHE_H
+
+namespace mxflib
+{
+	//! A least-recently-used cache of the content packages of a file, keyed on BodySID and edit unit
+	/*! Content packages are read with EssenceAccessor::ReadContentPackage(), and the least recently used are dropped
+	 *  once the bytes held exceed the budget. When two requests in a row are for nearby edit units of the same
+	 *  container, a worker thread reads ahead of the second in the same direction.
+	 *  Read() may be called on any number of threads at once.
+	 *  \note The chunks returned are shared with the cache, so must not be modified by the caller
+	 */
+	class ContentPackageCache : public RefCount<ContentPackageCache>, protected Thread
+	{
+	protected:
+		//! The key of a cached content package
+		struct CacheKey
+		{
+			UInt32 BodySID;						//!< The essence container, as requested
+			Position EditUnit;					//!< The edit unit, in stored order
+
+			bool operator<(const CacheKey &Other) const
+			{
+				if(BodySID != Other.BodySID) return BodySID < Other.BodySID;
+				return EditUnit < Other.EditUnit;
+			}
+		};
+
+		//! List of cache keys, most recently used first
+		typedef std::list<CacheKey> KeyList;
+
+		//! A cached content package
+		struct CacheEntry
+		{
+			DataChunkPtr Data;					//!< The bytes of the content package
+			EssenceAccessor::FrameInfo Info;	//!< The details of the content package
+			KeyList::iterator Use;				//!< The position of this entry in UseOrder
+		};
+
+		//! Map of cached content packages
+		typedef std::map<CacheKey, CacheEntry> EntryMap;
+
+		EssenceAccessorPtr Accessor;			//!< The accessor that reads content packages from the file
+		Mutex Lock;								//!< Lock protecting everything below
+		Condition Changed;						//!< Signalled when there is read-ahead to do or we are stopping
+
+		size_t Budget;							//!< The maximum number of bytes to hold
+		size_t CachedBytes;						//!< The number of bytes currently held
+		EntryMap Entries;						//!< The cached content packages
+		KeyList UseOrder;						//!< The keys of all entries, most recently used first
+
+		UInt64 Hits;							//!< Number of requests found in the cache
+		UInt64 Misses;							//!< Number of requests read from the file
+		UInt64 ReadAhead;						//!< Number of content packages read ahead by the worker
+
+		unsigned int Depth;						//!< Number of edit units to read ahead, or zero for none
+		bool HaveLast;							//!< True once LastKey holds a request
+		CacheKey LastKey;						//!< The most recent request
+		CacheKey NextKey;						//!< The next content package to read ahead
+		int Direction;							//!< The step between edit units read ahead, +1 or -1
+		unsigned int Remaining;					//!< Number of content packages still to read ahead
+		bool Started;							//!< True once we have attempted to start the worker thread
+		bool Stopping;							//!< Set to request the worker thread to stop
+
+	public:
+		//! Build a cache in front of a given accessor
+		/*! \param Accessor The accessor to read content packages with, which must already be open
+		 *  \param Budget The maximum number of bytes of content packages to hold
+		 *  \param Depth The number of edit units to read ahead when scrubbing, or zero to never read ahead
+		 */
+		ContentPackageCache(EssenceAccessorPtr &Accessor, size_t Budget, unsigned int Depth = 8);
+
+		//! Stop the worker thread before destruction
+		~ContentPackageCache() { Stop(); }
+
+		//! Get the content package of a given edit unit, from the cache if held or else from the file
+		/*! \param BodySID The essence container, or 0 for the first
+		 *  \param EditUnit The edit unit, in stored order
+		 *  \param Info If not NULL, this is filled with the timing and flags of the edit unit
+		 *  \return The bytes of all the KLVs of the content package, or NULL if it could not be read
+		 */
+		DataChunkPtr Read(UInt32 BodySID, Position EditUnit, EssenceAccessor::FrameInfo *Info = NULL);
+
+		//! Change the maximum number of bytes to hold, dropping the least recently used content packages as required
+		void SetBudget(size_t NewBudget);
+
+		//! Drop all cached content packages
+		void Clear(void);
+
+		//! Stop the worker thread, after which no more reading ahead is done
+		void Stop(void);
+
+		//! Get the number of requests found in the cache
+		UInt64 GetHits(void) { MutexLock Locked(Lock); return Hits; }
+
+		//! Get the number of requests read from the file
+		UInt64 GetMisses(void) { MutexLock Locked(Lock); return Misses; }
+
+		//! Get the number of content packages read ahead by the worker thread
+		UInt64 GetReadAhead(void) { MutexLock Locked(Lock); return ReadAhead; }
+
+		//! Get the number of bytes currently held
+		size_t GetCachedBytes(void) { MutexLock Locked(Lock); return CachedBytes; }
+
+		//! Get the number of content packages currently held
+		size_t GetCount(void) { MutexLock Locked(Lock); return Entries.size(); }
+
+	protected:
+		//! Add a content package to the cache as the most recently used, dropping others to stay within the budget
+		/*! \note Called with the lock held */
+		void Insert(const CacheKey &Key, DataChunkPtr &Data, const EssenceAccessor::FrameInfo &Info);
+
+		//! Drop least recently used content packages until no more than the budget is held
+		/*! \note Called with the lock held */
+		void Trim(void);
+
+		//! Record a request, and start reading ahead if it continues in the direction of the previous one
+		/*! \note Called with the lock held */
+		void NoteRequest(const CacheKey &Key);
+
+		//! Read ahead in the direction of the most recent requests until we are stopped
+		virtual void Run(void);
+
+	private:
+		//! Prevent copy construction
+		ContentPackageCache(const ContentPackageCache &);
+	};
+
+	//! A smart pointer to a ContentPackageCache object
+	typedef SmartPtr<ContentPackageCache> ContentPackageCachePtr;
+}
+
+#endif // MXFLIB__PACKAGECACHE_H
@@ -0,0 +1,327 @@
+/*! \file	parallelread.cpp
+ *	\brief	Implementation of a class that reads the body partitions of an MXF file on several threads
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace mxflib
+{
+	//! A task, run by the shared executor, that reads partitions for a ParallelBodyReader
+	class ParallelReadWorker : public Task
+	{
+	protected:
+		ParallelBodyReader *Owner;					//!< The reader we work for
+		MXFFilePtr WorkerFile;						//!< Our own handle on the file
+
+	public:
+		ParallelReadWorker(ParallelBodyReader *Owner, MXFFilePtr WorkerFile) : Owner(Owner), WorkerFile(WorkerFile) {}
+
+		void Run(void)
+		{
+			Owner->WorkerLoop(WorkerFile);
+			WorkerFile->Close();
+		}
+	};
+
+
+	//! A read handler that loads each KLV read by a worker and queues it for dispatch
+	class ParallelQueueHandler : public GCReadHandler_Base
+	{
+	protected:
+		ParallelBodyReader *Owner;					//!< The reader we work for
+
+	public:
+		size_t Range;								//!< The partition being read
+		bool Stopped;								//!< Set true if the owner has asked the workers to stop
+
+	public:
+		ParallelQueueHandler(ParallelBodyReader *Owner) : Owner(Owner), Range(0), Stopped(false) {}
+
+		bool HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
+		{
+			// Read the value while we still have the worker's file
+			Length ValueLength = Object->GetLength();
+			if((ValueLength > 0) && (static_cast<Length>(Object->ReadData()) < ValueLength))
+			{
+				error("Unable to read value of KLV at %s\n", Object->GetSourceLocation().c_str());
+				return false;
+			}
+
+			// Hand the object over to the original file, so handlers never use another thread's file
+			Position Location = Object->GetLocation();
+			Object->SetSource(Owner->File, Location);
+			Object->SetDestination(Owner->File, Location);
+
+			if(!Owner->QueueItem(Range, Object, Caller->GetFileOffset(), Caller->GetStreamOffset()))
+			{
+				Stopped = true;
+				return false;
+			}
+
+			return true;
+		}
+	};
+}
+
+
+//! Construct a reader for a given stream in a file
+ParallelBodyReader::ParallelBodyReader(MXFFilePtr File, UInt32 BodySID)
+	: File(File), BodySID(BodySID), ThreadCount(4), MaxQueued(16 * 1024 * 1024), NextRange(0), Stopping(false), Failed(false)
+{
+	Reader = new GCReader(File);
+}
+
+
+//! Read the whole stream, dispatching every KLV to the handlers in stream order
+bool ParallelBodyReader::Read(void)
+{
+	if(!FindRanges()) return false;
+
+	NextRange = 0;
+	Stopping = false;
+	Failed = false;
+
+	// Each worker needs its own handle on the file, or its own MXFFile sharing a thread-safe backend
+	// DRAGONS: A read started by a task of the shared executor is done on that task, as its workers are already in use
+	//          and the dispatch loop below cannot help with queued tasks while it waits
+	TaskExecutor &Executor = GetTaskExecutor();
+	TaskGroup Workers;
+	size_t WorkerCount = 0;
+	FileBackendPtr Backend = File->GetBackend();
+	if((!Executor.IsWorkerThread()) && Executor.Start() && (Backend ? Backend->IsThreadSafe() : ((!File->Name.empty()) && ((!File->IsMemoryFile()) || File->IsMappedFile()))))
+	{
+		size_t Threads = ThreadCount;
+		if(Threads > Executor.GetWorkers()) Threads = Executor.GetWorkers();
+		if(Threads > Ranges.size()) Threads = Ranges.size();
+
+		while(Threads--)
+		{
+			MXFFilePtr WorkerFile = new MXFFile;
+			bool Opened;
+			if(Backend) Opened = WorkerFile->OpenBackend(Backend);
+			else Opened = File->IsMappedFile() ? WorkerFile->OpenMapped(File->Name) : WorkerFile->Open(File->Name, true);
+			if(!Opened) break;
+
+			WorkerFile->SetReadAhead(File->GetReadAhead());
+
+			Workers.Submit(new ParallelReadWorker(this, WorkerFile), &Executor);
+			WorkerCount++;
+		}
+	}
+
+	if(WorkerCount == 0)
+	{
+		bool Ret = ReadSerial();
+		Ranges.clear();
+		return Ret;
+	}
+
+	// Dispatch each partition's KLVs in turn, as the workers queue them
+	bool Ret = true;
+	size_t Range;
+	for(Range = 0; Ret && (Range < Ranges.size()); Range++)
+	{
+		for(;;)
+		{
+			PartitionRange::Item ThisItem;
+			{
+				MutexLock Locked(Lock);
+
+				PartitionRange &ThisRange = Ranges[Range];
+				while(ThisRange.Queue.empty() && (!ThisRange.Done) && (!Failed)) Changed.Wait(Lock);
+
+				if(Failed)
+				{
+					Ret = false;
+					break;
+				}
+
+				if(ThisRange.Queue.empty()) break;
+
+				ThisItem = ThisRange.Queue.front();
+				ThisRange.Queue.pop_front();
+				ThisRange.QueuedBytes -= static_cast<size_t>(ThisItem.Object->GetLength());
+
+				Changed.Broadcast();
+			}
+
+			Reader->SetFileOffset(ThisItem.FileOffset);
+			Reader->SetStreamOffset(ThisItem.StreamOffset);
+			if(!Reader->HandleData(ThisItem.Object))
+			{
+				Ret = false;
+				break;
+			}
+		}
+	}
+
+	// Stop the workers, which will only still be running if we are stopping early
+	{
+		MutexLock Locked(Lock);
+		Stopping = true;
+		Changed.Broadcast();
+	}
+
+	Workers.Wait();
+
+	Ranges.clear();
+
+	return Ret;
+}
+
+
+//! Find the partitions holding essence for this stream
+bool ParallelBodyReader::FindRanges(void)
+{
+	Ranges.clear();
+
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	RIP::iterator it = File->FileRIP.begin();
+	while(it != File->FileRIP.end())
+	{
+		PartitionInfoPtr Info = (*it).second;
+		it++;
+
+		// Don't read partition packs that we already know are for other streams
+		if(Info->SIDsKnown() && (Info->GetBodySID() != BodySID)) continue;
+
+		File->Seek(Info->GetByteOffset());
+		PartitionPtr ThisPartition = File->ReadPartition();
+		if(!ThisPartition)
+		{
+			error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(Info->GetByteOffset(), 8).c_str(), File->Name.c_str());
+			return false;
+		}
+
+		if(ThisPartition->GetUInt(BodySID_UL) != BodySID) continue;
+
+		if(!ThisPartition->SeekEssence()) continue;
+
+		PartitionRange ThisRange;
+		ThisRange.EssenceStart = File->Tell();
+		ThisRange.StreamOffset = ThisPartition->GetInt64(BodyOffset_UL);
+		ThisRange.QueuedBytes = 0;
+		ThisRange.Done = false;
+
+		Ranges.push_back(ThisRange);
+	}
+
+	if(Ranges.empty())
+	{
+		error("No partitions found for BodySID 0x%04x in file \"%s\"\n", BodySID, File->Name.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Read each partition on the calling thread, used when the file cannot be opened by the workers
+bool ParallelBodyReader::ReadSerial(void)
+{
+	std::vector<PartitionRange>::iterator it = Ranges.begin();
+	while(it != Ranges.end())
+	{
+		// DRAGONS: Reading stops with false at the end of the file, which is not an error for the last partition
+		if((!Reader->ReadFromFile((*it).EssenceStart, (*it).StreamOffset)) && (!File->Eof())) return false;
+		it++;
+	}
+
+	return true;
+}
+
+
+//! Read partitions until there are none left, called by each worker task
+void ParallelBodyReader::WorkerLoop(MXFFilePtr WorkerFile)
+{
+	ParallelQueueHandler *Handler = new ParallelQueueHandler(this);
+	GCReadHandlerPtr HandlerPtr = Handler;
+
+	GCReaderPtr WorkerReader = new GCReader(WorkerFile, HandlerPtr, HandlerPtr);
+
+	for(;;)
+	{
+		size_t Range;
+		Position EssenceStart;
+		Position StreamOffset;
+		{
+			MutexLock Locked(Lock);
+			if(Stopping || (NextRange >= Ranges.size())) return;
+
+			Range = NextRange++;
+			EssenceStart = Ranges[Range].EssenceStart;
+			StreamOffset = Ranges[Range].StreamOffset;
+		}
+
+		Handler->Range = Range;
+		bool Ret = WorkerReader->ReadFromFile(EssenceStart, StreamOffset);
+
+		MutexLock Locked(Lock);
+		Ranges[Range].Done = true;
+
+		// DRAGONS: As for ReadSerial(), reaching the end of the file is not an error
+		if((!Ret) && (!Handler->Stopped) && (!WorkerFile->Eof()))
+		{
+			Failed = true;
+			Stopping = true;
+		}
+
+		Changed.Broadcast();
+	}
+}
+
+
+//! Queue a KLV read by a worker, waiting if the queue for its partition is full
+bool ParallelBodyReader::QueueItem(size_t Range, KLVObjectPtr Object, Position FileOffset, Position StreamOffset)
+{
+	size_t Size = static_cast<size_t>(Object->GetLength());
+
+	MutexLock Locked(Lock);
+
+	// DRAGONS: An empty queue always accepts an item, so the partition being dispatched can never stall
+	PartitionRange &ThisRange = Ranges[Range];
+	while((!Stopping) && (!ThisRange.Queue.empty()) && ((ThisRange.QueuedBytes + Size) > MaxQueued)) Changed.Wait(Lock);
+
+	if(Stopping) return false;
+
+	PartitionRange::Item ThisItem;
+	ThisItem.Object = Object;
+	ThisItem.FileOffset = FileOffset;
+	ThisItem.StreamOffset = StreamOffset;
+
+	ThisRange.Queue.push_back(ThisItem);
+	ThisRange.QueuedBytes += Size;
+
+	Changed.Broadcast();
+
+	return true;
+}
@@ -0,0 +1,154 @@
+/*! \file	parallelread.h
+ *	\brief	Definition of a class that reads the body partitions of an MXF file on several threads
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Files with regular body partitions and a complete RIP can be read much faster on multi-core systems and
+ *  striped storage by reading different partitions at the same time. A ParallelBodyReader divides the essence
+ *  of one stream into its partitions, reads each on a task of the shared TaskExecutor with its own file handle and GCReader,
+ *  and dispatches the KLVs to the handlers on the calling thread in stream order.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__PARALLELREAD_H
+#define MXFLIB__PARALLELREAD_H
+
+namespace mxflib
+{
+	// Forward declare the worker task and read handler classes, which are private to the implementation
+	class ParallelReadWorker;
+	class ParallelQueueHandler;
+
+	//! Reads the essence of one stream from a multi-partition file on several threads
+	/*! The RIP is used to find every partition holding essence for the stream. Worker tasks take these partitions
+	 *  in order, each reading the contiguous byte range of one partition with its own MXFFile, and the value of each
+	 *  KLV is read before it is queued. Read() then passes the KLVs to the handlers in stream order on the calling
+	 *  thread, with the offsets of its GCReader set as they would be for a single-threaded read.
+	 *  \note If the file cannot be opened a second time (such as a memory file, or a backend file whose backend is not thread-safe) it is read on the calling thread
+	 *  \note If Read() is called by a task of the shared TaskExecutor the stream is read on the calling thread, so nested reads don't wait for workers that are in use
+	 *  \note The KLVObjects passed to handlers have the original file as their source
+	 */
+	class ParallelBodyReader : public RefCount<ParallelBodyReader>
+	{
+	protected:
+		//! Details of a partition holding essence for the stream, and the KLVs read from it but not yet dispatched
+		struct PartitionRange
+		{
+			Position EssenceStart;				//!< File offset of the first essence KLV in the partition
+			Position StreamOffset;				//!< Stream offset of the first essence KLV in the partition
+
+			//! A KLV read by a worker
+			struct Item
+			{
+				KLVObjectPtr Object;			//!< The KLV, with its value loaded
+				Position FileOffset;			//!< File offset of the start of the KLV
+				Position StreamOffset;			//!< Stream offset of the start of the KLV
+			};
+
+			std::list<Item> Queue;				//!< KLVs read but not yet dispatched
+			size_t QueuedBytes;					//!< Total size of the values in the queue
+			bool Done;							//!< True once the worker has read the whole partition
+		};
+
+		MXFFilePtr File;						//!< The file being read
+		UInt32 BodySID;							//!< The stream being read
+		unsigned int ThreadCount;				//!< Number of worker tasks to run at once
+		size_t MaxQueued;						//!< Number of bytes that may be queued for each partition before its worker waits
+
+		GCReaderPtr Reader;						//!< The GCReader used to dispatch KLVs to handlers
+
+		Mutex Lock;								//!< Lock protecting all of the following
+		Condition Changed;						//!< Signalled when a queue or any other state changes
+		std::vector<PartitionRange> Ranges;		//!< The partitions to read, in stream order
+		size_t NextRange;						//!< The next partition to give to a worker
+		bool Stopping;							//!< True if the workers should stop, such as after an error
+		bool Failed;							//!< True if a worker has failed to read a partition
+
+	public:
+		//! Construct a reader for a given stream in a file
+		ParallelBodyReader(MXFFilePtr File, UInt32 BodySID);
+
+		//! Set the number of partitions read at once
+		/*! Each is read by a task of the shared TaskExecutor, so no more are read at once than it has workers */
+		void SetThreads(unsigned int Threads) { ThreadCount = Threads; }
+
+		//! Set the number of bytes of essence that may be read ahead of dispatch for each partition
+		/*! A worker that gets this far ahead waits for the handlers to catch up before reading more, limiting memory use
+		 *  to about this much per thread. A single KLV larger than this is still read in full.
+		 */
+		void SetMaxQueued(size_t Bytes) { MaxQueued = Bytes; }
+
+		//! Set the default read handler
+		/*! \see GCReader::SetDefaultHandler() */
+		void SetDefaultHandler(GCReadHandlerPtr DefaultHandler = NULL) { Reader->SetDefaultHandler(DefaultHandler); }
+
+		//! Set the filler handler
+		/*! \see GCReader::SetFillerHandler() */
+		void SetFillerHandler(GCReadHandlerPtr FillerHandler = NULL) { Reader->SetFillerHandler(FillerHandler); }
+
+		//! Set the encryption handler
+		/*! \see GCReader::SetEncryptionHandler() */
+		void SetEncryptionHandler(GCReadHandlerPtr EncryptionHandler = NULL) { Reader->SetEncryptionHandler(EncryptionHandler); }
+
+		//! Set the data handler for a given track number
+		/*! \see GCReader::SetDataHandler() */
+		void SetDataHandler(UInt32 TrackNumber, GCReadHandlerPtr DataHandler = NULL) { Reader->SetDataHandler(TrackNumber, DataHandler); }
+
+		//! Get the GCReader used to dispatch KLVs, which is the caller passed to each handler
+		GCReaderPtr GetGCReader(void) { return Reader; }
+
+		//! Read the whole stream, dispatching every KLV to the handlers in stream order
+		/*! \return true if all went well, false if no partitions were found for the stream, a read failed or a handler returned false
+		 */
+		bool Read(void);
+
+	protected:
+		//! Find the partitions holding essence for this stream
+		bool FindRanges(void);
+
+		//! Read each partition on the calling thread, used when the file cannot be opened by the workers
+		bool ReadSerial(void);
+
+		//! Read partitions until there are none left, called by each worker task
+		void WorkerLoop(MXFFilePtr WorkerFile);
+
+		//! Queue a KLV read by a worker, waiting if the queue for its partition is full
+		/*! \return false if the workers should stop */
+		bool QueueItem(size_t Range, KLVObjectPtr Object, Position FileOffset, Position StreamOffset);
+
+		// The worker task class and its read handler need access to the worker functions
+		friend class ParallelReadWorker;
+		friend class ParallelQueueHandler;
+
+	private:
+		//! Prevent copy construction
+		ParallelBodyReader(const ParallelBodyReader &);
+	};
+
+	//! A smart pointer to a ParallelBodyReader object
+	typedef SmartPtr<ParallelBodyReader> ParallelBodyReaderPtr;
+}
+
+#endif // MXFLIB__PARALLELREAD_H
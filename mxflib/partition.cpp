@@ -69,33 +69,36 @@ void mxflib::Partition::AddMetadata(MDObjectPtr NewObject, bool ForceFirst /*=fa
 			{
 				has_target = true;
 
-				UUIDPtr ID = new UUID((*it).second->Value->PutData()->Data);
-				RefTargets.insert(std::map<UUID, MDObjectPtr>::value_type(*ID, NewObject));
+				RefTargetIndex::Entry &Entry = RefTargets.Insert((*it).second->Value->GetData().Data);
 
-				// Try and satisfy all refs to this set
-				for(;;)
+				// Only the first set with a given InstanceUID becomes the target
+				if(!Entry.Target)
 				{
-					std::multimap<UUID, MDObjectPtr>::iterator mit = UnmatchedRefs.find(*ID);
+					Entry.Target = NewObject;
 
-					// Exit when no more refs to this object
-					if(mit == UnmatchedRefs.end()) break;
-
-					// Sanity check!
-					if((*mit).second->GetLink())
+					// Satisfy all refs already waiting for this set
+					size_t Pending = Entry.FirstPending;
+					Entry.FirstPending = RefTargetIndex::NoPending;
+					while(Pending != RefTargetIndex::NoPending)
 					{
-						error("Internal error - %s at 0x%s in UnmatchedRefs but already linked!\n", (*mit).second->FullName().c_str() , Int64toHexString((*mit).second->GetLocation(), 8).c_str());
-					}
+						PendingRef &ThisRef = UnmatchedRefs[Pending];
 
-					// Make the link
-					(*mit).second->SetLink(NewObject);
+						// Sanity check!
+						if(ThisRef.Source->GetLink())
+						{
+							error("Internal error - %s at 0x%s in UnmatchedRefs but already linked!\n", ThisRef.Source->FullName().c_str() , Int64toHexString(ThisRef.Source->GetLocation(), 8).c_str());
+						}
 
-					// If we are the tagert of a strong ref we won't get added to the top level
-					if((*mit).second->GetRefType() == DICT_REF_STRONG) linked = true;
+						// Make the link
+						ThisRef.Source->SetLink(NewObject);
 
-					// Remove from the unmatched refs map
-					UnmatchedRefs.erase(mit);
+						// If we are the tagert of a strong ref we won't get added to the top level
+						if(ThisRef.Source->GetRefType() == DICT_REF_STRONG) linked = true;
 
-					// loop for any more refs to this set
+						// The slot is left in the list, but no longer holds a ref
+						ThisRef.Source = NULL;
+						Pending = ThisRef.Next;
+					}
 				}
 			}
 		}
@@ -220,21 +223,34 @@ void mxflib::Partition::ProcessChildRefs(MDObjectPtr ThisObject)
 				}
 				else
 				{
-					UUIDPtr ID = new UUID((*it).second->Value->PutData()->Data);
-					std::map<UUID, MDObjectPtr>::iterator mit = RefTargets.find(*ID);
+					const UInt8 *ID = (*it).second->Value->GetData().Data;
 
-					if(mit == RefTargets.end())
+					if(BatchRefs)
 					{
-						// Not matched yet, so add to the list of outstanding refs
-						UnmatchedRefs.insert(std::multimap<UUID, MDObjectPtr>::value_type(*ID, (*it).second));
+						// All refs are resolved in one pass once the sets have all been read
+						PendingRef NewRef;
+						memcpy(NewRef.ID, ID, 16);
+						NewRef.Source = (*it).second;
+						NewRef.Next = RefTargetIndex::NoPending;
+						UnmatchedRefs.push_back(NewRef);
 					}
 					else
 					{
-						// Make the link
-						(*it).second->SetLink((*mit).second);
+						RefTargetIndex::Entry &Entry = RefTargets.Insert(ID);
+
+						if(!Entry.Target)
+						{
+							// Not matched yet, so add to the list of outstanding refs
+							AddUnmatchedRef(Entry, (*it).second);
+						}
+						else
+						{
+							// Make the link
+							(*it).second->SetLink(Entry.Target);
 
-						// If we have made a strong ref, remove the target from the top level
-						if(Ref == DICT_REF_STRONG) TopLevelMetadata.remove((*mit).second);
+							// If we have made a strong ref, remove the target from the top level
+							if(Ref == DICT_REF_STRONG) TopLevelMetadata.remove(Entry.Target);
+						}
 					}
 				}
 			}
@@ -245,6 +261,163 @@ void mxflib::Partition::ProcessChildRefs(MDObjectPtr ThisObject)
 }
 
 
+//! Record a reference as unmatched, chained from the index entry of its target
+void mxflib::Partition::AddUnmatchedRef(RefTargetIndex::Entry &Target, MDObjectPtr &Source)
+{
+	PendingRef NewRef;
+	memcpy(NewRef.ID, Target.ID, 16);
+	NewRef.Source = Source;
+	NewRef.Next = Target.FirstPending;
+
+	Target.FirstPending = UnmatchedRefs.size();
+	UnmatchedRefs.push_back(NewRef);
+
+	// If the target has been read, but not yet decoded, it can be decoded when this reference is followed
+	if(ThisDeferred && ThisDeferred->IsDeferred(UUID(Target.ID))) Source->SetResolver(Deferred);
+}
+
+
+//! Resolve all the references collected while reading header metadata, in a single pass
+/*! Any refs that are still unmatched are chained from the index entries of their targets, ready for those sets to be added.
+ *  \note This may be called more than once while reading, as resolving refs already chained does no harm
+ */
+void mxflib::Partition::ResolveBatchRefs(void)
+{
+	PendingRefList Refs;
+	Refs.swap(UnmatchedRefs);
+
+	// The chains of any refs already unmatched are rebuilt below, so clear their heads first
+	PendingRefList::iterator it = Refs.begin();
+	while(it != Refs.end())
+	{
+		if((*it).Source) RefTargets.Insert((*it).ID).FirstPending = RefTargetIndex::NoPending;
+		it++;
+	}
+
+	// The targets of strong refs, which are not top-level
+	std::vector<MDObject*> Linked;
+
+	it = Refs.begin();
+	while(it != Refs.end())
+	{
+		// Skip the slots of refs satisfied since they were recorded
+		if((*it).Source)
+		{
+			// DRAGONS: Every ref already has an entry, so this lookup never grows the table
+			RefTargetIndex::Entry *Entry = RefTargets.Find((*it).ID);
+
+			if(!Entry->Target)
+			{
+				AddUnmatchedRef(*Entry, (*it).Source);
+			}
+			else
+			{
+				(*it).Source->SetLink(Entry->Target);
+
+				if((*it).Source->GetRefType() == DICT_REF_STRONG) Linked.push_back(Entry->Target.GetPtr());
+			}
+		}
+
+		it++;
+	}
+
+	// Remove all strongly reffed sets from the top level in one pass, rather than one search of the list per ref
+	if(!Linked.empty())
+	{
+		std::sort(Linked.begin(), Linked.end());
+
+		MDObjectList::iterator TopIt = TopLevelMetadata.begin();
+		while(TopIt != TopLevelMetadata.end())
+		{
+			if(std::binary_search(Linked.begin(), Linked.end(), (*TopIt).GetPtr())) TopIt = TopLevelMetadata.erase(TopIt);
+			else TopIt++;
+		}
+	}
+}
+
+
+//! Locate the entry for a given InstanceUID
+/*! \return NULL if there is no entry for this InstanceUID */
+RefTargetIndex::Entry *RefTargetIndex::Find(const UInt8 *ID)
+{
+	if(Slots.empty()) return NULL;
+
+	size_t Mask = Slots.size() - 1;
+	size_t Slot = Hash(ID) & Mask;
+	while(Slots[Slot].Used)
+	{
+		if(memcmp(Slots[Slot].ID, ID, 16) == 0) return &Slots[Slot];
+		Slot = (Slot + 1) & Mask;
+	}
+
+	return NULL;
+}
+
+
+//! Locate the entry for a given InstanceUID, adding an empty entry if there is not one
+/*! \note The returned reference is only valid until the next call to Insert() */
+RefTargetIndex::Entry &RefTargetIndex::Insert(const UInt8 *ID)
+{
+	// Keep the table no more than half full so that probe sequences stay short
+	if((Count + 1) * 2 > Slots.size()) Grow();
+
+	size_t Mask = Slots.size() - 1;
+	size_t Slot = Hash(ID) & Mask;
+	while(Slots[Slot].Used)
+	{
+		if(memcmp(Slots[Slot].ID, ID, 16) == 0) return Slots[Slot];
+		Slot = (Slot + 1) & Mask;
+	}
+
+	Entry &Ret = Slots[Slot];
+	memcpy(Ret.ID, ID, 16);
+	Ret.Used = true;
+	Count++;
+
+	return Ret;
+}
+
+
+//! Hash the bytes of an InstanceUID
+size_t RefTargetIndex::Hash(const UInt8 *ID)
+{
+	// DRAGONS: InstanceUIDs are not always random (some writers count up from a fixed base) so all 16 bytes are mixed with FNV-1a
+	UInt32 Ret = 2166136261U;
+	for(int i = 0; i < 16; i++)
+	{
+		Ret ^= ID[i];
+		Ret *= 16777619U;
+	}
+
+	return static_cast<size_t>(Ret);
+}
+
+
+//! Double the size of the table
+void RefTargetIndex::Grow(void)
+{
+	std::vector<Entry> OldSlots;
+	OldSlots.swap(Slots);
+
+	Slots.resize(OldSlots.empty() ? 64 : (OldSlots.size() * 2));
+
+	size_t Mask = Slots.size() - 1;
+	std::vector<Entry>::iterator it = OldSlots.begin();
+	while(it != OldSlots.end())
+	{
+		if((*it).Used)
+		{
+			size_t Slot = Hash((*it).ID) & Mask;
+			while(Slots[Slot].Used) Slot = (Slot + 1) & Mask;
+
+			Slots[Slot] = *it;
+		}
+
+		it++;
+	}
+}
+
+
 //! Load any metadictionaties that are in the list of currently loaded objects
 bool mxflib::Partition::LoadMetadict(void)
 {
@@ -317,11 +490,91 @@ bool mxflib::Partition::LoadMetadict(void)
 }
 
 
+namespace
+{
+	//! Locate the local tag used for InstanceUID in a given primer (or the static primer if none given)
+	Tag FindInstanceUIDTag(PrimerPtr &UsePrimer)
+	{
+		if(UsePrimer)
+		{
+			Primer::iterator it = UsePrimer->begin();
+			while(it != UsePrimer->end())
+			{
+				if((*it).second.Matches(InstanceUID_UL)) return (*it).first;
+				it++;
+			}
+		}
+
+		// Not found in the primer, so use the static value
+		ULPtr InstanceUID = new UL(InstanceUID_UL);
+		return Primer::StaticLookup(InstanceUID);
+	}
+
+	//! Build the key used to cache the overlay holding the metadictionary of a block of header metadata
+	/*! Metadictionaries are loaded when the Preface is read, so this is a hash of all bytes before the Preface,
+	 *  including the primer, as these are all that the loaded metadictionary can depend on.
+	 *  \return NULL if there is no Preface, or the KLVs before it cannot be parsed
+	 */
+	DataChunkPtr MetadictKey(const UInt8 *Buffer, size_t Size)
+	{
+		const UInt8 *Ptr = Buffer;
+		const UInt8 *End = Buffer + Size;
+
+		while(static_cast<size_t>(End - Ptr) > 16)
+		{
+			if(UL(Ptr).Matches(Preface_UL))
+			{
+				HashSHA1 Hash;
+				Hash.HashData(static_cast<size_t>(Ptr - Buffer), Buffer);
+				return Hash.GetHash();
+			}
+
+			// Skip this KLV
+			const UInt8 *LenPtr = Ptr + 16;
+			UInt64 Len = *LenPtr++;
+			if(Len >= 0x80)
+			{
+				int LenSize = static_cast<int>(Len & 0x7f);
+				if((LenSize > 8) || (End - LenPtr) < LenSize) return NULL;
+
+				Len = 0;
+				while(LenSize--) Len = (Len << 8) + *(LenPtr++);
+			}
+
+			if(static_cast<UInt64>(End - LenPtr) < Len) return NULL;
+			Ptr = LenPtr + static_cast<size_t>(Len);
+		}
+
+		return NULL;
+	}
+}
+
+
 //! Read a full set of header metadata from this partition's source file (including primer)
 /*!  \return The number of bytes read (<b>including</b> any preceeding filler)
  *   \return 0 if no header metadata in this partition
  */
 Length mxflib::Partition::ReadMetadata(void)
+{
+	return ReadSourceMetadata(NULL);
+}
+
+
+//! Read a full set of header metadata from this partition's source file, decoding only selected sets
+/*! Only the sets selected by the filter, and the sets that reference them up to the Preface, are decoded.
+ *  All other sets with an InstanceUID are located but not decoded, as with FeatureLazyMetadata, and are
+ *  decoded when a reference to them is first followed or ReadDeferredMetadata() is called.
+ *  \return The number of bytes read (<b>including</b> any preceeding filler)
+ *  \return 0 if no header metadata in this partition
+ */
+Length mxflib::Partition::ReadMetadata(const MetadataFilter &Filter)
+{
+	return ReadSourceMetadata(&Filter);
+}
+
+
+//! Locate the header metadata in this partition's source file and read it
+Length mxflib::Partition::ReadSourceMetadata(const MetadataFilter *Filter)
 {
 	Length MetadataSize = GetInt64(HeaderByteCount_UL);
 	if(MetadataSize == 0) return 0;
@@ -340,7 +593,7 @@ Length mxflib::Partition::ReadMetadata(void)
 	Length Len = ParentFile->ReadBER();
 	ParentFile->Seek(ParentFile->Tell() + Len);
 
-	return ReadMetadata(ParentFile, MetadataSize);
+	return ReadMetadata(ParentFile, MetadataSize, Filter);
 }
 
 
@@ -349,7 +602,7 @@ Length mxflib::Partition::ReadMetadata(void)
  *        the primer, but the return value does
  *  \return The number of bytes read (<b>including</b> any preceeding filler)
  */
-Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size)
+Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size, const MetadataFilter *Filter /*=NULL*/)
 {
 	Length Bytes = 0;
 	Length FillerBytes = 0;
@@ -405,9 +658,54 @@ Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size)
 		Size = static_cast<Length>(Data->Size);
 	}
 
+	// Should metadictionaries be loaded when the Preface is read?
+	bool LoadMetadicts = Feature(FeatureLoadMetadict);
+
+	// Once the dictionary is frozen, any metadictionary of the file is loaded into an overlay for the file,
+	// unless an overlay built from an identical metadictionary is in the overlay cache
+	DataChunkPtr OverlayKey;
+	if(MDOType::IsFrozen() && LoadMetadicts)
+	{
+		OverlayKey = MetadictKey(Data->Data, Data->Size);
+
+		TypeOverlayPtr Cached;
+		if(OverlayKey) Cached = TypeOverlay::FindCached(*OverlayKey);
+
+		if(Cached)
+		{
+			File->SetTypeOverlay(Cached);
+			LoadMetadicts = false;
+		}
+		// DRAGONS: An overlay that is to be cached needs to hold only this metadictionary, and a cached one is shared so is never added to
+		else if(OverlayKey || !File->GetTypeOverlay() || File->GetTypeOverlay()->IsCached())
+		{
+			File->SetTypeOverlay(new TypeOverlay);
+		}
+	}
+	TypeOverlay::Scope OverlayScope(File->GetTypeOverlay().GetPtr());
+
 	// Start of data buffer
 	const UInt8 *BuffPtr = Data->Data;
 
+	// When reading lazily, or only decoding selected sets, sets that can be referenced are not decoded until a reference to them is followed
+	// DRAGONS: Metadictionaries need to be read before the sets that use them, so these are incompatible with lazy or filtered reading
+	if(Feature(FeatureLoadMetadict)) Filter = NULL;
+	bool Lazy = (Filter || Feature(FeatureLazyMetadata)) && !Feature(FeatureLoadMetadict);
+	if(Lazy)
+	{
+		ThisDeferred = new DeferredMetadata(this, File, Location, Data);
+		Deferred = ThisDeferred;
+	}
+
+	// The tag used for InstanceUID, located once we have read the primer
+	Tag InstanceUIDTag = 0;
+
+	// Collect the refs of each set as it is added, and resolve them all once the sets are read
+	BatchRefs = true;
+
+	// Should the bytes of each set be kept for reuse when written?
+	bool KeepBytes = Feature(FeatureKeepMetadataBytes);
+
 	while(Size)
 	{
 		Length BytesAtItemStart = Bytes;
@@ -429,11 +727,22 @@ Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size)
 		ULPtr NewUL = new UL(BuffPtr);
 
 		/* If we are loading metadictionaries, we do so when we first read the Preface key */
-		if(Feature(FeatureLoadMetadict))
+		if(LoadMetadicts)
 		{
 			if(NewUL->Matches(Preface_UL))
 			{
-				LoadMetadict();
+				// The metadictionaries are found by following refs, so resolve those read so far
+				ResolveBatchRefs();
+
+				bool Loaded = LoadMetadict();
+
+				// The overlay is now complete, so may be reused by other files with the same metadictionary
+				// DRAGONS: Overlays from metadictionaries with errors are not cached, so that the errors are reported for each file
+				if(OverlayKey)
+				{
+					if(Loaded) TypeOverlay::AddCached(*OverlayKey, File->GetTypeOverlay());
+					OverlayKey = NULL;
+				}
 			}
 		}
 
@@ -516,12 +825,43 @@ Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size)
 			continue;
 		}
 		
+		// Record, rather than decode, lazily read local sets that have an InstanceUID
+		if(Lazy && Len && (NewItem->GetType()->GetKeyFormat() == DICT_KEY_2_BYTE) && (NewItem->GetType()->GetLenFormat() == DICT_LEN_2_BYTE)
+		   && (!NewItem->IsA(Preface_UL)) && !(Filter && Filter->Matches(NewItem->GetType())))
+		{
+			if(!InstanceUIDTag) InstanceUIDTag = FindInstanceUIDTag(PartitionPrimer);
+
+			// Scan the local set for the InstanceUID property
+			const UInt8 *ItemPtr = BuffPtr;
+			Length ItemSize = Len;
+			while(ItemSize >= 4)
+			{
+				Tag ThisTag = GetU16(ItemPtr);
+				UInt16 ThisLen = GetU16(&ItemPtr[2]);
+				if((ThisTag == InstanceUIDTag) && (ThisLen == 16) && (ItemSize >= 20)) break;
+
+				ItemPtr += 4 + ThisLen;
+				if(ItemSize < static_cast<Length>(4 + ThisLen)) ItemSize = 0; else ItemSize -= 4 + ThisLen;
+			}
+
+			if((ItemSize >= 20) && ThisDeferred->Add(UUID(&ItemPtr[4]), NewUL, static_cast<size_t>(BuffPtr - Data->Data), (UInt32)(Bytes - BytesAtItemStart), (UInt32)Len))
+			{
+				Size -= Len;
+				Bytes += Len;
+				BuffPtr += Len;
+
+				continue;
+			}
+		}
+
 		if(Len)
 		{
 			NewItem->SetParent(File, BytesAtItemStart + Location,(UInt32)( Bytes - BytesAtItemStart));
 
 			NewItem->ReadValue(BuffPtr,(UInt32) Len, PartitionPrimer);
 
+			if(KeepBytes) NewItem->KeepReadBytes(Data, static_cast<size_t>(BytesAtItemStart), static_cast<size_t>(Bytes - BytesAtItemStart + Len), PartitionPrimer);
+
 			// Skip total length, not just the length actually consumed
 			Size -= Len;
 			Bytes += Len;
@@ -531,32 +871,210 @@ Length mxflib::Partition::ReadMetadata(MXFFilePtr File, Length Size)
 		AddMetadata(NewItem);
 	}
 
+	// Link all the refs in one pass now that every set has been read
+	// DRAGONS: Any refs to sets that were deferred rather than decoded are given the resolver here
+	BatchRefs = false;
+	ResolveBatchRefs();
+
+	// Sets selected by a filter need the sets above them to be reachable from the Preface
+	if(Filter) DecodeFilterAncestors();
+
 	return Bytes + FillerBytes;
 }
 
 
-//! Read any index segments from this partition's source file, and add them to a given table
-/*! \ret true if all OK
-	*/
-bool mxflib::Partition::ReadIndex(IndexTablePtr Table)
+//! Decode the deferred sets that reference sets already decoded, until every decoded set is reached from the Preface
+/*! Each pass decodes the parents of the sets that are still top-level, so this takes one pass per level of the tree
+ */
+void mxflib::Partition::DecodeFilterAncestors(void)
 {
-	bool Ret = true;
-
-	MDObjectListPtr Segments = ReadIndex();
+	if(!ThisDeferred) return;
 
-	MDObjectList::iterator it = Segments->begin();
-	while(it != Segments->end())
+	for(;;)
 	{
-		// Set error flag if any add fails
-		if(!Table->AddSegment(*it)) Ret = false;
+		// Index the InstanceUIDs of all decoded sets without a decoded parent
+		RefTargetIndex Orphans;
+		MDObjectList::iterator it = TopLevelMetadata.begin();
+		while(it != TopLevelMetadata.end())
+		{
+			if(!(*it)->IsA(Preface_UL))
+			{
+				MDObjectPtr ID = (*it)[InstanceUID_UL];
+				if(ID && (ID->GetData().Size == 16)) Orphans.Insert(ID->GetData().Data).Target = *it;
+			}
+			it++;
+		}
+
+		// Stop once there are no more parents to decode
+		if((Orphans.size() == 0) || (ThisDeferred->DecodeReferrers(Orphans) == 0)) break;
+	}
+}
+
 
+//! Determine if sets of a given class should be decoded
+bool MetadataClassFilter::Matches(const MDOTypePtr &Type) const
+{
+	ULList::const_iterator it = Classes.begin();
+	while(it != Classes.end())
+	{
+		if(Type->IsA(**it)) return true;
 		it++;
 	}
 
+	return false;
+}
+
+
+//! Construct an empty list of deferred sets for a given partition and buffer of raw metadata
+/*! \param Location The location in File of the first byte of Buffer
+ */
+DeferredMetadata::DeferredMetadata(Partition *Owner, MXFFilePtr &File, Position Location, DataChunkPtr &Buffer)
+	: Owner(Owner), File(File), Location(Location), Buffer(Buffer)
+{
+}
+
+
+//! Add a set to the list
+/*! \param Offset The offset of the value of the set in the buffer of raw metadata
+ *  \param KLSize The size of the key and length of the set (which immediately precede its value)
+ *  \param Len The size of the value of the set
+ *  \return false if a set with this InstanceUID is already deferred, in which case it is not added
+ */
+bool DeferredMetadata::Add(const UUID &InstanceUID, ULPtr &Key, size_t Offset, UInt32 KLSize, UInt32 Len)
+{
+	if(IsDeferred(InstanceUID)) return false;
+
+	DeferredSet NewSet;
+	NewSet.Key = Key;
+	NewSet.Offset = Offset;
+	NewSet.KLSize = KLSize;
+	NewSet.Len = Len;
+
+	NewSet.IndexEntry = Index.insert(std::map<UUID, size_t>::value_type(InstanceUID, Sets.size())).first;
+	Sets.push_back(NewSet);
+
+	return true;
+}
+
+
+//! Decode the set with a given InstanceUID and add it to the partition
+/*! \return The decoded set, or NULL if there is no such set waiting to be decoded
+ */
+MDObjectPtr DeferredMetadata::Decode(const UUID &InstanceUID)
+{
+	std::map<UUID, size_t>::iterator it = Index.find(InstanceUID);
+	if(it == Index.end()) return NULL;
+
+	return Decode((*it).second);
+}
+
+
+//! Decode a given entry in Sets and add it to the partition
+MDObjectPtr DeferredMetadata::Decode(size_t Entry)
+{
+	DeferredSet &ThisSet = Sets[Entry];
+
+	// Don't decode anything twice, or after the partition has gone
+	if((!ThisSet.Key) || (!Owner)) return NULL;
+
+	MDObjectPtr Ret = new MDObject(ThisSet.Key);
+	ThisSet.Key = NULL;
+	Index.erase(ThisSet.IndexEntry);
+
+	MXFFilePtr ThisFile = File;
+	Ret->SetParent(ThisFile, Location + ThisSet.Offset - ThisSet.KLSize, ThisSet.KLSize);
+	Ret->ReadValue(&Buffer->Data[ThisSet.Offset], ThisSet.Len, Owner->PartitionPrimer);
+
+	if(Feature(FeatureKeepMetadataBytes)) Ret->KeepReadBytes(Buffer, ThisSet.Offset - ThisSet.KLSize, ThisSet.KLSize + ThisSet.Len, Owner->PartitionPrimer);
+
+	// Adding the set links it to all references already waiting for it
+	Owner->AddMetadata(Ret);
+
 	return Ret;
 }
 
 
+//! Decode all sets not yet decoded, in the order they were read
+void DeferredMetadata::DecodeAll(void)
+{
+	// DRAGONS: Sets.size() is re-checked each time in case the partition is cleared while adding a set
+	for(size_t i = 0; i < Sets.size(); i++) Decode(i);
+
+	// Nothing is left to decode, even if the partition has gone
+	Index.clear();
+}
+
+
+//! Decode all sets not yet decoded that reference any of a given set of InstanceUIDs
+/*! Any property holding a single 16-byte value, or a batch or array of them, is taken to be a reference.
+ *  \return The number of sets decoded
+ */
+size_t DeferredMetadata::DecodeReferrers(RefTargetIndex &IDs)
+{
+	size_t Ret = 0;
+
+	for(size_t i = 0; i < Sets.size(); i++)
+	{
+		if(!Sets[i].Key) continue;
+
+		// Scan the local set for a property holding one of the InstanceUIDs
+		// DRAGONS: This also finds weak refs, and any other 16-byte values that happen to match, which only costs an extra decode
+		const UInt8 *ItemPtr = &Buffer->Data[Sets[i].Offset];
+		Length ItemSize = Sets[i].Len;
+		bool Found = false;
+		while((ItemSize >= 4) && !Found)
+		{
+			UInt16 ThisLen = GetU16(&ItemPtr[2]);
+			if(ItemSize < static_cast<Length>(4 + ThisLen)) break;
+
+			const UInt8 *ValuePtr = &ItemPtr[4];
+			if(ThisLen == 16)
+			{
+				Found = (IDs.Find(ValuePtr) != NULL);
+			}
+			else if((ThisLen >= 8) && (GetU32(&ValuePtr[4]) == 16) && ((GetU32(ValuePtr) * 16) == static_cast<UInt32>(ThisLen - 8)))
+			{
+				for(UInt32 j = 8; (j < ThisLen) && !Found; j += 16) Found = (IDs.Find(&ValuePtr[j]) != NULL);
+			}
+
+			ItemPtr += 4 + ThisLen;
+			ItemSize -= 4 + ThisLen;
+		}
+
+		if(Found && Decode(i)) Ret++;
+	}
+
+	return Ret;
+}
+
+
+//! Decode the target of a given reference source
+void DeferredMetadata::Resolve(MDObject *Source)
+{
+	DataChunkPtr ID = Source->PutData();
+	if(ID->Size != 16) return;
+
+	Decode(UUID(ID->Data));
+}
+
+
+//! Read any index segments from this partition's source file, and add them to a given table
+/*! The segments are parsed directly from the raw bytes of the index, without building any MDObjects
+ *  \param Info If not NULL, a summary of each segment read is appended to this list
+ *  \ret true if all OK
+ */
+bool mxflib::Partition::ReadIndex(IndexTablePtr Table, IndexSegmentInfoList *Info /*=NULL*/)
+{
+	// No index bytes is not an error, there is simply nothing to add
+	if(GetInt64(IndexByteCount_UL) == 0) return true;
+
+	DataChunkPtr IndexChunk = ReadIndexChunk();
+	if(!IndexChunk) return false;
+
+	return Table->AddSegments(IndexChunk, Info);
+}
+
+
 //! Read any index table segments from this partition's source file
 MDObjectListPtr mxflib::Partition::ReadIndex(void)
 {
@@ -701,8 +1219,9 @@ DataChunkPtr mxflib::Partition::ReadIndexChunk(void)
 	// Move to the start of the index table segments
 	ParentFile->Seek(Location + MetadataSize);
 
-	// Read the specified number of bytes
-	Ret = ParentFile->Read(static_cast<size_t>(IndexSize));
+	// Read the specified number of bytes, referencing the mapped bytes directly if possible
+	if(ParentFile->IsMappedFile()) Ret = ParentFile->ReadView(static_cast<size_t>(IndexSize));
+	else Ret = ParentFile->Read(static_cast<size_t>(IndexSize));
 
 	/* Remove any trailing filler */
 
@@ -801,6 +1320,18 @@ bool mxflib::Partition::StartElements()
 	return _NextBodyLocation != 0;
 }
 
+//! Start reading elements from a given location in the body, such as one found with an index table
+bool mxflib::Partition::StartElementsAt(Position Location)
+{
+	_BodyLocation = 0;
+
+	if(!Object->GetParentFile()) { error("Call to Partition::StartElementsAt() on a non-file partition\n"); return false; }
+
+	_NextBodyLocation = SkipFill( static_cast<UInt64>(Location) );
+
+	return _NextBodyLocation != 0;
+}
+
 // goto _NextBodyLocation
 KLVObjectPtr mxflib::Partition::NextElement()
 {
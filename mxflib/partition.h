@@ -36,10 +36,171 @@
 #include "mxflib/primer.h"
 
 #include <list>
+#include <map>
+#include <vector>
 
 
 namespace mxflib
 {
+	//! Index of header metadata reference targets, keyed by the 16 bytes of their InstanceUID
+	/*! Each entry also heads the chain of unmatched references waiting for that target.
+	 *  DRAGONS: This is an open-addressed hash table of the raw bytes, rather than a map of UUID, as building and comparing
+	 *           a UUID object for every reference dominated the time taken to read large header metadata
+	 */
+	class RefTargetIndex
+	{
+	public:
+		//! Value of Entry::FirstPending and PendingRef::Next for the end of a chain
+		static const size_t NoPending = static_cast<size_t>(-1);
+
+		//! An entry in the index
+		struct Entry
+		{
+			UInt8 ID[16];						//!< The InstanceUID
+			bool Used;							//!< True if this slot holds an entry
+			MDObjectPtr Target;					//!< The set with this InstanceUID, or NULL if not yet found
+			size_t FirstPending;				//!< Index of the first unmatched reference to this target, or NoPending
+
+			Entry() : Used(false), FirstPending(NoPending) {}
+		};
+
+	protected:
+		std::vector<Entry> Slots;				//!< The hash table, always a power of two in size
+		size_t Count;							//!< The number of entries in use
+
+	public:
+		RefTargetIndex() : Count(0) {}
+
+		//! Locate the entry for a given InstanceUID
+		/*! \return NULL if there is no entry for this InstanceUID */
+		Entry *Find(const UInt8 *ID);
+
+		//! Locate the entry for a given InstanceUID, adding an empty entry if there is not one
+		/*! \note The returned reference is only valid until the next call to Insert() */
+		Entry &Insert(const UInt8 *ID);
+
+		//! Remove all entries
+		void clear(void) { Slots.clear(); Count = 0; }
+
+		//! Get the number of entries
+		size_t size(void) const { return Count; }
+
+	protected:
+		//! Hash the bytes of an InstanceUID
+		static size_t Hash(const UInt8 *ID);
+
+		//! Double the size of the table
+		void Grow(void);
+	};
+
+	//! A strong or weak reference not yet linked to its target
+	struct PendingRef
+	{
+		UInt8 ID[16];							//!< The InstanceUID of the target
+		MDObjectPtr Source;						//!< The reference source, or NULL once it has been linked
+		size_t Next;							//!< Index of the next unmatched reference to the same target, or RefTargetIndex::NoPending
+	};
+
+	//! List of references not yet linked to their targets
+	typedef std::vector<PendingRef> PendingRefList;
+
+
+	//! Selects the header metadata sets to decode when reading with Partition::ReadMetadata(const MetadataFilter &)
+	class MetadataFilter
+	{
+	public:
+		virtual ~MetadataFilter() {}
+
+		//! Determine if sets of a given class should be decoded
+		virtual bool Matches(const MDOTypePtr &Type) const = 0;
+	};
+
+	//! Filter that selects sets of any of a list of classes, including classes derived from them
+	class MetadataClassFilter : public MetadataFilter
+	{
+	protected:
+		ULList Classes;						//!< The classes to select
+
+	public:
+		//! Construct a filter that selects no classes
+		MetadataClassFilter() {}
+
+		//! Construct a filter that selects a single class
+		MetadataClassFilter(const UL &Class) { Add(Class); }
+
+		//! Add a class to select
+		void Add(const UL &Class) { Classes.push_back(new UL(Class)); }
+
+		//! Determine if sets of a given class should be decoded
+		virtual bool Matches(const MDOTypePtr &Type) const;
+	};
+
+
+	//! Header metadata sets that have been located but not yet decoded
+	/*! Used when reading header metadata with FeatureLazyMetadata enabled. Each set that is a reference target
+	 *  is recorded here along with the location of its value in the raw metadata, and is only decoded (and added
+	 *  to the partition) when a reference to it is first followed.
+	 */
+	class DeferredMetadata : public RefResolver
+	{
+	protected:
+		//! The location of a single set that has not been decoded
+		struct DeferredSet
+		{
+			ULPtr Key;						//!< The key of the set, or NULL once it has been decoded
+			size_t Offset;					//!< Offset of the value of the set in Buffer
+			UInt32 KLSize;					//!< Size of the key and length of the set
+			UInt32 Len;						//!< Size of the value of the set
+			std::map<UUID, size_t>::iterator IndexEntry;	//!< The entry for this set in Index, valid until it is decoded
+		};
+
+		PartitionParent Owner;				//!< The partition to which decoded sets are added
+		MXFFileParent File;					//!< The file from which the metadata was read
+		Position Location;					//!< The location in the file of the start of Buffer
+		DataChunkPtr Buffer;				//!< The raw header metadata
+		std::vector<DeferredSet> Sets;		//!< All deferred sets, in the order they were read
+		std::map<UUID, size_t> Index;		//!< Index in Sets of each set that is not yet decoded, by InstanceUID
+
+	public:
+		//! Construct an empty list of deferred sets for a given partition and buffer of raw metadata
+		DeferredMetadata(Partition *Owner, MXFFilePtr &File, Position Location, DataChunkPtr &Buffer);
+
+		//! Add a set to the list
+		/*! \return false if a set with this InstanceUID is already deferred, in which case it is not added */
+		bool Add(const UUID &InstanceUID, ULPtr &Key, size_t Offset, UInt32 KLSize, UInt32 Len);
+
+		//! Determine if a set with a given InstanceUID is waiting to be decoded
+		bool IsDeferred(const UUID &InstanceUID) const { return Index.find(InstanceUID) != Index.end(); }
+
+		//! Get the number of sets not yet decoded
+		size_t size(void) const { return Index.size(); }
+
+		//! Decode the set with a given InstanceUID and add it to the partition
+		/*! \return The decoded set, or NULL if there is no such set waiting to be decoded */
+		MDObjectPtr Decode(const UUID &InstanceUID);
+
+		//! Decode all sets not yet decoded, in the order they were read
+		void DecodeAll(void);
+
+		//! Decode all sets not yet decoded that reference any of a given set of InstanceUIDs
+		/*! Any property holding a single 16-byte value, or a batch or array of them, is taken to be a reference.
+		 *  \return The number of sets decoded
+		 */
+		size_t DecodeReferrers(RefTargetIndex &IDs);
+
+		//! Decode the target of a given reference source
+		virtual void Resolve(MDObject *Source);
+
+	protected:
+		//! Decode a given entry in Sets and add it to the partition
+		MDObjectPtr Decode(size_t Entry);
+
+	private:
+		//! Prevent copy construction
+		DeferredMetadata(const DeferredMetadata &);
+	};
+
+
 	//! Holds data relating to a single partition
 	class Partition : public ObjectInterface, public RefCount<Partition>
 	{
@@ -56,17 +217,28 @@ namespace mxflib
 										 */
 
 		MDObjectList AllMetadata;		//!< List of all header metadata sets in the partition
+										/*!< Sets deferred by lazy or filtered reading are not
+										 *   included until they are decoded, which can be
+										 *   forced with ReadDeferredMetadata()
+										 */
 		MDObjectList TopLevelMetadata;	//!< List of all metadata items in the partition not linked from another
+										/*!< Incomplete in the same way as AllMetadata until
+										 *   any deferred sets are decoded
+										 */
 
 	private:
-		std::map<UUID, MDObjectPtr> RefTargets;				//!< Map of UUID of all reference targets to objects
-		std::multimap<UUID, MDObjectPtr> UnmatchedRefs;		//!< Map of UUID of all strong or weak refs not yet linked
+		RefTargetIndex RefTargets;							//!< Index of all reference targets, each heading a chain of the unmatched refs to it
+		PendingRefList UnmatchedRefs;						//!< All strong or weak refs not yet linked, chained by target from RefTargets
+		bool BatchRefs;										//!< True while reading header metadata, when refs are only resolved once all sets are read
+
+		RefResolverPtr Deferred;							//!< Sets read but not yet decoded, if reading with FeatureLazyMetadata
+		DeferredMetadata *ThisDeferred;						//!< Deferred, as its real type
 
 	public:
-		Partition(const char *BaseType) { Object = new MDObject(BaseType); };
-		Partition(MDOTypePtr BaseType) { Object = new MDObject(BaseType); };
-		Partition(const UL &BaseUL) { Object = new MDObject(BaseUL); };
-		Partition(ULPtr BaseUL) { Object = new MDObject(*BaseUL); };
+		Partition(const char *BaseType) : BatchRefs(false), ThisDeferred(NULL) { Object = new MDObject(BaseType); };
+		Partition(MDOTypePtr BaseType) : BatchRefs(false), ThisDeferred(NULL) { Object = new MDObject(BaseType); };
+		Partition(const UL &BaseUL) : BatchRefs(false), ThisDeferred(NULL) { Object = new MDObject(BaseUL); };
+		Partition(ULPtr BaseUL) : BatchRefs(false), ThisDeferred(NULL) { Object = new MDObject(*BaseUL); };
 
 		//! Reload the metadata tree - DRAGONS: not an ideal way of doing this
 		void UpdateMetadata(ObjectInterface *NewObject) { ClearMetadata(); AddMetadata(NewObject->Object); };
@@ -87,29 +259,53 @@ namespace mxflib
 			TopLevelMetadata.clear();
 			RefTargets.clear();
 			UnmatchedRefs.clear();
+			Deferred = NULL;
+			ThisDeferred = NULL;
 		}
 
 		//! Read a full set of header metadata from this partition's source file (including primer)
 		Length ReadMetadata(void);
 
+		//! Read a full set of header metadata from this partition's source file, decoding only selected sets
+		/*! Only the sets selected by the filter, and the sets that reference them up to the Preface, are decoded.
+		 *  All other sets with an InstanceUID are located but not decoded, as with FeatureLazyMetadata, and are
+		 *  decoded when a reference to them is first followed or ReadDeferredMetadata() is called.
+		 *  \return The number of bytes read (<b>including</b> any preceeding filler)
+		 */
+		Length ReadMetadata(const MetadataFilter &Filter);
+
 		//! Read a full set of header metadata from a file (including primer)
-		Length ReadMetadata(MXFFilePtr File, Length Size);
+		/*! \param Filter If not NULL, only the sets selected by this filter, and the sets that reference them, are decoded */
+		Length ReadMetadata(MXFFilePtr File, Length Size, const MetadataFilter *Filter = NULL);
+
+		//! Get the number of header metadata sets read with FeatureLazyMetadata that have not yet been decoded
+		size_t GetDeferredCount(void) const { return ThisDeferred ? ThisDeferred->size() : 0; }
+
+		//! Decode all header metadata sets read with FeatureLazyMetadata that have not yet been decoded
+		void ReadDeferredMetadata(void) { if(ThisDeferred) ThisDeferred->DecodeAll(); }
 
 		//! Parse the current metadata sets into higher-level sets
 		MetadataPtr ParseMetadata(void);
 
 		//! Read any index table segments from this partition's source file
+		/*! \note This builds an MDObject for each segment, so is only useful for dumping the segments as metadata.
+		 *        To load an index table use ReadIndex(IndexTablePtr), which parses the raw bytes directly
+		 */
 		MDObjectListPtr ReadIndex(void);
 
 		//! Read any index table segments from a file
 		MDObjectListPtr ReadIndex(MXFFilePtr File, UInt64 Size);
 
 		//! Read any index segments from this partition's source file, and add them to a given table
-		/*! \ret true if all OK
+		/*! The segments are parsed directly from the raw bytes of the index, without building any MDObjects
+		 *  \param Info If not NULL, a summary of each segment read is appended to this list
+		 *  \ret true if all OK
 		 */
-		bool ReadIndex(IndexTablePtr Table);
+		bool ReadIndex(IndexTablePtr Table, IndexSegmentInfoList *Info = NULL);
 
 		//! Read raw index table data from this partition's source file
+		/*! \note For a memory mapped file the chunk references the mapped bytes rather than a copy, so must be treated as read-only
+		 */
 		DataChunkPtr ReadIndexChunk(void);
 
 		//! Set the KAG for this partition
@@ -122,8 +318,8 @@ namespace mxflib
 
 		// Access functions for the reference resolving properties
 		// DRAGONS: These should be const, but can't make it work!
-		std::map<UUID, MDObjectPtr>& GetRefTargets(void) { return RefTargets; };
-		std::multimap<UUID, MDObjectPtr>& GetUnmatchedRefs(void) { return UnmatchedRefs; };
+		RefTargetIndex& GetRefTargets(void) { return RefTargets; };
+		PendingRefList& GetUnmatchedRefs(void) { return UnmatchedRefs; };
 
 		//! Determine if the partition object is currently set as complete
 		bool IsComplete(void);
@@ -160,6 +356,9 @@ namespace mxflib
 	public:
 		// goto start of body...set the member variables _BodyLocation, _NextBodyLocation
 		bool StartElements();
+		//! Start reading elements from a given location in the body, such as one found with an index table
+		/*! \param Location The file offset of the key of the first element to read */
+		bool StartElementsAt(Position Location);
 		// goto _NextBodyLocation
 		KLVObjectPtr NextElement();
 		// skip over a KLV packet
@@ -179,6 +378,18 @@ namespace mxflib
 		//! Scan a metadata object for strong references in sub-objects and add those to this partition
 		void AddMetadataSubs(MDObjectPtr &NewObject, bool ForceFirst);
 
+		//! Record a reference as unmatched, chained from the index entry of its target
+		void AddUnmatchedRef(RefTargetIndex::Entry &Target, MDObjectPtr &Source);
+
+		//! Resolve all the references collected while reading header metadata, in a single pass
+		void ResolveBatchRefs(void);
+
+		//! Locate the header metadata in this partition's source file and read it
+		Length ReadSourceMetadata(const MetadataFilter *Filter);
+
+		//! Decode the deferred sets that reference sets already decoded, until every decoded set is reached from the Preface
+		void DecodeFilterAncestors(void);
+
 	private:
 		UInt64 _BodyLocation;				// file position for current Element
 		UInt64 _NextBodyLocation;		// file position for Element after this
@@ -0,0 +1,600 @@
+/*! \file	prefetch.cpp
+ *	\brief	Implementation of classes that read essence ahead of the writer on a background thread
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+//! Record an offered edit unit
+bool IndexRecorder::OfferEditUnit(int SubStream, Position EditUnit, int KeyOffset /*=0*/, int Flags /*=-1*/)
+{
+	OfferedEntry Entry;
+	Entry.Type = OfferedEntry::EditUnit;
+	Entry.SubStream = SubStream;
+	Entry.Pos = EditUnit;
+	Entry.Offset = KeyOffset;
+	Entry.Flags = Flags;
+	Offered.push_back(Entry);
+
+	// DRAGONS: The real manager currently accepts all offered entries, so we can say the same now
+	return true;
+}
+
+
+//! Record an offered temporal offset
+bool IndexRecorder::OfferTemporalOffset(Position EditUnit, int Offset)
+{
+	OfferedEntry Entry;
+	Entry.Type = OfferedEntry::TemporalOffset;
+	Entry.SubStream = 0;
+	Entry.Pos = EditUnit;
+	Entry.Offset = Offset;
+	Entry.Flags = 0;
+	Offered.push_back(Entry);
+
+	return true;
+}
+
+
+//! Record an offered key-frame offset
+bool IndexRecorder::OfferKeyOffset(Position EditUnit, int Offset)
+{
+	OfferedEntry Entry;
+	Entry.Type = OfferedEntry::KeyOffset;
+	Entry.SubStream = 0;
+	Entry.Pos = EditUnit;
+	Entry.Offset = Offset;
+	Entry.Flags = 0;
+	Offered.push_back(Entry);
+
+	return true;
+}
+
+
+//! Pass a list of recorded offers on to a given manager
+void IndexRecorder::Replay(const OfferedList &List, IndexManagerPtr &Manager)
+{
+	OfferedList::const_iterator it = List.begin();
+	while(it != List.end())
+	{
+		switch((*it).Type)
+		{
+		case OfferedEntry::EditUnit:
+			Manager->OfferEditUnit((*it).SubStream, (*it).Pos, (*it).Offset, (*it).Flags);
+			break;
+
+		case OfferedEntry::TemporalOffset:
+			Manager->OfferTemporalOffset((*it).Pos, (*it).Offset);
+			break;
+
+		case OfferedEntry::KeyOffset:
+			Manager->OfferKeyOffset((*it).Pos, (*it).Offset);
+			break;
+		}
+
+		it++;
+	}
+}
+
+
+//! Pass a list of recorded offers on to a given manager, with all edit units offered for a given sub-stream
+void IndexRecorder::Replay(const OfferedList &List, IndexManagerPtr &Manager, int SubStream)
+{
+	OfferedList::const_iterator it = List.begin();
+	while(it != List.end())
+	{
+		if((*it).Type == OfferedEntry::EditUnit) Manager->OfferEditUnit(SubStream, (*it).Pos, (*it).Offset, (*it).Flags);
+		else if((*it).Type == OfferedEntry::TemporalOffset) Manager->OfferTemporalOffset((*it).Pos, (*it).Offset);
+		else Manager->OfferKeyOffset((*it).Pos, (*it).Offset);
+
+		it++;
+	}
+}
+
+
+//! Construct a group with a given queue depth for each source and the index manager that the sources use
+PrefetchGroup::PrefetchGroup(unsigned int Depth, IndexManagerPtr &Manager)
+	: Depth(Depth ? Depth : 1), Manager(Manager), ThisRecorder(NULL), Waiters(0), Started(false), Stopping(false), Synchronous(false)
+{
+	if(Manager)
+	{
+		ThisRecorder = new IndexRecorder(Manager);
+		Recorder = ThisRecorder;
+	}
+}
+
+
+//! Add a source to this group
+EssenceSourcePtr PrefetchGroup::AddSource(EssenceSourcePtr &Source)
+{
+	PrefetchSource *NewSource = new PrefetchSource(this, Source);
+	EssenceSourcePtr Ret = NewSource;
+
+	Sources.push_back(NewSource);
+
+	// Any index entries offered while reading ahead are now recorded rather than going directly to the manager
+	// DRAGONS: Sub-streams from the same parser share its manager, but these will all report the same stream ID so it is safe to reset each
+	if(Recorder) Source->SetIndexManager(Recorder, Source->GetIndexStreamID());
+
+	return Ret;
+}
+
+
+//! Stop the worker thread, leaving any further reading to be done by the caller
+void PrefetchGroup::Stop(void)
+{
+	Lock.Lock();
+	Stopping = true;
+	Started = true;
+	Changed.Broadcast();
+	Lock.Unlock();
+
+	Join();
+
+	// DRAGONS: Only switch to synchronous reading once the worker has finished, or a waiting caller could read at the same time
+	Lock.Lock();
+	Synchronous = true;
+	Changed.Broadcast();
+	Lock.Unlock();
+}
+
+
+//! Read a single wrapping unit from a source into its queue
+void PrefetchGroup::ReadItem(PrefetchSource *Source)
+{
+	bool Threaded = !Synchronous;
+	if(Threaded) Lock.Unlock();
+
+	PrefetchSource::PrefetchItem Item;
+	Item.Data = Source->Inner->GetEssenceData();
+	Item.EndOfItem = Source->Inner->EndOfItem();
+	Item.EditPoint = Source->Inner->IsEditPoint();
+	Item.Pos = Source->Inner->GetCurrentPosition();
+
+	// Build the item in a list of its own so that it can be spliced into the queue without copying the recorded index entries
+	std::list<PrefetchSource::PrefetchItem> NewItem;
+	NewItem.push_back(Item);
+	if(ThisRecorder) ThisRecorder->TakeOffered(NewItem.back().Offered);
+
+	if(Threaded) Lock.Lock();
+
+	if(!Item.Data) Source->ReadEnded = true;
+
+	Source->Queue.splice(Source->Queue.end(), NewItem);
+	Source->QueueSize++;
+
+	Changed.Broadcast();
+}
+
+
+//! Read ahead on each source in turn until all are exhausted or we are stopped
+void PrefetchGroup::Run(void)
+{
+	MutexLock Locked(Lock);
+
+	for(;;)
+	{
+		bool Active = false;
+
+		std::vector<PrefetchSource*>::iterator it = Sources.begin();
+		while(it != Sources.end())
+		{
+			if(!(*it)->ReadEnded)
+			{
+				Active = true;
+
+				// Wait for space in this queue, unless the writer is waiting for data that we have not yet read
+				// DRAGONS: Allowing a queue to grow beyond the depth when the writer is waiting prevents a deadlock if the writer
+				//          does not take data from each source at the same rate, at the cost of extra memory use when it does not
+				while(!Stopping && ((*it)->QueueSize >= Depth) && (Waiters == 0)) Changed.Wait(Lock);
+
+				if(Stopping) return;
+
+				ReadItem(*it);
+			}
+
+			it++;
+		}
+
+		if(!Active) return;
+	}
+}
+
+
+//! Construct a source that supplies data from a given source, read ahead by a given group
+PrefetchSource::PrefetchSource(PrefetchGroup *Group, EssenceSourcePtr &Inner)
+	: Group(Group), Inner(Inner), QueueSize(0), ReadEnded(false), Offset(0), Replayed(false), LastEndOfItem(true), LastEditPoint(true)
+{
+	StreamID = Inner->GetStreamID();
+	IndexMan = Group->Manager;
+	IndexStreamID = Inner->GetIndexStreamID();
+	CurrentPos = Inner->GetCurrentPosition();
+}
+
+
+//! Wait until there is an item at the front of the queue
+PrefetchSource::PrefetchItem &PrefetchSource::WaitForItem(void)
+{
+	while(!QueueSize)
+	{
+		// If the worker is not running, read the data ourselves
+		if(Group->Synchronous)
+		{
+			Group->ReadItem(this);
+			break;
+		}
+
+		if(!Group->Started)
+		{
+			Group->Started = true;
+			if(!Group->Start())
+			{
+				warning("Unable to start essence prefetch thread - reading synchronously\n");
+				Group->Synchronous = true;
+			}
+
+			continue;
+		}
+
+		Group->Waiters++;
+		Group->Changed.Broadcast();
+		Group->Changed.Wait(Group->Lock);
+		Group->Waiters--;
+	}
+
+	return Queue.front();
+}
+
+
+//! Get the size of the next "installment" of essence data in bytes
+size_t PrefetchSource::GetEssenceDataSize(void)
+{
+	MutexLock Locked(Group->Lock);
+
+	PrefetchItem &Item = WaitForItem();
+	if(!Item.Data) return 0;
+
+	return Item.Data->Size - Offset;
+}
+
+
+//! Get the next "installment" of essence data
+/*! \note The requested Size is ignored as the data has already been read in whole wrapping units */
+DataChunkPtr PrefetchSource::GetEssenceData(size_t Size /*=0*/, size_t MaxSize /*=0*/)
+{
+	MutexLock Locked(Group->Lock);
+
+	PrefetchItem &Item = WaitForItem();
+
+	// Pass on any index entries offered while reading this item, now that the writer has reached it
+	if(!Replayed)
+	{
+		if(IndexMan) IndexRecorder::Replay(Item.Offered, IndexMan);
+		Replayed = true;
+	}
+
+	// The end marker stays at the front of the queue
+	if(!Item.Data) return NULL;
+
+	size_t Remaining = Item.Data->Size - Offset;
+
+	// Split the item if it is too big
+	if(MaxSize && (Remaining > MaxSize))
+	{
+		DataChunkPtr Ret = Item.Data->Slice(Offset, MaxSize);
+		Offset += MaxSize;
+		LastEndOfItem = false;
+
+		return Ret;
+	}
+
+	DataChunkPtr Ret;
+	if(Offset == 0) Ret = Item.Data;
+	else Ret = Item.Data->Slice(Offset, Remaining);
+
+	LastEndOfItem = Item.EndOfItem;
+	LastEditPoint = Item.EditPoint;
+	CurrentPos = Item.Pos;
+
+	Queue.pop_front();
+	QueueSize--;
+	Offset = 0;
+	Replayed = false;
+
+	// Let the worker know there is space in the queue
+	Group->Changed.Broadcast();
+
+	return Ret;
+}
+
+
+//! Is all data exhasted?
+bool PrefetchSource::EndOfData(void)
+{
+	MutexLock Locked(Group->Lock);
+
+	return !WaitForItem().Data;
+}
+
+
+//! Construct a tee for a given source
+EssenceTee::EssenceTee(EssenceSourcePtr &Source, unsigned int Depth /*=8*/, Mutex *ReadLock /*=NULL*/)
+	: ReadLock(ReadLock), Source(Source), Depth(Depth ? Depth : 1), FirstItem(0), ItemCount(0), Reading(false), ReadEnded(false), ThisRecorder(NULL)
+{
+}
+
+
+//! Add a branch, which must be read by a writer to allow the other branches to progress
+EssenceSourcePtr EssenceTee::AddBranch(void)
+{
+	TeeSource *NewBranch = new TeeSource(this, Source);
+	EssenceSourcePtr Ret = NewBranch;
+
+	MutexLock Locked(Lock);
+
+	// DRAGONS: The source itself is never given to a writer, so its digest will not also receive the data
+	if(Branches.empty()) NewBranch->SetDigest(Source->GetDigest());
+
+	NewBranch->NextItem = FirstItem;
+	Branches.push_back(NewBranch);
+
+	return Ret;
+}
+
+
+//! Wait until a given item has been read, reading it if no other branch is doing so
+EssenceTee::TeeItem &EssenceTee::WaitForItem(Position Item)
+{
+	while(Item >= ItemCount)
+	{
+		// Wait for any read in progress, or for the slowest branch if we are too far ahead of it
+		if(Reading || ((ItemCount - FirstItem) >= static_cast<Position>(Depth)))
+		{
+			Changed.Wait(Lock);
+			continue;
+		}
+
+		Reading = true;
+		Lock.Unlock();
+
+		if(ReadLock) ReadLock->Lock();
+
+		std::list<TeeItem> NewItem;
+		NewItem.resize(1);
+		TeeItem &ThisItem = NewItem.back();
+		ThisItem.Data = Source->GetEssenceData();
+		ThisItem.EndOfItem = Source->EndOfItem();
+		ThisItem.EditPoint = Source->IsEditPoint();
+		ThisItem.Pos = Source->GetCurrentPosition();
+		if(ThisRecorder) ThisRecorder->TakeOffered(ThisItem.Offered);
+
+		if(ReadLock) ReadLock->Unlock();
+
+		Lock.Lock();
+
+		if(!ThisItem.Data) ReadEnded = true;
+
+		Queue.splice(Queue.end(), NewItem);
+		ItemCount++;
+		Reading = false;
+
+		Changed.Broadcast();
+	}
+
+	std::list<TeeItem>::iterator it = Queue.begin();
+	Position Count = Item - FirstItem;
+	while(Count--) it++;
+
+	return *it;
+}
+
+
+//! Drop any items from the front of the queue that have been taken by every branch
+void EssenceTee::Trim(void)
+{
+	Position Slowest = ItemCount;
+	std::list<TeeSource*>::iterator it = Branches.begin();
+	while(it != Branches.end())
+	{
+		if((*it)->NextItem < Slowest) Slowest = (*it)->NextItem;
+		it++;
+	}
+
+	// The end marker is never taken, so is never dropped
+	while((FirstItem < Slowest) && Queue.front().Data)
+	{
+		Queue.pop_front();
+		FirstItem++;
+	}
+}
+
+
+//! Remove a branch that is being destroyed, so that it no longer holds back the others
+void EssenceTee::RemoveBranch(TeeSource *Branch)
+{
+	MutexLock Locked(Lock);
+
+	Branches.remove(Branch);
+	Trim();
+
+	Changed.Broadcast();
+}
+
+
+//! Set the index manager for a branch, recording the source's index offers so that they can be passed to each branch
+void EssenceTee::SetBranchIndexManager(IndexManagerPtr &Manager, int StreamID)
+{
+	MutexLock Locked(Lock);
+	LockSource();
+
+	// Let the source set up the new manager as it requires, then have it offer its entries to the recorder
+	// DRAGONS: Any later calls that the source makes to the recorder's target, rather than offers, only reach the first manager set
+	Source->SetIndexManager(Manager, StreamID);
+
+	if(!Recorder)
+	{
+		ThisRecorder = new IndexRecorder(Manager);
+		Recorder = ThisRecorder;
+	}
+
+	Source->SetIndexManager(Recorder, StreamID);
+
+	UnlockSource();
+}
+
+
+//! Wait until no branch is reading the source, then take the read lock (if any) so that the source can be changed
+void EssenceTee::LockSource(void)
+{
+	while(Reading) Changed.Wait(Lock);
+
+	if(ReadLock) ReadLock->Lock();
+}
+
+
+//! Construct a branch of a given tee
+TeeSource::TeeSource(EssenceTee *Tee, EssenceSourcePtr &Inner)
+	: Tee(Tee), Inner(Inner), NextItem(0), Offset(0), Replayed(false), LastEndOfItem(true), LastEditPoint(true)
+{
+	StreamID = Inner->GetStreamID();
+	IndexStreamID = Inner->GetIndexStreamID();
+	CurrentPos = Inner->GetCurrentPosition();
+
+	SpecifiedKey = Inner->GetKey();
+	NonGC = Inner->GetNonGC();
+	EssenceDescriptor = Inner->GetDescriptor();
+}
+
+
+//! Set the index manager to use for building index tables for this branch
+void TeeSource::SetIndexManager(IndexManagerPtr &Manager, int StreamID)
+{
+	EssenceSource::SetIndexManager(Manager, StreamID);
+
+	if(Manager && Inner->CanIndex()) Tee->SetBranchIndexManager(Manager, StreamID);
+}
+
+
+//! Set a source type or parser specific option on the original source, which affects all branches
+bool TeeSource::SetOption(std::string Option, Int64 Param /*=0*/)
+{
+	MutexLock Locked(Tee->Lock);
+	Tee->LockSource();
+
+	bool Ret = Inner->SetOption(Option, Param);
+
+	Tee->UnlockSource();
+	return Ret;
+}
+
+
+//! Enable VBR indexing in the original source, which affects all branches
+bool TeeSource::EnableVBRIndexMode(void)
+{
+	MutexLock Locked(Tee->Lock);
+	Tee->LockSource();
+
+	bool Ret = Inner->EnableVBRIndexMode();
+
+	Tee->UnlockSource();
+	return Ret;
+}
+
+
+//! Get the size of the next "installment" of essence data in bytes
+size_t TeeSource::GetEssenceDataSize(void)
+{
+	MutexLock Locked(Tee->Lock);
+
+	EssenceTee::TeeItem &Item = Tee->WaitForItem(NextItem);
+	if(!Item.Data) return 0;
+
+	return Item.Data->Size - Offset;
+}
+
+
+//! Get the next "installment" of essence data
+/*! \note The requested Size is ignored as the data has already been read in whole wrapping units */
+DataChunkPtr TeeSource::GetEssenceData(size_t Size /*=0*/, size_t MaxSize /*=0*/)
+{
+	MutexLock Locked(Tee->Lock);
+
+	EssenceTee::TeeItem &Item = Tee->WaitForItem(NextItem);
+
+	// Pass on any index entries offered while reading this item, as this branch's sub-stream
+	if(!Replayed)
+	{
+		if(IndexMan) IndexRecorder::Replay(Item.Offered, IndexMan, IndexStreamID);
+		Replayed = true;
+	}
+
+	// The end marker is never passed
+	if(!Item.Data) return NULL;
+
+	size_t Remaining = Item.Data->Size - Offset;
+
+	// Split the item if it is too big
+	if(MaxSize && (Remaining > MaxSize))
+	{
+		DataChunkPtr Ret = Item.Data->Slice(Offset, MaxSize);
+		Offset += MaxSize;
+		LastEndOfItem = false;
+
+		return Ret;
+	}
+
+	// DRAGONS: The whole item is shared with the other branches rather than copied
+	DataChunkPtr Ret;
+	if(Offset == 0) Ret = Item.Data;
+	else Ret = Item.Data->Slice(Offset, Remaining);
+
+	LastEndOfItem = Item.EndOfItem;
+	LastEditPoint = Item.EditPoint;
+	CurrentPos = Item.Pos;
+
+	NextItem++;
+	Offset = 0;
+	Replayed = false;
+
+	// Let any branch waiting for us to catch up know that we have moved on
+	Tee->Trim();
+	Tee->Changed.Broadcast();
+
+	return Ret;
+}
+
+
+//! Is all data exhasted?
+bool TeeSource::EndOfData(void)
+{
+	MutexLock Locked(Tee->Lock);
+
+	return !Tee->WaitForItem(NextItem).Data;
+}
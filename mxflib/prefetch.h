@@ -0,0 +1,425 @@
+/*! \file	prefetch.h
+ *	\brief	Definition of classes that read essence ahead of the writer on a background thread
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A PrefetchGroup runs the essence sources of one BodyStream on a worker thread, queuing a
+ *  bounded number of wrapping units per source. Each source is replaced in the stream by a
+ *  PrefetchSource that hands the queued data to the BodyWriter in exactly the order it would
+ *  have been read, so the multiplex is unchanged. Any index entries offered by a source while
+ *  it is being read ahead are recorded and only passed to the real IndexManager when the
+ *  matching data is taken, so index tables are built exactly as they would be without prefetch.
+ *
+ *  An EssenceTee shares the data read from one essence source between several TeeSources, each
+ *  of which may be given to a different BodyWriter running on its own thread. The source is only
+ *  read and parsed once, with each wrapping unit held in a shared DataChunk until every branch
+ *  has taken it.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__PREFETCH_H
+#define MXFLIB__PREFETCH_H
+
+namespace mxflib
+{
+	//! An IndexManager that records the entries offered to it so they can be passed on to another manager later
+	/*! Only the "Offer" calls made by essence parsers while reading are recorded, anything else is either
+	 *  forwarded to the target manager or handled by this (otherwise unused) manager.
+	 */
+	class IndexRecorder : public IndexManager
+	{
+	public:
+		//! A single recorded offer
+		struct OfferedEntry
+		{
+			enum OfferType { EditUnit, TemporalOffset, KeyOffset };
+
+			OfferType Type;						//!< Which offer this was
+			int SubStream;						//!< Sub-stream ID for an edit unit offer
+			Position Pos;						//!< The edit unit offered
+			int Offset;							//!< The key offset of an edit unit, or the offset for other offers
+			int Flags;							//!< Flags for an edit unit offer
+		};
+
+		//! List of recorded offers, in the order they were made
+		typedef std::list<OfferedEntry> OfferedList;
+
+	protected:
+		IndexManagerPtr Target;					//!< The manager that will eventually receive the offers
+		OfferedList Offered;					//!< Offers recorded since the last call to TakeOffered()
+
+	public:
+		//! Construct a recorder for a given target manager
+		IndexRecorder(IndexManagerPtr &Target) : IndexManager(0, 0), Target(Target) {}
+
+		//! Record an offered edit unit
+		virtual bool OfferEditUnit(int SubStream, Position EditUnit, int KeyOffset = 0, int Flags = -1);
+
+		//! Record an offered temporal offset
+		virtual bool OfferTemporalOffset(Position EditUnit, int Offset);
+
+		//! Record an offered key-frame offset
+		virtual bool OfferKeyOffset(Position EditUnit, int Offset);
+
+		//! Update the PosTableIndex for a given stream in the target manager
+		virtual void SetPosTableIndex(int StreamID, int PosTableIndex) { Target->SetPosTableIndex(StreamID, PosTableIndex); }
+
+		//! Move all offers recorded so far to the end of a given list
+		void TakeOffered(OfferedList &List) { List.splice(List.end(), Offered); }
+
+		//! Pass a list of recorded offers on to a given manager
+		static void Replay(const OfferedList &List, IndexManagerPtr &Manager);
+
+		//! Pass a list of recorded offers on to a given manager, with all edit units offered for a given sub-stream
+		static void Replay(const OfferedList &List, IndexManagerPtr &Manager, int SubStream);
+	};
+}
+
+
+namespace mxflib
+{
+	// Forward declare the prefetch source class
+	class PrefetchSource;
+
+	//! A group of essence sources that are read ahead, in turn, by a single worker thread
+	/*! The sources of a BodyStream may share a single parser (and a single file), so all sources within a
+	 *  stream are read by the same thread in the same order as the BodyWriter would read them.
+	 *  \note The worker thread is started when data is first requested, and may be stopped at any time
+	 *        with Stop(), after which any remaining data is read directly by the caller
+	 */
+	class PrefetchGroup : public RefCount<PrefetchGroup>, protected Thread
+	{
+	protected:
+		Mutex Lock;								//!< Lock protecting all queues of this group
+		Condition Changed;						//!< Signalled whenever a queue changes or we are stopping
+		unsigned int Depth;						//!< Number of wrapping units to queue for each source before waiting
+		IndexManagerPtr Manager;				//!< The index manager for the stream, or NULL if not indexed
+		IndexManagerPtr Recorder;				//!< The recorder that collects index offers while reading ahead
+		IndexRecorder *ThisRecorder;			//!< Recorder, as its real type
+		std::vector<PrefetchSource*> Sources;	//!< The sources we read, in the order they are read
+		int Waiters;							//!< Number of callers waiting for data
+		bool Started;							//!< True once we have attempted to start the worker thread
+		bool Stopping;							//!< Set to request the worker thread to stop
+		bool Synchronous;						//!< True if data is to be read directly by the caller rather than the worker
+
+		friend class PrefetchSource;
+
+	public:
+		//! Construct a group with a given queue depth for each source and the index manager that the sources use
+		PrefetchGroup(unsigned int Depth, IndexManagerPtr &Manager);
+
+		//! Stop the worker thread before destruction
+		~PrefetchGroup() { Stop(); }
+
+		//! Add a source to this group
+		/*! \return The source to use in place of the given source */
+		EssenceSourcePtr AddSource(EssenceSourcePtr &Source);
+
+		//! Stop the worker thread, leaving any further reading to be done by the caller
+		void Stop(void);
+
+	protected:
+		//! Read a single wrapping unit from a source into its queue
+		/*! \note Called with the lock held, but the lock is released during the read if the worker thread is running */
+		void ReadItem(PrefetchSource *Source);
+
+		//! Read ahead on each source in turn until all are exhausted or we are stopped
+		virtual void Run(void);
+
+	private:
+		//! Prevent copy construction
+		PrefetchGroup(const PrefetchGroup &);
+	};
+
+	//! Smart pointer to a PrefetchGroup
+	typedef SmartPtr<PrefetchGroup> PrefetchGroupPtr;
+
+	//! List of smart pointers to PrefetchGroups
+	typedef std::list<PrefetchGroupPtr> PrefetchGroupList;
+
+
+	//! An essence source that supplies data read ahead from another source by a PrefetchGroup
+	/*! Static properties of the essence are passed straight through to the original source.
+	 *  \note Only frame wrapped streams without pre-charge or system items are suitable for prefetching
+	 */
+	class PrefetchSource : public EssenceSource
+	{
+	protected:
+		//! A wrapping unit read from the original source, with the state of the source immediately after reading it
+		struct PrefetchItem
+		{
+			DataChunkPtr Data;					//!< The data read, or NULL at the end of the data
+			bool EndOfItem;						//!< Result of EndOfItem() after the read
+			bool EditPoint;						//!< Result of IsEditPoint() after the read
+			Position Pos;						//!< Result of GetCurrentPosition() after the read
+			IndexRecorder::OfferedList Offered;	//!< Index entries offered while reading
+		};
+
+		PrefetchGroupPtr Group;					//!< The group that reads ahead for us
+		EssenceSourcePtr Inner;					//!< The original source
+		std::list<PrefetchItem> Queue;			//!< Items read but not yet taken
+		unsigned int QueueSize;					//!< Number of items in Queue
+		bool ReadEnded;							//!< True once the end of data has been queued
+		size_t Offset;							//!< Number of bytes of the front item already returned (if split by MaxSize)
+		bool Replayed;							//!< True if the index offers of the front item have been replayed
+		bool LastEndOfItem;						//!< Value to return from EndOfItem()
+		bool LastEditPoint;						//!< Value to return from IsEditPoint()
+		Position CurrentPos;					//!< Value to return from GetCurrentPosition()
+
+		friend class PrefetchGroup;
+
+	public:
+		//! Construct a source that supplies data from a given source, read ahead by a given group
+		PrefetchSource(PrefetchGroup *Group, EssenceSourcePtr &Inner);
+
+		//! Ensure the worker thread is no longer using us
+		~PrefetchSource() { Group->Stop(); }
+
+		//! Get the size of the next "installment" of essence data in bytes
+		virtual size_t GetEssenceDataSize(void);
+
+		//! Get the next "installment" of essence data
+		virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0);
+
+		//! Did the last call to GetEssenceData() return the end of a wrapping item
+		virtual bool EndOfItem(void) { return LastEndOfItem; }
+
+		//! Is all data exhasted?
+		virtual bool EndOfData(void);
+
+		//! Is the last data read the start of an edit point?
+		virtual bool IsEditPoint(void) { return LastEditPoint; }
+
+		//! Get the current position in GetEditRate() sized edit units
+		virtual Position GetCurrentPosition(void) { return CurrentPos; }
+
+		// Everything else is a static property of the original source
+
+		virtual DataChunk *GetPadding(void) { return Inner->GetPadding(); }
+		virtual UInt8 GetGCEssenceType(void) { return Inner->GetGCEssenceType(); }
+		virtual UInt8 GetGCElementType(void) { return Inner->GetGCElementType(); }
+		virtual Rational GetEditRate(void) { return Inner->GetEditRate(); }
+		virtual int GetBERSize(void) { return Inner->GetBERSize(); }
+		virtual UInt32 GetBytesPerEditUnit(UInt32 KAGSize = 1) { return Inner->GetBytesPerEditUnit(KAGSize); }
+		virtual bool CanIndex() { return Inner->CanIndex(); }
+		virtual int GetIndexStreamID(void) { return Inner->GetIndexStreamID(); }
+		virtual void SetKey(DataChunkPtr &Key, bool NonGC = false) { Inner->SetKey(Key, NonGC); }
+		virtual DataChunkPtr &GetKey(void) { return Inner->GetKey(); }
+		virtual bool GetNonGC(void) { return Inner->GetNonGC(); }
+		virtual bool IsSystemItem(void) { return Inner->IsSystemItem(); }
+		virtual bool IsPictureEssence(void) { return Inner->IsPictureEssence(); }
+		virtual bool IsSoundEssence(void) { return Inner->IsSoundEssence(); }
+		virtual bool IsDataEssence(void) { return Inner->IsDataEssence(); }
+		virtual bool IsCompoundEssence(void) { return Inner->IsCompoundEssence(); }
+		virtual Int32 RelativeWriteOrder(void) { return Inner->RelativeWriteOrder(); }
+		virtual int RelativeWriteOrderType(void) { return Inner->RelativeWriteOrderType(); }
+		virtual Length GetPrechargeSize(void) { return Inner->GetPrechargeSize(); }
+		virtual Position GetRangeStart(void) { return Inner->GetRangeStart(); }
+		virtual Position GetRangeEnd(void) { return Inner->GetRangeEnd(); }
+		virtual Length GetRangeDuration(void) { return Inner->GetRangeDuration(); }
+		virtual std::string Name(void) { return "Prefetched " + Inner->Name(); }
+		virtual void SetDescriptor(MDObjectPtr Descriptor) { Inner->SetDescriptor(Descriptor); }
+		virtual MDObjectPtr GetDescriptor(void) { return Inner->GetDescriptor(); }
+
+	protected:
+		//! Wait until there is an item at the front of the queue
+		/*! \note Called with the group lock held */
+		PrefetchItem &WaitForItem(void);
+
+	private:
+		//! Prevent copy construction
+		PrefetchSource(const PrefetchSource &);
+	};
+}
+
+
+namespace mxflib
+{
+	// Forward declare the tee branch class
+	class TeeSource;
+
+	//! Shares the data read from one essence source between a number of branches, each used by a different writer
+	/*! Each wrapping unit is read from the source once, by whichever branch first needs it, and is held in a shared
+	 *  DataChunk until every branch has taken it. A branch that gets Depth wrapping units ahead of the slowest branch
+	 *  waits for it to catch up, so the memory used is bounded.
+	 *  \note The writers using the branches must each run on their own thread, or the fastest would wait forever
+	 *  \note The shared data must not be modified by the writers
+	 */
+	class EssenceTee : public RefCount<EssenceTee>
+	{
+	protected:
+		//! A wrapping unit read from the source, with the state of the source immediately after reading it
+		struct TeeItem
+		{
+			DataChunkPtr Data;					//!< The data read, or NULL at the end of the data
+			bool EndOfItem;						//!< Result of EndOfItem() after the read
+			bool EditPoint;						//!< Result of IsEditPoint() after the read
+			Position Pos;						//!< Result of GetCurrentPosition() after the read
+			IndexRecorder::OfferedList Offered;	//!< Index entries offered while reading
+		};
+
+		Mutex Lock;								//!< Lock protecting the queue and all branches
+		Condition Changed;						//!< Signalled whenever the queue changes or a branch moves on
+		Mutex *ReadLock;						//!< Lock held while reading the source, if it shares a parser with other tees, else NULL
+		EssenceSourcePtr Source;				//!< The source being shared
+		unsigned int Depth;						//!< Number of wrapping units a branch may get ahead of the slowest branch
+		std::list<TeeItem> Queue;				//!< Items read that have not yet been taken by every branch
+		Position FirstItem;						//!< The number of the item at the front of the queue
+		Position ItemCount;						//!< The number of items read so far
+		bool Reading;							//!< True while a branch is reading the source with the lock released
+		bool ReadEnded;							//!< True once the end of data has been queued
+		IndexManagerPtr Recorder;				//!< The recorder that collects index offers from the source, or NULL if not yet needed
+		IndexRecorder *ThisRecorder;			//!< Recorder, as its real type
+		std::list<TeeSource*> Branches;			//!< The branches that share the source
+
+		friend class TeeSource;
+
+	public:
+		//! Construct a tee for a given source
+		/*! \param Source The source to share
+		 *  \param Depth The number of wrapping units that a branch may get ahead of the slowest branch
+		 *  \param ReadLock A lock to hold while reading the source, for sources that share a parser or file with other tees, or NULL
+		 */
+		EssenceTee(EssenceSourcePtr &Source, unsigned int Depth = 8, Mutex *ReadLock = NULL);
+
+		//! Add a branch, which must be read by a writer to allow the other branches to progress
+		/*! Any digest set on the source is also given to the first branch added, so the essence is digested once
+		 *  \note All branches must be added before any data is read
+		 */
+		EssenceSourcePtr AddBranch(void);
+
+	protected:
+		//! Wait until a given item has been read, reading it if no other branch is doing so
+		/*! \note Called with the lock held, but the lock is released during the read */
+		TeeItem &WaitForItem(Position Item);
+
+		//! Drop any items from the front of the queue that have been taken by every branch
+		/*! \note Called with the lock held */
+		void Trim(void);
+
+		//! Remove a branch that is being destroyed, so that it no longer holds back the others
+		void RemoveBranch(TeeSource *Branch);
+
+		//! Set the index manager for a branch, recording the source's index offers so that they can be passed to each branch
+		void SetBranchIndexManager(IndexManagerPtr &Manager, int StreamID);
+
+		//! Wait until no branch is reading the source, then take the read lock (if any) so that the source can be changed
+		/*! \note Called with the lock held, which must then be kept until UnlockSource() is called */
+		void LockSource(void);
+
+		//! Release the read lock taken by LockSource()
+		void UnlockSource(void) { if(ReadLock) ReadLock->Unlock(); }
+
+	private:
+		//! Prevent copy construction
+		EssenceTee(const EssenceTee &);
+	};
+
+	//! Smart pointer to an EssenceTee
+	typedef SmartPtr<EssenceTee> EssenceTeePtr;
+
+
+	//! An essence source that supplies a copy of the data read from another source by an EssenceTee
+	/*! Static properties of the essence are passed straight through to the original source, except for the key and
+	 *  descriptor which start as those of the original source but may be changed for each branch.
+	 *  \note Only frame wrapped streams are suitable for sharing, as the data is held in whole wrapping units
+	 */
+	class TeeSource : public EssenceSource
+	{
+	protected:
+		EssenceTeePtr Tee;						//!< The tee that reads the source for us
+		EssenceSourcePtr Inner;					//!< The original source
+		Position NextItem;						//!< The number of the next item to take from the tee
+		size_t Offset;							//!< Number of bytes of the next item already returned (if split by MaxSize)
+		bool Replayed;							//!< True if the index offers of the next item have been replayed
+		bool LastEndOfItem;						//!< Value to return from EndOfItem()
+		bool LastEditPoint;						//!< Value to return from IsEditPoint()
+		Position CurrentPos;					//!< Value to return from GetCurrentPosition()
+
+		friend class EssenceTee;
+
+	public:
+		//! Construct a branch of a given tee
+		TeeSource(EssenceTee *Tee, EssenceSourcePtr &Inner);
+
+		//! Let the tee know that we no longer hold back the other branches
+		~TeeSource() { Tee->RemoveBranch(this); }
+
+		//! Get the size of the next "installment" of essence data in bytes
+		virtual size_t GetEssenceDataSize(void);
+
+		//! Get the next "installment" of essence data
+		virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0);
+
+		//! Did the last call to GetEssenceData() return the end of a wrapping item
+		virtual bool EndOfItem(void) { return LastEndOfItem; }
+
+		//! Is all data exhasted?
+		virtual bool EndOfData(void);
+
+		//! Is the last data read the start of an edit point?
+		virtual bool IsEditPoint(void) { return LastEditPoint; }
+
+		//! Get the current position in GetEditRate() sized edit units
+		virtual Position GetCurrentPosition(void) { return CurrentPos; }
+
+		//! Set the index manager to use for building index tables for this branch
+		virtual void SetIndexManager(IndexManagerPtr &Manager, int StreamID);
+
+		//! Set a source type or parser specific option on the original source, which affects all branches
+		virtual bool SetOption(std::string Option, Int64 Param = 0);
+
+		//! Enable VBR indexing in the original source, which affects all branches
+		virtual bool EnableVBRIndexMode(void);
+
+		// Everything else is a static property of the original source
+
+		virtual DataChunk *GetPadding(void) { return Inner->GetPadding(); }
+		virtual UInt8 GetGCEssenceType(void) { return Inner->GetGCEssenceType(); }
+		virtual UInt8 GetGCElementType(void) { return Inner->GetGCElementType(); }
+		virtual Rational GetEditRate(void) { return Inner->GetEditRate(); }
+		virtual int GetBERSize(void) { return Inner->GetBERSize(); }
+		virtual UInt32 GetBytesPerEditUnit(UInt32 KAGSize = 1) { return Inner->GetBytesPerEditUnit(KAGSize); }
+		virtual bool CanIndex() { return Inner->CanIndex(); }
+		virtual bool IsSystemItem(void) { return Inner->IsSystemItem(); }
+		virtual bool IsPictureEssence(void) { return Inner->IsPictureEssence(); }
+		virtual bool IsSoundEssence(void) { return Inner->IsSoundEssence(); }
+		virtual bool IsDataEssence(void) { return Inner->IsDataEssence(); }
+		virtual bool IsCompoundEssence(void) { return Inner->IsCompoundEssence(); }
+		virtual Int32 RelativeWriteOrder(void) { return Inner->RelativeWriteOrder(); }
+		virtual int RelativeWriteOrderType(void) { return Inner->RelativeWriteOrderType(); }
+		virtual Length GetPrechargeSize(void) { return Inner->GetPrechargeSize(); }
+		virtual Position GetRangeStart(void) { return Inner->GetRangeStart(); }
+		virtual Position GetRangeEnd(void) { return Inner->GetRangeEnd(); }
+		virtual Length GetRangeDuration(void) { return Inner->GetRangeDuration(); }
+		virtual std::string Name(void) { return "Shared " + Inner->Name(); }
+
+	private:
+		//! Prevent copy construction
+		TeeSource(const TeeSource &);
+	};
+}
+
+#endif // MXFLIB__PREFETCH_H
@@ -179,6 +179,63 @@ Tag Primer::Lookup(ULPtr ItemUL, Tag TryTag /*=0*/)
 }
 
 
+//! Determine if a tag may be used for a given UL without conflicting with the entries in this primer
+/*! \return true if the tag is already used for this UL, or neither the tag nor the UL are yet in this primer
+ */
+bool Primer::CanUse(const UL &ItemUL, Tag ThisTag) const
+{
+	Primer::const_iterator it = find(ThisTag);
+	if(it != end()) return (*it).second == ItemUL;
+
+	return TagLookup.find(ItemUL) == TagLookup.end();
+}
+
+
+//! Make a copy of this primer, which may then be used independently (such as on another thread)
+PrimerPtr Primer::MakeCopy(void) const
+{
+	PrimerPtr Ret = new Primer;
+
+	Ret->Primer_Root::operator=(*this);
+	Ret->TagLookup = TagLookup;
+	Ret->NextDynamic = NextDynamic;
+
+	return Ret;
+}
+
+
+//! Locate the UL and type for a given tag
+/*! \return NULL if the tag is not in this primer
+ */
+const Primer::TagType *Primer::LookupType(Tag ThisTag)
+{
+	// Discard the cache if types have been added or removed since it was built
+	UInt32 Generation = MDOType::GetLookupGeneration();
+	if(Generation != TypeCacheGeneration)
+	{
+		TypeCache.clear();
+		TypeCacheGeneration = Generation;
+	}
+
+	if(TypeCache.empty()) TypeCache.resize(256);
+	
+	std::vector<TagType> &Page = TypeCache[ThisTag >> 8];
+	if(Page.empty()) Page.resize(256);
+
+	TagType &Entry = Page[ThisTag & 0xff];
+	if(!Entry.TypeUL)
+	{
+		Primer::iterator it = find(ThisTag);
+		if(it == end()) return NULL;
+
+		Entry.TypeUL = new UL((*it).second);
+		Entry.Type = MDOType::Find(Entry.TypeUL);
+	}
+
+	return &Entry;
+}
+
+
 //! Write this primer to a memory buffer
 /*! The primer will be <b>appended</b> to the DataChunk */
 UInt32 Primer::WritePrimer(DataChunkPtr &Buffer)
@@ -62,7 +62,23 @@ namespace mxflib
 		std::map<UL, Tag> TagLookup;			//! Reverse lookup for locating a tag for a given UL
 
 	public:
-		Primer() { NextDynamic = 0xffff; };
+		//! The cached result of looking up the definition for a tag in this primer
+		struct TagType
+		{
+			ULPtr TypeUL;						//!< The UL for this tag, as given in the primer (NULL if not yet looked up)
+			MDOTypePtr Type;					//!< The type with this UL, or NULL if there is no such type
+		};
+
+	protected:
+		//! Cache of tag lookups, as 256 pages of 256 tags, with each page left empty until a tag in it is looked up
+		/*! DRAGONS: Entries are only added for tags that are in the primer, and tags are never removed other than by clear(),
+		 *           so the cache only needs to be discarded when the primer is cleared or the loaded types change
+		 */
+		std::vector<std::vector<TagType> > TypeCache;
+		UInt32 TypeCacheGeneration;				//! The value of MDOType::GetLookupGeneration() when TypeCache was built
+
+	public:
+		Primer() { NextDynamic = 0xffff; TypeCacheGeneration = 0; };
 		UInt32 ReadValue(const UInt8 *Buffer, UInt32 Size);
 
 		//! Write this primer to a memory buffer
@@ -74,6 +90,26 @@ namespace mxflib
 		//! Determine the tag to use for a given UL - when no primer is availabe
 		static Tag StaticLookup(ULPtr ItemUL, Tag TryTag = 0);
 
+		//! Determine if a tag may be used for a given UL without conflicting with the entries in this primer
+		/*! \return true if the tag is already used for this UL, or neither the tag nor the UL are yet in this primer */
+		bool CanUse(const UL &ItemUL, Tag ThisTag) const;
+
+		//! Make a copy of this primer, which may then be used independently (such as on another thread)
+		PrimerPtr MakeCopy(void) const;
+
+		//! Locate the UL and type for a given tag
+		/*! The first lookup of each tag is cached so that local sets sharing this primer only need a direct indexed lookup for each property
+		 *  \return NULL if the tag is not in this primer
+		 */
+		const TagType *LookupType(Tag ThisTag);
+
+		//! Remove all entries
+		void clear(void)
+		{
+			TypeCache.clear();
+			Primer_Root::clear();
+		}
+
 		//! Insert a new child type
 		std::pair<iterator, bool> insert(value_type Val) 
 		{ 
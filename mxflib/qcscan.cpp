@@ -0,0 +1,578 @@
+/*! \file	qcscan.cpp
+ *	\brief	Implementation of a class that checks the structure and index tables of an MXF file on several threads
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#include "mxflib/mxflib.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The number of edit units of an index table checked by each task
+	const Length IndexCheckChunk = 65536;
+
+	//! The largest number of mismatched entries of each index table given as findings, the rest are only counted
+	const size_t MaxIndexFindings = 16;
+
+	//! The highest stream offset, used to find the last essence KLV starting at or before an offset
+	const Position MaxPosition = UINT64_C(0x7fffffffffffffff);
+
+	//! Determine if a key is a KLV filler key
+	bool IsFillerKey(const UInt8 *Key)
+	{
+		// DRAGONS: The version byte of the filler key varies, so is not compared
+		return (memcmp(Key, KLVFill_UL_Data, 7) == 0) && (memcmp(&Key[8], &KLVFill_UL_Data[8], 8) == 0);
+	}
+
+	//! Determine if a key is that of a header, body or footer partition pack, rather than another pack of the same family such as the primer
+	bool IsPartitionPackKey(const UInt8 *Key)
+	{
+		return IsPartitionKey(Key) && (Key[13] >= 0x02) && (Key[13] <= 0x04);
+	}
+
+	//! Determine if a key is a Generic Container element key, including system items and encrypted triplets
+	bool IsGCElementKey(const UInt8 *Key)
+	{
+		static const UInt8 Prefix[4] = { 0x06, 0x0e, 0x2b, 0x34 };
+		static const UInt8 GCItem[4] = { 0x0d, 0x01, 0x03, 0x01 };
+		return (memcmp(Key, Prefix, 4) == 0) && (memcmp(&Key[8], GCItem, 4) == 0);
+	}
+
+	//! Format a file offset for a finding
+	std::string OffsetString(Position Offset)
+	{
+		return "0x" + Int64toHexString(Offset, 8);
+	}
+
+	//! Order findings by file offset, with those of unknown offset first
+	bool FindingBefore(const QCFinding &Left, const QCFinding &Right)
+	{
+		return Left.Offset < Right.Offset;
+	}
+}
+
+
+namespace mxflib
+{
+	//! A task, run by the shared executor, that walks the KLVs of one partition for a QCScanner
+	class QCPartitionTask : public Task
+	{
+	protected:
+		QCScanner *Owner;							//!< The scanner we work for
+		QCScanner::PartitionScan &Part;				//!< The partition to walk
+
+	public:
+		QCPartitionTask(QCScanner *Owner, QCScanner::PartitionScan &Part) : Owner(Owner), Part(Part) {}
+
+		void Run(void) { Owner->ScanPartition(Part); }
+	};
+
+
+	//! A task, run by the shared executor, that checks a range of edit units of an index table for a QCScanner
+	class QCIndexTask : public Task
+	{
+	protected:
+		QCScanner *Owner;							//!< The scanner we work for
+		QCScanner::IndexCheck &Check;				//!< The index table being checked
+		Position First;								//!< The first edit unit to check
+		Position Last;								//!< The edit unit following the last to check
+
+	public:
+		QCIndexTask(QCScanner *Owner, QCScanner::IndexCheck &Check, Position First, Position Last) : Owner(Owner), Check(Check), First(First), Last(Last) {}
+
+		void Run(void) { Owner->CheckIndexRange(Check, First, Last); }
+	};
+
+
+	//! A header-only read handler that checks each KLV of a partition as it is walked
+	class QCScanHandler : public GCReadHandler_Base
+	{
+	protected:
+		QCScanner::PartitionScan &Part;				//!< The partition being walked
+
+	public:
+		QCScanHandler(QCScanner::PartitionScan &Part) : Part(Part) {}
+
+		bool HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
+		{
+			Position Pos = Caller->GetFileOffset();
+			Position Next = Pos + Object->GetKLSize() + Object->GetLength();
+
+			if(Next > Part.End)
+			{
+				Part.Findings.push_back(QCFinding("klv.overrun", Pos, "KLV ends at " + OffsetString(Next) + ", beyond the end of the partition at " + OffsetString(Part.End)));
+				Part.Overrun = true;
+
+				// Leave the reader at the start of this KLV, so the walk is seen to end here
+				Caller->StopReading(true);
+				return true;
+			}
+
+			Part.KLVs++;
+
+			if((Pos < Part.EssenceStart) && (Next > Part.EssenceStart))
+			{
+				Part.Findings.push_back(QCFinding("partition.bytecount", Pos, "HeaderByteCount and IndexByteCount end at " + OffsetString(Part.EssenceStart) + ", inside this KLV"));
+			}
+
+			const UInt8 *Key = Object->GetUL()->GetValue();
+			if(IsFillerKey(Key))
+			{
+				// The KAG is relative to the start of the partition
+				if((Part.KAGSize > 1) && (((Next - Part.Start) % Part.KAGSize) != 0))
+				{
+					// Only the first in each partition is given as a finding, as a writer that gets this wrong will usually do so for every filler
+					if(Part.MisalignedFillers == 0)
+						Part.Findings.push_back(QCFinding("klv.kag", Pos, "Filler ends at " + OffsetString(Next) + ", which is not on a " + UInt64toString(Part.KAGSize) + " byte KAG boundary"));
+
+					Part.MisalignedFillers++;
+				}
+			}
+			else if((Pos >= Part.EssenceStart) && IsGCElementKey(Key))
+			{
+				Position StreamPos = Part.BodyOffset + (Pos - Part.EssenceStart);
+				Part.Elements.push_back(std::make_pair(StreamPos, StreamPos + (Next - Pos)));
+			}
+
+			return true;
+		}
+	};
+}
+
+
+//! Build a report of the scan, one item per line
+std::string QCReport::GetReport(void) const
+{
+	std::string Ret;
+
+	Ret += "qc.partitions " + UInt64toString(Partitions) + "\n";
+	Ret += "qc.klvs " + UInt64toString(KLVs) + "\n";
+	Ret += "qc.essence.klvs " + UInt64toString(EssenceKLVs) + "\n";
+	Ret += "qc.fill.misaligned " + UInt64toString(MisalignedFillers) + "\n";
+	Ret += "qc.index.tables " + UInt64toString(IndexTables) + "\n";
+	Ret += "qc.index.entries " + UInt64toString(IndexEntries) + "\n";
+	Ret += "qc.index.mismatched " + UInt64toString(IndexMismatches) + "\n";
+	Ret += "qc.findings " + UInt64toString(Findings.size()) + "\n";
+	Ret += std::string("qc.result ") + (Passed() ? "pass" : "fail") + "\n";
+
+	QCFindingList::const_iterator it = Findings.begin();
+	while(it != Findings.end())
+	{
+		Ret += "qc.finding " + (*it).Check + " " + (((*it).Offset < 0) ? std::string("-1") : OffsetString((*it).Offset)) + " " + (*it).Detail + "\n";
+		it++;
+	}
+
+	return Ret;
+}
+
+
+//! Check the file
+/*! \return false if the file could not be checked at all, in which case the report will hold the reason as a finding.
+ *          The file may still have failed some checks if true is returned, which is shown by Report.Passed().
+ */
+bool QCScanner::Scan(QCReport &Report)
+{
+	Report = QCReport();
+	Scans.clear();
+	StreamElements.clear();
+
+	// The partitions are checked against the RIP at the end of the file, if there is one
+	std::vector<UInt32> RIPBodySIDs;
+	if(File->ReadRIP())
+	{
+		RIP::iterator it = File->FileRIP.begin();
+		while(it != File->FileRIP.end())
+		{
+			RIPBodySIDs.push_back((*it).second->GetBodySID());
+			it++;
+		}
+	}
+	else
+	{
+		Report.Findings.push_back(QCFinding("rip.missing", -1, "The file has no RIP, the partitions were located by scanning the file"));
+		if(!File->GetRIP())
+		{
+			Report.Findings.push_back(QCFinding("rip.unreadable", -1, "Unable to locate the partitions of the file"));
+			return false;
+		}
+	}
+
+	// Read every partition pack and index table segment at once
+	if(!File->Preload(ThreadCount))
+	{
+		Report.Findings.push_back(QCFinding("file.unreadable", -1, "Unable to read the partition packs and index tables"));
+		return false;
+	}
+
+	Length FileSize = File->Size();
+
+	Scans.resize(File->FileRIP.size());
+	std::set<UInt32> IndexSIDs;
+	size_t i = 0;
+	RIP::iterator it = File->FileRIP.begin();
+	while(it != File->FileRIP.end())
+	{
+		PartitionInfoPtr Info = (*it).second;
+		it++;
+
+		PartitionScan &Part = Scans[i++];
+		Part.Pack = Info->GetPartition();
+		Part.Start = Info->GetByteOffset();
+		Part.End = (it == File->FileRIP.end()) ? FileSize : (*it).second->GetByteOffset();
+		Part.WalkStart = Part.Start;
+		Part.EssenceStart = Info->GetEssenceStart();
+		Part.Reached = Part.Start;
+		Part.BodyOffset = 0;
+		Part.BodySID = 0;
+		Part.KAGSize = 1;
+		Part.Footer = false;
+		Part.Overrun = false;
+		Part.KLVs = 0;
+		Part.MisalignedFillers = 0;
+
+		if(!Part.Pack) continue;
+
+		Part.BodyOffset = Part.Pack->GetInt64(BodyOffset_UL);
+		Part.BodySID = Part.Pack->GetUInt(BodySID_UL);
+		Part.KAGSize = Part.Pack->GetUInt(KAGSize_UL);
+		Part.Footer = (Part.Pack->Object->GetUL()->GetValue()[13] == 0x04);
+
+		if(Part.Pack->GetUInt(IndexSID_UL) && Part.Pack->GetInt64(IndexByteCount_UL)) IndexSIDs.insert(Part.Pack->GetUInt(IndexSID_UL));
+	}
+
+	// Positional reads let every task share the file, unless its backend is not thread-safe
+	FileBackendPtr Backend = File->GetBackend();
+	bool Parallel = (ThreadCount > 1) && ((!Backend) || Backend->IsThreadSafe());
+	TaskExecutor &Executor = GetTaskExecutor();
+
+	// Walk the KLVs of every partition
+	{
+		TaskGroup Tasks;
+		for(i = 0; i < Scans.size(); i++)
+		{
+			if(!Scans[i].Pack) continue;
+
+			TaskPtr Item = new QCPartitionTask(this, Scans[i]);
+			if(Parallel) Tasks.Submit(Item, &Executor);
+			else Item->Run();
+		}
+		Tasks.Wait();
+	}
+
+	CheckPartitions(Report, RIPBodySIDs);
+
+	// Check every index table against the essence KLVs found by the walk
+	std::list<IndexCheck> Checks;
+	{
+		TaskGroup Tasks;
+		std::set<UInt32>::iterator SID_it = IndexSIDs.begin();
+		while(SID_it != IndexSIDs.end())
+		{
+			UInt32 IndexSID = *SID_it;
+			SID_it++;
+
+			IndexTablePtr Table = File->GetPreloadedIndex(IndexSID);
+			if(!Table)
+			{
+				Report.Findings.push_back(QCFinding("index.unreadable", -1, "Unable to read the index table for IndexSID " + UInt64toString(IndexSID)));
+				continue;
+			}
+
+			std::map<UInt32, ElementList>::iterator Elements_it = StreamElements.find(Table->BodySID);
+			if(Elements_it == StreamElements.end())
+			{
+				Report.Findings.push_back(QCFinding("index.bodysid", -1, "The index table for IndexSID " + UInt64toString(IndexSID) + " indexes BodySID " + UInt64toString(Table->BodySID) + ", which has no essence"));
+				continue;
+			}
+
+			Checks.push_back(IndexCheck());
+			IndexCheck &Check = Checks.back();
+			Check.Table = Table;
+			Check.IndexSID = IndexSID;
+			Check.Elements = &(*Elements_it).second;
+			Check.Entries = 0;
+			Check.Mismatches = 0;
+
+			// A CBR index table may not give its duration, in which case it covers the whole stream
+			Check.Duration = Table->GetDuration();
+			if((Check.Duration <= 0) && Table->EditUnitByteCount)
+			{
+				Length StreamBytes = 0;
+				for(i = 0; i < Scans.size(); i++)
+				{
+					if((Scans[i].BodySID == Table->BodySID) && (Scans[i].Reached > Scans[i].EssenceStart)) StreamBytes += Scans[i].Reached - Scans[i].EssenceStart;
+				}
+				Check.Duration = StreamBytes / Table->EditUnitByteCount;
+			}
+
+			// Look-ups are much faster once the table is flattened, which must be done before the tasks share it
+			Table->Flatten();
+
+			Position First;
+			for(First = 0; First < Check.Duration; First += IndexCheckChunk)
+			{
+				Position Last = First + IndexCheckChunk;
+				if(Last > Check.Duration) Last = Check.Duration;
+
+				TaskPtr Item = new QCIndexTask(this, Check, First, Last);
+				if(Parallel) Tasks.Submit(Item, &Executor);
+				else Item->Run();
+			}
+		}
+		Tasks.Wait();
+	}
+
+	std::list<IndexCheck>::iterator Check_it = Checks.begin();
+	while(Check_it != Checks.end())
+	{
+		Report.IndexTables++;
+		Report.IndexEntries += (*Check_it).Entries;
+		Report.IndexMismatches += (*Check_it).Mismatches;
+		Report.Findings.splice(Report.Findings.end(), (*Check_it).Findings);
+		Check_it++;
+	}
+
+	// DRAGONS: The sort is stable, so findings at the same offset stay in the order they were found
+	Report.Findings.sort(FindingBefore);
+
+	return true;
+}
+
+
+//! Walk the KLVs of a partition, called by each partition task
+void QCScanner::ScanPartition(PartitionScan &Part)
+{
+	UInt8 Key[16];
+	Length Len;
+	Int32 KLSize = File->ReadKLAt(Part.Start, Key, Len);
+	if(!KLSize)
+	{
+		Part.Findings.push_back(QCFinding("partition.unreadable", Part.Start, "Unable to read the partition pack"));
+		return;
+	}
+
+	Part.WalkStart = Part.Start + KLSize + Len;
+	if(Part.EssenceStart < 0) Part.EssenceStart = Part.WalkStart;
+
+	// Walk the keys and lengths only, sharing the file with the other tasks
+	GCReadHandlerPtr Handler = new QCScanHandler(Part);
+	GCReaderPtr Reader = new GCReader(File, Handler, Handler);
+	Reader->SetHeaderOnly();
+	Reader->SetPositionalRead();
+
+	// DRAGONS: The reader stops at any key that IsPartitionKey() matches, which includes the primer pack,
+	//          so the walk is resumed after each such pack that is not a partition pack
+	Position WalkFrom = Part.WalkStart;
+	for(;;)
+	{
+		Reader->ReadFromFile(WalkFrom, 0);
+		Part.Reached = Reader->GetFileOffset();
+		if(Part.Overrun || (Part.Reached >= Part.End)) break;
+
+		KLSize = File->ReadKLAt(Part.Reached, Key, Len);
+		if((!KLSize) || (!IsPartitionKey(Key)) || IsPartitionPackKey(Key)) break;
+
+		Handler->HandleData(Reader, File->ReadKLVHeaderAt(Part.Reached));
+		if(Part.Overrun) break;
+
+		WalkFrom = Part.Reached + KLSize + Len;
+	}
+
+	if(Part.EssenceStart > Part.Reached)
+	{
+		Part.Findings.push_back(QCFinding("partition.bytecount", Part.Start, "HeaderByteCount and IndexByteCount end at " + OffsetString(Part.EssenceStart) + ", beyond the end of the partition at " + OffsetString(Part.Reached)));
+	}
+
+	if(Part.Overrun || (Part.Reached >= Part.End)) return;
+
+	// The walk stops early at a partition pack, which should have been the next in the RIP, or at a KLV that can't be read
+	if(KLSize && IsPartitionPackKey(Key))
+		Part.Findings.push_back(QCFinding("rip.incomplete", Part.Reached, "Partition pack is not listed in the RIP"));
+	else
+		Part.Findings.push_back(QCFinding("klv.unreadable", Part.Reached, "Unable to read a KLV, " + Int64toString(Part.End - Part.Reached) + " bytes before the next partition"));
+}
+
+
+//! Check the partition packs against the RIP and each other
+void QCScanner::CheckPartitions(QCReport &Report, const std::vector<UInt32> &RIPBodySIDs)
+{
+	Position FooterOffset = -1;
+	if((!Scans.empty()) && Scans.back().Footer) FooterOffset = Scans.back().Start;
+
+	Position Previous = 0;
+	std::map<UInt32, Position> NextBodyOffset;
+
+	size_t i;
+	for(i = 0; i < Scans.size(); i++)
+	{
+		PartitionScan &Part = Scans[i];
+
+		Report.Partitions++;
+		Report.KLVs += Part.KLVs;
+		Report.EssenceKLVs += Part.Elements.size();
+		Report.MisalignedFillers += Part.MisalignedFillers;
+
+		if(!Part.Pack)
+		{
+			Report.Findings.push_back(QCFinding("partition.unreadable", Part.Start, "Unable to read the partition pack"));
+			continue;
+		}
+
+		Position This = Part.Pack->GetInt64(ThisPartition_UL);
+		if(This != Part.Start)
+			Report.Findings.push_back(QCFinding("partition.this", Part.Start, "ThisPartition is " + OffsetString(This)));
+
+		Position Prev = Part.Pack->GetInt64(PreviousPartition_UL);
+		if(Prev != Previous)
+			Report.Findings.push_back(QCFinding("partition.previous", Part.Start, "PreviousPartition is " + OffsetString(Prev) + ", but the previous partition in the RIP is at " + OffsetString(Previous)));
+		Previous = Part.Start;
+
+		// DRAGONS: A FooterPartition of zero is allowed in partitions written before the footer position was known
+		Position Footer = Part.Pack->GetInt64(FooterPartition_UL);
+		if(Part.Footer)
+		{
+			if(Footer != Part.Start)
+				Report.Findings.push_back(QCFinding("partition.footer", Part.Start, "FooterPartition of the footer is " + OffsetString(Footer)));
+		}
+		else if(Footer && (Footer != FooterOffset))
+		{
+			if(FooterOffset < 0)
+				Report.Findings.push_back(QCFinding("partition.footer", Part.Start, "FooterPartition is " + OffsetString(Footer) + ", but the file has no footer"));
+			else
+				Report.Findings.push_back(QCFinding("partition.footer", Part.Start, "FooterPartition is " + OffsetString(Footer) + ", but the footer is at " + OffsetString(FooterOffset)));
+		}
+
+		if((i < RIPBodySIDs.size()) && (RIPBodySIDs[i] != Part.BodySID))
+		{
+			Report.Findings.push_back(QCFinding("rip.bodysid", Part.Start, "The RIP gives BodySID " + UInt64toString(RIPBodySIDs[i]) + ", but the partition pack gives BodySID " + UInt64toString(Part.BodySID)));
+		}
+
+		if(Part.BodySID)
+		{
+			// Each partition of a stream should continue from the end of the essence in the last
+			// DRAGONS: The offset is taken from this partition for those that follow, so that one error doesn't give a finding for every partition
+			Position Expected = 0;
+			std::map<UInt32, Position>::iterator Next_it = NextBodyOffset.find(Part.BodySID);
+			if(Next_it != NextBodyOffset.end()) Expected = (*Next_it).second;
+
+			if(Part.BodyOffset != Expected)
+			{
+				Report.Findings.push_back(QCFinding("partition.bodyoffset", Part.Start, "BodyOffset is " + OffsetString(Part.BodyOffset) + ", but the essence of BodySID "
+												  + UInt64toString(Part.BodySID) + " in earlier partitions ends at " + OffsetString(Expected)));
+			}
+
+			Length EssenceBytes = (Part.Reached > Part.EssenceStart) ? (Part.Reached - Part.EssenceStart) : 0;
+			NextBodyOffset[Part.BodySID] = Part.BodyOffset + EssenceBytes;
+
+			ElementList &Elements = StreamElements[Part.BodySID];
+			Elements.insert(Elements.end(), Part.Elements.begin(), Part.Elements.end());
+		}
+
+		// Free the element offsets now they are merged
+		ElementList().swap(Part.Elements);
+
+		Report.Findings.splice(Report.Findings.end(), Part.Findings);
+	}
+
+	// The elements are only out of order if a BodyOffset is wrong, which has already been reported, but the index check needs them sorted
+	std::map<UInt32, ElementList>::iterator it = StreamElements.begin();
+	while(it != StreamElements.end())
+	{
+		std::sort((*it).second.begin(), (*it).second.end());
+		it++;
+	}
+}
+
+
+//! Check the entries for a range of edit units of an index table, called by each index task
+void QCScanner::CheckIndexRange(IndexCheck &Check, Position First, Position Last)
+{
+	UInt64 Entries = 0;
+	UInt64 Mismatches = 0;
+	QCFindingList Findings;
+
+	IndexPos Pos;
+	Position EditUnit;
+	for(EditUnit = First; EditUnit < Last; EditUnit++)
+	{
+		// Sparse index tables don't have an entry for every edit unit, and the stored order is what is in the file
+		Check.Table->Lookup(EditUnit, Pos, 0, false);
+		if((!Pos.Exact) || Pos.OtherPos) continue;
+
+		Entries++;
+
+		// Find the last essence KLV starting at or before the indexed offset
+		ElementList::const_iterator it = std::upper_bound(Check.Elements->begin(), Check.Elements->end(), std::make_pair(Pos.Location, MaxPosition));
+		if(it != Check.Elements->begin())
+		{
+			it--;
+			if((*it).first == Pos.Location) continue;
+
+			// DRAGONS: A CBR index of clip-wrapped essence gives offsets within the value of the single KLV, which is longer than an edit unit
+			if(Check.Table->EditUnitByteCount && (Pos.Location < (*it).second) && (((*it).second - (*it).first) > static_cast<Length>(Check.Table->EditUnitByteCount))) continue;
+		}
+
+		Mismatches++;
+		if(Findings.size() < MaxIndexFindings)
+		{
+			Findings.push_back(QCFinding("index.offset", StreamToFile(Check.Table->BodySID, Pos.Location), "Index table for IndexSID " + UInt64toString(Check.IndexSID)
+										 + " gives stream offset " + OffsetString(Pos.Location) + " for edit unit " + Int64toString(EditUnit) + ", which is not the start of an essence KLV"));
+		}
+	}
+
+	MutexLock Locked(Lock);
+
+	Check.Entries += Entries;
+	Check.Mismatches += Mismatches;
+
+	while((!Findings.empty()) && (Check.Findings.size() < MaxIndexFindings))
+	{
+		Check.Findings.push_back(Findings.front());
+		Findings.pop_front();
+	}
+}
+
+
+//! Find the file offset of a stream offset in a given stream
+/*! \return The file offset, or -1 if the stream offset is not in any partition of the stream */
+Position QCScanner::StreamToFile(UInt32 BodySID, Position StreamOffset) const
+{
+	std::vector<PartitionScan>::const_iterator it = Scans.begin();
+	while(it != Scans.end())
+	{
+		if(((*it).BodySID == BodySID) && (StreamOffset >= (*it).BodyOffset) && (StreamOffset < (*it).BodyOffset + ((*it).Reached - (*it).EssenceStart)))
+			return (*it).EssenceStart + (StreamOffset - (*it).BodyOffset);
+
+		it++;
+	}
+
+	return -1;
+}
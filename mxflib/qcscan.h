@@ -0,0 +1,183 @@
+/*! \file	qcscan.h
+ *	\brief	Definition of a class that checks the structure and index tables of an MXF file on several threads
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A QCScanner checks that the partition packs, the RIP, the KLVs of each partition and the index tables of a file
+ *  agree with each other, without reading any essence. The partition packs and index tables are read with
+ *  MXFFile::Preload(), then each partition is walked on a task of the shared TaskExecutor using a header-only
+ *  positional GCReader, recording where each essence KLV starts. Finally each index table entry is checked against
+ *  these KLV starts, again on several tasks. The findings are reported as a QCReport, one per line, for other tools to parse.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#ifndef MXFLIB__QCSCAN_H
+#define MXFLIB__QCSCAN_H
+
+namespace mxflib
+{
+	//! A problem found by a QCScanner
+	struct QCFinding
+	{
+		std::string Check;						//!< The name of the check that failed, such as "partition.previous"
+		Position Offset;						//!< The file offset of the partition or KLV at fault, or -1 if not known
+		std::string Detail;						//!< A description of the problem
+
+		QCFinding(const std::string &Check, Position Offset, const std::string &Detail) : Check(Check), Offset(Offset), Detail(Detail) {}
+	};
+
+	//! A list of QC findings
+	typedef std::list<QCFinding> QCFindingList;
+
+	//! The results of a QC scan of a file
+	struct QCReport
+	{
+		UInt64 Partitions;						//!< The number of partitions in the RIP
+		UInt64 KLVs;							//!< The number of KLVs walked, not counting the partition packs
+		UInt64 EssenceKLVs;						//!< The number of Generic Container element KLVs in the essence containers
+		UInt64 MisalignedFillers;				//!< The number of filler KLVs that do not end on a KAG boundary
+		UInt64 IndexTables;						//!< The number of index tables checked
+		UInt64 IndexEntries;					//!< The number of index table entries checked
+		UInt64 IndexMismatches;					//!< The number of index table entries that do not give the start of an essence KLV
+		QCFindingList Findings;					//!< The problems found, in file order
+
+		QCReport() : Partitions(0), KLVs(0), EssenceKLVs(0), MisalignedFillers(0), IndexTables(0), IndexEntries(0), IndexMismatches(0) {}
+
+		//! Determine if the file passed every check
+		bool Passed(void) const { return Findings.empty(); }
+
+		//! Build a report of the scan, one item per line
+		/*! Each statistic is given as "<name> <value>", followed by each finding as "qc.finding <check> 0x<offset> <detail>",
+		 *  with an offset of -1 if not known
+		 */
+		std::string GetReport(void) const;
+	};
+
+	// Forward declare the task and read handler classes, which are private to the implementation
+	class QCPartitionTask;
+	class QCIndexTask;
+	class QCScanHandler;
+
+	//! Checks the structure and index tables of an MXF file, using several threads
+	/*! The following are checked:
+	 *  - That the file has a RIP, and that the BodySID of each of its entries matches the partition pack
+	 *  - That the ThisPartition, PreviousPartition and FooterPartition of each partition pack agree with the RIP
+	 *  - That the KLVs of each partition run exactly to the next partition in the RIP, and that no other partitions are found
+	 *  - That the HeaderByteCount and IndexByteCount of each partition end on a KLV boundary
+	 *  - That each filler KLV ends on a KAG boundary, when the KAG is larger than 1
+	 *  - That the BodyOffset of each partition follows on from the essence in earlier partitions of the same stream
+	 *  - That each entry of each index table gives the stream offset of the start of an essence KLV, or for a CBR index of
+	 *    clip-wrapped essence an offset within its value
+	 *  \note Only the keys and lengths of KLVs, the partition packs and the index tables are read, never the essence
+	 *  \note If the file uses a backend that is not thread-safe the partitions and index entries are checked on the calling thread
+	 */
+	class QCScanner : public RefCount<QCScanner>
+	{
+	protected:
+		//! The stream offsets of the start and end of each essence KLV of a stream, in order
+		typedef std::vector<std::pair<Position, Position> > ElementList;
+
+		//! The results of walking the KLVs of one partition
+		struct PartitionScan
+		{
+			PartitionPtr Pack;					//!< The partition pack, or NULL if it could not be read
+			Position Start;						//!< File offset of the partition pack
+			Position End;						//!< File offset of the next partition in the RIP, or the end of the file
+			Position WalkStart;					//!< File offset of the first KLV following the partition pack
+			Position EssenceStart;				//!< File offset of the start of the essence container, after the header metadata and index table
+			Position Reached;					//!< File offset reached by the walk
+			Position BodyOffset;				//!< The BodyOffset of the partition pack
+			UInt32 BodySID;						//!< The BodySID of the partition pack
+			UInt32 KAGSize;						//!< The KAGSize of the partition pack
+			bool Footer;						//!< True if this is the footer partition
+			bool Overrun;						//!< True if the walk stopped at a KLV running past the end of the partition
+			UInt64 KLVs;						//!< The number of KLVs walked
+			UInt64 MisalignedFillers;			//!< The number of filler KLVs that do not end on a KAG boundary
+			ElementList Elements;				//!< The stream offsets of each Generic Container element KLV in the essence container
+			QCFindingList Findings;				//!< The problems found in this partition
+		};
+
+		//! The state of an index table being checked
+		struct IndexCheck
+		{
+			IndexTablePtr Table;				//!< The index table
+			UInt32 IndexSID;					//!< The IndexSID of the table
+			Length Duration;					//!< The number of edit units to check
+			const ElementList *Elements;		//!< The essence KLVs of the indexed stream
+			UInt64 Entries;						//!< The number of entries checked
+			UInt64 Mismatches;					//!< The number of entries not matching an essence KLV
+			QCFindingList Findings;				//!< The first few mismatches found
+		};
+
+		MXFFilePtr File;						//!< The file being checked
+		unsigned int ThreadCount;				//!< Number of threads to use when preloading the partitions
+
+		Mutex Lock;								//!< Lock protecting the results of index checks as they are merged
+
+		std::vector<PartitionScan> Scans;		//!< The partitions, in file order
+		std::map<UInt32, ElementList> StreamElements;	//!< The essence KLVs of each BodySID
+
+	public:
+		//! Construct a scanner for a given file
+		QCScanner(MXFFilePtr &File) : File(File), ThreadCount(8) {};
+
+		//! Set the number of threads used to preload the partition packs and index tables
+		/*! The partitions and index entries are checked on the tasks of the shared TaskExecutor */
+		void SetThreads(unsigned int Threads) { ThreadCount = Threads; }
+
+		//! Check the file
+		/*! \return false if the file could not be checked at all, in which case the report will hold the reason as a finding.
+		 *          The file may still have failed some checks if true is returned, which is shown by Report.Passed().
+		 */
+		bool Scan(QCReport &Report);
+
+	protected:
+		//! Walk the KLVs of a partition, called by each partition task
+		void ScanPartition(PartitionScan &Part);
+
+		//! Check the partition packs against the RIP and each other
+		void CheckPartitions(QCReport &Report, const std::vector<UInt32> &RIPBodySIDs);
+
+		//! Check the entries for a range of edit units of an index table, called by each index task
+		void CheckIndexRange(IndexCheck &Check, Position First, Position Last);
+
+		//! Find the file offset of a stream offset in a given stream
+		/*! \return The file offset, or -1 if the stream offset is not in any partition of the stream */
+		Position StreamToFile(UInt32 BodySID, Position StreamOffset) const;
+
+		// The task and handler classes need access to the scanning functions
+		friend class QCPartitionTask;
+		friend class QCIndexTask;
+		friend class QCScanHandler;
+
+	private:
+		//! Prevent copy construction
+		QCScanner(const QCScanner &);
+	};
+
+	//! A smart pointer to a QCScanner object
+	typedef SmartPtr<QCScanner> QCScannerPtr;
+}
+
+#endif // MXFLIB__QCSCAN_H
@@ -0,0 +1,646 @@
+/*! \file	rewrap.cpp
+ *	\brief	Implementation of an engine that re-wraps MXF files by copying the essence KLVs unchanged
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+
+using namespace mxflib;
+
+
+namespace mxflib
+{
+	//! A GCReader handler that passes each KLV of one essence container to a RawRewrapper
+	class RawRewrapHandler : public GCReadHandler_Base
+	{
+	protected:
+		RawRewrapper *Owner;				//!< The re-wrapper to pass KLVs to
+		UInt32 BodySID;						//!< The BodySID of the essence container being read
+
+	public:
+		//! Construct a handler for a given BodySID
+		/*! \note The owner is not a smart pointer as the owner holds the reader that holds this handler */
+		RawRewrapHandler(RawRewrapper *Owner, UInt32 BodySID) : Owner(Owner), BodySID(BodySID) {}
+
+		//! Copy a KLV
+		bool HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
+		{
+			return Owner->CopyKLV(BodySID, Caller->GetStreamOffset(), Object);
+		}
+	};
+}
+
+
+//! Read the structure of the source file: the RIP, index tables and header metadata
+bool RawRewrapper::ReadSource(void)
+{
+	InFile->GetRIP();
+	if(InFile->FileRIP.empty())
+	{
+		error("Unable to locate the partitions of \"%s\"\n", InFile->Name.c_str());
+		return false;
+	}
+
+	// Find each essence container and gather all segments of each index table
+	std::map<UInt32, IndexTablePtr> IndexTables;
+	RIP::iterator it = InFile->FileRIP.begin();
+	while(it != InFile->FileRIP.end())
+	{
+		InFile->Seek((*it).second->ByteOffset);
+		PartitionPtr ThisPartition = InFile->ReadPartition();
+		if(ThisPartition)
+		{
+			UInt32 BodySID = ThisPartition->GetUInt(BodySID_UL);
+			if(BodySID && (Streams.find(BodySID) == Streams.end())) Streams[BodySID] = new RewrapStream(BodySID);
+
+			UInt32 IndexSID = ThisPartition->GetUInt(IndexSID_UL);
+			if(IndexSID && (ThisPartition->GetInt64(IndexByteCount_UL) != 0))
+			{
+				IndexTablePtr &Index = IndexTables[IndexSID];
+				if(!Index) Index = new IndexTable;
+				ThisPartition->ReadIndex(Index);
+			}
+		}
+
+		it++;
+	}
+
+	// Match each index table with the essence container that it indexes
+	std::map<UInt32, IndexTablePtr>::iterator Index_it = IndexTables.begin();
+	while(Index_it != IndexTables.end())
+	{
+		IndexTablePtr &Index = (*Index_it).second;
+
+		RewrapStreamMap::iterator Stream_it = Streams.find(Index->BodySID);
+		if(Stream_it == Streams.end())
+		{
+			warning("Index table with IndexSID 0x%04x is for BodySID 0x%04x, which is not in the file, so will not be copied\n", Index->IndexSID, Index->BodySID);
+		}
+		else
+		{
+			// Speed up the many look-ups made while copying
+			Index->Flatten();
+
+			(*Stream_it).second->SrcIndex = Index;
+			(*Stream_it).second->Duration = Index->GetDuration();
+		}
+
+		Index_it++;
+	}
+
+	if(PartitionEditUnits > 0)
+	{
+		RewrapStreamMap::iterator Stream_it = Streams.begin();
+		while(Stream_it != Streams.end())
+		{
+			if(!(*Stream_it).second->SrcIndex) warning("BodySID 0x%04x is not indexed, so its partitions will follow those of the source file\n", (*Stream_it).first);
+			Stream_it++;
+		}
+	}
+
+	// Read the master partition pack
+	MasterPartition = InFile->ReadMasterPartition();
+	if(!MasterPartition)
+	{
+		InFile->Seek(0);
+		MasterPartition = InFile->ReadPartition();
+
+		if(!MasterPartition)
+		{
+			error("Could not read the header of \"%s\"\n", InFile->Name.c_str());
+			return false;
+		}
+
+		warning("Could not locate a closed partition containing header metadata - copying the open header\n");
+	}
+
+	SourceClosed = MasterPartition->IsClosed();
+	SourceComplete = MasterPartition->IsComplete();
+
+	// Read the metadata from the header
+	MasterPartition->ReadMetadata();
+	HMeta = MasterPartition->ParseMetadata();
+	if(!HMeta)
+	{
+		error("Could not load the header metadata of \"%s\"\n", InFile->Name.c_str());
+		return false;
+	}
+
+	// Use the same KAG as the source header unless told otherwise
+	InFile->Seek(0);
+	PartitionPtr Header = InFile->ReadPartition();
+	if(Header) SourceKAG = Header->GetUInt(KAGSize_UL);
+	if(SourceKAG == 0) SourceKAG = 1;
+
+	return true;
+}
+
+
+//! Copy the source file to the destination
+bool RawRewrapper::Rewrap(void)
+{
+	if((!HMeta) && (!ReadSource())) return false;
+
+	if(NewOP) HMeta->SetOP(*NewOP);
+
+	UInt32 KAG = KAGSize ? KAGSize : SourceKAG;
+
+	/* Write the header, with all essence moved to body partitions */
+
+	if(SourceClosed)
+		MasterPartition->ChangeType(SourceComplete ? ClosedCompleteHeader_UL : ClosedHeader_UL);
+	else
+		MasterPartition->ChangeType(SourceComplete ? OpenCompleteHeader_UL : OpenHeader_UL);
+
+	MasterPartition->SetKAG(KAG);
+	MasterPartition->SetUInt(BodySID_UL, 0);
+	MasterPartition->SetUInt(IndexSID_UL, 0);
+	MasterPartition->SetUInt64(BodyOffset_UL, 0);
+	MasterPartition->SetUInt64(FooterPartition_UL, 0);
+
+	OutFile->WritePartition(MasterPartition);
+
+	/* Copy the body */
+
+	BodyReaderPtr BodyParser = new BodyReader(InFile);
+
+	// The values are copied in chunks by WriteRaw(), so only the keys and lengths need to be read
+	BodyParser->SetHeaderOnly(true);
+
+	RewrapStreamMap::iterator it = Streams.begin();
+	while(it != Streams.end())
+	{
+		RewrapStreamPtr &Stream = (*it).second;
+
+		Stream->Writer = new GCWriter(OutFile, Stream->BodySID);
+		Stream->Writer->SetKAG(KAG);
+
+		BodyParser->MakeGCReader(Stream->BodySID, new RawRewrapHandler(this, Stream->BodySID));
+
+		it++;
+	}
+
+	InFile->Seek(0);
+	for(;;)
+	{
+		if(!BodyParser->IsAtPartition())
+		{
+			BodyParser->ReSync();
+		}
+
+		// Stop when there are no more partitions
+		InFile->Seek(BodyParser->Tell());
+		PartitionPtr CurrentPartition = InFile->ReadPartition();
+		if(!CurrentPartition) break;
+
+		// Each pass reads the essence of one source partition
+		SourcePartitionStart = true;
+		bool ReadOK = BodyParser->ReadFromFile();
+
+		if(Failed) return false;
+		if(!ReadOK) break;
+	}
+
+	return WriteFooter();
+}
+
+
+//! Copy a single KLV read from the source
+bool RawRewrapper::CopyKLV(UInt32 BodySID, Position SrcOffset, KLVObjectPtr Object)
+{
+	RewrapStreamMap::iterator it = Streams.find(BodySID);
+	if(it == Streams.end()) return true;
+
+	RewrapStreamPtr &Stream = (*it).second;
+
+	Position SrcEnd = SrcOffset + Object->GetKLSize() + Object->GetLength();
+
+	// The first KLV of an indexed stream shows if the index is relative to the value of a clip-wrapped KLV:
+	// If so the second edit unit starts within the first KLV
+	if(!Stream->Started)
+	{
+		Stream->Started = true;
+
+		if(Stream->SrcIndex)
+		{
+			Position SecondOffset = EditUnitOffset(Stream, 1);
+			if((SecondOffset >= 0) && (SecondOffset < SrcEnd))
+			{
+				Stream->Clip = true;
+				Stream->SrcBase = SrcOffset + Object->GetKLSize();
+			}
+
+			Stream->NextEditUnitOffset = EditUnitOffset(Stream, 0);
+		}
+	}
+
+	// KLVs that start edit units are aligned to the KAG, and only these may start a partition,
+	// so that the elements of a content package stay together as they are in the index table
+	// DRAGONS: Every KLV is treated as starting an edit unit if the stream is not indexed
+	bool EditUnitStart = (Stream->NextEditUnitOffset < 0) || (Stream->NextEditUnitOffset < SrcEnd);
+
+	bool NewPartition = (BodySID != CurrentBodySID);
+	if(SourcePartitionStart && ((PartitionEditUnits == 0) || (!Stream->SrcIndex))) NewPartition = true;
+	if(EditUnitStart && (PartitionEditUnits > 0) && Stream->SrcIndex && (PartitionEditUnitCount >= PartitionEditUnits)) NewPartition = true;
+
+	SourcePartitionStart = false;
+
+	if(NewPartition) StartPartition(Stream);
+
+	GCWriterPtr &Writer = Stream->Writer;
+	if(EditUnitStart) Writer->AlignToKAG();
+
+	Position DstOffset = Writer->GetStreamOffset();
+	Writer->WriteRaw(Object, false);
+	Length DstSize = Writer->GetStreamOffset() - DstOffset;
+
+	// A short copy means that the value could not be read or written
+	if(DstSize < (Object->GetLength() + 17))
+	{
+		error("Failed to copy the KLV at stream offset 0x%s of BodySID 0x%04x\n", Int64toHexString(SrcOffset, 8).c_str(), BodySID);
+		Failed = true;
+		return false;
+	}
+
+	KLVCount++;
+	ByteCount += DstSize;
+
+	if(Stream->SrcIndex)
+	{
+		CopiedKLV ThisKLV;
+		ThisKLV.SrcOffset = SrcOffset;
+		ThisKLV.DstOffset = DstOffset;
+		ThisKLV.Size = SrcEnd - SrcOffset;
+		ThisKLV.SrcKLSize = Object->GetKLSize();
+		ThisKLV.DstKLSize = static_cast<UInt32>(DstSize - Object->GetLength());
+		Stream->Copied.push_back(ThisKLV);
+
+		if(Stream->Clip && (Stream->Copied.size() == 1)) Stream->DstBase = DstOffset + ThisKLV.DstKLSize;
+
+		// Move on past the edit units that start in this KLV
+		if(Stream->SrcIndex->EditUnitByteCount)
+		{
+			// DRAGONS: This is done arithmetically as a clip-wrapped KLV may hold a great many edit units
+			if((Stream->NextEditUnitOffset >= 0) && (Stream->NextEditUnitOffset < SrcEnd))
+			{
+				Position EUBC = Stream->SrcIndex->EditUnitByteCount;
+				Position Next = (SrcEnd - Stream->SrcBase + EUBC - 1) / EUBC;
+
+				PartitionEditUnitCount += static_cast<Length>(Next - Stream->NextEditUnit);
+				Stream->NextEditUnit = Next;
+				Stream->NextEditUnitOffset = EditUnitOffset(Stream, Next);
+			}
+		}
+		else
+		{
+			while((Stream->NextEditUnitOffset >= 0) && (Stream->NextEditUnitOffset < SrcEnd))
+			{
+				PartitionEditUnitCount++;
+				Stream->NextEditUnit++;
+				Stream->NextEditUnitOffset = EditUnitOffset(Stream, Stream->NextEditUnit);
+			}
+		}
+	}
+
+	return true;
+}
+
+
+//! Write a body partition pack for a given stream
+void RawRewrapper::StartPartition(RewrapStreamPtr &Stream)
+{
+	// End the essence of the current partition on the KAG so that the filler before the new partition pack is counted
+	// as part of that stream, otherwise stream offsets predicted from an earlier partition would land in the filler
+	if(CurrentBodySID != 0)
+	{
+		RewrapStreamMap::iterator it = Streams.find(CurrentBodySID);
+		if(it != Streams.end()) (*it).second->Writer->AlignToKAG();
+	}
+
+	if(SourceClosed)
+		MasterPartition->ChangeType(SourceComplete ? ClosedCompleteBodyPartition_UL : ClosedBodyPartition_UL);
+	else
+		MasterPartition->ChangeType(SourceComplete ? OpenCompleteBodyPartition_UL : OpenBodyPartition_UL);
+
+	MasterPartition->SetUInt(BodySID_UL, Stream->BodySID);
+	MasterPartition->SetUInt(IndexSID_UL, 0);
+	MasterPartition->SetUInt64(BodyOffset_UL, Stream->Writer->GetStreamOffset());
+
+	OutFile->WritePartition(MasterPartition, false);
+
+	CurrentBodySID = Stream->BodySID;
+	PartitionEditUnitCount = 0;
+}
+
+
+//! Get the source stream offset of an edit unit, or -1 if it is not indexed
+Position RawRewrapper::EditUnitOffset(RewrapStreamPtr &Stream, Position EditUnit)
+{
+	if((Stream->Duration > 0) && (EditUnit >= Stream->Duration)) return -1;
+
+	// DRAGONS: Edit units are counted in stored order as that is the order in which they are copied
+	IndexPos Result;
+	Stream->SrcIndex->Lookup(EditUnit, Result, 0, false);
+	if(!Result.Exact) return -1;
+
+	return Stream->SrcBase + Result.Location;
+}
+
+
+//! Get the destination stream offset of a source stream offset, or -1 if it is beyond the copied data
+Position RawRewrapper::Translate(RewrapStreamPtr &Stream, Position SrcOffset)
+{
+	std::vector<CopiedKLV> &Copied = Stream->Copied;
+	if(Copied.empty()) return -1;
+
+	// Find the last KLV that starts at or before this offset
+	size_t Low = 0;
+	size_t High = Copied.size();
+	while((High - Low) > 1)
+	{
+		size_t Mid = (Low + High) / 2;
+		if(Copied[Mid].SrcOffset <= SrcOffset) Low = Mid; else High = Mid;
+	}
+
+	const CopiedKLV &ThisKLV = Copied[Low];
+
+	// Offsets before the first KLV, such as in a leading filler, are the start of the first KLV
+	if(SrcOffset <= ThisKLV.SrcOffset) return ThisKLV.DstOffset;
+
+	// Offsets within a KLV keep their place in its value
+	if(SrcOffset < (ThisKLV.SrcOffset + ThisKLV.Size))
+	{
+		Position ValueOffset = SrcOffset - ThisKLV.SrcOffset - ThisKLV.SrcKLSize;
+		if(ValueOffset < 0) return ThisKLV.DstOffset;
+
+		return ThisKLV.DstOffset + ThisKLV.DstKLSize + ValueOffset;
+	}
+
+	// Offsets in a filler that was dropped are the start of the next KLV
+	if((Low + 1) < Copied.size()) return Copied[Low + 1].DstOffset;
+
+	return -1;
+}
+
+
+//! Build the index table for the destination from the source index table of a stream
+IndexTablePtr RawRewrapper::TranslateIndex(RewrapStreamPtr &Stream)
+{
+	IndexTablePtr &Src = Stream->SrcIndex;
+	if((!Src) || Stream->Copied.empty()) return NULL;
+
+	// A clip-wrapped CBR index is relative to the value of the KLV, which is copied unchanged
+	if(Src->EditUnitByteCount && Stream->Clip)
+	{
+		const CopiedKLV &First = Stream->Copied.front();
+		if((Stream->Duration == 0) || ((Stream->SrcBase + Stream->Duration * Src->EditUnitByteCount) <= (First.SrcOffset + First.Size))) return Src;
+	}
+
+	IndexTablePtr Ret = new IndexTable;
+	Ret->IndexSID = Src->IndexSID;
+	Ret->BodySID = Src->BodySID;
+	Ret->EditRate = Src->EditRate;
+
+	// Translate the deltas through the layout of the first edit unit
+	Position FirstOffset = EditUnitOffset(Stream, 0);
+	Position DstFirstOffset = (FirstOffset >= 0) ? Translate(Stream, FirstOffset) : -1;
+	if(Src->BaseDeltaCount)
+	{
+		std::vector<DeltaEntry> Deltas(Src->BaseDeltaArray, Src->BaseDeltaArray + Src->BaseDeltaCount);
+
+		if(DstFirstOffset >= 0)
+		{
+			std::vector<DeltaEntry>::iterator it = Deltas.begin();
+			while(it != Deltas.end())
+			{
+				// DRAGONS: Deltas in later slices are relative to the slice, so are left unchanged
+				if((*it).Slice == 0)
+				{
+					Position DstOffset = Translate(Stream, FirstOffset + GetU32((*it).ElementDelta));
+					if(DstOffset >= DstFirstOffset) PutU32(static_cast<UInt32>(DstOffset - DstFirstOffset), (*it).ElementDelta);
+				}
+
+				it++;
+			}
+		}
+
+		Ret->DefineDeltaArray(static_cast<int>(Deltas.size()), &Deltas.front());
+	}
+
+	/* CBR source: the data is now CBR again only if the edit units are evenly spaced from the start */
+
+	if(Src->EditUnitByteCount)
+	{
+		if(Ret->NSL || Ret->NPE)
+		{
+			warning("Unable to convert the CBR index table for BodySID 0x%04x to VBR as it has slices\n", Stream->BodySID);
+			return NULL;
+		}
+
+		std::vector<Position> Locations;
+		for(Position EditUnit = 0; ; EditUnit++)
+		{
+			Position Offset = EditUnitOffset(Stream, EditUnit);
+			if(Offset < 0) break;
+
+			Position DstOffset = Translate(Stream, Offset);
+			if(DstOffset < 0) break;
+
+			Locations.push_back(DstOffset - Stream->DstBase);
+		}
+
+		bool CBR = (Locations.size() > 1) && (Locations[0] == 0) && (Locations[1] > 0) && (Locations[1] <= 0xffffffff);
+		Position Step = CBR ? Locations[1] : 0;
+
+		size_t i;
+		for(i = 2; CBR && (i < Locations.size()); i++)
+		{
+			if(Locations[i] != (static_cast<Position>(i) * Step)) CBR = false;
+		}
+
+		if(CBR)
+		{
+			Ret->EditUnitByteCount = static_cast<UInt32>(Step);
+			Ret->IndexDuration = static_cast<Length>(Locations.size());
+			return Ret;
+		}
+
+		// Otherwise index each edit unit
+		std::vector<UInt8> Entries(Locations.size() * Ret->IndexEntrySize, 0);
+		for(i = 0; i < Locations.size(); i++)
+		{
+			PutU64(static_cast<UInt64>(Locations[i]), &Entries[i * Ret->IndexEntrySize + 3]);
+		}
+
+		if(!Locations.empty()) Ret->AddIndexEntries(0, static_cast<int>(Locations.size()), Ret->IndexEntrySize, &Entries.front());
+
+		return Ret;
+	}
+
+	/* VBR source: translate the stream offset and slice offsets of each entry, keeping everything else */
+
+	Ret->NSL = Src->NSL;
+	Ret->NPE = Src->NPE;
+	Ret->IndexEntrySize = Src->IndexEntrySize;
+
+	int EntrySize = Src->IndexEntrySize;
+	Position NextEditUnit = 0;
+	std::vector<UInt8> Entries;
+
+	IndexSegmentMap::iterator it = Src->SegmentMap.begin();
+	while(it != Src->SegmentMap.end())
+	{
+		IndexSegmentPtr &Segment = (*it).second;
+		it++;
+
+		// Skip any entries repeated from an earlier segment
+		int First = 0;
+		if(Segment->StartPosition < NextEditUnit) First = static_cast<int>(NextEditUnit - Segment->StartPosition);
+		if(First >= Segment->EntryCount) continue;
+
+		Entries.resize((Segment->EntryCount - First) * EntrySize);
+		const UInt8 *pSrc = &Segment->IndexEntryArray.Data[First * EntrySize];
+		UInt8 *pDst = &Entries.front();
+
+		int Count;
+		for(Count = First; Count < Segment->EntryCount; Count++)
+		{
+			Position Offset = Stream->SrcBase + GetI64(&pSrc[3]);
+			Position DstOffset = Translate(Stream, Offset);
+			if(DstOffset < 0) break;
+
+			memcpy(pDst, pSrc, EntrySize);
+			PutU64(static_cast<UInt64>(DstOffset - Stream->DstBase), &pDst[3]);
+
+			// Slice offsets are relative to the start of the edit unit
+			int Slice;
+			for(Slice = 0; Slice < Src->NSL; Slice++)
+			{
+				UInt8 *pSlice = &pDst[11 + 4 * Slice];
+				Position SliceOffset = Translate(Stream, Offset + GetU32(pSlice));
+				if(SliceOffset >= DstOffset) PutU32(static_cast<UInt32>(SliceOffset - DstOffset), pSlice);
+			}
+
+			pSrc += EntrySize;
+			pDst += EntrySize;
+		}
+
+		if(Count > First) Ret->AddIndexEntries(Segment->StartPosition + First, Count - First, EntrySize, &Entries.front());
+		NextEditUnit = Segment->StartPosition + Count;
+
+		if(Count < Segment->EntryCount)
+		{
+			warning("Index table for BodySID 0x%04x ends at edit unit %s as the rest of the indexed essence was not copied\n", 
+					Stream->BodySID, Int64toString(NextEditUnit).c_str());
+			break;
+		}
+	}
+
+	return Ret;
+}
+
+
+//! Write the footer with the translated index tables and a RIP, and update the header
+bool RawRewrapper::WriteFooter(void)
+{
+	// Translate the index tables
+	std::list<IndexTablePtr> Indexes;
+
+	RewrapStreamMap::iterator it = Streams.begin();
+	while(it != Streams.end())
+	{
+		RewrapStreamPtr &Stream = (*it).second;
+
+		if(Stream->SrcIndex)
+		{
+			IndexTablePtr Index = TranslateIndex(Stream);
+			if(Index) Indexes.push_back(Index);
+			else warning("Unable to translate the index table for BodySID 0x%04x, so it will not be copied\n", Stream->BodySID);
+		}
+
+		it++;
+	}
+
+	MasterPartition->SetUInt(BodySID_UL, 0);
+	MasterPartition->SetUInt64(BodyOffset_UL, 0);
+
+	// Each index table but the last goes in its own body partition ahead of the footer
+	while(Indexes.size() > 1)
+	{
+		if(SourceClosed)
+			MasterPartition->ChangeType(SourceComplete ? ClosedCompleteBodyPartition_UL : ClosedBodyPartition_UL);
+		else
+			MasterPartition->ChangeType(SourceComplete ? OpenCompleteBodyPartition_UL : OpenBodyPartition_UL);
+
+		MasterPartition->SetUInt(IndexSID_UL, Indexes.front()->IndexSID);
+
+		DataChunkPtr IndexData = new DataChunk;
+		Indexes.front()->WriteIndex(*IndexData);
+		OutFile->WritePartitionWithIndex(MasterPartition, IndexData, false);
+
+		Indexes.pop_front();
+	}
+
+	// The footer only needs the metadata if the header is not closed and complete
+	bool FooterMetadata = !(SourceClosed && SourceComplete);
+
+	MasterPartition->ChangeType((SourceComplete || !FooterMetadata) ? CompleteFooter_UL : Footer_UL);
+
+	if(Indexes.empty())
+	{
+		MasterPartition->SetUInt(IndexSID_UL, 0);
+		OutFile->WritePartition(MasterPartition, FooterMetadata);
+	}
+	else
+	{
+		MasterPartition->SetUInt(IndexSID_UL, Indexes.front()->IndexSID);
+
+		DataChunkPtr IndexData = new DataChunk;
+		Indexes.front()->WriteIndex(*IndexData);
+		OutFile->WritePartitionWithIndex(MasterPartition, IndexData, FooterMetadata);
+	}
+
+	UInt64 FooterPos = MasterPartition->GetUInt64(ThisPartition_UL);
+
+	OutFile->WriteRIP();
+
+	// Record the position of the footer in the header
+	OutFile->Seek(0);
+	PartitionPtr Header = OutFile->ReadPartition();
+	if(!Header)
+	{
+		error("Unable to re-read the header partition pack of \"%s\"\n", OutFile->Name.c_str());
+		return false;
+	}
+
+	Header->SetUInt64(FooterPartition_UL, FooterPos);
+	OutFile->Seek(0);
+	OutFile->WritePartitionPack(Header);
+
+	return true;
+}
@@ -0,0 +1,181 @@
+/*! \file	rewrap.h
+ *	\brief	Definition of an engine that re-wraps MXF files by copying the essence KLVs unchanged
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Changing the partitioning, KAG or operational pattern label of a file does not need the essence to be parsed. A
+ *  RawRewrapper reads the body of the source file with a BodyReader and copies each essence KLV to the destination
+ *  with GCWriter::WriteRaw(), dropping the source fillers. New partition packs are written as required, along with
+ *  the header metadata from the source file, and the source index tables are translated to the new layout by mapping
+ *  each indexed stream offset through a record of where each KLV was copied to. As the essence is never parsed the
+ *  copy runs at close to the speed of the storage.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__REWRAP_H
+#define MXFLIB__REWRAP_H
+
+namespace mxflib
+{
+	// Forward declare the read handler, which is private to the implementation
+	class RawRewrapHandler;
+
+	//! Re-wraps an MXF file by copying its essence KLVs unchanged into a new layout
+	/*! Each BodySID is copied to the same BodySID in the destination, with the header metadata and index tables.
+	 *  By default a new body partition is started wherever the source file starts one, or SetPartitionEditUnits()
+	 *  may be used to start one every so many edit units of an indexed stream.
+	 *  \note The header metadata is copied as it is, so if SetOP() is used it is the caller's job to ensure
+	 *        that the packages described by the metadata match the new label
+	 */
+	class RawRewrapper : public RefCount<RawRewrapper>
+	{
+	protected:
+		//! Record of where a single KLV was copied to
+		struct CopiedKLV
+		{
+			Position SrcOffset;					//!< The stream offset of the KLV in the source
+			Position DstOffset;					//!< The stream offset of the KLV in the destination
+			Length Size;						//!< The total size of the KLV
+			UInt32 SrcKLSize;					//!< The size of the key and length in the source
+			UInt32 DstKLSize;					//!< The size of the key and length in the destination
+		};
+
+		//! State of the copy of a single essence container
+		struct RewrapStream : public RefCount<RewrapStream>
+		{
+			UInt32 BodySID;						//!< The BodySID of this essence container
+			GCWriterPtr Writer;					//!< The writer for the destination
+			IndexTablePtr SrcIndex;				//!< The index table from the source, or NULL if not indexed
+			Length Duration;					//!< The duration of the source index, or 0 if not known
+			bool Started;						//!< True once the first KLV has been copied
+			bool Clip;							//!< True if the source index is relative to the value of the first KLV (clip-wrapping)
+			Position SrcBase;					//!< The source stream offset that index locations are relative to
+			Position DstBase;					//!< The destination stream offset that index locations are relative to
+			Position NextEditUnit;				//!< The next edit unit not yet found in the copied data
+			Position NextEditUnitOffset;		//!< The source stream offset of NextEditUnit, or -1 if not indexed
+			std::vector<CopiedKLV> Copied;		//!< Where each KLV was copied to, in stream order (only recorded if indexed)
+
+			//! Construct the state for a given BodySID
+			RewrapStream(UInt32 BodySID) : BodySID(BodySID), Duration(0), Started(false), Clip(false), SrcBase(0), DstBase(0),
+				NextEditUnit(0), NextEditUnitOffset(-1) {}
+		};
+
+		//! A smart pointer to a RewrapStream
+		typedef SmartPtr<RewrapStream> RewrapStreamPtr;
+
+		//! Map of the streams being copied, indexed by BodySID
+		typedef std::map<UInt32, RewrapStreamPtr> RewrapStreamMap;
+
+		MXFFilePtr InFile;						//!< The source file
+		MXFFilePtr OutFile;						//!< The destination file
+
+		UInt32 KAGSize;							//!< The KAG to use, or 0 to use the KAG of the source header
+		ULPtr NewOP;							//!< The operational pattern label to set, or NULL to leave it unchanged
+		Length PartitionEditUnits;				//!< The number of edit units per body partition, or 0 to follow the source partitioning
+
+		PartitionPtr MasterPartition;			//!< The partition holding the source header metadata, used as the template for all partition packs
+		MetadataPtr HMeta;						//!< The source header metadata
+		bool SourceClosed;						//!< True if the source header metadata is closed
+		bool SourceComplete;					//!< True if the source header metadata is complete
+		UInt32 SourceKAG;						//!< The KAG of the source header partition
+		RewrapStreamMap Streams;				//!< The essence containers being copied
+
+		UInt32 CurrentBodySID;					//!< The BodySID of the current destination partition, or 0 if none
+		bool SourcePartitionStart;				//!< True if a new source partition has been started since the last KLV was copied
+		Length PartitionEditUnitCount;			//!< The number of edit units started in the current destination partition
+		bool Failed;							//!< True if the copy has failed
+
+		UInt64 KLVCount;						//!< The number of KLVs copied
+		UInt64 ByteCount;						//!< The number of bytes copied, including keys and lengths
+
+		friend class RawRewrapHandler;
+
+	public:
+		//! Construct a re-wrapper between two open files
+		RawRewrapper(MXFFilePtr InFile, MXFFilePtr OutFile)
+			: InFile(InFile), OutFile(OutFile), KAGSize(0), PartitionEditUnits(0), SourceClosed(false), SourceComplete(false), SourceKAG(1),
+			  CurrentBodySID(0), SourcePartitionStart(false), PartitionEditUnitCount(0), Failed(false), KLVCount(0), ByteCount(0) {}
+
+		//! Set the KAG of the destination file, or 0 to use the KAG of the source header
+		void SetKAG(UInt32 KAG) { KAGSize = KAG; }
+
+		//! Set the operational pattern label of the destination file
+		void SetOP(const UL &OP) { NewOP = new UL(OP); }
+
+		//! Start a new body partition every given number of edit units, or 0 to follow the source partitioning
+		/*! \note Streams without an index table always follow the source partitioning */
+		void SetPartitionEditUnits(Length EditUnits) { PartitionEditUnits = EditUnits; }
+
+		//! Read the structure of the source file: the RIP, index tables and header metadata
+		/*! This is called by Rewrap() if required, but may be called first so that the metadata can be updated
+		 *  \return false on error
+		 */
+		bool ReadSource(void);
+
+		//! Get the header metadata that will be written, once ReadSource() has been called
+		MetadataPtr GetMetadata(void) { return HMeta; }
+
+		//! Copy the source file to the destination
+		/*! Writes the header, all the essence, the footer with the translated index tables and a RIP
+		 *  \return false on error
+		 */
+		bool Rewrap(void);
+
+		//! Get the number of KLVs copied
+		UInt64 GetKLVCount(void) { return KLVCount; }
+
+		//! Get the number of bytes of essence copied, including keys and lengths
+		UInt64 GetByteCount(void) { return ByteCount; }
+
+	protected:
+		//! Copy a single KLV read from the source
+		bool CopyKLV(UInt32 BodySID, Position SrcOffset, KLVObjectPtr Object);
+
+		//! Write a body partition pack for a given stream
+		void StartPartition(RewrapStreamPtr &Stream);
+
+		//! Get the source stream offset of an edit unit, or -1 if it is not indexed
+		Position EditUnitOffset(RewrapStreamPtr &Stream, Position EditUnit);
+
+		//! Get the destination stream offset of a source stream offset, or -1 if it is beyond the copied data
+		Position Translate(RewrapStreamPtr &Stream, Position SrcOffset);
+
+		//! Build the index table for the destination from the source index table of a stream
+		/*! \return The new index table, or NULL if it can't be translated */
+		IndexTablePtr TranslateIndex(RewrapStreamPtr &Stream);
+
+		//! Write the footer with the translated index tables and a RIP, and update the header
+		bool WriteFooter(void);
+
+	private:
+		//! Prevent copy construction
+		RawRewrapper(const RawRewrapper &);
+	};
+
+	//! A smart pointer to a RawRewrapper object
+	typedef SmartPtr<RawRewrapper> RawRewrapperPtr;
+}
+
+#endif // MXFLIB__REWRAP_H
@@ -312,26 +312,19 @@ SymbolSpacePtr &GetCodingSymbolSpace(UInt8 Coding, RegisterParserState *State)
 
 namespace
 {
-	//! Parse an RXI file or string into an RXIData structure
-	/*! If DictFile is empty the contents of strXML will be parsed instead
-	 */
-	RXIDataPtr ParseRXIInternal(std::string DictFile, std::string &strXML, SymbolSpacePtr DefaultSymbolSpace, std::string Application)
+	//! Initialize the parser state for parsing RXI into a new RXIData structure
+	void InitParserState(RegisterParserState &State, SymbolSpacePtr DefaultSymbolSpace, std::string Application)
 	{
-		// Info bloack to return
-		RXIDataPtr Ret = new RXIData;
-
-		// State data block passed through XML parser
-		RegisterParserState State;
-
 		// Initialize the state
 		State.State = DictStateIdle;
 		State.Depth = 0;
 		State.InTraits = false;
 		State.DefaultSymbolSpace = DefaultSymbolSpace;
 		State.DictSymbolSpace = DefaultSymbolSpace;
-		State.RXIData = Ret;
+		State.Parser = NULL;
+		State.RXIData = new RXIData;
 
-		Ret->LegacyFormat = false;
+		State.RXIData->LegacyFormat = false;
 
 		if(Application.empty())
 		{
@@ -365,6 +358,43 @@ namespace
 				State.AppVersion = ParseAppVersion(Application.substr(Pos+1));
 			}
 		}
+	}
+
+
+	//! Complete the RXIData structure once all RXI has been parsed
+	/*! \return The parsed data, or NULL on error */
+	RXIDataPtr FinishParserState(RegisterParserState &State)
+	{
+		// Legacy dictionary detected
+		if(State.RXIData->LegacyFormat) return State.RXIData;
+
+		// Flag an error if it all went bad
+		if(State.State == DictStateError) return NULL;
+
+		// Work out orphaned elements
+		ElementInfoMap::iterator it = State.ElementMap.begin();
+		while(it != State.ElementMap.end())
+		{
+			if(!(*it).second.Group)
+			{
+				State.RXIData->ElementList.push_back((*it).second.Item);
+			}
+			it++;
+		}
+
+		return State.RXIData;
+	}
+
+
+	//! Parse an RXI file or string into an RXIData structure
+	/*! If DictFile is empty the contents of strXML will be parsed instead
+	 */
+	RXIDataPtr ParseRXIInternal(std::string DictFile, std::string &strXML, SymbolSpacePtr DefaultSymbolSpace, std::string Application)
+	{
+		// State data block passed through XML parser
+		RegisterParserState State;
+
+		InitParserState(State, DefaultSymbolSpace, Application);
 
 		// Parse the file
 		bool result = false;
@@ -397,25 +427,81 @@ namespace
 			}
 		}
 
-		// Legacy dictionary detected
-		if(State.RXIData->LegacyFormat) return State.RXIData;
+		return FinishParserState(State);
+	}
+}
 
-		// Flag an error if it all went bad
-		if(State.State == DictStateError) return NULL;
 
-		// Work out orphaned elements
-		ElementInfoMap::iterator it = State.ElementMap.begin();
-		while(it != State.ElementMap.end())
-		{
-			if(!(*it).second.Group)
-			{
-				State.RXIData->ElementList.push_back((*it).second.Item);
-			}
-			it++;
-		}
+//! State carried between the pieces of a streamed parse
+class RXIStreamParser::StreamState : public RegisterParserState
+{
+};
 
-		return State.RXIData;
+
+//! Start a new streamed parse of RXI data
+RXIStreamParser::RXIStreamParser(SymbolSpacePtr DefaultSymbolSpace /*=MXFLibSymbols*/, std::string Application /*=""*/)
+{
+	State = new StreamState;
+	InitParserState(*State, DefaultSymbolSpace, Application);
+	Failed = false;
+
+#ifdef HAVE_EXPAT
+	State->Parser = XMLParserBegin(&DictLoad_XMLHandler, State, true);
+	if(!State->Parser) Failed = true;
+#else
+	XML_error(NULL, "Cannot parse streamed dictionary XML unless compiled with Expat XML parser\n");
+	Failed = true;
+#endif
+}
+
+
+//! Free any resources held by a streamed parse
+RXIStreamParser::~RXIStreamParser()
+{
+#ifdef HAVE_EXPAT
+	XMLParserEnd(State->Parser);
+#endif
+
+	delete State;
+}
+
+
+//! Parse the next piece of RXI data
+/*! The data need not be kept once this returns, and the pieces may split the XML at any point
+ *  \return false if the parse has failed, either now or with an earlier piece
+ */
+bool RXIStreamParser::Parse(const char *Data, size_t Size)
+{
+	if(Failed) return false;
+
+#ifdef HAVE_EXPAT
+	if(!XMLParserContinue(State->Parser, &DictLoad_XMLHandler, State, Data, Size)) Failed = true;
+#endif
+
+	return !Failed;
+}
+
+
+//! Complete the parse, once all data has been supplied with Parse()
+/*! \return The parsed data, or NULL on error */
+RXIDataPtr RXIStreamParser::End(void)
+{
+	if(Failed) return NULL;
+
+#ifdef HAVE_EXPAT
+	// Tell the parser that there is no more data, which may trigger the handling of the final tags
+	if(!XMLParserContinue(State->Parser, &DictLoad_XMLHandler, State, NULL, 0, true))
+	{
+		Failed = true;
+		XML_fatalError(NULL, "Failed to load dictionary from XML");
+		return NULL;
 	}
+#endif
+
+	// Prevent further parsing, the parser requires no more data once ended
+	Failed = true;
+
+	return FinishParserState(*State);
 }
 
 
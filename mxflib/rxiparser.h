@@ -66,6 +66,37 @@ namespace mxflib
 	{
 		return ParseRXIData(strXML, MXFLibSymbols, Application);
 	}
+
+
+	//! Parser for RXI data supplied in pieces, such as when read from a large register
+	/*! This avoids holding the whole of the XML in memory, each piece being parsed as it is supplied to Parse().
+	 *  Once all data has been supplied End() returns the RXIData structure, as returned by ParseRXIData().
+	 *  \note Requires the Expat XML parser
+	 */
+	class RXIStreamParser
+	{
+	protected:
+		class StreamState;					//!< State carried between pieces
+		StreamState *State;					//!< Our parser state
+		bool Failed;						//!< Set once the parse has failed, or been ended
+
+	private:
+		//! Prevent copy construction by NOT having an implementation to this copy constructor
+		RXIStreamParser(const RXIStreamParser &rhs);
+
+	public:
+		//! Start a new streamed parse of RXI data
+		RXIStreamParser(SymbolSpacePtr DefaultSymbolSpace = MXFLibSymbols, std::string Application = "");
+
+		//! Free any resources held by a streamed parse
+		~RXIStreamParser();
+
+		//! Parse the next piece of RXI data
+		bool Parse(const char *Data, size_t Size);
+
+		//! Complete the parse, once all data has been supplied with Parse()
+		RXIDataPtr End(void);
+	};
 }
 
 #endif // MXFLIB__RXIPARSER_H
@@ -48,6 +48,39 @@
 //#define PTRCHECK( x ) x
 #define PTRCHECK( x )
 
+/* Reference count locking
+ *
+ * By default reference counts are updated with atomic operations where the compiler supports them
+ * (Win32 or GCC 4.1 and later), with a small spin-lock per object protecting the rarely used list of
+ * parent pointers. Otherwise each object holds its own mutex. The following macros may be defined
+ * on the compiler command-line:
+ *
+ * MXFLIB_MUTEX_REFCOUNT - Always use a mutex per object
+ *
+ * NO_SP_MUTEX - Use no locking at all (only safe if SmartPtrs are never shared between threads)
+ */
+#if !defined(NO_SP_MUTEX) && !defined(MXFLIB_MUTEX_REFCOUNT)
+#if defined(_WIN32) || defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+#define MXFLIB_ATOMIC_REFCOUNT
+#endif
+#endif
+
+/* Move support
+ *
+ * When built as C++11 (or with Visual C++ 2010 or later) SmartPtr and DataChunk have move constructors and
+ * move assignment, so returning a pointer or a chunk by value, or moving one within a growing container, hands over
+ * the reference or buffer rather than taking and releasing a reference count or copying the data. Older compilers
+ * simply copy as before. MXFLIB_NO_MOVE may be defined on the compiler command-line to disable move support.
+ */
+#if !defined(MXFLIB_NO_MOVE) && ((__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1600)))
+#define MXFLIB_HAS_MOVE
+#if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#define MXFLIB_NOEXCEPT noexcept
+#else
+#define MXFLIB_NOEXCEPT
+#endif
+#endif
+
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
 #include <assert.h>
@@ -59,6 +92,37 @@
 // Ensure we know NULL
 #include <stdlib.h>
 
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+namespace mxflib
+{
+#ifdef _WIN32
+	//! Atomically increment an integer, returning the new value
+	inline int AtomicIncrement(int *Value) { return static_cast<int>(InterlockedIncrement(reinterpret_cast<volatile LONG*>(Value))); }
+
+	//! Atomically decrement an integer, returning the new value
+	inline int AtomicDecrement(int *Value) { return static_cast<int>(InterlockedDecrement(reinterpret_cast<volatile LONG*>(Value))); }
+
+	//! Attempt to take a simple spin-lock, returning true if now held
+	inline bool AtomicTryLock(int *Lock) { return InterlockedExchange(reinterpret_cast<volatile LONG*>(Lock), 1) == 0; }
+
+	//! Release a spin-lock taken with AtomicTryLock()
+	inline void AtomicUnlock(int *Lock) { InterlockedExchange(reinterpret_cast<volatile LONG*>(Lock), 0); }
+#else
+	//! Atomically increment an integer, returning the new value
+	inline int AtomicIncrement(int *Value) { return __sync_add_and_fetch(Value, 1); }
+
+	//! Atomically decrement an integer, returning the new value
+	inline int AtomicDecrement(int *Value) { return __sync_sub_and_fetch(Value, 1); }
+
+	//! Attempt to take a simple spin-lock, returning true if now held
+	inline bool AtomicTryLock(int *Lock) { return __sync_lock_test_and_set(Lock, 1) == 0; }
+
+	//! Release a spin-lock taken with AtomicTryLock()
+	inline void AtomicUnlock(int *Lock) { __sync_lock_release(Lock); }
+#endif
+}
+#endif // MXFLIB_ATOMIC_REFCOUNT
+
 namespace mxflib 
 {
 	// Forward declaration of SmartPtr to allow it to be befreinded
@@ -127,9 +191,14 @@ namespace mxflib
 		int __m_counter;									//!< The actual reference count
 
 		typedef ParentPtr<T> LocalParent;					//!< Parent pointer to this type
-		typedef std::list<LocalParent*> LocalParentList;	//!< List of pointers to parent pointers
-		LocalParentList *ParentPointers;					//!< List of parent pointers to this object
+		typedef std::vector<LocalParent*> LocalParentList;	//!< List of pointers to parent pointers
+														/*!< DRAGONS: This is a vector rather than a list as a set may have a parent pointer from each of
+														 *            its many children, and a vector costs a pointer for each rather than a list node */
+		LocalParentList *ParentPointers;					//!< List of parent pointers to this object (allocated when the first is added)
 
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+		int ParentLock;										//!< Spin-lock protecting ParentPointers (the count itself is updated atomically)
+#else
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
 		CRITICAL_SECTION mutex; 
@@ -137,11 +206,15 @@ namespace mxflib
 		pthread_mutex_t mutex;
 #endif
 #endif //NO_SP_MUTEX
+#endif // MXFLIB_ATOMIC_REFCOUNT
 
 	protected:
-		//! Increment the number of references
-		virtual void __IncRefCount()
+		//! Lock this object's reference details (other than the count when it is atomic)
+		void __Lock()
 		{
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+			while(!AtomicTryLock(&ParentLock)) {};
+#else
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
 			EnterCriticalSection(& mutex);
@@ -149,54 +222,69 @@ namespace mxflib
 			pthread_mutex_lock( & mutex);
 #endif
 #endif //NO_SP_MUTEX
-			__m_counter++;
+#endif // MXFLIB_ATOMIC_REFCOUNT
+		}
 
-			PTRDEBUG( debug("%p Increment count -> %d\n", this, __m_counter); )
+		//! Unlock this object's reference details
+		void __Unlock()
+		{
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+			AtomicUnlock(&ParentLock);
+#else
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
-				LeaveCriticalSection(&mutex);
+			LeaveCriticalSection(&mutex);
 #else
-				pthread_mutex_unlock( &mutex);
+			pthread_mutex_unlock( &mutex);
 #endif
 #endif //NO_SP_MUTEX
+#endif // MXFLIB_ATOMIC_REFCOUNT
 		}
 
-		//! Decrement the number of references, if none left delete the object
-		virtual void __DecRefCount()
+		//! Initialize the lock for a new object
+		void __InitLock()
 		{
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+			ParentLock = 0;
+#else
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
-			EnterCriticalSection(& mutex);
+			InitializeCriticalSection(&mutex);
 #else
-			pthread_mutex_lock( & mutex);
+			pthread_mutex_init(&mutex, NULL);
 #endif
 #endif //NO_SP_MUTEX
+#endif // MXFLIB_ATOMIC_REFCOUNT
+		}
 
-			__m_counter--;
+		//! Increment the number of references
+		virtual void __IncRefCount()
+		{
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+			AtomicIncrement(&__m_counter);
+#else
+			__Lock();
+			__m_counter++;
+			__Unlock();
+#endif // MXFLIB_ATOMIC_REFCOUNT
 
-			PTRDEBUG( debug("%p Decrement count -> %d\n", this, __m_counter); )
+			PTRDEBUG( debug("%p Increment count -> %d\n", this, __m_counter); )
+		}
 
-				if(__m_counter<=0)
-				{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-					LeaveCriticalSection(&mutex);
-#else
-					pthread_mutex_unlock( &mutex);
-#endif
-#endif //NO_SP_MUTEX
-					__DestroyRef();
-				}
-				else
-				{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-					LeaveCriticalSection(&mutex);
+		//! Decrement the number of references, if none left delete the object
+		virtual void __DecRefCount()
+		{
+#ifdef MXFLIB_ATOMIC_REFCOUNT
+			int Count = AtomicDecrement(&__m_counter);
 #else
-					pthread_mutex_unlock( &mutex);
-#endif
-#endif //NO_SP_MUTEX
-				}
+			__Lock();
+			int Count = --__m_counter;
+			__Unlock();
+#endif // MXFLIB_ATOMIC_REFCOUNT
+
+			PTRDEBUG( debug("%p Decrement count -> %d\n", this, Count); )
+
+			if(Count <= 0) __DestroyRef();
 		}
 
 		//! Get a pointer to the object
@@ -246,36 +334,20 @@ namespace mxflib
 		//! Add a parent pointer to this object
 		virtual void AddRefC(ParentPtr<T> &Ptr)
 		{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			EnterCriticalSection(& mutex);
-#else
-			pthread_mutex_lock( & mutex);
-#endif
-#endif //NO_SP_MUTEX
+			__Lock();
+
 			PTRDEBUG( debug("Adding ParentPtr(%p) to %p\n", &Ptr, this); )
 
-				if(!ParentPointers) ParentPointers = new LocalParentList;
+			if(!ParentPointers) ParentPointers = new LocalParentList;
 			ParentPointers->push_back(&Ptr);
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			LeaveCriticalSection(&mutex);
-#else
-			pthread_mutex_unlock( &mutex);
-#endif
-#endif //NO_SP_MUTEX
+
+			__Unlock();
 		}
 
 		//! Delete a parent pointer to this object
 		virtual void DeleteRef(ParentPtr<T> &Ptr)
 		{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			EnterCriticalSection(& mutex);
-#else
-			pthread_mutex_lock( & mutex);
-#endif
-#endif //NO_SP_MUTEX
+			__Lock();
 
 			if(ParentPointers)
 			{
@@ -285,41 +357,29 @@ namespace mxflib
 					if((*it) == &Ptr)
 					{
 						PTRDEBUG( debug("Deleting ParentPtr(%p) from %p\n", &Ptr, this); )
-							ParentPointers->erase(it);
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-						LeaveCriticalSection(&mutex);
-#else
-						pthread_mutex_unlock( &mutex);
-#endif
-#endif //NO_SP_MUTEX
 
+						// The order does not matter, so move the last entry into this slot rather than shuffle them all up
+						*it = ParentPointers->back();
+						ParentPointers->pop_back();
+
+						__Unlock();
 						return;
 					}
 					it++;
 				}
 			}
+
+			__Unlock();
+
 			error("Tried to clear ParentPtr(%p) from %p but that ParentPtr does not exist\n", &Ptr, this);
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			LeaveCriticalSection(&mutex);
-#else
-			pthread_mutex_unlock( &mutex);
-#endif
-#endif //NO_SP_MUTEX
 		}
 
 	protected:
 		//! Constructor for the RefCount class
 		RefCount()
 		{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			InitializeCriticalSection(&mutex);
-#else
-			pthread_mutex_init(&mutex, NULL);
-#endif
-#endif //NO_SP_MUTEX			
+			__InitLock();
+
 			// If we are "checking" add entry to the list
 			// We add to the start of the list as this gives the best chance of finding the
 			// item quickly when it is deleted (most objects are first-in-last-out)
@@ -337,13 +397,8 @@ namespace mxflib
 		//! Copy Constructor for the RefCount class
 		RefCount( RefCount &)
 		{
-#ifndef NO_SP_MUTEX
-#ifdef _WIN32
-			InitializeCriticalSection(&mutex);
-#else
-			pthread_mutex_init(&mutex, NULL);
-#endif
-#endif //NO_SP_MUTEX			
+			__InitLock();
+
 			// If we are "checking" add entry to the list
 			// We add to the start of the list as this gives the best chance of finding the
 			// item quickly when it is deleted (most objects are first-in-last-out)
@@ -371,6 +426,7 @@ namespace mxflib
 		virtual ~RefCount() 
 		{
 			if(ParentPointers) ClearParents(); 
+#ifndef MXFLIB_ATOMIC_REFCOUNT
 #ifndef NO_SP_MUTEX
 #ifdef _WIN32
 			DeleteCriticalSection(&mutex);
@@ -379,6 +435,7 @@ namespace mxflib
 			pthread_mutex_destroy(&mutex);
 #endif
 #endif //NO_SP_MUTEX
+#endif // MXFLIB_ATOMIC_REFCOUNT
 		}
 
 
@@ -571,6 +628,31 @@ namespace mxflib
 					oldref->__DecRefCount();
 		}
 
+		//! Determine if this pointer holds a counted reference to its object (parent pointers do not)
+		virtual bool __IsCounted(void) const { return true; }
+
+#ifdef MXFLIB_HAS_MOVE
+		//! Take the target of another smart pointer, taking over its reference rather than adding one where possible
+		/*! DRAGONS: A parent pointer holds no count to hand over, so when either pointer is a parent pointer this is a simple assignment */
+		void __Take(SmartPtr<T> &sp)
+		{
+			if(&sp == this) return;
+
+			if((!__IsCounted()) || (!sp.__IsCounted()))
+			{
+				__Assign(sp.__m_refcount);
+				return;
+			}
+
+			IRefCount<T> *oldref = __m_refcount;
+
+			__m_refcount = sp.__m_refcount;
+			sp.__m_refcount = NULL;
+
+			if(oldref!=NULL) oldref->__DecRefCount();
+		}
+#endif // MXFLIB_HAS_MOVE
+
 	public:
 		//! Construct a smart pointer that points to nothing
 		SmartPtr()
@@ -599,6 +681,19 @@ namespace mxflib
 			__Assign(ptr.GetRefC());
 		}
 
+#ifdef MXFLIB_HAS_MOVE
+		//!	Construct a smart pointer that takes over the target, and the reference, of another smart pointer
+		/*! \note A derived class under construction is never a parent pointer here, as ParentPtr has no move constructor */
+		SmartPtr(SmartPtr<T> &&sp) MXFLIB_NOEXCEPT
+		{
+			__m_refcount = NULL;
+			__Take(sp);
+		}
+
+		//! Assign another smart pointer, taking over its reference
+		SmartPtr & operator = (SmartPtr<T> &&sp) MXFLIB_NOEXCEPT {__Take(sp); return *this;}
+#endif // MXFLIB_HAS_MOVE
+
 		//! Detatch this pointer from the object before destruction
 		virtual ~SmartPtr()
 		{
@@ -691,6 +786,9 @@ namespace mxflib
 	template<class T> class ParentPtr : public SmartPtr<T>
 	{
 	protected:
+		//! Parent pointers don't hold a counted reference, so one may never be handed over by a move
+		virtual bool __IsCounted(void) const { return false; }
+
 		//!	Assign a 'smart' object to this pointer
 		/*! Note that no reference counting is performed with this version.
 		*  This prevents circular references keeping objects for ever.
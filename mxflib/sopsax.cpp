@@ -38,12 +38,45 @@
 using namespace mxflib;
 
 
+/* Position within the XML text being parsed
+** This behaves like a FILE read with fgetc() and ungetc(), but scans
+** the text in memory rather than calling the C library for each char
+*/
+typedef struct
+{
+	const unsigned char *Ptr;		/* Next character to read */
+	const unsigned char *End;		/* End of the text */
+	int Eof;						/* Set once a read has been attempted past the end, as feof() */
+} sopReader;
+
+
 /* Local Prototypes */
-static int sopSkipToClose(FILE *xmlFile);
-static int sopGetCharNonQ(FILE *xmlFile);
-static int sopGetChar(FILE *xmlFile);
-static void sopSkipSpace(FILE *xmlFile);
-static void sopGetItem(FILE *xmlFile, char *Buffer, int Max);
+static bool sopSAXParse(sopSAXHandlerPtr sax, void *UserData, sopReader *xmlFile);
+static int sopSkipToClose(sopReader *xmlFile);
+static int sopGetCharNonQ(sopReader *xmlFile);
+static int sopGetChar(sopReader *xmlFile);
+static void sopSkipSpace(sopReader *xmlFile);
+static void sopGetItem(sopReader *xmlFile, char *Buffer, int Max);
+
+
+/* Read the next character, as fgetc() */
+static inline int sopReadChar(sopReader *xmlFile)
+{
+	if(xmlFile->Ptr < xmlFile->End) return *(xmlFile->Ptr++);
+
+	xmlFile->Eof = 1;
+	return EOF;
+}
+
+
+/* Push back the last character read, as ungetc() */
+static inline void sopUngetChar(int c, sopReader *xmlFile)
+{
+	if(c == EOF) return;
+
+	xmlFile->Ptr--;
+	xmlFile->Eof = 0;
+}
 
 
 #define MAXTAGDEPTH 32
@@ -53,20 +86,13 @@ static void sopGetItem(FILE *xmlFile, char *Buffer, int Max);
 
 /*
 ** sopSAXParseFile() - Parse an XML file (not re-entrant due to static data)
+**
+** The whole file is mapped into memory (or read, if it cannot be mapped)
+** and then parsed as a buffer
 */
 
 bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *filename)
 {
-	FILE *xmlFile;
-	int ElementNesting;
-	char ThisTag[MAXTAGLENGTH+1];
-
-	/* NOTE: These are static because they are quite large */
-	/*       For re-entrant use they can be made auto */
-	static char TagName[MAXTAGDEPTH][MAXTAGLENGTH+1];
-	static char AttribBuffer[ATTRIBBUFFERSIZE];
-	static char *Attribs[(MAXATTRIBS+1)*2];
-
 	/* Validate the handler */
 	if(sax == NULL)
 	{
@@ -78,9 +104,9 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 	if (filename == NULL)
 		return false;
 
-	xmlFile = fopen(filename, "rb");
+	FileHandle InFile = FileOpenRead(filename);
 
-	if(xmlFile == NULL)
+	if(!FileValid(InFile))
 	{
 		if(sax->fatalError != NULL) sax->fatalError(UserData, 
 			"Cannot open file %s", filename);
@@ -88,8 +114,78 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 		return false;
 	}
 
+	Int64 Size = FileSize(InFile);
+	if(Size < 0) Size = 0;
+
+	UInt8 *Mapped = FileMemoryMap(InFile, static_cast<UInt64>(Size));
+
+	bool Ret;
+	if(Mapped)
+	{
+		Ret = sopSAXParseBuffer(sax, UserData, reinterpret_cast<const char *>(Mapped), static_cast<size_t>(Size));
+		FileMemoryUnmap(Mapped, static_cast<UInt64>(Size));
+	}
+	else
+	{
+		/* Can't map the file (it may be empty, or not a regular file) so read it all */
+		std::string Text;
+		unsigned char Buffer[64 * 1024];
+		for(;;)
+		{
+			size_t Bytes = FileRead(InFile, Buffer, sizeof(Buffer));
+			if(Bytes == 0) break;
+			Text.append(reinterpret_cast<const char *>(Buffer), Bytes);
+		}
+
+		Ret = sopSAXParseBuffer(sax, UserData, Text.data(), Text.size());
+	}
+
+	FileClose(InFile);
+
+	return Ret;
+}
+
+
+/*
+** sopSAXParseBuffer() - Parse XML held in memory (not re-entrant due to static data)
+*/
+
+bool mxflib::sopSAXParseBuffer(sopSAXHandlerPtr sax, void *UserData, const char *Buffer, size_t Size)
+{
+	/* Validate the handler */
+	if(sax == NULL)
+	{
+		// Note that this is far from ideal - but we don't have a valid error handler now!
+		fprintf(stderr, "Cannot parse XML with no handler\n");
+		return false;
+	}
+
+	sopReader Reader;
+	Reader.Ptr = reinterpret_cast<const unsigned char *>(Buffer);
+	Reader.End = Reader.Ptr + Size;
+	Reader.Eof = 0;
+
+	return sopSAXParse(sax, UserData, &Reader);
+}
+
+
+/*
+** sopSAXParse() - Parse XML from a reader (not re-entrant due to static data)
+*/
+
+bool sopSAXParse(sopSAXHandlerPtr sax, void *UserData, sopReader *xmlFile)
+{
+	int ElementNesting;
+	char ThisTag[MAXTAGLENGTH+1];
+
+	/* NOTE: These are static because they are quite large */
+	/*       For re-entrant use they can be made auto */
+	static char TagName[MAXTAGDEPTH][MAXTAGLENGTH+1];
+	static char AttribBuffer[ATTRIBBUFFERSIZE];
+	static char *Attribs[(MAXATTRIBS+1)*2];
+
 	ElementNesting = 0;
-	while(!feof(xmlFile))
+	while(!xmlFile->Eof)
 	{
 		int c;
 		int attrib;
@@ -201,7 +297,7 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 						ThisTag);
 
 				/* Skip to the end of this element here, but continue parsing file */
-				while(!feof(xmlFile))
+				while(!xmlFile->Eof)
 				{
 					c = sopGetCharNonQ(xmlFile);
 					if(c=='>')
@@ -239,10 +335,10 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 						Attribs[attrib*2], ThisTag);
 			
 				/* Push back the rouge char (in case is is a quote) */
-				ungetc(c, xmlFile);
+				sopUngetChar(c, xmlFile);
 
 				/* Skip to the end of this element here, but continue parsing file */
-				while(!feof(xmlFile))
+				while(!xmlFile->Eof)
 				{
 					c = sopGetCharNonQ(xmlFile);
 					if(c=='>')
@@ -292,8 +388,6 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 		}
 	}
 
-	fclose(xmlFile);
-
 	return true;
 }
 
@@ -301,49 +395,52 @@ bool mxflib::sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *f
 /*
 ** sopGetChar() - Get character from XML file, skipping comments
 */
-int sopGetChar(FILE *xmlFile)
+int sopGetChar(sopReader *xmlFile)
 {
 	int c;
 	int c2, c3;
-	long pos;
+	const unsigned char *pos;
 
 	/* Get the next character */
-	c = fgetc(xmlFile);
+	c = sopReadChar(xmlFile);
 	/* return it if safe */
 	if(c != '<') return c;
 
-	pos = ftell(xmlFile);
+	pos = xmlFile->Ptr;
 	/* Else sniff the next chars for '!--' */
-	c = fgetc(xmlFile);
+	c = sopReadChar(xmlFile);
 	if(c != '!')
 	{
 		/* We're safe, move back and continue */
-		fseek(xmlFile, pos, SEEK_SET);
+		xmlFile->Ptr = pos;
+		xmlFile->Eof = 0;
 		return '<';
 	}
 	
-	c2 = fgetc(xmlFile);
+	c2 = sopReadChar(xmlFile);
 	if(c2 != '-')
 	{
 		/* We're safe, move back and continue */
-		fseek(xmlFile, pos, SEEK_SET);
+		xmlFile->Ptr = pos;
+		xmlFile->Eof = 0;
 		return '<';
 	}
 
-	c3 = fgetc(xmlFile);
+	c3 = sopReadChar(xmlFile);
 	if(c3 != '-')
 	{
 		/* We're safe, move back and continue */
-		fseek(xmlFile, pos, SEEK_SET);
+		xmlFile->Ptr = pos;
+		xmlFile->Eof = 0;
 		return '<';
 	}
 
 	/* Scan for end of comment */
 	c3 = 0;
 	c2 = 0;
-	while(!feof(xmlFile))
+	while(!xmlFile->Eof)
 	{
-		c = fgetc(xmlFile);
+		c = sopReadChar(xmlFile);
 		if((c=='>') && (c2=='-') && (c3=='-'))
 		{
 			return sopGetChar(xmlFile);
@@ -361,7 +458,7 @@ int sopGetChar(FILE *xmlFile)
 /*
 ** sopSkipSpace() - Skip any whitespace or newline characters in XML file
 */
-void sopSkipSpace(FILE *xmlFile)
+void sopSkipSpace(sopReader *xmlFile)
 {
 	int c;
 
@@ -370,7 +467,7 @@ void sopSkipSpace(FILE *xmlFile)
 		c = sopGetChar(xmlFile);
 		if((c!=' ') && (c!='\t') && (c!='\r') && (c!='\n'))
 		{
-			ungetc(c, xmlFile);
+			sopUngetChar(c, xmlFile);
 			return;
 		}
 	}
@@ -380,7 +477,7 @@ void sopSkipSpace(FILE *xmlFile)
 /*
 ** sopGetCharNonQ() - Get character from XML file, skipping quoted strings
 */
-int sopGetCharNonQ(FILE *xmlFile)
+int sopGetCharNonQ(sopReader *xmlFile)
 {
 	int c;
 
@@ -408,7 +505,7 @@ int sopGetCharNonQ(FILE *xmlFile)
 ** Note: '?' is permitted before the '>' and is discarded
 **
 */
-int sopSkipToClose(FILE *xmlFile)
+int sopSkipToClose(sopReader *xmlFile)
 {
 	int c;
 
@@ -424,9 +521,9 @@ int sopSkipToClose(FILE *xmlFile)
 	/* Other characters found - skip them */
 
 	/* Push back the rouge char (in case is is a quote) */
-	ungetc(c, xmlFile);
+	sopUngetChar(c, xmlFile);
 
-	while(!feof(xmlFile))
+	while(!xmlFile->Eof)
 	{
 		c = sopGetCharNonQ(xmlFile);
 		if(c=='>') break;
@@ -444,7 +541,7 @@ int sopSkipToClose(FILE *xmlFile)
 ** ends in a whitespace, or a return, or '>'
 **
 */
-void sopGetItem(FILE *xmlFile, char *Buffer, int Max)
+void sopGetItem(sopReader *xmlFile, char *Buffer, int Max)
 {
 	int c;
 
@@ -501,7 +598,7 @@ void sopGetItem(FILE *xmlFile, char *Buffer, int Max)
 		}		
 
 		/* Push back the separator */
-		ungetc(c, xmlFile);
+		sopUngetChar(c, xmlFile);
 	}
 
 	/* Terminate the string */
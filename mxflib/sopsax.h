@@ -57,6 +57,7 @@ namespace mxflib
 
 	/* Function Prototypes */
 	bool sopSAXParseFile(sopSAXHandlerPtr sax, void *UserData, const char *filename);
+	bool sopSAXParseBuffer(sopSAXHandlerPtr sax, void *UserData, const char *Buffer, size_t Size);
 }
 
 #endif /* _SOPSAX_H */
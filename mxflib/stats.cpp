@@ -0,0 +1,119 @@
+/*! \file	stats.cpp
+ *	\brief	Implementation of the counters and timers for measuring where time is spent in the library
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The names of the counters, in the order of StatsCounter
+	const char *StatsNames[StatsCounterCount] =
+	{
+		"file.read.calls",
+		"file.read.bytes",
+		"file.write.calls",
+		"file.write.bytes",
+		"file.seek.calls",
+		"gcreader.klvs",
+		"datachunk.allocations",
+		"datachunk.allocated_bytes",
+		"index.lookups",
+		"essence.getdata.calls",
+		"essence.getdata.microseconds",
+		"essence.batches",
+		"packagecache.hits",
+		"packagecache.misses",
+		"live.package.writes",
+		"live.package.microseconds",
+		"live.package.late",
+		"gcwriter.early_writes",
+		"datachunk.shared_bytes"
+	};
+}
+
+
+#ifndef MXFLIB_NO_STATS
+namespace mxflib
+{
+	// Define the gathering flag and the counters
+	bool StatsActive = false;
+	UInt64 StatsCounters[StatsCounterCount];
+}
+#endif // MXFLIB_NO_STATS
+
+
+//! Get the name of a counter
+const char *mxflib::GetStatName(StatsCounter Counter)
+{
+	if((Counter < 0) || (Counter >= StatsCounterCount)) return "unknown";
+
+	return StatsNames[Counter];
+}
+
+
+//! Get the current value of a counter
+UInt64 mxflib::GetStat(StatsCounter Counter)
+{
+#ifdef MXFLIB_NO_STATS
+	return 0;
+#else
+	if((Counter < 0) || (Counter >= StatsCounterCount)) return 0;
+
+	return StatsCounters[Counter];
+#endif // MXFLIB_NO_STATS
+}
+
+
+//! Set all counters back to zero
+void mxflib::ResetStats(void)
+{
+#ifndef MXFLIB_NO_STATS
+	memset(StatsCounters, 0, sizeof(StatsCounters));
+#endif // MXFLIB_NO_STATS
+}
+
+
+//! Build a report of all counters, one per line, as "<name> <value>"
+std::string mxflib::GetStatsReport(void)
+{
+	std::string Ret;
+
+	int i;
+	for(i = 0; i < StatsCounterCount; i++)
+	{
+		Ret += StatsNames[i];
+		Ret += " ";
+		Ret += UInt64toString(GetStat(static_cast<StatsCounter>(i)));
+		Ret += "\n";
+	}
+
+	return Ret;
+}
@@ -0,0 +1,154 @@
+/*! \file	stats.h
+ *	\brief	Counters and timers for measuring where time is spent in the library
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A small set of named counters is updated on the hot paths of the library, such as the number of bytes read
+ *  and written by MXFFile and the number of KLVs dispatched by GCReader. Gathering is off until EnableStats()
+ *  is called, when the cost is a single test of a flag, and the whole facility may be compiled out by defining
+ *  MXFLIB_NO_STATS, when the update functions become empty inlines.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__STATS_H
+#define MXFLIB__STATS_H
+
+// Define this value here, or on the compiler command line, to remove all statistics gathering from the library
+//#define MXFLIB_NO_STATS
+
+namespace mxflib
+{
+	//! The counters that may be gathered
+	/*! Timers are held as a pair of counters, the number of timed calls followed by the total time in microseconds */
+	enum StatsCounter
+	{
+		StatsFileReadCalls = 0,				//!< Number of calls to MXFFile::Read()
+		StatsFileReadBytes,					//!< Number of bytes read by MXFFile::Read()
+		StatsFileWriteCalls,				//!< Number of calls to MXFFile::Write()
+		StatsFileWriteBytes,				//!< Number of bytes passed to MXFFile::Write()
+		StatsFileSeekCalls,					//!< Number of calls to MXFFile::Seek()
+		StatsKLVsDispatched,				//!< Number of KLVs dispatched to handlers by GCReader
+		StatsChunkAllocations,				//!< Number of DataChunk buffers allocated
+		StatsChunkAllocatedBytes,			//!< Number of bytes of DataChunk buffer allocated
+		StatsIndexLookups,					//!< Number of calls to IndexTable::Lookup()
+		StatsEssenceDataCalls,				//!< Number of calls to EssenceSource::GetEssenceData() made by BodyWriter
+		StatsEssenceDataTime,				//!< Microseconds spent in the calls counted by StatsEssenceDataCalls
+		StatsEssenceBatches,				//!< Number of batches of edit units returned by EssenceSource::GetEssenceBatch() to BodyWriter
+		StatsPackageCacheHits,				//!< Number of content packages found in a ContentPackageCache
+		StatsPackageCacheMisses,			//!< Number of content packages read from the file by a ContentPackageCache
+		StatsLivePackageWrites,				//!< Number of content packages written by a BodyWriter in live mode
+		StatsLivePackageWriteTime,			//!< Microseconds from reading each content package counted by StatsLivePackageWrites to it reaching the file
+		StatsLivePackagesLate,				//!< Number of content packages counted by StatsLivePackageWrites that took longer than the latency target
+		StatsGCWriterEarlyWrites,			//!< Number of times a GCWriter wrote part of a content package early as its write queue was over budget
+		StatsChunkSharedBytes,				//!< Number of bytes of DataChunk slices that shared a buffer rather than copying it
+
+		StatsCounterCount					//!< The number of counters (not a counter)
+	};
+
+	//! Get the name of a counter
+	const char *GetStatName(StatsCounter Counter);
+
+	//! Get the current value of a counter
+	UInt64 GetStat(StatsCounter Counter);
+
+	//! Set all counters back to zero
+	void ResetStats(void);
+
+	//! Build a report of all counters, one per line, as "<name> <value>"
+	std::string GetStatsReport(void);
+
+#ifdef MXFLIB_NO_STATS
+
+	//! Start or stop gathering statistics
+	/*! \return false, as gathering is not available in this build */
+	inline bool EnableStats(bool Enable = true) { return false; }
+
+	//! Determine if statistics are being gathered
+	inline bool StatsEnabled(void) { return false; }
+
+	//! Add to a counter
+	inline void StatsAdd(StatsCounter Counter, UInt64 Value = 1) {}
+
+	//! Time the life of this object, adding the call and time to a timer pair
+	class StatsTimer
+	{
+	public:
+		StatsTimer(StatsCounter Counter) {}
+	};
+
+#else // MXFLIB_NO_STATS
+
+	// Declare the gathering flag and the counters
+	extern bool StatsActive;
+	extern UInt64 StatsCounters[StatsCounterCount];
+
+	//! Start or stop gathering statistics
+	/*! \return true if gathering is available in this build */
+	inline bool EnableStats(bool Enable = true) { StatsActive = Enable; return true; }
+
+	//! Determine if statistics are being gathered
+	inline bool StatsEnabled(void) { return StatsActive; }
+
+	//! Add to a counter
+	/*! DRAGONS: Counters may be updated by several threads (such as by asynchronous writers and parallel readers)
+	 *           so atomic adds are used where they are available, otherwise counts may be a little low
+	 */
+	inline void StatsAdd(StatsCounter Counter, UInt64 Value = 1)
+	{
+		if(!StatsActive) return;
+
+#if defined(_WIN32)
+		InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG*>(&StatsCounters[Counter]), static_cast<LONGLONG>(Value));
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+		__sync_fetch_and_add(&StatsCounters[Counter], Value);
+#else
+		StatsCounters[Counter] += Value;
+#endif
+	}
+
+	//! Time the life of this object, adding the call and time to a timer pair
+	/*! Counter is the call counter of the pair, which is followed by the time counter */
+	class StatsTimer
+	{
+	protected:
+		StatsCounter Counter;				//!< The call counter of the timer pair
+		UInt64 Start;						//!< The time we were constructed, or zero if not gathering
+
+	public:
+		StatsTimer(StatsCounter Counter) : Counter(Counter), Start(StatsActive ? GetMicroseconds() : 0) {}
+
+		~StatsTimer()
+		{
+			if(!Start) return;
+
+			StatsAdd(Counter);
+			StatsAdd(static_cast<StatsCounter>(Counter + 1), GetMicroseconds() - Start);
+		}
+	};
+
+#endif // MXFLIB_NO_STATS
+}
+
+#endif // MXFLIB__STATS_H
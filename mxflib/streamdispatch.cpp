@@ -0,0 +1,247 @@
+/*! \file	streamdispatch.cpp
+ *	\brief	Implementation of a class that runs the read handlers of one stream on the shared TaskExecutor
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+#if defined(_WIN32)
+	//! True if the atomic operations needed by the ring are available
+	const bool HaveAtomics = true;
+
+	//! Stop loads and stores moving across this point, in the compiler or the CPU
+	inline void MemoryFence(void) { MemoryBarrier(); }
+
+	//! Set a flag, returning true if it was clear
+	inline bool TrySetFlag(volatile long *Flag) { return InterlockedExchange(Flag, 1) == 0; }
+
+	//! Clear a flag set with TrySetFlag()
+	inline void ClearFlag(volatile long *Flag) { InterlockedExchange(Flag, 0); }
+#elif defined(__GNUC__)
+	const bool HaveAtomics = true;
+	inline void MemoryFence(void) { __sync_synchronize(); }
+	inline bool TrySetFlag(volatile long *Flag) { return __sync_lock_test_and_set(Flag, 1) == 0; }
+	inline void ClearFlag(volatile long *Flag) { __sync_lock_release(Flag); }
+#else
+	// DRAGONS: Without atomic operations the ring cannot be shared, so dispatchers always run handlers on the reading thread
+	const bool HaveAtomics = false;
+	inline void MemoryFence(void) {}
+	inline bool TrySetFlag(volatile long *Flag) { if(*Flag) return false; *Flag = 1; return true; }
+	inline void ClearFlag(volatile long *Flag) { *Flag = 0; }
+#endif
+}
+
+
+namespace mxflib
+{
+	//! A read handler that loads each KLV framed on the reading thread and queues it for dispatch
+	class StreamQueueHandler : public GCReadHandler_Base
+	{
+	protected:
+		StreamDispatcher *Owner;					//!< The dispatcher we queue for
+
+	public:
+		StreamQueueHandler(StreamDispatcher *Owner) : Owner(Owner) {}
+
+		bool HandleData(GCReaderPtr Caller, KLVObjectPtr Object)
+		{
+			// Load the value here so that handlers never wait for the file, unless an asynchronous read has done so already
+			Length ValueLength = Object->GetLength();
+			if((ValueLength > 0) && (!Caller->IsHeaderOnly()) && (static_cast<Length>(Object->GetData().Size) != ValueLength))
+			{
+				if(static_cast<Length>(Object->ReadData()) < ValueLength)
+				{
+					error("Unable to read value of KLV at %s\n", Object->GetSourceLocation().c_str());
+					return false;
+				}
+			}
+
+			return Owner->Push(Object, Caller->GetFileOffset(), Caller->GetStreamOffset());
+		}
+	};
+
+
+	//! A task, run by the shared executor, that dispatches the KLVs queued for a StreamDispatcher
+	class StreamDrainTask : public Task
+	{
+	protected:
+		StreamDispatcher *Owner;					//!< The dispatcher we drain
+
+	public:
+		StreamDrainTask(StreamDispatcher *Owner) : Owner(Owner) {}
+
+		void Run(void) { Owner->Drain(); }
+	};
+}
+
+
+//! Construct a dispatcher for a stream read from a given file
+StreamDispatcher::StreamDispatcher(MXFFilePtr File, GCReaderPtr Reader, unsigned int Depth /*=64*/)
+	: Reader(Reader), Head(0), Tail(0), Scheduled(0), ProducerWaiting(0), Failed(false)
+{
+	Executor = &GetTaskExecutor();
+
+	size_t Size = 2;
+	while(Size < Depth) Size *= 2;
+	Ring.resize(Size);
+	Mask = Size - 1;
+
+	// DRAGONS: A dispatcher made by a task of the executor runs handlers on the reading thread, as a drain task could be
+	//          queued behind the very task that is waiting for it
+	if(HaveAtomics && (!Executor->IsWorkerThread()) && Executor->Start())
+	{
+		QueueHandler = new StreamQueueHandler(this);
+
+		// Positional reads leave the file pointer alone, so handlers may read from the file while the next KLVs are framed
+		Framer = new GCReader(File, QueueHandler);
+		Framer->SetPositionalRead(true);
+		Framer->SetHeaderOnly(Reader->IsHeaderOnly());
+	}
+}
+
+
+//! Get the reader to use on the reading thread
+GCReaderPtr StreamDispatcher::GetFramer(void)
+{
+	if(!Framer) return Reader;
+
+	// Fillers are only queued if the stream has a handler for them
+	Framer->SetFillerHandler(Reader->GetFillerHandler() ? QueueHandler : NULL);
+
+	return Framer;
+}
+
+
+//! Wait for all queued KLVs to be dispatched, helping with queued tasks meanwhile
+bool StreamDispatcher::Wait(void)
+{
+	Tasks.Wait();
+
+	bool Ret = !Failed;
+	Failed = false;
+
+	return Ret;
+}
+
+
+//! Queue a KLV framed on the reading thread, waiting if the ring is full
+bool StreamDispatcher::Push(KLVObjectPtr Object, Position FileOffset, Position StreamOffset)
+{
+	for(;;)
+	{
+		if(Failed) return false;
+
+		MemoryFence();
+		if((Tail - Head) <= Mask) break;
+
+		// Run a queued task while the ring is full, which may well be our own drain task
+		if(Executor->RunOne()) continue;
+
+		// DRAGONS: The flag is set before the ring is checked again, and the drain task checks the flag after moving Head,
+		//          so at least one of us sees the other and the wake-up cannot be lost
+		MutexLock Locked(Lock);
+		ProducerWaiting = 1;
+		MemoryFence();
+		if(((Tail - Head) > Mask) && (!Failed)) Space.Wait(Lock);
+		ProducerWaiting = 0;
+	}
+
+	Item &Slot = Ring[Tail & Mask];
+	Slot.Object = Object;
+	Slot.FileOffset = FileOffset;
+	Slot.StreamOffset = StreamOffset;
+
+	// Publish the item only once it is complete
+	MemoryFence();
+	Tail = Tail + 1;
+	MemoryFence();
+
+	if(TrySetFlag(&Scheduled)) Tasks.Submit(new StreamDrainTask(this), Executor);
+
+	return true;
+}
+
+
+//! Dispatch queued KLVs until the ring is empty, called by each drain task
+void StreamDispatcher::Drain(void)
+{
+	TraceScope Trace("StreamDispatcher::Drain", "read");
+
+	for(;;)
+	{
+		MemoryFence();
+		while(Head != Tail)
+		{
+			// Copy the item out before releasing its slot to the reading thread
+			MemoryFence();
+			Item &Slot = Ring[Head & Mask];
+			KLVObjectPtr Object = Slot.Object;
+			Position FileOffset = Slot.FileOffset;
+			Position StreamOffset = Slot.StreamOffset;
+			Slot.Object = NULL;
+
+			MemoryFence();
+			Head = Head + 1;
+			WakeProducer();
+
+			// Once a handler has failed the remaining items are discarded, as the reading thread will soon stop
+			if(Failed) continue;
+
+			Reader->SetFileOffset(FileOffset);
+			Reader->SetStreamOffset(StreamOffset);
+			if(!Reader->HandleData(Object))
+			{
+				Failed = true;
+				WakeProducer();
+			}
+
+			MemoryFence();
+		}
+
+		// DRAGONS: An item may be queued between the last check and clearing the flag, in which case the reading thread
+		//          will not have scheduled another task, so check again and carry on if nobody else has taken over
+		ClearFlag(&Scheduled);
+		MemoryFence();
+		if(Head == Tail) return;
+		if(!TrySetFlag(&Scheduled)) return;
+	}
+}
+
+
+//! Wake the reading thread if it is waiting for space
+void StreamDispatcher::WakeProducer(void)
+{
+	MemoryFence();
+	if(!ProducerWaiting) return;
+
+	MutexLock Locked(Lock);
+	Space.Signal();
+}
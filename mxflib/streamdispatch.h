@@ -0,0 +1,136 @@
+/*! \file	streamdispatch.h
+ *	\brief	Definition of a class that runs the read handlers of one stream on the shared TaskExecutor
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A BodyReader normally passes every KLV of every stream to its handlers on the thread that reads the file, so the
+ *  handlers of a file with several body streams (such as OP1b or AS-02 files with separate picture and sound streams)
+ *  take turns even when each is busy decoding or decrypting. With parallel dispatch enabled the reading thread only
+ *  frames the KLVs and loads their values, handing each to a StreamDispatcher for its BodySID. The dispatcher queues
+ *  them in a lock-free single-producer, single-consumer ring, drained by one task at a time on the shared TaskExecutor,
+ *  so the handlers of each stream still see their KLVs one at a time in file order while different streams run at once.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+#ifndef MXFLIB__STREAMDISPATCH_H
+#define MXFLIB__STREAMDISPATCH_H
+
+namespace mxflib
+{
+	// Forward declare the queueing handler and drain task classes, which are private to the implementation
+	class StreamQueueHandler;
+	class StreamDrainTask;
+
+	//! Runs the read handlers of one stream on the shared TaskExecutor, fed with KLVs framed on another thread
+	/*! The reading thread uses the GCReader returned by GetFramer(), whose handler loads the value of each KLV and
+	 *  queues it. Queued KLVs are passed to the stream's own GCReader by a drain task, with its file and stream offsets
+	 *  set as they would be for a single-threaded read, so handlers see the same caller state as usual.
+	 *  \note Handlers of different streams run at the same time, so must not share state without their own locking
+	 *  \note GCReader::StopReading() has no effect when called from a handler, as the following KLVs may already be queued
+	 *  \note If the platform has no atomic operations, the executor has no workers or the dispatcher is made by a task of the
+	 *        executor, the KLVs are passed to the handlers on the reading thread as normal
+	 */
+	class StreamDispatcher : public RefCount<StreamDispatcher>
+	{
+	protected:
+		//! A KLV framed by the reading thread and not yet dispatched
+		struct Item
+		{
+			KLVObjectPtr Object;				//!< The KLV, with its value loaded unless reading headers only
+			Position FileOffset;				//!< File offset of the start of the KLV
+			Position StreamOffset;				//!< Stream offset of the start of the KLV
+		};
+
+		GCReaderPtr Reader;						//!< The stream's own reader, holding its handlers, only used by the drain task
+		GCReaderPtr Framer;						//!< The reader used on the reading thread, or NULL when dispatching on that thread
+		GCReadHandlerPtr QueueHandler;			//!< The handler that queues each KLV framed by Framer
+		TaskExecutor *Executor;					//!< The executor running the drain tasks
+
+		//! The ring of queued KLVs, whose size is a power of two
+		/*! DRAGONS: Head is only written by the drain task and Tail only by the reading thread, each after the item it
+		 *           releases has been copied, so neither needs a lock. Only one drain task is scheduled at a time.
+		 */
+		std::vector<Item> Ring;
+		size_t Mask;							//!< Ring size minus one
+		volatile size_t Head;					//!< Count of items taken by the drain task
+		volatile size_t Tail;					//!< Count of items queued by the reading thread
+
+		volatile long Scheduled;				//!< Non-zero while a drain task is queued or running
+		volatile long ProducerWaiting;			//!< Non-zero while the reading thread is waiting for space in the ring
+		volatile bool Failed;					//!< Set by the drain task when a handler fails, after which queued KLVs are discarded
+
+		Mutex Lock;								//!< Lock used only while the reading thread waits for space
+		Condition Space;						//!< Signalled when space is made in the ring, or a handler fails
+		TaskGroup Tasks;						//!< The drain tasks
+
+		friend class StreamQueueHandler;
+		friend class StreamDrainTask;
+
+	public:
+		//! Construct a dispatcher for a stream read from a given file
+		/*! \param File The file being read
+		 *  \param Reader The stream's own reader, whose handlers will receive the KLVs
+		 *  \param Depth The number of KLVs that may be queued before the reading thread waits, rounded up to a power of two
+		 */
+		StreamDispatcher(MXFFilePtr File, GCReaderPtr Reader, unsigned int Depth = 64);
+
+		//! Wait for all queued KLVs to be dispatched
+		~StreamDispatcher() { Tasks.Wait(); }
+
+		//! Get the reader to use on the reading thread
+		/*! This is the stream's own reader when dispatching on the reading thread. Otherwise it is a positional reader
+		 *  whose filler handling follows that of the stream's own reader, and whose header-only and asynchronous read
+		 *  settings should be set to match.
+		 */
+		GCReaderPtr GetFramer(void);
+
+		//! Determine if KLVs are being dispatched by tasks, rather than on the reading thread
+		bool IsParallel(void) const { return Framer ? true : false; }
+
+		//! Determine if a handler has failed since the last call to Wait()
+		bool HasFailed(void) const { return Failed; }
+
+		//! Wait for all queued KLVs to be dispatched, helping with queued tasks meanwhile
+		/*! \return false if a handler has failed since the last call to Wait()
+		 */
+		bool Wait(void);
+
+	protected:
+		//! Queue a KLV framed on the reading thread, waiting if the ring is full
+		/*! \return false if a handler has failed, so reading should stop */
+		bool Push(KLVObjectPtr Object, Position FileOffset, Position StreamOffset);
+
+		//! Dispatch queued KLVs until the ring is empty, called by each drain task
+		void Drain(void);
+
+		//! Wake the reading thread if it is waiting for space
+		void WakeProducer(void);
+
+	private:
+		//! Prevent copy construction
+		StreamDispatcher(const StreamDispatcher &);
+	};
+}
+
+#endif // MXFLIB__STREAMDISPATCH_H
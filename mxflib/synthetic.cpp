@@ -0,0 +1,371 @@
+/*! \file	synthetic.cpp
+ *	\brief	Implementation of essence sources that generate synthetic essence for load testing
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! A simple repeatable random number generator, as the quality of the numbers is not important
+	class SyntheticRandom
+	{
+	protected:
+		UInt32 State;
+
+	public:
+		SyntheticRandom(UInt32 Seed) : State(Seed) {}
+
+		UInt32 Next(void)
+		{
+			State = (State * 1103515245) + 12345;
+			return State >> 8;
+		}
+	};
+
+	//! Index flags of a long-GOP I frame, which starts a closed GOP with a sequence header
+	const UInt8 FlagsI = 0xc0;
+
+	//! Index flags of a long-GOP P frame
+	const UInt8 FlagsP = 0x22;
+
+	//! Index flags of a long-GOP B frame
+	const UInt8 FlagsB = 0x33;
+}
+
+
+//! Build a source, generating all the frames it will return
+SyntheticEssenceSource::SyntheticEssenceSource(const SyntheticSettings &UseSettings)
+	: Settings(UseSettings), CurrentPos(0), SentBytes(0), AtEndOfItem(true), LastEditPoint(true), AnchorFrame(0)
+{
+	if((Settings.EditRate.Numerator <= 0) || (Settings.EditRate.Denominator <= 0)) Settings.EditRate = Rational(25, 1);
+
+	const UInt64 Num = static_cast<UInt64>(Settings.EditRate.Numerator);
+	const UInt64 Den = static_cast<UInt64>(Settings.EditRate.Denominator);
+
+	if(Settings.Channels)
+	{
+		if(Settings.Channels < 0) Settings.Channels = 1;
+		if(Settings.SampleBits < 1) Settings.SampleBits = 24;
+		if(!Settings.SampleRate) Settings.SampleRate = 48000;
+
+		// All edit units are slices of one buffer big enough for the largest, which may be one sample longer than the smallest
+		UInt64 MaxSamples = ((Settings.SampleRate * Den) + Num - 1) / Num;
+		Settings.FrameSize = static_cast<UInt32>(MaxSamples * Settings.Channels * ((Settings.SampleBits + 7) / 8));
+
+		Sizes.push_back(Settings.FrameSize);
+	}
+	else if(Settings.Pattern == SyntheticLongGOP)
+	{
+		if(Settings.GOPSize < 1) Settings.GOPSize = 1;
+		if(Settings.BFrames < 0) Settings.BFrames = 0;
+
+		// Build the GOP in coded order: each anchor frame is followed by the B frames displayed before it, and any frames
+		// displayed after the last anchor are coded as P frames so that the GOP remains closed
+		Temporal.push_back(0);
+		Flags.push_back(FlagsI);
+
+		const int Step = Settings.BFrames + 1;
+		int LastAnchor = 0;
+		int Anchor;
+		for(Anchor = Step; Anchor < Settings.GOPSize; Anchor += Step)
+		{
+			Temporal.push_back(Anchor);
+			Flags.push_back(FlagsP);
+
+			int i;
+			for(i = LastAnchor + 1; i < Anchor; i++)
+			{
+				Temporal.push_back(i);
+				Flags.push_back(FlagsB);
+			}
+
+			LastAnchor = Anchor;
+		}
+
+		int i;
+		for(i = LastAnchor + 1; i < Settings.GOPSize; i++)
+		{
+			Temporal.push_back(i);
+			Flags.push_back(FlagsP);
+		}
+	}
+
+	if(!Settings.Channels)
+	{
+		if(!Settings.FrameSize) Settings.FrameSize = static_cast<UInt32>((Settings.BitRate * Den) / (8 * Num));
+		if(!Settings.FrameSize) Settings.FrameSize = 1;
+
+		if(Settings.Pattern == SyntheticLongGOP)
+		{
+			// Share the bytes of each GOP between I, P and B frames in the ratio 4:2:1
+			UInt64 Weights = 0;
+			std::vector<UInt8>::iterator it = Flags.begin();
+			while(it != Flags.end())
+			{
+				Weights += (*it == FlagsI) ? 4 : ((*it == FlagsP) ? 2 : 1);
+				it++;
+			}
+
+			UInt64 GOPBytes = static_cast<UInt64>(Settings.FrameSize) * Settings.GOPSize;
+
+			it = Flags.begin();
+			while(it != Flags.end())
+			{
+				UInt64 Size = (GOPBytes * ((*it == FlagsI) ? 4 : ((*it == FlagsP) ? 2 : 1))) / Weights;
+				Sizes.push_back(Size ? static_cast<size_t>(Size) : 1);
+				it++;
+			}
+		}
+		else if(Settings.Pattern == SyntheticVBR)
+		{
+			if(Settings.PoolFrames < 1) Settings.PoolFrames = 1;
+			if(Settings.VBRRange < 0) Settings.VBRRange = 0;
+			if(Settings.VBRRange > 100) Settings.VBRRange = 100;
+
+			SyntheticRandom Rand(Settings.Seed);
+
+			int i;
+			for(i = 0; i < Settings.PoolFrames; i++)
+			{
+				int Percent = 100 - Settings.VBRRange + static_cast<int>(Rand.Next() % static_cast<UInt32>((2 * Settings.VBRRange) + 1));
+				UInt64 Size = (static_cast<UInt64>(Settings.FrameSize) * Percent) / 100;
+				Sizes.push_back(Size ? static_cast<size_t>(Size) : 1);
+			}
+		}
+		else
+		{
+			Sizes.push_back(Settings.FrameSize);
+		}
+	}
+
+	// Lay the frames out back to back so that runs of them can be returned as a single batch
+	size_t Total = 0;
+	std::vector<size_t>::iterator it = Sizes.begin();
+	while(it != Sizes.end())
+	{
+		Offsets.push_back(Total);
+		Total += *it;
+		it++;
+	}
+
+	Pool = new DataChunk(Total);
+
+	// Fill a word at a time, as a large pool of large frames would otherwise take a noticeable time to build
+	SyntheticRandom Rand(Settings.Seed);
+	UInt8 *p = Pool->Data;
+	size_t i;
+	for(i = 0; (i + 4) <= Total; i += 4)
+	{
+		PutU32(Rand.Next() ^ (Rand.Next() << 16), p);
+		p += 4;
+	}
+	for(; i < Total; i++) *(p++) = static_cast<UInt8>(Rand.Next());
+}
+
+
+//! Get the index of the pregenerated frame to use for a given edit unit
+size_t SyntheticEssenceSource::GetPoolIndex(Position EditUnit) const
+{
+	if(Sizes.size() == 1) return 0;
+	return static_cast<size_t>(EditUnit % static_cast<Position>(Sizes.size()));
+}
+
+
+//! Get the size of a given edit unit
+size_t SyntheticEssenceSource::GetSize(Position EditUnit) const
+{
+	if(!Settings.Channels) return Sizes[GetPoolIndex(EditUnit)];
+
+	// DRAGONS: The samples of each edit unit are rounded so that the stream stays in step with the edit rate, giving
+	//          the usual 1602/1601 sample cadence of 48kHz audio at 30000/1001
+	const UInt64 Scale = static_cast<UInt64>(Settings.SampleRate) * Settings.EditRate.Denominator;
+	const UInt64 Num = static_cast<UInt64>(Settings.EditRate.Numerator);
+	const UInt64 Unit = static_cast<UInt64>(EditUnit);
+
+	UInt64 Samples = (((Unit + 1) * Scale) / Num) - ((Unit * Scale) / Num);
+	return static_cast<size_t>(Samples * Settings.Channels * ((Settings.SampleBits + 7) / 8));
+}
+
+
+//! Offer the index entry of the edit unit about to be returned, and note if it is an edit point
+void SyntheticEssenceSource::StartEditUnit(void)
+{
+	if(Settings.Channels || (Settings.Pattern != SyntheticLongGOP))
+	{
+		LastEditPoint = true;
+		return;
+	}
+
+	int Coded = static_cast<int>(GetPoolIndex(CurrentPos));
+	UInt8 FrameFlags = Flags[Coded];
+
+	LastEditPoint = (FrameFlags == FlagsI);
+	if(LastEditPoint) AnchorFrame = CurrentPos;
+
+	if(!IndexMan) return;
+
+	// DRAGONS: As for MPEG, anchor offsets are negative and one out of range is set to 127 with bit 3 of the flags set
+	int AnchorOffset = static_cast<int>(AnchorFrame - CurrentPos);
+	int IndexFlags = FrameFlags;
+	if(AnchorOffset < -128)
+	{
+		AnchorOffset = 127;
+		IndexFlags |= 4;
+	}
+
+	IndexMan->OfferEditUnit(IndexStreamID, CurrentPos, AnchorOffset, IndexFlags);
+
+	int Display = Temporal[Coded];
+	IndexMan->OfferTemporalOffset(CurrentPos - Coded + Display, Coded - Display);
+}
+
+
+//! Get the size of the next "installment" of essence data in bytes
+size_t SyntheticEssenceSource::GetEssenceDataSize(void)
+{
+	if(EndOfData()) return 0;
+
+	return GetSize(CurrentPos) - SentBytes;
+}
+
+
+//! Get the next "installment" of essence data
+/*! \return The next edit unit, or the next part of it if MaxSize is smaller, or NULL at the end of the data */
+DataChunkPtr SyntheticEssenceSource::GetEssenceData(size_t Size /*=0*/, size_t MaxSize /*=0*/)
+{
+	if(EndOfData()) return NULL;
+
+	if(!SentBytes) StartEditUnit();
+
+	size_t Remaining = GetSize(CurrentPos) - SentBytes;
+	size_t Bytes = Remaining;
+	if(Size && (Bytes > Size)) Bytes = Size;
+	if(MaxSize && (Bytes > MaxSize)) Bytes = MaxSize;
+
+	DataChunkPtr Ret = Pool->Slice(Offsets[GetPoolIndex(CurrentPos)] + SentBytes, Bytes);
+
+	if(Bytes == Remaining)
+	{
+		CurrentPos++;
+		SentBytes = 0;
+		AtEndOfItem = true;
+	}
+	else
+	{
+		SentBytes += Bytes;
+		AtEndOfItem = false;
+	}
+
+	return Ret;
+}
+
+
+//! Get a run of whole edit units in one call, sharing the buffer of the pregenerated frames
+EssenceBatchPtr SyntheticEssenceSource::GetEssenceBatch(size_t MaxUnits, size_t MaxBytes)
+{
+	// Sound edit units are all slices from the start of the pool, so are not back to back
+	if(Settings.Channels) return NULL;
+
+	if(IndexMan && (Settings.Pattern == SyntheticLongGOP)) return NULL;
+	if(SentBytes || EndOfData()) return NULL;
+
+	EssenceBatchPtr Ret = new EssenceBatch;
+	Ret->FirstPosition = CurrentPos;
+
+	// A batch ends where the pool wraps back to its first frame
+	size_t Start = Offsets[GetPoolIndex(CurrentPos)];
+	size_t Bytes = 0;
+	while((Ret->size() < MaxUnits) && (!EndOfData()))
+	{
+		size_t Size = GetSize(CurrentPos);
+		if(Ret->size())
+		{
+			if((GetPoolIndex(CurrentPos) == 0) || (MaxBytes && ((Bytes + Size) > MaxBytes))) break;
+		}
+
+		StartEditUnit();
+
+		Ret->Sizes.push_back(Size);
+		Ret->EditPoints.push_back(LastEditPoint);
+		Bytes += Size;
+		CurrentPos++;
+	}
+
+	Ret->Buffer = Pool->Slice(Start, Bytes);
+	AtEndOfItem = true;
+
+	return Ret;
+}
+
+
+//! Get BytesPerEditUnit if Constant, else 0
+UInt32 SyntheticEssenceSource::GetBytesPerEditUnit(UInt32 KAGSize /*=1*/)
+{
+	if(Sizes.size() != 1) return 0;
+
+	// Sound is only constant if each edit unit holds a whole number of samples
+	if(Settings.Channels && ((Settings.SampleRate * static_cast<UInt64>(Settings.EditRate.Denominator)) % Settings.EditRate.Numerator)) return 0;
+
+	// DRAGONS: This assumes that 4-byte BER lengths are used, as does the WAVE parser
+	UInt32 Ret = Settings.FrameSize + 16 + 4;
+
+	if(KAGSize > 1)
+	{
+		UInt32 Remainder = Ret % KAGSize;
+		if(Remainder) Remainder = KAGSize - Remainder;
+		Ret += Remainder;
+
+		// If there is not enough space to fit a filler in the remaining space an extra KAG will be required
+		while((Remainder > 0) && (Remainder < 17))
+		{
+			Ret += KAGSize;
+			Remainder += KAGSize;
+		}
+	}
+
+	return Ret;
+}
+
+
+//! Move directly to a given edit unit
+bool SyntheticEssenceSource::SkipTo(Position EditUnit)
+{
+	if((EditUnit < 0) || ((Settings.Duration >= 0) && (EditUnit > Settings.Duration))) return false;
+
+	CurrentPos = EditUnit;
+	SentBytes = 0;
+	AtEndOfItem = true;
+
+	// The anchor is the I frame that starts the GOP, as every GOP is closed
+	if(!Temporal.empty()) AnchorFrame = CurrentPos - static_cast<Position>(GetPoolIndex(CurrentPos));
+
+	return true;
+}
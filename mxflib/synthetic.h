@@ -0,0 +1,175 @@
+/*! \file	synthetic.h
+ *	\brief	Definition of essence sources that generate synthetic essence for load testing
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  A SyntheticEssenceSource hands out frames that are generated once when it is built and then returned by reference,
+ *  so it can feed a BodyWriter, the IndexManager and the storage below them far faster than any real essence parser,
+ *  without needing any media. Picture streams may be CBR, VBR or long-GOP, in which case they also offer the index
+ *  entries and temporal offsets of an MPEG-like GOP structure, and sound streams carry any number of PCM channels.
+ *  The essence bytes are repeatable pseudo-random values, so they do not compress or de-duplicate in the storage
+ *  under test, but they are not decodable pictures or sound.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__SYNTHETIC_H
+#define MXFLIB__SYNTHETIC_H
+
+namespace mxflib
+{
+	//! The pattern of frame sizes of a synthetic picture stream
+	enum SyntheticPattern
+	{
+		SyntheticCBR,							//!< Every frame is the same size
+		SyntheticVBR,							//!< Frame sizes vary at random around the average size
+		SyntheticLongGOP						//!< Frames follow an MPEG-like GOP of I, P and B frames, stored in coded order
+	};
+
+	//! The settings of a synthetic essence stream
+	struct SyntheticSettings
+	{
+		Rational EditRate;						//!< The edit rate of the stream
+		Length Duration;						//!< The number of edit units to return, or -1 for no end
+
+		/* Picture settings, used if Channels is 0 */
+
+		SyntheticPattern Pattern;				//!< The pattern of frame sizes
+		UInt32 FrameSize;						//!< The average number of bytes per frame, or 0 to set it from BitRate
+		UInt64 BitRate;							//!< The average bit rate, used if FrameSize is 0
+		int VBRRange;							//!< The percentage that VBR frame sizes vary above and below the average
+		int GOPSize;							//!< The number of frames in each long-GOP, each GOP is closed and starts with an I frame
+		int BFrames;							//!< The number of B frames between anchor frames in a long-GOP
+		int PoolFrames;							//!< The number of different VBR frames to generate, which are then returned in turn
+		UInt8 ElementType;						//!< The GC element type of the picture
+
+		/* Sound settings */
+
+		int Channels;							//!< The number of sound channels, or 0 for picture
+		int SampleBits;							//!< The number of bits per sample, rounded up to whole bytes
+		UInt32 SampleRate;						//!< The number of samples per second
+
+		UInt32 Seed;							//!< The seed of the essence bytes and VBR sizes, so that runs are repeatable
+
+		SyntheticSettings() : EditRate(25, 1), Duration(250), Pattern(SyntheticCBR), FrameSize(0), BitRate(50000000),
+							  VBRRange(50), GOPSize(12), BFrames(2), PoolFrames(64), ElementType(0x05),
+							  Channels(0), SampleBits(24), SampleRate(48000), Seed(1) {}
+	};
+
+
+	//! An essence source that returns synthetic frames generated when it is built
+	/*! Frames are returned as slices sharing the buffer of the pregenerated frames, which are copied only if the caller
+	 *  modifies them, so each call costs little more than a DataChunk allocation.
+	 *  DRAGONS: As the frames are generated by the constructor, building a source for a large frame size or a large
+	 *           PoolFrames takes time and memory, so build sources before starting any timing
+	 */
+	class SyntheticEssenceSource : public EssenceSource
+	{
+	protected:
+		SyntheticSettings Settings;				//!< Our settings, with FrameSize set
+		DataChunkPtr Pool;						//!< The pregenerated frames, back to back
+		std::vector<size_t> Offsets;			//!< The offset in Pool of each pregenerated frame
+		std::vector<size_t> Sizes;				//!< The size of each pregenerated frame
+		std::vector<int> Temporal;				//!< For long-GOP, the display order of each frame of the GOP, in coded order
+		std::vector<UInt8> Flags;				//!< For long-GOP, the index flags of each frame of the GOP, in coded order
+
+		Position CurrentPos;					//!< The number of whole edit units returned
+		size_t SentBytes;						//!< Bytes of the current edit unit already returned, if returning it in pieces
+		bool AtEndOfItem;						//!< True if the last call to GetEssenceData() returned the end of an edit unit
+		bool LastEditPoint;						//!< True if the last edit unit started was an edit point
+		Position AnchorFrame;					//!< For long-GOP, the position of the most recent I frame
+
+	public:
+		//! Build a source, generating all the frames it will return
+		SyntheticEssenceSource(const SyntheticSettings &UseSettings);
+
+		//! Get the size of the next "installment" of essence data in bytes
+		virtual size_t GetEssenceDataSize(void);
+
+		//! Get the next "installment" of essence data
+		virtual DataChunkPtr GetEssenceData(size_t Size = 0, size_t MaxSize = 0);
+
+		//! Get a run of whole edit units in one call, sharing the buffer of the pregenerated frames
+		/*! \note Batches are not returned for sound, or for an indexed long-GOP stream as its index entries are offered as each edit unit is read */
+		virtual EssenceBatchPtr GetEssenceBatch(size_t MaxUnits, size_t MaxBytes);
+
+		//! Did the last call to GetEssenceData() return the end of a wrapping item
+		virtual bool EndOfItem(void) { return AtEndOfItem; }
+
+		//! Is all data exhasted?
+		virtual bool EndOfData(void) { return (Settings.Duration >= 0) && (CurrentPos >= Settings.Duration); }
+
+		//! Get the GCEssenceType to use when wrapping this essence in a Generic Container
+		virtual UInt8 GetGCEssenceType(void) { return Settings.Channels ? 0x16 : 0x15; }
+
+		//! Get the GCEssenceType to use when wrapping this essence in a Generic Container
+		virtual UInt8 GetGCElementType(void) { return Settings.Channels ? 0x01 : Settings.ElementType; }
+
+		//! Is the last data read the start of an edit point?
+		virtual bool IsEditPoint(void) { return LastEditPoint; }
+
+		//! Get the edit rate of this wrapping of the essence
+		virtual Rational GetEditRate(void) { return Settings.EditRate; }
+
+		//! Get the current position in GetEditRate() sized edit units
+		virtual Position GetCurrentPosition(void) { return CurrentPos; }
+
+		//! Get BytesPerEditUnit if Constant, else 0
+		virtual UInt32 GetBytesPerEditUnit(UInt32 KAGSize = 1);
+
+		//! Can this stream provide indexing
+		/*! Long-GOP streams offer their own index entries, the offsets of all streams are set by the GCWriter */
+		virtual bool CanIndex() { return true; }
+
+		//! Set the index manager to use for building index tables for this essence
+		virtual void SetIndexManager(IndexManagerPtr &Manager, int StreamID)
+		{
+			EssenceSource::SetIndexManager(Manager, StreamID);
+
+			// Long-GOP entries are offered in coded order, so they must be reordered
+			if((Settings.Pattern == SyntheticLongGOP) && (!Settings.Channels)) Manager->SetPosTableIndex(StreamID, -1);
+		}
+
+		//! Move directly to a given edit unit
+		virtual bool SkipTo(Position EditUnit);
+
+		//! Get the name of this essence source (used for error messeges)
+		virtual std::string Name(void) { return Settings.Channels ? "Synthetic sound" : "Synthetic picture"; }
+
+		//! Get the settings of this source, with FrameSize set for picture or the largest edit unit size for sound
+		const SyntheticSettings &GetSettings(void) const { return Settings; }
+
+	protected:
+		//! Get the index of the pregenerated frame to use for a given edit unit
+		size_t GetPoolIndex(Position EditUnit) const;
+
+		//! Get the size of a given edit unit
+		size_t GetSize(Position EditUnit) const;
+
+		//! Offer the index entry of the edit unit about to be returned, and note if it is an edit point
+		void StartEditUnit(void);
+	};
+}
+
+#endif // MXFLIB__SYNTHETIC_H
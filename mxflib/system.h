@@ -224,6 +224,7 @@ namespace mxflib
 #include <fcntl.h>			//!< for _O_BINARY etc
 #include <sys/stat.h>		//!< for _S_IREAD, _S_IWRITE
 #include <sys/timeb.h>		//!< for _timeb
+#include <malloc.h>			//!< for _aligned_malloc
 
 
 // Define special func pointer for use in determining OS varient
@@ -269,6 +270,137 @@ namespace mxflib
 	inline bool FileExists(const char *filename) { struct _stat buf; return _stat(filename, &buf) == 0; }
 	inline int FileDelete(const char *filename) { return _unlink(filename); }
 	inline Int64 FileSize(FileHandle file) { struct _stat64 buf; return _fstat64(file, &buf) != 0 ? -1 : buf.st_size; } 
+	inline Int64 FileModTime(const char *filename) { struct _stat64 buf; return _stat64(filename, &buf) != 0 ? -1 : static_cast<Int64>(buf.st_mtime); }
+
+	//! Map the first size bytes of an open file into memory as a read-only view
+	/*! \return pointer to the mapped data, or NULL if the file could not be mapped
+	 *  \note Writing to the mapped data faults, so a stray write can't change what other readers of the mapping see
+	 */
+	inline UInt8 *FileMemoryMap(FileHandle file, UInt64 size)
+	{
+		// Don't attempt to map empty files, or files too large for our address space
+		if((size == 0) || (size != static_cast<UInt64>(static_cast<size_t>(size)))) return NULL;
+
+		HANDLE Mapping = CreateFileMapping((HANDLE)_get_osfhandle(file), NULL, PAGE_READONLY, 0, 0, NULL);
+		if(!Mapping) return NULL;
+
+		// DRAGONS: The view holds its own reference to the mapping, so we can close our handle straight away
+		void *Ret = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, static_cast<size_t>(size));
+		CloseHandle(Mapping);
+
+		return static_cast<UInt8*>(Ret);
+	}
+	inline void FileMemoryUnmap(UInt8 *map, UInt64 /*size*/) { UnmapViewOfFile(map); }
+
+	//! Tell the OS that a region of an open file will be read soon (not supported on this platform, so does nothing)
+	inline void FilePrefetch(FileHandle /*file*/, UInt64 /*offset*/, UInt64 /*size*/) {}
+
+	//! Read from a given position of an open file, so that several threads may read the same handle at once
+	/*! DRAGONS: On this platform the read still moves the file pointer of a synchronous handle, so positional reads
+	 *           must not be mixed with FileSeek() and FileRead() on another thread
+	 */
+	inline size_t FileReadAt(FileHandle file, UInt64 offset, unsigned char *dest, size_t size)
+	{
+		OVERLAPPED Pos;
+		memset(&Pos, 0, sizeof(Pos));
+		Pos.Offset = static_cast<DWORD>(offset);
+		Pos.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+		DWORD Bytes;
+		if(!ReadFile((HANDLE)_get_osfhandle(file), dest, static_cast<DWORD>(size), &Bytes, &Pos))
+		{
+			// Reading at the end of the file is not an error
+			return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : static_cast<size_t>(-1);
+		}
+		return static_cast<size_t>(Bytes);
+	}
+
+	//! Write at a given position of an open file, without using the file pointer
+	/*! DRAGONS: As for FileReadAt(), the file pointer of a synchronous handle is still moved */
+	inline size_t FileWriteAt(FileHandle file, UInt64 offset, const unsigned char *source, size_t size)
+	{
+		OVERLAPPED Pos;
+		memset(&Pos, 0, sizeof(Pos));
+		Pos.Offset = static_cast<DWORD>(offset);
+		Pos.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+		DWORD Written;
+		if(!WriteFile((HANDLE)_get_osfhandle(file), source, static_cast<DWORD>(size), &Written, &Pos)) return static_cast<size_t>(-1);
+		return static_cast<size_t>(Written);
+	}
+
+	//! Copy a range of one open file to the current position of another, moving the destination file pointer
+	/*! On this platform the data is copied through a buffer.
+	 *  DRAGONS: As for FileReadAt(), the file pointer of a synchronous source handle is moved
+	 *  \return The number of bytes copied, which is only less than size at the end of the source or on error
+	 */
+	inline UInt64 FileCopyRange(FileHandle dest, FileHandle src, UInt64 offset, UInt64 size)
+	{
+		UInt64 Ret = 0;
+
+		const size_t BufferSize = 1024 * 1024;
+		unsigned char *Buffer = new unsigned char[BufferSize];
+		while(Ret < size)
+		{
+			size_t Chunk = (size - Ret) > BufferSize ? BufferSize : static_cast<size_t>(size - Ret);
+			size_t Bytes = FileReadAt(src, offset + Ret, Buffer, Chunk);
+			if((Bytes == 0) || (Bytes == static_cast<size_t>(-1))) break;
+
+			size_t Written = FileWrite(dest, Buffer, Bytes);
+			Ret += Written;
+			if(Written != Bytes) break;
+		}
+		delete[] Buffer;
+
+		return Ret;
+	}
+
+	//! Handle for unbuffered writes to a file, which bypass the OS cache
+	typedef HANDLE DirectFileHandle;
+
+	//! Open an existing file for unbuffered writing
+	/*! All writes must be a multiple of the sector size, at an offset that is a multiple of the sector size, from memory aligned to the sector size */
+	inline DirectFileHandle FileOpenDirect(const char *filename)
+	{
+		return CreateFileA(filename, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, NULL);
+	}
+	inline bool DirectFileValid(DirectFileHandle file) { return (file != INVALID_HANDLE_VALUE); }
+	inline size_t FileWriteDirect(DirectFileHandle file, const unsigned char *source, size_t size, UInt64 offset)
+	{
+		OVERLAPPED Pos;
+		memset(&Pos, 0, sizeof(Pos));
+		Pos.Offset = static_cast<DWORD>(offset);
+		Pos.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+		DWORD Written;
+		if(!WriteFile(file, source, static_cast<DWORD>(size), &Written, &Pos)) return static_cast<size_t>(-1);
+		return static_cast<size_t>(Written);
+	}
+	inline void FileCloseDirect(DirectFileHandle file) { CloseHandle(file); }
+
+	//! Reserve disk space for an open file without changing its length, so that it can be written without fragmenting
+	/*! \return true if the space was reserved, false if not supported */
+	inline bool FilePreallocate(FileHandle file, UInt64 size)
+	{
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0600)
+		FILE_ALLOCATION_INFO Info;
+		Info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+		return SetFileInformationByHandle((HANDLE)_get_osfhandle(file), FileAllocationInfo, &Info, sizeof(Info)) ? true : false;
+#else
+		return false;
+#endif
+	}
+
+	//! Release any space reserved by FilePreallocate() beyond the end of the file
+	/*! DRAGONS: Windows releases this itself when the file is closed */
+	inline void FileTrimAllocation(FileHandle /*file*/) {}
+
+	//! Set the length of an open file, discarding anything after the given size
+	inline bool FileTruncate(FileHandle file, UInt64 size) { return _chsize_s(file, static_cast<__int64>(size)) == 0; }
+
+	//! Allocate memory aligned to a given boundary, as required for unbuffered writes
+	inline UInt8 *AlignedAlloc(size_t size, size_t align) { return static_cast<UInt8*>(_aligned_malloc(size, align)); }
+	inline void AlignedFree(UInt8 *buffer) { _aligned_free(buffer); }
 
 #endif //MXFLIB_NO_FILE_IO
 
@@ -285,6 +417,15 @@ namespace mxflib
 		return Ret;
 	}
 
+	//! Get a monotonic time in microseconds, for measuring intervals
+	inline UInt64 GetMicroseconds(void)
+	{
+		LARGE_INTEGER Count, Freq;
+		QueryPerformanceCounter(&Count);
+		QueryPerformanceFrequency(&Freq);
+		return static_cast<UInt64>(Count.QuadPart / Freq.QuadPart) * 1000000 + static_cast<UInt64>(((Count.QuadPart % Freq.QuadPart) * 1000000) / Freq.QuadPart);
+	}
+
 	/******** UUID Generation ********/
 	inline void MakeUUID(UInt8 *Buffer)
 	{
@@ -428,6 +569,15 @@ namespace mxflib
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/sendfile.h>
+#endif
 
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
@@ -544,6 +694,202 @@ namespace mxflib
 	inline bool FileExists(const char *filename) { struct stat buf; return stat(filename, &buf) == 0; }
 	inline int FileDelete(const char *filename) { return unlink(filename); }
 	inline Int64 FileSize(FileHandle file) { struct stat64 buf; return fstat64(fileno(file), &buf) != 0 ? -1 : buf.st_size; } 
+	inline Int64 FileModTime(const char *filename) { struct stat64 buf; return stat64(filename, &buf) != 0 ? -1 : static_cast<Int64>(buf.st_mtime); }
+
+	//! Map the first size bytes of an open file into memory as a read-only view
+	/*! \return pointer to the mapped data, or NULL if the file could not be mapped
+	 *  \note Writing to the mapped data faults, so a stray write can't change what other readers of the mapping see
+	 */
+	inline UInt8 *FileMemoryMap(FileHandle file, UInt64 size)
+	{
+		// Don't attempt to map empty files, or files too large for our address space
+		if((size == 0) || (size != static_cast<UInt64>(static_cast<size_t>(size)))) return NULL;
+
+		void *Ret = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		return (Ret == MAP_FAILED) ? NULL : static_cast<UInt8*>(Ret);
+	}
+	inline void FileMemoryUnmap(UInt8 *map, UInt64 size) { munmap(map, static_cast<size_t>(size)); }
+
+	//! Tell the OS that a region of an open file will be read soon, so that it can start reading it in the background
+	inline void FilePrefetch(FileHandle file, UInt64 offset, UInt64 size)
+	{
+#ifdef POSIX_FADV_WILLNEED
+		posix_fadvise(fileno(file), static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_WILLNEED);
+#endif
+	}
+
+	//! Read from a given position of an open file, so that several threads may read the same handle at once
+	/*! The file pointer is not used or moved.
+	 *  DRAGONS: This bypasses the stdio buffer, so data written with FileWrite() is only seen once it has been flushed
+	 */
+	inline size_t FileReadAt(FileHandle file, UInt64 offset, unsigned char *dest, size_t size)
+	{
+		size_t Ret = 0;
+		while(size)
+		{
+			ssize_t Bytes = pread(fileno(file), dest, size, static_cast<off_t>(offset));
+			if(Bytes < 0)
+			{
+				if(errno == EINTR) continue;
+				return Ret ? Ret : static_cast<size_t>(-1);
+			}
+
+			// End of file
+			if(Bytes == 0) break;
+
+			dest += Bytes;
+			offset += Bytes;
+			size -= Bytes;
+			Ret += Bytes;
+		}
+
+		return Ret;
+	}
+
+	//! Write at a given position of an open file, without using or moving the file pointer
+	/*! DRAGONS: This bypasses the stdio buffer, so any data written with FileWrite() should be flushed first */
+	inline size_t FileWriteAt(FileHandle file, UInt64 offset, const unsigned char *source, size_t size)
+	{
+		ssize_t Ret = pwrite(fileno(file), source, size, static_cast<off_t>(offset));
+		return (Ret < 0) ? static_cast<size_t>(-1) : static_cast<size_t>(Ret);
+	}
+
+	//! Copy a range of one open file to the current position of another, moving the destination file pointer
+	/*! Where the OS supports it the data is copied in the kernel, or the blocks are shared by the filesystem, without passing
+	 *  through user space. The source file pointer is not used or moved.
+	 *  \return The number of bytes copied, which is only less than size at the end of the source or on error
+	 */
+	inline UInt64 FileCopyRange(FileHandle dest, FileHandle src, UInt64 offset, UInt64 size)
+	{
+		fflush(dest);
+		UInt64 DestPos = static_cast<UInt64>(ftello(dest));
+		UInt64 Ret = 0;
+
+#ifdef __linux__
+		// Limit each call to 1GB so that the counts fit in an ssize_t everywhere
+		const UInt64 MaxChunk = 1024 * 1024 * 1024;
+		int DestFD = fileno(dest);
+		int SrcFD = fileno(src);
+
+#ifdef SYS_copy_file_range
+		// This will share the blocks rather than copy them on filesystems that support reflinks
+		loff_t In = static_cast<loff_t>(offset);
+		loff_t Out = static_cast<loff_t>(DestPos);
+		while(Ret < size)
+		{
+			UInt64 Chunk = (size - Ret) > MaxChunk ? MaxChunk : (size - Ret);
+			ssize_t Bytes = syscall(SYS_copy_file_range, SrcFD, &In, DestFD, &Out, static_cast<size_t>(Chunk), 0U);
+			if((Bytes < 0) && (errno == EINTR)) continue;
+			if(Bytes <= 0) break;
+
+			Ret += Bytes;
+		}
+#endif // SYS_copy_file_range
+
+		// DRAGONS: sendfile() writes at the file pointer of the destination, so we move it to the end of any data already copied
+		if((Ret < size) && (lseek(DestFD, static_cast<off_t>(DestPos + Ret), SEEK_SET) != static_cast<off_t>(-1)))
+		{
+			off_t In = static_cast<off_t>(offset + Ret);
+			while(Ret < size)
+			{
+				UInt64 Chunk = (size - Ret) > MaxChunk ? MaxChunk : (size - Ret);
+				ssize_t Bytes = sendfile(DestFD, SrcFD, &In, static_cast<size_t>(Chunk));
+				if((Bytes < 0) && (errno == EINTR)) continue;
+				if(Bytes <= 0) break;
+
+				Ret += Bytes;
+			}
+		}
+#endif // __linux__
+
+		// Resynchronize the stdio file pointer with any data copied above
+		fseeko(dest, static_cast<off_t>(DestPos + Ret), SEEK_SET);
+
+		// Copy anything left through a buffer
+		if(Ret < size)
+		{
+			const size_t BufferSize = 1024 * 1024;
+			unsigned char *Buffer = new unsigned char[BufferSize];
+			while(Ret < size)
+			{
+				size_t Chunk = (size - Ret) > BufferSize ? BufferSize : static_cast<size_t>(size - Ret);
+				size_t Bytes = FileReadAt(src, offset + Ret, Buffer, Chunk);
+				if((Bytes == 0) || (Bytes == static_cast<size_t>(-1))) break;
+
+				size_t Written = fwrite(Buffer, 1, Bytes, dest);
+				Ret += Written;
+				if(Written != Bytes) break;
+			}
+			delete[] Buffer;
+		}
+
+		return Ret;
+	}
+
+	//! Handle for unbuffered writes to a file, which bypass the OS cache
+	typedef int DirectFileHandle;
+
+	//! Open an existing file for unbuffered writing
+	/*! All writes must be a multiple of the block size, at an offset that is a multiple of the block size, from memory aligned to the block size
+	 *  \note Where O_DIRECT is not available the OS is asked not to cache the data, if supported
+	 */
+	inline DirectFileHandle FileOpenDirect(const char *filename)
+	{
+#if defined(O_DIRECT)
+		return open(filename, O_WRONLY | O_DIRECT);
+#elif defined(F_NOCACHE)
+		int Ret = open(filename, O_WRONLY);
+		if(Ret >= 0) fcntl(Ret, F_NOCACHE, 1);
+		return Ret;
+#else
+		return -1;
+#endif
+	}
+	inline bool DirectFileValid(DirectFileHandle file) { return (file >= 0); }
+	inline size_t FileWriteDirect(DirectFileHandle file, const unsigned char *source, size_t size, UInt64 offset)
+	{
+		ssize_t Ret = pwrite(file, source, size, static_cast<off_t>(offset));
+		return (Ret < 0) ? static_cast<size_t>(-1) : static_cast<size_t>(Ret);
+	}
+	inline void FileCloseDirect(DirectFileHandle file) { close(file); }
+
+	//! Reserve disk space for an open file without changing its length, so that it can be written without fragmenting
+	/*! \return true if the space was reserved, false if not supported */
+	inline bool FilePreallocate(FileHandle file, UInt64 size)
+	{
+#if defined(FALLOC_FL_KEEP_SIZE)
+		return fallocate64(fileno(file), FALLOC_FL_KEEP_SIZE, 0, static_cast<off64_t>(size)) == 0;
+#else
+		return false;
+#endif
+	}
+
+	//! Release any space reserved by FilePreallocate() beyond the end of the file
+	inline void FileTrimAllocation(FileHandle file)
+	{
+#if defined(FALLOC_FL_KEEP_SIZE)
+		// DRAGONS: Truncating to the current length frees any blocks allocated after the end
+		fflush(file);
+		struct stat64 buf;
+		if(fstat64(fileno(file), &buf) == 0) { int Ret = ftruncate64(fileno(file), buf.st_size); (void)Ret; }
+#endif
+	}
+
+	//! Set the length of an open file, discarding anything after the given size
+	inline bool FileTruncate(FileHandle file, UInt64 size)
+	{
+		fflush(file);
+		return ftruncate(fileno(file), static_cast<off_t>(size)) == 0;
+	}
+
+	//! Allocate memory aligned to a given boundary, as required for unbuffered writes
+	inline UInt8 *AlignedAlloc(size_t size, size_t align)
+	{
+		void *Ret;
+		if(posix_memalign(&Ret, align, size) != 0) return NULL;
+		return static_cast<UInt8*>(Ret);
+	}
+	inline void AlignedFree(UInt8 *buffer) { free(buffer); }
 #endif //MXFLIB_NO_FILE_IO
 
 	/********* Acurate time *********/
@@ -561,6 +907,16 @@ namespace mxflib
 		return Ret;
 	}
 
+	//! Get a time in microseconds, for measuring intervals
+	inline UInt64 GetMicroseconds(void)
+	{
+		struct timeval	tv;
+
+		gettimeofday(&tv, NULL);
+
+		return static_cast<UInt64>(tv.tv_sec) * 1000000 + static_cast<UInt64>(tv.tv_usec);
+	}
+
 	/******** UUID Generation ********/
 #ifdef HAVE_UUID_GENERATE
 	inline void MakeUUID(UInt8 *Buffer)
@@ -664,6 +1020,27 @@ namespace mxflib
 	void FileFlush(FileHandle file) ; 
 	bool FileExists(const char *filename);
 	int FileDelete(const char *filename);
+
+	// Unbuffered writing is not available with client supplied file-I/O
+	typedef UInt32 DirectFileHandle;
+	inline DirectFileHandle FileOpenDirect(const char *) { return 0; }
+	inline bool DirectFileValid(DirectFileHandle) { return false; }
+	inline size_t FileWriteDirect(DirectFileHandle, const unsigned char *, size_t, UInt64) { return static_cast<size_t>(-1); }
+	inline void FileCloseDirect(DirectFileHandle) {}
+	inline UInt8 *AlignedAlloc(size_t, size_t) { return NULL; }
+	inline void AlignedFree(UInt8 *) {}
+
+	// Nor is preallocation
+	inline bool FilePreallocate(FileHandle, UInt64) { return false; }
+	inline void FileTrimAllocation(FileHandle) {}
+	inline bool FileTruncate(FileHandle, UInt64) { return false; }
+
+	// Nor are positional reads and writes
+	inline size_t FileReadAt(FileHandle, UInt64, unsigned char *, size_t) { return static_cast<size_t>(-1); }
+	inline size_t FileWriteAt(FileHandle, UInt64, const unsigned char *, size_t) { return static_cast<size_t>(-1); }
+
+	// Nor are copies between files, which callers must do through a buffer
+	inline UInt64 FileCopyRange(FileHandle, FileHandle, UInt64, UInt64) { return 0; }
 }
 #endif // MXFLIB_NO_FILE_IO
 
@@ -0,0 +1,230 @@
+/*! \file	thread.h
+ *	\brief	Simple portable threading primitives
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  These wrappers give the minimum needed for MXFLib to run work on a background thread:
+ *  a mutex, a condition variable, a thread base class and thread-local storage. They use Win32 threads when
+ *  _WIN32 is defined, otherwise POSIX threads.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__THREAD_H
+#define MXFLIB__THREAD_H
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+//! Storage class for a variable that has a separate copy for each thread
+/*! DRAGONS: Only suitable for plain data (such as pointers) with constant initialisers */
+#ifdef _WIN32
+#define MXFLIB_THREAD_LOCAL __declspec(thread)
+#else
+#define MXFLIB_THREAD_LOCAL __thread
+#endif
+
+namespace mxflib
+{
+	//! A simple (non-recursive) mutex
+	class Mutex
+	{
+	protected:
+#ifdef _WIN32
+		CRITICAL_SECTION Section;
+#else
+		pthread_mutex_t Handle;
+#endif
+
+		friend class Condition;
+
+	public:
+#ifdef _WIN32
+		Mutex() { InitializeCriticalSection(&Section); }
+		~Mutex() { DeleteCriticalSection(&Section); }
+
+		//! Lock the mutex, waiting until it is available
+		void Lock(void) { EnterCriticalSection(&Section); }
+
+		//! Unlock the mutex
+		void Unlock(void) { LeaveCriticalSection(&Section); }
+#else
+		Mutex() { pthread_mutex_init(&Handle, NULL); }
+		~Mutex() { pthread_mutex_destroy(&Handle); }
+
+		//! Lock the mutex, waiting until it is available
+		void Lock(void) { pthread_mutex_lock(&Handle); }
+
+		//! Unlock the mutex
+		void Unlock(void) { pthread_mutex_unlock(&Handle); }
+#endif
+
+	private:
+		//! Prevent copy construction
+		Mutex(const Mutex &);
+
+		//! Prevent assignment
+		Mutex &operator=(const Mutex &);
+	};
+
+
+	//! Lock a mutex for the lifetime of this object
+	class MutexLock
+	{
+	protected:
+		Mutex &Locked;								//!< The mutex we hold
+
+	public:
+		MutexLock(Mutex &ToLock) : Locked(ToLock) { Locked.Lock(); }
+		~MutexLock() { Locked.Unlock(); }
+
+	private:
+		//! Prevent copy construction
+		MutexLock(const MutexLock &);
+
+		//! Prevent assignment
+		MutexLock &operator=(const MutexLock &);
+	};
+
+
+	//! A condition variable, used with a Mutex to wait for a change of state
+	class Condition
+	{
+	protected:
+#ifdef _WIN32
+		CONDITION_VARIABLE Handle;
+#else
+		pthread_cond_t Handle;
+#endif
+
+	public:
+#ifdef _WIN32
+		Condition() { InitializeConditionVariable(&Handle); }
+		~Condition() {}
+
+		//! Wait for the condition to be signalled
+		/*! \note The mutex must be locked by the caller, and will be locked again on return */
+		void Wait(Mutex &Lock) { SleepConditionVariableCS(&Handle, &Lock.Section, INFINITE); }
+
+		//! Wake one waiting thread
+		void Signal(void) { WakeConditionVariable(&Handle); }
+
+		//! Wake all waiting threads
+		void Broadcast(void) { WakeAllConditionVariable(&Handle); }
+#else
+		Condition() { pthread_cond_init(&Handle, NULL); }
+		~Condition() { pthread_cond_destroy(&Handle); }
+
+		//! Wait for the condition to be signalled
+		/*! \note The mutex must be locked by the caller, and will be locked again on return */
+		void Wait(Mutex &Lock) { pthread_cond_wait(&Handle, &Lock.Handle); }
+
+		//! Wake one waiting thread
+		void Signal(void) { pthread_cond_signal(&Handle); }
+
+		//! Wake all waiting threads
+		void Broadcast(void) { pthread_cond_broadcast(&Handle); }
+#endif
+
+	private:
+		//! Prevent copy construction
+		Condition(const Condition &);
+
+		//! Prevent assignment
+		Condition &operator=(const Condition &);
+	};
+
+
+	//! Base class for an object that runs its Run() function on a new thread
+	/*! DRAGONS: Join() must be called before the derived object is destroyed, as the base destructor
+	 *           runs too late to stop the thread using the derived members
+	 */
+	class Thread
+	{
+	protected:
+		bool Running;								//!< True once Start() has succeeded and until Join() returns
+#ifdef _WIN32
+		HANDLE Handle;
+#else
+		pthread_t Handle;
+#endif
+
+	public:
+		Thread() : Running(false) {}
+		virtual ~Thread() {}
+
+		//! Start running Run() on a new thread
+		/*! \return false if the thread could not be started */
+		bool Start(void)
+		{
+			if(Running) return true;
+
+#ifdef _WIN32
+			Handle = CreateThread(NULL, 0, Entry, this, 0, NULL);
+			Running = (Handle != NULL);
+#else
+			Running = (pthread_create(&Handle, NULL, Entry, this) == 0);
+#endif
+			return Running;
+		}
+
+		//! Wait for Run() to return
+		void Join(void)
+		{
+			if(!Running) return;
+
+#ifdef _WIN32
+			WaitForSingleObject(Handle, INFINITE);
+			CloseHandle(Handle);
+#else
+			pthread_join(Handle, NULL);
+#endif
+			Running = false;
+		}
+
+		//! Determine if the thread has been started and not yet joined
+		bool IsRunning(void) const { return Running; }
+
+	protected:
+		//! The function to run on the new thread
+		virtual void Run(void) = 0;
+
+	private:
+		//! Entry point for the new thread
+#ifdef _WIN32
+		static DWORD WINAPI Entry(LPVOID This) { static_cast<Thread*>(This)->Run(); return 0; }
+#else
+		static void *Entry(void *This) { static_cast<Thread*>(This)->Run(); return NULL; }
+#endif
+
+		//! Prevent copy construction
+		Thread(const Thread &);
+
+		//! Prevent assignment
+		Thread &operator=(const Thread &);
+	};
+}
+
+#endif // MXFLIB__THREAD_H
@@ -0,0 +1,656 @@
+/*! \file	timeline.cpp
+ *	\brief	Implementation of a class that resolves timecodes and edit units of an MXF file to byte offsets
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! Read a rational property, returning 0/0 if it is not present
+	Rational ReadRational(MDObjectPtr Object)
+	{
+		Rational Ret(0, 0);
+		if(Object)
+		{
+			Ret.Numerator = Object->GetInt("Numerator");
+			Ret.Denominator = Object->GetInt("Denominator");
+		}
+		return Ret;
+	}
+
+	//! Convert a count of edit units from one edit rate to another, rounding down
+	/*! \return The converted count, or the original count if either rate is not valid */
+	Position ConvertEditUnits(Position Count, Rational From, Rational To)
+	{
+		if((From.Numerator <= 0) || (From.Denominator <= 0) || (To.Numerator <= 0) || (To.Denominator <= 0)) return Count;
+
+		From.Reduce();
+		To.Reduce();
+		if(From == To) return Count;
+
+		Int64 Multiply = static_cast<Int64>(From.Denominator) * To.Numerator;
+		Int64 Divide = static_cast<Int64>(From.Numerator) * To.Denominator;
+
+		// Round towards minus infinity so that a position part way through an edit unit gives that edit unit
+		Int64 Scaled = Count * Multiply;
+		Int64 Ret = Scaled / Divide;
+		if((Scaled % Divide) && (Scaled < 0)) Ret--;
+		return Ret;
+	}
+
+	//! Get the package UID of the File Package holding a given essence container, and the IndexSID of the container
+	/*! \param BodySID The essence container, or 0 for the first listed, in which case it is updated to the BodySID found
+	 *  \return NULL if the essence container is not listed
+	 */
+	DataChunkPtr FindEssenceContainer(MetadataPtr &HMeta, UInt32 &BodySID, UInt32 &IndexSID)
+	{
+		MDObjectPtr ContentStorage = HMeta->GetRef(ContentStorageObject_UL);
+		MDObjectPtr EssenceDataObjects = ContentStorage ? ContentStorage->Child(EssenceDataObjects_UL) : NULL;
+		if(!EssenceDataObjects) return NULL;
+
+		MDObject::iterator it = EssenceDataObjects->begin();
+		while(it != EssenceDataObjects->end())
+		{
+			MDObjectPtr ECData = (*it).second->GetRef();
+			UInt32 ThisBodySID = ECData ? ECData->GetUInt(BodySID_UL) : 0;
+
+			// DRAGONS: Containers with a BodySID of zero are external essence, so have nothing to map
+			if(ThisBodySID && ((BodySID == 0) || (ThisBodySID == BodySID)))
+			{
+				BodySID = ThisBodySID;
+				IndexSID = ECData->GetUInt(IndexSID_UL);
+
+				MDObjectPtr Ptr = ECData->Child(LinkedPackageUID_UL);
+				DataChunkPtr Ret = Ptr ? Ptr->PutData() : NULL;
+				if(Ret && (Ret->Size == 32)) return Ret;
+				return NULL;
+			}
+
+			it++;
+		}
+
+		return NULL;
+	}
+
+	//! Determine if a property holds a given package UID
+	bool MatchUID(MDObjectPtr Object, DataChunkPtr &UID)
+	{
+		DataChunkPtr Value = Object ? Object->PutData() : NULL;
+		return Value && (Value->Size == 32) && (memcmp(Value->Data, UID->Data, 32) == 0);
+	}
+}
+
+
+//! Build the map for an essence container by reading the header metadata, index table and partitions of a file
+/*! \param File The file, which is left at an undefined position
+ *  \param BodySID The essence container, or 0 for the first listed in the header metadata
+ *  \return true if the map was built, even if some details (such as timecodes) were not found
+ */
+bool TimelineMap::Build(MXFFilePtr &File, UInt32 BodySID /*=0*/)
+{
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	PartitionPtr MasterPartition = File->ReadMasterPartition();
+	if(!MasterPartition)
+	{
+		File->Seek(0);
+		MasterPartition = File->ReadPartition();
+	}
+
+	if(!MasterPartition)
+	{
+		error("Could not read the header of \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	if(MasterPartition->AllMetadata.empty()) MasterPartition->ReadMetadata();
+	MetadataPtr HMeta = MasterPartition->ParseMetadata();
+	if(!HMeta)
+	{
+		error("Could not read the header metadata of \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	UInt32 IndexSID = 0;
+	if(!FindEssenceContainer(HMeta, BodySID, IndexSID))
+	{
+		if(BodySID) error("No File Package is linked to BodySID 0x%04x in \"%s\"\n", BodySID, File->Name.c_str());
+		else error("No internal essence containers are listed in \"%s\"\n", File->Name.c_str());
+		return false;
+	}
+
+	this->BodySID = BodySID;
+
+	// Use the index table built by MXFFile::Preload() if there is one, rather than reading it again
+	Index = IndexSID ? File->GetPreloadedIndex(IndexSID) : NULL;
+
+	UInt32 ReadIndexSID = 0;
+	if(IndexSID && !Index)
+	{
+		Index = new IndexTable;
+		ReadIndexSID = IndexSID;
+	}
+
+	if(!ReadPartitions(File, ReadIndexSID)) return false;
+
+	// An index table with no segments is no use
+	if(Index && (Index->EditUnitByteCount == 0) && (Index->GetDuration() <= 0)) Index = NULL;
+
+	Finish(File, HMeta);
+
+	return true;
+}
+
+
+//! Build the map for an essence container from header metadata and an index table that have already been read
+/*! The partitions of the file are read to locate the essence.
+ *  \param File The file, which is left at an undefined position
+ *  \param HMeta The header metadata of the file
+ *  \param Index The index table of the essence container, or NULL if not indexed
+ *  \param BodySID The essence container
+ *  \return true if the map was built, even if some details (such as timecodes) were not found
+ */
+bool TimelineMap::Build(MXFFilePtr &File, MetadataPtr HMeta, IndexTablePtr Index, UInt32 BodySID)
+{
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	this->BodySID = BodySID;
+	this->Index = Index;
+
+	if(!ReadPartitions(File, 0)) return false;
+
+	Finish(File, HMeta);
+
+	return true;
+}
+
+
+//! Complete the map once the partitions and index table have been read
+void TimelineMap::Finish(MXFFilePtr &File, MetadataPtr &HMeta)
+{
+	if(HMeta) ReadPackages(HMeta);
+
+	if(Index)
+	{
+		// Speed up the look-ups, CBR tables are already resolved arithmetically
+		Index->Flatten();
+
+		EditRate = Index->EditRate;
+		Duration = Index->GetDuration();
+	}
+
+	if((EditRate.Numerator <= 0) || (EditRate.Denominator <= 0)) EditRate = FileEditRate;
+
+	FindStreamBase(File);
+
+	// CBR index tables covering the whole container have no duration, so work it out from the size of the essence
+	if(Index && Index->EditUnitByteCount && (Duration <= 0) && (!Segments.empty()))
+	{
+		const Segment &Last = Segments.back();
+		Duration = (Last.StreamOffset + Last.Size - StreamBase) / Index->EditUnitByteCount;
+	}
+
+	// Without an index table the best guess is the duration of the File Package track, which starts at its origin
+	if((Duration <= 0) && (FileDuration > 0)) Duration = ConvertEditUnits(FileDuration + Origin, FileEditRate, EditRate);
+
+	if(Duration <= 0) Duration = -1;
+}
+
+
+//! Read the timecodes, origin and edit rates from the packages linked to the essence container
+void TimelineMap::ReadPackages(MetadataPtr &HMeta)
+{
+	UInt32 FoundBodySID = BodySID;
+	UInt32 IndexSID;
+	DataChunkPtr FileUID = FindEssenceContainer(HMeta, FoundBodySID, IndexSID);
+	if(!FileUID) return;
+
+	// Find the File Package
+	PackagePtr FilePackage;
+	PackageList::iterator Package_it = HMeta->Packages.begin();
+	while(Package_it != HMeta->Packages.end())
+	{
+		if(MatchUID((*Package_it)->Child(PackageUID_UL), FileUID))
+		{
+			FilePackage = *Package_it;
+			break;
+		}
+		Package_it++;
+	}
+
+	if(!FilePackage) return;
+
+	// Find the Material Package track that plays this File Package, and the position in the File Package where it starts
+	UInt32 FileTrackID = 0;
+	bool FoundMaterial = false;
+	Package_it = HMeta->Packages.begin();
+	while((!FoundMaterial) && (Package_it != HMeta->Packages.end()))
+	{
+		if((*Package_it)->IsA(MaterialPackage_UL))
+		{
+			TrackList::iterator Track_it = (*Package_it)->Tracks.begin();
+			while((!FoundMaterial) && (Track_it != (*Package_it)->Tracks.end()))
+			{
+				// The position on the Material Package track of each component
+				Position ClipPosition = 0;
+
+				ComponentList::iterator Comp_it = (*Track_it)->Components.begin();
+				while(Comp_it != (*Track_it)->Components.end())
+				{
+					if((*Comp_it)->IsA(SourceClip_UL) && MatchUID((*Comp_it)->Child(SourcePackageID_UL), FileUID))
+					{
+						FoundMaterial = true;
+						MaterialEditRate = ReadRational((*Track_it)->Child(EditRate_UL));
+						MaterialStart = (*Comp_it)->GetInt64(StartPosition_UL) - ClipPosition;
+						FileTrackID = (*Comp_it)->GetUInt(SourceTrackID_UL);
+						break;
+					}
+
+					ClipPosition += (*Comp_it)->GetInt64(ComponentLength_UL);
+					Comp_it++;
+				}
+
+				Track_it++;
+			}
+
+			// Use the timecode of this Material Package
+			if(FoundMaterial)
+			{
+				Track_it = (*Package_it)->Tracks.begin();
+				while(Track_it != (*Package_it)->Tracks.end())
+				{
+					if((*Track_it)->IsTimecodeTrack() && (!(*Track_it)->Components.empty()))
+					{
+						ComponentPtr TC = (*Track_it)->Components.front();
+						MaterialTC.Valid = true;
+						MaterialTC.Start = TC->GetInt64(StartTimecode_UL);
+						MaterialTC.FPS = static_cast<UInt16>(TC->GetUInt(RoundedTimecodeBase_UL));
+						MaterialTC.DropFrame = (TC->GetUInt(DropFrame_UL) != 0);
+						MaterialTC.EditRate = ReadRational((*Track_it)->Child(EditRate_UL));
+						break;
+					}
+					Track_it++;
+				}
+			}
+		}
+
+		Package_it++;
+	}
+
+	// Read the File Package essence track and timecode
+	TrackList::iterator Track_it = FilePackage->Tracks.begin();
+	bool FoundFileTrack = false;
+	while(Track_it != FilePackage->Tracks.end())
+	{
+		if((*Track_it)->IsTimecodeTrack())
+		{
+			if((!FileTC.Valid) && (!(*Track_it)->Components.empty()))
+			{
+				ComponentPtr TC = (*Track_it)->Components.front();
+				FileTC.Valid = true;
+				FileTC.Start = TC->GetInt64(StartTimecode_UL);
+				FileTC.FPS = static_cast<UInt16>(TC->GetUInt(RoundedTimecodeBase_UL));
+				FileTC.DropFrame = (TC->GetUInt(DropFrame_UL) != 0);
+				FileTC.EditRate = ReadRational((*Track_it)->Child(EditRate_UL));
+			}
+		}
+		else if((!FoundFileTrack) && (*Track_it)->IsEssenceTrack())
+		{
+			// Use the track played by the Material Package, or the first essence track if that is not known
+			if((FileTrackID == 0) || ((*Track_it)->GetUInt(TrackID_UL) == FileTrackID))
+			{
+				FoundFileTrack = true;
+				FileEditRate = ReadRational((*Track_it)->Child(EditRate_UL));
+				Origin = (*Track_it)->GetInt64(Origin_UL);
+
+				FileDuration = 0;
+				ComponentList::iterator Comp_it = (*Track_it)->Components.begin();
+				while(Comp_it != (*Track_it)->Components.end())
+				{
+					FileDuration += (*Comp_it)->GetInt64(ComponentLength_UL);
+					Comp_it++;
+				}
+			}
+		}
+
+		Track_it++;
+	}
+
+	// If the material package is not known, the file package timecode is the best guess
+	if(!FoundMaterial)
+	{
+		MaterialEditRate = FileEditRate;
+		MaterialStart = 0;
+		MaterialTC = FileTC;
+	}
+}
+
+
+//! Read the partitions holding the essence container, and any index table segments if required
+/*! \param ReadIndexSID The IndexSID of the index table to read, or 0 if it is not to be read
+ */
+bool TimelineMap::ReadPartitions(MXFFilePtr &File, UInt32 ReadIndexSID)
+{
+	Segments.clear();
+
+	RIP::iterator it = File->FileRIP.begin();
+	while(it != File->FileRIP.end())
+	{
+		PartitionInfoPtr Info = (*it).second;
+		it++;
+
+		// Don't read partition packs that we already know are not needed
+		if(Info->SIDsKnown() && (Info->GetBodySID() != BodySID) && ((ReadIndexSID == 0) || (Info->GetIndexSID() != ReadIndexSID))) continue;
+
+		// Use the partition pack read by MXFFile::Preload() if there is one
+		PartitionPtr ThisPartition = Info->GetPartition();
+		if(!ThisPartition)
+		{
+			File->Seek(Info->GetByteOffset());
+			ThisPartition = File->ReadPartition();
+			if(!ThisPartition)
+			{
+				error("Unable to read partition pack at 0x%s in file \"%s\"\n", Int64toHexString(Info->GetByteOffset(), 8).c_str(), File->Name.c_str());
+				return false;
+			}
+		}
+
+		if(ReadIndexSID && (ThisPartition->GetUInt(IndexSID_UL) == ReadIndexSID) && (ThisPartition->GetInt64(IndexByteCount_UL) != 0))
+		{
+			ThisPartition->ReadIndex(Index);
+		}
+
+		if(ThisPartition->GetUInt(BodySID_UL) != BodySID) continue;
+
+		if(!ThisPartition->SeekEssence()) continue;
+
+		Segment ThisSegment;
+		ThisSegment.FileOffset = File->Tell();
+		ThisSegment.StreamOffset = ThisPartition->GetInt64(BodyOffset_UL);
+
+		// The essence runs up to the next partition pack, or the end of the file
+		Position End = (it == File->FileRIP.end()) ? File->Size() : (*it).second->GetByteOffset();
+		ThisSegment.Size = (End > ThisSegment.FileOffset) ? (End - ThisSegment.FileOffset) : 0;
+
+		// DRAGONS: Partitions should be in stream order, but keep the list sorted in case they are not
+		std::vector<Segment>::iterator Pos = Segments.end();
+		while((Pos != Segments.begin()) && ((*(Pos - 1)).StreamOffset > ThisSegment.StreamOffset)) Pos--;
+		Segments.insert(Pos, ThisSegment);
+	}
+
+	if(Segments.empty())
+	{
+		error("No partitions found for BodySID 0x%04x in file \"%s\"\n", BodySID, File->Name.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Find the stream offset that index table locations are relative to
+void TimelineMap::FindStreamBase(MXFFilePtr &File)
+{
+	StreamBase = 0;
+	if(!Index) return;
+
+	// Locate the first essence KLV, skipping any filler
+	const Segment &First = Segments.front();
+	Position FileOffset = First.FileOffset;
+	Position End = First.FileOffset + First.Size;
+	UInt8 Key[16];
+	Length ValueLength;
+	Int32 KLSize;
+	for(;;)
+	{
+		if(FileOffset >= End) return;
+
+		KLSize = File->ReadKLAt(FileOffset, Key, ValueLength);
+		if(KLSize == 0) return;
+
+		// DRAGONS: The version byte of the filler key varies, so is not compared
+		if((memcmp(Key, KLVFill_UL_Data, 7) != 0) || (memcmp(&Key[8], &KLVFill_UL_Data[8], 8) != 0)) break;
+
+		FileOffset += KLSize + ValueLength;
+	}
+
+	// If the second edit unit starts within the first KLV, the index table is relative to the value of a clip-wrapped KLV
+	Position StreamOffset = First.StreamOffset + (FileOffset - First.FileOffset);
+	Position KLVEnd = StreamOffset + KLSize + ValueLength;
+
+	IndexPos Result;
+	Index->Lookup(1, Result, 0, false);
+	if(Result.Exact && (Result.Location < KLVEnd)) StreamBase = StreamOffset + KLSize;
+}
+
+
+//! Convert a timecode frame count to an edit unit of the essence container
+/*! \param Timecode The frame count of the timecode, as used by the StartTimecode property
+ *  \param Source The timecode track that this is a timecode of
+ *  \return The edit unit in stored order, or -1 if this timecode is not in the essence container
+ */
+Position TimelineMap::TimecodeToEditUnit(Position Timecode, TimecodeSource Source /*=MaterialTimecode*/)
+{
+	Position Ret;
+	if(!ResolveTimecode(Timecode, Source, Ret)) return -1;
+
+	if((Ret < 0) || ((Duration >= 0) && (Ret >= Duration))) return -1;
+
+	return Ret;
+}
+
+
+//! Convert a timecode frame count to a stored edit unit, without checking that it is in the essence container
+/*! \return false if the timecode track was not found */
+bool TimelineMap::ResolveTimecode(Position Timecode, TimecodeSource Source, Position &EditUnit)
+{
+	const TimecodeInfo &TC = GetTimecode(Source);
+	if(!TC.Valid) return false;
+
+	Position Ret;
+	if(Source == FileTimecode)
+	{
+		// Position on the File Package track, which counts from the origin
+		Ret = ConvertEditUnits(Timecode - TC.Start, TC.EditRate, FileEditRate);
+	}
+	else
+	{
+		// Position on the Material Package track, then on the File Package track
+		Ret = ConvertEditUnits(Timecode - TC.Start, TC.EditRate, MaterialEditRate) + MaterialStart;
+		Ret = ConvertEditUnits(Ret, MaterialEditRate, FileEditRate);
+	}
+
+	// Stored edit units count from the start of the track rather than its origin, and may be at a different rate
+	EditUnit = ConvertEditUnits(Ret + Origin, FileEditRate, EditRate);
+
+	return true;
+}
+
+
+//! Convert a timecode string of the form "hh:mm:ss:ff" to an edit unit of the essence container
+/*! Either ':' or ';' may be used as separators, the timecode track gives the frame rate and if drop-frame is used.
+ *  \return The edit unit in stored order, or -1 if the timecode is not valid or is not in the essence container
+ */
+Position TimelineMap::TimecodeToEditUnit(const std::string &Timecode, TimecodeSource Source /*=MaterialTimecode*/)
+{
+	Position Frames;
+	if(!ParseTimecode(Timecode, Source, Frames)) return -1;
+
+	return TimecodeToEditUnit(Frames, Source);
+}
+
+
+//! Convert a timecode string to a frame count using the frame rate and drop-frame setting of a timecode track
+/*! \return false if the timecode is not valid or the timecode track was not found */
+bool TimelineMap::ParseTimecode(const std::string &Timecode, TimecodeSource Source, Position &Frames)
+{
+	const TimecodeInfo &TC = GetTimecode(Source);
+	if(!TC.Valid) return false;
+
+	int Fields[4];
+	int FieldCount = 0;
+	bool InField = false;
+
+	std::string::const_iterator it = Timecode.begin();
+	while(it != Timecode.end())
+	{
+		if((*it >= '0') && (*it <= '9'))
+		{
+			if(!InField)
+			{
+				if(FieldCount == 4) return false;
+				Fields[FieldCount++] = 0;
+				InField = true;
+			}
+			Fields[FieldCount - 1] = Fields[FieldCount - 1] * 10 + (*it - '0');
+		}
+		else if((*it == ':') || (*it == ';') || (*it == '.'))
+		{
+			if(!InField) return false;
+			InField = false;
+		}
+		else return false;
+
+		it++;
+	}
+
+	if((FieldCount != 4) || (!InField)) return false;
+
+	Frames = TCtoFrames(TC.FPS, TC.DropFrame, Fields[0], Fields[1], Fields[2], Fields[3]);
+	return true;
+}
+
+
+//! Get the stream offset of the start of an edit unit
+/*! \return The stream offset, or -1 if not indexed
+ */
+Position TimelineMap::EditUnitToStreamOffset(Position EditUnit) const
+{
+	if((!Index) || (EditUnit < 0)) return -1;
+
+	// The end of the last edit unit is the end of the essence
+	if((EditUnit == Duration) && (!Index->EditUnitByteCount))
+	{
+		if(Segments.empty()) return -1;
+		const Segment &Last = Segments.back();
+		return Last.StreamOffset + Last.Size;
+	}
+
+	if((Duration >= 0) && (EditUnit > Duration)) return -1;
+
+	IndexPos Result;
+	Index->Lookup(EditUnit, Result, 0, false);
+	if(!Result.Exact) return -1;
+
+	return StreamBase + Result.Location;
+}
+
+
+//! Get the file offset of a stream offset
+/*! \return The file offset, or -1 if the stream offset is not in the file
+ */
+Position TimelineMap::StreamOffsetToFileOffset(Position StreamOffset) const
+{
+	if(Segments.empty() || (StreamOffset < Segments.front().StreamOffset)) return -1;
+
+	// Find the last segment that starts at or before this offset
+	size_t Low = 0;
+	size_t High = Segments.size();
+	while((High - Low) > 1)
+	{
+		size_t Mid = (Low + High) / 2;
+		if(Segments[Mid].StreamOffset <= StreamOffset) Low = Mid; else High = Mid;
+	}
+
+	const Segment &ThisSegment = Segments[Low];
+
+	// DRAGONS: The end of a segment is a valid offset, as it is the end of the last edit unit in the partition
+	if(StreamOffset > (ThisSegment.StreamOffset + ThisSegment.Size)) return -1;
+
+	return ThisSegment.FileOffset + (StreamOffset - ThisSegment.StreamOffset);
+}
+
+
+//! Get the range of bytes in the file that holds a number of edit units
+/*! \param EditUnit The first edit unit
+ *  \param Count The number of edit units
+ *  \param FileOffset Set to the file offset of the start of the first edit unit
+ *  \param Size Set to the number of bytes up to the end of the last edit unit
+ *  \return false if the range is not known
+ *  \note If the edit units span more than one partition, the range includes the partition packs and any other
+ *        data between them, so the bytes need to be parsed as KLVs rather than taken as pure essence
+ */
+bool TimelineMap::GetByteRange(Position EditUnit, Length Count, Position &FileOffset, Length &Size)
+{
+	if(Count <= 0) return false;
+
+	Position Start = EditUnitToFileOffset(EditUnit);
+	if(Start < 0) return false;
+
+	// DRAGONS: The end is found from the stream offset so that the end of a partition is not taken as the start of the next
+	Position EndStream = EditUnitToStreamOffset(EditUnit + Count);
+	if(EndStream < 0) return false;
+
+	size_t Low = 0;
+	size_t High = Segments.size();
+	while((High - Low) > 1)
+	{
+		size_t Mid = (Low + High) / 2;
+		if(Segments[Mid].StreamOffset < EndStream) Low = Mid; else High = Mid;
+	}
+
+	const Segment &EndSegment = Segments[Low];
+	if((EndStream < EndSegment.StreamOffset) || (EndStream > (EndSegment.StreamOffset + EndSegment.Size))) return false;
+
+	FileOffset = Start;
+	Size = EndSegment.FileOffset + (EndStream - EndSegment.StreamOffset) - Start;
+	return true;
+}
+
+
+//! Get the range of bytes in the file that holds the edit units from one timecode up to, but not including, another
+/*! \return false if the range is not known
+ *  \see GetByteRange(Position, Length, Position &, Length &)
+ */
+bool TimelineMap::GetByteRange(const std::string &InTimecode, const std::string &OutTimecode, Position &FileOffset, Length &Size, TimecodeSource Source /*=MaterialTimecode*/)
+{
+	Position In = TimecodeToEditUnit(InTimecode, Source);
+	if(In < 0) return false;
+
+	// DRAGONS: The out point may be the timecode just after the last edit unit, which is not itself in the container
+	Position OutFrames;
+	Position Out;
+	if((!ParseTimecode(OutTimecode, Source, OutFrames)) || (!ResolveTimecode(OutFrames, Source, Out))) return false;
+
+	if((Out <= In) || ((Duration >= 0) && (Out > Duration))) return false;
+
+	return GetByteRange(In, Out - In, FileOffset, Size);
+}
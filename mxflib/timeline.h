@@ -0,0 +1,229 @@
+/*! \file	timeline.h
+ *	\brief	Definition of a class that resolves timecodes and edit units of an MXF file to byte offsets
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Working out where a given timecode is stored in a file means walking the timecode tracks of the packages, the
+ *  source clips that link them and the index table, then finding the partition that holds the essence. A TimelineMap
+ *  does all of this once for an essence container and keeps just the results, so that frame-accurate requests can be
+ *  answered quickly and without further reading of the file.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__TIMELINE_H
+#define MXFLIB__TIMELINE_H
+
+namespace mxflib
+{
+	//! Resolves timecodes and edit units of one essence container to offsets and byte ranges in the file
+	/*! The map is built once from the timecode tracks of the Material and File Packages, the index table of the
+	 *  essence container and the partitions holding it. After that no further reading is done: CBR index tables are
+	 *  resolved arithmetically, VBR index tables are flattened and binary searched, and the partition holding a
+	 *  stream offset is found by a binary search of the partition map.
+	 *  \note Edit units are counted in stored order, as that is the order of the bytes in the file
+	 */
+	class TimelineMap : public RefCount<TimelineMap>
+	{
+	public:
+		//! Which timecode track to resolve timecodes against
+		enum TimecodeSource
+		{
+			MaterialTimecode,					//!< The timecode track of the Material Package
+			FileTimecode						//!< The timecode track of the File Package (the source timecode)
+		};
+
+	protected:
+		//! Details of a timecode track
+		struct TimecodeInfo
+		{
+			bool Valid;							//!< True if this timecode track was found
+			Position Start;						//!< The frame count of the first timecode
+			UInt16 FPS;							//!< The rounded timecode base
+			bool DropFrame;						//!< True if this is a drop-frame timecode
+			Rational EditRate;					//!< The edit rate of the timecode track
+		};
+
+		//! The essence of the container held in a single partition
+		struct Segment
+		{
+			Position StreamOffset;				//!< The stream offset of the first byte of essence in the partition
+			Position FileOffset;				//!< The file offset of the first byte of essence in the partition
+			Length Size;						//!< The number of bytes of essence in the partition (up to the next partition pack)
+		};
+
+		UInt32 BodySID;							//!< The BodySID of the essence container
+		IndexTablePtr Index;					//!< The index table of the essence container, or NULL if not indexed
+		Rational EditRate;						//!< The edit rate of the index table
+		Length Duration;						//!< The duration of the essence in edit units, or -1 if not known
+
+		TimecodeInfo MaterialTC;				//!< The timecode of the Material Package
+		TimecodeInfo FileTC;					//!< The timecode of the File Package
+
+		Position MaterialStart;					//!< The position in the File Package track of the start of the Material Package track, in File Package edit units
+		Position Origin;						//!< The origin of the File Package track, which is the stored edit unit at position zero
+		Rational MaterialEditRate;				//!< The edit rate of the Material Package track
+		Rational FileEditRate;					//!< The edit rate of the File Package track
+		Length FileDuration;					//!< The duration of the File Package track, or -1 if not known
+
+		std::vector<Segment> Segments;			//!< The partitions holding the essence, in stream order
+		Position StreamBase;					//!< The stream offset that index table locations are relative to (the start of the value for clip-wrapping)
+
+	public:
+		//! Build an empty map
+		TimelineMap() : BodySID(0), Duration(-1), MaterialStart(0), Origin(0), FileDuration(-1), StreamBase(0)
+		{
+			MaterialTC.Valid = false;
+			FileTC.Valid = false;
+		}
+
+		//! Build the map for an essence container by reading the header metadata, index table and partitions of a file
+		/*! \param File The file, which is left at an undefined position
+		 *  \param BodySID The essence container, or 0 for the first listed in the header metadata
+		 *  \return true if the map was built, even if some details (such as timecodes) were not found
+		 */
+		bool Build(MXFFilePtr &File, UInt32 BodySID = 0);
+
+		//! Build the map for an essence container from header metadata and an index table that have already been read
+		/*! The partitions of the file are read to locate the essence.
+		 *  \param File The file, which is left at an undefined position
+		 *  \param HMeta The header metadata of the file
+		 *  \param Index The index table of the essence container, or NULL if not indexed
+		 *  \param BodySID The essence container
+		 *  \return true if the map was built, even if some details (such as timecodes) were not found
+		 */
+		bool Build(MXFFilePtr &File, MetadataPtr HMeta, IndexTablePtr Index, UInt32 BodySID);
+
+		//! Get the BodySID of the essence container mapped
+		UInt32 GetBodySID(void) const { return BodySID; }
+
+		//! Get the edit rate of the essence container, as used by its index table
+		Rational GetEditRate(void) const { return EditRate; }
+
+		//! Get the duration of the essence container in edit units, or -1 if not known
+		Length GetDuration(void) const { return Duration; }
+
+		//! Get the index table of the essence container, or NULL if not indexed
+		IndexTablePtr GetIndex(void) const { return Index; }
+
+		//! Get the stream offset that index table locations are relative to
+		/*! This is the start of the value of the KLV for clip-wrapped essence, and zero otherwise */
+		Position GetStreamBase(void) const { return StreamBase; }
+
+		//! Determine if a given timecode track was found
+		bool HasTimecode(TimecodeSource Source = MaterialTimecode) const { return GetTimecode(Source).Valid; }
+
+		//! Get the frame count of the first timecode of a timecode track, or -1 if not found
+		Position GetStartTimecode(TimecodeSource Source = MaterialTimecode) const
+		{
+			const TimecodeInfo &TC = GetTimecode(Source);
+			return TC.Valid ? TC.Start : -1;
+		}
+
+		//! Convert a timecode frame count to an edit unit of the essence container
+		/*! \param Timecode The frame count of the timecode, as used by the StartTimecode property
+		 *  \param Source The timecode track that this is a timecode of
+		 *  \return The edit unit in stored order, or -1 if this timecode is not in the essence container
+		 */
+		Position TimecodeToEditUnit(Position Timecode, TimecodeSource Source = MaterialTimecode);
+
+		//! Convert a timecode string of the form "hh:mm:ss:ff" to an edit unit of the essence container
+		/*! Either ':' or ';' may be used as separators, the timecode track gives the frame rate and if drop-frame is used.
+		 *  \return The edit unit in stored order, or -1 if the timecode is not valid or is not in the essence container
+		 */
+		Position TimecodeToEditUnit(const std::string &Timecode, TimecodeSource Source = MaterialTimecode);
+
+		//! Get the stream offset of the start of an edit unit
+		/*! \return The stream offset, or -1 if not indexed
+		 */
+		Position EditUnitToStreamOffset(Position EditUnit) const;
+
+		//! Get the file offset of a stream offset
+		/*! \return The file offset, or -1 if the stream offset is not in the file
+		 */
+		Position StreamOffsetToFileOffset(Position StreamOffset) const;
+
+		//! Get the file offset of the start of an edit unit
+		/*! \return The file offset, or -1 if not known
+		 */
+		Position EditUnitToFileOffset(Position EditUnit)
+		{
+			Position StreamOffset = EditUnitToStreamOffset(EditUnit);
+			if(StreamOffset < 0) return -1;
+			return StreamOffsetToFileOffset(StreamOffset);
+		}
+
+		//! Get the range of bytes in the file that holds a number of edit units
+		/*! \param EditUnit The first edit unit
+		 *  \param Count The number of edit units
+		 *  \param FileOffset Set to the file offset of the start of the first edit unit
+		 *  \param Size Set to the number of bytes up to the end of the last edit unit
+		 *  \return false if the range is not known
+		 *  \note If the edit units span more than one partition, the range includes the partition packs and any other
+		 *        data between them, so the bytes need to be parsed as KLVs rather than taken as pure essence
+		 */
+		bool GetByteRange(Position EditUnit, Length Count, Position &FileOffset, Length &Size);
+
+		//! Get the range of bytes in the file that holds the edit units from one timecode up to, but not including, another
+		/*! \return false if the range is not known
+		 *  \see GetByteRange(Position, Length, Position &, Length &)
+		 */
+		bool GetByteRange(const std::string &InTimecode, const std::string &OutTimecode, Position &FileOffset, Length &Size, TimecodeSource Source = MaterialTimecode);
+
+	protected:
+		//! Get the details of a timecode track
+		const TimecodeInfo &GetTimecode(TimecodeSource Source) const { return (Source == FileTimecode) ? FileTC : MaterialTC; }
+
+		//! Complete the map once the partitions and index table have been read
+		void Finish(MXFFilePtr &File, MetadataPtr &HMeta);
+
+		//! Convert a timecode frame count to a stored edit unit, without checking that it is in the essence container
+		/*! \return false if the timecode track was not found */
+		bool ResolveTimecode(Position Timecode, TimecodeSource Source, Position &EditUnit);
+
+		//! Convert a timecode string to a frame count using the frame rate and drop-frame setting of a timecode track
+		/*! \return false if the timecode is not valid or the timecode track was not found */
+		bool ParseTimecode(const std::string &Timecode, TimecodeSource Source, Position &Frames);
+
+		//! Read the timecodes, origin and edit rates from the packages linked to the essence container
+		void ReadPackages(MetadataPtr &HMeta);
+
+		//! Read the partitions holding the essence container, and any index table segments if required
+		/*! \param ReadIndexSID The IndexSID of the index table to read, or 0 if it is not to be read
+		 */
+		bool ReadPartitions(MXFFilePtr &File, UInt32 ReadIndexSID);
+
+		//! Find the stream offset that index table locations are relative to
+		void FindStreamBase(MXFFilePtr &File);
+
+	private:
+		//! Prevent copy construction
+		TimelineMap(const TimelineMap &);
+	};
+
+	//! A smart pointer to a TimelineMap object
+	typedef SmartPtr<TimelineMap> TimelineMapPtr;
+}
+
+#endif // MXFLIB__TIMELINE_H
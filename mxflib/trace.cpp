@@ -0,0 +1,191 @@
+/*! \file	trace.cpp
+ *	\brief	Implementation of timeline tracing of where and when time is spent in the library
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+#ifndef MXFLIB_NO_TRACE
+namespace mxflib
+{
+	// Define the recording flag
+	bool TraceActive = false;
+}
+
+
+namespace
+{
+	//! A recorded event
+	struct TraceRecord
+	{
+		const char *Name;					//!< The name of the event, or NULL if this slot has not been used
+		const char *Category;				//!< The category of the event
+		UInt64 Start;						//!< The start time, from GetMicroseconds()
+		UInt64 Duration;					//!< The length in microseconds
+		UInt64 Thread;						//!< The number of the thread that recorded the event
+	};
+
+	//! The ring of events
+	/*! DRAGONS: The ring is only freed when a new one is started, as a thread may still be recording an event just after tracing stops */
+	TraceRecord *Ring = NULL;
+
+	//! The number of events in the ring
+	size_t RingSize = 0;
+
+	//! The number of events recorded since tracing started, the next event goes in slot (NextRecord % RingSize)
+	UInt64 NextRecord = 0;
+
+	//! The number given to the last thread to record an event
+	UInt64 LastThread = 0;
+
+	//! The number of the current thread, or zero if it has not yet recorded an event
+	MXFLIB_THREAD_LOCAL UInt64 CurrentThread = 0;
+
+	//! The file to write to
+	FILE *TraceFile = NULL;
+
+	//! The time tracing started, so that the trace starts at zero
+	UInt64 TraceStart = 0;
+
+	//! Set once StopTrace() has been registered to run at exit
+	bool ExitRegistered = false;
+
+	//! Atomically increment a counter, returning the new value
+	inline UInt64 TraceIncrement(UInt64 *Value)
+	{
+#if defined(_WIN32)
+		return static_cast<UInt64>(InterlockedIncrement64(reinterpret_cast<volatile LONGLONG*>(Value)));
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+		return __sync_add_and_fetch(Value, 1);
+#else
+		return ++(*Value);
+#endif
+	}
+
+	//! Write the trace at exit
+	void StopTraceAtExit(void)
+	{
+		StopTrace();
+	}
+}
+
+
+//! Start recording trace events, to be written to a file when tracing stops or the process exits
+bool mxflib::StartTrace(const std::string &FileName, size_t MaxEvents /*=1024*1024*/)
+{
+	StopTrace();
+
+	TraceFile = fopen(FileName.c_str(), "wb");
+	if(!TraceFile)
+	{
+		error("Unable to open trace file \"%s\"\n", FileName.c_str());
+		return false;
+	}
+
+	if(MaxEvents < 1) MaxEvents = 1;
+
+	delete[] Ring;
+	Ring = new TraceRecord[MaxEvents];
+	memset(Ring, 0, sizeof(TraceRecord) * MaxEvents);
+	RingSize = MaxEvents;
+	NextRecord = 0;
+
+	if(!ExitRegistered)
+	{
+		atexit(StopTraceAtExit);
+		ExitRegistered = true;
+	}
+
+	TraceStart = GetMicroseconds();
+	TraceActive = true;
+
+	return true;
+}
+
+
+//! Stop recording and write the trace file
+void mxflib::StopTrace(void)
+{
+	TraceActive = false;
+
+	if(!TraceFile) return;
+
+	fprintf(TraceFile, "{\"traceEvents\":[");
+
+	// Once the ring has wrapped only the most recent events remain
+	UInt64 Count = NextRecord;
+	UInt64 First = (Count > RingSize) ? (Count - RingSize) : 0;
+
+	bool Started = false;
+	UInt64 i;
+	for(i = First; i < Count; i++)
+	{
+		const TraceRecord &Record = Ring[i % RingSize];
+		if(!Record.Name) continue;
+
+		// DRAGONS: Events that started before tracing did have their start time clipped
+		UInt64 Start = (Record.Start > TraceStart) ? (Record.Start - TraceStart) : 0;
+
+		fprintf(TraceFile, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%s,\"dur\":%s,\"pid\":1,\"tid\":%s}",
+				Started ? "," : "", Record.Name, Record.Category, UInt64toString(Start).c_str(),
+				UInt64toString(Record.Duration).c_str(), UInt64toString(Record.Thread).c_str());
+
+		Started = true;
+	}
+
+	fprintf(TraceFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	if(Count > RingSize) warning("The trace ring overflowed, so only the last %s of %s events were written\n",
+								 UInt64toString(RingSize).c_str(), UInt64toString(Count).c_str());
+
+	fclose(TraceFile);
+	TraceFile = NULL;
+}
+
+
+//! Record a complete event
+void mxflib::TraceEvent(const char *Name, const char *Category, UInt64 Start, UInt64 Duration)
+{
+	if(!TraceActive) return;
+
+	if(!CurrentThread) CurrentThread = TraceIncrement(&LastThread);
+
+	// DRAGONS: If the ring wraps while an event is being written to a slot a second writer may also be using it, giving a
+	//          mixed-up event, but this needs the whole ring to be recorded during the write of one event
+	TraceRecord &Record = Ring[(TraceIncrement(&NextRecord) - 1) % RingSize];
+
+	Record.Category = Category;
+	Record.Start = Start;
+	Record.Duration = Duration;
+	Record.Thread = CurrentThread;
+	Record.Name = Name;
+}
+
+#endif // MXFLIB_NO_TRACE
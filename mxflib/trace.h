@@ -0,0 +1,111 @@
+/*! \file	trace.h
+ *	\brief	Timeline tracing of where and when time is spent in the library
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  The counters of stats.h show how much time is spent in each part of the library, a trace shows when and on which
+ *  thread, so that the overlap of the streams of a multi-stream wrap, or of the workers of a parallel read, can be seen.
+ *  Scoped events are recorded into a fixed-size ring in memory, at the cost of two clock reads and an atomic increment
+ *  each, and the ring is written as Chrome trace event JSON (for chrome://tracing or Perfetto) when tracing stops or
+ *  the process exits. Tracing is off until StartTrace() is called, when the cost is a single test of a flag, and the
+ *  whole facility may be compiled out by defining MXFLIB_NO_TRACE, when TraceScope becomes an empty class.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__TRACE_H
+#define MXFLIB__TRACE_H
+
+// Define this value here, or on the compiler command line, to remove all tracing from the library
+//#define MXFLIB_NO_TRACE
+
+
+namespace mxflib
+{
+#ifdef MXFLIB_NO_TRACE
+
+	//! Start recording trace events
+	/*! \return false, as tracing is not available in this build */
+	inline bool StartTrace(const std::string &FileName, size_t MaxEvents = 0) { return false; }
+
+	//! Stop recording and write the trace file
+	inline void StopTrace(void) {}
+
+	//! Determine if trace events are being recorded
+	inline bool TraceEnabled(void) { return false; }
+
+	//! Record the life of this object as a trace event
+	class TraceScope
+	{
+	public:
+		TraceScope(const char *Name, const char *Category) {}
+	};
+
+#else // MXFLIB_NO_TRACE
+
+	// Declare the recording flag
+	extern bool TraceActive;
+
+	//! Start recording trace events, to be written to a file when tracing stops or the process exits
+	/*! \param FileName The file to write the Chrome trace event JSON to
+	 *  \param MaxEvents The number of events held, once this many have been recorded the oldest are overwritten
+	 *  \return false if the file could not be opened
+	 */
+	bool StartTrace(const std::string &FileName, size_t MaxEvents = 1024 * 1024);
+
+	//! Stop recording and write the trace file
+	void StopTrace(void);
+
+	//! Determine if trace events are being recorded
+	inline bool TraceEnabled(void) { return TraceActive; }
+
+	//! Record a complete event
+	/*! \param Name The name of the event, which must last for the life of the process (normally a string literal)
+	 *  \param Category The category of the event, which must also last for the life of the process
+	 *  \param Start The start time of the event, from GetMicroseconds()
+	 *  \param Duration The length of the event in microseconds
+	 */
+	void TraceEvent(const char *Name, const char *Category, UInt64 Start, UInt64 Duration);
+
+	//! Record the life of this object as a trace event
+	class TraceScope
+	{
+	protected:
+		const char *Name;					//!< The name of the event
+		const char *Category;				//!< The category of the event
+		UInt64 Start;						//!< The time we were constructed, or zero if not recording
+
+	public:
+		TraceScope(const char *Name, const char *Category) : Name(Name), Category(Category), Start(TraceActive ? GetMicroseconds() : 0) {}
+
+		~TraceScope()
+		{
+			if(Start) TraceEvent(Name, Category, Start, GetMicroseconds() - Start);
+		}
+	};
+
+#endif // MXFLIB_NO_TRACE
+}
+
+#endif // MXFLIB__TRACE_H
@@ -0,0 +1,291 @@
+/*! \file	typeoverlay.cpp
+ *	\brief	Implementation of the registry overlay that holds classes and types added after the dictionary is frozen
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+
+namespace
+{
+	//! The overlay active on this thread
+	MXFLIB_THREAD_LOCAL TypeOverlay *CurrentOverlay = NULL;
+
+	//! Determine if a UL is a SMPTE UL, and so should also be found version-less
+	bool IsSMPTEUL(const UL &ThisUL)
+	{
+		const UInt8 *Data = ThisUL.GetValue();
+		return (Data[0] == 0x06) && (Data[1] == 0x0e) && (Data[2] == 0x2b) && (Data[3] == 0x34);
+	}
+
+	//! Make a copy of a UL with the version number set to 1
+	UL Version1(const UL &ThisUL)
+	{
+		UL Ret = ThisUL;
+		Ret.Set(7, 1);
+		return Ret;
+	}
+
+	//! Cached overlays, indexed by key, along with the list of keys with the most recently found first
+	/*! DRAGONS: These are built on first use, as the cache may be used before static initialization is complete */
+	struct OverlayCache
+	{
+		Mutex Lock;										//!< Lock held while the cache is accessed
+		std::map<std::string, TypeOverlayPtr> Overlays;	//!< The cached overlays
+		std::list<std::string> Order;					//!< The keys, most recently found first
+		size_t Limit;									//!< The maximum number of overlays to hold
+
+		OverlayCache() : Limit(64) {}
+	};
+
+	//! Get the overlay cache
+	OverlayCache &GetCache(void)
+	{
+		static OverlayCache Cache;
+		return Cache;
+	}
+
+	//! Discard the least recently found overlays until the cache is within its limit
+	/*! \note The cache lock must be held by the caller */
+	void TrimCache(OverlayCache &Cache)
+	{
+		while(Cache.Order.size() > Cache.Limit)
+		{
+			Cache.Overlays.erase(Cache.Order.back());
+			Cache.Order.pop_back();
+		}
+	}
+}
+
+
+//! Add a class to this overlay
+void TypeOverlay::AddClass(const MDOTypePtr &Class, const UL &ClassUL)
+{
+	ClassULs.Set(ClassUL, Class);
+	if(IsSMPTEUL(ClassUL)) ClassULsVer1.Set(Version1(ClassUL), Class);
+
+	Classes.push_back(Class);
+	Generation++;
+}
+
+
+//! Find a class in this overlay by UL, matching version-less if no exact match
+MDOTypePtr TypeOverlay::FindClass(const UL &ClassUL) const
+{
+	const MDOTypePtr *Found = ClassULs.Find(ClassUL);
+	if((!Found) && IsSMPTEUL(ClassUL)) Found = ClassULsVer1.Find(Version1(ClassUL));
+
+	return Found ? *Found : NULL;
+}
+
+
+//! Add a type to this overlay
+void TypeOverlay::AddType(const MDTypePtr &Type, const UL &TypeUL)
+{
+	TypeULs[TypeUL] = Type;
+	if(IsSMPTEUL(TypeUL)) TypeULsVer1[Version1(TypeUL)] = Type;
+}
+
+
+//! Find a type in this overlay by UL, matching version-less if no exact match
+MDTypePtr TypeOverlay::FindType(const UL &TypeUL) const
+{
+	std::map<UL, MDTypePtr>::const_iterator it = TypeULs.find(TypeUL);
+	if(it != TypeULs.end()) return (*it).second;
+
+	if(IsSMPTEUL(TypeUL))
+	{
+		it = TypeULsVer1.find(Version1(TypeUL));
+		if(it != TypeULsVer1.end()) return (*it).second;
+	}
+
+	return NULL;
+}
+
+
+//! Add a symbol space created while this overlay is active
+void TypeOverlay::AddSymbolSpace(const SymbolSpacePtr &Space)
+{
+	if(SymbolSpaces.find(Space->Name()) != SymbolSpaces.end())
+	{
+		error("Duplicate symbol space name \"%s\"\n", Space->Name().c_str());
+	}
+
+	SymbolSpaces.insert(SymbolSpaceMap::value_type(Space->Name(), Space));
+}
+
+
+//! Find a symbol space created while this overlay was active
+SymbolSpacePtr TypeOverlay::FindSymbolSpace(const std::string &Name) const
+{
+	SymbolSpaceMap::const_iterator it = SymbolSpaces.find(Name);
+	if(it != SymbolSpaces.end()) return (*it).second;
+
+	return NULL;
+}
+
+
+//! Add a symbol to a frozen symbol space
+/*! \return false if the symbol is already in this overlay for that symbol space */
+bool TypeOverlay::AddSymbol(const std::string &SpaceName, const std::string &Symbol, ULPtr &SymbolUL)
+{
+	std::map<std::string, ULPtr> &Space = Symbols[SpaceName];
+	if(Space.find(Symbol) != Space.end()) return false;
+
+	Space.insert(std::map<std::string, ULPtr>::value_type(Symbol, SymbolUL));
+	return true;
+}
+
+
+//! Find a symbol added to a frozen symbol space
+ULPtr TypeOverlay::FindSymbol(const std::string &SpaceName, const std::string &Symbol) const
+{
+	std::map<std::string, std::map<std::string, ULPtr> >::const_iterator Space_it = Symbols.find(SpaceName);
+	if(Space_it == Symbols.end()) return NULL;
+
+	std::map<std::string, ULPtr>::const_iterator it = (*Space_it).second.find(Symbol);
+	if(it != (*Space_it).second.end()) return (*it).second;
+
+	return NULL;
+}
+
+
+//! Find a symbol in any symbol space of this overlay
+ULPtr TypeOverlay::FindSymbol(const std::string &Symbol) const
+{
+	std::map<std::string, std::map<std::string, ULPtr> >::const_iterator Space_it = Symbols.begin();
+	while(Space_it != Symbols.end())
+	{
+		std::map<std::string, ULPtr>::const_iterator it = (*Space_it).second.find(Symbol);
+		if(it != (*Space_it).second.end()) return (*it).second;
+
+		Space_it++;
+	}
+
+	SymbolSpaceMap::const_iterator it = SymbolSpaces.begin();
+	while(it != SymbolSpaces.end())
+	{
+		ULPtr Ret = (*it).second->Find(Symbol);
+		if(Ret) return Ret;
+
+		it++;
+	}
+
+	return NULL;
+}
+
+
+//! Find an overlay in the overlay cache
+/*! \param Key The key the overlay was cached with, such as a hash of the metadictionary it was built from
+ *  \return NULL if no overlay is cached with that key
+ */
+TypeOverlayPtr TypeOverlay::FindCached(const DataChunk &Key)
+{
+	OverlayCache &Cache = GetCache();
+	MutexLock Lock(Cache.Lock);
+
+	std::string KeyString(reinterpret_cast<const char *>(Key.Data), Key.Size);
+	std::map<std::string, TypeOverlayPtr>::iterator it = Cache.Overlays.find(KeyString);
+	if(it == Cache.Overlays.end()) return NULL;
+
+	// Move this key to the front of the list
+	std::list<std::string>::iterator Order_it = Cache.Order.begin();
+	while((Order_it != Cache.Order.end()) && ((*Order_it) != KeyString)) Order_it++;
+	if((Order_it != Cache.Order.end()) && (Order_it != Cache.Order.begin())) Cache.Order.splice(Cache.Order.begin(), Cache.Order, Order_it);
+
+	return (*it).second;
+}
+
+
+//! Add a completed overlay to the overlay cache
+/*! The least recently found overlay is discarded if the cache is full.
+ *  \note The overlay must not be changed after it is cached, as it may be in use by other threads
+ */
+void TypeOverlay::AddCached(const DataChunk &Key, TypeOverlayPtr Overlay)
+{
+	if(!Overlay) return;
+
+	OverlayCache &Cache = GetCache();
+	MutexLock Lock(Cache.Lock);
+
+	if(Cache.Limit == 0) return;
+
+	// If another thread has cached an overlay for the same key, keep that one
+	std::string KeyString(reinterpret_cast<const char *>(Key.Data), Key.Size);
+	if(Cache.Overlays.find(KeyString) != Cache.Overlays.end()) return;
+
+	Overlay->Cached = true;
+	Cache.Overlays[KeyString] = Overlay;
+	Cache.Order.push_front(KeyString);
+
+	TrimCache(Cache);
+}
+
+
+//! Discard all overlays in the overlay cache, used when the dictionary is cleared
+void TypeOverlay::ClearCache(void)
+{
+	OverlayCache &Cache = GetCache();
+	MutexLock Lock(Cache.Lock);
+
+	Cache.Overlays.clear();
+	Cache.Order.clear();
+}
+
+
+//! Set the maximum number of overlays held in the overlay cache, 0 disables caching
+void TypeOverlay::SetCacheLimit(size_t Limit)
+{
+	OverlayCache &Cache = GetCache();
+	MutexLock Lock(Cache.Lock);
+
+	Cache.Limit = Limit;
+	TrimCache(Cache);
+}
+
+
+//! Get the overlay active on this thread, or NULL if none is
+TypeOverlay *TypeOverlay::Current(void)
+{
+	return CurrentOverlay;
+}
+
+
+//! Make an overlay active, or leave the current one active if NULL
+TypeOverlay::Scope::Scope(TypeOverlay *Overlay) : Previous(CurrentOverlay)
+{
+	if(Overlay) CurrentOverlay = Overlay;
+}
+
+
+//! Restore the previously active overlay
+TypeOverlay::Scope::~Scope()
+{
+	CurrentOverlay = Previous;
+}
@@ -0,0 +1,173 @@
+/*! \file	typeoverlay.h
+ *	\brief	Definition of the registry overlay that holds classes and types added after the dictionary is frozen
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Once FreezeDictionary() has been called the global registry of classes, types and symbol spaces is never
+ *  changed again, so it may be read by any number of threads without locking. Anything defined after that,
+ *  such as the contents of the metadictionary of a file being read, goes into the TypeOverlay that is active
+ *  on the thread doing the defining, and lookups on a thread search its active overlay after the registry.
+ *
+ *  Files from the same encoder usually carry identical metadictionaries, so completed overlays are kept in a
+ *  small cache keyed by a hash of the metadictionary bytes, letting later files reuse an overlay without
+ *  defining its classes and types again.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__TYPEOVERLAY_H
+#define MXFLIB__TYPEOVERLAY_H
+
+namespace mxflib
+{
+	// Forward declare the overlay class so the smart pointer can be defined
+	class TypeOverlay;
+
+	//! A smart pointer to a TypeOverlay object
+	typedef SmartPtr<TypeOverlay> TypeOverlayPtr;
+}
+
+
+namespace mxflib
+{
+	//! Classes, types and symbols defined after the dictionary was frozen
+	/*! An overlay is built by a single thread, for example while reading the metadictionary of a file, with
+	 *  the overlay made active for that thread by a TypeOverlay::Scope. Once complete it may be made active
+	 *  on any number of threads at once, as lookups do not change it.
+	 *  \note Classes and types already in the frozen registry are never changed, so a definition in an overlay
+	 *        that would extend one (such as a new property of a standard set) is not applied
+	 */
+	class TypeOverlay : public RefCount<TypeOverlay>
+	{
+	protected:
+		ULHashMap<MDOTypePtr> ClassULs;						//!< Classes added to this overlay, by UL
+		ULHashMap<MDOTypePtr> ClassULsVer1;					//!< Classes added to this overlay, by UL with the version number set to 1
+		MDOTypeList Classes;								//!< All classes added to this overlay, in the order added
+
+		std::map<UL, MDTypePtr> TypeULs;					//!< Types added to this overlay, by UL
+		std::map<UL, MDTypePtr> TypeULsVer1;				//!< Types added to this overlay, by UL with the version number set to 1
+
+		SymbolSpaceMap SymbolSpaces;						//!< Symbol spaces created while this overlay was active
+
+		//! Symbols added to frozen symbol spaces, indexed by symbol space name then symbol
+		std::map<std::string, std::map<std::string, ULPtr> > Symbols;
+
+		UInt32 Generation;									//!< Count of classes added, so cached lookups can be discarded
+
+		bool Cached;										//!< True once this overlay is in the overlay cache, after which it must not be changed
+
+	public:
+		//! Build an empty overlay
+		TypeOverlay() : Generation(0), Cached(false) {}
+
+		//! Add a class to this overlay
+		void AddClass(const MDOTypePtr &Class, const UL &ClassUL);
+
+		//! Find a class in this overlay by UL, matching version-less if no exact match
+		MDOTypePtr FindClass(const UL &ClassUL) const;
+
+		//! Get the list of all classes added to this overlay
+		const MDOTypeList &GetClasses(void) const { return Classes; }
+
+		//! Get the list of all classes added to this overlay, allowing the classes to be updated
+		MDOTypeList &GetClasses(void) { return Classes; }
+
+		//! Add a type to this overlay
+		void AddType(const MDTypePtr &Type, const UL &TypeUL);
+
+		//! Find a type in this overlay by UL, matching version-less if no exact match
+		MDTypePtr FindType(const UL &TypeUL) const;
+
+		//! Add a symbol space created while this overlay is active
+		void AddSymbolSpace(const SymbolSpacePtr &Space);
+
+		//! Find a symbol space created while this overlay was active
+		SymbolSpacePtr FindSymbolSpace(const std::string &Name) const;
+
+		//! Add a symbol to a frozen symbol space
+		/*! \return false if the symbol is already in this overlay for that symbol space */
+		bool AddSymbol(const std::string &SpaceName, const std::string &Symbol, ULPtr &SymbolUL);
+
+		//! Find a symbol added to a frozen symbol space
+		ULPtr FindSymbol(const std::string &SpaceName, const std::string &Symbol) const;
+
+		//! Find a symbol in any symbol space of this overlay
+		ULPtr FindSymbol(const std::string &Symbol) const;
+
+		//! Get a value that changes whenever a class is added to this overlay
+		UInt32 GetGeneration(void) const { return Generation; }
+
+		//! Determine if this overlay is in the overlay cache, and so is shared and must not be changed
+		bool IsCached(void) const { return Cached; }
+
+		//! Find an overlay in the overlay cache
+		/*! \param Key The key the overlay was cached with, such as a hash of the metadictionary it was built from
+		 *  \return NULL if no overlay is cached with that key
+		 */
+		static TypeOverlayPtr FindCached(const DataChunk &Key);
+
+		//! Add a completed overlay to the overlay cache
+		/*! The least recently found overlay is discarded if the cache is full.
+		 *  \note The overlay must not be changed after it is cached, as it may be in use by other threads
+		 */
+		static void AddCached(const DataChunk &Key, TypeOverlayPtr Overlay);
+
+		//! Discard all overlays in the overlay cache, used when the dictionary is cleared
+		static void ClearCache(void);
+
+		//! Set the maximum number of overlays held in the overlay cache, 0 disables caching
+		static void SetCacheLimit(size_t Limit);
+
+		//! Get the overlay active on this thread, or NULL if none is
+		static TypeOverlay *Current(void);
+
+		//! Makes an overlay the active one for this thread for the lifetime of the scope object
+		/*! The previously active overlay (if any) is restored when the scope ends, so scopes may be nested */
+		class Scope
+		{
+		protected:
+			TypeOverlay *Previous;							//!< The overlay active before this scope
+
+		public:
+			//! Make an overlay active, or leave the current one active if NULL
+			Scope(TypeOverlay *Overlay);
+
+			//! Restore the previously active overlay
+			~Scope();
+
+		private:
+			//! Prevent copy construction
+			Scope(const Scope &);
+
+			//! Prevent assignment
+			Scope &operator=(const Scope &);
+		};
+
+	private:
+		//! Prevent copy construction
+		TypeOverlay(const TypeOverlay &);
+	};
+}
+
+#endif // MXFLIB__TYPEOVERLAY_H
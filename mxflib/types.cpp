@@ -12,42 +12,6 @@ using namespace mxflib;
 #include "types.h"
 
 
-//! Fast compare a UL based on testing most-likely to fail bytes first
-/*! We use an unrolled loop with modified order for best efficiency
- *  There may be a slightly faster way that will prevent pipeline stalling, but this is fast enough!
- */
-bool mxflib::UL::operator==(const UL &RHS) const
-{
-	// Most differences are in the second 8 bytes so we check those first
-	UInt8 const *pLHS = &Ident[8];
-	UInt8 const *pRHS = &RHS.Ident[8];
-	
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 8
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 9
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 10
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 11
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 12
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 13
-	if(*pLHS++ != *pRHS++) return false;		// Test byte 14
-	if(*pLHS != *pRHS) return false;			// Test byte 15
-
-	// Now we test the first 8 bytes, but in reverse as the first 4 are almost certainly "06 0e 2b 34"
-	// We use predecrement from the original start values so that the compiler will optimize the address calculation if possible
-	pLHS = &Ident[8];
-	pRHS = &RHS.Ident[8];
-
-	if(*--pLHS != *--pRHS) return false;		// Test byte 7
-	if(*--pLHS != *--pRHS) return false;		// Test byte 6
-	if(*--pLHS != *--pRHS) return false;		// Test byte 5
-	if(*--pLHS != *--pRHS) return false;		// Test byte 4
-	if(*--pLHS != *--pRHS) return false;		// Test byte 3
-	if(*--pLHS != *--pRHS) return false;		// Test byte 2
-	if(*--pLHS != *--pRHS) return false;		// Test byte 1
-	
-	return (*--pLHS == *--pRHS);				// Test byte 0
-}
-
-
 //! Fast compare of effective values of UL based on testing most-likely to fail bytes first
 /*! DRAGONS: This comparison ignores the UL version number and group coding
  *	We use an unrolled loop with modified order for best efficiency.
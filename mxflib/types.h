@@ -77,6 +77,35 @@ namespace mxflib
 }
 
 
+namespace mxflib
+{
+	//! Compare two 16-byte keys
+	/*! The keys are compared as a pair of 64-bit words, with no assumptions made about alignment
+	 *  DRAGONS: The memcpy calls are resolved to plain loads by any optimizing compiler
+	 */
+	inline bool ULEquals(const UInt8 *LHS, const UInt8 *RHS)
+	{
+		UInt64 L[2], R[2];
+		memcpy(L, LHS, 16);
+		memcpy(R, RHS, 16);
+
+		// Most differences are in the second 8 bytes so we check those first
+		return (L[1] == R[1]) && (L[0] == R[0]);
+	}
+
+	//! Compare two 16-byte keys, only testing the bits that are set in a 16-byte mask
+	inline bool ULMaskedEquals(const UInt8 *LHS, const UInt8 *RHS, const UInt8 *Mask)
+	{
+		UInt64 L[2], R[2], M[2];
+		memcpy(L, LHS, 16);
+		memcpy(R, RHS, 16);
+		memcpy(M, Mask, 16);
+
+		return (((L[1] ^ R[1]) & M[1]) == 0) && (((L[0] ^ R[0]) & M[0]) == 0);
+	}
+}
+
+
 namespace mxflib
 {
 	template <int SIZE> class Identifier /*: public RefCount<Identifier<SIZE> >*/
@@ -212,7 +241,7 @@ namespace mxflib
 		UL(const UUID *RHS) { operator=(*RHS); }
 
 		//! Fast compare a UL based on testing most-likely to fail bytes first
-		bool operator==(const UL &RHS) const;
+		bool operator==(const UL &RHS) const { return ULEquals(Ident, RHS.Ident); }
 
 		//! Simple != implementation
 		bool operator!=(const UL& Other) const { return !operator==(Other); }
@@ -0,0 +1,186 @@
+/*! \file	ulhash.h
+ *	\brief	Definition of a hash table keyed on 16-byte ULs
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  The type system looks up a definition by UL for every item read from header metadata.
+ *  ULHashMap is an open-addressing hash table that finds an entry in close to constant time,
+ *  however many definitions are loaded. It can either match keys exactly, or use the same
+ *  rules as UL::Matches() so that the version number (and group coding) is ignored.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#ifndef MXFLIB__ULHASH_H
+#define MXFLIB__ULHASH_H
+
+#include <vector>
+
+namespace mxflib
+{
+	//! Hash table mapping ULs to values
+	/*! Entries are held in the order they were added, with a power-of-two table of indexes into that list.
+	 *  If more than one entry matches a key, the one added first is found.
+	 *  \note Entries cannot be removed individually, only by clearing the whole table
+	 */
+	template<class T> class ULHashMap
+	{
+	protected:
+		//! A single entry in the table
+		struct Entry
+		{
+			UInt8 Key[16];					//!< The UL for this entry
+			T Value;						//!< The value for this entry
+		};
+
+		std::vector<Entry> Entries;			//!< All entries, in the order they were added
+		std::vector<UInt32> Slots;			//!< Hash table of (index + 1) into Entries, 0 for an empty slot
+		UInt32 Mask;						//!< Size of Slots - 1
+		bool Versionless;					//!< True if keys are compared with the rules of UL::Matches() rather than exactly
+
+	public:
+		//! Build an empty table, optionally matching keys with the rules of UL::Matches() rather than exactly
+		ULHashMap(bool Versionless = false) : Mask(0), Versionless(Versionless) {}
+
+		//! Get the number of entries in the table
+		size_t size(void) const { return Entries.size(); }
+
+		//! Determine if the table is empty
+		bool empty(void) const { return Entries.empty(); }
+
+		//! Remove all entries
+		void clear(void)
+		{
+			Entries.clear();
+			Slots.clear();
+			Mask = 0;
+		}
+
+		//! Make space for a given number of entries without the table needing to grow
+		void reserve(size_t Count)
+		{
+			Entries.reserve(Count);
+			if((Count * 2) > Slots.size()) Rehash(Count * 2);
+		}
+
+		//! Set the value for a key, replacing any existing entry that matches the key
+		void Set(const UL &Key, const T &Value)
+		{
+			UInt32 Index = FindIndex(Key.GetValue());
+			if(Index) Entries[Index - 1].Value = Value;
+			else Add(Key, Value);
+		}
+
+		//! Add an entry for a key, even if there is an existing entry that matches the key
+		void Add(const UL &Key, const T &Value)
+		{
+			if(((Entries.size() + 1) * 2) > Slots.size()) Rehash((Entries.size() + 1) * 2);
+
+			Entry NewEntry;
+			memcpy(NewEntry.Key, Key.GetValue(), 16);
+			NewEntry.Value = Value;
+			Entries.push_back(NewEntry);
+
+			Place(static_cast<UInt32>(Entries.size()));
+		}
+
+		//! Find the value for a key
+		/*! \return A pointer to the value of the first entry that matches the key, or NULL if none does */
+		const T *Find(const UL &Key) const
+		{
+			UInt32 Index = FindIndex(Key.GetValue());
+			if(Index) return &Entries[Index - 1].Value;
+			return NULL;
+		}
+
+	protected:
+		//! Calculate the hash of a key, ignoring the bytes that UL::Matches() may ignore if this is a versionless table
+		UInt32 Hash(const UInt8 *Key) const
+		{
+			// 32-bit FNV-1a
+			UInt32 Ret = 0x811c9dc5;
+			for(int i=0; i<16; i++)
+			{
+				if(Versionless && ((i == 5) || (i == 7))) continue;
+				Ret = (Ret ^ Key[i]) * 0x01000193;
+			}
+
+			return Ret;
+		}
+
+		//! Determine if a stored key matches a key being searched for
+		bool KeyMatches(const UInt8 *Stored, const UInt8 *Key) const
+		{
+			if(!Versionless) return memcmp(Stored, Key, 16) == 0;
+
+			// DRAGONS: These are the rules used by UL::Matches(), with the stored key taking the place of "this"
+			if(memcmp(&Stored[8], &Key[8], 8) != 0) return false;
+			if(Stored[6] != Key[6]) return false;
+			if((Stored[5] != Key[5]) && (Stored[4] != 0x02)) return false;
+			return memcmp(Stored, Key, 5) == 0;
+		}
+
+		//! Find the entry that matches a key
+		/*! \return Index + 1 of the first entry (in the order added) that matches, or 0 if none does */
+		UInt32 FindIndex(const UInt8 *Key) const
+		{
+			if(Entries.empty()) return 0;
+
+			// DRAGONS: Keys that match each other always have the same hash, so the first one added is always reached first
+			UInt32 Slot = Hash(Key) & Mask;
+			for(;;)
+			{
+				UInt32 Index = Slots[Slot];
+				if(Index == 0) return 0;
+				if(KeyMatches(Entries[Index - 1].Key, Key)) return Index;
+
+				Slot = (Slot + 1) & Mask;
+			}
+		}
+
+		//! Put the entry with a given (index + 1) into the first free slot for its key
+		void Place(UInt32 Index)
+		{
+			UInt32 Slot = Hash(Entries[Index - 1].Key) & Mask;
+			while(Slots[Slot]) Slot = (Slot + 1) & Mask;
+			Slots[Slot] = Index;
+		}
+
+		//! Rebuild the hash table with at least a given number of slots
+		void Rehash(size_t MinSlots)
+		{
+			size_t NewSize = 16;
+			while(NewSize < MinSlots) NewSize <<= 1;
+
+			Slots.assign(NewSize, 0);
+			Mask = static_cast<UInt32>(NewSize - 1);
+
+			// Re-add the entries in the order they were originally added so that the first added is still found first
+			UInt32 Count = static_cast<UInt32>(Entries.size());
+			for(UInt32 i=1; i<=Count; i++) Place(i);
+		}
+	};
+}
+
+#endif // MXFLIB__ULHASH_H
@@ -110,128 +110,237 @@ int ANCVBISource::Field2Offset(void)
 //! Build the data for this frame in SMPTE-436M format
 DataChunkPtr ANCVBISource::BuildChunk(void)
 {
-	/* Fill lines from line sources */
+	/* Gather the lines for this frame from the line sources, sorted by line number */
+
+	// DRAGONS: Clearing the vector keeps its storage, so after the first frame this does not allocate
+	PendingLines.clear();
 
 	ANCVBILineSourceList::iterator LS_it = Sources.begin();
 	while(LS_it != Sources.end())
 	{
-		int LineNumber = (*LS_it)->GetLineNumber();
-		if((*LS_it)->GetField() == 2) LineNumber += Field2Offset();
-
-		Lines.insert(ANCLineMap::value_type(
-				LineNumber, 
-				new ANCLine(LineNumber, 
-				(*LS_it)->GetWrappingType(), 
-				(*LS_it)->GetSampleCoding(), 
-				(*LS_it)->GetLineData(), 
-				(*LS_it)->GetDID(), 
-				(*LS_it)->GetSDID())));
+		PendingLine Line;
+		Line.LineNumber = (*LS_it)->GetLineNumber();
+		if((*LS_it)->GetField() == 2) Line.LineNumber += Field2Offset();
+		Line.Source = (*LS_it).GetPtr();
+
+		int DirectSize = Line.Source->GetLineDataSize();
+		if(DirectSize >= 0)
+		{
+			Line.DataSize = static_cast<size_t>(DirectSize);
+		}
+		else
+		{
+			Line.LineData = Line.Source->GetLineData();
+			Line.DataSize = Line.LineData ? Line.LineData->Size : 0;
+		}
+
+		// Insert in line number order, after any existing lines with the same number
+		// DRAGONS: There are rarely more than a handful of lines, and they are usually already in order, so a simple insertion is fastest
+		std::vector<PendingLine>::iterator Pos = PendingLines.end();
+		while((Pos != PendingLines.begin()) && ((*(Pos - 1)).LineNumber > Line.LineNumber)) Pos--;
+		PendingLines.insert(Pos, Line);
 
 		LS_it++;
 	}
 
 
-	/* Now build the chunk from line data */
+	/* Work out the exact size of the frame, so that it is built in a single buffer */
 
-	/* First we handle the special case of no lines this frame (should be quite common) */
-	if(Lines.empty())
-	{
-		// Simply return "Number of Lines = 0"
-		DataChunkPtr Ret = new DataChunk(2);
-		PutU16(0, Ret->Data);
+	size_t BufferSize = 2;
+	UInt16 LineCount = 0;
 
-		return Ret;
-	}
+	std::vector<PendingLine>::iterator it = PendingLines.begin();
+	while(it != PendingLines.end())
+	{
+		// Only the first line-source for each line is written
+		if((it == PendingLines.begin()) || ((*(it - 1)).LineNumber != (*it).LineNumber))
+		{
+			// ANC packets need to start DID, SDID, DataCount
+			size_t Bytes = (*it).DataSize;
+			if((*it).Source->GetDID() != -1) Bytes += 3;
 
-	VBILineMap::iterator it = Lines.begin();
+			// Add the line header, and the line data rounded to the next UInt32 boundary
+			BufferSize += 14 + ((Bytes + 3) / 4) * 4;
+			LineCount++;
+		}
 
-	// Guess the buffer size by assuming that all the lines are the same size, then add 2 bytes for the line count
-	// DRAGONS: If the line sizes do vary this is a bottle-neck
-	// DRAGONS: We will use this as a remaining-bytes counter while writing the data
-	size_t BufferSize = ((*it).second->GetFullDataSize() * Lines.size()) + 2;
+		it++;
+	}
 
-	// Get a buffer of this size
 	DataChunkPtr Ret = new DataChunk(BufferSize);
 
-	// Index the start of the buffer
-	UInt8 *pBuffer = Ret->Data;
+	// Write in the number of lines (this is all there is if no lines this frame, which should be quite common)
+	PutU16(LineCount, Ret->Data);
+	UInt8 *pBuffer = &Ret->Data[2];
 
-	// Write in the number of lines
-	PutU16(static_cast<UInt16>(Lines.size()), Ret->Data);
-	pBuffer += 2;
-	BufferSize -= 2;
 
-	while(it != Lines.end())
-	{
-		// Get the number of bytes required to add this line to the buffer
-		size_t RequiredBytes = (*it).second->GetFullDataSize();
+	/* Now write each line */
 
-		// If we don't have enough space we must increase the buffer size - can only happen if lines differ in size
-		if(RequiredBytes > BufferSize)
+	it = PendingLines.begin();
+	while(it != PendingLines.end())
+	{
+		if((it != PendingLines.begin()) && ((*(it - 1)).LineNumber == (*it).LineNumber))
 		{
-			// Work out how far through the buffer we currently are
-			size_t CurrentPos = pBuffer - Ret->Data;
+			it++;
+			continue;
+		}
 
-			// Make the buffer big enough for this line
-			Ret->Resize(static_cast<UInt32>(CurrentPos + RequiredBytes));
+		ANCVBILineSource *Source = (*it).Source;
+		UInt8 *pData = &pBuffer[14];
 
-			// Flag that we now have just enough bytes left
-			BufferSize = RequiredBytes;
+		// ANC packets need to start DID, SDID, DataCount
+		size_t Bytes = (*it).DataSize;
+		UInt16 SampleCount;
+		int DID = Source->GetDID();
+		if(DID != -1)
+		{
+			pData[0] = static_cast<UInt8>(DID);
+			pData[1] = static_cast<UInt8>(Source->GetSDID());
+			pData[2] = static_cast<UInt8>((*it).DataSize);
+			pData += 3;
+			Bytes += 3;
+		}
 
-			// Set the buffer pointer in the (possibly re-allocated) buffer
-			pBuffer = &Ret->Data[CurrentPos];
+		// Write the line data, either directly by the line source or from the data it has already supplied
+		if((*it).LineData)
+		{
+			if((*it).DataSize) memcpy(pData, (*it).LineData->Data, (*it).DataSize);
+			SampleCount = static_cast<UInt16>(Bytes);
+		}
+		else
+		{
+			SampleCount = Source->WriteLineData(pData);
+			if(DID != -1) SampleCount += 3;
 		}
 
-		// Write the data into the buffer (formatted by the VBILine itself)
-		(*it).second->WriteData(pBuffer);
+		// Pad with zeros to the next UInt32 boundary
+		size_t PaddedBytes = ((Bytes + 3) / 4) * 4;
+		if(PaddedBytes > Bytes) memset(&pBuffer[14 + Bytes], 0, PaddedBytes - Bytes);
 
-		// Update the buffer pointer and bytes-remaining count
-		pBuffer += RequiredBytes;
-		BufferSize -= RequiredBytes;
+		// Finally write the line header in front of the data
+		pBuffer += ANCVBILine::WriteHeader(pBuffer, (*it).LineNumber, Source->GetWrappingType(), Source->GetSampleCoding(), SampleCount, PaddedBytes);
+		pBuffer += PaddedBytes;
 
 		it++;
 	}
 
-	// Resize the buffer to the actual number of bytes that we wrote
-	Ret->Resize(static_cast<UInt32>(pBuffer - Ret->Data));
-
-	// Clear the list of pending lines
-	Lines.clear();
+	// Release any line data held for this frame
+	PendingLines.clear();
 
 	// Return the finished data
 	return Ret;
 }
 
 
-//! Write the line of data into a buffer, including the line number, wrapping type, sample coding and sample count bytes
-/*! \note It is the caller's responsibility to ensure that the buffer has enough space - the number of bytes written <b>will be</b> GetFullDataSize()
+//! Write the line number, wrapping type, sample coding, sample count and array header for a line into a buffer
+/*! \return The number of bytes written, which is always 14
  */
-void ANCVBILine::WriteData(UInt8 *Buffer)
+size_t ANCVBILine::WriteHeader(UInt8 *Buffer, int LineNumber, ANCWrappingType Wrapping, ANCSampleCoding Coding, UInt16 SampleCount, size_t DataSize)
 {
 	// Write the line number
-	PutU16( LineNumber, Buffer);
+	PutU16(static_cast<UInt16>(LineNumber), Buffer);
 
 	// Add the wrapping type
-	Buffer[2] = static_cast<UInt8>(WrappingType);
+	Buffer[2] = static_cast<UInt8>(Wrapping);
 
 	// Add the sample coding
-	Buffer[3] = static_cast<UInt8>(SampleCoding);
+	Buffer[3] = static_cast<UInt8>(Coding);
 
 	// And the sample count
-	PutU16(static_cast<UInt16>(SampleCount), &Buffer[4]);
+	PutU16(SampleCount, &Buffer[4]);
+
+	// Then the array header for the line data
+	PutU32(static_cast<UInt32>(DataSize), &Buffer[6]);
+	PutU32(1, &Buffer[10]);
 
-	// Then copy in all the line data (assuming we have some) including the array header
+	return 14;
+}
+
+
+//! Write the line of data into a buffer, including the line number, wrapping type, sample coding and sample count bytes
+/*! \note It is the caller's responsibility to ensure that the buffer has enough space - the number of bytes written <b>will be</b> GetFullDataSize()
+ */
+void ANCVBILine::WriteData(UInt8 *Buffer)
+{
+	// Write the header, then copy in all the line data (assuming we have some)
 	if(Data.Data)
 	{
-		PutU32(static_cast<UInt32>(Data.Size), &Buffer[6]);
-		PutU32(1, &Buffer[10]);
+		WriteHeader(Buffer, LineNumber, WrappingType, SampleCoding, SampleCount, Data.Size);
 		memcpy(&Buffer[14], Data.Data, Data.Size);
 	}
 	else
 	{
-		PutU32(0, &Buffer[6]);
-		PutU32(1, &Buffer[10]);
+		WriteHeader(Buffer, LineNumber, WrappingType, SampleCoding, SampleCount, 0);
+	}
+}
+
+
+//! Pack 10-bit samples into a buffer as per SMPTE-436M, three samples per 32-bit word with the first sample in the most significant bits
+/*! The last word is padded with zero samples if Count is not a multiple of 3. Only the least significant 10 bits of each sample are used.
+ *  \return The number of bytes written, which will be Packed10BitSize(Count)
+ */
+size_t ANCVBILine::Pack10Bit(UInt8 *Buffer, const UInt16 *Samples, size_t Count)
+{
+	UInt8 *pBuffer = Buffer;
+
+	// Pack whole words of three samples
+	size_t Words = Count / 3;
+	while(Words--)
+	{
+		UInt32 Word = (static_cast<UInt32>(Samples[0] & 0x3ff) << 20) | (static_cast<UInt32>(Samples[1] & 0x3ff) << 10) | (Samples[2] & 0x3ff);
+		PutU32(Word, pBuffer);
+
+		Samples += 3;
+		pBuffer += 4;
+	}
+
+	// Pack any remaining one or two samples, padded with zeros
+	size_t Remaining = Count % 3;
+	if(Remaining)
+	{
+		UInt32 Word = static_cast<UInt32>(Samples[0] & 0x3ff) << 20;
+		if(Remaining == 2) Word |= static_cast<UInt32>(Samples[1] & 0x3ff) << 10;
+		PutU32(Word, pBuffer);
+
+		pBuffer += 4;
+	}
+
+	return static_cast<size_t>(pBuffer - Buffer);
+}
+
+
+//! Unpack 10-bit samples packed as per SMPTE-436M
+/*! \return The number of bytes read, which will be Packed10BitSize(Count)
+ */
+size_t ANCVBILine::Unpack10Bit(UInt16 *Samples, const UInt8 *Buffer, size_t Count)
+{
+	const UInt8 *pBuffer = Buffer;
+
+	// Unpack whole words of three samples
+	size_t Words = Count / 3;
+	while(Words--)
+	{
+		UInt32 Word = GetU32(pBuffer);
+		Samples[0] = static_cast<UInt16>((Word >> 20) & 0x3ff);
+		Samples[1] = static_cast<UInt16>((Word >> 10) & 0x3ff);
+		Samples[2] = static_cast<UInt16>(Word & 0x3ff);
+
+		Samples += 3;
+		pBuffer += 4;
+	}
+
+	// Unpack any remaining one or two samples
+	size_t Remaining = Count % 3;
+	if(Remaining)
+	{
+		UInt32 Word = GetU32(pBuffer);
+		Samples[0] = static_cast<UInt16>((Word >> 20) & 0x3ff);
+		if(Remaining == 2) Samples[1] = static_cast<UInt16>((Word >> 10) & 0x3ff);
+
+		pBuffer += 4;
 	}
+
+	return static_cast<size_t>(pBuffer - Buffer);
 }
 
 
@@ -297,13 +406,13 @@ DataChunkPtr ANCVBISource::GetEssenceData(size_t Size /*=0*/, size_t MaxSize /*=
 	size_t Bytes = BufferedData.front()->Size - BufferOffset;
 	
 	// If we can return all these now, do so
-	if(Bytes <= MaxSize)
+	if((MaxSize == 0) || (Bytes <= MaxSize))
 	{
 		// Build a new buffer to hold the reduced data
 		DataChunkPtr Ret = new DataChunk(Bytes);
 
 		// Copy in the remaining bytes
-		Ret->Set(static_cast<UInt32>(Bytes), BufferedData.front()->Data);
+		Ret->Set(static_cast<UInt32>(Bytes), &BufferedData.front()->Data[BufferOffset]);
 
 		// Remove this item from the list of buffers
 		BufferedData.pop_front();
@@ -319,10 +428,10 @@ DataChunkPtr ANCVBISource::GetEssenceData(size_t Size /*=0*/, size_t MaxSize /*=
 	DataChunkPtr Ret = new DataChunk(MaxSize);
 
 	// Copy in as many bytes as permitted
-	Ret->Set(static_cast<UInt32>(MaxSize), BufferedData.front()->Data);
+	Ret->Set(static_cast<UInt32>(MaxSize), &BufferedData.front()->Data[BufferOffset]);
 
 	// Update the offset
-	BufferOffset -= MaxSize;
+	BufferOffset += MaxSize;
 
 	// Return the data
 	return Ret;
@@ -93,11 +93,11 @@ namespace mxflib
 	public:
 		//! Construct a VBILine with no data
 		ANCVBILine(int LineNumber, ANCWrappingType Wrapping, ANCSampleCoding Coding)
-			: LineNumber(LineNumber), WrappingType(Wrapping), SampleCoding(Coding) {};
+			: LineNumber(LineNumber), WrappingType(Wrapping), SampleCoding(Coding), SampleCount(0) {};
 
 		//! Construct a VBILine with no data, for an interlaced frame
 		ANCVBILine(int Field, int LineNumber, ANCWrappingType Wrapping, ANCSampleCoding Coding)
-			: WrappingType(Wrapping), SampleCoding(Coding) 
+			: WrappingType(Wrapping), SampleCoding(Coding), SampleCount(0)
 		{
 			if(Field == 2) this->LineNumber = 0x4000 + LineNumber;
 			else this->LineNumber = LineNumber;
@@ -132,6 +132,9 @@ namespace mxflib
 				// Set the line data
 				Data.Set(LineData);
 
+				// Each byte is one sample
+				SampleCount = static_cast<UInt16>(LineData->Size);
+
 				// Pad with zeros if required
 				if(LineData->Size < Size) memset(&Data.Data[LineData->Size], 0, Size - LineData->Size);
 			}
@@ -170,6 +173,25 @@ namespace mxflib
 		/*! \note It is the caller's responsibility to ensure that the buffer has enough space - the number of bytes written <b>will be</b> GetFullDataSize()
 		 */
 		void WriteData(UInt8 *Buffer);
+
+		//! Write the line number, wrapping type, sample coding, sample count and array header for a line into a buffer
+		/*! \return The number of bytes written, which is always 14
+		 */
+		static size_t WriteHeader(UInt8 *Buffer, int LineNumber, ANCWrappingType Wrapping, ANCSampleCoding Coding, UInt16 SampleCount, size_t DataSize);
+
+		//! Get the number of bytes needed to hold a given number of 10-bit samples packed as per SMPTE-436M
+		static size_t Packed10BitSize(size_t Count) { return ((Count + 2) / 3) * 4; }
+
+		//! Pack 10-bit samples into a buffer as per SMPTE-436M, three samples per 32-bit word with the first sample in the most significant bits
+		/*! The last word is padded with zero samples if Count is not a multiple of 3. Only the least significant 10 bits of each sample are used.
+		 *  \return The number of bytes written, which will be Packed10BitSize(Count)
+		 */
+		static size_t Pack10Bit(UInt8 *Buffer, const UInt16 *Samples, size_t Count);
+
+		//! Unpack 10-bit samples packed as per SMPTE-436M
+		/*! \return The number of bytes read, which will be Packed10BitSize(Count)
+		 */
+		static size_t Unpack10Bit(UInt16 *Samples, const UInt8 *Buffer, size_t Count);
 	};
 
 	//! Alias for ANC usage of ANCVBILine
@@ -220,6 +242,20 @@ namespace mxflib
 		//! Get the next line of data to wrap
 		virtual DataChunkPtr GetLineData(void) = 0;
 
+		//! Get the size of the next line of data, if it can be written directly into the frame buffer with WriteLineData()
+		/*! Line-sources that can write their data directly should override this and WriteLineData() to avoid
+		 *  allocating a new chunk for each line of each frame.
+		 *  \return The number of bytes that WriteLineData() will write, or -1 if the data must be read with GetLineData()
+		 */
+		virtual int GetLineDataSize(void) { return -1; }
+
+		//! Write the next line of data directly into the frame buffer
+		/*! \param Buffer The buffer to write into, which will have space for GetLineDataSize() bytes
+		 *  \return The number of samples written (this is the number of bytes for 8-bit sample codings)
+		 *  \note This is only called if GetLineDataSize() has returned a size, and is called instead of GetLineData()
+		 */
+		virtual UInt16 WriteLineData(UInt8 *Buffer) { return 0; }
+
 		//! Determine if this line-source is able to be used when slaved from a master with the given wrapping configuration
 		/*! \return Simple and short text description of the line being wrapped if OK (e.g. "Fixed AFD of 0x54") or empty string if not valid
 		 */
@@ -251,7 +287,18 @@ namespace mxflib
 	protected:
 		ANCVBILineSourceList Sources;		//!< List of line sources used to build lines
 
-		ANCVBILineMap Lines;				//!< Map of lines built for this frame
+		//! A line to be written in the frame being built
+		struct PendingLine
+		{
+			int LineNumber;					//!< The line number, including any field 2 offset
+			ANCVBILineSource *Source;		//!< The line-source supplying this line
+			DataChunkPtr LineData;			//!< The data for this line if not written directly by the line-source
+			size_t DataSize;				//!< The number of bytes of data for this line, excluding DID, SDID, DataCount and padding
+		};
+
+		//! Lines for the frame being built, in line number order
+		/*! This is kept between frames so that its storage is re-used */
+		std::vector<PendingLine> PendingLines;
 
 		DataChunkList BufferedData;			//!< List of data items prepared and ready to be supplied in response to GetEssenceData() - next to be supplied is the head
 
@@ -378,6 +425,10 @@ namespace mxflib
 
 	protected:
 		//! Build the ANC or VBI data for this frame in SMPTE-436M format
+		/*! The frame is built in a single buffer of the exact size required. Line-sources that support WriteLineData()
+		 *  write straight into this buffer, so frames where all lines are written this way need only one allocation.
+		 *  \note If two line-sources supply the same line, only the first is written
+		 */
 		DataChunkPtr BuildChunk(void);
 
 		//! Get the wrapping UL to use
@@ -467,13 +518,23 @@ namespace mxflib
 		//! Get the next line of data to wrap
 		DataChunkPtr GetLineData(void)
 		{
-			// Build a simple payload with just the AFD and no bar data
 			DataChunkPtr Payload = new DataChunk(8);
-			Payload->Data[0] = CurrentAFD;
-			memset(&Payload->Data[1], 0, 7);
+			WriteLineData(Payload->Data);
 			return Payload;
 		}
 
+		//! Get the size of the next line of data, which is always written directly
+		int GetLineDataSize(void) { return 8; }
+
+		//! Write the next line of data directly into the frame buffer
+		UInt16 WriteLineData(UInt8 *Buffer)
+		{
+			// Build a simple payload with just the AFD and no bar data
+			Buffer[0] = CurrentAFD;
+			memset(&Buffer[1], 0, 7);
+			return 8;
+		}
+
 		//! Determine if this line-source is able to be used when slaved from a master with the given wrapping configuration
 		/*! \return Simple and short text description of the line being wrapped if OK (e.g. "Fixed AFD of 0x54") or empty string if not valid
 		 */
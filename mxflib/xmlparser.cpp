@@ -34,8 +34,57 @@
 #include "expat.h"
 
 
+namespace
+{
+	//! Largest block passed to expat in one call, as it takes an int length
+	const size_t MaxParseBlock = 1024 * 1024 * 1024;
+
+	//! Build a new expat parser using a given handler
+	XML_Parser CreateParser(mxflib::XMLParserHandlerPtr Hand, void *UserData, bool ParseNamespaces)
+	{
+		XML_Parser Parser = ParseNamespaces ? XML_ParserCreateNS(NULL, '|') : XML_ParserCreate(NULL);
+		if(!Parser)
+		{
+			Hand->fatalError(UserData, "Could't create an expat XML parser\n");
+			return NULL;
+		}
+
+		// Set the element handlers
+		XML_SetElementHandler(Parser, Hand->startElement, Hand->endElement);
+
+		// Set the user data
+		XML_SetUserData(Parser, UserData);
+
+		return Parser;
+	}
+
+	//! Parse a block of XML held in memory, without copying it
+	/*! \return false on a parse error, which will have been reported */
+	bool ParseBlock(XML_Parser Parser, mxflib::XMLParserHandlerPtr Hand, void *UserData, const char *Data, size_t Size, bool Final)
+	{
+		do
+		{
+			size_t Bytes = Size > MaxParseBlock ? MaxParseBlock : Size;
+			int IsFinal = (Final && (Bytes == Size)) ? 1 : 0;
+
+			if(XML_Parse(Parser, Data, static_cast<int>(Bytes), IsFinal) == XML_STATUS_ERROR)
+			{
+				Hand->fatalError(UserData, "Parse error at line %d:\n%s\n",  XML_GetCurrentLineNumber(Parser),
+																			 XML_ErrorString(XML_GetErrorCode(Parser)));
+				return false;
+			}
+
+			Data += Bytes;
+			Size -= Bytes;
+		} while(Size);
+
+		return true;
+	}
+}
+
 
 //! Use Expat parser to parse an XML file
+/*! The whole file is mapped into memory and parsed in place where possible, otherwise it is read and parsed in blocks */
 bool mxflib::XMLParserParseFile(XML_Parser *pParser, mxflib::XMLParserHandlerPtr Hand, void *UserData, const char *filename, bool ParseNamespaces /*=false*/)
 {
 	if(!Hand)
@@ -53,10 +102,9 @@ bool mxflib::XMLParserParseFile(XML_Parser *pParser, mxflib::XMLParserHandlerPtr
 	}
 
 	// Build a new parser
-	XML_Parser Parser = ParseNamespaces ? XML_ParserCreateNS(NULL, '|') : XML_ParserCreate(NULL);
+	XML_Parser Parser = CreateParser(Hand, UserData, ParseNamespaces);
 	if(!Parser)
 	{
-		Hand->fatalError(UserData, "Could't create an expat XML parser\n");
 		FileClose(InFile);
 		return false;
 	}
@@ -64,90 +112,101 @@ bool mxflib::XMLParserParseFile(XML_Parser *pParser, mxflib::XMLParserHandlerPtr
 	// Set the caller's parser pointer if requested
 	if(pParser) *pParser = Parser;
 
-	// Set the element handlers
-	XML_SetElementHandler(Parser, Hand->startElement, Hand->endElement);
+	bool Ret = true;
 
-	// Set the user data
-	XML_SetUserData(Parser, UserData);
-
-	int Done = 0;
-	do
+	Int64 Size = FileSize(InFile);
+	UInt8 *Mapped = (Size > 0) ? FileMemoryMap(InFile, static_cast<UInt64>(Size)) : NULL;
+	if(Mapped)
 	{
-		const int BufferSize = 1024 * 64;
-		UInt8 *Buffer = (UInt8*)XML_GetBuffer(Parser, BufferSize);
-
-		int Bytes = (int)FileRead(InFile, Buffer, BufferSize);
+		Ret = ParseBlock(Parser, Hand, UserData, reinterpret_cast<const char *>(Mapped), static_cast<size_t>(Size), true);
+		FileMemoryUnmap(Mapped, static_cast<UInt64>(Size));
+	}
+	else
+	{
+		int Done = 0;
+		do
+		{
+			const int BufferSize = 1024 * 64;
+			UInt8 *Buffer = (UInt8*)XML_GetBuffer(Parser, BufferSize);
 
-		if(FileEof(InFile)) Done = -1;
+			int Bytes = (int)FileRead(InFile, Buffer, BufferSize);
 
-		if (XML_ParseBuffer(Parser, Bytes, Done) == XML_STATUS_ERROR) 
-		{
-			Hand->fatalError(UserData, "Parse error at line %d:\n%s\n",  XML_GetCurrentLineNumber(Parser),
-																		 XML_ErrorString(XML_GetErrorCode(Parser)));
+			if(FileEof(InFile)) Done = -1;
 
-			XML_ParserFree(Parser);
-			FileClose(InFile);
-			return false;
-		}
-	} while(!Done);
+			if (XML_ParseBuffer(Parser, Bytes, Done) == XML_STATUS_ERROR) 
+			{
+				Hand->fatalError(UserData, "Parse error at line %d:\n%s\n",  XML_GetCurrentLineNumber(Parser),
+																			 XML_ErrorString(XML_GetErrorCode(Parser)));
+				Ret = false;
+				break;
+			}
+		} while(!Done);
+	}
 
 	// Free the parser
 	XML_ParserFree(Parser);
 
 	FileClose(InFile);
 
-	return true;
+	return Ret;
 }
 
 
-
-//! Use Expat parser to parse an XML file
+//! Use Expat parser to parse XML held in a string
+/*! The string is parsed in place, rather than being copied into the parser's own buffer */
 bool mxflib::XMLParserParseString(XML_Parser *pParser, mxflib::XMLParserHandlerPtr Hand, void *UserData, std::string & strXML, bool ParseNamespaces /*=false*/)
 {
 	if(!Hand)
 	{
-		error("No handler defined in call to XMLParserParseFile()\n");
+		error("No handler defined in call to XMLParserParseString()\n");
 		return false;
 	}
 
-
 	// Build a new parser
-	XML_Parser Parser = XML_ParserCreate(NULL);
-	if(!Parser)
-	{
-		Hand->fatalError(UserData, "Could't create an expat XML parser\n");
-		return false;
-	}
+	XML_Parser Parser = CreateParser(Hand, UserData, ParseNamespaces);
+	if(!Parser) return false;
 
 	// Set the caller's parser pointer if requested
 	if(pParser) *pParser = Parser;
 
-	// Set the element handlers
-	XML_SetElementHandler(Parser, Hand->startElement, Hand->endElement);
+	bool Ret = ParseBlock(Parser, Hand, UserData, strXML.data(), strXML.size(), true);
 
-	// Set the user data
-	XML_SetUserData(Parser, UserData);
+	// Free the parser
+	XML_ParserFree(Parser);
 
-	int Done = 0;
+	return Ret;
+}
 
-		const size_t BufferSize = strXML.size()+1;
-		char *Buffer = (char *)XML_GetBuffer(Parser, static_cast<int>(BufferSize));
-		strcpy(Buffer, strXML.c_str());
 
-		if (XML_ParseBuffer(Parser, static_cast<int>(BufferSize-1), Done) == XML_STATUS_ERROR) 
-		{
-			Hand->fatalError(UserData, "Parse error at line %d:\n%s\n",  XML_GetCurrentLineNumber(Parser),
-				XML_ErrorString(XML_GetErrorCode(Parser)));
+//! Start parsing XML that will be supplied in pieces with XMLParserContinue()
+/*! \return The parser to pass to XMLParserContinue() and XMLParserEnd(), or NULL on error */
+XML_Parser mxflib::XMLParserBegin(mxflib::XMLParserHandlerPtr Hand, void *UserData, bool ParseNamespaces /*=false*/)
+{
+	if(!Hand)
+	{
+		error("No handler defined in call to XMLParserBegin()\n");
+		return NULL;
+	}
 
-			XML_ParserFree(Parser);
-			return false;
-		}
+	return CreateParser(Hand, UserData, ParseNamespaces);
+}
 
-	// Free the parser
-	XML_ParserFree(Parser);
 
-	return true;
+//! Parse the next piece of XML started with XMLParserBegin()
+/*! The data is parsed in place and need not be kept once this returns, pieces may split the XML at any point.
+ *  \param Final Set true for the last piece
+ *  \return false on a parse error, which will have been reported
+ */
+bool mxflib::XMLParserContinue(XML_Parser Parser, mxflib::XMLParserHandlerPtr Hand, void *UserData, const char *Data, size_t Size, bool Final /*=false*/)
+{
+	return ParseBlock(Parser, Hand, UserData, Data, Size, Final);
 }
-#endif // HAVE_EXPAT
 
 
+//! Free a parser started with XMLParserBegin()
+void mxflib::XMLParserEnd(XML_Parser Parser)
+{
+	if(Parser) XML_ParserFree(Parser);
+}
+#endif // HAVE_EXPAT
+
@@ -59,6 +59,15 @@ namespace mxflib
 	{
 		return XMLParserParseString(NULL, Hand, UserData, strXML, ParseNamespaces);
 	}
+
+	//! Start parsing XML that will be supplied in pieces with XMLParserContinue()
+	XML_Parser XMLParserBegin(XMLParserHandlerPtr Hand, void *UserData, bool ParseNamespaces = false);
+
+	//! Parse the next piece of XML started with XMLParserBegin()
+	bool XMLParserContinue(XML_Parser Parser, XMLParserHandlerPtr Hand, void *UserData, const char *Data, size_t Size, bool Final = false);
+
+	//! Free a parser started with XMLParserBegin()
+	void XMLParserEnd(XML_Parser Parser);
 }
 
 #else // HAVE_EXPAT
@@ -0,0 +1,281 @@
+/*! \file	mxfrewrap.cpp
+ *	\brief	MXF to MXF re-wrapping utility for MXFLib
+ *
+ *	\version $Id$
+ *
+ */
+/*
+ *  Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *	
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *	
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include "mxflib/mxflib.h"
+
+using namespace mxflib;
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mxflib/dict.h"
+
+
+using namespace std;
+
+
+// Product GUID and version text for this release
+UInt8 ProductGUID_Data[16] = { 0x3c, 0x57, 0x1e, 0x92, 0x6a, 0x4d, 0x4b, 0x8f, 0x9e, 0x21, 0x5d, 0x0c, 0x7b, 0x83, 0xf4, 0x16 };
+string CompanyName = "freeMXF.org";
+string ProductName = "mxfrewrap MXF re-wrapping utility";
+string ProductVersion = "Based on " + LibraryVersion();
+string PlatformName = "MXFLib (" + OSName() + ")";
+
+
+//! MXFLib debug flag
+bool DebugMode = false;
+
+//! KAG to use, or 0 to keep the KAG of the source
+UInt32 KAGSize = 0;
+
+//! Number of edit units per body partition, or 0 to follow the source
+Length PartitionEditUnits = 0;
+
+//! Name of the new operational pattern, or empty to leave it unchanged
+std::string OPName;
+
+
+//! Names of the operational patterns that may be set with -op
+struct OPNameEntry
+{
+	const char *Name;					//!< The name given after -op=
+	const UL *Label;					//!< The label
+};
+
+static const OPNameEntry OPNames[] =
+{
+	{ "1a", &MXFOP1a_UL }, { "1b", &MXFOP1b_UL }, { "1c", &MXFOP1c_UL },
+	{ "2a", &MXFOP2a_UL }, { "2b", &MXFOP2b_UL }, { "2c", &MXFOP2c_UL },
+	{ "3a", &MXFOP3a_UL }, { "3b", &MXFOP3b_UL }, { "3c", &MXFOP3c_UL },
+	{ "atom", &MXFOPAtom_UL },
+	{ NULL, NULL }
+};
+
+
+//! Build the label for a named operational pattern, keeping the qualifiers of the current label of a generalized OP
+static ULPtr MakeOP(std::string Name, MetadataPtr HMeta);
+
+
+int main(int argc, char *argv[])
+{
+	printf("MXF re-wrapping utility\n");
+
+	int num_options = 0;
+	for(int i=1; i<argc; i++)
+	{
+		if(argv[i][0] == '-')
+		{
+			num_options++;
+			if((argv[i][1] == 'v') || (argv[i][1] == 'V'))
+				DebugMode = true;
+			else if((argv[i][1] == 'k') || (argv[i][1] == 'K'))
+			{
+				if((argv[i][2] != '=') && (argv[i][2] != ':'))
+				{
+					error("-k option syntax = -k=<kag-size>\n");
+					return 1;
+				}
+				KAGSize = atoi(&argv[i][3]);
+			}
+			else if(((argv[i][1] == 'o') || (argv[i][1] == 'O')) && ((argv[i][2] == 'p') || (argv[i][2] == 'P')))
+			{
+				if((argv[i][3] != '=') && (argv[i][3] != ':'))
+				{
+					error("-op option syntax = -op=<pattern>\n");
+					return 1;
+				}
+				OPName = std::string(&argv[i][4]);
+			}
+			else if((argv[i][1] == 'p') || (argv[i][1] == 'P'))
+			{
+				if((argv[i][2] != '=') && (argv[i][2] != ':'))
+				{
+					error("-p option syntax = -p=<edit-units>\n");
+					return 1;
+				}
+				PartitionEditUnits = atoi(&argv[i][3]);
+			}
+		}
+	}
+
+	// Load the dictionaries
+	LoadDictionary(DictData);
+
+	if (argc - num_options < 3)
+	{
+		printf("\nUsage:  %s [options] <in-filename> <out-filename>\n\n", argv[0] );
+
+		printf("Options:\n");
+		printf("  -k=size    Use the given KAG size (default is the KAG of the source file)\n");
+		printf("  -p=n       Start a new body partition every n edit units (default is to follow the source file)\n");
+		printf("  -op=name   Set the operational pattern label to OP1a, 1b ... 3c or Atom\n");
+		printf("  -v         Verbose mode\n");
+		printf("\n");
+		printf("The essence is copied unchanged. When changing the operational pattern the header\n");
+		printf("metadata is not restructured, so the source packages must already match the new label.\n");
+		printf("\n");
+
+		return 1;
+	}
+
+	MXFFilePtr InFile = new MXFFile;
+	if(!InFile->Open(argv[num_options+1], true))
+	{
+		error("Can't open input file\n");
+		return 1;
+	}
+
+	MXFFilePtr OutFile = new MXFFile;
+	if(!OutFile->OpenNew(argv[num_options+2]))
+	{
+		error("Can't open output file\n");
+		return 1;
+	}
+
+	RawRewrapperPtr Rewrapper = new RawRewrapper(InFile, OutFile);
+	Rewrapper->SetKAG(KAGSize);
+	Rewrapper->SetPartitionEditUnits(PartitionEditUnits);
+
+	if(!Rewrapper->ReadSource()) return 1;
+
+	MetadataPtr HMeta = Rewrapper->GetMetadata();
+
+	if(!OPName.empty())
+	{
+		ULPtr NewOP = MakeOP(OPName, HMeta);
+		if(!NewOP)
+		{
+			error("Unknown operational pattern \"%s\"\n", OPName.c_str());
+			return 1;
+		}
+
+		Rewrapper->SetOP(*NewOP);
+	}
+
+	/* Build an Ident set describing us and link into the metadata */
+
+	MDObjectPtr Ident = new MDObject(Identification_UL);
+	Ident->SetString(CompanyName_UL, CompanyName);
+	Ident->SetString(ProductName_UL, ProductName);
+	Ident->SetString(VersionString_UL, ProductVersion);
+	Ident->SetString(ToolkitVersion_UL, LibraryProductVersion());
+	Ident->SetString(Platform_UL, PlatformName);
+	Ident->SetValue(ProductUID_UL, DataChunk(16, ProductGUID_Data));
+
+	HMeta->UpdateGenerations(Ident);
+
+	bool Ret = Rewrapper->Rewrap();
+
+	InFile->Close();
+	OutFile->Close();
+
+	if(!Ret) return 1;
+
+	printf("Copied %s KLVs (%s bytes)\n", UInt64toString(Rewrapper->GetKLVCount()).c_str(), UInt64toString(Rewrapper->GetByteCount()).c_str());
+	printf("Done\n");
+
+	return 0;
+}
+
+
+//! Build the label for a named operational pattern, keeping the qualifiers of the current label of a generalized OP
+static ULPtr MakeOP(std::string Name, MetadataPtr HMeta)
+{
+	// Accept "OP1a" as well as "1a"
+	if((Name.size() > 2) && ((Name[0] == 'o') || (Name[0] == 'O')) && ((Name[1] == 'p') || (Name[1] == 'P'))) Name = Name.substr(2);
+
+	std::string::iterator it = Name.begin();
+	while(it != Name.end())
+	{
+		*it = tolower(*it);
+		it++;
+	}
+
+	const OPNameEntry *Entry = OPNames;
+	while(Entry->Name && (Name != Entry->Name)) Entry++;
+	if(!Entry->Name) return NULL;
+
+	ULPtr Ret = new UL(*Entry->Label);
+
+	// Generalized OP labels end with qualifiers describing the file, which are kept from the current label
+	MDObjectPtr CurrentOP = HMeta[OperationalPattern_UL];
+	if(CurrentOP && (Ret->GetValue()[12] <= 3))
+	{
+		DataChunkPtr Current = CurrentOP->PutData();
+		if((Current->Size == 16) && (Current->Data[12] >= 1) && (Current->Data[12] <= 3))
+		{
+			UInt8 Label[16];
+			memcpy(Label, Ret->GetValue(), 16);
+			Label[14] = Current->Data[14];
+			Ret = new UL(Label);
+		}
+	}
+
+	return Ret;
+}
+
+
+// Debug and error messages
+#include <stdarg.h>
+
+#ifdef MXFLIB_DEBUG
+//! Display a general debug message
+void mxflib::debug(const char *Fmt, ...)
+{
+	if(!DebugMode) return;
+
+	va_list args;
+
+	va_start(args, Fmt);
+	vprintf(Fmt, args);
+	va_end(args);
+}
+#endif // MXFLIB_DEBUG
+
+//! Display a warning message
+void mxflib::warning(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	printf("Warning: ");
+	vprintf(Fmt, args);
+	va_end(args);
+}
+
+//! Display an error message
+void mxflib::error(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	printf("ERROR: ");
+	vprintf(Fmt, args);
+	va_end(args);
+}
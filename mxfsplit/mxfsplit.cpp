@@ -63,6 +63,7 @@ namespace
 		UMIDPtr PackageID;
 		PackagePtr Package;
 		MDObjectPtr Descriptor;
+		UInt32 IndexSID;
 	};
 
 	//! Map of EssenceStreamInfo structures indexed by BodySID
@@ -124,6 +125,13 @@ static bool SplitParts = false;		// -p
 static bool FullIndex = false;		// -f dump full index
 static bool OPPercentage=false;
 static bool DumpExtraneous = false;		// -x dump extraneous body elements
+static bool MappedRead = false;		// -mm read the file via a memory mapping
+static size_t ReadAheadKB = 0;			// -ra read the file via a read-ahead buffer of this many KB
+static size_t ThreadedKB = 0;			// -t write each output file on its own thread, queueing up to this many KB
+static Length IndexInterval = -1;		// -ix build an index table in the footer, indexing every nth edit unit (0 = first in each partition)
+static bool ShowStats = false;			// -stats display library statistics after processing
+static std::string TraceFile;			// -trace write a timeline of library activity to this file
+static std::string DigestAlgorithm;		// -hd make a digest of each output stream with this algorithm
 #ifndef _WIN32
 #define MAX_PATH 1024
 #endif
@@ -134,6 +142,10 @@ static char OPdir[SZ_OP_DIR];
 static unsigned int firstFrame=0;
 static unsigned int nFrames=(unsigned int )-1;
 
+//! File offsets of the first edit unit to restore in each indexed stream, indexed by BodySID
+/*! Streams listed here are read from this offset rather than from the start of the file */
+static std::map<UInt32, Position> RangeStarts;
+
 static unsigned int SplitWaveChannels = 2;	// -w=n
 
 
@@ -146,7 +158,8 @@ static void DumpObject(MDObjectPtr Object, std::string Prefix);
 PartitionPtr FindLatestClosedPartitionHeaderMetadata( MXFFile* File );
 static void DumpHeader(PartitionPtr ThisPartition);
 static void DumpIndex(PartitionPtr ThisPartition);
-static void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup);
+static void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup, Position PartitionEnd = -1);
+static int BuildFooterIndex(const char *FileName, Length Interval);
 
 Position  MXFFileLen; //used to estimate %age done
 Uint64    DoneSoFar=0;
@@ -157,6 +170,9 @@ Uint64    DoneSoFar=0;
  */
 EssenceInfoPtr BuildEssenceInfo(MXFFilePtr &File);
 
+//! Use the index tables of a file to find where each stream's partial restore starts
+static void LocateRangeStarts(MXFFilePtr &File, EssenceInfoPtr &EssenceLookup);
+
 
 //! ListWriter - write to a sequential set of files
 class ListWriter : public ListOfFiles, public RefCount<ListWriter>
@@ -225,7 +241,8 @@ namespace mxflib
 
 	public:
 		//! Initialize this sink
-		PartialSink(EssenceSinkPtr TargetSink, Position StartPos, Length RangeLength) : Sink(TargetSink), Start(StartPos), Count(RangeLength), Pos(0)
+		/*! \param CurrentPos The position of the first edit unit that will be received, if edit units have been skipped */
+		PartialSink(EssenceSinkPtr TargetSink, Position StartPos, Length RangeLength, Position CurrentPos = 0) : Sink(TargetSink), Start(StartPos), Count(RangeLength), Pos(CurrentPos)
 		{
 		}
 
@@ -336,11 +353,162 @@ namespace mxflib
 	};
 
 
+	//! Class that passes data to another sink on a separate thread, so that slow writes don't hold up reading
+	/*! The data is copied into a bounded queue. If the queue is full PutEssenceData() waits for the worker thread to catch up.
+	 *  The target sink's EndOfData() is also called on the worker thread.
+	 *  \note Any partial or percentage filters should wrap this sink rather than be wrapped by it, as they are queried by the reading thread
+	 */
+	class ThreadedSink : public EssenceSink, protected Thread
+	{
+	private:
+		ThreadedSink();									//!< Prevent default construction
+
+	protected:
+		//! An item waiting to be written
+		struct QueueItem
+		{
+			DataChunkPtr Data;							//!< The data to write
+			bool EndOfItem;								//!< Flag to pass on with the data
+		};
+
+		EssenceSinkPtr Sink;							//!< The EssenceSink to receive the data
+		size_t MaxQueued;								//!< The maximum number of bytes to queue before waiting
+		size_t Queued;									//!< The number of bytes currently queued
+		std::list<QueueItem> Queue;						//!< Items waiting to be written, the head is the item being written
+		DataChunkList Free;								//!< Written buffers available for re-use
+		bool Stopping;									//!< Set once no more data will be queued
+		bool Failed;									//!< Set if the target sink has failed
+		bool EndResult;									//!< Result of the target sink's EndOfData()
+		bool EndCalled;									//!< True once EndOfData is called
+		Mutex Lock;										//!< Lock for all the above
+		Condition Changed;								//!< Signalled when the queue changes
+
+	public:
+		//! Initialize this sink and start the worker thread
+		ThreadedSink(EssenceSinkPtr TargetSink, size_t MaxQueued) 
+			: Sink(TargetSink), MaxQueued(MaxQueued), Queued(0), Stopping(false), Failed(false), EndResult(true), EndCalled(false)
+		{
+			if(!Start()) warning("Unable to start output thread - writing on the main thread instead\n");
+		}
+
+		//! Clean up
+		virtual ~ThreadedSink()
+		{
+			if(!EndCalled) EndOfData();
+		}
+
+		//! Receive the next "installment" of essence data
+		/*! This will receive a buffer containing the next bytes of essence data
+		 *  \param Buffer The data buffer
+		 *  \param BufferSize The number of bytes in the data buffer
+		 *  \param EndOfItem This buffer is the last in this wrapping item
+		 *  \return True if all is OK, else false
+		 *  \note As the data is written later a failure may not be reported until a later call, or by EndOfData()
+		 */
+		virtual bool PutEssenceData(UInt8 const *Buffer, size_t BufferSize, bool EndOfItem = true)
+		{
+			if(!IsRunning()) return Sink->PutEssenceData(Buffer, BufferSize, EndOfItem);
+
+			QueueItem Item;
+			Item.EndOfItem = EndOfItem;
+
+			{
+				MutexLock Locked(Lock);
+
+				// Wait for space in the queue, but always allow one item so that large items don't stall
+				while(!Failed && !Queue.empty() && ((Queued + BufferSize) > MaxQueued)) Changed.Wait(Lock);
+				if(Failed) return false;
+
+				if(!Free.empty())
+				{
+					Item.Data = Free.front();
+					Free.pop_front();
+				}
+			}
+
+			if(!Item.Data) Item.Data = new DataChunk;
+			Item.Data->Set(BufferSize, Buffer);
+
+			MutexLock Locked(Lock);
+			Queue.push_back(Item);
+			Queued += BufferSize;
+			Changed.Broadcast();
+
+			return true;
+		}
+
+		//! Wait for all the data queued so far to be written
+		void Sync(void)
+		{
+			MutexLock Locked(Lock);
+			while(!Queue.empty()) Changed.Wait(Lock);
+		}
+
+		//! Called once all data exhausted
+		/*! \return true if all is OK, else false
+		 *  \note This function must also be called from the derived class' destructor in case it is never explicitly called
+		 */
+		virtual bool EndOfData(void)
+		{
+			if(EndCalled) return EndResult && !Failed;
+			EndCalled = true;
+
+			if(!IsRunning()) return EndResult = Sink->EndOfData();
+
+			{
+				MutexLock Locked(Lock);
+				Stopping = true;
+				Changed.Broadcast();
+			}
+
+			Join();
+
+			return EndResult && !Failed;
+		}
+
+	protected:
+		//! Write queued data until stopped, then end the target sink
+		virtual void Run(void)
+		{
+			MutexLock Locked(Lock);
+
+			for(;;)
+			{
+				while(Queue.empty() && !Stopping) Changed.Wait(Lock);
+				if(Queue.empty()) break;
+
+				// The item stays at the head of the queue while it is written so that Sync() waits for it
+				QueueItem &Item = Queue.front();
+
+				Lock.Unlock();
+				bool Result = Failed || Sink->PutEssenceData(Item.Data->Data, Item.Data->Size, Item.EndOfItem);
+				Lock.Lock();
+
+				if(!Result) Failed = true;
+
+				Queued -= Item.Data->Size;
+				Free.push_back(Item.Data);
+				Queue.pop_front();
+				Changed.Broadcast();
+			}
+
+			Lock.Unlock();
+			bool Result = Sink->EndOfData();
+			Lock.Lock();
+
+			EndResult = Result;
+			Free.clear();
+		}
+	};
+
+
 	struct StreamFile
 	{
 		FileHandle file;
 		GCElementKind kind;
 		EssenceSinkPtr Sink;
+		ThreadedSink *Writer;							//!< The threaded part of Sink, if writing on a separate thread (owned by Sink)
+		EssenceDigestPtr Digest;						//!< Digest of the data written, or NULL if not digesting
 	};
 
 	typedef map<string, StreamFile> FileMap;
@@ -576,11 +744,20 @@ int main_process(int argc, char *argv[])
 				}
 			}
 			else if(Opt == 'f') FullIndex = true;
+			else if((Opt == 'i') && (tolower(*(p+1)) == 'x'))
+			{
+				char *Interval = p+2;
+				if((*Interval == '=') || (*Interval == ':')) Interval++;
+				IndexInterval = *Interval ? (Length)strtoul(Interval, NULL, 0) : 1;
+			}
 			else if(Opt == 'i')	SplitIndex = true;
 			else if(Opt == 'g')	SplitGC = true;
 			else if(Opt == 'p') SplitParts = true;
 			else if(Opt == 'a') DumpAllHeader = true;
+			else if((Opt == 'm') && (tolower(*(p+1)) == 'm')) MappedRead = true;
 			else if(Opt == 'm') SplitMono = true;
+			else if(0 == strncmp(p, "stats", 5)) ShowStats = true;
+			else if(0 == strncmp(p, "trace=", 6)) TraceFile = &p[6];
 			else if(Opt == 's') SplitStereo = true;
 			else if(Opt == '%') OPPercentage = true;
 			else if(Opt == 'd') 
@@ -614,6 +791,12 @@ int main_process(int argc, char *argv[])
 				}
 				num_options++;
 			}
+			else if((Opt == 'r') && (tolower(*(p+1)) == 'a'))
+			{
+				char *Size = p+2;
+				if((*Size == '=') || (*Size == ':')) Size++;
+				ReadAheadKB = *Size ? (size_t)strtoul(Size, NULL, 0) : 8192;
+			}
 			else if(Opt == 'r')
 			{
 				firstFrame=atoi( argv[i+1] );
@@ -625,7 +808,26 @@ int main_process(int argc, char *argv[])
 			{
 				PauseBeforeExit = true;
 			}
+			else if((Opt == 'h') && (tolower(*(p+1)) == 'd'))
+			{
+				char *Name = p+2;
+				if((*Name == '=') || (*Name == ':')) Name++;
+				DigestAlgorithm = *Name ? Name : "xxh64";
+
+				HashPtr Test = MakeDigestHash(DigestAlgorithm);
+				if(!Test)
+				{
+					error("Unknown digest algorithm \"%s\"\n", DigestAlgorithm.c_str());
+					return 1;
+				}
+			}
 			else if(Opt == 'x') DumpExtraneous = true;
+			else if(Opt == 't')
+			{
+				char *Size = p+1;
+				if((*Size == '=') || (*Size == ':')) Size++;
+				ThreadedKB = *Size ? (size_t)strtoul(Size, NULL, 0) : 16384;
+			}
 		}
 	}
 
@@ -645,7 +847,15 @@ int main_process(int argc, char *argv[])
 		//fprintf( stderr,"                       [-s] Subdivide AESBWF Elements into stereo wave files \n" );
 		//fprintf( stderr,"                       [-p] Split Partitions \n");
 		fprintf( stderr,"                       [-x] Dump Extraneous Body Elements \n" );
+		fprintf( stderr,"                      [-mm] Read the file via a memory mapping \n" );
+		fprintf( stderr,"                 [-ra[=kb]] Read the file via a read-ahead buffer (default 8192 KB) \n" );
 		fprintf( stderr,"                       [-r <first frame> <nframes> ] Output a region of the MXF file\n");
+		fprintf( stderr,"                  [-t[=kb]] Write each output file on its own thread, queueing up to kb (default 16384 KB) \n" );
+		fprintf( stderr,"                 [-ix[=n]] Build an index table in the footer of a file with no index, then exit\n" );
+		fprintf( stderr,"                                    (indexing every nth edit unit, or the first in each partition if n=0)\n");
+		fprintf( stderr,"                   [-stats] Display library statistics after processing\n");
+		fprintf( stderr,"            [-trace=<file>] Write a timeline of library activity to <file> in Chrome trace format\n");
+		fprintf( stderr,"                [-hd[=alg]] Make a digest of each stream written, using md5, sha1 or xxh64 (default xxh64)\n");
 		fprintf( stderr,"                       [-z] Pause for input before final exit\n");
 		fprintf( stderr,"             [-dd=filename] Use DM dictionary \n" );
 
@@ -660,12 +870,18 @@ int main_process(int argc, char *argv[])
 		dd_it++;
 	}
 
+	if(IndexInterval >= 0) return BuildFooterIndex(argv[num_options+1], IndexInterval);
+
+	if(ShowStats && !EnableStats()) warning("Library statistics are not available in this build\n");
+	if(TraceFile.size() && !StartTrace(TraceFile)) warning("Unable to start a trace to \"%s\"\n", TraceFile.c_str());
+
 	MXFFilePtr TestFile = new MXFFile;
-	if (! TestFile->Open(argv[num_options+1], true))
+	if (! (MappedRead ? TestFile->OpenMapped(argv[num_options+1]) : TestFile->Open(argv[num_options+1], true)))
 	{
 		perror(argv[num_options+1]);
 		return 1;
 	}
+	if(ReadAheadKB) TestFile->SetReadAhead(ReadAheadKB * 1024);
 	TestFile->SeekEnd();
 	MXFFileLen=TestFile->Tell();
 	TestFile->Seek(0);
@@ -675,6 +891,9 @@ int main_process(int argc, char *argv[])
 	// If we don't already have one, get a RIP (however possible)
 	if(TestFile->FileRIP.empty()) TestFile->GetRIP();
 
+	// Jump straight to the start of a partial restore in any indexed streams
+	if((nFrames != (unsigned int)-1) && (firstFrame > 0) && EssenceLookup) LocateRangeStarts(TestFile, EssenceLookup);
+
 	// Iterate over Partitions
 	RIP::iterator it = TestFile->FileRIP.begin();
 	UInt32 iPart = 0;
@@ -687,6 +906,14 @@ int main_process(int argc, char *argv[])
 		                       Int64toHexString((*it).second->ByteOffset,8).c_str(),
 													 (*it).second->BodySID );
 
+		// Start a new partition in the digest of each stream
+		FileMap::iterator itDigest = theStreams.begin();
+		while(itDigest != theStreams.end())
+		{
+			if((*itDigest).second.Digest) (*itDigest).second.Digest->StartPartition((*it).second->ByteOffset);
+			itDigest++;
+		}
+
 		TestFile->Seek((*it).second->ByteOffset);
 		PartitionPtr ThisPartition = TestFile->ReadPartition();
 		if(ThisPartition)
@@ -709,7 +936,9 @@ int main_process(int argc, char *argv[])
 			}
 			
 			// Body Elements
-			DumpBody( ThisPartition, EssenceLookup );
+			RIP::iterator Next = it;
+			Next++;
+			DumpBody( ThisPartition, EssenceLookup, (Next == TestFile->FileRIP.end()) ? MXFFileLen : (*Next).second->ByteOffset );
 		}
 		it++;
 	} // while(it != TestFile->FileRIP.end())
@@ -726,16 +955,39 @@ int main_process(int argc, char *argv[])
 				UpdateWaveLengths((*itFile).second.file);
 			}
 */
+			// Make sure that all data has been written before we check the size
+			if((*itFile).second.Writer) (*itFile).second.Writer->Sync();
+
 			if( !Quiet ) printf( "Closing %s, size 0x%s\n", (*itFile).first.c_str(), Int64toHexString(FileTell( (*itFile).second.file )).c_str() );
 
 			if((*itFile).second.Sink) (*itFile).second.Sink->EndOfData();
 			FileClose( (*itFile).second.file );
 
+			EssenceDigestPtr &Digest = (*itFile).second.Digest;
+			if(Digest)
+			{
+				printf( "%s digest of %s: %s (0x%s bytes)\n", Digest->GetAlgorithm().c_str(), (*itFile).first.c_str(),
+						DigestToString(Digest->GetDigest()).c_str(), Int64toHexString(Digest->GetSize()).c_str() );
+
+				EssenceDigest::PartitionDigestList &Partitions = Digest->GetPartitionDigests();
+				EssenceDigest::PartitionDigestList::iterator itPart = Partitions.begin();
+				while(itPart != Partitions.end())
+				{
+					printf( "  Partition at 0x%s: %s (0x%s bytes)\n", Int64toHexString((*itPart).Partition, 8).c_str(),
+							DigestToString((*itPart).Digest).c_str(), Int64toHexString((*itPart).Size).c_str() );
+					itPart++;
+				}
+			}
+
 			itFile++;
 		}
 	}
 	theStreams.clear();
 
+	if(StatsEnabled()) printf("\nLibrary statistics:\n%s", GetStatsReport().c_str());
+
+	StopTrace();
+
 	return 0;
 }
 
@@ -902,9 +1154,12 @@ void DumpHeader( PartitionPtr ThisPartition )
 // FIXME not yet changed into xml-style output
 void DumpIndex( PartitionPtr ThisPartition )
 {
-	// Read any index table segments!
-	MDObjectListPtr Segments = ThisPartition->ReadIndex();
-	if(Segments->empty())
+	// Read any index table segments, parsing them directly from the raw index bytes
+	IndexTablePtr Table = new IndexTable;
+	IndexSegmentInfoList Segments;
+	ThisPartition->ReadIndex(Table, &Segments);
+
+	if(Segments.empty())
 	{
 		if( !Quiet ) printf("No Index Table in this Partition\n\n");
 	}
@@ -912,29 +1167,20 @@ void DumpIndex( PartitionPtr ThisPartition )
 	{
 		printf( "\nIndexTable:\n" );
 
-		IndexTablePtr Table = new IndexTable;
+		IndexSegmentInfoList::iterator it = Segments.begin();
 
-		MDObjectList::iterator it = Segments->begin();
-
-		while(it != Segments->end())
+		while(it != Segments.end())
 		{
-			Table->AddSegment(*it);
-		
-			// Demonstrate this new segment
+			// Demonstrate this segment
 			
-			UInt32 Streams = 1;
-			MDObjectPtr DeltaEntryArray = (*it)[DeltaEntryArray_UL];
-			if(DeltaEntryArray && DeltaEntryArray->GetType()->size())
-			{
-				Streams = static_cast<Uint32>(DeltaEntryArray->size() / DeltaEntryArray->GetType()->size());
-				if(Streams == 0) Streams = 1;	// Fix for bad DeltaEntryArray
-			}
+			UInt32 Streams = (*it).DeltaCount;
+			if(Streams == 0) Streams = 1;
 
-			Position Start = (*it)->GetInt64(IndexStartPosition_UL);
-			Length Duration = (*it)->GetInt64(IndexDuration_UL);
+			Position Start = (*it).StartPosition;
+			Length Duration = (*it).Duration;
 			
-			UInt32 IndexSID = (*it)->GetUInt(IndexSID_UL);
-			UInt32 BodySID = (*it)->GetUInt(BodySID_UL);
+			UInt32 IndexSID = (*it).IndexSID;
+			UInt32 BodySID = (*it).BodySID;
 			
 			if(Duration == 0) printf("CBR Index Table Segment (covering whole Essence Container) :\n");
 			else printf("\nIndex Table Segment (first edit unit = %s, duration = %s) :\n", Int64toString(Start).c_str(), Int64toString(Duration).c_str());
@@ -1218,6 +1464,8 @@ EssenceInfoPtr BuildEssenceInfo(MXFFilePtr &File)
 			EssenceStreamInfo NewEI;
 			NewEI.PackageID = new UMID(PackageID->PutData()->Data);
 
+			NewEI.IndexSID = ThisECDSet->GetUInt(IndexSID_UL);
+
 			// Insert the basic essence info - but not if this is external essence (BodySID == 0)
 			UInt32 BodySID = ThisECDSet->GetUInt(BodySID_UL);
 			if(BodySID) Ret->Lookup[BodySID] = NewEI;
@@ -1269,16 +1517,217 @@ EssenceInfoPtr BuildEssenceInfo(MXFFilePtr &File)
 }
 
 
+//! Build an index table for a file written without one, and add it to the footer partition
+/*! Only the partition packs and the keys and lengths of the body KLVs are read. The footer is updated in place,
+ *  leaving its header metadata untouched, and the RIP is rewritten after the new index table.
+ *  \return The exit code for the program
+ *  \note If the EssenceContainerData set in the header metadata has no IndexSID it is not updated with the one chosen
+ */
+int BuildFooterIndex(const char *FileName, Length Interval)
+{
+	MXFFilePtr File = new MXFFile;
+	if(!File->Open(FileName, false))
+	{
+		perror(FileName);
+		return 1;
+	}
+
+	EssenceInfoPtr EssenceLookup = BuildEssenceInfo(File);
+	if((!EssenceLookup) || EssenceLookup->Lookup.empty())
+	{
+		error("No essence streams found in file %s\n", FileName);
+		return 1;
+	}
+
+	if(File->FileRIP.empty()) File->GetRIP();
+
+	// DRAGONS: Byte 14 of a partition pack key is 0x04 for all kinds of footer
+	PartitionPtr Footer = File->ReadFooterPartition();
+	if((!Footer) || (Footer->Object->GetUL()->GetValue()[13] != 0x04))
+	{
+		error("File %s does not have a footer partition\n", FileName);
+		return 1;
+	}
+
+	if(Footer->GetUInt(IndexSID_UL) != 0)
+	{
+		error("File %s already has an index table in its footer partition\n", FileName);
+		return 1;
+	}
+
+	// Index the first stream, using the IndexSID given in the header metadata if there is one, or one not used by any stream if not
+	EssenceStreamInfoMap::iterator it = EssenceLookup->Lookup.begin();
+	UInt32 BodySID = (*it).first;
+	if(EssenceLookup->Lookup.size() > 1) warning("File %s contains more than one essence stream, only BodySID 0x%04x will be indexed\n", FileName, BodySID);
+
+	UInt32 IndexSID = (*it).second.IndexSID;
+	if(IndexSID == 0)
+	{
+		RIP::iterator RIP_it = File->FileRIP.begin();
+		while(RIP_it != File->FileRIP.end())
+		{
+			File->Seek((*RIP_it).second->ByteOffset);
+			PartitionPtr ThisPartition = File->ReadPartition();
+			if(ThisPartition)
+			{
+				if(ThisPartition->GetUInt(BodySID_UL) > IndexSID) IndexSID = ThisPartition->GetUInt(BodySID_UL);
+				if(ThisPartition->GetUInt(IndexSID_UL) > IndexSID) IndexSID = ThisPartition->GetUInt(IndexSID_UL);
+			}
+			RIP_it++;
+		}
+		IndexSID++;
+	}
+
+	Rational EditRate(0, 1);
+	MDObjectPtr Descriptor = (*it).second.Descriptor;
+	MDObjectPtr SampleRate;
+	if(Descriptor) SampleRate = Descriptor[SampleRate_UL];
+	if(SampleRate)
+	{
+		EditRate.Numerator = SampleRate->GetInt("Numerator");
+		EditRate.Denominator = SampleRate->GetInt("Denominator");
+	}
+
+	IndexScannerPtr Scanner = new IndexScanner(File);
+	Scanner->SetInterval(Interval);
+	IndexTablePtr Table = Scanner->Scan(BodySID, IndexSID, EditRate);
+	if(!Table) return 1;
+
+	DataChunk IndexData;
+	Table->WriteIndex(IndexData);
+
+	// Locate the end of the header metadata in the footer, after the partition pack and any filler that follows it
+	Position FooterPos = Footer->Object->GetLocation();
+	File->Seek(FooterPos + 16);
+	Length PackLength = File->ReadBER();
+	Position PackEnd = File->Tell() + PackLength;
+
+	Position MetadataStart = PackEnd;
+	ULPtr Key = File->ReadKey();
+	if(Key && Key->Matches(KLVFill_UL))
+	{
+		Length FillLength = File->ReadBER();
+		MetadataStart = File->Tell() + FillLength;
+	}
+
+	Position IndexStart = MetadataStart + Footer->GetInt64(HeaderByteCount_UL);
+
+	// The new footer must not end before the old one, as the RIP has to be at the very end of the file, so pad the index if required
+	File->SeekEnd();
+	Position OldEnd = File->Tell();
+	Length RIPSize = 16 + 4 + (static_cast<Length>(File->FileRIP.size()) * 12) + 4;
+	Length Shortfall = OldEnd - (IndexStart + static_cast<Length>(IndexData.Size) + RIPSize);
+	Length FillSize = 0;
+	if(Shortfall > 0) FillSize = (Shortfall < 20) ? 20 : Shortfall;
+
+	Footer->SetUInt(IndexSID_UL, IndexSID);
+	Footer->SetUInt64(IndexByteCount_UL, static_cast<UInt64>(IndexData.Size + FillSize));
+
+	File->Seek(FooterPos);
+	File->WritePartitionPack(Footer);
+	if(File->Tell() != PackEnd)
+	{
+		error("Footer partition pack in file %s changed size when updated - the file is now damaged\n", FileName);
+		return 1;
+	}
+
+	File->Seek(IndexStart);
+	File->Write(IndexData);
+
+	if(FillSize)
+	{
+		File->Write(KLVFill_UL.GetValue(), 16);
+		File->Write(*MakeBER(FillSize - 20, 4));
+
+		if(FillSize > 20)
+		{
+			DataChunk Fill(static_cast<size_t>(FillSize - 20));
+			memset(Fill.Data, 0, Fill.Size);
+			File->Write(Fill);
+		}
+	}
+
+	File->WriteRIP();
+	File->Close();
+
+	if(!Quiet) printf("Indexed %s edit units of BodySID 0x%04x in footer as IndexSID 0x%04x\n", Int64toString(Scanner->GetEditUnitCount()).c_str(), BodySID, IndexSID);
+
+	return 0;
+}
+
+
+//! Use the index tables of a file to find where each stream's partial restore starts
+/*! The first edit unit to restore (in stored order) is looked up in the index table for each stream, and the file
+ *  offset of its content package is recorded in RangeStarts. Streams without a usable index are read from the start.
+ *  \note Only the partition packs and index table segments are read, so this takes the same time wherever the range is
+ */
+void LocateRangeStarts(MXFFilePtr &File, EssenceInfoPtr &EssenceLookup)
+{
+	// We use a body reader to convert stream offsets to file offsets
+	BodyReaderPtr Reader = new BodyReader(File);
+
+	EssenceStreamInfoMap::iterator it = EssenceLookup->Lookup.begin();
+	while(it != EssenceLookup->Lookup.end())
+	{
+		UInt32 BodySID = (*it).first;
+		UInt32 IndexSID = (*it).second.IndexSID;
+		it++;
+
+		if(!IndexSID) continue;
+
+		// Gather all segments of the index table for this stream
+		IndexTablePtr Index = new IndexTable;
+		RIP::iterator Part_it = File->FileRIP.begin();
+		while(Part_it != File->FileRIP.end())
+		{
+			File->Seek((*Part_it).second->ByteOffset);
+			PartitionPtr ThisPartition = File->ReadPartition();
+			if(ThisPartition && (ThisPartition->GetUInt(IndexSID_UL) == IndexSID)) ThisPartition->ReadIndex(Index);
+
+			Part_it++;
+		}
+
+		// DRAGONS: The range is counted in stored order, as it is by PartialSink, so we don't reorder
+		IndexPos Result;
+		Index->Lookup(static_cast<Position>(firstFrame), Result, 0, false);
+		if((!Result.Exact) || (Result.Location < 0)) continue;
+
+		// A range that starts beyond the end of the stream is left to the normal read to find nothing
+		if(!File->FileRIP.FindPartition(BodySID, Result.Location)) continue;
+
+		Position FilePos = Reader->Seek(BodySID, Result.Location);
+		if(FilePos < 0) continue;
+
+		// Only use this location if it is the start of a GC KLV, which is not the case for clip-wrapped essence
+		File->Seek(FilePos);
+		ULPtr Key = File->ReadKey();
+		if((!Key) || !(GetGCElementKind(Key).IsValid || IsGCSystemItem(Key))) continue;
+
+		if(!Quiet) printf("Partial restore of BodySID 0x%04x starts at 0x%s\n", BodySID, Int64toHexString(FilePos, 8).c_str());
 
-void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup)
+		RangeStarts[BodySID] = FilePos;
+	}
+}
+
+
+void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup, Position PartitionEnd /*=-1*/)
 {
 
 	UInt32 BodySID = ThisPartition->GetUInt( BodySID_UL );
 
+	// Locate the start of any partial restore for this stream
+	Position RangeStart = -1;
+	std::map<UInt32, Position>::iterator Range_it = RangeStarts.find(BodySID);
+	if(Range_it != RangeStarts.end()) RangeStart = (*Range_it).second;
+
 	if( 0==BodySID )
 	{
 		if( !Quiet ) printf( "No Body in this Partition\n\n" );
 	}
+	else if((RangeStart >= 0) && (PartitionEnd >= 0) && (RangeStart >= PartitionEnd))
+	{
+		if( !Quiet ) printf( "Skipping elements for BodySID 0x%04x before the partial restore\n", BodySID );
+	}
 	else
 	{
 		if( !Quiet ) printf( "Elements for BodySID 0x%04x\n", BodySID );
@@ -1290,7 +1739,12 @@ void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup)
 		int limit=0;
 
 		KLVObjectPtr anElement;
-		ThisPartition->StartElements();
+		if(RangeStart > ThisPartition->Object->GetLocation())
+		{
+			// DRAGONS: Earlier partitions were skipped above, so the range starts in this partition
+			ThisPartition->StartElementsAt(RangeStart);
+		}
+		else ThisPartition->StartElements();
 		while( anElement = ThisPartition->NextElement() )
 		{
 			EssenceSinkPtr ThisSink;
@@ -1528,10 +1982,29 @@ void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup)
 							}
 						}
 
+						/* Write on a separate thread if required (before adding filters, which are queried by this thread) */
+						ThreadedSink *Writer = NULL;
+						if(ThreadedKB && ThisSink && !DivideFiles)
+						{
+							Writer = new ThreadedSink(ThisSink, ThreadedKB * 1024);
+							ThisSink = Writer;
+						}
+
+						/* Digest the data written if required (on this thread, so partitions can be marked as they are read) */
+						EssenceDigestPtr Digest;
+						if(DigestAlgorithm.size() && ThisSink && !DivideFiles)
+						{
+							Digest = new EssenceDigest(DigestAlgorithm);
+							Digest->StartPartition(ThisPartition->Object->GetLocation());
+							ThisSink = new DigestSink(ThisSink, Digest);
+						}
+
 						/* Add partial filter if required */
 						if(nFrames != -1)
 						{
-							ThisSink = new PartialSink(ThisSink, firstFrame, nFrames);
+							// Streams read from the start of the range have skipped the edit units before it
+							Position SkippedFrames = (RangeStart >= 0) ? static_cast<Position>(firstFrame) : 0;
+							ThisSink = new PartialSink(ThisSink, firstFrame, nFrames, SkippedFrames);
 						}
 
 						/* Add percentage filter if required */
@@ -1546,6 +2019,8 @@ void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup)
 							sf.file = ThisFile; 
 							sf.kind = kind;
 							sf.Sink = ThisSink;
+							sf.Writer = Writer;
+							sf.Digest = Digest;
 							theStreams.insert( FileMap::value_type(filename, sf) );
 						}
 					}
@@ -1566,23 +2041,18 @@ void DumpBody(PartitionPtr ThisPartition, EssenceInfoPtr &EssenceLookup)
 				/* Copy the essence KLV to the output file in manageable chunks */
 	
 				// Limit chunk size to 32Mb
-				const Length MaxSize = 32 * 1024 * 1024;
-
-				Position Offset = 0;
-				for(;;)
+				const size_t MaxSize = 32 * 1024 * 1024;
+
+				// DRAGONS: NextElement() seeks to each KLV, so positional reads are safe here and allow the next chunk
+				//          to be read while this one is written. The sinks don't modify the data, so a mapped file
+				//          supplies views of each chunk and avoids copying
+				anElement->SetPositionalRead();
+				KLVCursor Cursor(anElement, MaxSize, true);
+				while(Cursor.Next())
 				{
-					// Work out the chunk-size
-					Length CurrentSize = anElement->GetLength() - (Length)Offset;
-					if(CurrentSize <= 0) break;
-					if(CurrentSize > MaxSize) CurrentSize = MaxSize;
-
-					size_t Bytes = anElement->ReadDataFrom(Offset, static_cast<size_t>(CurrentSize));
-					if(!Bytes) break;
-					Offset += Bytes;
-
-					//if(FileValid(ThisFile)) FileWrite(ThisFile, anElement->GetData().Data, anElement->GetData().Size);
+					//if(FileValid(ThisFile)) FileWrite(ThisFile, Cursor.GetData().Data, Cursor.GetData().Size);
 					// FIXME: Need to add end-of-element
-					if(ThisSink) ThisSink->PutEssenceData(anElement->GetData());
+					if(ThisSink) ThisSink->PutEssenceData(Cursor.GetData());
 				}
 
 				// If we are dividing into multiple files then we are done with this one
@@ -86,6 +86,12 @@ void mxflib::error(const char *Fmt, ...)
 //! Choose the best wrapping option for a given input file
 EssenceParser::WrappingConfigPtr ChooseWrapping(FileParserPtr &FParser, ProcessOptions &Opt);
 
+//! Apply the settings of a layout plan that have not been given on the command line
+void ApplyLayoutPlan(ProcessOptions &Opt, const LayoutPlan &Plan);
+
+//! Report how well a finished output file lines up with the storage it is to be read from
+void ReportLayout(ProcessOptions &Opt, int OutFileNum);
+
 // OP Qualifier manipulators: ClearStream, SetStream, SetUniTrack, SetMultiTrack
 void ClearStream(UL &theUL);
 void SetStream(UL &theUL);
@@ -167,6 +173,17 @@ int main_process(int argc, char *argv[])
 
 	DebugMode = Opt.DebugMode;
 
+	if(Opt.ShowStats && !EnableStats()) warning("Library statistics are not available in this build\n");
+	if(Opt.TraceFile.size() && !StartTrace(Opt.TraceFile)) warning("Unable to start a trace to \"%s\"\n", Opt.TraceFile.c_str());
+
+	// The KAG must be planned before the wrapping options are chosen, partitions are planned again once the edit rate is known
+	if(Opt.Storage.IsSet()) ApplyLayoutPlan(Opt, PlanLayout(Opt.Storage, 0, Rational()));
+
+	// Re-use essence buffers rather than allocating new ones for each frame
+	// DRAGONS: The pool is never deleted as static DataChunks may be freed after main returns
+	BufferPool *Pool = new BufferPool;
+	DataChunk::SetAllocator(Pool);
+
 	// Enable FastClipWrap mode - don't do this if random access not available of the output medium
 	SetFastClipWrap(true);
 
@@ -221,6 +238,10 @@ int main_process(int argc, char *argv[])
 	// Audio Demuxers
 	AudioDemuxPtr AudioDemuxer[ProcessOptions::MaxInFiles];
 
+	// The parser used by each source, as sources sharing a parser must not be read at the same time by concurrent outputs
+	int InReadGroup[ProcessOptions::MaxInFiles];
+	int ParserCount = 0;
+
 
 	// Identify the wrapping options
 	// DRAGONS: Not flexible yet
@@ -232,6 +253,10 @@ int main_process(int argc, char *argv[])
 	for(i=0; i< InCount; i++)
 	{
 		FileParserPtr FParser = new FileParser(Opt.InFilename[i]);
+		int ParserGroup = ParserCount++;
+
+		// Open the files of a list in advance if requested
+		if(Opt.LookaheadFiles && FParser->IsFileList()) FParser->SetLookahead(Opt.LookaheadFiles);
 
 		// Wrapping config to use
 		EssenceParser::WrappingConfigPtr WCP = ChooseWrapping(FParser, Opt);
@@ -341,6 +366,7 @@ int main_process(int argc, char *argv[])
 						// Increase the apparent number of input files as it now looks like one file per demux-source
 						InFileSource[OutNum].first = iFilePackage;
 						InFileSource[OutNum].second = AudioDemuxer[DemuxIndex]->GetSource(j, ChanCount);
+						InReadGroup[OutNum] = ParserGroup;
 						OutNum++;
 						Opt.InFileGangSize++;
 			
@@ -397,6 +423,7 @@ int main_process(int argc, char *argv[])
 						else
 						{
 							ThisFParser = new FileParser(Opt.InFilename[i]);
+							if(Opt.LookaheadFiles && ThisFParser->IsFileList()) ThisFParser->SetLookahead(Opt.LookaheadFiles);
 							WrapCfg = ChooseWrapping(ThisFParser, Opt);
 
 							// Set the wrapping options
@@ -419,6 +446,7 @@ int main_process(int argc, char *argv[])
 						// Increase the apparent number of input files as it now looks like one file per demux-source
 						InFileSource[OutNum].first = iFilePackage;
 						InFileSource[OutNum].second = AudioDemuxer[OutNum]->GetSource(j, ChanCount);
+						InReadGroup[OutNum] = (j == 0) ? ParserGroup : ParserCount++;
 						OutNum++;
 						Opt.InFileGangSize++;
 
@@ -442,6 +470,7 @@ int main_process(int argc, char *argv[])
 			// Record the essence source for this source file or files
 			InFileSource[OutNum].first = iFilePackage;
 			InFileSource[OutNum].second = FParser->GetEssenceSource(WCP->Stream);
+			InReadGroup[OutNum] = ParserGroup;
 			OutNum++;
 
 			// Inform the user of the chosen wrapping
@@ -458,6 +487,7 @@ int main_process(int argc, char *argv[])
 					// Add this sub-stream
 					InFileSource[OutNum].first = iFilePackage;
 					InFileSource[OutNum].second = (FParser->GetSubSource((*subit)->Stream));
+					InReadGroup[OutNum] = ParserGroup;
 					OutNum++;
 					Opt.InFileGangSize++;
 
@@ -523,6 +553,15 @@ int main_process(int argc, char *argv[])
 		}
 	}
 
+	// Complete the layout plan now that the edit rate is known
+	if(Opt.Storage.IsSet())
+	{
+		LayoutPlan Plan = PlanLayout(Opt.Storage, 0, EditRate);
+		ApplyLayoutPlan(Opt, Plan);
+
+		printf("\nLayout planned for storage profile:\n%s", Plan.GetDescription().c_str());
+	}
+
 	// Generate a UMID for the Material Package
 	UMIDPtr MPUMID = MakeUMID( 0x0d ); // mixed type
 
@@ -530,8 +569,49 @@ int main_process(int argc, char *argv[])
 	// DRAGONS: there is only ONE which is used by all files in an OP-Atom set
 	// FIXME: if we ever start building multiple nonOP-Atom files at one time, need to modify the UMID each time
 
+	// Digest the essence of each track as it is written, if requested
+	int TrackCount = static_cast<int>(WrappingList.size());
+	if(Opt.DigestAlgorithm.size())
+	{
+		for(i = 0; i < TrackCount; i++)
+		{
+			if(InFileSource[i].second) InFileSource[i].second->SetDigest(new EssenceDigest(Opt.DigestAlgorithm));
+		}
+	}
+
 	int OutFileNum;
-	for(OutFileNum=0; OutFileNum < Opt.OutFileCount ; OutFileNum++)
+	if(Opt.ConcurrentOutputs && (Opt.OutFileCount > 1))
+	{
+		// Open all the output files
+		MXFFilePtr Out[ProcessOptions::MaxOutFiles];
+		for(OutFileNum=0; OutFileNum < Opt.OutFileCount ; OutFileNum++)
+		{
+			Out[OutFileNum] = new MXFFile;
+			if(!Out[OutFileNum]->OpenNew(Opt.OutFilename[OutFileNum]))
+			{
+				error("Can't open output file \"%s\"\n", Opt.OutFilename[OutFileNum]);
+				return 5;
+			}
+		}
+
+		printf( "\nProcessing %d output files at once\n", Opt.OutFileCount);
+
+		if(InitialFile.size()) printf("    Essence File: %s\n", InitialFile.c_str());
+
+		Length Duration[ProcessOptions::MaxOutFiles];
+		ProcessConcurrent(Out, &Opt, WrappingList, InFileSource, EditRate, MPUMID, FPUMID, NULL, Duration, InReadGroup);
+
+		for(OutFileNum=0; OutFileNum < Opt.OutFileCount ; OutFileNum++)
+		{
+			printf( "Duration of \"%s\" = %s edit units\n", Opt.OutFilename[OutFileNum], Int64toString( Duration[OutFileNum] ).c_str() );
+
+			// Close the file - all done!
+			Out[OutFileNum]->Close();
+
+			ReportLayout(Opt, OutFileNum);
+		}
+	}
+	else for(OutFileNum=0; OutFileNum < Opt.OutFileCount ; OutFileNum++)
 	{
 		// Open the output file
 		MXFFilePtr Out = new MXFFile;
@@ -562,9 +642,40 @@ int main_process(int argc, char *argv[])
 		// Close the file - all done!
 		Out->Close();
 
+		ReportLayout(Opt, OutFileNum);
+	}
+
+	// Report the digest of each track, and of its essence in each partition
+	for(i = 0; i < TrackCount; i++)
+	{
+		EssenceDigestPtr Digest = InFileSource[i].second ? InFileSource[i].second->GetDigest() : NULL;
+		if(!Digest) continue;
+
+		printf("\nTrack %d %s digest: %s (0x%s bytes)\n", i + 1, Digest->GetAlgorithm().c_str(), DigestToString(Digest->GetDigest()).c_str(),
+			   Int64toHexString(Digest->GetSize()).c_str());
 
+		EssenceDigest::PartitionDigestList &Partitions = Digest->GetPartitionDigests();
+		EssenceDigest::PartitionDigestList::iterator it = Partitions.begin();
+		while(it != Partitions.end())
+		{
+			printf("  Partition at 0x%s: %s (0x%s bytes)\n", Int64toHexString((*it).Partition, 8).c_str(), DigestToString((*it).Digest).c_str(),
+				   Int64toHexString((*it).Size).c_str());
+			it++;
+		}
 	}
 
+	if(DebugMode)
+	{
+		BufferPoolStats Stats = Pool->GetStats();
+		debug("Buffer pool: %s allocations, %s re-used, %s frees, %s pooled, %s bytes held\n",
+			  UInt64toString(Stats.Allocations).c_str(), UInt64toString(Stats.Hits).c_str(), UInt64toString(Stats.Frees).c_str(),
+			  UInt64toString(Stats.Pooled).c_str(), UInt64toString(Stats.HeldBytes).c_str());
+	}
+
+	if(StatsEnabled()) printf("\nLibrary statistics:\n%s", GetStatsReport().c_str());
+
+	StopTrace();
+
 	printf("\nDone\n");
 
 	return 0;
@@ -746,3 +857,53 @@ EssenceParser::WrappingConfigPtr ChooseWrapping(FileParserPtr &FParser, ProcessO
 	return WCP;
 }
 
+
+//! Report how well a finished output file lines up with the storage it is to be read from
+void ReportLayout(ProcessOptions &Opt, int OutFileNum)
+{
+	if(!Opt.Storage.IsSet()) return;
+
+	MXFFilePtr Check = new MXFFile;
+	LayoutStats Stats;
+	if(Check->Open(Opt.OutFilename[OutFileNum], true) && MeasureLayout(Check, Opt.Storage, Stats))
+	{
+		printf("\nLayout statistics:\n%s", Stats.GetReport().c_str());
+	}
+	Check->Close();
+}
+
+
+//! Apply the settings of a layout plan that have not been given on the command line
+void ApplyLayoutPlan(ProcessOptions &Opt, const LayoutPlan &Plan)
+{
+	if(Opt.KAGSize == 1) Opt.KAGSize = Plan.KAGSize;
+
+	if(Plan.BlockAlign && !Opt.BlockSize) Opt.BlockSize = Plan.BlockAlign;
+
+	// Body partitions are forbidden in OP-Atom, which also has its own mandatory index table
+	if(Opt.OPAtom) return;
+
+	if(Opt.BodyMode == Body_None)
+	{
+		if(Plan.PartitionSize)
+		{
+			Opt.BodyMode = Body_Size;
+			Opt.BodyRate = static_cast<UInt32>(Plan.PartitionSize);
+		}
+		else if(Plan.PartitionDuration)
+		{
+			Opt.BodyMode = Body_Duration;
+			Opt.BodyRate = static_cast<UInt32>(Plan.PartitionDuration);
+		}
+	}
+
+	if(!(Opt.UseIndex || Opt.SparseIndex || Opt.SprinkledIndex))
+	{
+		if(Plan.SprinkledIndex)
+		{
+			Opt.SprinkledIndex = true;
+			Opt.IsolatedIndex = Plan.IsolatedIndex;
+		}
+		else Opt.UseIndex = true;
+	}
+}
@@ -150,20 +150,36 @@ void HelpText()
 		printf("    -n         = Use negative indexing during pre-charge (aligns 0 with start)\n");
 		printf("    -f         = Frame-wrap and group in one container\n");
 		printf("    -f0        = Frame-wrap and group in one container, padding streams that end early\n");
+		printf("    -hd[=<alg>]= Make a digest of each track's essence while writing, using md5, sha1 or xxh64 (default xxh64)\n");
 		printf("    -hp=<size> = Leave at least <size> bytes of expansion space in the header (-h deprecated)\n");
+		printf("    -hr[=<pc>] = Leave expansion space in the header of <pc>%% of its metadata (default 10)\n");
 		printf("    -hs=<size> = Make the header at least <size> bytes\n");
 		printf("    -i         = Write index tables (at the end of the file)\n");
 		printf("    -ip        = Write sparse index tables with one entry per partition\n");
 		printf("    -is        = Write index tables sprinkled one section per partition\n");
+		printf("    -ib        = As -is, but free index entries once written to bound memory use\n");
 		printf("    -ii        = Isolated index tables (don't share partition with essence)\n");
 		printf("    -ii2       = Isolated index tables (don't share with essence or metadata)\n");
 		printf("    -ka=<size> = Set KAG size (default=1) (-k deprecated)\n");
+		printf("    -oa=<dur>  = Preallocate disk space for about <dur> frames of CBR essence\n");
+		printf("    -od[=<kb>] = Write output with direct I/O, bypassing the file cache, using a <kb>KB buffer (default 4096)\n");
+		printf("                 (use a KAG of 4096 or more to keep partitions aligned)\n");
+		printf("    -ol[=<n>]  = Open the next <n> files of a file list on background threads (default 8)\n");
+		printf("    -om        = Write all output files (such as each OP-Atom track) at once on their own threads, reading the essence only once\n");
+		printf("    -or[=<n>]  = Read essence ahead on a background thread, queuing <n> frames per stream (default 8)\n");
+		printf("    -ow[=<kb>] = Write output on a background thread using <kb>KB buffers (default 4096)\n");
 		printf("    -pd=<dur>  = Body partition every <dur> frames\n");
 		printf("    -ps=<size> = Body partition roughly every <size> bytes\n");
 		printf("                 (early rather than late)\n");
 		printf("    -fr=<n>/<d>= Force edit rate (if possible) (-r deprecated, but allowed for legacy\n");
 		printf("    -s         = Interleave essence containers for streaming\n");
+		printf("    -sp=<stripe>[:<part>[:<read>]]\n");
+		printf("               = Plan the KAG, partitions and index for storage with the given stripe size,\n");
+		printf("                 object part size and read size in bytes, and report the alignment achieved\n");
+		printf("    -stats     = Display library statistics (I/O, KLVs, allocations etc.) after processing\n");
 		printf("    -kxs       = Use 377-2 KLV Extension Syntax (KXS) including only extensions beyond the baseline\n");
+		printf("    -trace=<file>\n");
+		printf("               = Write a timeline of library activity to <file> in Chrome trace format\n");
 		printf("    -u         = Update the header after writing footer\n");
 		printf("    -v         = Verbose mode\n");
 		printf("    -w         = List available wrapping options (does not build a file)\n");
@@ -250,12 +266,62 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 				}
 				else error("Unknown body partition mode '%c'\n", p[1]);
 			}
+			else if((Opt == 'o') && (tolower(p[1]) == 'w'))
+			{
+				if((*Val == '=') || (*Val == ':')) Val++;
+
+				char *temp;
+				UInt32 Size = *Val ? strtoul(Val, &temp, 0) : 4096;
+				pOpt->AsyncWriteSize = Size * 1024;
+			}
+			else if((Opt == 'o') && (tolower(p[1]) == 'd'))
+			{
+				if((*Val == '=') || (*Val == ':')) Val++;
+
+				char *temp;
+				UInt32 Size = *Val ? strtoul(Val, &temp, 0) : 4096;
+				pOpt->DirectWriteSize = Size * 1024;
+			}
+			else if((Opt == 'o') && (tolower(p[1]) == 'a'))
+			{
+				if((*Val == '=') || (*Val == ':')) Val++;
+
+				char *temp;
+				pOpt->PreallocateDuration = strtoul(Val, &temp, 0);
+			}
+			else if((Opt == 'o') && (tolower(p[1]) == 'l'))
+			{
+				if((*Val == '=') || (*Val == ':')) Val++;
+
+				char *temp;
+				pOpt->LookaheadFiles = *Val ? strtoul(Val, &temp, 0) : 8;
+			}
+			else if((Opt == 'o') && (tolower(p[1]) == 'm')) pOpt->ConcurrentOutputs = true;
+			else if((Opt == 'o') && (tolower(p[1]) == 'r'))
+			{
+				if((*Val == '=') || (*Val == ':')) Val++;
+
+				char *temp;
+				pOpt->PrefetchDepth = *Val ? strtoul(Val, &temp, 0) : 8;
+			}
 			else if(Opt == 'e') pOpt->EditAlign = true;
 			else if(Opt == 'f') 
 			{
 				pOpt->FrameGroup = true;
 				if(p[1] == '0') pOpt->ZeroPad = true;
 			}
+			else if(0 == strncmp(p, "stats", 5)) pOpt->ShowStats = true;
+			else if(0 == strncmp(p, "trace=", 6)) pOpt->TraceFile = &p[6];
+			else if((Opt == 's') && (tolower(p[1]) == 'p'))
+			{
+				// The value is further along as we are using a 2-byte option
+				if(*Val) Val++;
+				if(!pOpt->Storage.Parse(Val))
+				{
+					error("Invalid storage profile \"%s\"\n", Val);
+					return -1;
+				}
+			}
 			else if(Opt == 's') pOpt->StreamMode = true;
 			else if(Opt == 'i')
 			{
@@ -272,6 +338,11 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 				{
 					pOpt->SprinkledIndex = true;
 				}
+				else if(tolower(p[1]) == 'b')
+				{
+					pOpt->SprinkledIndex = true;
+					pOpt->BoundedIndex = true;
+				}
 				else
 				{
 					pOpt->UseIndex = true;
@@ -301,6 +372,26 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 					Val++;
 					pOpt->HeaderSize = strtoul(Val, &temp, 0);
 				}
+				else if(tolower(p[1]) == 'r')
+				{
+					// -hr for header expansion space sized from the metadata
+					if(*Val) Val++;
+					if((*Val == '=') || (*Val == ':')) Val++;
+					pOpt->HeaderReserve = *Val ? strtoul(Val, &temp, 0) : 10;
+				}
+				else if(tolower(p[1]) == 'd')
+				{
+					// -hd for essence digests
+					if((*Val == '=') || (*Val == ':')) Val++;
+					pOpt->DigestAlgorithm = *Val ? Val : "xxh64";
+
+					HashPtr Test = MakeDigestHash(pOpt->DigestAlgorithm);
+					if(!Test)
+					{
+						error("Unknown digest algorithm \"%s\"\n", pOpt->DigestAlgorithm.c_str());
+						return -1;
+					}
+				}
 				else if(tolower(p[1]) == 'p')
 				{
 					// -hp for header padding
@@ -609,8 +700,8 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 	{
 		printf("An updated header will be written after writing the footer\n");
 
-		// We may need some extra space in the header
-		if(pOpt->HeaderPadding<EmpiricalSmallestHeader && pOpt->HeaderSize<EmpiricalSmallestHeader)
+		// We may need some extra space in the header, unless it is being sized from the metadata
+		if(pOpt->HeaderReserve == 0 && pOpt->HeaderPadding<EmpiricalSmallestHeader && pOpt->HeaderSize<EmpiricalSmallestHeader)
 		{
 			pOpt->HeaderPadding = EmpiricalSmallestHeader;
 			printf("Header padding has been increased to the empirical minimum: %d bytes\n", pOpt->HeaderPadding);
@@ -649,6 +740,16 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 		printf("The header will be at least %d bytes long\n", pOpt->HeaderSize);
 	}
 
+	if(pOpt->HeaderReserve)
+	{
+		printf("Expansion space of at least %u%% of the header metadata will be left in the header\n", pOpt->HeaderReserve);
+	}
+
+	if(pOpt->PreallocateDuration)
+	{
+		printf("Disk space will be preallocated for %s frames\n", Int64toString(pOpt->PreallocateDuration).c_str());
+	}
+
 	if(pOpt->StreamMode && (pOpt->InFileGangSize == 1))
 	{
 		warning("Essence containers will not be interleaved for streaming as none are ganged\n");
@@ -686,6 +787,7 @@ int ParseOptions(int &argc, char **argv, ProcessOptions *pOpt)
 	{
 		if(pOpt->UseIndex) printf("Index tables will also be sprinkled across partitions for each frame wrapped container\n");
 		else		 printf("Index tables will be sprinkled across partitions for each frame wrapped essence container\n");
+		if(pOpt->BoundedIndex) printf("Index entries will be freed once sprinkled, footer index tables will be sparse\n");
 	}
 	if(pOpt->SparseIndex) 
 	{
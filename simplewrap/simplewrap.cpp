@@ -45,6 +45,9 @@ string PlatformName = "MXFLib (" + OSName() + ")";
 //! Debug flag for MXFLib
 static bool DebugMode = false;
 
+//! Where to send messages, which is stderr if the MXF file is being written to stdout
+static FILE *MessageFile = stdout;
+
 
 //! Wrap the file
 int main(int argc, char *argv[]) 
@@ -53,16 +56,14 @@ int main(int argc, char *argv[])
 	/**  INITIAL SETUP - Parse the command line etc.  **/
 	/***************************************************/
 
-	printf("MXFlib Simple Wrapper\n" );
-
 	char *SourceFile = NULL;
 	char *DestFile = NULL;
 	
 	// Parse the command line
 	for(int i=1; i<argc; i++)
 	{
-		// Parse options
-		if(argv[i][0] == '-')
+		// Parse options (a lone "-" is a filename)
+		if((argv[i][0] == '-') && argv[i][1])
 		{
 			char *p = &argv[i][1];					// The option less the '-' or '/'
 			char Opt = tolower(*p);					// The option itself (in lower case)
@@ -92,6 +93,12 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	// An output filename of "-" streams the MXF file to stdout
+	bool ToStdout = (DestFile != NULL) && (strcmp(DestFile, "-") == 0);
+	if(ToStdout) MessageFile = stderr;
+
+	fprintf(MessageFile, "MXFlib Simple Wrapper\n" );
+
 	// If two filenames were not supplied, give usage instructions
 	if(DestFile == NULL)
 	{
@@ -99,7 +106,7 @@ int main(int argc, char *argv[])
 
 		fprintf(stderr, "Where: -v enables verbose mode (debug output)\n");
 		fprintf(stderr, "       <infile> is the essence file to wrap\n");
-		fprintf(stderr, "       <outfile> is the output file to produce\n");
+		fprintf(stderr, "       <outfile> is the output file to produce, or - to write to stdout\n");
 
 		return 1;
 	}
@@ -149,11 +156,20 @@ int main(int argc, char *argv[])
 	/*********************************************/
 
 	// Enable FastClipWrap mode - don't do this if random access not available of the output medium
-	SetFastClipWrap(true);
+	SetFastClipWrap(!ToStdout);
 
 	// Open the destination MXF file
 	MXFFilePtr OutFile = new MXFFile;
-	if(!OutFile->OpenNew(DestFile))
+	if(ToStdout)
+	{
+#ifdef _WIN32
+		_setmode(_fileno(stdout), _O_BINARY);
+		OutFile->OpenStreamFromHandle(_fileno(stdout));
+#else
+		OutFile->OpenStreamFromHandle(stdout);
+#endif
+	}
+	else if(!OutFile->OpenNew(DestFile))
 	{
 		error("Couldn't open source file %s\n", SourceFile);
 		return 1;
@@ -376,7 +392,7 @@ void mxflib::debug(const char *Fmt, ...)
 	va_list args;
 
 	va_start(args, Fmt);
-	vprintf(Fmt, args);
+	vfprintf(MessageFile, Fmt, args);
 	va_end(args);
 }
 #endif // MXFLIB_DEBUG
@@ -387,8 +403,8 @@ void mxflib::warning(const char *Fmt, ...)
 	va_list args;
 
 	va_start(args, Fmt);
-	printf("Warning: ");
-	vprintf(Fmt, args);
+	fprintf(MessageFile, "Warning: ");
+	vfprintf(MessageFile, Fmt, args);
 	va_end(args);
 }
 
@@ -398,8 +414,8 @@ void mxflib::error(const char *Fmt, ...)
 	va_list args;
 
 	va_start(args, Fmt);
-	printf("ERROR: ");
-	vprintf(Fmt, args);
+	fprintf(MessageFile, "ERROR: ");
+	vfprintf(MessageFile, Fmt, args);
 	va_end(args);
 }
 
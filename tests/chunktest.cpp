@@ -0,0 +1,254 @@
+/*! \file	chunktest.cpp
+ *	\brief	Checks of the copy-on-write buffer sharing of DataChunk
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Each check prints a line starting "FAIL" if it does not hold, so a clean run prints nothing and exits with 0.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include <mxflib/mxflib.h>
+
+using namespace mxflib;
+
+#include <stdio.h>
+
+using namespace std;
+
+
+namespace
+{
+	//! The size of the test chunks, big enough to be shared rather than copied
+	const size_t TestSize = 1000;
+
+	//! Number of checks that failed
+	int Failures = 0;
+
+	//! Record the result of a check
+	void Check(bool Passed, const char *Name)
+	{
+		if(Passed) return;
+
+		printf("FAIL: %s\n", Name);
+		Failures++;
+	}
+
+	//! Build a chunk holding a known pattern
+	DataChunkPtr MakePattern(void)
+	{
+		DataChunkPtr Ret = new DataChunk(TestSize);
+
+		size_t i;
+		for(i = 0; i < TestSize; i++) Ret->Data[i] = static_cast<UInt8>(i * 7);
+
+		return Ret;
+	}
+
+	//! Determine if a chunk holds part of the known pattern
+	bool HasPattern(const DataChunk &Chunk, size_t Start, size_t Length)
+	{
+		if(Chunk.Size != Length) return false;
+
+		size_t i;
+		for(i = 0; i < Length; i++) if(Chunk.Data[i] != static_cast<UInt8>((Start + i) * 7)) return false;
+
+		return true;
+	}
+
+	//! Thread that copies and slices a shared source chunk, as the writer threads of a tee do
+	class CopyThread : public Thread
+	{
+	protected:
+		DataChunkPtr Source;					//!< The chunk to copy
+		int Count;								//!< The number of copies to make
+
+	public:
+		bool Passed;							//!< Set false if any copy was wrong
+
+		CopyThread(DataChunkPtr Source, int Count) : Source(Source), Count(Count), Passed(true) {}
+
+	protected:
+		void Run(void)
+		{
+			int i;
+			for(i = 0; i < Count; i++)
+			{
+				DataChunk Copy(*Source);
+				DataChunkPtr Part = Source->Slice(300, 500);
+
+				if(!HasPattern(Copy, 0, TestSize) || !HasPattern(*Part, 300, 500)) Passed = false;
+			}
+		}
+	};
+}
+
+
+//! Run the checks
+int main(int argc, char *argv[])
+{
+	// A copy has a buffer of its own, so writing directly to either chunk leaves the other unchanged
+	{
+		DataChunkPtr Original = MakePattern();
+		DataChunk Copy(*Original);
+		Check(!Copy.IsShared() && !Original->IsShared() && (Copy.Data != Original->Data), "copy has its own buffer");
+
+		Copy.Data[0] = 0xff;
+		Check(HasPattern(*Original, 0, TestSize), "original unchanged by writing to a copy");
+
+		DataChunk PtrCopy(Original);
+		Original->Data[0] = 0xff;
+		Check(HasPattern(PtrCopy, 0, TestSize), "copy from a smart pointer unchanged by writing to the original");
+	}
+
+	// A slice is not changed by Set(), Append() or MakeWritable() on the original, nor the original by changes to the slice
+	{
+		DataChunkPtr Original = MakePattern();
+		DataChunkPtr Part = Original->Slice(0, TestSize);
+		Check(Part->IsShared() && Original->IsShared(), "slice of the whole chunk shares the buffer");
+
+		UInt8 Bytes[4] = { 0xff, 0xff, 0xff, 0xff };
+		Original->Set(4, Bytes, 10);
+		Check(HasPattern(*Part, 0, TestSize), "slice unchanged by Set() on the original");
+		Check((Original->Data[10] == 0xff) && !Original->IsShared(), "Set() on the original takes a private copy");
+
+		DataChunkPtr Second = Original->Slice(0, TestSize);
+		Second->Append(4, Bytes);
+		Check((Original->Size == TestSize) && (Original->Data[10] == 0xff) && (Original->Data[20] == 140), "original unchanged by Append() on a slice");
+		Check((Second->Size == TestSize + 4) && (Second->Data[TestSize] == 0xff), "Append() on a slice");
+
+		DataChunkPtr Third = Part->Slice(0, TestSize);
+		Third->MakeWritable();
+		Check(!Third->IsShared(), "MakeWritable() takes a private copy");
+		Third->Data[0] = 0xff;
+		Check(HasPattern(*Part, 0, TestSize), "slice unchanged by writing after MakeWritable() on another slice");
+	}
+
+	// A slice outlives the chunk it was taken from
+	{
+		DataChunkPtr Original = MakePattern();
+		DataChunkPtr Part = Original->Slice(100, 500);
+		Check(Part->IsShared(), "slice shares the buffer");
+
+		Original = NULL;
+		Check(HasPattern(*Part, 100, 500), "slice outlives its source");
+
+		DataChunkPtr SubPart = Part->Slice(50, 300);
+		Part = NULL;
+		Check(HasPattern(*SubPart, 150, 300), "slice of a slice outlives both");
+	}
+
+	// Bytes that are shared rather than copied are counted
+	if(EnableStats())
+	{
+		ResetStats();
+
+		DataChunkPtr Original = MakePattern();
+		DataChunkPtr Part = Original->Slice(0, 600);
+		DataChunkPtr Whole = Original->Slice(0, TestSize);
+		DataChunk Copy(*Original);
+		DataChunkPtr Small = Original->Slice(0, 10);
+
+		Check(GetStat(StatsChunkSharedBytes) == 600 + TestSize, "shared bytes counted");
+
+		EnableStats(false);
+	}
+
+	// TakeBuffer() takes over the owner of a shared buffer
+	{
+		DataChunkPtr Original = MakePattern();
+		DataChunkPtr Shared = Original->Slice(0, TestSize);
+		Original = NULL;
+
+		DataChunk Taker;
+		Check(Taker.TakeBuffer(Shared, true), "TakeBuffer() from a shared chunk");
+		Check(HasPattern(Taker, 0, TestSize) && (Shared->Size == 0), "TakeBuffer() moves the shared data");
+
+		DataChunkPtr Part = MakePattern()->Slice(200, 400);
+		DataChunk PartTaker;
+		Check(PartTaker.TakeBuffer(Part, false) && HasPattern(PartTaker, 200, 400) && HasPattern(*Part, 200, 400), "TakeBuffer() from a slice without emptying it");
+	}
+
+	// Several threads may copy and slice the same chunk at once
+	{
+		const int Threads = 4;
+
+		int Round;
+		for(Round = 0; Round < 200; Round++)
+		{
+			DataChunkPtr Original = MakePattern();
+
+			std::vector<CopyThread*> Copiers;
+			int i;
+			for(i = 0; i < Threads; i++) Copiers.push_back(new CopyThread(Original, 10));
+			for(i = 0; i < Threads; i++) Copiers[i]->Start();
+
+			bool Passed = true;
+			for(i = 0; i < Threads; i++)
+			{
+				Copiers[i]->Join();
+				if(!Copiers[i]->Passed) Passed = false;
+				delete Copiers[i];
+			}
+
+			Check(Passed && HasPattern(*Original, 0, TestSize), "copies made by several threads at once");
+			if(!Passed) break;
+		}
+	}
+
+	return Failures ? 1 : 0;
+}
+
+
+// Debug and error messages
+#include <stdarg.h>
+
+#ifdef MXFLIB_DEBUG
+//! Display a general debug message
+void mxflib::debug(const char *Fmt, ...)
+{
+}
+#endif // MXFLIB_DEBUG
+
+//! Display a warning message
+void mxflib::warning(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "Warning: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}
+
+//! Display an error message
+void mxflib::error(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}
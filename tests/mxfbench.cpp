@@ -0,0 +1,848 @@
+/*! \file	mxfbench.cpp
+ *	\brief	Micro and macro benchmarks for the core read and write paths of MXFLib
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Each benchmark is run a number of times and the best and median times are reported
+ *  as JSON, so that results from different builds or releases can be compared by a script.
+ *  All test data is generated from fixed seeds so each run does the same work.
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include <mxflib/mxflib.h>
+
+using namespace mxflib;
+
+#include <mxflib/dict.h>
+
+#include <stdio.h>
+#include <algorithm>
+
+using namespace std;
+
+
+namespace
+{
+	//! Number of times to run each benchmark
+	int Repeats = 5;
+
+	//! Multiplier for the amount of work done by each benchmark
+	int Scale = 1;
+
+	//! Path of mxfwrap for the end-to-end benchmarks, or empty to skip them
+	std::string WrapTool;
+
+	//! Path of mxfsplit for the end-to-end benchmarks, or empty to skip them
+	std::string SplitTool;
+
+	//! Somewhere for benchmarks to put their results so that the compiler can't remove the work
+	volatile UInt64 Sink = 0;
+
+	//! Details of the result of one benchmark
+	struct BenchResult
+	{
+		std::string Name;					//!< The name of the benchmark
+		UInt64 Operations;					//!< Number of operations per run, or zero for throughput benchmarks
+		UInt64 Bytes;						//!< Number of bytes processed per run, or zero for operation benchmarks
+		double Best;						//!< Fastest run in seconds
+		double Median;						//!< Median run in seconds
+	};
+
+	//! All results so far, in the order run
+	std::list<BenchResult> Results;
+
+	//! Get a wall clock time in seconds
+	double Now(void)
+	{
+#ifdef _WIN32
+		LARGE_INTEGER Count, Freq;
+		QueryPerformanceCounter(&Count);
+		QueryPerformanceFrequency(&Freq);
+		return static_cast<double>(Count.QuadPart) / static_cast<double>(Freq.QuadPart);
+#else
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return static_cast<double>(tv.tv_sec) + (static_cast<double>(tv.tv_usec) / 1000000.0);
+#endif
+	}
+
+	//! A simple repeatable pseudo-random number generator, so that every run uses the same data
+	class BenchRandom
+	{
+	protected:
+		UInt32 State;
+
+	public:
+		BenchRandom(UInt32 Seed = 12345) : State(Seed) {}
+
+		UInt32 Next(void)
+		{
+			State = (State * 1103515245) + 12345;
+			return State >> 8;
+		}
+	};
+
+	//! Base class for benchmarks, which is set up once then run several times
+	class Benchmark
+	{
+	public:
+		virtual ~Benchmark() {}
+
+		//! Do one run of the benchmark, returning false if it could not be run
+		virtual bool Run(void) = 0;
+	};
+
+	//! Run a benchmark the configured number of times and record the result
+	void Measure(const char *Name, Benchmark &Bench, UInt64 Operations, UInt64 Bytes)
+	{
+		std::vector<double> Times;
+
+		int i;
+		for(i = 0; i < Repeats; i++)
+		{
+			double Start = Now();
+			if(!Bench.Run())
+			{
+				error("Benchmark %s failed\n", Name);
+				return;
+			}
+			Times.push_back(Now() - Start);
+		}
+
+		std::sort(Times.begin(), Times.end());
+
+		BenchResult Result;
+		Result.Name = Name;
+		Result.Operations = Operations;
+		Result.Bytes = Bytes;
+		Result.Best = Times.front();
+		Result.Median = Times[Times.size() / 2];
+		Results.push_back(Result);
+
+		fprintf(stderr, "%-24s best %.6fs median %.6fs\n", Name, Result.Best, Result.Median);
+	}
+
+
+	/* Micro-benchmarks */
+
+	//! Encode BER lengths of a range of sizes
+	class MakeBERBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		UInt64 Lengths[1024];
+
+	public:
+		MakeBERBench(UInt64 Count) : Count(Count)
+		{
+			BenchRandom Rand;
+			int i;
+			for(i = 0; i < 1024; i++) Lengths[i] = static_cast<UInt64>(Rand.Next()) >> (Rand.Next() % 24);
+		}
+
+		bool Run(void)
+		{
+			UInt8 Buffer[9];
+			UInt64 Total = 0;
+
+			UInt64 i;
+			for(i = 0; i < Count; i++) Total += MakeBER(Buffer, 9, Lengths[i & 1023]);
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Decode BER lengths of a range of sizes
+	class ReadBERBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		UInt8 Buffer[1024 * 9];
+		int Offsets[1024];
+
+	public:
+		ReadBERBench(UInt64 Count) : Count(Count)
+		{
+			BenchRandom Rand;
+			int Offset = 0;
+			int i;
+			for(i = 0; i < 1024; i++)
+			{
+				Offsets[i] = Offset;
+				Offset += MakeBER(&Buffer[Offset], 9, static_cast<UInt64>(Rand.Next()) >> (Rand.Next() % 24));
+			}
+		}
+
+		bool Run(void)
+		{
+			UInt64 Total = 0;
+
+			UInt64 i;
+			for(i = 0; i < Count; i++)
+			{
+				UInt8 const *p = &Buffer[Offsets[i & 1023]];
+				Total += ReadBER(&p, 9);
+			}
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Build a set of ULs that differ only in their last few bytes, as essence and metadata keys do
+	void MakeULs(std::vector<UL> &ULs, size_t Count)
+	{
+		BenchRandom Rand;
+		UInt8 Data[16] = { 0x06, 0x0e, 0x2b, 0x34, 0x01, 0x02, 0x01, 0x01, 0x0d, 0x01, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00 };
+
+		size_t i;
+		for(i = 0; i < Count; i++)
+		{
+			Data[12] = static_cast<UInt8>(Rand.Next());
+			Data[13] = static_cast<UInt8>(Rand.Next());
+			Data[14] = static_cast<UInt8>(Rand.Next());
+			Data[15] = static_cast<UInt8>(i);
+			ULs.push_back(UL(Data));
+		}
+	}
+
+	//! Compare ULs for equality and order
+	class ULCompareBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		std::vector<UL> ULs;
+
+	public:
+		ULCompareBench(UInt64 Count) : Count(Count) { MakeULs(ULs, 256); }
+
+		bool Run(void)
+		{
+			UInt64 Total = 0;
+
+			UInt64 i;
+			for(i = 0; i < Count; i++)
+			{
+				const UL &a = ULs[i & 255];
+				const UL &b = ULs[(i * 7) & 255];
+				if(a == b) Total++;
+				if(a < b) Total += 2;
+			}
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Find ULs in a hash table
+	class ULHashBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		std::vector<UL> ULs;
+		ULHashMap<int> Map;
+
+	public:
+		ULHashBench(UInt64 Count) : Count(Count)
+		{
+			MakeULs(ULs, 1024);
+
+			int i;
+			for(i = 0; i < 1024; i++) Map.Set(ULs[i], i);
+		}
+
+		bool Run(void)
+		{
+			UInt64 Total = 0;
+
+			UInt64 i;
+			for(i = 0; i < Count; i++)
+			{
+				const int *Value = Map.Find(ULs[(i * 13) & 1023]);
+				if(Value) Total += *Value;
+			}
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Find dictionary ULs, either in the static index written by dictconvert or in the loaded type definitions
+	class DictLookupBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		bool Static;
+		std::vector<UL> ULs;
+
+	public:
+		DictLookupBench(UInt64 Count, bool Static) : Count(Count), Static(Static)
+		{
+			UInt32 i;
+			for(i = 0; i < DictData_Index.EntryCount; i++) ULs.push_back(UL(DictData_Index.Entries[i].Key));
+		}
+
+		bool Run(void)
+		{
+			UInt64 Total = 0;
+			size_t Size = ULs.size();
+
+			UInt64 i;
+			for(i = 0; i < Count; i++)
+			{
+				const UL &Key = ULs[(i * 13) % Size];
+				if(Static) { if(DictData_Index.Find(Key)) Total++; }
+				else { if(MDOType::Find(Key)) Total++; }
+			}
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Look up random edit units in a VBR index table
+	class IndexLookupBench : public Benchmark
+	{
+	protected:
+		UInt64 Count;
+		Length Entries;
+		IndexTablePtr Table;
+
+	public:
+		IndexLookupBench(UInt64 Count, Length Entries, bool Flat) : Count(Count), Entries(Entries)
+		{
+			Table = new IndexTable;
+			Table->IndexSID = 2;
+			Table->BodySID = 1;
+			Table->EditRate = Rational(25, 1);
+
+			UInt32 ElementSize = 0;
+			Table->DefineDeltaArray(1, &ElementSize);
+
+			BenchRandom Rand;
+			UInt64 Offset = 0;
+			Position i;
+			for(i = 0; i < Entries; i++)
+			{
+				Table->AddIndexEntry(i, 0, 0, (i % 12) ? 0x00 : 0x80, Offset);
+				Offset += 100000 + (Rand.Next() % 50000);
+			}
+
+			if(Flat) Table->Flatten();
+		}
+
+		bool Run(void)
+		{
+			BenchRandom Rand;
+			IndexPos Result;
+			UInt64 Total = 0;
+
+			UInt64 i;
+			for(i = 0; i < Count; i++)
+			{
+				Table->Lookup(static_cast<Position>(Rand.Next() % Entries), Result);
+				Total += Result.Location;
+			}
+
+			Sink += Total;
+			return true;
+		}
+	};
+
+	//! Load a VBR index table from its raw bytes
+	class IndexLoadBench : public Benchmark
+	{
+	protected:
+		DataChunkPtr Data;
+
+	public:
+		IndexLoadBench(Length Entries)
+		{
+			IndexTablePtr Table = new IndexTable;
+			Table->IndexSID = 2;
+			Table->BodySID = 1;
+			Table->EditRate = Rational(25, 1);
+
+			UInt32 ElementSize = 0;
+			Table->DefineDeltaArray(1, &ElementSize);
+
+			UInt64 Offset = 0;
+			Position i;
+			for(i = 0; i < Entries; i++)
+			{
+				Table->AddIndexEntry(i, 0, 0, (i % 12) ? 0x00 : 0x80, Offset);
+				Offset += 100000;
+			}
+
+			Data = new DataChunk;
+			Table->WriteIndex(*Data);
+		}
+
+		//! Get the number of bytes of index table data loaded by each run
+		size_t GetSize(void) const { return Data->Size; }
+
+		bool Run(void)
+		{
+			IndexTablePtr Table = new IndexTable;
+			if(!Table->AddSegments(Data)) return false;
+
+			Sink += Table->GetDuration();
+			return true;
+		}
+	};
+
+	//! Read the metadata of a synthetic header partition
+	class ReadMetadataBench : public Benchmark
+	{
+	protected:
+		MXFFilePtr File;
+
+	public:
+		//! Build the header, with about Sets sets, in a memory file
+		ReadMetadataBench(int Sets)
+		{
+			MetadataPtr MData = new Metadata();
+			PackagePtr MaterialPackage = MData->AddMaterialPackage(MakeUMID(0x02));
+
+			// Each track has a track, a sequence and a source clip
+			int i;
+			for(i = 0; i < (Sets / 3); i++)
+			{
+				TrackPtr Track = MaterialPackage->AddSoundTrack(Rational(25, 1));
+				Track->AddSourceClip(250);
+			}
+
+			PartitionPtr ThisPartition = new Partition(OpenHeader_UL);
+			ThisPartition->SetKAG(1);
+			ThisPartition->SetUInt(BodySID_UL, 0);
+			ThisPartition->AddMetadata(MData);
+
+			File = new MXFFile;
+			File->OpenMemory();
+			File->WritePartition(ThisPartition);
+		}
+
+		bool Run(void)
+		{
+			File->Seek(0);
+			PartitionPtr ThisPartition = File->ReadPartition();
+			if(!ThisPartition) return false;
+
+			if(ThisPartition->ReadMetadata() == 0) return false;
+
+			Sink += ThisPartition->AllMetadata.size();
+			return true;
+		}
+	};
+
+	//! Write content packages through a GCWriter into a memory file
+	class GCFlushBench : public Benchmark
+	{
+	protected:
+		int Frames;
+		MXFFilePtr File;
+		DataChunk Picture;
+		DataChunk Sound;
+
+	public:
+		GCFlushBench(int Frames) : Frames(Frames), Picture(250000), Sound(11520)
+		{
+			BenchRandom Rand;
+			size_t i;
+			for(i = 0; i < Picture.Size; i++) Picture.Data[i] = static_cast<UInt8>(Rand.Next());
+			for(i = 0; i < Sound.Size; i++) Sound.Data[i] = static_cast<UInt8>(Rand.Next());
+
+			File = new MXFFile;
+			File->OpenMemory();
+		}
+
+		//! Get the number of bytes of essence written per run
+		UInt64 GetBytes(void) const { return static_cast<UInt64>(Frames) * (Picture.Size + Sound.Size); }
+
+		bool Run(void)
+		{
+			// DRAGONS: Each run overwrites the previous one so the memory file does not keep growing
+			File->Seek(0);
+
+			GCWriterPtr Writer = new GCWriter(File, 1);
+			GCStreamID PictureID = Writer->AddPictureElement(0x05);
+			GCStreamID SoundID = Writer->AddSoundElement(0x01);
+
+			int i;
+			for(i = 0; i < Frames; i++)
+			{
+				Writer->AddEssenceData(PictureID, Picture.Size, Picture.Data);
+				Writer->AddEssenceData(SoundID, Sound.Size, Sound.Data);
+				Writer->Flush();
+			}
+
+			Sink += File->Tell();
+			return true;
+		}
+	};
+
+	//! Write long-GOP picture and 8 channels of sound from synthetic sources through a BodyWriter into a memory file, with a footer index
+	class BodyWriterBench : public Benchmark
+	{
+	protected:
+		MXFFilePtr File;
+		SyntheticEssenceSource *Picture;
+		SyntheticEssenceSource *Sound;
+		EssenceSourcePtr PictureSource;
+		EssenceSourcePtr SoundSource;
+
+	public:
+		BodyWriterBench(int Frames)
+		{
+			SyntheticSettings Settings;
+			Settings.Duration = Frames;
+			Settings.Pattern = SyntheticLongGOP;
+			Picture = new SyntheticEssenceSource(Settings);
+			PictureSource = Picture;
+
+			Settings.Channels = 8;
+			Sound = new SyntheticEssenceSource(Settings);
+			SoundSource = Sound;
+
+			File = new MXFFile;
+			File->OpenMemory();
+		}
+
+		//! Get the number of bytes of essence written per run
+		UInt64 GetBytes(void) const
+		{
+			return static_cast<UInt64>(Picture->GetSettings().Duration) * (Picture->GetSettings().FrameSize + Sound->GetSettings().FrameSize);
+		}
+
+		bool Run(void)
+		{
+			// DRAGONS: Each run overwrites the previous one so the memory file does not keep growing
+			File->Seek(0);
+			Picture->SkipTo(0);
+			Sound->SkipTo(0);
+
+			BodyStreamPtr Stream = new BodyStream(1, PictureSource);
+			Stream->AddSubStream(SoundSource);
+			Stream->SetWrapType(BodyStream::StreamWrapFrame);
+			Stream->SetIndexType(BodyStream::StreamIndexFullFooter);
+			Stream->SetIndexSID(2);
+
+			BodyWriterPtr Writer = new BodyWriter(File);
+			Writer->SetKAG(1);
+			Writer->SetForceBER4(true);
+			Writer->AddStream(Stream);
+
+			PartitionPtr Header = new Partition(OpenHeader_UL);
+			Writer->SetPartition(Header);
+
+			Writer->WriteHeader(false, false);
+			Writer->WriteBody();
+			Writer->WriteFooter(false, false);
+
+			Sink += File->Tell();
+			return true;
+		}
+	};
+
+
+	/* Macro-benchmarks */
+
+	//! Write a WAVE file of 24-bit stereo audio at 48kHz with repeatable content
+	bool MakeWave(const char *FileName, int Seconds)
+	{
+		FILE *Out = fopen(FileName, "wb");
+		if(!Out) return false;
+
+		const UInt32 DataSize = static_cast<UInt32>(Seconds) * 48000 * 2 * 3;
+
+		UInt8 Header[44];
+		memcpy(Header, "RIFF", 4);
+		PutU32_LE(36 + DataSize, &Header[4]);
+		memcpy(&Header[8], "WAVEfmt ", 8);
+		PutU32_LE(16, &Header[16]);
+		PutU16_LE(1, &Header[20]);					// PCM
+		PutU16_LE(2, &Header[22]);					// Channels
+		PutU32_LE(48000, &Header[24]);				// Sample rate
+		PutU32_LE(48000 * 2 * 3, &Header[28]);		// Bytes per second
+		PutU16_LE(2 * 3, &Header[32]);				// Block align
+		PutU16_LE(24, &Header[34]);					// Bits per sample
+		memcpy(&Header[36], "data", 4);
+		PutU32_LE(DataSize, &Header[40]);
+
+		bool Ret = (fwrite(Header, 1, 44, Out) == 44);
+
+		BenchRandom Rand;
+		UInt8 Buffer[48000 * 2 * 3];
+		int i;
+		for(i = 0; Ret && (i < Seconds); i++)
+		{
+			size_t j;
+			for(j = 0; j < sizeof(Buffer); j++) Buffer[j] = static_cast<UInt8>(Rand.Next());
+			Ret = (fwrite(Buffer, 1, sizeof(Buffer), Out) == sizeof(Buffer));
+		}
+
+		fclose(Out);
+		return Ret;
+	}
+
+	//! Run a command line tool, discarding its output
+	class ToolBench : public Benchmark
+	{
+	protected:
+		std::string Command;
+
+	public:
+		ToolBench(std::string Tool, std::string Args)
+		{
+#ifdef _WIN32
+			Command = "\"\"" + Tool + "\" " + Args + " > NUL 2>&1\"";
+#else
+			Command = "\"" + Tool + "\" " + Args + " > /dev/null 2>&1";
+#endif
+		}
+
+		bool Run(void) { return system(Command.c_str()) == 0; }
+	};
+}
+
+
+//! Run the benchmarks
+int main(int argc, char *argv[])
+{
+	std::string OutFile;
+	bool MicroOnly = false;
+
+	int i;
+	for(i = 1; i < argc; i++)
+	{
+		if((argv[i][0] != '-') || (!argv[i][1]))
+		{
+			fprintf(stderr, "Unexpected argument %s\n", argv[i]);
+			return 1;
+		}
+
+		char Opt = tolower(argv[i][1]);
+		char *Val = &argv[i][2];
+		if((*Val == '=') || (*Val == ':')) Val++;
+
+		if(Opt == 'r') Repeats = atoi(Val);
+		else if(Opt == 's') Scale = atoi(Val);
+		else if(Opt == 'm') MicroOnly = true;
+		else if(Opt == 'w') WrapTool = Val;
+		else if(Opt == 'x') SplitTool = Val;
+		else if(Opt == 'o') OutFile = Val;
+		else
+		{
+			fprintf(stderr, "\nUsage: %s [-r=<n>] [-s=<n>] [-m] [-w=<mxfwrap>] [-x=<mxfsplit>] [-o=<file>]\n\n", argv[0]);
+
+			fprintf(stderr, "Where: -r=<n>       runs each benchmark n times (default 5)\n");
+			fprintf(stderr, "       -s=<n>       multiplies the work done by each benchmark by n (default 1)\n");
+			fprintf(stderr, "       -m           runs only the micro-benchmarks\n");
+			fprintf(stderr, "       -w=<mxfwrap> is the mxfwrap to time end-to-end\n");
+			fprintf(stderr, "       -x=<mxfsplit> is the mxfsplit to time end-to-end (requires -w)\n");
+			fprintf(stderr, "       -o=<file>    writes the JSON results to a file rather than stdout\n");
+
+			return 1;
+		}
+	}
+
+	if(Repeats < 1) Repeats = 1;
+	if(Scale < 1) Scale = 1;
+
+	LoadDictionary("dict.xml");
+
+	const UInt64 Ops = static_cast<UInt64>(Scale) * 10000000;
+
+	{
+		MakeBERBench Bench(Ops);
+		Measure("ber.make", Bench, Ops, 0);
+	}
+
+	{
+		ReadBERBench Bench(Ops);
+		Measure("ber.read", Bench, Ops, 0);
+	}
+
+	{
+		ULCompareBench Bench(Ops);
+		Measure("ul.compare", Bench, Ops, 0);
+	}
+
+	{
+		ULHashBench Bench(Ops);
+		Measure("ul.hash", Bench, Ops, 0);
+	}
+
+	{
+		DictLookupBench Bench(Ops, true);
+		Measure("dict.index", Bench, Ops, 0);
+	}
+
+	{
+		DictLookupBench Bench(Ops, false);
+		Measure("dict.find", Bench, Ops, 0);
+	}
+
+	{
+		IndexLookupBench Bench(Ops / 10, 100000, false);
+		Measure("index.lookup", Bench, Ops / 10, 0);
+	}
+
+	{
+		IndexLookupBench Bench(Ops / 10, 100000, true);
+		Measure("index.lookup.flat", Bench, Ops / 10, 0);
+	}
+
+	{
+		IndexLoadBench Bench(Scale * 100000);
+		Measure("index.load", Bench, 1, Bench.GetSize());
+	}
+
+	{
+		const int Sets = Scale * 3000;
+		ReadMetadataBench Bench(Sets);
+		Measure("partition.readmetadata", Bench, Sets, 0);
+	}
+
+	{
+		GCFlushBench Bench(Scale * 250);
+		Measure("gcwriter.flush", Bench, 0, Bench.GetBytes());
+	}
+
+	{
+		BodyWriterBench Bench(Scale * 250);
+		Measure("bodywriter.synthetic", Bench, 0, Bench.GetBytes());
+	}
+
+	if((!MicroOnly) && (!WrapTool.empty()))
+	{
+		const int Seconds = Scale * 60;
+		const UInt64 WaveBytes = static_cast<UInt64>(Seconds) * 48000 * 2 * 3;
+
+		if(!MakeWave("mxfbench.wav", Seconds))
+		{
+			error("Unable to write mxfbench.wav\n");
+		}
+		else
+		{
+			{
+				ToolBench Bench(WrapTool, "-f -r25/1 mxfbench.wav mxfbench.mxf");
+				Measure("mxfwrap", Bench, 0, WaveBytes);
+			}
+
+			if(!SplitTool.empty())
+			{
+				ToolBench Bench(SplitTool, "-q mxfbench.mxf");
+				Measure("mxfsplit", Bench, 0, WaveBytes);
+			}
+
+			// DRAGONS: The name of the file written by mxfsplit depends on the track number of the wrapped audio
+			FileDelete("mxfbench.wav");
+			FileDelete("mxfbench.mxf");
+			FileDelete("_0001_16010101.stream");
+		}
+	}
+
+	// Write the results
+	FILE *Out = stdout;
+	if(!OutFile.empty())
+	{
+		Out = fopen(OutFile.c_str(), "w");
+		if(!Out)
+		{
+			error("Unable to write %s\n", OutFile.c_str());
+			return 1;
+		}
+	}
+
+	fprintf(Out, "{\n");
+	fprintf(Out, "  \"library\": \"%s\",\n", LibraryVersion().c_str());
+	fprintf(Out, "  \"platform\": \"%s\",\n", OSName().c_str());
+	fprintf(Out, "  \"repeats\": %d,\n", Repeats);
+	fprintf(Out, "  \"scale\": %d,\n", Scale);
+	fprintf(Out, "  \"results\": [");
+
+	std::list<BenchResult>::iterator it = Results.begin();
+	while(it != Results.end())
+	{
+		fprintf(Out, "%s\n    { \"name\": \"%s\", \"best_seconds\": %.6f, \"median_seconds\": %.6f", (it == Results.begin()) ? "" : ",",
+				(*it).Name.c_str(), (*it).Best, (*it).Median);
+
+		if((*it).Operations)
+		{
+			fprintf(Out, ", \"operations\": %s, \"ns_per_op\": %.3f", UInt64toString((*it).Operations).c_str(),
+					((*it).Best * 1000000000.0) / static_cast<double>((*it).Operations));
+		}
+
+		if((*it).Bytes)
+		{
+			fprintf(Out, ", \"bytes\": %s, \"mb_per_s\": %.2f", UInt64toString((*it).Bytes).c_str(),
+					(static_cast<double>((*it).Bytes) / (1024.0 * 1024.0)) / (*it).Best);
+		}
+
+		fprintf(Out, " }");
+		it++;
+	}
+
+	fprintf(Out, "\n  ]\n}\n");
+
+	if(Out != stdout) fclose(Out);
+
+	return 0;
+}
+
+
+// Debug and error messages
+#include <stdarg.h>
+
+#ifdef MXFLIB_DEBUG
+//! Display a general debug message
+void mxflib::debug(const char *Fmt, ...)
+{
+}
+#endif // MXFLIB_DEBUG
+
+//! Display a warning message
+void mxflib::warning(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "Warning: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}
+
+//! Display an error message
+void mxflib::error(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}
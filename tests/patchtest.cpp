@@ -0,0 +1,144 @@
+/*! \file	patchtest.cpp
+ *	\brief	Check of MXFFile::PatchPartition(), patching the durations in the header of a file
+ *
+ *	\version $Id$
+ *
+ *  \detail
+ *  Every duration in the header metadata of the given file is set to a new value and patched into the file in place,
+ *  so the result can be checked by reading the file with mxfdump. Anything that goes wrong prints a line starting "FAIL".
+ */
+/*
+ *	Copyright (c) 2011, Matt Beard
+ *
+ *	This software is provided 'as-is', without any express or implied warranty.
+ *	In no event will the authors be held liable for any damages arising from
+ *	the use of this software.
+ *
+ *	Permission is granted to anyone to use this software for any purpose,
+ *	including commercial applications, and to alter it and redistribute it
+ *	freely, subject to the following restrictions:
+ *
+ *	  1. The origin of this software must not be misrepresented; you must
+ *	     not claim that you wrote the original software. If you use this
+ *	     software in a product, an acknowledgment in the product
+ *	     documentation would be appreciated but is not required.
+ *
+ *	  2. Altered source versions must be plainly marked as such, and must
+ *	     not be misrepresented as being the original software.
+ *
+ *	  3. This notice may not be removed or altered from any source
+ *	     distribution.
+ */
+
+#include <mxflib/mxflib.h>
+
+using namespace mxflib;
+
+#include <stdio.h>
+
+using namespace std;
+
+
+//! Patch the durations of a file
+int main(int argc, char *argv[])
+{
+	if(argc != 3)
+	{
+		fprintf(stderr, "\nUsage: %s <file> <duration>\n\n", argv[0]);
+		return 1;
+	}
+
+	Int64 Duration = static_cast<Int64>(strtol(argv[2], NULL, 0));
+
+	LoadDictionary("dict.xml");
+
+	MXFFilePtr File = new MXFFile;
+	if(!File->Open(argv[1], false))
+	{
+		printf("FAIL: Could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	PartitionPtr Header = File->ReadPartition();
+	if((!Header) || (!Header->ReadMetadata()))
+	{
+		printf("FAIL: Could not read the header metadata of %s\n", argv[1]);
+		return 1;
+	}
+
+	int Count = 0;
+	MDObjectList::iterator it = Header->AllMetadata.begin();
+	while(it != Header->AllMetadata.end())
+	{
+		if((*it)->Child(ComponentLength_UL))
+		{
+			(*it)->SetInt64(ComponentLength_UL, Duration);
+			Count++;
+		}
+
+		it++;
+	}
+
+	if(!Count)
+	{
+		printf("FAIL: No durations found in %s\n", argv[1]);
+		return 1;
+	}
+
+	int Ret = 0;
+	if(!File->PatchPartition(Header))
+	{
+		printf("FAIL: PatchPartition() failed\n");
+		Ret = 1;
+	}
+
+	// Once patched nothing should be left flagged as modified
+	it = Header->AllMetadata.begin();
+	while(it != Header->AllMetadata.end())
+	{
+		if((*it)->IsModified())
+		{
+			printf("FAIL: %s is still modified after patching\n", (*it)->FullName().c_str());
+			Ret = 1;
+		}
+
+		it++;
+	}
+
+	File->Close();
+
+	return Ret;
+}
+
+
+// Debug and error messages
+#include <stdarg.h>
+
+#ifdef MXFLIB_DEBUG
+//! Display a general debug message
+void mxflib::debug(const char *Fmt, ...)
+{
+}
+#endif // MXFLIB_DEBUG
+
+//! Display a warning message
+void mxflib::warning(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "Warning: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}
+
+//! Display an error message
+void mxflib::error(const char *Fmt, ...)
+{
+	va_list args;
+
+	va_start(args, Fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, Fmt, args);
+	va_end(args);
+}